@@ -64,6 +64,10 @@ endif()
 option(TOGGLE_BIN_FOLDER "Use build/bin folder for generate compilation files" ON)
 option(OPTIONS_ENABLE_OPENMP "Enable Open Multi-Processing support." ON)
 option(DEBUG_LOG "Enable Debug Log" OFF)
+option(OPTIONS_ENABLE_PROFILER "Compile in Tracy profiler zones and allocation tracking" OFF)
+option(OPTIONS_ENABLE_ALLOCATION_PROFILER "Account heap allocations per dispatcher task context" OFF)
+set(OPTIONS_ALLOCATOR "system" CACHE STRING "Heap allocator behind operator new: system, mimalloc or jemalloc")
+set_property(CACHE OPTIONS_ALLOCATOR PROPERTY STRINGS system mimalloc jemalloc)
 option(ASAN_ENABLED "Build this target with AddressSanitizer" OFF)
 option(BUILD_STATIC_LIBRARY "Build using static libraries" OFF)
 option(SPEED_UP_BUILD_UNITY "Compile using build unity for speed up build" ON)
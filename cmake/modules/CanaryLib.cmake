@@ -78,7 +78,7 @@ target_link_libraries(${PROJECT_NAME}_lib
         ${LUAJIT_LIBRARIES}
         CURL::libcurl
         ZLIB::ZLIB
-        absl::any absl::log absl::base absl::bits
+        absl::any absl::log absl::base absl::bits absl::inlined_vector
         asio::asio
         eventpp::eventpp
         fmt::fmt
@@ -110,6 +110,45 @@ else()
     target_link_libraries(${PROJECT_NAME}_lib PUBLIC jsoncpp_static Threads::Threads)
 endif (MSVC)
 
+# === Tracy profiler ===
+# cmake -DOPTIONS_ENABLE_PROFILER=ON .. (vcpkg: --x-feature=profiler)
+if(OPTIONS_ENABLE_PROFILER)
+    log_option_enabled("profiler")
+    find_package(Tracy CONFIG REQUIRED)
+    target_link_libraries(${PROJECT_NAME}_lib PUBLIC Tracy::TracyClient)
+    target_compile_definitions(${PROJECT_NAME}_lib PUBLIC CANARY_PROFILER)
+else()
+    log_option_disabled("profiler")
+endif()
+
+# === Heap allocator ===
+# cmake -DOPTIONS_ALLOCATOR=mimalloc .. (vcpkg: --x-feature=mimalloc), or jemalloc (--x-feature=jemalloc)
+if(OPTIONS_ALLOCATOR STREQUAL "mimalloc")
+    log_option_enabled("allocator mimalloc")
+    find_package(mimalloc CONFIG REQUIRED)
+    target_link_libraries(${PROJECT_NAME}_lib PUBLIC $<IF:$<TARGET_EXISTS:mimalloc-static>,mimalloc-static,mimalloc>)
+    target_compile_definitions(${PROJECT_NAME}_lib PUBLIC CANARY_ALLOCATOR_MIMALLOC)
+elseif(OPTIONS_ALLOCATOR STREQUAL "jemalloc")
+    log_option_enabled("allocator jemalloc")
+    find_package(PkgConfig REQUIRED)
+    pkg_check_modules(jemalloc REQUIRED IMPORTED_TARGET jemalloc)
+    target_link_libraries(${PROJECT_NAME}_lib PUBLIC PkgConfig::jemalloc)
+    target_compile_definitions(${PROJECT_NAME}_lib PUBLIC CANARY_ALLOCATOR_JEMALLOC)
+elseif(OPTIONS_ALLOCATOR STREQUAL "system")
+    log_option_enabled("allocator system")
+else()
+    message(FATAL_ERROR "OPTIONS_ALLOCATOR must be system, mimalloc or jemalloc, not ${OPTIONS_ALLOCATOR}")
+endif()
+
+# === Allocation profiler ===
+# cmake -DOPTIONS_ENABLE_ALLOCATION_PROFILER=ON .., works with or without Tracy
+if(OPTIONS_ENABLE_ALLOCATION_PROFILER)
+    log_option_enabled("allocation profiler")
+    target_compile_definitions(${PROJECT_NAME}_lib PUBLIC CANARY_ALLOCATION_PROFILER)
+else()
+    log_option_disabled("allocation profiler")
+endif()
+
 # === OpenMP ===
 if(OPTIONS_ENABLE_OPENMP)
     log_option_enabled("openmp")
@@ -38,13 +38,7 @@ function familiarOnLogin.onLogin(player)
 			familiarMonster:changeSpeed(deltaSpeed)
 
 			player:setStorageValue(Global.Storage.FamiliarSummon, os.time() + familiarTimeLeft)
-			addEvent(RemoveFamiliar, familiarTimeLeft * 1000, familiarMonster:getId(), player:getId())
-
-			for sendMessage = 1, #FAMILIAR_TIMER do
-				if player:getStorageValue(FAMILIAR_TIMER[sendMessage].storage) == -1 and familiarTimeLeft >= FAMILIAR_TIMER[sendMessage].countdown then
-					player:setStorageValue(FAMILIAR_TIMER[sendMessage].storage, addEvent(SendMessageFunction, (familiarTimeLeft - FAMILIAR_TIMER[sendMessage].countdown) * 1000, player:getId(), FAMILIAR_TIMER[sendMessage].message))
-				end
-			end
+			StartFamiliarTimer(familiarMonster:getId(), player:getId(), familiarTimeLeft)
 		end
 	end
 	return true
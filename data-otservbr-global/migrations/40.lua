@@ -1,3 +1,17 @@
 function onUpdateDatabase()
-	return false -- true = There are others migrations file | false = this is the last migration file
+	logger.info("Updating database to version 40 (cluster messages between worlds)")
+	db.query([[
+		CREATE TABLE IF NOT EXISTS `cluster_messages` (
+			`id` bigint(20) UNSIGNED NOT NULL AUTO_INCREMENT,
+			`world_id` int(11) UNSIGNED NOT NULL,
+			`type` smallint(5) UNSIGNED NOT NULL,
+			`guid` int(11) UNSIGNED NOT NULL DEFAULT '0',
+			`value` int(11) NOT NULL DEFAULT '0',
+			`text` varchar(255) NOT NULL DEFAULT '',
+			`created_at` bigint(20) NOT NULL,
+			PRIMARY KEY (`id`),
+			INDEX `created_at` (`created_at`)
+		) ENGINE=InnoDB DEFAULT CHARSET=utf8;
+	]])
+	return true
 end
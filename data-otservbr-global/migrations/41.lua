@@ -0,0 +1,17 @@
+function onUpdateDatabase()
+	logger.info("Updating database to version 41 (bank ledger for offline players)")
+	db.query([[
+		CREATE TABLE IF NOT EXISTS `player_bank_ledger` (
+			`id` bigint(20) UNSIGNED NOT NULL AUTO_INCREMENT,
+			`player_id` int(11) NOT NULL,
+			`amount` bigint(20) UNSIGNED NOT NULL,
+			`created_at` bigint(20) NOT NULL,
+			PRIMARY KEY (`id`),
+			INDEX `player_id` (`player_id`),
+			CONSTRAINT `player_bank_ledger_players_fk`
+				FOREIGN KEY (`player_id`) REFERENCES `players` (`id`)
+				ON DELETE CASCADE
+		) ENGINE=InnoDB DEFAULT CHARSET=utf8;
+	]])
+	return true
+end
@@ -10,10 +10,7 @@ function familiarOnDeath.onDeath(creature, corpse, lasthitkiller, mostdamagekill
 
 	if table.contains(vocation, creature:getName()) then
 		player:setStorageValue(Global.Storage.FamiliarSummon, os.time())
-		for sendMessage = 1, #FAMILIAR_TIMER do
-			stopEvent(player:getStorageValue(FAMILIAR_TIMER[sendMessage].storage))
-			player:setStorageValue(FAMILIAR_TIMER[sendMessage].storage, -1)
-		end
+		StopFamiliarTimer(player:getId())
 	end
 	return true
 end
@@ -45,11 +45,12 @@ function playerDeath.onDeath(player, corpse, killer, mostDamageKiller, unjustifi
 	end
 
 	local playerGuid = player:getGuid()
+	local deathTime = os.time()
 	db.query(
 		"INSERT INTO `player_deaths` (`player_id`, `time`, `level`, `killed_by`, `is_player`, `mostdamage_by`, `mostdamage_is_player`, `unjustified`, `mostdamage_unjustified`) VALUES ("
 			.. playerGuid
 			.. ", "
-			.. os.time()
+			.. deathTime
 			.. ", "
 			.. player:getLevel()
 			.. ", "
@@ -66,6 +67,7 @@ function playerDeath.onDeath(player, corpse, killer, mostDamageKiller, unjustifi
 			.. (mostDamageUnjustified and 1 or 0)
 			.. ")"
 	)
+	player:addDeathRecord(deathTime, player:getLevel(), killerName, byPlayer == 1, mostDamageName, byPlayerMostDamage == 1, unjustified, mostDamageUnjustified)
 	local resultId = db.storeQuery("SELECT `player_id` FROM `player_deaths` WHERE `player_id` = " .. playerGuid)
 	-- Start Webhook Player Death
 	local playerName = player:getName()
@@ -5,16 +5,14 @@ FAMILIAR_ID = {
 	[VOCATION.BASE_ID.KNIGHT] = { id = 991, name = "Knight familiar" },
 }
 
+-- Warnings before the familiar disappears, the longest countdown first
 FAMILIAR_TIMER = {
-	[1] = { storage = Global.Storage.FamiliarSummonEvent10, countdown = 10, message = "10 seconds" },
-	[2] = { storage = Global.Storage.FamiliarSummonEvent60, countdown = 60, message = "one minute" },
+	[1] = { countdown = 60, message = "one minute" },
+	[2] = { countdown = 10, message = "10 seconds" },
 }
 
-function SendMessageFunction(playerId, message)
-	if Player(playerId) then
-		Player(playerId):sendTextMessage(MESSAGE_LOOT, "Your summon will disappear in less than " .. message)
-	end
-end
+-- Player id => the one pending event of their familiar, a warning or the removal
+FamiliarEvents = FamiliarEvents or {}
 
 function RemoveFamiliar(creatureId, playerId)
 	local creature = Creature(creatureId)
@@ -23,7 +21,44 @@ function RemoveFamiliar(creatureId, playerId)
 		return true
 	end
 	creature:remove()
-	for sendMessage = 1, #FAMILIAR_TIMER do
-		player:setStorageValue(FAMILIAR_TIMER[sendMessage].storage, -1)
+end
+
+-- Schedules the next step only, so a familiar holds a single event whatever the number of warnings
+local function scheduleFamiliarStep(creatureId, playerId, timeLeft)
+	for _, timer in ipairs(FAMILIAR_TIMER) do
+		if timer.countdown < timeLeft then
+			FamiliarEvents[playerId] = addEvent(FamiliarTimerEvent, (timeLeft - timer.countdown) * 1000, creatureId, playerId, timer.countdown, timer.message)
+			return
+		end
+	end
+	FamiliarEvents[playerId] = addEvent(FamiliarTimerEvent, timeLeft * 1000, creatureId, playerId, 0)
+end
+
+function FamiliarTimerEvent(creatureId, playerId, timeLeft, message)
+	FamiliarEvents[playerId] = nil
+	local player = Player(playerId)
+	if not player or not Creature(creatureId) then
+		return
+	end
+
+	if timeLeft <= 0 then
+		RemoveFamiliar(creatureId, playerId)
+		return
+	end
+
+	player:sendTextMessage(MESSAGE_LOOT, "Your summon will disappear in less than " .. message)
+	scheduleFamiliarStep(creatureId, playerId, timeLeft)
+end
+
+function StartFamiliarTimer(creatureId, playerId, timeLeft)
+	StopFamiliarTimer(playerId)
+	scheduleFamiliarStep(creatureId, playerId, timeLeft)
+end
+
+function StopFamiliarTimer(playerId)
+	local eventId = FamiliarEvents[playerId]
+	if eventId then
+		stopEvent(eventId)
+		FamiliarEvents[playerId] = nil
 	end
 end
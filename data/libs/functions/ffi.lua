@@ -0,0 +1,74 @@
+-- LuaJIT FFI fast path for hot getters, enabled by luaFfiGetters in config.lua
+-- CanaryFFI only exists when the option is on and the server runs LuaJIT
+if not CanaryFFI or not jit then
+	return
+end
+
+local ffi = require("ffi")
+ffi.cdef(CanaryFFI.cdef)
+
+local function bind(name, declaration)
+	local pointer = CanaryFFI[name]
+	if pointer then
+		return ffi.cast(declaration, pointer)
+	end
+end
+
+local creatureGetHealth = bind("creatureGetHealth", "double (*)(void*)")
+local creatureGetPosition = bind("creatureGetPosition", "bool (*)(void*, canary_position*)")
+local playerGetLevel = bind("playerGetLevel", "double (*)(void*)")
+local playerGetStorageValue = bind("playerGetStorageValue", "double (*)(void*, uint32_t)")
+local itemGetId = bind("itemGetId", "double (*)(void*)")
+
+-- The getters return NaN where the regular functions return nil
+if creatureGetHealth then
+	function Creature.getHealth(self)
+		local health = creatureGetHealth(self)
+		if health ~= health then
+			return nil
+		end
+		return health
+	end
+end
+
+if creatureGetPosition then
+	local positionMetatable = debug.getregistry().Position
+	local position = ffi.new("canary_position")
+
+	function Creature.getPosition(self)
+		if not creatureGetPosition(self, position) then
+			return nil
+		end
+		return setmetatable({ x = position.x, y = position.y, z = position.z, stackpos = 0 }, positionMetatable)
+	end
+end
+
+if playerGetLevel then
+	function Player.getLevel(self)
+		local level = playerGetLevel(self)
+		if level ~= level then
+			return nil
+		end
+		return level
+	end
+end
+
+if playerGetStorageValue then
+	function Player.getStorageValue(self, key)
+		local value = playerGetStorageValue(self, key)
+		if value ~= value then
+			return nil
+		end
+		return value
+	end
+end
+
+if itemGetId then
+	function Item.getId(self)
+		local id = itemGetId(self)
+		if id ~= id then
+			return nil
+		end
+		return id
+	end
+end
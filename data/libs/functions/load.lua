@@ -25,3 +25,4 @@ dofile(CORE_DIRECTORY .. "/libs/functions/tables.lua")
 dofile(CORE_DIRECTORY .. "/libs/functions/teleport.lua")
 dofile(CORE_DIRECTORY .. "/libs/functions/tile.lua")
 dofile(CORE_DIRECTORY .. "/libs/functions/vocation.lua")
+dofile(CORE_DIRECTORY .. "/libs/functions/ffi.lua")
@@ -1,12 +1,13 @@
 -- return a dictionary of itemId => { count, gut }
----@param config { factor: number, gut: boolean, filter?: fun(itemType: ItemType, unique: boolean): boolean }
+---@param config { factor: number, gut: boolean, loot?: table, filter?: fun(itemType: ItemType, unique: boolean): boolean }
 ---@return LootItems
 function MonsterType:generateLootRoll(config, resultTable)
 	if configManager.getNumber(configKeys.RATE_LOOT) <= 0 then
 		return resultTable or {}
 	end
 
-	local monsterLoot = self:getLoot() or {}
+	-- Callers rolling many times can pass the loot list instead of building it on every roll
+	local monsterLoot = config.loot or self:getLoot() or {}
 	local factor = config.factor or 1.0
 	local uniqueItems = {}
 
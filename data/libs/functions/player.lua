@@ -429,22 +429,7 @@ function Player:createFamiliar(familiarName, timeLeft)
 	myFamiliar:getPosition():sendMagicEffect(CONST_ME_TELEPORT)
 	-- Divide by 2 to get half the time (the default total time is 30 / 2 = 15)
 	self:setStorageValue(Global.Storage.FamiliarSummon, os.time() + timeLeft)
-	addEvent(RemoveFamiliar, timeLeft * 1000, myFamiliar:getId(), self:getId())
-	for sendMessage = 1, #FAMILIAR_TIMER do
-		self:setStorageValue(
-			FAMILIAR_TIMER[sendMessage].storage,
-			addEvent(
-				-- Calling function
-				SendMessageFunction,
-				-- Time for execute event
-				(timeLeft - FAMILIAR_TIMER[sendMessage].countdown) * 1000,
-				-- Param "playerId"
-				self:getId(),
-				-- Param "message"
-				FAMILIAR_TIMER[sendMessage].message
-			)
-		)
-	end
+	StartFamiliarTimer(myFamiliar:getId(), self:getId(), timeLeft)
 	return true
 end
 
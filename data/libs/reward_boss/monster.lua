@@ -41,7 +41,7 @@ local function isEquipment(itemType)
 	return table.contains(equipmentTypes, t)
 end
 
-function MonsterType.getBossReward(self, lootFactor, topScore, equipmentOnly, lootTable)
+function MonsterType.getBossReward(self, lootFactor, topScore, equipmentOnly, lootTable, monsterLoot)
 	if configManager.getNumber(configKeys.RATE_LOOT) <= 0 then
 		return lootTable or {}
 	end
@@ -49,6 +49,7 @@ function MonsterType.getBossReward(self, lootFactor, topScore, equipmentOnly, lo
 	return self:generateLootRoll({
 		factor = lootFactor,
 		gut = false,
+		loot = monsterLoot,
 		filter = function(itemType, unique)
 			if unique and not topScore then
 				return false
@@ -61,17 +61,18 @@ function bossDeath.onDeath(creature, corpse, killer, mostDamageKiller, lastHitUn
 		end)
 
 		local expectedScore = 1 / participants
+		-- Read once, every participant rolls against the same list
+		local monsterLoot = monsterType:getLoot() or {}
 
 		for _, con in ipairs(scores) do
 			-- Ignoring stamina for now because I heard you get receive rewards even when it's depleted
 			if con.score ~= 0 then
-				local reward, stamina, player
+				local stamina, player
 				if con.player then
 					player = con.player
 				else
 					player = Game.getOfflinePlayer(con.guid)
 				end
-				reward = player:getReward(rewardId, true)
 				stamina = player:getStamina()
 
 				local lootFactor = 1
@@ -100,13 +101,13 @@ function bossDeath.onDeath(creature, corpse, killer, mostDamageKiller, lastHitUn
 					rolls = math.floor(rolls)
 				end
 
-				local playerLoot = monsterType:getBossReward(lootFactor, _ == 1, false, {})
+				local playerLoot = monsterType:getBossReward(lootFactor, _ == 1, false, {}, monsterLoot)
 				for _ = 2, rolls do
-					playerLoot = monsterType:getBossReward(lootFactor, false, true, playerLoot)
+					playerLoot = monsterType:getBossReward(lootFactor, false, true, playerLoot, monsterLoot)
 				end
 
-				-- Add droped items to reward container
-				reward:addRewardBossItems(playerLoot)
+				-- The reward is filled first and then put in the reward chest
+				local reward = player:addRewardItems(rewardId, playerLoot)
 
 				if con.player then
 					local lootMessage = ("The following items dropped by %s are available in your reward chest: %s"):format(creature:getName(), reward:getContentDescription())
@@ -14,8 +14,9 @@ function unban.onSay(player, words, param)
 		return true
 	end
 
-	db.asyncQuery("DELETE FROM `account_bans` WHERE `account_id` = " .. Result.getNumber(resultId, "account_id"))
-	db.asyncQuery("DELETE FROM `ip_bans` WHERE `ip` = " .. Result.getNumber(resultId, "lastip"))
+	-- The logins are checked against the loaded bans, so they are loaded again once each delete ran
+	db.asyncQuery("DELETE FROM `account_bans` WHERE `account_id` = " .. Result.getNumber(resultId, "account_id"), Game.reloadBans)
+	db.asyncQuery("DELETE FROM `ip_bans` WHERE `ip` = " .. Result.getNumber(resultId, "lastip"), Game.reloadBans)
 	Result.free(resultId)
 	local text = param .. " has been unbanned."
 	player:sendTextMessage(MESSAGE_ADMINISTRADOR, text)
@@ -0,0 +1,30 @@
+local allocator = TalkAction("/allocator")
+
+function allocator.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	local before = Game.getAllocatorStats()
+	if param == "purge" then
+		Game.purgeAllocator()
+		local after = Game.getAllocatorStats()
+		player:sendTextMessage(MESSAGE_ADMINISTRADOR, string.format("Allocator purged, resident memory went from %d MB to %d MB.", before.resident / 1048576, after.resident / 1048576))
+		return true
+	end
+
+	local text = string.format("Allocator: %s\nResident: %d MB", before.name, before.resident / 1048576)
+	if before.allocated > 0 then
+		text = text .. string.format("\nAllocated: %d MB", before.allocated / 1048576)
+	end
+	if before.committed > 0 then
+		text = text .. string.format("\nCommitted: %d MB", before.committed / 1048576)
+	end
+	text = text .. "\n\n/allocator purge returns the free memory the allocator keeps to the system."
+
+	player:showTextDialog(2160, text)
+	return true
+end
+
+allocator:separator(" ")
+allocator:groupType("god")
+allocator:register()
@@ -0,0 +1,26 @@
+local chatStats = TalkAction("/chatstats")
+
+function chatStats.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	if param == "reset" then
+		Game.resetChatChannelStats()
+		player:sendTextMessage(MESSAGE_EVENT_ADVANCE, "Chat channel stats reset.")
+		return true
+	end
+
+	local stats, seconds = Game.getChatChannelStats()
+	local minutes = math.max(seconds / 60, 1 / 60)
+	local text = string.format("%d channels with messages in the last %d seconds:", #stats, seconds)
+	for _, channel in ipairs(stats) do
+		text = text .. string.format("\n%s (%d): %d users, %d messages (%.1f/min), %d deliveries (%.1f/min)", channel.name, channel.id, channel.users, channel.messages, channel.messages / minutes, channel.deliveries, channel.deliveries / minutes)
+	end
+
+	player:showTextDialog(2160, text)
+	return true
+end
+
+chatStats:separator(" ")
+chatStats:groupType("god")
+chatStats:register()
@@ -0,0 +1,59 @@
+local luaProfiler = TalkAction("/luaprofiler")
+
+function luaProfiler.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	local params = param:split(" ")
+	local action = params[1]
+	if action == "reset" then
+		Game.resetLuaProfile()
+		player:sendTextMessage(MESSAGE_ADMINISTRADOR, "Lua profiler was reset.")
+		return true
+	end
+
+	if action == "sample" then
+		if params[2] == "stop" then
+			Game.stopLuaSampling()
+			player:sendTextMessage(MESSAGE_ADMINISTRADOR, "Lua sampling was stopped.")
+		elseif Game.startLuaSampling(tonumber(params[2]) or 1) then
+			player:sendTextMessage(MESSAGE_ADMINISTRADOR, "Lua sampling was started.")
+		else
+			player:sendTextMessage(MESSAGE_ADMINISTRADOR, "Lua sampling needs LuaJIT.")
+		end
+		return true
+	end
+
+	local byMax = action == "max"
+	local limit = tonumber(byMax and params[2] or action) or 10
+	local profile = Game.getLuaProfile(byMax)
+
+	local calls = profile.calls
+	local text = string.format("Top %d of %d scripts by %s:", math.min(limit, #calls), #calls, byMax and "slowest call" or "execution time")
+	for index, call in ipairs(calls) do
+		if index > limit then
+			break
+		end
+
+		text = text .. string.format("\n%s (%s): %d calls, %d ms total, p50 %d us, p99 %d us, max %d us", call.script, call.interface, call.calls, call.total / 1000, call.p50, call.p99, call.max)
+	end
+
+	local samples = profile.samples
+	if profile.sampling or #samples > 0 then
+		text = text .. string.format("\n\nTop %d of %d sampled lines:", math.min(limit, #samples), #samples)
+		for index, sample in ipairs(samples) do
+			if index > limit then
+				break
+			end
+
+			text = text .. string.format("\n%s: %d samples", sample.location, sample.samples)
+		end
+	end
+
+	player:showTextDialog(2160, text)
+	return true
+end
+
+luaProfiler:separator(" ")
+luaProfiler:groupType("god")
+luaProfiler:register()
@@ -0,0 +1,46 @@
+local networkProfiler = TalkAction("/netprofiler")
+
+function networkProfiler.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	if param == "reset" then
+		Game.resetNetworkProfile()
+		player:sendTextMessage(MESSAGE_ADMINISTRADOR, "Network profiler was reset.")
+		return true
+	end
+
+	local limit = tonumber(param) or 10
+	local profile = Game.getNetworkProfile()
+
+	local opcodes = profile.opcodes
+	table.sort(opcodes, function(lhs, rhs)
+		return lhs.total > rhs.total
+	end)
+
+	local text = string.format("Top %d of %d client opcodes by parse time:", math.min(limit, #opcodes), #opcodes)
+	for index, opcode in ipairs(opcodes) do
+		if index > limit then
+			break
+		end
+
+		text = text .. string.format("\n0x%02X: %d calls, %d bytes, %d ms total, p50 %d us, p99 %d us, max %d us", opcode.opcode, opcode.calls, opcode.bytes, opcode.total / 1000, opcode.p50, opcode.p99, opcode.max)
+	end
+
+	local sends = profile.sends
+	text = text .. string.format("\n\nTop %d of %d send functions by bytes:", math.min(limit, #sends), #sends)
+	for index, send in ipairs(sends) do
+		if index > limit then
+			break
+		end
+
+		text = text .. string.format("\n%s: %d messages, %d bytes", send["function"], send.messages, send.bytes)
+	end
+
+	player:showTextDialog(2160, text)
+	return true
+end
+
+networkProfiler:separator(" ")
+networkProfiler:groupType("god")
+networkProfiler:register()
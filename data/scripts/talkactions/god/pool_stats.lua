@@ -0,0 +1,19 @@
+local poolStats = TalkAction("/poolstats")
+
+function poolStats.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	local stats = Game.getObjectPoolStats()
+	local text = string.format("%d object pools:", #stats)
+	for _, pool in ipairs(stats) do
+		text = text .. string.format("\n%s: %d live of %d slots, %d bytes each, %d KB reserved", pool.name, pool.live, pool.capacity, pool.blockSize, pool.capacity * pool.blockSize / 1024)
+	end
+
+	player:showTextDialog(2160, text)
+	return true
+end
+
+poolStats:separator(" ")
+poolStats:groupType("god")
+poolStats:register()
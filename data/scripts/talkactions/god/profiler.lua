@@ -0,0 +1,30 @@
+local profiler = TalkAction("/profiler")
+
+function profiler.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	if param == "reset" then
+		Game.resetTaskProfile()
+		player:sendTextMessage(MESSAGE_ADMINISTRADOR, "Task profiler was reset.")
+		return true
+	end
+
+	local limit = tonumber(param) or 10
+	local profiles = Game.getTaskProfile()
+	local text = string.format("Top %d of %d task contexts by execution time:", math.min(limit, #profiles), #profiles)
+	for index, profile in ipairs(profiles) do
+		if index > limit then
+			break
+		end
+
+		text = text .. string.format("\n%s: %d calls, %d ms total, p50 %d us, p99 %d us, max %d us, wait p99 %d us", profile.context, profile.calls, profile.total / 1000, profile.p50, profile.p99, profile.max, profile.waitP99)
+	end
+
+	player:showTextDialog(2160, text)
+	return true
+end
+
+profiler:separator(" ")
+profiler:groupType("god")
+profiler:register()
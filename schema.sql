@@ -801,6 +801,32 @@ CREATE TABLE IF NOT EXISTS `kv_store` (
   PRIMARY KEY (`key_name`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8;
 
+-- Table structure `cluster_messages`
+CREATE TABLE IF NOT EXISTS `cluster_messages` (
+    `id` bigint(20) UNSIGNED NOT NULL AUTO_INCREMENT,
+    `world_id` int(11) UNSIGNED NOT NULL,
+    `type` smallint(5) UNSIGNED NOT NULL,
+    `guid` int(11) UNSIGNED NOT NULL DEFAULT '0',
+    `value` int(11) NOT NULL DEFAULT '0',
+    `text` varchar(255) NOT NULL DEFAULT '',
+    `created_at` bigint(20) NOT NULL,
+    CONSTRAINT `cluster_messages_pk` PRIMARY KEY (`id`),
+    INDEX `created_at` (`created_at`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8;
+
+-- Table structure `player_bank_ledger`
+CREATE TABLE IF NOT EXISTS `player_bank_ledger` (
+    `id` bigint(20) UNSIGNED NOT NULL AUTO_INCREMENT,
+    `player_id` int(11) NOT NULL,
+    `amount` bigint(20) UNSIGNED NOT NULL,
+    `created_at` bigint(20) NOT NULL,
+    CONSTRAINT `player_bank_ledger_pk` PRIMARY KEY (`id`),
+    INDEX `player_id` (`player_id`),
+    CONSTRAINT `player_bank_ledger_players_fk`
+        FOREIGN KEY (`player_id`) REFERENCES `players` (`id`)
+        ON DELETE CASCADE
+) ENGINE=InnoDB DEFAULT CHARSET=utf8;
+
 -- Create Account god/god
 INSERT INTO `accounts`
 (`id`, `name`, `email`, `password`, `type`) VALUES
@@ -13,24 +13,53 @@
 
 #include "declarations.hpp"
 #include "creatures/players/grouping/familiars.hpp"
+#include "creatures/players/management/ban.hpp"
 #include "creatures/players/storages/storages.hpp"
 #include "database/databasemanager.hpp"
+#include "database/databasetasks.hpp"
 #include "game/game.hpp"
+#include "game/functions/game_reload.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/events_scheduler.hpp"
+#include "game/scheduling/scheduler.hpp"
+#include "io/ioguild.hpp"
 #include "io/iomarket.hpp"
+#include "io/iohighscores.hpp"
+#include "io/worldsnapshot.hpp"
+#include "items/decay/decay.hpp"
+#include "lib/memory/allocator.hpp"
+#include "lib/metrics/metrics.hpp"
 #include "lib/thread/thread_pool.hpp"
 #include "lua/creature/events.hpp"
 #include "lua/modules/modules.hpp"
 #include "lua/scripts/lua_environment.hpp"
 #include "lua/scripts/scripts.hpp"
 #include "server/network/protocol/protocollogin.hpp"
+#include "server/network/protocol/session_recording.hpp"
+#include "server/cluster/cluster_bus.hpp"
+#include "server/metrics_exporter.hpp"
 #include "server/network/webhook/webhook.hpp"
 #include "io/ioprey.hpp"
 #include "io/io_bosstiary.hpp"
+#include "utils/cpu_features.hpp"
+#include "utils/object_pool.hpp"
 
 #include "core.hpp"
 
+namespace {
+	// Resident set size of the process in bytes, 0 where it is not known
+	int64_t getResidentMemory() {
+#ifdef __linux__
+		std::ifstream statm("/proc/self/statm");
+		int64_t pages = 0, residentPages = 0;
+		if (statm >> pages >> residentPages) {
+			return residentPages * sysconf(_SC_PAGESIZE);
+		}
+#endif
+		return 0;
+	}
+}
+
 CanaryServer::CanaryServer(
 	Logger &logger,
 	RSA &rsa,
@@ -57,14 +86,30 @@ int CanaryServer::run() {
 			try {
 				loadConfigLua();
 
+				inject<ThreadPool>().start(
+					static_cast<uint16_t>(g_configManager().getNumber(THREAD_POOL_COMPUTE_THREADS)),
+					static_cast<uint16_t>(g_configManager().getNumber(THREAD_POOL_BLOCKING_THREADS)),
+					g_configManager().getBoolean(THREAD_POOL_CPU_PINNING)
+				);
+				g_dispatcher().getWatchdog().start(static_cast<uint32_t>(g_configManager().getNumber(DISPATCHER_WATCHDOG_THRESHOLD)));
+				g_dispatcher().getRecorder().start(
+					static_cast<uint32_t>(g_configManager().getNumber(FLIGHT_RECORDER_WINDOW)),
+					static_cast<uint32_t>(g_configManager().getNumber(FLIGHT_RECORDER_TASK_THRESHOLD)),
+					static_cast<uint32_t>(g_configManager().getNumber(FLIGHT_RECORDER_CYCLE_THRESHOLD))
+				);
+
 				logger.info("Server protocol: {}.{}{}", CLIENT_VERSION_UPPER, CLIENT_VERSION_LOWER, g_configManager().getBoolean(OLD_PROTOCOL) ? " and 10x allowed!" : "");
 
 				rsa.start();
-				initializeDatabase();
+				// Nothing before the core scripts needs the database, appearances and items.xml load meanwhile
+				databaseLoad = startStage("database", [this] { initializeDatabase(); });
 				loadModules();
+				g_gameReload().startScriptsWatcher();
 				setWorldType();
 				loadMaps();
 
+				IOMarket::getInstance().loadOffers();
+
 				logger.info("Initializing gamestate...");
 				g_game().setGameState(GAME_STATE_INIT);
 
@@ -73,7 +118,9 @@ int CanaryServer::run() {
 
 				IOMarket::checkExpiredOffers();
 				IOMarket::getInstance().updateStatistics();
+				IOHighscores::getInstance().start();
 
+				logStartupStages();
 				logger.info("Loaded all modules, server starting up...");
 
 #ifndef _WIN32
@@ -84,8 +131,23 @@ int CanaryServer::run() {
 				}
 #endif
 
+				const auto &replayFile = g_configManager().getString(SESSION_REPLAY);
+				if (!replayFile.empty() && !g_sessionReplay().load(replayFile)) {
+					throw FailedToInitializeCanary(fmt::format("Could not replay the sessions of {}", replayFile));
+				}
+
+				IOBan::startSync();
+				g_scheduler().addEvent(IOGuild::REFRESH_INTERVAL_MS, [] { IOGuild::refresh(); }, "IOGuild::refresh");
 				g_game().start(&serviceManager);
+				g_clusterBus().start();
 				g_game().setGameState(GAME_STATE_NORMAL);
+				startMetrics();
+
+				if (g_sessionReplay().isLoaded()) {
+					g_sessionReplay().start();
+				} else if (g_configManager().getBoolean(SESSION_RECORDING)) {
+					g_sessionRecorder().start();
+				}
 
 				g_webhook().sendMessage("Server is now online", "Server has successfully started.", WEBHOOK_COLOR_ONLINE);
 
@@ -109,6 +171,13 @@ int CanaryServer::run() {
 
 	loaderSignal.wait(loaderUniqueLock, [this] { return loaderDone || loadFailed; });
 
+	if (g_sessionReplay().isLoaded() && !loadFailed) {
+		logger.info("Replaying recorded sessions, no ports are open");
+		g_sessionReplay().wait();
+		shutdown();
+		return EXIT_SUCCESS;
+	}
+
 	if (loadFailed || !serviceManager.is_running()) {
 		logger.error("No services running. The server is NOT online!");
 		shutdown();
@@ -143,14 +212,22 @@ void CanaryServer::setWorldType() {
 	logger.debug("World type set as {}", asUpperCaseString(worldType));
 }
 
-void CanaryServer::loadMaps() const {
+void CanaryServer::loadMaps() {
+	// Rethrows if reading the tiles failed
+	runStage("map tiles wait", [this] { mapTilesLoad.get(); });
+
 	try {
-		g_game().loadMainMap(g_configManager().getString(MAP_NAME));
+		runStage("map data", [] { g_game().loadMainMapData(); });
 
 		// If "mapCustomEnabled" is true on config.lua, then load the custom map
 		if (g_configManager().getBoolean(TOGGLE_MAP_CUSTOM)) {
 			g_game().loadCustomMaps(g_configManager().getString(DATA_DIRECTORY) + "/world/custom/");
 		}
+
+		// Every map and house is in place, the items left on the map at the last shutdown go back on top
+		if (g_configManager().getBoolean(WORLD_SNAPSHOT)) {
+			runStage("world snapshot", [] { WorldSnapshot::restore(g_game().map, g_game().getMainMapFile()); });
+		}
 	} catch (const std::exception &err) {
 		throw FailedToInitializeCanary(err.what());
 	}
@@ -185,7 +262,8 @@ void CanaryServer::logInfos() {
 	logger.info("{} - Version {}", STATUS_SERVER_NAME, STATUS_SERVER_VERSION);
 #endif
 
-	logger.debug("Compiled with {}, on {} {}, for platform {}\n", getCompiler(), __DATE__, __TIME__, getPlatform());
+	logger.debug("Compiled with {}, on {} {}, for platform {}", getCompiler(), __DATE__, __TIME__, getPlatform());
+	logger.debug("Vector kernels use the CPU extensions: {}", getCpuFeatures().toString());
 
 #if defined(LUAJIT_VERSION)
 	logger.debug("Linked with {} for Lua support", LUAJIT_VERSION);
@@ -287,6 +365,10 @@ void CanaryServer::initializeDatabase() {
 	}
 	logger.debug("MySQL Version: {}", Database::getClientVersion());
 
+	if (!g_databaseTasks().connectPool()) {
+		throw FailedToInitializeCanary("Failed to connect the database pool!");
+	}
+
 	logger.debug("Running database manager...");
 	if (!DatabaseManager::isDatabaseSetup()) {
 		throw FailedToInitializeCanary(fmt::format(
@@ -301,6 +383,8 @@ void CanaryServer::initializeDatabase() {
 		&& !DatabaseManager::optimizeTables()) {
 		logger.debug("No tables were optimized");
 	}
+
+	IOGuild::loadGuilds();
 }
 
 void CanaryServer::loadModules() {
@@ -322,37 +406,76 @@ void CanaryServer::loadModules() {
 	}
 
 	auto coreFolder = g_configManager().getString(CORE_DIRECTORY);
-	// Load items dependencies
-	modulesLoadHelper((g_game().loadAppearanceProtobuf(coreFolder + "/items/appearances.dat") == ERROR_NONE), "appearances.dat");
-	modulesLoadHelper(Item::items.loadFromXml(), "items.xml");
+	// Load items dependencies, items.xml is read while appearances.dat is parsed but applied after it
+	pugi::xml_document itemsDocument;
+	auto itemsXmlRead = startStage("items.xml read", [this, &itemsDocument] {
+		modulesLoadHelper(Items::parseXmlFile(itemsDocument), "items.xml");
+	});
+	runStage("appearances.dat", [this, &coreFolder] {
+		modulesLoadHelper((g_game().loadAppearanceProtobuf(coreFolder + "/items/appearances.dat") == ERROR_NONE), "appearances.dat");
+	});
+	itemsXmlRead.get();
+	runStage("items.xml", [this, &itemsDocument] {
+		modulesLoadHelper(Item::items.loadFromXml(itemsDocument), "items.xml");
+	});
+
+	// Migrations reserve script environments, so the database must be done before any Lua runs.
+	// Rethrows if setting it up failed
+	runStage("database wait", [this] { databaseLoad.get(); });
 
 	auto datapackFolder = g_configManager().getString(DATA_DIRECTORY);
+	// Every Lua stage below runs on this thread, they all share the single Lua state
 	logger.debug("Loading core scripts on folder: {}/", coreFolder);
-	// Load first core Lua libs
-	modulesLoadHelper((g_luaEnvironment().loadFile(coreFolder + "/core.lua", "core.lua") == 0), "core.lua");
-	modulesLoadHelper(g_scripts().loadScripts(coreFolder + "/scripts", false, false), "/data/scripts");
+	runStage("core scripts", [&] {
+		// Load first core Lua libs
+		modulesLoadHelper((g_luaEnvironment().loadFile(coreFolder + "/core.lua", "core.lua") == 0), "core.lua");
+		modulesLoadHelper(g_scripts().loadScripts(coreFolder + "/scripts", false, false), "/data/scripts");
+	});
 
 	// Second XML scripts
-	modulesLoadHelper(g_vocations().loadFromXml(), "XML/vocations.xml");
-	modulesLoadHelper(g_eventsScheduler().loadScheduleEventFromXml(), "XML/events.xml");
-	modulesLoadHelper(Outfits::getInstance().loadFromXml(), "XML/outfits.xml");
-	modulesLoadHelper(Familiars::getInstance().loadFromXml(), "XML/familiars.xml");
-	modulesLoadHelper(g_imbuements().loadFromXml(), "XML/imbuements.xml");
-	modulesLoadHelper(g_storages().loadFromXML(), "XML/storages.xml");
-	modulesLoadHelper(g_modules().loadFromXml(), "modules/modules.xml");
-	modulesLoadHelper(g_events().loadFromXml(), "events/events.xml");
-	modulesLoadHelper((g_npcs().load(true, false)), "npclib");
+	runStage("XML modules", [this] {
+		modulesLoadHelper(g_vocations().loadFromXml(), "XML/vocations.xml");
+		modulesLoadHelper(g_eventsScheduler().loadScheduleEventFromXml(), "XML/events.xml");
+		modulesLoadHelper(Outfits::getInstance().loadFromXml(), "XML/outfits.xml");
+		modulesLoadHelper(Familiars::getInstance().loadFromXml(), "XML/familiars.xml");
+		modulesLoadHelper(g_imbuements().loadFromXml(), "XML/imbuements.xml");
+		modulesLoadHelper(g_storages().loadFromXML(), "XML/storages.xml");
+		modulesLoadHelper(g_modules().loadFromXml(), "modules/modules.xml");
+		modulesLoadHelper(g_events().loadFromXml(), "events/events.xml");
+		modulesLoadHelper((g_npcs().load(true, false)), "npclib");
+	});
 
 	logger.debug("Loading datapack scripts on folder: {}/", datapackName);
-	modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/scripts/lib", true, false), datapackFolder + "/scripts/libs");
-	// Load scripts
-	modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/scripts", false, false), datapackFolder + "/scripts");
-	// Load monsters
-	modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/monster", false, false), datapackFolder + "/monster");
-	modulesLoadHelper((g_npcs().load(false, true)), "npc");
+	runStage("datapack scripts", [&] {
+		modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/scripts/lib", true, false), datapackFolder + "/scripts/libs");
+		// Load scripts
+		modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/scripts", false, false), datapackFolder + "/scripts");
+	});
+
+	/**
+	 * The tiles only need the item types, which are final once the datapack scripts ran
+	 * (Action:position may still turn item types non moveable).
+	 * Monster and npc scripts only register creature types, so both go on together.
+	 */
+	mapTilesLoad = startStage("map tiles", [] {
+		try {
+			g_game().loadMainMapTiles(g_configManager().getString(MAP_NAME));
+		} catch (const FailedToInitializeCanary &) {
+			throw;
+		} catch (const std::exception &err) {
+			throw FailedToInitializeCanary(err.what());
+		}
+	});
+
+	runStage("monsters and npcs", [this, &datapackFolder] {
+		// Load monsters
+		modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/monster", false, false), datapackFolder + "/monster");
+		modulesLoadHelper((g_npcs().load(false, true)), "npc");
+	});
 
 	g_game().loadBoostedCreature();
 	g_ioBosstiary().loadBoostedBoss();
+	g_ioprey().initializeMonsterPools();
 	g_ioprey().initializeTaskHuntOptions();
 }
 
@@ -363,6 +486,110 @@ void CanaryServer::modulesLoadHelper(bool loaded, std::string moduleName) {
 	}
 }
 
+void CanaryServer::runStage(std::string_view name, const std::function<void()> &stage) {
+	const int64_t memoryBefore = getResidentMemory();
+	const auto start = std::chrono::steady_clock::now();
+	stage();
+	const auto end = std::chrono::steady_clock::now();
+	const int64_t memoryDelta = getResidentMemory() - memoryBefore;
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+	logger.info("Startup stage {} done in {} ms, resident memory {:+} MB", name, elapsed, memoryDelta / (1024 * 1024));
+
+	std::scoped_lock lock(stagesMutex);
+	stages.push_back({ std::string(name), start, end, memoryDelta });
+}
+
+void CanaryServer::logStartupStages() {
+	std::scoped_lock lock(stagesMutex);
+	if (stages.empty()) {
+		return;
+	}
+
+	const auto toMs = [](auto duration) {
+		return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+	};
+
+	auto bootStart = stages.front().start;
+	auto bootEnd = stages.front().end;
+	std::chrono::steady_clock::duration stagesTotal {};
+	for (const auto &stage : stages) {
+		bootStart = std::min(bootStart, stage.start);
+		bootEnd = std::max(bootEnd, stage.end);
+		// Waits only measure the stage they wait on, they are not counted twice
+		if (!stage.name.ends_with(" wait")) {
+			stagesTotal += stage.end - stage.start;
+		}
+	}
+
+	logger.info("Startup stages took {} ms, {} ms of it overlapped on the blocking threads", toMs(bootEnd - bootStart), std::max<int64_t>(0, toMs(stagesTotal - (bootEnd - bootStart))));
+
+	auto sorted = stages;
+	std::ranges::sort(sorted, [](const auto &lhs, const auto &rhs) {
+		return lhs.end - lhs.start > rhs.end - rhs.start;
+	});
+	for (const auto &stage : sorted) {
+		logger.debug("Startup stage {}: started at {} ms, took {} ms, resident memory {:+} MB", stage.name, toMs(stage.start - bootStart), toMs(stage.end - stage.start), stage.memoryDelta / (1024 * 1024));
+	}
+}
+
+void CanaryServer::startMetrics() {
+	auto* playersOnline = &g_metrics().getGauge("canary_players_online", "Players logged in");
+	auto* monstersOnline = &g_metrics().getGauge("canary_monsters_online", "Monsters spawned");
+	auto* decayPending = &g_metrics().getGauge("canary_decay_pending_items", "Items waiting to decay");
+	auto* schedulerEvents = &g_metrics().getGauge("canary_scheduler_pending_events", "Events waiting in the scheduler");
+	auto* processCpu = &g_metrics().getGauge("canary_process_cpu_milliseconds", "User and system CPU time of the process");
+	const auto allocatorLabels = fmt::format("allocator=\"{}\"", Allocator::getName());
+	auto* allocatorAllocated = &g_metrics().getGauge("canary_allocator_allocated_bytes", "Heap bytes in use by the server, 0 when the allocator does not tell", allocatorLabels);
+	auto* allocatorCommitted = &g_metrics().getGauge("canary_allocator_committed_bytes", "Heap bytes the allocator holds from the system, 0 when it does not tell", allocatorLabels);
+	auto* processResident = &g_metrics().getGauge("canary_process_resident_bytes", "Resident memory of the process");
+	g_metrics().addCollector([=] {
+		playersOnline->set(static_cast<int64_t>(g_game().getPlayersOnline()));
+		monstersOnline->set(static_cast<int64_t>(g_game().getMonstersOnline()));
+		decayPending->set(static_cast<int64_t>(g_decay().getPendingCount()));
+		schedulerEvents->set(static_cast<int64_t>(g_scheduler().getEventCount()));
+		processCpu->set(getProcessCpuTimeMs());
+
+		const auto allocator = Allocator::getStats();
+		allocatorAllocated->set(allocator.allocated);
+		allocatorCommitted->set(allocator.committed);
+		processResident->set(allocator.resident);
+
+		// Pools show up the first time they allocate
+		for (const auto &stats : ObjectPoolRegistry::getStats()) {
+			const auto labels = fmt::format("pool=\"{}\"", stats.name);
+			g_metrics().getGauge("canary_object_pool_live", "Objects alive in the pool", labels).set(static_cast<int64_t>(stats.live));
+			g_metrics().getGauge("canary_object_pool_capacity", "Slots the pool allocated", labels).set(static_cast<int64_t>(stats.capacity));
+		}
+	});
+
+	const auto port = g_configManager().getNumber(METRICS_PORT);
+	if (port > 0) {
+		g_metricsExporter().start(g_configManager().getString(METRICS_IP), static_cast<uint16_t>(port));
+	}
+}
+
+std::future<void> CanaryServer::startStage(std::string name, std::function<void()> &&stage) {
+	auto task = std::make_shared<std::packaged_task<void()>>([this, name = std::move(name), stage = std::move(stage)] {
+		runStage(name, stage);
+	});
+	auto future = task->get_future();
+	if (g_configManager().getBoolean(PARALLEL_STARTUP)) {
+		inject<ThreadPool>().addBlockingLoad([task] { (*task)(); });
+	} else {
+		(*task)();
+	}
+	return future;
+}
+
 void CanaryServer::shutdown() {
+	g_metricsExporter().shutdown();
+	g_dispatcher().shutdown();
+	// After the game thread, so the messages of its last tasks still go out
+	g_webhook().shutdown();
+	g_sessionRecorder().stop();
+	// What the last game tasks sent to the database, stopping the pool drops it
+	g_databaseTasks().flushPool();
+	g_databaseTasks().flushWrites();
 	inject<ThreadPool>().shutdown();
 }
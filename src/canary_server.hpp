@@ -53,6 +53,22 @@ private:
 	bool loaderDone = false;
 	bool loadFailed = false;
 
+	// Main map tiles, read on the blocking pool while the monster and npc scripts load
+	std::future<void> mapTilesLoad;
+	// Connection and migrations, set up on the blocking pool while appearances and items load
+	std::future<void> databaseLoad;
+
+	struct StartupStage {
+		std::string name;
+		std::chrono::steady_clock::time_point start;
+		std::chrono::steady_clock::time_point end;
+		// Resident memory of the whole process, stages running meanwhile count too
+		int64_t memoryDelta;
+	};
+
+	std::mutex stagesMutex;
+	std::vector<StartupStage> stages;
+
 	void logInfos();
 	static void toggleForceCloseButton();
 	static void badAllocationHandler();
@@ -65,7 +81,20 @@ private:
 	void initializeDatabase();
 	void loadModules();
 	void setWorldType();
-	void loadMaps() const;
+	void loadMaps();
 	void setupHousesRent();
 	void modulesLoadHelper(bool loaded, std::string moduleName);
+	// Samples the game state into the metrics registry and exports it when metricsPort is set
+	void startMetrics();
+
+	// Runs a startup stage on the calling thread and logs how long it took
+	void runStage(std::string_view name, const std::function<void()> &stage);
+	// Logs the wall time of the whole startup and how much of it overlapped, then every stage slowest first
+	void logStartupStages();
+	/**
+	 * Runs a startup stage on the blocking pool, or right away if parallelStartup is off.
+	 * The stage must not touch anything the game thread uses until the future is waited,
+	 * future.get() rethrows whatever the stage threw.
+	 */
+	std::future<void> startStage(std::string name, std::function<void()> &&stage);
 };
@@ -52,6 +52,8 @@ enum booleanConfig_t {
 	SORT_LOOT_BY_CHANCE,
 	TOGGLE_SAVE_INTERVAL,
 	TOGGLE_SAVE_INTERVAL_CLEAN_MAP,
+	PLAYER_INCREMENTAL_SAVE,
+	PLAYER_DEPOT_ITEM_DIFF,
 	PREY_ENABLED,
 	PREY_FREE_THIRD_SLOT,
 	TASK_HUNTING_ENABLED,
@@ -91,6 +93,20 @@ enum booleanConfig_t {
 	TOGGLE_MOUNT_IN_PZ,
 	TOGGLE_HOUSE_TRANSFER_ON_SERVER_RESTART,
 
+	TOGGLE_TASK_PROFILER,
+	TOGGLE_NETWORK_PROFILER,
+	TOGGLE_LUA_PROFILER,
+	LUA_POSITION_USERDATA,
+	LUA_FFI_GETTERS,
+	LUA_BYTECODE_CACHE,
+	LUA_ABORT_OVER_BUDGET,
+	THREAD_POOL_CPU_PINNING,
+	MAP_SECTOR_INDEX,
+	MAP_SNAPSHOT,
+	WORLD_SNAPSHOT,
+	PARALLEL_STARTUP,
+	SESSION_RECORDING,
+
 	LAST_BOOLEAN_CONFIG
 };
 
@@ -106,12 +122,14 @@ enum stringConfig_t {
 	URL,
 	LOCATION,
 	IP,
+	METRICS_IP,
 	WORLD_TYPE,
 	MYSQL_HOST,
 	MYSQL_USER,
 	MYSQL_PASS,
 	MYSQL_DB,
 	MYSQL_SOCK,
+	MYSQL_REPLICA_HOST,
 	AUTH_TYPE,
 	DEFAULT_PRIORITY,
 	STORE_IMAGES_URL,
@@ -126,12 +144,16 @@ enum stringConfig_t {
 	FORGE_FIENDISH_INTERVAL_TIME,
 	TIBIADROME_CONCOCTION_TICK_TYPE,
 	M_CONST,
+	SESSION_REPLAY,
 
 	LAST_STRING_CONFIG
 };
 
 enum integerConfig_t {
 	SQL_PORT,
+	SQL_REPLICA_PORT,
+	DATABASE_POOL_SIZE,
+	DATABASE_INSERT_BATCH_SIZE,
 	MAX_PLAYERS,
 	PZ_LOCKED,
 	DEFAULT_DESPAWNRANGE,
@@ -151,11 +173,15 @@ enum integerConfig_t {
 	PROTECTION_LEVEL,
 	DEATH_LOSE_PERCENT,
 	STATUSQUERY_TIMEOUT,
+	STATUS_CACHE_TIME,
 	FRAG_TIME,
 	WHITE_SKULL_TIME,
 	GAME_PORT,
 	LOGIN_PORT,
 	STATUS_PORT,
+	METRICS_PORT,
+	CLUSTER_WORLD_ID,
+	CLUSTER_POLL_INTERVAL_MS,
 	STAIRHOP_DELAY,
 	MAX_CONTAINER,
 	MAX_CONTAINER_ITEM,
@@ -257,6 +283,29 @@ enum integerConfig_t {
 	REWARD_CHEST_MAX_COLLECT_ITEMS,
 	DISCORD_WEBHOOK_DELAY_MS,
 
+	TASK_PROFILER_LOG_INTERVAL,
+	TASK_PROFILER_LOG_CONTEXTS,
+	NETWORK_PROFILER_SLOW_PACKET_MS,
+	THREAD_POOL_COMPUTE_THREADS,
+	THREAD_POOL_BLOCKING_THREADS,
+	MAX_PENDING_LOGINS,
+	BAN_SYNC_INTERVAL,
+	LOGIN_CACHE_TIME,
+	MAP_TILE_EVICTION_INTERVAL,
+	MAP_CLEAN_INCREMENTAL_WINDOW,
+	PROGRESSIVE_SPAWN_TIME,
+	PROGRESSIVE_SPAWN_RADIUS,
+	KV_FLUSH_INTERVAL,
+	SCRIPTS_HOT_RELOAD_INTERVAL,
+	LUA_INSTRUCTION_BUDGET,
+	DISPATCHER_WATCHDOG_THRESHOLD,
+	FLIGHT_RECORDER_WINDOW,
+	FLIGHT_RECORDER_TASK_THRESHOLD,
+	FLIGHT_RECORDER_CYCLE_THRESHOLD,
+	HIGHSCORES_REFRESH_INTERVAL,
+	ALLOCATION_PROFILER_LOG_INTERVAL,
+	ALLOCATION_PROFILER_LOG_CONTEXTS,
+
 	LAST_INTEGER_CONFIG
 };
 
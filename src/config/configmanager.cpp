@@ -13,6 +13,7 @@
 #include "declarations.hpp"
 #include "game/game.hpp"
 #include "lua/scripts/luajit_sync.hpp"
+#include "server/cluster/cluster_bus.hpp"
 #include "server/network/webhook/webhook.hpp"
 
 #if LUA_VERSION_NUM >= 502
@@ -76,6 +77,11 @@ namespace {
 
 }
 
+ConfigManager::ConfigManager() {
+	snapshots.emplace_back(std::make_unique<const Values>());
+	current.store(snapshots.back().get(), std::memory_order_release);
+}
+
 bool ConfigManager::load() {
 	lua_State* L = luaL_newstate();
 	if (!L) {
@@ -94,6 +100,13 @@ bool ConfigManager::load() {
 	g_logger().setLevel(getGlobalString(L, "logLevel", "info"));
 #endif
 
+	// Starts from the current values, so the ones loaded only once are kept
+	auto next = std::make_unique<Values>(values());
+	auto &string = next->string;
+	auto &integer = next->integer;
+	auto &boolean = next->boolean;
+	auto &floating = next->floating;
+
 	// Parse config
 	// Info that must be loaded one time (unless we reset the modules involved)
 	if (!loaded) {
@@ -102,6 +115,7 @@ bool ConfigManager::load() {
 		boolean[TOGGLE_MAP_CUSTOM] = getGlobalBoolean(L, "toggleMapCustom", true);
 
 		string[IP] = getGlobalString(L, "ip", "127.0.0.1");
+		string[METRICS_IP] = getGlobalString(L, "metricsIp", "127.0.0.1");
 		string[MAP_NAME] = getGlobalString(L, "mapName", "canary");
 		string[MAP_DOWNLOAD_URL] = getGlobalString(L, "mapDownloadUrl", "");
 		string[MAP_AUTHOR] = getGlobalString(L, "mapAuthor", "Eduardo Dantas");
@@ -117,14 +131,21 @@ bool ConfigManager::load() {
 		string[MYSQL_PASS] = getGlobalString(L, "mysqlPass", "");
 		string[MYSQL_DB] = getGlobalString(L, "mysqlDatabase", "canary");
 		string[MYSQL_SOCK] = getGlobalString(L, "mysqlSock", "");
+		string[MYSQL_REPLICA_HOST] = getGlobalString(L, "mysqlReplicaHost", "");
 
 		string[AUTH_TYPE] = getGlobalString(L, "authType", "password");
 		boolean[RESET_SESSIONS_ON_STARTUP] = getGlobalBoolean(L, "resetSessionsOnStartup", false);
 
 		integer[SQL_PORT] = getGlobalNumber(L, "mysqlPort", 3306);
+		integer[SQL_REPLICA_PORT] = getGlobalNumber(L, "mysqlReplicaPort", 3306);
+		integer[DATABASE_POOL_SIZE] = getGlobalNumber(L, "databasePoolSize", 2);
+		integer[DATABASE_INSERT_BATCH_SIZE] = getGlobalNumber(L, "databaseInsertBatchSize", 1024 * 1024);
 		integer[GAME_PORT] = getGlobalNumber(L, "gameProtocolPort", 7172);
 		integer[LOGIN_PORT] = getGlobalNumber(L, "loginProtocolPort", 7171);
 		integer[STATUS_PORT] = getGlobalNumber(L, "statusProtocolPort", 7171);
+		integer[METRICS_PORT] = getGlobalNumber(L, "metricsPort", 0);
+		integer[CLUSTER_WORLD_ID] = getGlobalNumber(L, "clusterWorldId", 0);
+		integer[CLUSTER_POLL_INTERVAL_MS] = getGlobalNumber(L, "clusterPollIntervalMs", ClusterBus::DEFAULT_POLL_INTERVAL_MS);
 
 		integer[MARKET_OFFER_DURATION] = getGlobalNumber(L, "marketOfferDuration", 30 * 24 * 60 * 60);
 
@@ -178,6 +199,8 @@ bool ConfigManager::load() {
 	boolean[SORT_LOOT_BY_CHANCE] = getGlobalBoolean(L, "sortLootByChance", false);
 	boolean[TOGGLE_SAVE_INTERVAL] = getGlobalBoolean(L, "toggleSaveInterval", false);
 	boolean[TOGGLE_SAVE_INTERVAL_CLEAN_MAP] = getGlobalBoolean(L, "toggleSaveIntervalCleanMap", false);
+	boolean[PLAYER_INCREMENTAL_SAVE] = getGlobalBoolean(L, "playerIncrementalSave", true);
+	boolean[PLAYER_DEPOT_ITEM_DIFF] = getGlobalBoolean(L, "playerDepotItemDiff", false);
 	boolean[TELEPORT_SUMMONS] = getGlobalBoolean(L, "teleportSummons", false);
 	boolean[ALLOW_RELOAD] = getGlobalBoolean(L, "allowReload", false);
 
@@ -232,6 +255,7 @@ bool ConfigManager::load() {
 	integer[PROTECTION_LEVEL] = getGlobalNumber(L, "protectionLevel", 1);
 	integer[DEATH_LOSE_PERCENT] = getGlobalNumber(L, "deathLosePercent", -1);
 	integer[STATUSQUERY_TIMEOUT] = getGlobalNumber(L, "statusTimeout", 5000);
+	integer[STATUS_CACHE_TIME] = getGlobalNumber(L, "statusCacheTime", 5000);
 	integer[FRAG_TIME] = getGlobalNumber(L, "timeToDecreaseFrags", 24 * 60 * 60 * 1000);
 	integer[WHITE_SKULL_TIME] = getGlobalNumber(L, "whiteSkullTime", 15 * 60 * 1000);
 	integer[STAIRHOP_DELAY] = getGlobalNumber(L, "stairJumpExhaustion", 2000);
@@ -393,6 +417,51 @@ bool ConfigManager::load() {
 
 	boolean[TOGGLE_HOUSE_TRANSFER_ON_SERVER_RESTART] = getGlobalBoolean(L, "togglehouseTransferOnRestart", false);
 
+	boolean[TOGGLE_TASK_PROFILER] = getGlobalBoolean(L, "toggleTaskProfiler", true);
+	integer[TASK_PROFILER_LOG_INTERVAL] = getGlobalNumber(L, "taskProfilerLogInterval", 10 * 60);
+	integer[TASK_PROFILER_LOG_CONTEXTS] = getGlobalNumber(L, "taskProfilerLogContexts", 10);
+
+	boolean[TOGGLE_NETWORK_PROFILER] = getGlobalBoolean(L, "toggleNetworkProfiler", true);
+	integer[NETWORK_PROFILER_SLOW_PACKET_MS] = getGlobalNumber(L, "networkProfilerSlowPacketMs", 50);
+
+	boolean[TOGGLE_LUA_PROFILER] = getGlobalBoolean(L, "toggleLuaProfiler", false);
+	boolean[LUA_POSITION_USERDATA] = getGlobalBoolean(L, "luaPositionUserdata", false);
+	boolean[LUA_FFI_GETTERS] = getGlobalBoolean(L, "luaFfiGetters", false);
+	boolean[LUA_BYTECODE_CACHE] = getGlobalBoolean(L, "luaBytecodeCache", true);
+	boolean[LUA_ABORT_OVER_BUDGET] = getGlobalBoolean(L, "luaAbortOverBudget", false);
+
+	boolean[THREAD_POOL_CPU_PINNING] = getGlobalBoolean(L, "threadPoolCpuPinning", false);
+	integer[THREAD_POOL_COMPUTE_THREADS] = getGlobalNumber(L, "threadPoolComputeThreads", 0);
+	integer[THREAD_POOL_BLOCKING_THREADS] = getGlobalNumber(L, "threadPoolBlockingThreads", 4);
+	integer[MAX_PENDING_LOGINS] = getGlobalNumber(L, "maxPendingLogins", 256);
+	integer[BAN_SYNC_INTERVAL] = getGlobalNumber(L, "banSyncInterval", 60);
+	integer[LOGIN_CACHE_TIME] = getGlobalNumber(L, "loginCacheTime", 60);
+
+	boolean[MAP_SECTOR_INDEX] = getGlobalBoolean(L, "mapSectorIndex", false);
+	boolean[MAP_SNAPSHOT] = getGlobalBoolean(L, "mapSnapshot", true);
+	boolean[WORLD_SNAPSHOT] = getGlobalBoolean(L, "worldSnapshot", false);
+	boolean[PARALLEL_STARTUP] = getGlobalBoolean(L, "parallelStartup", true);
+	integer[MAP_TILE_EVICTION_INTERVAL] = getGlobalNumber(L, "mapTileEvictionInterval", 60);
+	integer[MAP_CLEAN_INCREMENTAL_WINDOW] = getGlobalNumber(L, "mapCleanIncrementalWindow", 30);
+	integer[PROGRESSIVE_SPAWN_TIME] = getGlobalNumber(L, "progressiveSpawnTime", 0);
+	integer[PROGRESSIVE_SPAWN_RADIUS] = getGlobalNumber(L, "progressiveSpawnRadius", 100);
+	integer[KV_FLUSH_INTERVAL] = getGlobalNumber(L, "kvFlushInterval", 60);
+	integer[SCRIPTS_HOT_RELOAD_INTERVAL] = getGlobalNumber(L, "scriptsHotReloadInterval", 0);
+	integer[LUA_INSTRUCTION_BUDGET] = getGlobalNumber(L, "luaInstructionBudget", 0);
+	integer[DISPATCHER_WATCHDOG_THRESHOLD] = getGlobalNumber(L, "dispatcherWatchdogThreshold", 0);
+	integer[FLIGHT_RECORDER_WINDOW] = getGlobalNumber(L, "flightRecorderWindow", 0);
+	integer[FLIGHT_RECORDER_TASK_THRESHOLD] = getGlobalNumber(L, "flightRecorderTaskThreshold", 100);
+	integer[FLIGHT_RECORDER_CYCLE_THRESHOLD] = getGlobalNumber(L, "flightRecorderCycleThreshold", 200);
+	integer[HIGHSCORES_REFRESH_INTERVAL] = getGlobalNumber(L, "highscoresRefreshInterval", 300);
+	integer[ALLOCATION_PROFILER_LOG_INTERVAL] = getGlobalNumber(L, "allocationProfilerLogInterval", 60);
+	integer[ALLOCATION_PROFILER_LOG_CONTEXTS] = getGlobalNumber(L, "allocationProfilerLogContexts", 10);
+	boolean[SESSION_RECORDING] = getGlobalBoolean(L, "sessionRecording", false);
+	string[SESSION_REPLAY] = getGlobalString(L, "sessionReplay", "");
+
+	const auto published = next.get();
+	snapshots.emplace_back(std::move(next));
+	current.store(published, std::memory_order_release);
+
 	loaded = true;
 	lua_close(L);
 	return true;
@@ -413,7 +482,7 @@ const std::string &ConfigManager::getString(stringConfig_t what) const {
 		g_logger().warn("[ConfigManager::getString] - Accessing invalid index: {}", fmt::underlying(what));
 		return dummyStr;
 	}
-	return string[what];
+	return values().string[what];
 }
 
 int32_t ConfigManager::getNumber(integerConfig_t what) const {
@@ -421,7 +490,7 @@ int32_t ConfigManager::getNumber(integerConfig_t what) const {
 		g_logger().warn("[ConfigManager::getNumber] - Accessing invalid index: {}", fmt::underlying(what));
 		return 0;
 	}
-	return integer[what];
+	return values().integer[what];
 }
 
 int16_t ConfigManager::getShortNumber(integerConfig_t what) const {
@@ -429,7 +498,7 @@ int16_t ConfigManager::getShortNumber(integerConfig_t what) const {
 		g_logger().warn("[ConfigManager::getShortNumber] - Accessing invalid index: {}", fmt::underlying(what));
 		return 0;
 	}
-	return integer[what];
+	return values().integer[what];
 }
 
 bool ConfigManager::getBoolean(booleanConfig_t what) const {
@@ -437,7 +506,7 @@ bool ConfigManager::getBoolean(booleanConfig_t what) const {
 		g_logger().warn("[ConfigManager::getBoolean] - Accessing invalid index: {}", fmt::underlying(what));
 		return false;
 	}
-	return boolean[what];
+	return values().boolean[what];
 }
 
 float ConfigManager::getFloat(floatingConfig_t what) const {
@@ -445,5 +514,5 @@ float ConfigManager::getFloat(floatingConfig_t what) const {
 		g_logger().warn("[ConfigManager::getFLoat] - Accessing invalid index: {}", fmt::underlying(what));
 		return 0;
 	}
-	return floating[what];
+	return values().floating[what];
 }
@@ -14,7 +14,7 @@
 
 class ConfigManager {
 public:
-	ConfigManager() = default;
+	ConfigManager();
 
 	// Singleton - ensures we don't accidentally copy it
 	ConfigManager(const ConfigManager &) = delete;
@@ -42,12 +42,28 @@ public:
 	};
 
 private:
+	// One whole configuration, never changed once published
+	struct Values {
+		std::string string[LAST_STRING_CONFIG] = {};
+		int32_t integer[LAST_INTEGER_CONFIG] = {};
+		bool boolean[LAST_BOOLEAN_CONFIG] = {};
+		float floating[LAST_FLOATING_CONFIG] = {};
+	};
+
+	const Values &values() const {
+		return *current.load(std::memory_order_acquire);
+	}
+
 	std::string configFileLua = { "config.lua" };
 
-	std::string string[LAST_STRING_CONFIG] = {};
-	int32_t integer[LAST_INTEGER_CONFIG] = {};
-	bool boolean[LAST_BOOLEAN_CONFIG] = {};
-	float floating[LAST_FLOATING_CONFIG] = {};
+	/**
+	 * A load builds new values and publishes them with one store, so a read
+	 * from any thread is a load and an index and never sees a reload half
+	 * done. Replaced values are kept, a reader may still hold one of their
+	 * strings; a reload is kilobytes, and rare.
+	 */
+	std::vector<std::unique_ptr<const Values>> snapshots;
+	std::atomic<const Values*> current;
 
 	bool loaded = false;
 };
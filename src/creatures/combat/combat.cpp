@@ -12,21 +12,63 @@
 #include "declarations.hpp"
 #include "creatures/combat/combat.hpp"
 #include "lua/creature/events.hpp"
+#include "creatures/players/grouping/party.hpp"
 #include "creatures/players/wheel/player_wheel.hpp"
 #include "game/game.hpp"
 #include "io/iobestiary.hpp"
 #include "creatures/monsters/monster.hpp"
 #include "creatures/monsters/monsters.hpp"
 #include "items/weapons/weapons.hpp"
+#include "lib/profiling/profiler.hpp"
+
+namespace {
+	/**
+	 * Tile list of a CombatFunc call. Callbacks (scripts, deaths) can cast
+	 * again from inside the call, so each one borrows its own vector from
+	 * a per thread pool instead of sharing a single buffer.
+	 */
+	class CombatTileBuffer {
+	public:
+		CombatTileBuffer() {
+			auto &pool = getPool();
+			if (pool.empty()) {
+				tiles = std::make_unique<std::vector<std::shared_ptr<Tile>>>();
+			} else {
+				tiles = std::move(pool.back());
+				pool.pop_back();
+			}
+		}
+		~CombatTileBuffer() {
+			tiles->clear();
+			getPool().emplace_back(std::move(tiles));
+		}
+
+		// Ensures that we don't accidentally copy it
+		CombatTileBuffer(const CombatTileBuffer &) = delete;
+		CombatTileBuffer operator=(const CombatTileBuffer &) = delete;
+
+		std::vector<std::shared_ptr<Tile>> &get() {
+			return *tiles;
+		}
 
-int32_t Combat::getLevelFormula(std::shared_ptr<Player> player, const std::shared_ptr<Spell> wheelSpell, const CombatDamage &damage) const {
+	private:
+		static std::vector<std::unique_ptr<std::vector<std::shared_ptr<Tile>>>> &getPool() {
+			static thread_local std::vector<std::unique_ptr<std::vector<std::shared_ptr<Tile>>>> pool;
+			return pool;
+		}
+
+		std::unique_ptr<std::vector<std::shared_ptr<Tile>>> tiles;
+	};
+}
+
+int32_t Combat::getLevelFormula(const std::shared_ptr<Player> &player, const std::shared_ptr<Spell> wheelSpell, const CombatDamage &damage) const {
 	if (!player) {
 		return 0;
 	}
 
 	uint32_t magicLevelSkill = player->getMagicLevel();
 	// Wheel of destiny - Runic Mastery
-	if (player->wheel()->getInstant("Runic Mastery") && wheelSpell && damage.instantSpellName.empty() && normal_random(0, 100) <= 25) {
+	if (player->wheel()->getCombatBonus().runicMastery && wheelSpell && damage.instantSpellName.empty() && normal_random(0, 100) <= 25) {
 		const auto conjuringSpell = g_spells().getInstantSpellByName(damage.runeSpellName);
 		if (conjuringSpell && conjuringSpell != wheelSpell) {
 			uint32_t castResult = conjuringSpell->canCast(player) ? 20 : 10;
@@ -38,7 +80,7 @@ int32_t Combat::getLevelFormula(std::shared_ptr<Player> player, const std::share
 	return levelFormula;
 }
 
-CombatDamage Combat::getCombatDamage(std::shared_ptr<Creature> creature, std::shared_ptr<Creature> target) const {
+CombatDamage Combat::getCombatDamage(const std::shared_ptr<Creature> &creature, const std::shared_ptr<Creature> &target) const {
 	CombatDamage damage;
 	damage.origin = params.origin;
 	damage.primary.type = params.combatType;
@@ -72,7 +114,7 @@ CombatDamage Combat::getCombatDamage(std::shared_ptr<Creature> creature, std::sh
 				);
 			} else if (formulaType == COMBAT_FORMULA_SKILL) {
 				std::shared_ptr<Item> tool = player->getWeapon();
-				const Weapon* weapon = g_weapons().getWeapon(tool);
+				const Weapon* weapon = player->getWeaponScript();
 				if (weapon) {
 					damage.primary.value = normal_random(
 						static_cast<int32_t>(minb),
@@ -99,7 +141,7 @@ CombatDamage Combat::getCombatDamage(std::shared_ptr<Creature> creature, std::sh
 	return damage;
 }
 
-void Combat::getCombatArea(const Position &centerPos, const Position &targetPos, const std::unique_ptr<AreaCombat> &area, std::forward_list<std::shared_ptr<Tile>> &list) {
+void Combat::getCombatArea(const Position &centerPos, const Position &targetPos, const std::unique_ptr<AreaCombat> &area, std::vector<std::shared_ptr<Tile>> &list) {
 	if (targetPos.z >= MAP_MAX_LAYERS) {
 		return;
 	}
@@ -107,7 +149,7 @@ void Combat::getCombatArea(const Position &centerPos, const Position &targetPos,
 	if (area) {
 		area->getList(centerPos, targetPos, list);
 	} else {
-		list.push_front(g_game().map.getOrCreateTile(targetPos));
+		list.emplace_back(g_game().map.getOrCreateTile(targetPos));
 	}
 }
 
@@ -175,7 +217,7 @@ ConditionType_t Combat::DamageToConditionType(CombatType_t type) {
 	}
 }
 
-bool Combat::isPlayerCombat(std::shared_ptr<Creature> target) {
+bool Combat::isPlayerCombat(const std::shared_ptr<Creature> &target) {
 	if (target->getPlayer()) {
 		return true;
 	}
@@ -187,7 +229,7 @@ bool Combat::isPlayerCombat(std::shared_ptr<Creature> target) {
 	return false;
 }
 
-ReturnValue Combat::canTargetCreature(std::shared_ptr<Player> player, std::shared_ptr<Creature> target) {
+ReturnValue Combat::canTargetCreature(const std::shared_ptr<Player> &player, const std::shared_ptr<Creature> &target) {
 	if (player == target) {
 		return RETURNVALUE_YOUMAYNOTATTACKTHISPLAYER;
 	}
@@ -235,7 +277,7 @@ ReturnValue Combat::canTargetCreature(std::shared_ptr<Player> player, std::share
 	return Combat::canDoCombat(player, target, true);
 }
 
-ReturnValue Combat::canDoCombat(std::shared_ptr<Creature> caster, std::shared_ptr<Tile> tile, bool aggressive) {
+ReturnValue Combat::canDoCombat(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Tile> &tile, bool aggressive) {
 	if (tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
 		return RETURNVALUE_NOTENOUGHROOM;
 	}
@@ -267,14 +309,17 @@ ReturnValue Combat::canDoCombat(std::shared_ptr<Creature> caster, std::shared_pt
 		}
 	}
 
+	if (!g_events().hasHandler(EventHandler_t::CREATURE_ON_AREA_COMBAT)) {
+		return RETURNVALUE_NOERROR;
+	}
 	return g_events().eventCreatureOnAreaCombat(caster, tile, aggressive);
 }
 
-bool Combat::isInPvpZone(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target) {
+bool Combat::isInPvpZone(const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target) {
 	return attacker->getZoneType() == ZONE_PVP && target->getZoneType() == ZONE_PVP;
 }
 
-bool Combat::isProtected(std::shared_ptr<Player> attacker, std::shared_ptr<Player> target) {
+bool Combat::isProtected(const std::shared_ptr<Player> &attacker, const std::shared_ptr<Player> &target) {
 	uint32_t protectionLevel = g_configManager().getNumber(PROTECTION_LEVEL);
 	if (target->getLevel() < protectionLevel || attacker->getLevel() < protectionLevel) {
 		return true;
@@ -291,7 +336,7 @@ bool Combat::isProtected(std::shared_ptr<Player> attacker, std::shared_ptr<Playe
 	return false;
 }
 
-ReturnValue Combat::canDoCombat(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target, bool aggressive) {
+ReturnValue Combat::canDoCombat(const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, bool aggressive) {
 	if (!aggressive) {
 		return RETURNVALUE_NOERROR;
 	}
@@ -401,6 +446,9 @@ ReturnValue Combat::canDoCombat(std::shared_ptr<Creature> attacker, std::shared_
 			}
 		}
 	}
+	if (!g_events().hasHandler(EventHandler_t::CREATURE_ON_TARGET_COMBAT)) {
+		return RETURNVALUE_NOERROR;
+	}
 	return g_events().eventCreatureOnTargetCombat(attacker, target);
 }
 
@@ -543,7 +591,7 @@ CallBack* Combat::getCallback(CallBackParam_t key) {
 	return nullptr;
 }
 
-void Combat::CombatHealthFunc(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params, CombatDamage* data) {
+void Combat::CombatHealthFunc(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage* data) {
 	assert(data);
 	CombatDamage damage = *data;
 
@@ -648,7 +696,7 @@ CombatDamage Combat::applyImbuementElementalDamage(std::shared_ptr<Player> attac
 	return damage;
 }
 
-void Combat::CombatManaFunc(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params, CombatDamage* data) {
+void Combat::CombatManaFunc(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage* data) {
 	assert(data);
 	CombatDamage damage = *data;
 	if (damage.primary.value < 0) {
@@ -662,7 +710,7 @@ void Combat::CombatManaFunc(std::shared_ptr<Creature> caster, std::shared_ptr<Cr
 	}
 }
 
-bool Combat::checkFearConditionAffected(std::shared_ptr<Player> player) {
+bool Combat::checkFearConditionAffected(const std::shared_ptr<Player> &player) {
 	if (player->isImmuneFear()) {
 		return false;
 	}
@@ -690,7 +738,7 @@ bool Combat::checkFearConditionAffected(std::shared_ptr<Player> player) {
 	return true;
 }
 
-void Combat::CombatConditionFunc(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params, CombatDamage* data) {
+void Combat::CombatConditionFunc(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage* data) {
 	if (params.origin == ORIGIN_MELEE && data && data->primary.value == 0 && data->secondary.value == 0) {
 		return;
 	}
@@ -729,6 +777,12 @@ void Combat::CombatConditionFunc(std::shared_ptr<Creature> caster, std::shared_p
 		}
 
 		if (caster == target || target && !target->isImmune(condition->getType())) {
+			// Conditions that only carry their ticks extend the running one, the template is cloned for new ones only
+			if (target && target->refreshCondition(condition->getType(), condition->getId(), condition->getTicks(), condition->getSubId())) {
+				target->onAddCombatCondition(condition->getType());
+				continue;
+			}
+
 			auto conditionCopy = condition->clone();
 			if (caster) {
 				conditionCopy->setParam(CONDITION_PARAM_OWNER, caster->getID());
@@ -743,18 +797,18 @@ void Combat::CombatConditionFunc(std::shared_ptr<Creature> caster, std::shared_p
 	}
 }
 
-void Combat::CombatDispelFunc(std::shared_ptr<Creature>, std::shared_ptr<Creature> target, const CombatParams &params, CombatDamage*) {
+void Combat::CombatDispelFunc(const std::shared_ptr<Creature> &, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage*) {
 	if (target) {
 		target->removeCombatCondition(params.dispelType);
 	}
 }
 
-void Combat::CombatNullFunc(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params, CombatDamage*) {
+void Combat::CombatNullFunc(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage*) {
 	CombatConditionFunc(caster, target, params, nullptr);
 	CombatDispelFunc(caster, target, params, nullptr);
 }
 
-void Combat::combatTileEffects(const SpectatorHashSet &spectators, std::shared_ptr<Creature> caster, std::shared_ptr<Tile> tile, const CombatParams &params) {
+void Combat::combatTileEffects(const SpectatorHashSet &spectators, const std::shared_ptr<Creature> &caster, const std::shared_ptr<Tile> &tile, const CombatParams &params) {
 	if (params.itemId != 0) {
 		uint16_t itemId = params.itemId;
 		switch (itemId) {
@@ -843,7 +897,7 @@ void Combat::combatTileEffects(const SpectatorHashSet &spectators, std::shared_p
 	}
 }
 
-void Combat::postCombatEffects(std::shared_ptr<Creature> caster, const Position &origin, const Position &pos, const CombatParams &params) {
+void Combat::postCombatEffects(const std::shared_ptr<Creature> &caster, const Position &origin, const Position &pos, const CombatParams &params) {
 	if (caster && params.distanceEffect != CONST_ANI_NONE) {
 		addDistanceEffect(caster, origin, pos, params.distanceEffect);
 	}
@@ -855,7 +909,7 @@ void Combat::postCombatEffects(std::shared_ptr<Creature> caster, const Position
 	}
 }
 
-void Combat::addDistanceEffect(std::shared_ptr<Creature> caster, const Position &fromPos, const Position &toPos, uint16_t effect) {
+void Combat::addDistanceEffect(const std::shared_ptr<Creature> &caster, const Position &fromPos, const Position &toPos, uint16_t effect) {
 	if (effect == CONST_ANI_WEAPONTYPE) {
 		if (!caster) {
 			return;
@@ -990,39 +1044,31 @@ bool Combat::doCombat(std::shared_ptr<Creature> caster, const Position &position
 }
 
 void Combat::CombatFunc(std::shared_ptr<Creature> caster, const Position &origin, const Position &pos, const std::unique_ptr<AreaCombat> &area, const CombatParams &params, CombatFunction func, CombatDamage* data) {
-	std::forward_list<std::shared_ptr<Tile>> tileList;
+	CANARY_PROFILE_ZONE("Combat::CombatFunc");
+	CombatTileBuffer tileBuffer;
+	auto &tileList = tileBuffer.get();
 
-	if (caster) {
-		getCombatArea(caster->getPosition(), pos, area, tileList);
-	} else {
-		getCombatArea(pos, pos, area, tileList);
-	}
+	const Position &centerPos = caster ? caster->getPosition() : pos;
+	getCombatArea(centerPos, pos, area, tileList);
 
 	SpectatorHashSet spectators;
 	uint32_t maxX = 0;
 	uint32_t maxY = 0;
 
-	// calculate the max viewable range
-	for (std::shared_ptr<Tile> tile : tileList) {
-		const Position &tilePos = tile->getPosition();
-
-		uint32_t diff = Position::getDistanceX(tilePos, pos);
-		if (diff > maxX) {
-			maxX = diff;
-		}
-
-		diff = Position::getDistanceY(tilePos, pos);
-		if (diff > maxY) {
-			maxY = diff;
-		}
+	// the max viewable range, from the area bounds
+	if (area) {
+		area->getRange(centerPos, pos, maxX, maxY);
 	}
 
 	const int32_t rangeX = maxX + MAP_MAX_VIEW_PORT_X;
 	const int32_t rangeY = maxY + MAP_MAX_VIEW_PORT_Y;
 	g_game().map.getSpectators(spectators, pos, true, true, rangeX, rangeX, rangeY, rangeY);
+	// Damage, messages and sounds of the whole cast reuse this single scan
+	CombatSpectators castSpectators(spectators, pos, maxX, maxY);
+	PartyAnalyzerBatch analyzerBatch;
 
 	int affected = 0;
-	for (std::shared_ptr<Tile> tile : tileList) {
+	for (const auto &tile : tileList) {
 		if (canDoCombat(caster, tile, params.aggressive) != RETURNVALUE_NOERROR) {
 			continue;
 		}
@@ -1076,7 +1122,7 @@ void Combat::CombatFunc(std::shared_ptr<Creature> caster, const Position &origin
 	uint8_t beamAffectedCurrent = 0;
 
 	tmpDamage.affected = affected;
-	for (std::shared_ptr<Tile> tile : tileList) {
+	for (const auto &tile : tileList) {
 		if (canDoCombat(caster, tile, params.aggressive) != RETURNVALUE_NOERROR) {
 			continue;
 		}
@@ -1393,25 +1439,66 @@ std::vector<std::pair<Position, std::vector<uint32_t>>> Combat::pickChainTargets
 		maxTargets++;
 	}
 
+	// Every hop stays within chainDistance of the previous one, so a single scan around the start covers the whole chain
+	struct ChainCandidate {
+		std::shared_ptr<Creature> creature;
+		// Whether the caster may hit it, decided on first use: -1 unknown
+		int8_t targetable = -1;
+	};
+	std::vector<ChainCandidate> candidates;
+	{
+		const int32_t reach = static_cast<int32_t>(chainDistance) * maxTargets;
+		SpectatorHashSet spectators;
+		g_game().map.getSpectators(spectators, targets.back()->getPosition(), false, false, reach, reach, reach, reach);
+		candidates.reserve(spectators.size());
+		for (const auto &spectator : spectators) {
+			if (spectator) {
+				candidates.push_back({ spectator });
+			}
+		}
+	}
+	// Sight lines already checked, keyed by the ids of both ends
+	phmap::flat_hash_map<uint64_t, bool> sightCache;
+
 	const int maxBacktrackingAttempts = 10; // Can be adjusted as needed
 	while (!targets.empty() && targets.size() <= maxTargets) {
 		auto currentTarget = targets.back();
-		SpectatorHashSet spectators;
-		g_game().map.getSpectators(spectators, currentTarget->getPosition(), false, false, chainDistance, chainDistance, chainDistance, chainDistance);
-		g_logger().debug("Combat::pickChainTargets: currentTarget: {}, spectators: {}", currentTarget->getName(), spectators.size());
+		const Position &currentPos = currentTarget->getPosition();
+		g_logger().debug("Combat::pickChainTargets: currentTarget: {}, candidates: {}", currentTarget->getName(), candidates.size());
 
 		double closestDistance = std::numeric_limits<double>::max();
 		std::shared_ptr<Creature> closestSpectator = nullptr;
-		for (std::shared_ptr<Creature> spectator : spectators) {
-			if (!spectator || visited.contains(spectator->getID())) {
+		for (auto &candidate : candidates) {
+			const auto &spectator = candidate.creature;
+			const Position &spectatorPos = spectator->getPosition();
+			if (spectatorPos.z != currentPos.z || Position::getDistanceX(currentPos, spectatorPos) > chainDistance || Position::getDistanceY(currentPos, spectatorPos) > chainDistance) {
 				continue;
 			}
-			if (!isValidChainTarget(caster, currentTarget, spectator, params, aggressive)) {
+
+			if (visited.contains(spectator->getID())) {
+				continue;
+			}
+
+			if (candidate.targetable == -1) {
+				candidate.targetable = isValidChainTarget(caster, spectator, params, aggressive);
+			}
+
+			bool valid = candidate.targetable == 1;
+			if (valid) {
+				const uint64_t sightKey = (static_cast<uint64_t>(currentTarget->getID()) << 32) | spectator->getID();
+				auto [it, inserted] = sightCache.try_emplace(sightKey, false);
+				if (inserted) {
+					it->second = g_game().isSightClear(currentPos, spectatorPos, true);
+				}
+				valid = it->second;
+			}
+
+			if (!valid) {
 				visited.insert(spectator->getID());
 				continue;
 			}
 
-			double distance = Position::getEuclideanDistance(currentTarget->getPosition(), spectator->getPosition());
+			double distance = Position::getEuclideanDistance(currentPos, spectatorPos);
 			if (distance < closestDistance) {
 				closestDistance = distance;
 				closestSpectator = spectator;
@@ -1448,23 +1535,22 @@ std::vector<std::pair<Position, std::vector<uint32_t>>> Combat::pickChainTargets
 	return resultMap;
 }
 
-bool Combat::isValidChainTarget(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> currentTarget, std::shared_ptr<Creature> potentialTarget, const CombatParams &params, bool aggressive) {
+bool Combat::isValidChainTarget(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &potentialTarget, const CombatParams &params, bool aggressive) {
 	bool canCombat = canDoCombat(caster, potentialTarget, aggressive) == RETURNVALUE_NOERROR;
 	bool pick = params.chainPickerCallback ? params.chainPickerCallback->onChainCombat(caster, potentialTarget) : true;
-	bool hasSight = g_game().isSightClear(currentTarget->getPosition(), potentialTarget->getPosition(), true);
-	return canCombat && pick && hasSight;
+	return canCombat && pick;
 }
 
 //**********************************************************//
 
-uint32_t ValueCallback::getMagicLevelSkill(std::shared_ptr<Player> player, const CombatDamage &damage) const {
+uint32_t ValueCallback::getMagicLevelSkill(const std::shared_ptr<Player> &player, const CombatDamage &damage) const {
 	if (!player) {
 		return 0;
 	}
 
 	uint32_t magicLevelSkill = player->getMagicLevel();
 	// Wheel of destiny
-	if (player && player->wheel()->getInstant("Runic Mastery") && damage.instantSpellName.empty()) {
+	if (player && player->wheel()->getCombatBonus().runicMastery && damage.instantSpellName.empty()) {
 		const std::shared_ptr<Spell> spell = g_spells().getRuneSpellByName(damage.runeSpellName);
 		// Rune conjuring spell have the same name as the rune item spell.
 		const std::shared_ptr<InstantSpell> conjuringSpell = g_spells().getInstantSpellByName(damage.runeSpellName);
@@ -1477,7 +1563,98 @@ uint32_t ValueCallback::getMagicLevelSkill(std::shared_ptr<Player> player, const
 	return magicLevelSkill + player->getSpecializedMagicLevel(damage.primary.type, true);
 }
 
-void ValueCallback::getMinMaxValues(std::shared_ptr<Player> player, CombatDamage &damage, bool useCharges) const {
+void ValueCallback::compileFormula() {
+	nativeFormula.reset();
+	if (type != COMBAT_FORMULA_LEVELMAGIC || !scriptInterface || !scriptInterface->reserveScriptEnv()) {
+		return;
+	}
+
+	ScriptEnvironment* env = scriptInterface->getScriptEnv();
+	if (!env->setCallbackId(scriptId, scriptInterface)) {
+		scriptInterface->resetScriptEnv();
+		return;
+	}
+
+	lua_State* L = scriptInterface->getLuaState();
+	const int top = lua_gettop(L);
+
+	// Stand-in player, any method call or field access aborts the probe
+	lua_newtable(L);
+	lua_newtable(L);
+	static constexpr std::array<const char*, 4> playerEvents = { "__index", "__newindex", "__call", "__concat" };
+	for (const auto event : playerEvents) {
+		lua_pushcfunction(L, [](lua_State* state) -> int {
+			return luaL_error(state, "formula uses the player");
+		});
+		lua_setfield(L, -2, event);
+	}
+	lua_setmetatable(L, -2);
+	const int playerIndex = lua_gettop(L);
+
+	// The first three points fit the coefficients, the rest must agree with them
+	static constexpr std::array<std::pair<uint32_t, uint32_t>, 9> probes = { {
+		{ 100, 0 }, { 101, 0 }, { 100, 1 },
+		{ 1, 0 }, { 8, 3 }, { 137, 59 }, { 600, 112 }, { 1250, 7 }, { 2000, 150 },
+	} };
+	std::array<std::pair<double, double>, probes.size()> results;
+	bool linear = true;
+	for (size_t i = 0; linear && i < probes.size(); ++i) {
+		scriptInterface->pushFunction(scriptId);
+		lua_pushvalue(L, playerIndex);
+		lua_pushnumber(L, probes[i].first);
+		lua_pushnumber(L, probes[i].second);
+		if (lua_pcall(L, 3, 2, 0) != 0) {
+			lua_pop(L, 1);
+			linear = false;
+			break;
+		}
+
+		linear = lua_type(L, -2) == LUA_TNUMBER && lua_type(L, -1) == LUA_TNUMBER;
+		results[i] = { lua_tonumber(L, -2), lua_tonumber(L, -1) };
+		lua_pop(L, 2);
+	}
+
+	lua_settop(L, top);
+	scriptInterface->resetScriptEnv();
+	if (!linear) {
+		return;
+	}
+
+	const auto fit = [&results](auto value) {
+		LinearFormula formula;
+		formula.perLevel = value(results[1]) - value(results[0]);
+		formula.perMagicLevel = value(results[2]) - value(results[0]);
+		formula.base = value(results[0]) - probes[0].first * formula.perLevel;
+		return formula;
+	};
+	const auto minFormula = fit([](const auto &result) { return result.first; });
+	const auto maxFormula = fit([](const auto &result) { return result.second; });
+
+	const auto matches = [](const LinearFormula &formula, const std::pair<uint32_t, uint32_t> &probe, double expected) {
+		return std::abs(formula.apply(probe.first, probe.second) - expected) <= 1e-6 * std::max(1.0, std::abs(expected));
+	};
+	for (size_t i = 3; i < probes.size(); ++i) {
+		if (!matches(minFormula, probes[i], results[i].first) || !matches(maxFormula, probes[i], results[i].second)) {
+			return;
+		}
+	}
+
+	nativeFormula = { minFormula, maxFormula };
+}
+
+void ValueCallback::getMinMaxValues(const std::shared_ptr<Player> &player, CombatDamage &damage, bool useCharges) const {
+	if (nativeFormula) {
+		const double level = player->getLevel();
+		const double magicLevel = getMagicLevelSkill(player, damage);
+		damage.primary.value = normal_random(
+			static_cast<int32_t>(nativeFormula->first.apply(level, magicLevel)),
+			static_cast<int32_t>(nativeFormula->second.apply(level, magicLevel))
+		);
+		damage.secondary.type = COMBAT_NONE;
+		damage.secondary.value = 0;
+		return;
+	}
+
 	// onGetPlayerMinMaxValues(...)
 	if (!scriptInterface->reserveScriptEnv()) {
 		g_logger().error("[ValueCallback::getMinMaxValues - Player {} formula {}] "
@@ -1516,7 +1693,7 @@ void ValueCallback::getMinMaxValues(std::shared_ptr<Player> player, CombatDamage
 		case COMBAT_FORMULA_SKILL: {
 			// onGetPlayerMinMaxValues(player, attackSkill, attackValue, attackFactor)
 			std::shared_ptr<Item> tool = player->getWeapon();
-			const Weapon* weapon = g_weapons().getWeapon(tool);
+			const Weapon* weapon = player->getWeaponScript();
 			std::shared_ptr<Item> item = nullptr;
 
 			if (weapon) {
@@ -1769,8 +1946,37 @@ bool ChainPickerCallback::onChainCombat(std::shared_ptr<Creature> creature, std:
 
 //**********************************************************//
 
+CombatSpectators::CombatSpectators(const SpectatorHashSet &spectators, const Position &centerPos, uint32_t areaRangeX, uint32_t areaRangeY) :
+	previous(current), spectators(spectators), centerPos(centerPos), areaRangeX(areaRangeX), areaRangeY(areaRangeY) {
+	current = this;
+}
+
+CombatSpectators::~CombatSpectators() {
+	current = previous;
+}
+
+bool CombatSpectators::find(SpectatorHashSet &result, const Position &pos, bool multifloor) {
+	for (auto cast = current; cast; cast = cast->previous) {
+		// Every view from inside the area is within the scanned range
+		if (pos.z != cast->centerPos.z || static_cast<uint32_t>(Position::getDistanceX(pos, cast->centerPos)) > cast->areaRangeX || static_cast<uint32_t>(Position::getDistanceY(pos, cast->centerPos)) > cast->areaRangeY) {
+			continue;
+		}
+
+		for (const auto &spectator : cast->spectators) {
+			if (!spectator->isRemoved() && Map::isInSpectatorView(pos, spectator->getPosition(), multifloor)) {
+				result.insert(spectator);
+			}
+		}
+		return true;
+	}
+	return false;
+}
+
+//**********************************************************//
+
 void AreaCombat::clear() {
 	areas.clear();
+	compiledAreas = {};
 }
 
 AreaCombat::AreaCombat(const AreaCombat &rhs) {
@@ -1778,28 +1984,71 @@ AreaCombat::AreaCombat(const AreaCombat &rhs) {
 	for (const auto &it : rhs.areas) {
 		areas[it.first] = it.second->clone();
 	}
+	compiledAreas = rhs.compiledAreas;
 }
 
-void AreaCombat::getList(const Position &centerPos, const Position &targetPos, std::forward_list<std::shared_ptr<Tile>> &list) const {
-	const std::unique_ptr<MatrixArea> &area = getArea(centerPos, targetPos);
-	if (!area) {
+void AreaCombat::getList(const Position &centerPos, const Position &targetPos, std::vector<std::shared_ptr<Tile>> &list) const {
+	const CompiledArea &area = getCompiledArea(centerPos, targetPos);
+	if (area.cells.empty()) {
 		return;
 	}
 
-	uint32_t centerY, centerX;
-	area->getCenter(centerY, centerX);
-
-	Position tmpPos(targetPos.x - centerX, targetPos.y - centerY, targetPos.z);
-	uint32_t cols = area->getCols();
-	for (uint32_t y = 0, rows = area->getRows(); y < rows; ++y) {
-		for (uint32_t x = 0; x < cols; ++x) {
-			if (area->getValue(y, x) != 0 && g_game().isSightClear(targetPos, tmpPos, true)) {
-				list.push_front(g_game().map.getOrCreateTile(tmpPos));
+	// Every sight line from the center stays within the grid, so the blocking tiles are read once
+	const Position gridPos(static_cast<uint16_t>(targetPos.x + area.gridLeft), static_cast<uint16_t>(targetPos.y + area.gridTop), targetPos.z);
+	thread_local std::vector<uint8_t> blocked;
+	g_game().map.getSectorFlagGrid(gridPos, area.gridWidth, area.gridHeight, SECTOR_FLAG_BLOCKPROJECTILE, blocked);
+
+	list.reserve(list.size() + area.cells.size());
+	for (const auto &cell : area.cells) {
+		if (Map::isSightClear(blocked, area.gridWidth, area.centerX, area.centerY, cell.gridX, cell.gridY)) {
+			list.emplace_back(g_game().map.getOrCreateTile(static_cast<uint16_t>(targetPos.x + cell.dx), static_cast<uint16_t>(targetPos.y + cell.dy), targetPos.z));
+		}
+	}
+}
+
+void AreaCombat::compile() {
+	compiledAreas = {};
+	for (const auto &[dir, matrix] : areas) {
+		uint32_t centerY, centerX;
+		matrix->getCenter(centerY, centerX);
+
+		// Bounding box of the cells hit, always holding the center the sight lines start from
+		uint32_t minX = centerX, maxX = centerX, minY = centerY, maxY = centerY;
+		for (uint32_t y = 0; y < matrix->getRows(); ++y) {
+			for (uint32_t x = 0; x < matrix->getCols(); ++x) {
+				if (matrix->getValue(y, x)) {
+					minX = std::min(minX, x);
+					maxX = std::max(maxX, x);
+					minY = std::min(minY, y);
+					maxY = std::max(maxY, y);
+				}
 			}
-			tmpPos.x++;
 		}
-		tmpPos.x -= cols;
-		tmpPos.y++;
+
+		CompiledArea &area = compiledAreas[dir];
+		area.gridLeft = static_cast<int16_t>(static_cast<int32_t>(minX) - static_cast<int32_t>(centerX));
+		area.gridTop = static_cast<int16_t>(static_cast<int32_t>(minY) - static_cast<int32_t>(centerY));
+		area.gridWidth = static_cast<uint16_t>(maxX - minX + 1);
+		area.gridHeight = static_cast<uint16_t>(maxY - minY + 1);
+		area.centerX = static_cast<uint16_t>(centerX - minX);
+		area.centerY = static_cast<uint16_t>(centerY - minY);
+
+		for (uint32_t y = minY; y <= maxY; ++y) {
+			for (uint32_t x = minX; x <= maxX; ++x) {
+				if (y >= matrix->getRows() || x >= matrix->getCols() || !matrix->getValue(y, x)) {
+					continue;
+				}
+
+				const auto dx = static_cast<int16_t>(static_cast<int32_t>(x) - static_cast<int32_t>(centerX));
+				const auto dy = static_cast<int16_t>(static_cast<int32_t>(y) - static_cast<int32_t>(centerY));
+				area.cells.push_back({ dx, dy, static_cast<uint16_t>(x - minX), static_cast<uint16_t>(y - minY) });
+				area.rangeX = std::max<uint32_t>(area.rangeX, std::abs(dx));
+				area.rangeY = std::max<uint32_t>(area.rangeY, std::abs(dy));
+			}
+		}
+
+		// The tile list used to be built front to back, keep its order for scripts and effects
+		std::ranges::reverse(area.cells);
 	}
 }
 
@@ -1934,6 +2183,7 @@ void AreaCombat::setupArea(const std::list<uint32_t> &list, uint32_t rows) {
 	areas[DIRECTION_SOUTH] = std::move(southArea);
 	areas[DIRECTION_EAST] = std::move(eastArea);
 	areas[DIRECTION_WEST] = std::move(westArea);
+	compile();
 }
 
 void AreaCombat::setupArea(int32_t length, int32_t spread) {
@@ -2032,6 +2282,7 @@ void AreaCombat::setupExtArea(const std::list<uint32_t> &list, uint32_t rows) {
 	areas[DIRECTION_SOUTHWEST] = std::move(swArea);
 	areas[DIRECTION_NORTHEAST] = std::move(neArea);
 	areas[DIRECTION_SOUTHEAST] = std::move(seArea);
+	compile();
 }
 
 //**********************************************************//
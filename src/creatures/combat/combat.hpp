@@ -21,8 +21,6 @@ class Spell;
 class Player;
 class MatrixArea;
 
-static const std::unique_ptr<MatrixArea> &MatrixAreaNull {};
-
 // for luascript callback
 class ValueCallback final : public CallBack {
 public:
@@ -36,11 +34,31 @@ public:
 	 * @param damage The combat damage information.
 	 * @return The magic level skill of the player.
 	 */
-	uint32_t getMagicLevelSkill(std::shared_ptr<Player> player, const CombatDamage &damage) const;
-	void getMinMaxValues(std::shared_ptr<Player> player, CombatDamage &damage, bool useCharges) const;
+	uint32_t getMagicLevelSkill(const std::shared_ptr<Player> &player, const CombatDamage &damage) const;
+	void getMinMaxValues(const std::shared_ptr<Player> &player, CombatDamage &damage, bool useCharges) const;
+
+	/**
+	 * @brief Replaces the Lua call of a level/magic level callback with native math.
+	 *
+	 * The callback is probed once with sample levels and a stand-in player that
+	 * raises on any use. If it neither touches the player nor fails and its values
+	 * are linear in level and magic level, later hits use the fitted coefficients.
+	 */
+	void compileFormula();
 
 private:
+	struct LinearFormula {
+		double base = 0;
+		double perLevel = 0;
+		double perMagicLevel = 0;
+
+		double apply(double level, double magicLevel) const {
+			return base + level * perLevel + magicLevel * perMagicLevel;
+		}
+	};
+
 	formulaType_t type;
+	std::optional<std::pair<LinearFormula, LinearFormula>> nativeFormula;
 };
 
 class TileCallback final : public CallBack {
@@ -99,7 +117,7 @@ struct CombatParams {
 	uint8_t chainEffect = CONST_ME_NONE;
 };
 
-using CombatFunction = std::function<void(std::shared_ptr<Creature>, std::shared_ptr<Creature>, const CombatParams &, CombatDamage*)>;
+using CombatFunction = std::function<void(const std::shared_ptr<Creature> &, const std::shared_ptr<Creature> &, const CombatParams &, CombatDamage*)>;
 
 class MatrixArea {
 public:
@@ -192,6 +210,34 @@ private:
 	bool** data_;
 };
 
+/**
+ * A MatrixArea resolved once into the cells it hits, so a cast only looks the tiles up.
+ * Cells are relative to the target position, in the order getList always returned them.
+ */
+struct CompiledArea {
+	struct Cell {
+		int16_t dx;
+		int16_t dy;
+		// Position in the sight grid
+		uint16_t gridX;
+		uint16_t gridY;
+	};
+
+	std::vector<Cell> cells;
+
+	// Sight grid, the bounding box of the cells and the center, relative to the target
+	int16_t gridLeft = 0;
+	int16_t gridTop = 0;
+	uint16_t gridWidth = 0;
+	uint16_t gridHeight = 0;
+	uint16_t centerX = 0;
+	uint16_t centerY = 0;
+
+	// Largest distance of a cell from the target
+	uint32_t rangeX = 0;
+	uint32_t rangeY = 0;
+};
+
 class AreaCombat {
 public:
 	AreaCombat() = default;
@@ -204,7 +250,14 @@ public:
 	// non-assignable
 	AreaCombat &operator=(const AreaCombat &) = delete;
 
-	void getList(const Position &centerPos, const Position &targetPos, std::forward_list<std::shared_ptr<Tile>> &list) const;
+	// Appends the tiles hit, the ones out of sight from the area center are left out
+	void getList(const Position &centerPos, const Position &targetPos, std::vector<std::shared_ptr<Tile>> &list) const;
+	// Largest distance from targetPos of a tile getList may append
+	void getRange(const Position &centerPos, const Position &targetPos, uint32_t &rangeX, uint32_t &rangeY) const {
+		const auto &area = getCompiledArea(centerPos, targetPos);
+		rangeX = area.rangeX;
+		rangeY = area.rangeY;
+	}
 
 	void setupArea(const std::list<uint32_t> &list, uint32_t rows);
 	void setupArea(int32_t length, int32_t spread);
@@ -219,8 +272,10 @@ public:
 private:
 	std::unique_ptr<MatrixArea> createArea(const std::list<uint32_t> &list, uint32_t rows);
 	void copyArea(const std::unique_ptr<MatrixArea> &input, const std::unique_ptr<MatrixArea> &output, MatrixOperation_t op) const;
+	// Rebuilds compiledAreas from areas, after every setup
+	void compile();
 
-	const std::unique_ptr<MatrixArea> &getArea(const Position &centerPos, const Position &targetPos) const {
+	const CompiledArea &getCompiledArea(const Position &centerPos, const Position &targetPos) const {
 		int32_t dx = Position::getOffsetX(targetPos, centerPos);
 		int32_t dy = Position::getOffsetY(targetPos, centerPos);
 
@@ -247,18 +302,48 @@ private:
 			}
 		}
 
-		auto it = areas.find(dir);
-		if (it == areas.end()) {
-			return MatrixAreaNull;
-		}
-
-		return it->second;
+		return compiledAreas[dir];
 	}
 
 	std::map<Direction, std::unique_ptr<MatrixArea>> areas;
+	// Indexed by direction, empty where areas has no matrix
+	std::array<CompiledArea, DIRECTION_LAST + 1> compiledAreas;
 	bool hasExtArea = false;
 };
 
+/**
+ * Players in view of the cast Combat::CombatFunc is running, gathered once
+ * for the whole area. While it is alive the damage, message, effect and sound
+ * code takes its spectators from here, and only scans the map for positions
+ * out of the area. Casts started from callbacks stack on top of it.
+ * Players that walk in while the cast runs are not picked up.
+ */
+class CombatSpectators {
+public:
+	// spectators: multifloor, players only, covering areaRange plus the view port around centerPos
+	CombatSpectators(const SpectatorHashSet &spectators, const Position &centerPos, uint32_t areaRangeX, uint32_t areaRangeY);
+	~CombatSpectators();
+
+	// Ensures that we don't accidentally copy it
+	CombatSpectators(const CombatSpectators &) = delete;
+	CombatSpectators operator=(const CombatSpectators &) = delete;
+
+	/**
+	 * Adds the players map.getSpectators(spectators, pos, multifloor, true) would.
+	 * Returns false, adding nothing, when no cast in progress covers pos.
+	 */
+	static bool find(SpectatorHashSet &spectators, const Position &pos, bool multifloor);
+
+private:
+	static inline thread_local CombatSpectators* current = nullptr;
+
+	CombatSpectators* previous;
+	const SpectatorHashSet &spectators;
+	Position centerPos;
+	uint32_t areaRangeX;
+	uint32_t areaRangeY;
+};
+
 class Combat {
 public:
 	Combat() = default;
@@ -279,19 +364,19 @@ public:
 	static void doCombatDispel(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params);
 	static void doCombatDispel(std::shared_ptr<Creature> caster, const Position &position, const std::unique_ptr<AreaCombat> &area, const CombatParams &params);
 
-	static void getCombatArea(const Position &centerPos, const Position &targetPos, const std::unique_ptr<AreaCombat> &area, std::forward_list<std::shared_ptr<Tile>> &list);
+	static void getCombatArea(const Position &centerPos, const Position &targetPos, const std::unique_ptr<AreaCombat> &area, std::vector<std::shared_ptr<Tile>> &list);
 
-	static bool isInPvpZone(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target);
-	static bool isProtected(std::shared_ptr<Player> attacker, std::shared_ptr<Player> target);
-	static bool isPlayerCombat(std::shared_ptr<Creature> target);
+	static bool isInPvpZone(const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target);
+	static bool isProtected(const std::shared_ptr<Player> &attacker, const std::shared_ptr<Player> &target);
+	static bool isPlayerCombat(const std::shared_ptr<Creature> &target);
 	static CombatType_t ConditionToDamageType(ConditionType_t type);
 	static ConditionType_t DamageToConditionType(CombatType_t type);
-	static ReturnValue canTargetCreature(std::shared_ptr<Player> attacker, std::shared_ptr<Creature> target);
-	static ReturnValue canDoCombat(std::shared_ptr<Creature> caster, std::shared_ptr<Tile> tile, bool aggressive);
-	static ReturnValue canDoCombat(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target, bool aggressive);
-	static void postCombatEffects(std::shared_ptr<Creature> caster, const Position &origin, const Position &pos, const CombatParams &params);
+	static ReturnValue canTargetCreature(const std::shared_ptr<Player> &attacker, const std::shared_ptr<Creature> &target);
+	static ReturnValue canDoCombat(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Tile> &tile, bool aggressive);
+	static ReturnValue canDoCombat(const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, bool aggressive);
+	static void postCombatEffects(const std::shared_ptr<Creature> &caster, const Position &origin, const Position &pos, const CombatParams &params);
 
-	static void addDistanceEffect(std::shared_ptr<Creature> caster, const Position &fromPos, const Position &toPos, uint16_t effect);
+	static void addDistanceEffect(const std::shared_ptr<Creature> &caster, const Position &fromPos, const Position &toPos, uint16_t effect);
 
 	bool doCombat(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target) const;
 	bool doCombat(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const Position &origin) const;
@@ -311,7 +396,7 @@ public:
 		params.conditionList.emplace_front(condition);
 	}
 	void setPlayerCombatValues(formulaType_t formulaType, double mina, double minb, double maxa, double maxb);
-	void postCombatEffects(std::shared_ptr<Creature> caster, const Position &origin, const Position &pos) const {
+	void postCombatEffects(const std::shared_ptr<Creature> &caster, const Position &origin, const Position &pos) const {
 		postCombatEffects(caster, origin, pos, params);
 	}
 
@@ -336,7 +421,7 @@ public:
 private:
 	static void doChainEffect(const Position &origin, const Position &pos, uint8_t effect);
 	static std::vector<std::pair<Position, std::vector<uint32_t>>> pickChainTargets(std::shared_ptr<Creature> caster, const CombatParams &params, uint8_t chainDistance, uint8_t maxTargets, bool aggressive, bool backtracking, std::shared_ptr<Creature> initialTarget = nullptr);
-	static bool isValidChainTarget(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> currentTarget, std::shared_ptr<Creature> potentialTarget, const CombatParams &params, bool aggressive);
+	static bool isValidChainTarget(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &potentialTarget, const CombatParams &params, bool aggressive);
 
 	static void doCombatDefault(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params);
 
@@ -346,9 +431,9 @@ private:
 
 	static void CombatFunc(std::shared_ptr<Creature> caster, const Position &origin, const Position &pos, const std::unique_ptr<AreaCombat> &area, const CombatParams &params, CombatFunction func, CombatDamage* data);
 
-	static void CombatHealthFunc(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params, CombatDamage* data);
+	static void CombatHealthFunc(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage* data);
 	static CombatDamage applyImbuementElementalDamage(std::shared_ptr<Player> attackerPlayer, std::shared_ptr<Item> item, CombatDamage damage);
-	static void CombatManaFunc(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params, CombatDamage* damage);
+	static void CombatManaFunc(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage* damage);
 	/**
 	 * @brief Checks if a fear condition can be applied to a player.
 	 *
@@ -363,12 +448,12 @@ private:
 	 * @param player Pointer to the Player object to be checked.
 	 * @return true if the fear condition can be applied, false otherwise.
 	 */
-	static bool checkFearConditionAffected(std::shared_ptr<Player> player);
-	static void CombatConditionFunc(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params, CombatDamage* data);
-	static void CombatDispelFunc(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params, CombatDamage* data);
-	static void CombatNullFunc(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params, CombatDamage* data);
+	static bool checkFearConditionAffected(const std::shared_ptr<Player> &player);
+	static void CombatConditionFunc(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage* data);
+	static void CombatDispelFunc(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage* data);
+	static void CombatNullFunc(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage* data);
 
-	static void combatTileEffects(const SpectatorHashSet &spectators, std::shared_ptr<Creature> caster, std::shared_ptr<Tile> tile, const CombatParams &params);
+	static void combatTileEffects(const SpectatorHashSet &spectators, const std::shared_ptr<Creature> &caster, const std::shared_ptr<Tile> &tile, const CombatParams &params);
 
 	/**
 	 * @brief Calculate the level formula for combat.
@@ -378,8 +463,8 @@ private:
 	 * @param damage The combat damage.
 	 * @return The calculated level formula.
 	 */
-	int32_t getLevelFormula(std::shared_ptr<Player> player, const std::shared_ptr<Spell> wheelSpell, const CombatDamage &damage) const;
-	CombatDamage getCombatDamage(std::shared_ptr<Creature> creature, std::shared_ptr<Creature> target) const;
+	int32_t getLevelFormula(const std::shared_ptr<Player> &player, const std::shared_ptr<Spell> wheelSpell, const CombatDamage &damage) const;
+	CombatDamage getCombatDamage(const std::shared_ptr<Creature> &creature, const std::shared_ptr<Creature> &target) const;
 
 	bool doCombatChain(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, bool aggressive) const;
 
@@ -13,6 +13,7 @@
 #include "game/game.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "io/fileloader.hpp"
+#include "lib/metrics/metrics.hpp"
 
 /**
  *  Condition
@@ -146,7 +147,7 @@ void Condition::serialize(PropWriteStream &propWriteStream) {
 	propWriteStream.write<uint32_t>(id);
 
 	propWriteStream.write<uint8_t>(CONDITIONATTR_TICKS);
-	propWriteStream.write<uint32_t>(ticks);
+	propWriteStream.write<uint32_t>(getTicks());
 
 	propWriteStream.write<uint8_t>(CONDITIONATTR_ISBUFF);
 	propWriteStream.write<uint8_t>(isBuff);
@@ -162,8 +163,12 @@ void Condition::serialize(PropWriteStream &propWriteStream) {
 }
 
 void Condition::setTicks(int32_t newTicks) {
+	const int64_t newEndTime = newTicks + OTSYS_TIME();
+	if (expiryScheduled && newEndTime < endTime) {
+		++shortenedRevision;
+	}
 	ticks = newTicks;
-	endTime = ticks + OTSYS_TIME();
+	endTime = newEndTime;
 }
 
 bool Condition::executeCondition(std::shared_ptr<Creature> creature, int32_t interval) {
@@ -194,41 +199,41 @@ std::shared_ptr<Condition> Condition::createCondition(ConditionId_t id, Conditio
 		case CONDITION_DAZZLED:
 		case CONDITION_CURSED:
 		case CONDITION_BLEEDING:
-			return std::make_shared<ConditionDamage>(id, type, buff, subId);
+			return create<ConditionDamage>(id, type, buff, subId);
 
 		case CONDITION_HASTE:
 		case CONDITION_PARALYZE:
-			return std::make_shared<ConditionSpeed>(id, type, ticks, buff, subId, param);
+			return create<ConditionSpeed>(id, type, ticks, buff, subId, param);
 
 		case CONDITION_INVISIBLE:
-			return std::make_shared<ConditionInvisible>(id, type, ticks, buff, subId);
+			return create<ConditionInvisible>(id, type, ticks, buff, subId);
 
 		case CONDITION_OUTFIT:
-			return std::make_shared<ConditionOutfit>(id, type, ticks, buff, subId);
+			return create<ConditionOutfit>(id, type, ticks, buff, subId);
 
 		case CONDITION_LIGHT:
-			return std::make_shared<ConditionLight>(id, type, ticks, buff, subId, param & 0xFF, (param & 0xFF00) >> 8);
+			return create<ConditionLight>(id, type, ticks, buff, subId, param & 0xFF, (param & 0xFF00) >> 8);
 
 		case CONDITION_REGENERATION:
-			return std::make_shared<ConditionRegeneration>(id, type, ticks, buff, subId);
+			return create<ConditionRegeneration>(id, type, ticks, buff, subId);
 
 		case CONDITION_SOUL:
-			return std::make_shared<ConditionSoul>(id, type, ticks, buff, subId);
+			return create<ConditionSoul>(id, type, ticks, buff, subId);
 
 		case CONDITION_ATTRIBUTES:
-			return std::make_shared<ConditionAttributes>(id, type, ticks, buff, subId);
+			return create<ConditionAttributes>(id, type, ticks, buff, subId);
 
 		case CONDITION_SPELLCOOLDOWN:
-			return std::make_shared<ConditionSpellCooldown>(id, type, ticks, buff, subId);
+			return create<ConditionSpellCooldown>(id, type, ticks, buff, subId);
 
 		case CONDITION_SPELLGROUPCOOLDOWN:
-			return std::make_shared<ConditionSpellGroupCooldown>(id, type, ticks, buff, subId);
+			return create<ConditionSpellGroupCooldown>(id, type, ticks, buff, subId);
 
 		case CONDITION_MANASHIELD:
-			return std::make_shared<ConditionManaShield>(id, type, ticks, buff, subId);
+			return create<ConditionManaShield>(id, type, ticks, buff, subId);
 
 		case CONDITION_FEARED:
-			return std::make_shared<ConditionFeared>(id, type, ticks, buff, subId);
+			return create<ConditionFeared>(id, type, ticks, buff, subId);
 
 		case CONDITION_ROOTED:
 		case CONDITION_INFIGHT:
@@ -240,7 +245,7 @@ std::shared_ptr<Condition> Condition::createCondition(ConditionId_t id, Conditio
 		case CONDITION_CHANNELMUTEDTICKS:
 		case CONDITION_YELLTICKS:
 		case CONDITION_PACIFIED:
-			return std::make_shared<ConditionGeneric>(id, type, ticks, buff, subId);
+			return create<ConditionGeneric>(id, type, ticks, buff, subId);
 
 		default:
 			return nullptr;
@@ -337,17 +342,26 @@ bool Condition::updateCondition(const std::shared_ptr<Condition> addCondition) {
 		return false;
 	}
 
-	if (ticks == -1 && addCondition->getTicks() > 0) {
+	return updateTicks(addCondition->getTicks());
+}
+
+bool Condition::updateTicks(int32_t addTicks) const {
+	if (ticks == -1 && addTicks > 0) {
 		return false;
 	}
 
-	if (addCondition->getTicks() >= 0 && getEndTime() > (OTSYS_TIME() + addCondition->getTicks())) {
+	if (addTicks >= 0 && getEndTime() > (OTSYS_TIME() + addTicks)) {
 		return false;
 	}
 
 	return true;
 }
 
+void Condition::countCreated() {
+	static auto &created = g_metrics().getCounter("canary_conditions_created_total", "Conditions created or cloned");
+	created.add();
+}
+
 /**
  *  ConditionGeneric
  */
@@ -365,13 +379,20 @@ void ConditionGeneric::endCondition(std::shared_ptr<Creature>) {
 }
 
 void ConditionGeneric::addCondition(std::shared_ptr<Creature> creature, const std::shared_ptr<Condition> addCondition) {
-	if (updateCondition(addCondition)) {
-		setTicks(addCondition->getTicks());
+	if (conditionType == addCondition->getType()) {
+		refreshTicks(creature, addCondition->getTicks());
+	}
+}
+
+bool ConditionGeneric::refreshTicks(const std::shared_ptr<Creature> &creature, int32_t addTicks) {
+	if (updateTicks(addTicks)) {
+		setTicks(addTicks);
 
 		if (creature && addSound != SoundEffect_t::SILENCE) {
 			g_game().sendSingleSoundEffect(creature->getPosition(), addSound, creature);
 		}
 	}
+	return true;
 }
 
 uint32_t ConditionGeneric::getIcons() const {
@@ -1196,7 +1217,7 @@ bool ConditionRegeneration::executeCondition(std::shared_ptr<Creature> creature,
 					if (!spectators.empty()) {
 						message.type = MESSAGE_HEALED_OTHERS;
 						message.text = player->getName() + " was healed for " + healString;
-						for (std::shared_ptr<Creature> spectator : spectators) {
+						for (const auto &spectator : spectators) {
 							spectator->getPlayer()->sendTextMessage(message);
 						}
 					}
@@ -2435,8 +2456,14 @@ void ConditionLight::serialize(PropWriteStream &propWriteStream) {
  */
 
 void ConditionSpellCooldown::addCondition(std::shared_ptr<Creature> creature, const std::shared_ptr<Condition> addCondition) {
-	if (updateCondition(addCondition)) {
-		setTicks(addCondition->getTicks());
+	if (conditionType == addCondition->getType()) {
+		refreshTicks(creature, addCondition->getTicks());
+	}
+}
+
+bool ConditionSpellCooldown::refreshTicks(const std::shared_ptr<Creature> &creature, int32_t addTicks) {
+	if (updateTicks(addTicks)) {
+		setTicks(addTicks);
 
 		if (subId != 0 && ticks > 0) {
 			std::shared_ptr<Player> player = creature->getPlayer();
@@ -2445,6 +2472,7 @@ void ConditionSpellCooldown::addCondition(std::shared_ptr<Creature> creature, co
 			}
 		}
 	}
+	return true;
 }
 
 bool ConditionSpellCooldown::startCondition(std::shared_ptr<Creature> creature) {
@@ -2466,8 +2494,14 @@ bool ConditionSpellCooldown::startCondition(std::shared_ptr<Creature> creature)
  */
 
 void ConditionSpellGroupCooldown::addCondition(std::shared_ptr<Creature> creature, const std::shared_ptr<Condition> addCondition) {
-	if (updateCondition(addCondition)) {
-		setTicks(addCondition->getTicks());
+	if (conditionType == addCondition->getType()) {
+		refreshTicks(creature, addCondition->getTicks());
+	}
+}
+
+bool ConditionSpellGroupCooldown::refreshTicks(const std::shared_ptr<Creature> &creature, int32_t addTicks) {
+	if (updateTicks(addTicks)) {
+		setTicks(addTicks);
 
 		if (subId != 0 && ticks > 0) {
 			std::shared_ptr<Player> player = creature->getPlayer();
@@ -2476,6 +2510,7 @@ void ConditionSpellGroupCooldown::addCondition(std::shared_ptr<Creature> creatur
 			}
 		}
 	}
+	return true;
 }
 
 bool ConditionSpellGroupCooldown::startCondition(std::shared_ptr<Creature> creature) {
@@ -10,13 +10,54 @@
 #pragma once
 
 #include "declarations.hpp"
+#include "utils/tools.hpp"
+#include "lib/profiling/allocation_profiler.hpp"
+#include "utils/object_pool.hpp"
 
 class Creature;
 class Player;
 class PropStream;
 class PropWriteStream;
 
-class Condition : public SharedObject {
+class ConditionGeneric;
+class ConditionAttributes;
+class ConditionRegeneration;
+class ConditionManaShield;
+class ConditionSoul;
+class ConditionInvisible;
+class ConditionDamage;
+class ConditionFeared;
+class ConditionSpeed;
+class ConditionOutfit;
+class ConditionLight;
+class ConditionSpellCooldown;
+class ConditionSpellGroupCooldown;
+
+// Every condition comes from the pool of its type, a poison hit or a haste cast reuses the slot of an ended one
+
+#define CONDITION_POOL_NAME(type)                              \
+	template <>                                                \
+	struct ObjectPoolName<type> {                              \
+		static constexpr std::string_view value = #type;       \
+	}
+
+CONDITION_POOL_NAME(ConditionGeneric);
+CONDITION_POOL_NAME(ConditionAttributes);
+CONDITION_POOL_NAME(ConditionRegeneration);
+CONDITION_POOL_NAME(ConditionManaShield);
+CONDITION_POOL_NAME(ConditionSoul);
+CONDITION_POOL_NAME(ConditionInvisible);
+CONDITION_POOL_NAME(ConditionDamage);
+CONDITION_POOL_NAME(ConditionFeared);
+CONDITION_POOL_NAME(ConditionSpeed);
+CONDITION_POOL_NAME(ConditionOutfit);
+CONDITION_POOL_NAME(ConditionLight);
+CONDITION_POOL_NAME(ConditionSpellCooldown);
+CONDITION_POOL_NAME(ConditionSpellGroupCooldown);
+
+#undef CONDITION_POOL_NAME
+
+class Condition : public SharedObject, public AllocationTracked<Condition> {
 public:
 	Condition() = default;
 	Condition(ConditionId_t initId, ConditionType_t initType, int32_t initTicks, bool initBuff = false, uint32_t initSubId = 0) :
@@ -26,8 +67,16 @@ public:
 
 	virtual bool startCondition(std::shared_ptr<Creature> creature);
 	virtual bool executeCondition(std::shared_ptr<Creature> creature, int32_t interval);
+	// Whether executeCondition does more than count down, the creature only checks the end time of the others
+	virtual bool isPeriodic() const {
+		return tickSound != SoundEffect_t::SILENCE;
+	}
 	virtual void endCondition(std::shared_ptr<Creature> creature) = 0;
 	virtual void addCondition(std::shared_ptr<Creature> creature, const std::shared_ptr<Condition> condition) = 0;
+	// addCondition with a condition of the same type that only carries its ticks, false when the type merges more than that
+	virtual bool refreshTicks(const std::shared_ptr<Creature> &, int32_t) {
+		return false;
+	}
 	virtual uint32_t getIcons() const;
 	ConditionId_t getId() const {
 		return id;
@@ -45,10 +94,29 @@ public:
 		return endTime;
 	}
 	int32_t getTicks() const {
+		// Not counted down while scheduled, what is left is the time until the end
+		if (expiryScheduled && ticks > 0) {
+			return static_cast<int32_t>(std::clamp<int64_t>(endTime - OTSYS_TIME(), 0, ticks));
+		}
 		return ticks;
 	}
 	void setTicks(int32_t newTicks);
 
+	// Set by the creature once started, when the condition is not periodic
+	void setExpiryScheduled(bool scheduled) {
+		if (expiryScheduled && !scheduled) {
+			ticks = getTicks();
+		}
+		expiryScheduled = scheduled;
+	}
+	bool isExpiryScheduled() const {
+		return expiryScheduled;
+	}
+	// Bumped whenever a scheduled condition gets an earlier end time, so creatures recheck theirs
+	static uint32_t getShortenedRevision() {
+		return shortenedRevision;
+	}
+
 	static std::shared_ptr<Condition> createCondition(ConditionId_t id, ConditionType_t type, int32_t ticks, int32_t param = 0, bool buff = false, uint32_t subId = 0);
 	static std::shared_ptr<Condition> createCondition(PropStream &propStream);
 
@@ -71,13 +139,26 @@ protected:
 	ConditionType_t conditionType;
 	ConditionId_t id;
 	bool isBuff;
+	bool expiryScheduled = false;
 
 	virtual bool updateCondition(const std::shared_ptr<Condition> addCondition);
+	bool updateTicks(int32_t addTicks) const;
+
+	// Pooled make_shared, every condition created or cloned is counted in the metrics
+	template <typename T, typename... Args>
+	static std::shared_ptr<T> create(Args &&... args) {
+		countCreated();
+		return makePooled<T>(std::forward<Args>(args)...);
+	}
 
 private:
 	SoundEffect_t tickSound = SoundEffect_t::SILENCE;
 	SoundEffect_t addSound = SoundEffect_t::SILENCE;
 
+	static inline uint32_t shortenedRevision = 0;
+
+	static void countCreated();
+
 	friend class ConditionDamage;
 	friend class ConditionGeneric;
 };
@@ -91,10 +172,11 @@ public:
 	bool executeCondition(std::shared_ptr<Creature> creature, int32_t interval) override;
 	void endCondition(std::shared_ptr<Creature> creature) override;
 	void addCondition(std::shared_ptr<Creature> creature, const std::shared_ptr<Condition> condition) override;
+	bool refreshTicks(const std::shared_ptr<Creature> &creature, int32_t addTicks) override;
 	uint32_t getIcons() const override;
 
 	std::shared_ptr<Condition> clone() const override {
-		return std::make_shared<ConditionGeneric>(*this);
+		return create<ConditionGeneric>(*this);
 	}
 };
 
@@ -110,8 +192,12 @@ public:
 
 	bool setParam(ConditionParam_t param, int32_t value) final;
 
+	bool refreshTicks(const std::shared_ptr<Creature> &, int32_t) override {
+		return false;
+	}
+
 	std::shared_ptr<Condition> clone() const final {
-		return std::make_shared<ConditionAttributes>(*this);
+		return create<ConditionAttributes>(*this);
 	}
 
 	// serialization
@@ -174,14 +260,21 @@ public:
 	void endCondition(std::shared_ptr<Creature> creature) override;
 	void addCondition(std::shared_ptr<Creature> creature, const std::shared_ptr<Condition> addCondition) override;
 	bool executeCondition(std::shared_ptr<Creature> creature, int32_t interval) override;
+	bool isPeriodic() const override {
+		return true;
+	}
 
 	bool setParam(ConditionParam_t param, int32_t value) override;
 
 	uint32_t getHealthTicks(std::shared_ptr<Creature> creature) const;
 	uint32_t getManaTicks(std::shared_ptr<Creature> creature) const;
 
+	bool refreshTicks(const std::shared_ptr<Creature> &, int32_t) override {
+		return false;
+	}
+
 	std::shared_ptr<Condition> clone() const override {
-		return std::make_shared<ConditionRegeneration>(*this);
+		return create<ConditionRegeneration>(*this);
 	}
 
 	// serialization
@@ -211,7 +304,7 @@ public:
 	bool setParam(ConditionParam_t param, int32_t value) override;
 
 	std::shared_ptr<Condition> clone() const override {
-		return std::make_shared<ConditionManaShield>(*this);
+		return create<ConditionManaShield>(*this);
 	}
 
 	// serialization
@@ -229,11 +322,18 @@ public:
 
 	void addCondition(std::shared_ptr<Creature> creature, const std::shared_ptr<Condition> addCondition) override;
 	bool executeCondition(std::shared_ptr<Creature> creature, int32_t interval) override;
+	bool isPeriodic() const override {
+		return true;
+	}
 
 	bool setParam(ConditionParam_t param, int32_t value) override;
 
+	bool refreshTicks(const std::shared_ptr<Creature> &, int32_t) override {
+		return false;
+	}
+
 	std::shared_ptr<Condition> clone() const override {
-		return std::make_shared<ConditionSoul>(*this);
+		return create<ConditionSoul>(*this);
 	}
 
 	// serialization
@@ -255,7 +355,7 @@ public:
 	void endCondition(std::shared_ptr<Creature> creature) override;
 
 	std::shared_ptr<Condition> clone() const override {
-		return std::make_shared<ConditionInvisible>(*this);
+		return create<ConditionInvisible>(*this);
 	}
 };
 
@@ -269,12 +369,15 @@ public:
 
 	bool startCondition(std::shared_ptr<Creature> creature) override;
 	bool executeCondition(std::shared_ptr<Creature> creature, int32_t interval) override;
+	bool isPeriodic() const override {
+		return true;
+	}
 	void endCondition(std::shared_ptr<Creature> creature) override;
 	void addCondition(std::shared_ptr<Creature> creature, const std::shared_ptr<Condition> condition) override;
 	uint32_t getIcons() const override;
 
 	std::shared_ptr<Condition> clone() const override {
-		return std::make_shared<ConditionDamage>(*this);
+		return create<ConditionDamage>(*this);
 	}
 
 	bool setParam(ConditionParam_t param, int32_t value) override;
@@ -320,12 +423,15 @@ public:
 
 	bool startCondition(std::shared_ptr<Creature> creature) override;
 	bool executeCondition(std::shared_ptr<Creature> creature, int32_t interval) override;
+	bool isPeriodic() const override {
+		return true;
+	}
 	void endCondition(std::shared_ptr<Creature> creature) override;
 	void addCondition(std::shared_ptr<Creature> creature, const std::shared_ptr<Condition> condition) override;
 	uint32_t getIcons() const override;
 
 	std::shared_ptr<Condition> clone() const override {
-		return std::make_shared<ConditionFeared>(*this);
+		return create<ConditionFeared>(*this);
 	}
 
 	bool setPositionParam(ConditionParam_t param, const Position &pos) override;
@@ -364,7 +470,7 @@ public:
 	uint32_t getIcons() const override;
 
 	std::shared_ptr<Condition> clone() const override {
-		return std::make_shared<ConditionSpeed>(*this);
+		return create<ConditionSpeed>(*this);
 	}
 
 	bool setParam(ConditionParam_t param, int32_t value) override;
@@ -398,7 +504,7 @@ public:
 	void addCondition(std::shared_ptr<Creature> creature, const std::shared_ptr<Condition> condition) override;
 
 	std::shared_ptr<Condition> clone() const override {
-		return std::make_shared<ConditionOutfit>(*this);
+		return create<ConditionOutfit>(*this);
 	}
 
 	void setOutfit(const Outfit_t &outfit);
@@ -420,11 +526,14 @@ public:
 
 	bool startCondition(std::shared_ptr<Creature> creature) override;
 	bool executeCondition(std::shared_ptr<Creature> creature, int32_t interval) override;
+	bool isPeriodic() const override {
+		return true;
+	}
 	void endCondition(std::shared_ptr<Creature> creature) override;
 	void addCondition(std::shared_ptr<Creature> creature, const std::shared_ptr<Condition> addCondition) override;
 
 	std::shared_ptr<Condition> clone() const override {
-		return std::make_shared<ConditionLight>(*this);
+		return create<ConditionLight>(*this);
 	}
 
 	bool setParam(ConditionParam_t param, int32_t value) override;
@@ -446,9 +555,10 @@ public:
 
 	bool startCondition(std::shared_ptr<Creature> creature) override;
 	void addCondition(std::shared_ptr<Creature> creature, const std::shared_ptr<Condition> condition) override;
+	bool refreshTicks(const std::shared_ptr<Creature> &creature, int32_t addTicks) override;
 
 	std::shared_ptr<Condition> clone() const override {
-		return std::make_shared<ConditionSpellCooldown>(*this);
+		return create<ConditionSpellCooldown>(*this);
 	}
 };
 
@@ -459,8 +569,9 @@ public:
 
 	bool startCondition(std::shared_ptr<Creature> creature) override;
 	void addCondition(std::shared_ptr<Creature> creature, const std::shared_ptr<Condition> condition) override;
+	bool refreshTicks(const std::shared_ptr<Creature> &creature, int32_t addTicks) override;
 
 	std::shared_ptr<Condition> clone() const override {
-		return std::make_shared<ConditionSpellGroupCooldown>(*this);
+		return create<ConditionSpellGroupCooldown>(*this);
 	}
 };
@@ -79,9 +79,50 @@ TalkActionResult_t Spells::playerSaySpell(std::shared_ptr<Player> player, std::s
 
 void Spells::clear() {
 	instants.clear();
+	wordsTrie.clear();
 	runes.clear();
 }
 
+void Spells::clearFileEvents(const std::string &file) {
+	const auto fromFile = [&file](const auto &entry) { return entry.second->getScriptFile() == file; };
+	std::erase_if(runes, fromFile);
+	if (std::erase_if(instants, fromFile) > 0) {
+		// Nodes can't be taken out of the trie, it is rebuilt from what is left
+		wordsTrie.clear();
+		for (const auto &[words, instant] : instants) {
+			indexInstantWords(instant);
+		}
+	}
+}
+
+void Spells::indexInstantWords(const std::shared_ptr<InstantSpell> &instant) {
+	if (wordsTrie.empty()) {
+		wordsTrie.emplace_back();
+	}
+
+	uint32_t node = 0;
+	for (const char c : instant->getWords()) {
+		const char lower = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+		auto &children = wordsTrie[node].children;
+		auto it = std::ranges::lower_bound(children, lower, {}, &std::pair<char, uint32_t>::first);
+		if (it != children.end() && it->first == lower) {
+			node = it->second;
+			continue;
+		}
+
+		const auto child = static_cast<uint32_t>(wordsTrie.size());
+		children.emplace(it, lower, child);
+		wordsTrie.emplace_back();
+		node = child;
+	}
+
+	// Words differing only in case share a node, the first one in map order wins like the old linear search
+	auto &spell = wordsTrie[node].spell;
+	if (!spell || instant->getWords() < spell->getWords()) {
+		spell = instant;
+	}
+}
+
 bool Spells::hasInstantSpell(const std::string &word) const {
 	if (auto iterate = instants.find(word);
 		iterate != instants.end()) {
@@ -183,16 +224,19 @@ std::shared_ptr<RuneSpell> Spells::getRuneSpellByName(const std::string &name) {
 std::shared_ptr<InstantSpell> Spells::getInstantSpell(const std::string &words) {
 	std::shared_ptr<InstantSpell> result = nullptr;
 
-	for (auto &it : instants) {
-		const std::string &instantSpellWords = it.second->getWords();
-		size_t spellLen = instantSpellWords.length();
-		if (strncasecmp(instantSpellWords.c_str(), words.c_str(), spellLen) == 0) {
-			if (!result || spellLen > result->getWords().length()) {
-				result = it.second;
-				if (words.length() == spellLen) {
-					break;
-				}
-			}
+	// Longest spell words the text starts with
+	uint32_t node = 0;
+	for (size_t i = 0; i < words.length() && !wordsTrie.empty(); ++i) {
+		const char lower = static_cast<char>(std::tolower(static_cast<unsigned char>(words[i])));
+		const auto &children = wordsTrie[node].children;
+		auto it = std::ranges::lower_bound(children, lower, {}, &std::pair<char, uint32_t>::first);
+		if (it == children.end() || it->first != lower) {
+			break;
+		}
+
+		node = it->second;
+		if (wordsTrie[node].spell) {
+			result = wordsTrie[node].spell;
 		}
 	}
 
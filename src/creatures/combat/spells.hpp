@@ -57,16 +57,30 @@ public:
 	[[nodiscard]] bool hasInstantSpell(const std::string &word) const;
 
 	void setInstantSpell(const std::string &word, const std::shared_ptr<InstantSpell> instant) {
-		instants.try_emplace(word, instant);
+		if (instants.try_emplace(word, instant).second) {
+			indexInstantWords(instant);
+		}
 	}
 
 	void clear();
+	// Unregisters the events the given script file registered, for hot reload
+	void clearFileEvents(const std::string &file);
 	bool registerInstantLuaEvent(const std::shared_ptr<InstantSpell> instant);
 	bool registerRuneLuaEvent(const std::shared_ptr<RuneSpell> rune);
 
 private:
+	// Case insensitive trie over the words of every instant spell, node 0 is the root
+	struct WordsNode {
+		// Sorted by character
+		std::vector<std::pair<char, uint32_t>> children;
+		std::shared_ptr<InstantSpell> spell;
+	};
+
+	void indexInstantWords(const std::shared_ptr<InstantSpell> &instant);
+
 	std::map<uint16_t, std::shared_ptr<RuneSpell>> runes;
 	std::map<std::string, std::shared_ptr<InstantSpell>> instants;
+	std::vector<WordsNode> wordsTrie;
 
 	friend class CombatSpell;
 };
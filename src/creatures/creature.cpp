@@ -162,6 +162,7 @@ void Creature::onAttacking(uint32_t interval) {
 void Creature::onIdleStatus() {
 	if (getHealth() > 0) {
 		damageMap.clear();
+		totalDamage = 0;
 		lastHitCreatureId = 0;
 	}
 }
@@ -259,6 +260,11 @@ void Creature::addEventWalk(bool firstStep) {
 		g_game().checkCreatureWalk(getID());
 	}
 
+	if (!getPlayer()) {
+		eventWalk = g_creatureWalkWheel().schedule(getID(), ticks);
+		return;
+	}
+
 	eventWalk = g_scheduler().addEvent(
 		static_cast<uint32_t>(ticks), std::bind(&Game::checkCreatureWalk, &g_game(), getID()),
 		"Creature::checkCreatureWalk"
@@ -267,11 +273,77 @@ void Creature::addEventWalk(bool firstStep) {
 
 void Creature::stopEventWalk() {
 	if (eventWalk != 0) {
-		g_scheduler().stopEvent(eventWalk);
+		// A step on the walk wheel is left there, it no longer matches eventWalk
+		if (getPlayer()) {
+			g_scheduler().stopEvent(eventWalk);
+		}
 		eventWalk = 0;
 	}
 }
 
+CreatureWalkWheel &CreatureWalkWheel::getInstance() {
+	return inject<CreatureWalkWheel>();
+}
+
+uint32_t CreatureWalkWheel::schedule(uint32_t creatureId, int64_t delay) {
+	if (++lastHandle == 0) {
+		lastHandle = 1;
+	}
+
+	const int64_t deadline = OTSYS_TIME() + delay;
+	const int64_t slotTime = std::max((deadline + SLOT_DURATION - 1) / SLOT_DURATION, processedSlotTime + 1);
+	slots[slotTime % SLOT_COUNT].emplace_back(creatureId, lastHandle, deadline);
+	++pending;
+
+	if (tickEvent == 0) {
+		if (processedSlotTime == 0) {
+			processedSlotTime = OTSYS_TIME() / SLOT_DURATION;
+		}
+		tickEvent = g_scheduler().addEvent(static_cast<uint32_t>(SLOT_DURATION), [this] { tick(); }, "CreatureWalkWheel::tick");
+	}
+	return lastHandle;
+}
+
+void CreatureWalkWheel::tick() {
+	tickEvent = 0;
+
+	const int64_t now = OTSYS_TIME();
+	const int64_t slotTime = now / SLOT_DURATION;
+	// After a long stall every slot is looked at once
+	const int64_t firstSlotTime = std::max(processedSlotTime + 1, slotTime - static_cast<int64_t>(SLOT_COUNT) + 1);
+
+	due.clear();
+	for (int64_t time = firstSlotTime; time <= slotTime; ++time) {
+		auto &slot = slots[time % SLOT_COUNT];
+		std::erase_if(slot, [this, now](const Entry &entry) {
+			if (entry.deadline > now) {
+				return false;
+			}
+			due.emplace_back(entry);
+			return true;
+		});
+	}
+	processedSlotTime = std::max(processedSlotTime, slotTime);
+	pending -= due.size();
+
+	// A step schedules the next one of its walker, into a later slot
+	bool stepped = false;
+	for (const auto &entry : due) {
+		const auto creature = g_game().getCreatureByID(entry.creatureId);
+		if (creature && creature->eventWalk == entry.handle && creature->getHealth() > 0) {
+			creature->onCreatureWalk();
+			stepped = true;
+		}
+	}
+	if (stepped) {
+		g_game().cleanup();
+	}
+
+	if (pending > 0 && tickEvent == 0) {
+		tickEvent = g_scheduler().addEvent(static_cast<uint32_t>(SLOT_DURATION), [this] { tick(); }, "CreatureWalkWheel::tick");
+	}
+}
+
 void Creature::updateMapCache() {
 	std::shared_ptr<Tile> newTile;
 	const Position &myPos = getPosition();
@@ -639,7 +711,7 @@ void Creature::onDeath() {
 	const int64_t timeNow = OTSYS_TIME();
 	const uint32_t inFightTicks = g_configManager().getNumber(PZ_LOCKED);
 	int32_t mostDamage = 0;
-	std::map<std::shared_ptr<Creature>, uint64_t> experienceMap;
+	SmallFlatMap<std::shared_ptr<Creature>, uint64_t> experienceMap;
 	for (const auto &it : damageMap) {
 		if (auto attacker = g_game().getCreatureByID(it.first)) {
 			CountBlock_t cb = it.second;
@@ -660,12 +732,7 @@ void Creature::onDeath() {
 					}
 				}
 
-				auto tmpIt = experienceMap.find(attacker);
-				if (tmpIt == experienceMap.end()) {
-					experienceMap[attacker] = gainExp;
-				} else {
-					tmpIt->second += gainExp;
-				}
+				experienceMap[attacker] += gainExp;
 			}
 		}
 	}
@@ -1058,22 +1125,15 @@ bool Creature::setFollowCreature(std::shared_ptr<Creature> creature) {
 }
 
 double Creature::getDamageRatio(std::shared_ptr<Creature> attacker) const {
-	uint32_t totalDamage = 0;
-	uint32_t attackerDamage = 0;
-
-	for (const auto &it : damageMap) {
-		const CountBlock_t &cb = it.second;
-		totalDamage += cb.total;
-		if (it.first == attacker->getID()) {
-			attackerDamage += cb.total;
-		}
-	}
-
 	if (totalDamage == 0) {
 		return 0;
 	}
 
-	return (static_cast<double>(attackerDamage) / totalDamage);
+	const auto it = damageMap.find(attacker->getID());
+	if (it == damageMap.end()) {
+		return 0;
+	}
+	return static_cast<double>(it->second.total) / totalDamage;
 }
 
 uint64_t Creature::getGainedExperience(std::shared_ptr<Creature> attacker) const {
@@ -1087,16 +1147,12 @@ void Creature::addDamagePoints(std::shared_ptr<Creature> attacker, int32_t damag
 
 	uint32_t attackerId = attacker->id;
 
-	auto it = damageMap.find(attackerId);
-	if (it == damageMap.end()) {
-		CountBlock_t cb;
-		cb.ticks = OTSYS_TIME();
-		cb.total = damagePoints;
-		damageMap[attackerId] = cb;
-	} else {
+	auto [it, added] = damageMap.try_emplace(attackerId, CountBlock_t { damagePoints, OTSYS_TIME() });
+	if (!added) {
 		it->second.total += damagePoints;
 		it->second.ticks = OTSYS_TIME();
 	}
+	totalDamage += static_cast<uint64_t>(damagePoints);
 
 	lastHitCreatureId = attackerId;
 }
@@ -1212,7 +1268,7 @@ void Creature::onGainExperience(uint64_t gainExp, std::shared_ptr<Creature> targ
 		message.primary.color = TEXTCOLOR_WHITE_EXP;
 		message.primary.value = gainExp;
 
-		for (std::shared_ptr<Creature> spectator : spectators) {
+		for (const auto &spectator : spectators) {
 			spectator->getPlayer()->sendTextMessage(message);
 		}
 	}
@@ -1235,14 +1291,21 @@ bool Creature::setMaster(std::shared_ptr<Creature> newMaster, bool reloadCreatur
 		setSkillLoss(false);
 		g_game().reloadCreature(self);
 	}
+	if (newMaster == oldMaster) {
+		return true;
+	}
+
 	if (newMaster) {
-		newMaster->m_summons.insert(self);
+		newMaster->m_summons.emplace_back(self);
 	}
 
 	m_master = newMaster;
 
 	if (oldMaster) {
-		oldMaster->m_summons.erase(self);
+		auto &summons = oldMaster->m_summons;
+		if (auto it = std::ranges::find(summons, self); it != summons.end()) {
+			summons.erase(it);
+		}
 	}
 	return true;
 }
@@ -1255,12 +1318,15 @@ bool Creature::addCondition(std::shared_ptr<Condition> condition) {
 	std::shared_ptr<Condition> prevCond = getCondition(condition->getType(), condition->getId(), condition->getSubId());
 	if (prevCond) {
 		prevCond->addCondition(getCreature(), condition);
+		if (prevCond->isExpiryScheduled()) {
+			nextConditionExpiry = std::min(nextConditionExpiry, prevCond->getEndTime());
+		}
 
 		return true;
 	}
 
 	if (condition->startCondition(getCreature())) {
-		conditions.push_back(condition);
+		insertCondition(condition);
 		onAddCondition(condition->getType());
 		return true;
 	}
@@ -1268,6 +1334,18 @@ bool Creature::addCondition(std::shared_ptr<Condition> condition) {
 	return false;
 }
 
+bool Creature::refreshCondition(ConditionType_t type, ConditionId_t conditionId, int32_t ticks, uint32_t subId /* = 0*/) {
+	const auto condition = getCondition(type, conditionId, subId);
+	if (!condition || !condition->refreshTicks(getCreature(), ticks)) {
+		return false;
+	}
+
+	if (condition->isExpiryScheduled()) {
+		nextConditionExpiry = std::min(nextConditionExpiry, condition->getEndTime());
+	}
+	return true;
+}
+
 bool Creature::addCombatCondition(std::shared_ptr<Condition> condition) {
 	// Caution: condition variable could be deleted after the call to addCondition
 	ConditionType_t type = condition->getType();
@@ -1281,15 +1359,14 @@ bool Creature::addCombatCondition(std::shared_ptr<Condition> condition) {
 }
 
 void Creature::removeCondition(ConditionType_t type) {
-	auto it = conditions.begin(), end = conditions.end();
-	while (it != end) {
-		std::shared_ptr<Condition> condition = *it;
-		if (condition->getType() != type) {
-			++it;
+	size_t index = 0;
+	while (hasConditionType(type) && index < conditions.size()) {
+		if (conditions[index]->getType() != type) {
+			++index;
 			continue;
 		}
 
-		it = conditions.erase(it);
+		std::shared_ptr<Condition> condition = eraseCondition(index);
 
 		condition->endCondition(getCreature());
 
@@ -1298,11 +1375,11 @@ void Creature::removeCondition(ConditionType_t type) {
 }
 
 void Creature::removeCondition(ConditionType_t conditionType, ConditionId_t conditionId, bool force /* = false*/) {
-	auto it = conditions.begin(), end = conditions.end();
-	while (it != end) {
-		std::shared_ptr<Condition> condition = *it;
+	size_t index = 0;
+	while (hasConditionType(conditionType) && index < conditions.size()) {
+		std::shared_ptr<Condition> condition = conditions[index];
 		if (condition->getType() != conditionType || condition->getId() != conditionId) {
-			++it;
+			++index;
 			continue;
 		}
 
@@ -1318,7 +1395,7 @@ void Creature::removeCondition(ConditionType_t conditionType, ConditionId_t cond
 			}
 		}
 
-		it = conditions.erase(it);
+		eraseCondition(index);
 
 		condition->endCondition(getCreature());
 
@@ -1345,13 +1422,17 @@ void Creature::removeCondition(std::shared_ptr<Condition> condition) {
 		return;
 	}
 
-	conditions.erase(it);
+	eraseCondition(static_cast<size_t>(it - conditions.begin()));
 
 	condition->endCondition(getCreature());
 	onEndCondition(condition->getType());
 }
 
 std::shared_ptr<Condition> Creature::getCondition(ConditionType_t type) const {
+	if (!hasConditionType(type)) {
+		return nullptr;
+	}
+
 	for (const auto &condition : conditions) {
 		if (condition->getType() == type) {
 			return condition;
@@ -1361,6 +1442,10 @@ std::shared_ptr<Condition> Creature::getCondition(ConditionType_t type) const {
 }
 
 std::shared_ptr<Condition> Creature::getCondition(ConditionType_t type, ConditionId_t conditionId, uint32_t subId /* = 0*/) const {
+	if (!hasConditionType(type)) {
+		return nullptr;
+	}
+
 	for (const auto &condition : conditions) {
 		if (condition->getType() == type && condition->getId() == conditionId && condition->getSubId() == subId) {
 			return condition;
@@ -1379,26 +1464,103 @@ std::vector<std::shared_ptr<Condition>> Creature::getConditionsByType(ConditionT
 	return conditionsVec;
 }
 
+void Creature::insertCondition(const std::shared_ptr<Condition> &condition) {
+	conditions.push_back(condition);
+	conditionTypes |= conditionTypeBit(condition->getType());
+	if (!condition->isPeriodic()) {
+		condition->setExpiryScheduled(true);
+		nextConditionExpiry = std::min(nextConditionExpiry, condition->getEndTime());
+	}
+}
+
+std::shared_ptr<Condition> Creature::eraseCondition(size_t index) {
+	std::shared_ptr<Condition> condition = std::move(conditions[index]);
+	conditions.erase(conditions.begin() + index);
+
+	const ConditionType_t type = condition->getType();
+	if (std::ranges::none_of(conditions, [type](const auto &other) { return other->getType() == type; })) {
+		conditionTypes &= ~conditionTypeBit(type);
+	}
+
+	condition->setExpiryScheduled(false);
+	return condition;
+}
+
 void Creature::executeConditions(uint32_t interval) {
-	auto it = conditions.begin(), end = conditions.end();
-	while (it != end) {
-		std::shared_ptr<Condition> condition = *it;
-		if (!condition->executeCondition(getCreature(), interval)) {
-			ConditionType_t type = condition->getType();
+	// Run from a copy, a tick may add or remove conditions. Nested calls get their own buffer
+	static thread_local ConditionList tickingBuffer;
+	ConditionList ticking = std::move(tickingBuffer);
+	ticking.clear();
+	for (const auto &condition : conditions) {
+		if (!condition->isExpiryScheduled()) {
+			ticking.push_back(condition);
+		}
+	}
 
-			it = conditions.erase(it);
+	for (const auto &condition : ticking) {
+		auto it = std::find(conditions.begin(), conditions.end(), condition);
+		if (it == conditions.end() || condition->executeCondition(getCreature(), interval)) {
+			continue;
+		}
 
-			condition->endCondition(getCreature());
+		ConditionType_t type = condition->getType();
 
-			onEndCondition(type);
+		eraseCondition(static_cast<size_t>(it - conditions.begin()));
+
+		condition->endCondition(getCreature());
+
+		onEndCondition(type);
+	}
+
+	ticking.clear();
+	tickingBuffer = std::move(ticking);
+
+	if (OTSYS_TIME() > nextConditionExpiry || conditionShortenedRevision != Condition::getShortenedRevision()) {
+		expireConditions();
+	}
+}
+
+void Creature::expireConditions() {
+	static thread_local ConditionList expiredBuffer;
+	ConditionList expired = std::move(expiredBuffer);
+	expired.clear();
+
+	const int64_t timeNow = OTSYS_TIME();
+	nextConditionExpiry = std::numeric_limits<int64_t>::max();
+	conditionShortenedRevision = Condition::getShortenedRevision();
+	for (const auto &condition : conditions) {
+		if (!condition->isExpiryScheduled() || condition->getTicks() == -1) {
+			continue;
+		}
+
+		if (condition->getEndTime() < timeNow) {
+			expired.push_back(condition);
 		} else {
-			++it;
+			nextConditionExpiry = std::min(nextConditionExpiry, condition->getEndTime());
+		}
+	}
+
+	for (const auto &condition : expired) {
+		auto it = std::find(conditions.begin(), conditions.end(), condition);
+		if (it == conditions.end()) {
+			continue;
 		}
+
+		ConditionType_t type = condition->getType();
+
+		eraseCondition(static_cast<size_t>(it - conditions.begin()));
+
+		condition->endCondition(getCreature());
+
+		onEndCondition(type);
 	}
+
+	expired.clear();
+	expiredBuffer = std::move(expired);
 }
 
 bool Creature::hasCondition(ConditionType_t type, uint32_t subId /* = 0*/) const {
-	if (isSuppress(type)) {
+	if (!hasConditionType(type) || isSuppress(type)) {
 		return false;
 	}
 
@@ -1500,17 +1662,13 @@ bool Creature::registerCreatureEvent(const std::string &name) {
 	}
 
 	CreatureEventType_t type = event->getEventType();
-	if (hasEventRegistered(type)) {
-		for (const auto creatureEventPtr : eventsList) {
-			if (creatureEventPtr == event) {
-				return false;
-			}
-		}
-	} else {
-		scriptEventsBitField |= static_cast<uint32_t>(1) << type;
+	auto &events = eventsByType[type];
+	if (std::ranges::find(events, event) != events.end()) {
+		return false;
 	}
 
-	eventsList.push_back(event);
+	events.push_back(event);
+	scriptEventsBitField |= static_cast<uint32_t>(1) << type;
 	return true;
 }
 
@@ -1525,44 +1683,14 @@ bool Creature::unregisterCreatureEvent(const std::string &name) {
 		return false;
 	}
 
-	bool resetTypeBit = true;
-
-	auto it = eventsList.begin(), end = eventsList.end();
-	while (it != end) {
-		const auto curEvent = *it;
-		if (curEvent == event) {
-			it = eventsList.erase(it);
-			continue;
-		}
-
-		if (curEvent->getEventType() == type) {
-			resetTypeBit = false;
-		}
-		++it;
-	}
-
-	if (resetTypeBit) {
+	auto &events = eventsByType[type];
+	std::erase(events, event);
+	if (events.empty()) {
 		scriptEventsBitField &= ~(static_cast<uint32_t>(1) << type);
 	}
 	return true;
 }
 
-CreatureEventList Creature::getCreatureEvents(CreatureEventType_t type) {
-	CreatureEventList tmpEventList;
-
-	if (!hasEventRegistered(type)) {
-		return tmpEventList;
-	}
-
-	for (const auto creatureEventPtr : eventsList) {
-		if (creatureEventPtr->getEventType() == type) {
-			tmpEventList.push_back(creatureEventPtr);
-		}
-	}
-
-	return tmpEventList;
-}
-
 bool FrozenPathingConditionCall::isInRange(const Position &startPos, const Position &testPos, const FindPathParams &fpp) const {
 	if (fpp.fullPathSearch) {
 		if (testPos.x > targetPos.x + fpp.maxTargetDist) {
@@ -1639,10 +1767,7 @@ bool FrozenPathingConditionCall::operator()(const Position &startPos, const Posi
 }
 
 bool Creature::isInvisible() const {
-	return std::find_if(conditions.begin(), conditions.end(), [](const std::shared_ptr<Condition> condition) {
-			   return condition->getType() == CONDITION_INVISIBLE;
-		   })
-		!= conditions.end();
+	return hasConditionType(CONDITION_INVISIBLE);
 }
 
 bool Creature::getPathTo(const Position &targetPos, std::forward_list<Direction> &dirList, const FindPathParams &fpp) {
@@ -1790,7 +1915,7 @@ void Creature::setIncreasePercent(CombatType_t combat, int32_t value) {
 	}
 }
 
-const phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> Creature::getZones() {
+std::span<const std::shared_ptr<Zone>> Creature::getZones() {
 	return Zone::getZones(getPosition());
 }
 
@@ -1802,7 +1927,7 @@ void Creature::iconChanged() {
 
 	SpectatorHashSet spectators;
 	g_game().map.getSpectators(spectators, tile->getPosition(), true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (!spectator) {
 			continue;
 		}
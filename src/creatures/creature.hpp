@@ -12,13 +12,15 @@
 #include "declarations.hpp"
 #include "creatures/combat/condition.hpp"
 #include "utils/utils_definitions.hpp"
+#include "utils/small_flat_map.hpp"
 #include "lua/creature/creatureevent.hpp"
 #include "map/map.hpp"
 #include "game/movement/position.hpp"
 #include "items/tile.hpp"
+#include "lib/profiling/allocation_profiler.hpp"
 
-using ConditionList = std::list<std::shared_ptr<Condition>>;
-using CreatureEventList = std::list<std::shared_ptr<CreatureEvent>>;
+using ConditionList = std::vector<std::shared_ptr<Condition>>;
+using CreatureEventList = std::vector<std::shared_ptr<CreatureEvent>>;
 
 class Map;
 class Thing;
@@ -43,6 +45,10 @@ public:
 
 	bool isInRange(const Position &startPos, const Position &testPos, const FindPathParams &fpp) const;
 
+	const Position &getTargetPos() const {
+		return targetPos;
+	}
+
 private:
 	Position targetPos;
 };
@@ -51,7 +57,7 @@ private:
 // Defines the Base class for all creatures and base functions which
 // every creature has
 
-class Creature : virtual public Thing, public SharedObject {
+class Creature : virtual public Thing, public SharedObject, public AllocationTracked<Creature> {
 protected:
 	Creature();
 
@@ -263,7 +269,7 @@ public:
 		return ZONE_NORMAL;
 	}
 
-	const phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> getZones();
+	std::span<const std::shared_ptr<Zone>> getZones();
 
 	// walk functions
 	void startAutoWalk(const std::forward_list<Direction> &listDir, bool ignoreConditions = false);
@@ -331,7 +337,7 @@ public:
 		return m_master.lock();
 	}
 
-	const phmap::flat_hash_set<std::shared_ptr<Creature>> &getSummons() const {
+	const CreatureVector &getSummons() const {
 		return m_summons;
 	}
 
@@ -357,6 +363,8 @@ public:
 
 	bool addCondition(std::shared_ptr<Condition> condition);
 	bool addCombatCondition(std::shared_ptr<Condition> condition);
+	// Extends a condition the creature has to the ticks in place, false when there is none to extend and one must be added
+	bool refreshCondition(ConditionType_t type, ConditionId_t conditionId, int32_t ticks, uint32_t subId = 0);
 	void removeCondition(ConditionType_t conditionType, ConditionId_t conditionId, bool force = false);
 	void removeCondition(ConditionType_t type);
 	void removeCondition(std::shared_ptr<Condition> condition);
@@ -530,8 +538,9 @@ public:
 		int32_t total;
 		int64_t ticks;
 	};
-	using CountMap = std::map<uint32_t, CountBlock_t>;
-	CountMap getDamageMap() const {
+	// By attacker id, in the order they first hit
+	using CountMap = SmallFlatMap<uint32_t, CountBlock_t>;
+	const CountMap &getDamageMap() const {
 		return damageMap;
 	}
 	void setWheelOfDestinyDrainBodyDebuff(uint8_t value) {
@@ -651,20 +660,53 @@ protected:
 	static constexpr int32_t maxWalkCacheWidth = (mapWalkWidth - 1) / 2;
 	static constexpr int32_t maxWalkCacheHeight = (mapWalkHeight - 1) / 2;
 
+	/**
+	 * Read on every think pass over the check buckets (Game::checkCreatures)
+	 * and by the conditions, fight and walk steps that follow it, so they are
+	 * declared first and share a few cache lines instead of sitting among the
+	 * maps, arrays and the walk cache further down.
+	 */
 	Position position;
-
-	CountMap damageMap;
-
-	phmap::flat_hash_set<std::shared_ptr<Creature>> m_summons;
-	CreatureEventList eventsList;
+	int32_t health = 1000;
+	int32_t healthMax = 1000;
+	uint32_t id = 0;
+	// Think time skipped while sleeping in an inactive sector, caught up by the conditions on wake
+	uint32_t suspendedThinkInterval = 0;
+	bool creatureCheck = false;
+	bool inCheckCreaturesVector = false;
+	bool isInternalRemoved = false;
+	bool hasFollowPath = false;
+	bool forceUpdateFollowPath = false;
+	bool isUpdatingPath = false;
+	bool cancelNextWalk = false;
+	bool moveLocked = false;
+	// One bit per ConditionType_t present in conditions
+	uint64_t conditionTypes = 0;
+	// Earliest end time among the non periodic conditions, they are only checked once it passes
+	int64_t nextConditionExpiry = std::numeric_limits<int64_t>::max();
+	uint32_t conditionShortenedRevision = 0;
+	uint32_t scriptEventsBitField = 0;
+	uint32_t eventWalk = 0;
+	uint32_t walkUpdateTicks = 0;
+	// Few per creature, kept contiguous in the order they were added
 	ConditionList conditions;
-
+	std::weak_ptr<Creature> m_attackedCreature;
+	std::weak_ptr<Creature> m_followCreature;
 	std::forward_list<Direction> listWalkDir;
 
+	// Colder state, read when the creature is hit, moves or is looked at
+
 	std::weak_ptr<Tile> m_tile;
-	std::weak_ptr<Creature> m_attackedCreature;
 	std::weak_ptr<Creature> m_master;
-	std::weak_ptr<Creature> m_followCreature;
+
+	CountMap damageMap;
+	// Sum of the totals in damageMap
+	uint64_t totalDamage = 0;
+
+	// A handful at most, kept inline and scanned rather than hashed
+	CreatureVector m_summons;
+	// The registered events by type, scriptEventsBitField tells which are not empty
+	std::array<CreatureEventList, CREATURE_EVENT_EXTENDED_OPCODE + 1> eventsByType;
 
 	/**
 	 * We need to persist if this creature is summon or not because when we
@@ -677,10 +719,6 @@ protected:
 	bool summoned = false;
 
 	uint64_t lastStep = 0;
-	uint32_t id = 0;
-	uint32_t scriptEventsBitField = 0;
-	uint32_t eventWalk = 0;
-	uint32_t walkUpdateTicks = 0;
 	uint32_t lastHitCreatureId = 0;
 	uint32_t blockCount = 0;
 	uint32_t blockTicks = 0;
@@ -688,8 +726,6 @@ protected:
 	uint16_t baseSpeed = 110;
 	uint32_t mana = 0;
 	int32_t varSpeed = 0;
-	int32_t health = 1000;
-	int32_t healthMax = 1000;
 
 	uint16_t manaShield = 0;
 	uint16_t maxManaShield = 0;
@@ -711,25 +747,19 @@ protected:
 	Direction direction = DIRECTION_SOUTH;
 	Skulls_t skull = SKULL_NONE;
 
-	bool localMapCache[mapWalkHeight][mapWalkWidth] = { { false } };
-	bool isInternalRemoved = false;
 	bool isMapLoaded = false;
-	bool isUpdatingPath = false;
-	bool creatureCheck = false;
-	bool inCheckCreaturesVector = false;
 	bool skillLoss = true;
 	bool lootDrop = true;
-	bool cancelNextWalk = false;
-	bool hasFollowPath = false;
-	bool forceUpdateFollowPath = false;
 	bool hiddenHealth = false;
 	bool floorChange = false;
 	bool canUseDefense = true;
-	bool moveLocked = false;
 	int8_t charmChanceModifier = 0;
 
 	uint8_t wheelOfDestinyDrainBodyDebuff = 0;
 
+	// Tiles around the creature it can walk on, the largest member, last so it stays out of the way
+	bool localMapCache[mapWalkHeight][mapWalkWidth] = { { false } };
+
 	// use map here instead of phmap to keep the keys in a predictable order
 	std::map<std::string, CreatureIcon> creatureIcons = {};
 
@@ -737,7 +767,22 @@ protected:
 	bool hasEventRegistered(CreatureEventType_t event) const {
 		return (0 != (scriptEventsBitField & (static_cast<uint32_t>(1) << event)));
 	}
-	CreatureEventList getCreatureEvents(CreatureEventType_t type);
+	// A copy, the handlers may register and unregister events while the list is iterated
+	CreatureEventList getCreatureEvents(CreatureEventType_t type) const {
+		return hasEventRegistered(type) ? eventsByType[type] : CreatureEventList {};
+	}
+
+	static_assert(CONDITION_COUNT <= 64, "conditionTypes has one bit per condition type");
+	static constexpr uint64_t conditionTypeBit(ConditionType_t type) {
+		return uint64_t { 1 } << type;
+	}
+	bool hasConditionType(ConditionType_t type) const {
+		return (conditionTypes & conditionTypeBit(type)) != 0;
+	}
+	void insertCondition(const std::shared_ptr<Condition> &condition);
+	// Detaches the condition at index without ending it
+	std::shared_ptr<Condition> eraseCondition(size_t index);
+	void expireConditions();
 
 	void updateMapCache();
 	void updateTileCache(std::shared_ptr<Tile> tile, int32_t dx, int32_t dy);
@@ -763,9 +808,55 @@ protected:
 	friend class Game;
 	friend class Map;
 	friend class CreatureFunctions;
+	friend class CreatureWalkWheel;
 
 private:
 	bool canFollowMaster();
 	bool isLostSummon();
 	void handleLostSummon(bool teleportSummons);
 };
+
+/**
+ * Steps every walking monster and npc from a single scheduler event, the
+ * players keep an event of their own so their steps are on time. A walker
+ * waits in a wheel of 50 ms slots by its deadline and steps on the first
+ * tick after it, all walkers due at a tick step in one batch. The handle a
+ * walker is scheduled under is its eventWalk, a stopped walk just leaves a
+ * stale entry behind that the tick skips.
+ */
+class CreatureWalkWheel {
+public:
+	static constexpr int64_t SLOT_DURATION = 50;
+	static constexpr size_t SLOT_COUNT = 256;
+
+	CreatureWalkWheel() = default;
+
+	// Ensures that we don't accidentally copy it
+	CreatureWalkWheel(const CreatureWalkWheel &) = delete;
+	CreatureWalkWheel operator=(const CreatureWalkWheel &) = delete;
+
+	static CreatureWalkWheel &getInstance();
+
+	// Returns the handle of the step, never 0
+	uint32_t schedule(uint32_t creatureId, int64_t delay);
+
+private:
+	struct Entry {
+		uint32_t creatureId;
+		uint32_t handle;
+		int64_t deadline;
+	};
+
+	void tick();
+
+	std::array<std::vector<Entry>, SLOT_COUNT> slots;
+	std::vector<Entry> due;
+	// Last slot time (deadline / SLOT_DURATION, rounded up) the ticks went through
+	int64_t processedSlotTime = 0;
+	size_t pending = 0;
+	uint32_t lastHandle = 0;
+	uint32_t tickEvent = 0;
+};
+
+constexpr auto g_creatureWalkWheel = CreatureWalkWheel::getInstance;
+
@@ -1460,6 +1460,8 @@ struct FindPathParams {
 	int32_t maxSearchDist = 0;
 	int32_t minTargetDist = -1;
 	int32_t maxTargetDist = -1;
+	// Nodes costing more than this are not expanded, 0 means no limit
+	int32_t maxCost = 0;
 };
 
 struct RecentDeathEntry {
@@ -1471,6 +1473,18 @@ struct RecentDeathEntry {
 	uint32_t timestamp;
 };
 
+// A player_deaths row, as cached for the cyclopedia recent deaths and PvP kills
+struct PlayerDeathRecord {
+	uint32_t time = 0;
+	uint32_t level = 0;
+	std::string killedBy;
+	std::string mostDamageBy;
+	// Name of the player who died
+	std::string name;
+	bool unjustified = false;
+	bool mostDamageUnjustified = false;
+};
+
 struct RecentPvPKillEntry {
 	RecentPvPKillEntry(std::string description, uint32_t timestamp, uint8_t status) :
 		description(std::move(description)),
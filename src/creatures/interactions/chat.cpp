@@ -13,6 +13,7 @@
 #include "game/game.hpp"
 #include "utils/pugicast.hpp"
 #include "game/scheduling/scheduler.hpp"
+#include "server/network/message/outputmessage.hpp"
 
 bool PrivateChatChannel::isInvited(uint32_t guid) const {
 	if (guid == getOwner()) {
@@ -118,8 +119,13 @@ bool ChatChannel::hasUser(const std::shared_ptr<Player> &player) {
 }
 
 void ChatChannel::sendToAll(const std::string &message, SpeakClasses type) const {
+	++messages;
+	deliveries += users.size();
+
+	// Written once, every user gets the same bytes
+	BroadcastPacket packet;
 	for (const auto &it : users) {
-		it.second->sendChannelMessage("", message, type, id);
+		it.second->sendChannelMessage("", message, type, id, packet);
 	}
 }
 
@@ -128,8 +134,12 @@ bool ChatChannel::talk(const std::shared_ptr<Player> &fromPlayer, SpeakClasses t
 		return false;
 	}
 
+	++messages;
+	deliveries += users.size();
+
+	BroadcastPacket packet;
 	for (const auto &it : users) {
-		it.second->sendToChannel(fromPlayer, type, text, id);
+		it.second->sendToChannel(fromPlayer, type, text, id, packet);
 	}
 	return true;
 }
@@ -612,3 +622,46 @@ PrivateChatChannel* Chat::getPrivateChannel(const std::shared_ptr<Player> &playe
 	}
 	return nullptr;
 }
+
+std::vector<ChatChannelStats> Chat::getChannelStats() const {
+	std::vector<ChatChannelStats> stats;
+	const auto add = [&stats](const ChatChannel &channel) {
+		if (channel.messages != 0) {
+			stats.emplace_back(channel.getStats());
+		}
+	};
+
+	for (const auto &[id, channel] : normalChannels) {
+		add(channel);
+	}
+	for (const auto &[id, channel] : privateChannels) {
+		add(channel);
+	}
+	for (const auto &[party, channel] : partyChannels) {
+		add(channel);
+	}
+	for (const auto &[guildId, channel] : guildChannels) {
+		add(channel);
+	}
+
+	std::ranges::sort(stats, [](const auto &lhs, const auto &rhs) {
+		return lhs.deliveries > rhs.deliveries;
+	});
+	return stats;
+}
+
+void Chat::resetChannelStats() {
+	for (auto &[id, channel] : normalChannels) {
+		channel.resetStats();
+	}
+	for (auto &[id, channel] : privateChannels) {
+		channel.resetStats();
+	}
+	for (auto &[party, channel] : partyChannels) {
+		channel.resetStats();
+	}
+	for (auto &[guildId, channel] : guildChannels) {
+		channel.resetStats();
+	}
+	statsSince = time(nullptr);
+}
@@ -19,6 +19,15 @@ class Player;
 using UsersMap = std::map<uint32_t, std::shared_ptr<Player>>;
 using InvitedMap = std::map<uint32_t, std::shared_ptr<Player>>;
 
+struct ChatChannelStats {
+	std::string name;
+	uint16_t id;
+	size_t users;
+	uint64_t messages;
+	// Messages times the users they were sent to
+	uint64_t deliveries;
+};
+
 class ChatChannel {
 public:
 	ChatChannel() = default;
@@ -56,6 +65,14 @@ public:
 		return publicChannel;
 	}
 
+	ChatChannelStats getStats() const {
+		return { name, id, users.size(), messages, deliveries };
+	}
+	void resetStats() {
+		messages = 0;
+		deliveries = 0;
+	}
+
 	bool executeOnJoinEvent(const std::shared_ptr<Player> &player);
 	bool executeCanJoinEvent(const std::shared_ptr<Player> &player);
 	bool executeOnLeaveEvent(const std::shared_ptr<Player> &player);
@@ -74,6 +91,9 @@ protected:
 	uint16_t id;
 	bool publicChannel = false;
 
+	mutable uint64_t messages = 0;
+	mutable uint64_t deliveries = 0;
+
 	friend class Chat;
 };
 
@@ -139,6 +159,13 @@ public:
 	ChatChannel* getGuildChannelById(uint32_t guildId);
 	PrivateChatChannel* getPrivateChannel(const std::shared_ptr<Player> &player);
 
+	// Every channel with traffic since the last reset, by deliveries, most first
+	std::vector<ChatChannelStats> getChannelStats() const;
+	void resetChannelStats();
+	time_t getStatsSince() const {
+		return statsSince;
+	}
+
 	LuaScriptInterface* getScriptInterface() {
 		return &scriptInterface;
 	}
@@ -152,6 +179,8 @@ private:
 	LuaScriptInterface scriptInterface;
 
 	PrivateChatChannel dummyPrivate;
+
+	time_t statsSince = time(nullptr);
 };
 
 constexpr auto g_chat = Chat::getInstance;
@@ -13,6 +13,7 @@
 #include "creatures/combat/spells.hpp"
 #include "creatures/players/wheel/player_wheel.hpp"
 #include "game/game.hpp"
+#include "map/utils/astarnodes.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "lua/creature/events.hpp"
 #include "lua/callbacks/event_callback.hpp"
@@ -21,8 +22,6 @@
 int32_t Monster::despawnRange;
 int32_t Monster::despawnRadius;
 
-uint32_t Monster::monsterAutoID = 0x50000001;
-
 std::shared_ptr<Monster> Monster::createMonster(const std::string &name) {
 	const auto mType = g_monsters().getMonsterType(name);
 	if (!mType) {
@@ -212,10 +211,69 @@ void Monster::onCreatureMove(std::shared_ptr<Creature> creature, std::shared_ptr
 	}
 
 	if (creature.get() == this) {
-		updateTargetList();
+		// The moves seen so far are settled before the lists follow the own step
+		applyCreatureMoves();
+		updateTargetList(teleport ? nullptr : &oldPos);
 		updateIdleStatus();
+
+		// Monsters in no-logout zones are no forge candidates
+		if (!oldTile || !newTile || oldTile->hasFlag(TILESTATE_NOLOGOUT) != newTile->hasFlag(TILESTATE_NOLOGOUT)) {
+			g_game().updateForgeableMonster(getMonster());
+		}
 	} else {
-		bool canSeeNewPos = canSee(newPos);
+		queueCreatureMove(creature, oldPos);
+	}
+}
+
+void Monster::queueCreatureMove(const std::shared_ptr<Creature> &creature, const Position &oldPos) {
+	static bool handlerAdded = false;
+	if (!handlerAdded) {
+		handlerAdded = true;
+		g_dispatcher().prependCycleEndHandler(&Monster::applyAllCreatureMoves);
+	}
+
+	const uint32_t creatureId = creature->getID();
+	if (std::ranges::find(pendingCreatureMoves, creatureId, &std::pair<uint32_t, Position>::first) != pendingCreatureMoves.end()) {
+		return;
+	}
+
+	if (pendingCreatureMoves.empty()) {
+		monstersWithPendingMoves.emplace_back(getMonster());
+	}
+	pendingCreatureMoves.emplace_back(creatureId, oldPos);
+}
+
+void Monster::applyAllCreatureMoves() {
+	if (monstersWithPendingMoves.empty()) {
+		return;
+	}
+
+	const auto monsters = std::move(monstersWithPendingMoves);
+	monstersWithPendingMoves.clear();
+	for (const auto &monster : monsters) {
+		monster->applyCreatureMoves();
+	}
+}
+
+void Monster::applyCreatureMoves() {
+	if (pendingCreatureMoves.empty()) {
+		return;
+	}
+
+	const auto moves = std::move(pendingCreatureMoves);
+	pendingCreatureMoves.clear();
+	if (isRemoved() || getHealth() <= 0) {
+		return;
+	}
+
+	for (const auto &[creatureId, oldPos] : moves) {
+		const auto creature = g_game().getCreatureByID(creatureId);
+		// Gone ones left the lists as they disappeared
+		if (!creature || creature->isRemoved()) {
+			continue;
+		}
+
+		bool canSeeNewPos = canSee(creature->getPosition());
 		bool canSeeOldPos = canSee(oldPos);
 
 		if (canSeeNewPos && !canSeeOldPos) {
@@ -224,8 +282,6 @@ void Monster::onCreatureMove(std::shared_ptr<Creature> creature, std::shared_ptr
 			onCreatureLeave(creature);
 		}
 
-		updateIdleStatus();
-
 		if (!isSummon()) {
 			auto followCreature = getFollowCreature();
 			if (followCreature) {
@@ -252,6 +308,8 @@ void Monster::onCreatureMove(std::shared_ptr<Creature> creature, std::shared_ptr
 			}
 		}
 	}
+
+	updateIdleStatus();
 }
 
 void Monster::onCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text) {
@@ -327,7 +385,7 @@ void Monster::removeTarget(std::shared_ptr<Creature> creature) {
 	}
 }
 
-void Monster::updateTargetList() {
+void Monster::updateTargetList(const Position* previousPos /* = nullptr*/) {
 	auto friendIterator = friendList.begin();
 	while (friendIterator != friendList.end()) {
 		auto creature = (*friendIterator).second.lock();
@@ -342,19 +400,38 @@ void Monster::updateTargetList() {
 	while (targetIterator != targetIDList.end()) {
 		auto creature = targetListMap[*targetIterator].lock();
 		if (!creature || creature->getHealth() <= 0 || !canSee(creature->getPosition())) {
-			targetIterator = targetIDList.erase(targetIterator);
 			targetListMap.erase(*targetIterator);
+			targetIterator = targetIDList.erase(targetIterator);
 		} else {
 			++targetIterator;
 		}
 	}
 
+	if (std::exchange(targetListsCleared, false)) {
+		previousPos = nullptr;
+	}
+
 	SpectatorHashSet spectators;
 	g_game().map.getSpectators(spectators, position, true);
 	spectators.erase(this);
-	for (auto spectator : spectators) {
-		if (canSee(spectator->getPosition())) {
-			onCreatureFound(spectator);
+	for (const auto &spectator : spectators) {
+		const Position &spectatorPos = spectator->getPosition();
+		if (!canSee(spectatorPos)) {
+			continue;
+		}
+
+		// Already in view before the step, its own moves keep the lists up to date
+		if (previousPos && Creature::canSee(*previousPos, spectatorPos, MAP_MAX_VIEW_PORT_X, MAP_MAX_VIEW_PORT_Y)) {
+			continue;
+		}
+
+		// The caller updates the idle status once the lists are done
+		if (isFriend(spectator)) {
+			addFriend(spectator);
+		}
+
+		if (isOpponent(spectator)) {
+			addTarget(spectator);
 		}
 	}
 }
@@ -362,10 +439,12 @@ void Monster::updateTargetList() {
 void Monster::clearTargetList() {
 	targetIDList.clear();
 	targetListMap.clear();
+	targetListsCleared = true;
 }
 
 void Monster::clearFriendList() {
 	friendList.clear();
+	targetListsCleared = true;
 }
 
 void Monster::onCreatureFound(std::shared_ptr<Creature> creature, bool pushFront /* = false*/) {
@@ -385,21 +464,17 @@ void Monster::onCreatureEnter(std::shared_ptr<Creature> creature) {
 }
 
 bool Monster::isFriend(std::shared_ptr<Creature> creature) const {
-	if (isSummon() && getMaster()->getPlayer()) {
-		std::shared_ptr<Player> masterPlayer = getMaster()->getPlayer();
-		std::shared_ptr<Player> tmpPlayer = nullptr;
-
-		if (creature->getPlayer()) {
-			tmpPlayer = creature->getPlayer();
-		} else {
-			std::shared_ptr<Creature> creatureMaster = creature->getMaster();
-
-			if (creatureMaster && creatureMaster->getPlayer()) {
+	// Run for every spectator that moves, the master is locked once
+	const auto master = getMaster();
+	if (const auto masterPlayer = master ? master->getPlayer() : nullptr) {
+		std::shared_ptr<Player> tmpPlayer = creature->getPlayer();
+		if (!tmpPlayer) {
+			if (const auto creatureMaster = creature->getMaster()) {
 				tmpPlayer = creatureMaster->getPlayer();
 			}
 		}
 
-		if (tmpPlayer && (tmpPlayer == getMaster() || masterPlayer->isPartner(tmpPlayer))) {
+		if (tmpPlayer && (tmpPlayer == masterPlayer || masterPlayer->isPartner(tmpPlayer))) {
 			return true;
 		}
 	} else if (creature->getMonster() && !creature->isSummon()) {
@@ -409,9 +484,10 @@ bool Monster::isFriend(std::shared_ptr<Creature> creature) const {
 	return false;
 }
 
-bool Monster::isOpponent(std::shared_ptr<Creature> creature) const {
-	if (isSummon() && getMaster()->getPlayer()) {
-		if (creature != getMaster()) {
+bool Monster::isOpponent(const std::shared_ptr<Creature> &creature) const {
+	const auto master = getMaster();
+	if (master && master->getPlayer()) {
+		if (creature != master) {
 			return true;
 		}
 	} else if (creature->getPlayer() && creature->getPlayer()->hasFlag(PlayerFlags_t::IgnoredByMonsters)) {
@@ -420,7 +496,10 @@ bool Monster::isOpponent(std::shared_ptr<Creature> creature) const {
 		if (getFaction() != FACTION_DEFAULT) {
 			return isEnemyFaction(creature->getFaction()) || creature->getFaction() == FACTION_PLAYER;
 		}
-		if ((creature->getPlayer()) || (creature->getMaster() && creature->getMaster()->getPlayer())) {
+		if (creature->getPlayer()) {
+			return true;
+		}
+		if (const auto creatureMaster = creature->getMaster(); creatureMaster && creatureMaster->getPlayer()) {
 			return true;
 		}
 	}
@@ -464,7 +543,8 @@ bool Monster::searchTarget(TargetSearchType_t searchType /*= TARGETSEARCH_DEFAUL
 		}
 	}
 
-	std::list<std::shared_ptr<Creature>> resultList;
+	std::vector<std::shared_ptr<Creature>> resultList;
+	resultList.reserve(targetIDList.size());
 	const Position &myPos = getPosition();
 
 	for (auto cid : targetIDList) {
@@ -621,7 +701,7 @@ BlockType_t Monster::blockHit(std::shared_ptr<Creature> attacker, CombatType_t c
 
 		// Wheel of destiny
 		std::shared_ptr<Player> player = attacker ? attacker->getPlayer() : nullptr;
-		if (player && player->wheel()->getInstant("Ballistic Mastery")) {
+		if (player && player->wheel()->getCombatBonus().ballisticMastery) {
 			elementMod -= player->wheel()->checkElementSensitiveReduction(combatType);
 		}
 
@@ -720,6 +800,7 @@ void Monster::onEndCondition(ConditionType_t type) {
 
 void Monster::onThink(uint32_t interval) {
 	Creature::onThink(interval);
+	applyCreatureMoves();
 
 	if (mType->info.thinkEvent != -1) {
 		// onThink(self, interval)
@@ -814,6 +895,19 @@ void Monster::doAttacking(uint32_t interval) {
 	bool resetTicks = interval != 0;
 	attackTicks += interval;
 
+	// Every spell is still on cooldown, work out the tick reset the loop below would do
+	if (!extraMeleeAttack && attackTicks < mType->info.minAttackSpeed) {
+		if (mType->info.hasSpellAttack || (mType->info.hasMeleeAttack && !isFleeing() && (OTSYS_TIME() - lastMeleeAttack) >= 1500)) {
+			resetTicks = false;
+		}
+
+		updateLookDirection();
+		if (resetTicks) {
+			attackTicks = 0;
+		}
+		return;
+	}
+
 	float forgeAttackBonus = 0;
 	if (monsterForgeClassification > ForgeClassifications_t::FORGE_NORMAL_MONSTER) {
 		uint16_t damageBase = 3;
@@ -822,6 +916,8 @@ void Monster::doAttacking(uint32_t interval) {
 
 	const Position &myPos = getPosition();
 	const Position &targetPos = attackedCreature->getPosition();
+	const uint32_t targetDistance = std::max<uint32_t>(Position::getDistanceX(myPos, targetPos), Position::getDistanceY(myPos, targetPos));
+	const int64_t timeNow = OTSYS_TIME();
 
 	for (const spellBlock_t &spellBlock : mType->info.attackSpells) {
 		bool inRange = false;
@@ -830,7 +926,7 @@ void Monster::doAttacking(uint32_t interval) {
 			continue;
 		}
 
-		if (canUseSpell(myPos, targetPos, spellBlock, interval, inRange, resetTicks)) {
+		if (canUseSpell(targetDistance, timeNow, spellBlock, interval, inRange, resetTicks)) {
 			if (spellBlock.chance >= static_cast<uint32_t>(uniform_random(1, 100))) {
 				if (updateLook) {
 					updateLookDirection();
@@ -893,16 +989,12 @@ bool Monster::canUseAttack(const Position &pos, std::shared_ptr<Creature> target
 	return true;
 }
 
-bool Monster::canUseSpell(const Position &pos, const Position &targetPos, const spellBlock_t &sb, uint32_t interval, bool &inRange, bool &resetTicks) {
+bool Monster::canUseSpell(uint32_t targetDistance, int64_t timeNow, const spellBlock_t &sb, uint32_t interval, bool &inRange, bool &resetTicks) {
 	inRange = true;
 
-	if (sb.isMelee && isFleeing()) {
-		return false;
-	}
-
 	if (extraMeleeAttack) {
-		lastMeleeAttack = OTSYS_TIME();
-	} else if (sb.isMelee && (OTSYS_TIME() - lastMeleeAttack) < 1500) {
+		lastMeleeAttack = timeNow;
+	} else if (sb.isMelee && (timeNow - lastMeleeAttack) < 1500) {
 		return false;
 	}
 
@@ -918,7 +1010,7 @@ bool Monster::canUseSpell(const Position &pos, const Position &targetPos, const
 		}
 	}
 
-	if (sb.range != 0 && std::max<uint32_t>(Position::getDistanceX(pos, targetPos), Position::getDistanceY(pos, targetPos)) > sb.range) {
+	if (sb.range != 0 && targetDistance > sb.range) {
 		inRange = false;
 		return false;
 	}
@@ -1269,10 +1361,12 @@ bool Monster::getDanceStep(const Position &creaturePos, Direction &moveDirection
 		return false;
 	}
 
+	StepNeighbours neighbours(*this, creaturePos);
+
 	std::vector<Direction> dirList;
 	if (!keepDistance || offset_y >= 0) {
 		uint32_t tmpDist = std::max<uint32_t>(distance_x, std::abs((creaturePos.getY() - 1) - centerPos.getY()));
-		if (tmpDist == centerToDist && canWalkTo(creaturePos, DIRECTION_NORTH)) {
+		if (tmpDist == centerToDist && neighbours.canWalkTo(DIRECTION_NORTH)) {
 			bool result = true;
 
 			if (keepAttack) {
@@ -1287,7 +1381,7 @@ bool Monster::getDanceStep(const Position &creaturePos, Direction &moveDirection
 
 	if (!keepDistance || offset_y <= 0) {
 		uint32_t tmpDist = std::max<uint32_t>(distance_x, std::abs((creaturePos.getY() + 1) - centerPos.getY()));
-		if (tmpDist == centerToDist && canWalkTo(creaturePos, DIRECTION_SOUTH)) {
+		if (tmpDist == centerToDist && neighbours.canWalkTo(DIRECTION_SOUTH)) {
 			bool result = true;
 
 			if (keepAttack) {
@@ -1302,7 +1396,7 @@ bool Monster::getDanceStep(const Position &creaturePos, Direction &moveDirection
 
 	if (!keepDistance || offset_x <= 0) {
 		uint32_t tmpDist = std::max<uint32_t>(std::abs((creaturePos.getX() + 1) - centerPos.getX()), distance_y);
-		if (tmpDist == centerToDist && canWalkTo(creaturePos, DIRECTION_EAST)) {
+		if (tmpDist == centerToDist && neighbours.canWalkTo(DIRECTION_EAST)) {
 			bool result = true;
 
 			if (keepAttack) {
@@ -1317,7 +1411,7 @@ bool Monster::getDanceStep(const Position &creaturePos, Direction &moveDirection
 
 	if (!keepDistance || offset_x >= 0) {
 		uint32_t tmpDist = std::max<uint32_t>(std::abs((creaturePos.getX() - 1) - centerPos.getX()), distance_y);
-		if (tmpDist == centerToDist && canWalkTo(creaturePos, DIRECTION_WEST)) {
+		if (tmpDist == centerToDist && neighbours.canWalkTo(DIRECTION_WEST)) {
 			bool result = true;
 
 			if (keepAttack) {
@@ -1366,13 +1460,15 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 		return getRandomStep(creaturePos, moveDirection); // player is "on" the monster so let's get some random step and rest will be taken care later.
 	}
 
+	StepNeighbours neighbours(*this, creaturePos);
+
 	if (dx == dy) {
 		// player is diagonal to the monster
 		if (offsetx >= 1 && offsety >= 1) {
 			// player is NW
 			// escape to SE, S or E [and some extra]
-			bool s = canWalkTo(creaturePos, DIRECTION_SOUTH);
-			bool e = canWalkTo(creaturePos, DIRECTION_EAST);
+			bool s = neighbours.canWalkTo(DIRECTION_SOUTH);
+			bool e = neighbours.canWalkTo(DIRECTION_EAST);
 
 			if (s && e) {
 				moveDirection = boolean_random() ? DIRECTION_SOUTH : DIRECTION_EAST;
@@ -1383,14 +1479,14 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 			} else if (e) {
 				moveDirection = DIRECTION_EAST;
 				return true;
-			} else if (canWalkTo(creaturePos, DIRECTION_SOUTHEAST)) {
+			} else if (neighbours.canWalkTo(DIRECTION_SOUTHEAST)) {
 				moveDirection = DIRECTION_SOUTHEAST;
 				return true;
 			}
 
 			/* fleeing */
-			bool n = canWalkTo(creaturePos, DIRECTION_NORTH);
-			bool w = canWalkTo(creaturePos, DIRECTION_WEST);
+			bool n = neighbours.canWalkTo(DIRECTION_NORTH);
+			bool w = neighbours.canWalkTo(DIRECTION_WEST);
 
 			if (flee) {
 				if (n && w) {
@@ -1407,9 +1503,9 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 
 			/* end of fleeing */
 
-			if (w && canWalkTo(creaturePos, DIRECTION_SOUTHWEST)) {
+			if (w && neighbours.canWalkTo(DIRECTION_SOUTHWEST)) {
 				moveDirection = DIRECTION_WEST;
-			} else if (n && canWalkTo(creaturePos, DIRECTION_NORTHEAST)) {
+			} else if (n && neighbours.canWalkTo(DIRECTION_NORTHEAST)) {
 				moveDirection = DIRECTION_NORTH;
 			}
 
@@ -1417,8 +1513,8 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 		} else if (offsetx <= -1 && offsety <= -1) {
 			// player is SE
 			// escape to NW , W or N [and some extra]
-			bool w = canWalkTo(creaturePos, DIRECTION_WEST);
-			bool n = canWalkTo(creaturePos, DIRECTION_NORTH);
+			bool w = neighbours.canWalkTo(DIRECTION_WEST);
+			bool n = neighbours.canWalkTo(DIRECTION_NORTH);
 
 			if (w && n) {
 				moveDirection = boolean_random() ? DIRECTION_WEST : DIRECTION_NORTH;
@@ -1431,14 +1527,14 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 				return true;
 			}
 
-			if (canWalkTo(creaturePos, DIRECTION_NORTHWEST)) {
+			if (neighbours.canWalkTo(DIRECTION_NORTHWEST)) {
 				moveDirection = DIRECTION_NORTHWEST;
 				return true;
 			}
 
 			/* fleeing */
-			bool s = canWalkTo(creaturePos, DIRECTION_SOUTH);
-			bool e = canWalkTo(creaturePos, DIRECTION_EAST);
+			bool s = neighbours.canWalkTo(DIRECTION_SOUTH);
+			bool e = neighbours.canWalkTo(DIRECTION_EAST);
 
 			if (flee) {
 				if (s && e) {
@@ -1455,9 +1551,9 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 
 			/* end of fleeing */
 
-			if (s && canWalkTo(creaturePos, DIRECTION_SOUTHWEST)) {
+			if (s && neighbours.canWalkTo(DIRECTION_SOUTHWEST)) {
 				moveDirection = DIRECTION_SOUTH;
-			} else if (e && canWalkTo(creaturePos, DIRECTION_NORTHEAST)) {
+			} else if (e && neighbours.canWalkTo(DIRECTION_NORTHEAST)) {
 				moveDirection = DIRECTION_EAST;
 			}
 
@@ -1465,8 +1561,8 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 		} else if (offsetx >= 1 && offsety <= -1) {
 			// player is SW
 			// escape to NE, N, E [and some extra]
-			bool n = canWalkTo(creaturePos, DIRECTION_NORTH);
-			bool e = canWalkTo(creaturePos, DIRECTION_EAST);
+			bool n = neighbours.canWalkTo(DIRECTION_NORTH);
+			bool e = neighbours.canWalkTo(DIRECTION_EAST);
 			if (n && e) {
 				moveDirection = boolean_random() ? DIRECTION_NORTH : DIRECTION_EAST;
 				return true;
@@ -1478,14 +1574,14 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 				return true;
 			}
 
-			if (canWalkTo(creaturePos, DIRECTION_NORTHEAST)) {
+			if (neighbours.canWalkTo(DIRECTION_NORTHEAST)) {
 				moveDirection = DIRECTION_NORTHEAST;
 				return true;
 			}
 
 			/* fleeing */
-			bool s = canWalkTo(creaturePos, DIRECTION_SOUTH);
-			bool w = canWalkTo(creaturePos, DIRECTION_WEST);
+			bool s = neighbours.canWalkTo(DIRECTION_SOUTH);
+			bool w = neighbours.canWalkTo(DIRECTION_WEST);
 
 			if (flee) {
 				if (s && w) {
@@ -1502,9 +1598,9 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 
 			/* end of fleeing */
 
-			if (w && canWalkTo(creaturePos, DIRECTION_NORTHWEST)) {
+			if (w && neighbours.canWalkTo(DIRECTION_NORTHWEST)) {
 				moveDirection = DIRECTION_WEST;
-			} else if (s && canWalkTo(creaturePos, DIRECTION_SOUTHEAST)) {
+			} else if (s && neighbours.canWalkTo(DIRECTION_SOUTHEAST)) {
 				moveDirection = DIRECTION_SOUTH;
 			}
 
@@ -1512,8 +1608,8 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 		} else if (offsetx <= -1 && offsety >= 1) {
 			// player is NE
 			// escape to SW, S, W [and some extra]
-			bool w = canWalkTo(creaturePos, DIRECTION_WEST);
-			bool s = canWalkTo(creaturePos, DIRECTION_SOUTH);
+			bool w = neighbours.canWalkTo(DIRECTION_WEST);
+			bool s = neighbours.canWalkTo(DIRECTION_SOUTH);
 			if (w && s) {
 				moveDirection = boolean_random() ? DIRECTION_WEST : DIRECTION_SOUTH;
 				return true;
@@ -1523,14 +1619,14 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 			} else if (s) {
 				moveDirection = DIRECTION_SOUTH;
 				return true;
-			} else if (canWalkTo(creaturePos, DIRECTION_SOUTHWEST)) {
+			} else if (neighbours.canWalkTo(DIRECTION_SOUTHWEST)) {
 				moveDirection = DIRECTION_SOUTHWEST;
 				return true;
 			}
 
 			/* fleeing */
-			bool n = canWalkTo(creaturePos, DIRECTION_NORTH);
-			bool e = canWalkTo(creaturePos, DIRECTION_EAST);
+			bool n = neighbours.canWalkTo(DIRECTION_NORTH);
+			bool e = neighbours.canWalkTo(DIRECTION_EAST);
 
 			if (flee) {
 				if (n && e) {
@@ -1547,9 +1643,9 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 
 			/* end of fleeing */
 
-			if (e && canWalkTo(creaturePos, DIRECTION_SOUTHEAST)) {
+			if (e && neighbours.canWalkTo(DIRECTION_SOUTHEAST)) {
 				moveDirection = DIRECTION_EAST;
-			} else if (n && canWalkTo(creaturePos, DIRECTION_NORTHWEST)) {
+			} else if (n && neighbours.canWalkTo(DIRECTION_NORTHWEST)) {
 				moveDirection = DIRECTION_NORTH;
 			}
 
@@ -1563,13 +1659,13 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 		switch (playerDir) {
 			case DIRECTION_NORTH: {
 				// Player is to the NORTH, so obviously we need to check if we can go SOUTH, if not then let's choose WEST or EAST and again if we can't we need to decide about some diagonal movements.
-				if (canWalkTo(creaturePos, DIRECTION_SOUTH)) {
+				if (neighbours.canWalkTo(DIRECTION_SOUTH)) {
 					moveDirection = DIRECTION_SOUTH;
 					return true;
 				}
 
-				bool w = canWalkTo(creaturePos, DIRECTION_WEST);
-				bool e = canWalkTo(creaturePos, DIRECTION_EAST);
+				bool w = neighbours.canWalkTo(DIRECTION_WEST);
+				bool e = neighbours.canWalkTo(DIRECTION_EAST);
 				if (w && e && offsetx == 0) {
 					moveDirection = boolean_random() ? DIRECTION_WEST : DIRECTION_EAST;
 					return true;
@@ -1597,8 +1693,8 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 
 				/* end of fleeing */
 
-				bool sw = canWalkTo(creaturePos, DIRECTION_SOUTHWEST);
-				bool se = canWalkTo(creaturePos, DIRECTION_SOUTHEAST);
+				bool sw = neighbours.canWalkTo(DIRECTION_SOUTHWEST);
+				bool se = neighbours.canWalkTo(DIRECTION_SOUTHEAST);
 				if (sw || se) {
 					// we can move both dirs
 					if (sw && se) {
@@ -1616,7 +1712,7 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 				}
 
 				/* fleeing */
-				if (flee && canWalkTo(creaturePos, DIRECTION_NORTH)) {
+				if (flee && neighbours.canWalkTo(DIRECTION_NORTH)) {
 					// towards player, yea
 					moveDirection = DIRECTION_NORTH;
 					return true;
@@ -1627,13 +1723,13 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 			}
 
 			case DIRECTION_SOUTH: {
-				if (canWalkTo(creaturePos, DIRECTION_NORTH)) {
+				if (neighbours.canWalkTo(DIRECTION_NORTH)) {
 					moveDirection = DIRECTION_NORTH;
 					return true;
 				}
 
-				bool w = canWalkTo(creaturePos, DIRECTION_WEST);
-				bool e = canWalkTo(creaturePos, DIRECTION_EAST);
+				bool w = neighbours.canWalkTo(DIRECTION_WEST);
+				bool e = neighbours.canWalkTo(DIRECTION_EAST);
 				if (w && e && offsetx == 0) {
 					moveDirection = boolean_random() ? DIRECTION_WEST : DIRECTION_EAST;
 					return true;
@@ -1661,8 +1757,8 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 
 				/* end of fleeing */
 
-				bool nw = canWalkTo(creaturePos, DIRECTION_NORTHWEST);
-				bool ne = canWalkTo(creaturePos, DIRECTION_NORTHEAST);
+				bool nw = neighbours.canWalkTo(DIRECTION_NORTHWEST);
+				bool ne = neighbours.canWalkTo(DIRECTION_NORTHEAST);
 				if (nw || ne) {
 					// we can move both dirs
 					if (nw && ne) {
@@ -1680,7 +1776,7 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 				}
 
 				/* fleeing */
-				if (flee && canWalkTo(creaturePos, DIRECTION_SOUTH)) {
+				if (flee && neighbours.canWalkTo(DIRECTION_SOUTH)) {
 					// towards player, yea
 					moveDirection = DIRECTION_SOUTH;
 					return true;
@@ -1697,13 +1793,13 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 		Direction playerDir = offsetx < 0 ? DIRECTION_EAST : DIRECTION_WEST;
 		switch (playerDir) {
 			case DIRECTION_WEST: {
-				if (canWalkTo(creaturePos, DIRECTION_EAST)) {
+				if (neighbours.canWalkTo(DIRECTION_EAST)) {
 					moveDirection = DIRECTION_EAST;
 					return true;
 				}
 
-				bool n = canWalkTo(creaturePos, DIRECTION_NORTH);
-				bool s = canWalkTo(creaturePos, DIRECTION_SOUTH);
+				bool n = neighbours.canWalkTo(DIRECTION_NORTH);
+				bool s = neighbours.canWalkTo(DIRECTION_SOUTH);
 				if (n && s && offsety == 0) {
 					moveDirection = boolean_random() ? DIRECTION_NORTH : DIRECTION_SOUTH;
 					return true;
@@ -1731,8 +1827,8 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 
 				/* end of fleeing */
 
-				bool se = canWalkTo(creaturePos, DIRECTION_SOUTHEAST);
-				bool ne = canWalkTo(creaturePos, DIRECTION_NORTHEAST);
+				bool se = neighbours.canWalkTo(DIRECTION_SOUTHEAST);
+				bool ne = neighbours.canWalkTo(DIRECTION_NORTHEAST);
 				if (se || ne) {
 					if (se && ne) {
 						moveDirection = boolean_random() ? DIRECTION_SOUTHEAST : DIRECTION_NORTHEAST;
@@ -1749,7 +1845,7 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 				}
 
 				/* fleeing */
-				if (flee && canWalkTo(creaturePos, DIRECTION_WEST)) {
+				if (flee && neighbours.canWalkTo(DIRECTION_WEST)) {
 					// towards player, yea
 					moveDirection = DIRECTION_WEST;
 					return true;
@@ -1760,13 +1856,13 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 			}
 
 			case DIRECTION_EAST: {
-				if (canWalkTo(creaturePos, DIRECTION_WEST)) {
+				if (neighbours.canWalkTo(DIRECTION_WEST)) {
 					moveDirection = DIRECTION_WEST;
 					return true;
 				}
 
-				bool n = canWalkTo(creaturePos, DIRECTION_NORTH);
-				bool s = canWalkTo(creaturePos, DIRECTION_SOUTH);
+				bool n = neighbours.canWalkTo(DIRECTION_NORTH);
+				bool s = neighbours.canWalkTo(DIRECTION_SOUTH);
 				if (n && s && offsety == 0) {
 					moveDirection = boolean_random() ? DIRECTION_NORTH : DIRECTION_SOUTH;
 					return true;
@@ -1794,8 +1890,8 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 
 				/* end of fleeing */
 
-				bool nw = canWalkTo(creaturePos, DIRECTION_NORTHWEST);
-				bool sw = canWalkTo(creaturePos, DIRECTION_SOUTHWEST);
+				bool nw = neighbours.canWalkTo(DIRECTION_NORTHWEST);
+				bool sw = neighbours.canWalkTo(DIRECTION_SOUTHWEST);
 				if (nw || sw) {
 					if (nw && sw) {
 						moveDirection = boolean_random() ? DIRECTION_NORTHWEST : DIRECTION_SOUTHWEST;
@@ -1812,7 +1908,7 @@ bool Monster::getDistanceStep(const Position &targetPos, Direction &moveDirectio
 				}
 
 				/* fleeing */
-				if (flee && canWalkTo(creaturePos, DIRECTION_EAST)) {
+				if (flee && neighbours.canWalkTo(DIRECTION_EAST)) {
 					// towards player, yea
 					moveDirection = DIRECTION_EAST;
 					return true;
@@ -1837,6 +1933,12 @@ bool Monster::canWalkTo(Position pos, Direction moveDirection) {
 			return false;
 		}
 
+		// The floor bitmaps rule out floor changes and, unless items can be pushed, missing or solid tiles
+		auto &map = g_game().map;
+		if (map.hasSectorFlag(pos, SECTOR_FLAG_FLOORCHANGE) || (!canPushItems() && !map.isSectorWalkable(pos))) {
+			return false;
+		}
+
 		const auto tile = g_game().map.getTile(pos);
 		if (tile && tile->getTopVisibleCreature(getMonster()) == nullptr && tile->queryAdd(0, getMonster(), 1, FLAG_PATHFINDING | FLAG_IGNOREFIELDDAMAGE) == RETURNVALUE_NOERROR) {
 			return true;
@@ -2108,6 +2210,9 @@ void Monster::getPathSearchParams(std::shared_ptr<Creature> creature, FindPathPa
 	} else {
 		fpp.fullPathSearch = !canUseAttack(getPosition(), creature);
 	}
+
+	// A detour costing more than walking the search area twice diagonally is not worth chasing
+	fpp.maxCost = 2 * AStarNodes::MAP_DIAGONALWALKCOST * fpp.maxSearchDist;
 }
 
 void Monster::configureForgeSystem() {
@@ -2151,6 +2256,7 @@ void Monster::clearFiendishStatus() {
 	removeIcon("forge");
 	g_game().updateCreatureIcon(static_self_cast<Monster>());
 	g_game().sendUpdateCreature(static_self_cast<Monster>());
+	g_game().updateForgeableMonster(static_self_cast<Monster>());
 }
 
 bool Monster::canDropLoot() const {
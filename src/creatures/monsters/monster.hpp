@@ -39,11 +39,8 @@ public:
 		return static_self_cast<Monster>();
 	}
 
-	void setID() override {
-		if (id == 0) {
-			id = monsterAutoID++;
-		}
-	}
+	// The id comes from the registry of the game, given when the monster is added to it
+	void setID() override { }
 
 	void removeList() override;
 	void addList() override;
@@ -269,13 +266,15 @@ public:
 	}
 	// Hazard end
 
-	void updateTargetList();
+	// With the position we moved from, only the creatures that just came into view are looked at
+	void updateTargetList(const Position* previousPos = nullptr);
 	void clearTargetList();
 	void clearFriendList();
 
 	BlockType_t blockHit(std::shared_ptr<Creature> attacker, CombatType_t combatType, int32_t &damage, bool checkDefense = false, bool checkArmor = false, bool field = false) override;
 
-	static uint32_t monsterAutoID;
+	static constexpr uint32_t FIRST_ID = 0x50000001;
+	static constexpr uint32_t LAST_ID = 0x7FFFFFFF;
 
 	void configureForgeSystem();
 
@@ -329,6 +328,8 @@ private:
 	CreatureWeakHashMap friendList;
 	CreatureIDList targetIDList;
 	CreatureWeakHashMap targetListMap;
+	// Set when the lists were cleared, the next update then looks at every creature in view
+	bool targetListsCleared = true;
 
 	time_t timeToChangeFiendish = 0;
 
@@ -376,6 +377,19 @@ private:
 	void onCreatureLeave(std::shared_ptr<Creature> creature);
 	void onCreatureFound(std::shared_ptr<Creature> creature, bool pushFront = false);
 
+	/**
+	 * The target and friend lists follow the moves of other creatures once per
+	 * dispatcher cycle, a monster in a crowd sees many moves in one. Each mover
+	 * is kept with its position before its first move of the cycle.
+	 */
+	void queueCreatureMove(const std::shared_ptr<Creature> &creature, const Position &oldPos);
+	void applyCreatureMoves();
+	static void applyAllCreatureMoves();
+
+	std::vector<std::pair<uint32_t, Position>> pendingCreatureMoves;
+	// Game thread only
+	static inline std::vector<std::shared_ptr<Monster>> monstersWithPendingMoves;
+
 	void updateLookDirection();
 
 	void addFriend(std::shared_ptr<Creature> creature);
@@ -396,12 +410,37 @@ private:
 	void onEndCondition(ConditionType_t type) override;
 
 	bool canUseAttack(const Position &pos, std::shared_ptr<Creature> target) const;
-	bool canUseSpell(const Position &pos, const Position &targetPos, const spellBlock_t &sb, uint32_t interval, bool &inRange, bool &resetTicks);
+	// Distance and time are taken once per think by the caller
+	bool canUseSpell(uint32_t targetDistance, int64_t timeNow, const spellBlock_t &sb, uint32_t interval, bool &inRange, bool &resetTicks);
 	bool getRandomStep(const Position &creaturePos, Direction &direction);
 	bool getDanceStep(const Position &creaturePos, Direction &direction, bool keepAttack = true, bool keepDistance = true);
 	bool isInSpawnRange(const Position &pos) const;
 	bool canWalkTo(Position pos, Direction direction);
 
+	// canWalkTo around one position, each direction probed at most once per step decision
+	class StepNeighbours {
+	public:
+		StepNeighbours(Monster &monster, const Position &origin) :
+			monster(monster), origin(origin) { }
+
+		bool canWalkTo(Direction direction) {
+			const uint8_t bit = 1 << direction;
+			if ((probed & bit) == 0) {
+				probed |= bit;
+				if (monster.canWalkTo(origin, direction)) {
+					walkable |= bit;
+				}
+			}
+			return (walkable & bit) != 0;
+		}
+
+	private:
+		Monster &monster;
+		const Position origin;
+		uint8_t probed = 0;
+		uint8_t walkable = 0;
+	};
+
 	static bool pushItem(std::shared_ptr<Item> item, const Direction &nextDirection);
 	static void pushItems(std::shared_ptr<Tile> tile, const Direction &nextDirection);
 	static bool pushCreature(std::shared_ptr<Creature> creature);
@@ -413,7 +452,7 @@ private:
 	void onThinkSound(uint32_t interval);
 
 	bool isFriend(std::shared_ptr<Creature> creature) const;
-	bool isOpponent(std::shared_ptr<Creature> creature) const;
+	bool isOpponent(const std::shared_ptr<Creature> &creature) const;
 
 	uint64_t getLostExperience() const override {
 		return skillLoss ? mType->info.experience : 0;
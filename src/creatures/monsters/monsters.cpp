@@ -269,6 +269,14 @@ bool Monsters::deserializeSpell(const std::shared_ptr<MonsterSpell> spell, spell
 	return true;
 }
 
+void MonsterType::addAttackSpell(spellBlock_t &&spellBlock) {
+	info.minAttackSpeed = std::min(info.minAttackSpeed, spellBlock.speed);
+	if (spellBlock.spell) {
+		(spellBlock.isMelee ? info.hasMeleeAttack : info.hasSpellAttack) = true;
+	}
+	info.attackSpells.push_back(std::move(spellBlock));
+}
+
 bool MonsterType::loadCallback(LuaScriptInterface* scriptInterface) {
 	int32_t id = scriptInterface->getEvent();
 	if (id == -1) {
@@ -292,14 +300,10 @@ bool MonsterType::loadCallback(LuaScriptInterface* scriptInterface) {
 }
 
 std::shared_ptr<MonsterType> Monsters::getMonsterType(const std::string &name) {
-	std::string lowerCaseName = asLowerCaseString(name);
-	if (auto it = monsters.find(lowerCaseName);
-		it != monsters.end()
-		// We will only return the MonsterType if it match the exact name of the monster
-		&& it->first.find(lowerCaseName) != it->first.npos) {
+	if (auto it = monsters.find(name); it != monsters.end()) {
 		return it->second;
 	}
-	g_logger().error("[Monsters::getMonsterType] - Monster with name {} not exist", lowerCaseName);
+	g_logger().error("[Monsters::getMonsterType] - Monster with name {} not exist", asLowerCaseString(name));
 	return nullptr;
 }
 
@@ -309,7 +313,7 @@ std::shared_ptr<MonsterType> Monsters::getMonsterTypeByRaceId(uint16_t raceId, b
 		return bossType;
 	}
 
-	auto monster_race_map = g_game().getBestiaryList();
+	const auto &monster_race_map = g_game().getBestiaryList();
 	auto it = monster_race_map.find(raceId);
 	if (it == monster_race_map.end()) {
 		return nullptr;
@@ -319,12 +323,9 @@ std::shared_ptr<MonsterType> Monsters::getMonsterTypeByRaceId(uint16_t raceId, b
 }
 
 bool Monsters::tryAddMonsterType(const std::string &name, const std::shared_ptr<MonsterType> mType) {
-	std::string lowerName = asLowerCaseString(name);
-	if (monsters.find(lowerName) != monsters.end()) {
+	if (!monsters.try_emplace(asLowerCaseString(name), mType).second) {
 		g_logger().debug("[{}] the monster with name '{}' already exist", __FUNCTION__, name);
 		return false;
 	}
-
-	monsters[lowerName] = mType;
 	return true;
 }
@@ -68,6 +68,10 @@ class MonsterType {
 		std::vector<LootBlock> lootItems;
 		std::vector<std::string> scripts;
 		std::vector<spellBlock_t> attackSpells;
+		// Summary of attackSpells, kept up to date by addAttackSpell
+		uint32_t minAttackSpeed = std::numeric_limits<uint32_t>::max();
+		bool hasMeleeAttack = false;
+		bool hasSpellAttack = false;
 		std::vector<spellBlock_t> defenseSpells;
 		std::vector<summonBlock_t> summons;
 
@@ -196,6 +200,7 @@ public:
 	}
 
 	void loadLoot(const std::shared_ptr<MonsterType> monsterType, LootBlock lootblock);
+	void addAttackSpell(spellBlock_t &&spellBlock);
 
 	bool canSpawn(const Position &pos);
 };
@@ -269,7 +274,8 @@ public:
 	bool deserializeSpell(const std::shared_ptr<MonsterSpell> spell, spellBlock_t &sb, const std::string &description = "");
 
 	std::unique_ptr<LuaScriptInterface> scriptInterface;
-	std::map<std::string, std::shared_ptr<MonsterType>> monsters;
+	// Keys in lower case, looked up in any case
+	std::map<std::string, std::shared_ptr<MonsterType>, CaseInsensitiveLess> monsters;
 
 private:
 	std::shared_ptr<ConditionDamage> getDamageCondition(ConditionType_t conditionType, int32_t maxDamage, int32_t minDamage, int32_t startDamage, uint32_t tickInterval);
@@ -115,14 +115,81 @@ void SpawnsMonster::startup() {
 		return;
 	}
 
-	for (SpawnMonster &spawnMonster : spawnMonsterList) {
-		spawnMonster.startup();
+	if (g_configManager().getNumber(PROGRESSIVE_SPAWN_TIME) > 0) {
+		startupProgressive();
+	} else {
+		for (SpawnMonster &spawnMonster : spawnMonsterList) {
+			spawnMonster.startup();
+		}
 	}
 
 	started = true;
 }
 
+void SpawnsMonster::startupProgressive() {
+	const auto radius = static_cast<int32_t>(g_configManager().getNumber(PROGRESSIVE_SPAWN_RADIUS));
+	const auto &towns = g_game().map.towns.getTowns();
+	const auto isNearTown = [&towns, radius](const Position &pos) {
+		return std::ranges::any_of(towns, [&pos, radius](const auto &it) {
+			const auto &temple = it.second->getTemplePosition();
+			return Position::getDistanceX(pos, temple) <= radius && Position::getDistanceY(pos, temple) <= radius;
+		});
+	};
+
+	size_t nearTown = 0;
+	pendingStartup.clear();
+	for (SpawnMonster &spawnMonster : spawnMonsterList) {
+		if (isNearTown(spawnMonster.getCenterPos())) {
+			spawnMonster.startup();
+			++nearTown;
+		} else {
+			pendingStartup.emplace_back(&spawnMonster);
+		}
+	}
+
+	g_logger().info("Progressive spawn: {} spawns near towns placed, {} more over the next {} seconds", nearTown, pendingStartup.size(), g_configManager().getNumber(PROGRESSIVE_SPAWN_TIME));
+	if (pendingStartup.empty()) {
+		return;
+	}
+
+	// One batch every 100 ms
+	const auto batches = static_cast<size_t>(g_configManager().getNumber(PROGRESSIVE_SPAWN_TIME)) * 10;
+	startupBatchSize = (pendingStartup.size() + batches - 1) / batches;
+	pendingStartupIndex = 0;
+	startupBegin = getPreciseTimeMs();
+	startupEvent = g_scheduler().addEvent(100, [this] { startupPendingBatch(); }, "SpawnsMonster::startupPendingBatch");
+}
+
+void SpawnsMonster::startupPendingBatch() {
+	startupEvent = 0;
+
+	const size_t total = pendingStartup.size();
+	const size_t quarter = std::max<size_t>(1, total / 4);
+	const size_t end = std::min(total, pendingStartupIndex + startupBatchSize);
+	for (; pendingStartupIndex < end; ++pendingStartupIndex) {
+		pendingStartup[pendingStartupIndex]->startup(true);
+		if ((pendingStartupIndex + 1) % quarter == 0 && pendingStartupIndex + 1 < total) {
+			g_logger().info("Progressive spawn: {}/{} spawns placed", pendingStartupIndex + 1, total);
+		}
+	}
+
+	if (pendingStartupIndex < total) {
+		startupEvent = g_scheduler().addEvent(100, [this] { startupPendingBatch(); }, "SpawnsMonster::startupPendingBatch");
+		return;
+	}
+
+	g_logger().info("Progressive spawn: all {} spawns placed in {} seconds", total, (getPreciseTimeMs() - startupBegin) / 1000);
+	pendingStartup.clear();
+	pendingStartup.shrink_to_fit();
+}
+
 void SpawnsMonster::clear() {
+	if (startupEvent != 0) {
+		g_scheduler().stopEvent(startupEvent);
+		startupEvent = 0;
+	}
+	pendingStartup.clear();
+
 	for (SpawnMonster &spawnMonster : spawnMonsterList) {
 		spawnMonster.stopEvent();
 	}
@@ -141,13 +208,82 @@ bool SpawnsMonster::isInZone(const Position &centerPos, int32_t radius, const Po
 	return ((pos.getX() >= centerPos.getX() - radius) && (pos.getX() <= centerPos.getX() + radius) && (pos.getY() >= centerPos.getY() - radius) && (pos.getY() <= centerPos.getY() + radius));
 }
 
-void SpawnMonster::startSpawnMonsterCheck() {
-	if (checkSpawnMonsterEvent == 0) {
-		checkSpawnMonsterEvent = g_scheduler().addEvent(getInterval(), std::bind(&SpawnMonster::checkSpawnMonster, this), "SpawnMonster::checkSpawnMonster");
+SpawnMonsterWheel &SpawnMonsterWheel::getInstance() {
+	return inject<SpawnMonsterWheel>();
+}
+
+void SpawnMonsterWheel::schedule(SpawnMonster* spawn, uint32_t delay) {
+	if (spawn->checkSlot != -1) {
+		return;
+	}
+
+	const int64_t deadline = OTSYS_TIME() + delay;
+	const int64_t slotTime = std::max((deadline + SLOT_DURATION - 1) / SLOT_DURATION, processedSlotTime + 1);
+	const auto slot = static_cast<int32_t>(slotTime % SLOT_COUNT);
+	slots[slot].emplace_back(spawn, deadline);
+	spawn->checkSlot = slot;
+	++pending;
+
+	if (tickEvent == 0) {
+		if (processedSlotTime == 0) {
+			processedSlotTime = OTSYS_TIME() / SLOT_DURATION;
+		}
+		tickEvent = g_scheduler().addEvent(static_cast<uint32_t>(SLOT_DURATION), [this] { tick(); }, "SpawnMonsterWheel::tick");
+	}
+}
+
+void SpawnMonsterWheel::cancel(SpawnMonster* spawn) {
+	if (spawn->checkSlot == -1) {
+		return;
 	}
+
+	auto &slot = slots[spawn->checkSlot];
+	std::erase_if(slot, [spawn](const Entry &entry) { return entry.spawn == spawn; });
+	spawn->checkSlot = -1;
+	--pending;
+}
+
+void SpawnMonsterWheel::tick() {
+	tickEvent = 0;
+
+	const int64_t now = OTSYS_TIME();
+	const int64_t slotTime = now / SLOT_DURATION;
+	// After a long stall every slot is looked at once
+	const int64_t firstSlotTime = std::max(processedSlotTime + 1, slotTime - static_cast<int64_t>(SLOT_COUNT) + 1);
+
+	std::vector<SpawnMonster*> due;
+	for (int64_t time = firstSlotTime; time <= slotTime; ++time) {
+		auto &slot = slots[time % SLOT_COUNT];
+		std::erase_if(slot, [now, &due](const Entry &entry) {
+			if (entry.deadline > now) {
+				return false;
+			}
+			due.emplace_back(entry.spawn);
+			return true;
+		});
+	}
+	processedSlotTime = std::max(processedSlotTime, slotTime);
+
+	// Marked first, a check may schedule the next one of its spawn
+	pending -= due.size();
+	for (const auto spawn : due) {
+		spawn->checkSlot = -1;
+	}
+	for (const auto spawn : due) {
+		spawn->checkSpawnMonster();
+	}
+
+	if (pending > 0 && tickEvent == 0) {
+		tickEvent = g_scheduler().addEvent(static_cast<uint32_t>(SLOT_DURATION), [this] { tick(); }, "SpawnMonsterWheel::tick");
+	}
+}
+
+void SpawnMonster::startSpawnMonsterCheck() {
+	g_spawnMonsterWheel().schedule(this, getInterval());
 }
 
 SpawnMonster::~SpawnMonster() {
+
 	for (const auto &it : spawnedMonsterMap) {
 		std::shared_ptr<Monster> monster = it.second;
 		monster->setSpawnMonster(nullptr);
@@ -155,9 +291,14 @@ SpawnMonster::~SpawnMonster() {
 }
 
 bool SpawnMonster::findPlayer(const Position &pos) {
+	// No player was in view of the sector lately, skip the spectator scan
+	if (!g_game().map.isSectorActive(pos)) {
+		return false;
+	}
+
 	SpectatorHashSet spectators;
 	g_game().map.getSpectators(spectators, pos, false, true);
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (!spectator->getPlayer()->hasFlag(PlayerFlags_t::IgnoredByMonsters)) {
 			return true;
 		}
@@ -193,17 +334,15 @@ bool SpawnMonster::spawnMonster(uint32_t spawnMonsterId, const std::shared_ptr<M
 	return true;
 }
 
-void SpawnMonster::startup() {
+void SpawnMonster::startup(bool notify /* = false*/) {
 	for (const auto &it : spawnMonsterMap) {
 		uint32_t spawnMonsterId = it.first;
 		const spawnBlock_t &sb = it.second;
-		spawnMonster(spawnMonsterId, sb.monsterType, sb.pos, sb.direction, true);
+		spawnMonster(spawnMonsterId, sb.monsterType, sb.pos, sb.direction, !notify);
 	}
 }
 
 void SpawnMonster::checkSpawnMonster() {
-	checkSpawnMonsterEvent = 0;
-
 	cleanup();
 
 	uint32_t spawnMonsterCount = 0;
@@ -239,7 +378,7 @@ void SpawnMonster::checkSpawnMonster() {
 	}
 
 	if (spawnedMonsterMap.size() < spawnMonsterMap.size()) {
-		checkSpawnMonsterEvent = g_scheduler().addEvent(getInterval(), std::bind(&SpawnMonster::checkSpawnMonster, this), "SpawnMonster::checkSpawnMonster");
+		startSpawnMonsterCheck();
 	}
 }
 
@@ -297,8 +436,5 @@ void SpawnMonster::removeMonster(std::shared_ptr<Monster> monster) {
 }
 
 void SpawnMonster::stopEvent() {
-	if (checkSpawnMonsterEvent != 0) {
-		g_scheduler().stopEvent(checkSpawnMonsterEvent);
-		checkSpawnMonsterEvent = 0;
-	}
+	g_spawnMonsterWheel().cancel(this);
 }
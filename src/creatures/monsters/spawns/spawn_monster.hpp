@@ -39,7 +39,12 @@ public:
 	uint32_t getInterval() const {
 		return interval;
 	}
-	void startup();
+	// Spawns every monster of the spawn, the spectators are told unless the server is still starting
+	void startup(bool notify = false);
+
+	const Position &getCenterPos() const {
+		return centerPos;
+	}
 
 	void startSpawnMonsterCheck();
 	void stopEvent();
@@ -60,14 +65,58 @@ private:
 	int32_t radius;
 
 	uint32_t interval = 30000;
-	uint32_t checkSpawnMonsterEvent = 0;
+	// Slot of the pending check in the SpawnMonsterWheel, -1 when none is pending
+	int32_t checkSlot = -1;
 
 	static bool findPlayer(const Position &pos);
 	bool spawnMonster(uint32_t spawnMonsterId, const std::shared_ptr<MonsterType> monsterType, const Position &pos, Direction dir, bool startup = false);
 	void checkSpawnMonster();
 	void scheduleSpawn(uint32_t spawnMonsterId, spawnBlock_t &sb, uint16_t interval);
+
+	friend class SpawnMonsterWheel;
 };
 
+/**
+ * Runs the checks of every monster spawn from a single scheduler event.
+ * A pending check waits in a wheel of one second slots by its deadline,
+ * the event only ticks while some check is pending and each tick only
+ * looks at the slot that came due. Checks further away than a full turn
+ * stay in their slot until the turn they are due.
+ */
+class SpawnMonsterWheel {
+public:
+	static constexpr int64_t SLOT_DURATION = 1000;
+	static constexpr size_t SLOT_COUNT = 512;
+
+	SpawnMonsterWheel() = default;
+
+	// Ensures that we don't accidentally copy it
+	SpawnMonsterWheel(const SpawnMonsterWheel &) = delete;
+	SpawnMonsterWheel operator=(const SpawnMonsterWheel &) = delete;
+
+	static SpawnMonsterWheel &getInstance();
+
+	// Does nothing when the spawn already has a check pending
+	void schedule(SpawnMonster* spawn, uint32_t delay);
+	void cancel(SpawnMonster* spawn);
+
+private:
+	struct Entry {
+		SpawnMonster* spawn;
+		int64_t deadline;
+	};
+
+	void tick();
+
+	std::array<std::vector<Entry>, SLOT_COUNT> slots;
+	// Last slot time (deadline / SLOT_DURATION, rounded up) the ticks went through
+	int64_t processedSlotTime = 0;
+	size_t pending = 0;
+	uint32_t tickEvent = 0;
+};
+
+constexpr auto g_spawnMonsterWheel = SpawnMonsterWheel::getInstance;
+
 class SpawnsMonster {
 public:
 	static bool isInZone(const Position &centerPos, int32_t radius, const Position &pos);
@@ -87,7 +136,16 @@ public:
 	}
 
 private:
+	// Progressive startup, spawns the ones near towns now and the others over progressiveSpawnTime
+	void startupProgressive();
+	void startupPendingBatch();
+
 	std::forward_list<SpawnMonster> spawnMonsterList;
+	std::vector<SpawnMonster*> pendingStartup;
+	size_t pendingStartupIndex = 0;
+	size_t startupBatchSize = 0;
+	int64_t startupBegin = 0;
+	uint32_t startupEvent = 0;
 	std::string filemonstername;
 	bool loaded = false;
 	bool started = false;
@@ -20,8 +20,6 @@
 int32_t Npc::despawnRange;
 int32_t Npc::despawnRadius;
 
-uint32_t Npc::npcAutoID = 0x80000000;
-
 std::shared_ptr<Npc> Npc::createNpc(const std::string &name) {
 	const auto &npcType = g_npcs().getNpcType(name);
 	if (!npcType) {
@@ -260,13 +258,7 @@ void Npc::onPlayerBuyItem(std::shared_ptr<Player> player, uint16_t itemId, uint8
 		}
 	}
 
-	uint32_t buyPrice = 0;
-	const std::vector<ShopBlock> &shopVector = getShopItemVector();
-	for (ShopBlock shopBlock : shopVector) {
-		if (itemType.id == shopBlock.itemId && shopBlock.itemBuyPrice != 0) {
-			buyPrice = shopBlock.itemBuyPrice;
-		}
-	}
+	const uint32_t buyPrice = getShopBuyPrice(itemType.id);
 
 	uint32_t totalCost = buyPrice * amount;
 	uint32_t bagsCost = 0;
@@ -368,14 +360,8 @@ void Npc::onPlayerSellItem(std::shared_ptr<Player> player, uint16_t itemId, uint
 		return;
 	}
 
-	uint32_t sellPrice = 0;
 	const ItemType &itemType = Item::items[itemId];
-	const std::vector<ShopBlock> &shopVector = getShopItemVector();
-	for (ShopBlock shopBlock : shopVector) {
-		if (itemType.id == shopBlock.itemId && shopBlock.itemSellPrice != 0) {
-			sellPrice = shopBlock.itemSellPrice;
-		}
-	}
+	const uint32_t sellPrice = getShopSellPrice(itemType.id);
 	if (sellPrice == 0) {
 		return;
 	}
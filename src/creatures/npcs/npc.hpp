@@ -41,11 +41,8 @@ public:
 		return static_self_cast<Npc>();
 	}
 
-	void setID() override {
-		if (id == 0) {
-			id = npcAutoID++;
-		}
-	}
+	// The id comes from the registry of the game, given when the npc is added to it
+	void setID() override { }
 
 	void removeList() override;
 	void addList() override;
@@ -93,9 +90,22 @@ public:
 		npcType->info.currencyId = currency;
 	}
 
-	std::vector<ShopBlock> getShopItemVector() {
+	const std::vector<ShopBlock> &getShopItemVector() const {
 		return npcType->info.shopItemVector;
 	}
+	// 0 when the npc does not sell the item
+	uint32_t getShopBuyPrice(uint16_t itemId) const {
+		const auto it = npcType->info.shopBuyPrices.find(itemId);
+		return it != npcType->info.shopBuyPrices.end() ? it->second : 0;
+	}
+	// 0 when the npc does not buy the item
+	uint32_t getShopSellPrice(uint16_t itemId) const {
+		const auto it = npcType->info.shopSellPrices.find(itemId);
+		return it != npcType->info.shopSellPrices.end() ? it->second : 0;
+	}
+	const phmap::flat_hash_map<uint16_t, uint32_t> &getShopSellPrices() const {
+		return npcType->info.shopSellPrices;
+	}
 
 	bool isPushable() override {
 		return npcType->info.pushable;
@@ -160,7 +170,8 @@ public:
 	void removeShopPlayer(const std::shared_ptr<Player> &player);
 	void closeAllShopWindows();
 
-	static uint32_t npcAutoID;
+	static constexpr uint32_t FIRST_ID = 0x80000000;
+	static constexpr uint32_t LAST_ID = 0xFFFFFFFF;
 
 	void onCreatureWalk() override;
 
@@ -91,6 +91,13 @@ void NpcType::loadShop(const std::shared_ptr<NpcType> &npcType, ShopBlock shopBl
 		}
 	}
 
+	if (shopBlock.itemBuyPrice != 0) {
+		npcType->info.shopBuyPrices[shopBlock.itemId] = shopBlock.itemBuyPrice;
+	}
+	if (shopBlock.itemSellPrice != 0) {
+		npcType->info.shopSellPrices[shopBlock.itemId] = shopBlock.itemSellPrice;
+	}
+
 	if (shopBlock.childShop.empty()) {
 		bool isContainer = iType.isContainer();
 		if (isContainer) {
@@ -135,12 +142,11 @@ bool Npcs::reload() {
 }
 
 std::shared_ptr<NpcType> Npcs::getNpcType(const std::string &name, bool create /* = false*/) {
-	std::string key = asLowerCaseString(name);
-	auto it = npcs.find(key);
+	auto it = npcs.find(name);
 
 	if (it != npcs.end()) {
 		return it->second;
 	}
 
-	return create ? npcs[key] = std::make_shared<NpcType>(name) : nullptr;
+	return create ? npcs[asLowerCaseString(name)] = std::make_shared<NpcType>(name) : nullptr;
 }
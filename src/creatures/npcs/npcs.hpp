@@ -68,6 +68,9 @@ class NpcType : public SharedObject {
 		std::vector<voiceBlock_t> voiceVector;
 		std::vector<std::string> scripts;
 		std::vector<ShopBlock> shopItemVector;
+		// Item id to the price of its last shop entry with one, the players buy at shopBuyPrices
+		phmap::flat_hash_map<uint16_t, uint32_t> shopBuyPrices;
+		phmap::flat_hash_map<uint16_t, uint32_t> shopSellPrices;
 
 		NpcsEvent_t eventType = NPCS_EVENT_NONE;
 	};
@@ -111,7 +114,8 @@ public:
 
 private:
 	std::unique_ptr<LuaScriptInterface> scriptInterface;
-	std::map<std::string, std::shared_ptr<NpcType>> npcs;
+	// Keys in lower case, looked up in any case
+	std::map<std::string, std::shared_ptr<NpcType>, CaseInsensitiveLess> npcs;
 };
 
 constexpr auto g_npcs = Npcs::getInstance;
@@ -14,6 +14,7 @@
 
 void Guild::addMember(const std::shared_ptr<Player> &player) {
 	membersOnline.push_back(player);
+	online = true;
 	for (auto member : getMembersOnline()) {
 		g_game().updatePlayerHelpers(member);
 	}
@@ -28,7 +29,8 @@ void Guild::removeMember(const std::shared_ptr<Player> &player) {
 
 	g_game().updatePlayerHelpers(player);
 	if (membersOnline.empty()) {
-		g_game().removeGuild(id);
+		online = false;
+		g_game().saveOfflineGuild(id);
 	}
 }
 
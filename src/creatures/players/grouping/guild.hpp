@@ -64,7 +64,17 @@ public:
 		return bankBalance;
 	}
 	void setBankBalance(uint64_t balance) override {
-		bankBalance = balance;
+		if (bankBalance != balance) {
+			bankBalance = balance;
+			unsavedChanges = true;
+		}
+	}
+
+	bool hasUnsavedChanges() const {
+		return unsavedChanges;
+	}
+	void setSaved() {
+		unsavedChanges = false;
 	}
 
 	const std::vector<GuildRank_ptr> &getRanks() const {
@@ -91,5 +101,7 @@ private:
 	std::string motd;
 	uint32_t id;
 	uint32_t memberCount = 0;
-	bool online = true;
+	// Whether members are online, the guild stays cached in Game either way
+	bool online = false;
+	bool unsavedChanges = false;
 };
@@ -11,6 +11,7 @@
 
 #include "creatures/players/grouping/party.hpp"
 #include "game/game.hpp"
+#include "game/scheduling/dispatcher.hpp"
 #include "lua/creature/events.hpp"
 #include "lua/callbacks/event_callback.hpp"
 #include "lua/callbacks/events_callbacks.hpp"
@@ -387,8 +388,23 @@ void Party::broadcastPartyMessage(MessageClasses msgClass, const std::string &ms
 	}
 }
 
+void Party::updateFarMembers() {
+	farMembers.clear();
+	auto leader = getLeader();
+	if (!leader) {
+		return;
+	}
+
+	for (const auto &member : memberList) {
+		if (!Position::areInRange<30, 30, 1>(leader->getPosition(), member->getPosition())) {
+			farMembers.insert(member->getID());
+		}
+	}
+}
+
 void Party::updateSharedExperience() {
 	if (sharedExpActive) {
+		updateFarMembers();
 		bool result = getSharedExperienceStatus() == SHAREDEXP_OK;
 		if (result != sharedExpEnabled) {
 			sharedExpEnabled = result;
@@ -427,6 +443,7 @@ bool Party::setSharedExperience(std::shared_ptr<Player> player, bool newSharedEx
 	this->sharedExpActive = newSharedExpActive;
 
 	if (newSharedExpActive) {
+		updateFarMembers();
 		SharedExpStatus_t sharedExpStatus = getSharedExperienceStatus();
 		this->sharedExpEnabled = sharedExpStatus == SHAREDEXP_OK;
 		if (!silent) {
@@ -467,12 +484,14 @@ SharedExpStatus_t Party::getMemberSharedExperienceStatus(std::shared_ptr<Player>
 	if (!leader) {
 		return SHAREDEXP_EMPTYPARTY;
 	}
+	return getMemberSharedExperienceStatus(leader, player, getMinLevel());
+}
+
+SharedExpStatus_t Party::getMemberSharedExperienceStatus(const std::shared_ptr<Player> &leader, const std::shared_ptr<Player> &player, uint32_t minLevel) const {
 	if (memberList.empty()) {
 		return SHAREDEXP_EMPTYPARTY;
 	}
 
-	uint32_t highestLevel = getHighestLevel();
-	uint32_t minLevel = getMinLevel();
 	if (player->getLevel() < minLevel) {
 		return SHAREDEXP_LEVELDIFFTOOLARGE;
 	}
@@ -496,7 +515,7 @@ uint32_t Party::getHighestLevel() {
 	}
 
 	uint32_t highestLevel = leader->getLevel();
-	for (auto member : getMembers()) {
+	for (const auto &member : memberList) {
 		if (member->getLevel() > highestLevel) {
 			highestLevel = member->getLevel();
 		}
@@ -514,7 +533,7 @@ uint32_t Party::getLowestLevel() {
 		return 0;
 	}
 	uint32_t lowestLevel = leader->getLevel();
-	for (auto member : getMembers()) {
+	for (const auto &member : memberList) {
 		if (member->getLevel() < lowestLevel) {
 			lowestLevel = member->getLevel();
 		}
@@ -526,7 +545,7 @@ uint32_t Party::getMaxLevel() {
 	return static_cast<uint32_t>(std::floor((static_cast<float>(getLowestLevel()) * 3) / 2));
 }
 
-bool Party::isPlayerActive(std::shared_ptr<Player> player) {
+bool Party::isPlayerActive(const std::shared_ptr<Player> &player) const {
 	auto it = ticksMap.find(player->getID());
 	if (it == ticksMap.end()) {
 		return false;
@@ -541,13 +560,14 @@ SharedExpStatus_t Party::getSharedExperienceStatus() {
 	if (!leader) {
 		return SHAREDEXP_EMPTYPARTY;
 	}
-	SharedExpStatus_t leaderStatus = getMemberSharedExperienceStatus(leader);
+	const uint32_t minLevel = getMinLevel();
+	SharedExpStatus_t leaderStatus = getMemberSharedExperienceStatus(leader, leader, minLevel);
 	if (leaderStatus != SHAREDEXP_OK) {
 		return leaderStatus;
 	}
 
-	for (auto member : getMembers()) {
-		SharedExpStatus_t memberStatus = getMemberSharedExperienceStatus(member);
+	for (const auto &member : memberList) {
+		SharedExpStatus_t memberStatus = getMemberSharedExperienceStatus(leader, member, minLevel);
 		if (memberStatus != SHAREDEXP_OK) {
 			return memberStatus;
 		}
@@ -555,10 +575,14 @@ SharedExpStatus_t Party::getSharedExperienceStatus() {
 	return SHAREDEXP_OK;
 }
 
-void Party::updatePlayerTicks(std::shared_ptr<Player> player, uint32_t points) {
+void Party::updatePlayerTicks(const std::shared_ptr<Player> &player, uint32_t points) {
 	if (points != 0 && !player->hasFlag(PlayerFlags_t::NotGainInFight)) {
+		// Only becoming active can change the shared experience status, not staying active
+		const bool wasActive = isPlayerActive(player);
 		ticksMap[player->getID()] = OTSYS_TIME();
-		updateSharedExperience();
+		if (!wasActive) {
+			updateSharedExperience();
+		}
 	}
 }
 
@@ -637,9 +661,21 @@ void Party::updatePlayerStatus(std::shared_ptr<Player> player, const Position &o
 		return;
 	}
 
+	if (sharedExpActive) {
+		// A member step only matters once it crosses the range of the leader, a leader step may move anyone in or out
+		if (player == leader) {
+			updateSharedExperience();
+		} else {
+			const bool far = !Position::areInRange<30, 30, 1>(leader->getPosition(), newPos);
+			if (far ? farMembers.insert(player->getID()).second : farMembers.erase(player->getID()) > 0) {
+				updateSharedExperience();
+			}
+		}
+	}
+
 	int32_t maxDistance = g_configManager().getNumber(PARTY_LIST_MAX_DISTANCE);
 	if (maxDistance != 0) {
-		for (auto member : getMembers()) {
+		for (const auto &member : memberList) {
 			bool condition1 = (Position::getDistanceX(oldPos, member->getPosition()) <= maxDistance && Position::getDistanceY(oldPos, member->getPosition()) <= maxDistance);
 			bool condition2 = (Position::getDistanceX(newPos, member->getPosition()) <= maxDistance && Position::getDistanceY(newPos, member->getPosition()) <= maxDistance);
 			if (condition1 && !condition2) {
@@ -660,43 +696,87 @@ void Party::updatePlayerStatus(std::shared_ptr<Player> player, const Position &o
 }
 
 void Party::updatePlayerHealth(std::shared_ptr<Player> player, std::shared_ptr<Creature> target, uint8_t healthPercent) {
-	auto leader = getLeader();
-	if (!leader) {
+	queueStatus(player, target, false, healthPercent);
+}
+
+void Party::updatePlayerMana(std::shared_ptr<Player> player, uint8_t manaPercent) {
+	queueStatus(player, player, true, manaPercent);
+}
+
+void Party::queueStatus(const std::shared_ptr<Player> &player, const std::shared_ptr<Creature> &creature, bool mana, uint8_t percent) {
+	if (!getLeader()) {
 		return;
 	}
 
-	int32_t maxDistance = g_configManager().getNumber(PARTY_LIST_MAX_DISTANCE);
-	auto playerPosition = player->getPosition();
-	auto leaderPosition = leader->getPosition();
-	for (auto member : getMembers()) {
-		auto memberPosition = member->getPosition();
-		bool condition = (maxDistance == 0 || (Position::getDistanceX(playerPosition, memberPosition) <= maxDistance && Position::getDistanceY(playerPosition, memberPosition) <= maxDistance));
-		if (condition) {
-			member->sendPartyCreatureHealth(target, healthPercent);
-		}
+	static bool handlerAdded = false;
+	if (!handlerAdded) {
+		handlerAdded = true;
+		g_dispatcher().prependCycleEndHandler(&Party::sendAllPendingStatus);
 	}
-	bool condition = (maxDistance == 0 || (Position::getDistanceX(playerPosition, leaderPosition) <= maxDistance && Position::getDistanceY(playerPosition, leaderPosition) <= maxDistance));
-	if (condition) {
-		leader->sendPartyCreatureHealth(target, healthPercent);
+
+	const uint32_t creatureId = creature->getID();
+	if (auto it = std::ranges::find_if(pendingStatus, [creatureId, mana](const PendingStatus &pending) {
+			return pending.creatureId == creatureId && pending.mana == mana;
+		});
+	    it != pendingStatus.end()) {
+		it->player = player;
+		it->percent = percent;
+		return;
+	}
+
+	if (pendingStatus.empty()) {
+		pendingStatusParties.emplace_back(getParty());
 	}
+	pendingStatus.emplace_back(player, creature, creatureId, mana, percent);
 }
 
-void Party::updatePlayerMana(std::shared_ptr<Player> player, uint8_t manaPercent) {
+void Party::sendAllPendingStatus() {
+	if (pendingStatusParties.empty()) {
+		return;
+	}
+
+	const auto parties = std::move(pendingStatusParties);
+	pendingStatusParties.clear();
+	for (const auto &party : parties) {
+		party->sendPendingStatus();
+	}
+}
+
+void Party::sendPendingStatus() {
+	const auto pending = std::move(pendingStatus);
+	pendingStatus.clear();
+
 	auto leader = getLeader();
 	if (!leader) {
 		return;
 	}
 
 	int32_t maxDistance = g_configManager().getNumber(PARTY_LIST_MAX_DISTANCE);
-	for (auto member : getMembers()) {
-		bool condition = (maxDistance == 0 || (Position::getDistanceX(player->getPosition(), member->getPosition()) <= maxDistance && Position::getDistanceY(player->getPosition(), member->getPosition()) <= maxDistance));
-		if (condition) {
-			member->sendPartyPlayerMana(player, manaPercent);
+	for (const auto &status : pending) {
+		const auto player = status.player.lock();
+		const auto creature = status.creature.lock();
+		if (!player || !creature || (player != leader && player->getParty().get() != this)) {
+			continue;
 		}
-	}
-	bool condition = (maxDistance == 0 || (Position::getDistanceX(player->getPosition(), leader->getPosition()) <= maxDistance && Position::getDistanceY(player->getPosition(), leader->getPosition()) <= maxDistance));
-	if (condition) {
-		leader->sendPartyPlayerMana(player, manaPercent);
+
+		const auto &playerPosition = player->getPosition();
+		const auto send = [&](const std::shared_ptr<Player> &receiver) {
+			const auto &receiverPosition = receiver->getPosition();
+			if (maxDistance != 0 && (Position::getDistanceX(playerPosition, receiverPosition) > maxDistance || Position::getDistanceY(playerPosition, receiverPosition) > maxDistance)) {
+				return;
+			}
+
+			if (status.mana) {
+				receiver->sendPartyPlayerMana(player, status.percent);
+			} else {
+				receiver->sendPartyCreatureHealth(creature, status.percent);
+			}
+		};
+
+		for (const auto &member : memberList) {
+			send(member);
+		}
+		send(leader);
 	}
 }
 
@@ -725,13 +805,32 @@ void Party::updateTrackerAnalyzer() {
 		return;
 	}
 
-	for (auto member : getMembers()) {
+	if (analyzerBatchDepth > 0) {
+		if (auto self = getParty(); std::ranges::find(batchedAnalyzers, self) == batchedAnalyzers.end()) {
+			batchedAnalyzers.emplace_back(std::move(self));
+		}
+		return;
+	}
+
+	for (const auto &member : memberList) {
 		member->updatePartyTrackerAnalyzer();
 	}
 
 	leader->updatePartyTrackerAnalyzer();
 }
 
+void Party::endAnalyzerBatch() {
+	if (--analyzerBatchDepth > 0) {
+		return;
+	}
+
+	const auto parties = std::move(batchedAnalyzers);
+	batchedAnalyzers.clear();
+	for (const auto &party : parties) {
+		party->updateTrackerAnalyzer();
+	}
+}
+
 void Party::addPlayerLoot(std::shared_ptr<Player> player, std::shared_ptr<Item> item) {
 	auto leader = getLeader();
 	if (!leader) {
@@ -77,7 +77,7 @@ public:
 	SharedExpStatus_t getMemberSharedExperienceStatus(std::shared_ptr<Player> player);
 	void updateSharedExperience();
 
-	void updatePlayerTicks(std::shared_ptr<Player> player, uint32_t points);
+	void updatePlayerTicks(const std::shared_ptr<Player> &player, uint32_t points);
 	void clearPlayerPoints(std::shared_ptr<Player> player);
 
 	void showPlayerStatus(std::shared_ptr<Player> player, std::shared_ptr<Player> member, bool showStatus);
@@ -88,6 +88,11 @@ public:
 	void updatePlayerVocation(std::shared_ptr<Player> player);
 
 	void updateTrackerAnalyzer();
+	// While a batch is open each party sends its analyzer once, when the outermost batch ends
+	static void beginAnalyzerBatch() {
+		++analyzerBatchDepth;
+	}
+	static void endAnalyzerBatch();
 	void addPlayerLoot(std::shared_ptr<Player> player, std::shared_ptr<Item> item);
 	void addPlayerSupply(std::shared_ptr<Player> player, std::shared_ptr<Item> item);
 	void addPlayerDamage(std::shared_ptr<Player> player, uint64_t amount);
@@ -118,15 +123,33 @@ public:
 	std::vector<std::shared_ptr<PartyAnalyzer>> membersData;
 
 private:
+	struct PendingStatus {
+		std::weak_ptr<Player> player;
+		std::weak_ptr<Creature> creature;
+		uint32_t creatureId;
+		bool mana;
+		uint8_t percent;
+	};
+
 	const char* getSharedExpReturnMessage(SharedExpStatus_t value);
-	bool isPlayerActive(std::shared_ptr<Player> player);
+	bool isPlayerActive(const std::shared_ptr<Player> &player) const;
+	SharedExpStatus_t getMemberSharedExperienceStatus(const std::shared_ptr<Player> &leader, const std::shared_ptr<Player> &player, uint32_t minLevel) const;
 	SharedExpStatus_t getSharedExperienceStatus();
+	void updateFarMembers();
+
+	// Keeps the last percent of each creature, the party gets them once at the end of the dispatcher cycle
+	void queueStatus(const std::shared_ptr<Player> &player, const std::shared_ptr<Creature> &creature, bool mana, uint8_t percent);
+	void sendPendingStatus();
+	static void sendAllPendingStatus();
 	uint32_t getHighestLevel();
 	uint32_t getLowestLevel();
 	uint32_t getMinLevel();
 	uint32_t getMaxLevel();
 
 	std::map<uint32_t, int64_t> ticksMap;
+	// Members out of shared experience range of the leader, as of their last move
+	phmap::flat_hash_set<uint32_t> farMembers;
+	std::vector<PendingStatus> pendingStatus;
 
 	std::vector<std::shared_ptr<Player>> memberList;
 	std::vector<std::shared_ptr<Player>> inviteList;
@@ -135,4 +158,28 @@ private:
 
 	bool sharedExpActive = false;
 	bool sharedExpEnabled = false;
+
+	// Game thread only
+	static inline uint32_t analyzerBatchDepth = 0;
+	static inline std::vector<std::shared_ptr<Party>> batchedAnalyzers;
+	static inline std::vector<std::shared_ptr<Party>> pendingStatusParties;
+};
+
+/**
+ * Groups the analyzer updates of a multi target cast or a bulk loot, so
+ * every party member gets one analyzer packet with the totals instead of
+ * one per hit or looted item.
+ */
+class PartyAnalyzerBatch {
+public:
+	PartyAnalyzerBatch() {
+		Party::beginAnalyzerBatch();
+	}
+	~PartyAnalyzerBatch() {
+		Party::endAnalyzerBatch();
+	}
+
+	// Ensures that we don't accidentally copy it
+	PartyAnalyzerBatch(const PartyAnalyzerBatch &) = delete;
+	PartyAnalyzerBatch operator=(const PartyAnalyzerBatch &) = delete;
 };
@@ -11,7 +11,11 @@
 
 #include "creatures/players/management/ban.hpp"
 #include "database/database.hpp"
+#include "config/configmanager.hpp"
 #include "database/databasetasks.hpp"
+#include "game/scheduling/scheduler.hpp"
+#include "lib/di/container.hpp"
+#include "lib/thread/thread_pool.hpp"
 #include "utils/tools.hpp"
 
 bool Ban::acceptConnection(uint32_t clientIP) {
@@ -47,33 +51,97 @@ bool Ban::acceptConnection(uint32_t clientIP) {
 	return true;
 }
 
-bool IOBan::isAccountBanned(uint32_t accountId, BanInfo &banInfo) {
-	Database &db = Database::getInstance();
+namespace {
+	struct BanEntry {
+		BanInfo info;
+		time_t bannedAt = 0;
+		uint32_t bannedBy = 0;
+	};
+
+	struct BanTables {
+		phmap::flat_hash_map<uint32_t, BanEntry> accounts;
+		phmap::flat_hash_map<uint32_t, BanEntry> ips;
+		phmap::flat_hash_set<uint32_t> namelocks;
+	};
+
+	std::mutex tablesMutex;
+	BanTables tables;
+	// A load started later read the database later, so an older one finishing last is dropped
+	std::atomic<uint64_t> lastLoad = 0;
+	uint64_t appliedLoad = 0;
+
+	void readBans(Database &db, const std::string &query, const std::string &key, phmap::flat_hash_map<uint32_t, BanEntry> &bans) {
+		DBResult_ptr result = db.storeQuery(query);
+		if (!result) {
+			return;
+		}
+
+		do {
+			auto &entry = bans[result->getNumber<uint32_t>(key)];
+			entry.info.reason = result->getString("reason");
+			entry.info.expiresAt = result->getNumber<time_t>("expires_at");
+			entry.info.bannedBy = result->getString("name");
+			entry.bannedAt = result->getNumber<time_t>("banned_at");
+			entry.bannedBy = result->getNumber<uint32_t>("banned_by");
+		} while (result->next());
+	}
+
+	void loadTables() {
+		const auto load = ++lastLoad;
+
+		Database &db = Database::getInstance();
+		BanTables loaded;
+		readBans(db, "SELECT `b`.`account_id`, `b`.`reason`, `b`.`banned_at`, `b`.`expires_at`, `b`.`banned_by`, `p`.`name` FROM `account_bans` `b` LEFT JOIN `players` `p` ON `p`.`id` = `b`.`banned_by`", "account_id", loaded.accounts);
+		readBans(db, "SELECT `b`.`ip`, `b`.`reason`, `b`.`banned_at`, `b`.`expires_at`, `b`.`banned_by`, `p`.`name` FROM `ip_bans` `b` LEFT JOIN `players` `p` ON `p`.`id` = `b`.`banned_by`", "ip", loaded.ips);
+		if (DBResult_ptr result = db.storeQuery("SELECT `player_id` FROM `player_namelocks`")) {
+			do {
+				loaded.namelocks.emplace(result->getNumber<uint32_t>("player_id"));
+			} while (result->next());
+		}
 
-	std::ostringstream query;
-	query << "SELECT `reason`, `expires_at`, `banned_at`, `banned_by`, (SELECT `name` FROM `players` WHERE `id` = `banned_by`) AS `name` FROM `account_bans` WHERE `account_id` = " << accountId;
+		std::scoped_lock lock(tablesMutex);
+		if (load > appliedLoad) {
+			appliedLoad = load;
+			tables = std::move(loaded);
+		}
+	}
+
+	void scheduleSync() {
+		const auto interval = g_configManager().getNumber(BAN_SYNC_INTERVAL);
+		if (interval <= 0) {
+			return;
+		}
+
+		g_scheduler().addEvent(static_cast<uint32_t>(interval) * 1000, [] {
+			IOBan::reload();
+			scheduleSync();
+		}, "IOBan::sync");
+	}
+}
 
-	DBResult_ptr result = db.storeQuery(query.str());
-	if (!result) {
+bool IOBan::isAccountBanned(uint32_t accountId, BanInfo &banInfo) {
+	std::scoped_lock lock(tablesMutex);
+	auto it = tables.accounts.find(accountId);
+	if (it == tables.accounts.end()) {
 		return false;
 	}
 
-	int64_t expiresAt = result->getNumber<int64_t>("expires_at");
-	if (expiresAt != 0 && time(nullptr) > expiresAt) {
+	const auto &entry = it->second;
+	if (entry.info.expiresAt != 0 && time(nullptr) > entry.info.expiresAt) {
 		// Move the ban to history if it has expired
-		query.str(std::string());
-		query << "INSERT INTO `account_ban_history` (`account_id`, `reason`, `banned_at`, `expired_at`, `banned_by`) VALUES (" << accountId << ',' << db.escapeString(result->getString("reason")) << ',' << result->getNumber<time_t>("banned_at") << ',' << expiresAt << ',' << result->getNumber<uint32_t>("banned_by") << ')';
-		g_databaseTasks().execute(query.str());
+		Database &db = Database::getInstance();
+		std::ostringstream query;
+		query << "INSERT INTO `account_ban_history` (`account_id`, `reason`, `banned_at`, `expired_at`, `banned_by`) VALUES (" << accountId << ',' << db.escapeString(entry.info.reason) << ',' << entry.bannedAt << ',' << entry.info.expiresAt << ',' << entry.bannedBy << ')';
+		g_databaseTasks().execute(query.str(), nullptr, accountId);
 
 		query.str(std::string());
 		query << "DELETE FROM `account_bans` WHERE `account_id` = " << accountId;
-		g_databaseTasks().execute(query.str());
+		g_databaseTasks().execute(query.str(), nullptr, accountId);
+		tables.accounts.erase(it);
 		return false;
 	}
 
-	banInfo.expiresAt = expiresAt;
-	banInfo.reason = result->getString("reason");
-	banInfo.bannedBy = result->getString("name");
+	banInfo = entry.info;
 	return true;
 }
 
@@ -82,32 +150,34 @@ bool IOBan::isIpBanned(uint32_t clientIP, BanInfo &banInfo) {
 		return false;
 	}
 
-	Database &db = Database::getInstance();
-
-	std::ostringstream query;
-	query << "SELECT `reason`, `expires_at`, (SELECT `name` FROM `players` WHERE `id` = `banned_by`) AS `name` FROM `ip_bans` WHERE `ip` = " << clientIP;
-
-	DBResult_ptr result = db.storeQuery(query.str());
-	if (!result) {
+	std::scoped_lock lock(tablesMutex);
+	auto it = tables.ips.find(clientIP);
+	if (it == tables.ips.end()) {
 		return false;
 	}
 
-	int64_t expiresAt = result->getNumber<int64_t>("expires_at");
-	if (expiresAt != 0 && time(nullptr) > expiresAt) {
-		query.str(std::string());
+	if (it->second.info.expiresAt != 0 && time(nullptr) > it->second.info.expiresAt) {
+		std::ostringstream query;
 		query << "DELETE FROM `ip_bans` WHERE `ip` = " << clientIP;
 		g_databaseTasks().execute(query.str());
+		tables.ips.erase(it);
 		return false;
 	}
 
-	banInfo.expiresAt = expiresAt;
-	banInfo.reason = result->getString("reason");
-	banInfo.bannedBy = result->getString("name");
+	banInfo = it->second.info;
 	return true;
 }
 
 bool IOBan::isPlayerNamelocked(uint32_t playerId) {
-	std::ostringstream query;
-	query << "SELECT 1 FROM `player_namelocks` WHERE `player_id` = " << playerId;
-	return Database::getInstance().storeQuery(query.str()).get() != nullptr;
+	std::scoped_lock lock(tablesMutex);
+	return tables.namelocks.contains(playerId);
+}
+
+void IOBan::startSync() {
+	loadTables();
+	scheduleSync();
+}
+
+void IOBan::reload() {
+	inject<ThreadPool>().addBlockingLoad([] { loadTables(); });
 }
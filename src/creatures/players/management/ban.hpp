@@ -35,9 +35,20 @@ private:
 	std::recursive_mutex lock;
 };
 
+/**
+ * The bans and namelocks are kept in memory, so the checks of a login do
+ * not query the database. They are loaded at startup, again every
+ * banSyncInterval seconds for the changes made from outside (the website),
+ * and right away through reload() when a script changes the tables.
+ */
 class IOBan {
 public:
 	static bool isAccountBanned(uint32_t accountId, BanInfo &banInfo);
 	static bool isIpBanned(uint32_t clientIP, BanInfo &banInfo);
 	static bool isPlayerNamelocked(uint32_t playerId);
+
+	// Loads the tables before the first login and starts the periodic sync
+	static void startSync();
+	// Loads the tables again on a blocking thread, the checks use the old ones meanwhile
+	static void reload();
 };
@@ -18,6 +18,101 @@ constexpr std::size_t SLOT_LIMIT_THREE = 20;
 constexpr std::size_t SLOT_LIMIT_FOUR = 50;
 constexpr std::size_t TIMEOUT_EXTRA = 15;
 
+void WaitQueue::push(uint32_t guid, int64_t timeout) {
+	if (nextSequence >= tree.size()) {
+		rebuild();
+	}
+
+	const auto sequence = nextSequence++;
+	entries.emplace(guid, Entry { sequence, timeout });
+	add(sequence, 1);
+	timeouts.emplace(Timeout { timeout, guid });
+}
+
+bool WaitQueue::erase(uint32_t guid) {
+	auto it = entries.find(guid);
+	if (it == entries.end()) {
+		return false;
+	}
+
+	add(it->second.sequence, -1);
+	entries.erase(it);
+	return true;
+}
+
+bool WaitQueue::contains(uint32_t guid) const {
+	return entries.contains(guid);
+}
+
+void WaitQueue::setTimeout(uint32_t guid, int64_t timeout) {
+	auto it = entries.find(guid);
+	if (it == entries.end() || it->second.timeout == timeout) {
+		return;
+	}
+
+	it->second.timeout = timeout;
+	timeouts.emplace(Timeout { timeout, guid });
+}
+
+std::size_t WaitQueue::getPosition(uint32_t guid) const {
+	auto it = entries.find(guid);
+	if (it == entries.end()) {
+		return 0;
+	}
+
+	int32_t position = 0;
+	for (auto i = it->second.sequence; i > 0; i -= i & (~i + 1)) {
+		position += tree[i];
+	}
+	return static_cast<std::size_t>(position);
+}
+
+void WaitQueue::expire(int64_t now) {
+	while (!timeouts.empty() && timeouts.top().timeout <= now) {
+		const auto [timeout, guid] = timeouts.top();
+		timeouts.pop();
+
+		// Refreshed since, a later heap entry has its timeout
+		auto it = entries.find(guid);
+		if (it != entries.end() && it->second.timeout == timeout) {
+			add(it->second.sequence, -1);
+			entries.erase(it);
+		}
+	}
+}
+
+void WaitQueue::add(uint32_t sequence, int32_t delta) {
+	for (auto i = sequence; i < tree.size(); i += i & (~i + 1)) {
+		tree[i] += delta;
+	}
+}
+
+void WaitQueue::rebuild() {
+	std::vector<std::pair<uint32_t, Entry*>> queued;
+	queued.reserve(entries.size());
+	for (auto &[guid, entry] : entries) {
+		queued.emplace_back(entry.sequence, &entry);
+	}
+	std::ranges::sort(queued, {}, &std::pair<uint32_t, Entry*>::first);
+
+	// Room for as many arrivals as there are queued before the next rebuild
+	tree.assign(std::max<std::size_t>(64, queued.size() * 2) + 1, 0);
+	uint32_t sequence = 0;
+	for (const auto &[oldSequence, entry] : queued) {
+		entry->sequence = ++sequence;
+		tree[sequence] = 1;
+	}
+	nextSequence = sequence + 1;
+
+	// Linear construction, every node passes its count on to its parent
+	for (uint32_t i = 1; i < tree.size(); ++i) {
+		const auto parent = i + (i & (~i + 1));
+		if (parent < tree.size()) {
+			tree[parent] += tree[i];
+		}
+	}
+}
+
 WaitingList::WaitingList() :
 	info(new WaitListInfo) { }
 
@@ -25,20 +120,10 @@ WaitingList &WaitingList::getInstance() {
 	return inject<WaitingList>();
 }
 
-void WaitingList::cleanupList(WaitList &list) {
-	int64_t time = OTSYS_TIME();
-
-	auto it = list.begin();
-	while (it != list.end()) {
-		auto timeout = static_cast<int64_t>(it->timeout);
-		g_logger().warn("time: {}", timeout - time);
-		if ((timeout - time) <= 0) {
-			info->playerReferences.erase(it->playerGUID);
-			it = list.erase(it);
-		} else {
-			++it;
-		}
-	}
+void WaitingList::cleanupLists() {
+	const int64_t time = OTSYS_TIME();
+	info->priorityWaitList.expire(time);
+	info->waitList.expire(time);
 }
 
 std::size_t WaitingList::getTimeout(std::size_t slot) {
@@ -69,59 +154,43 @@ bool WaitingList::clientLogin(std::shared_ptr<Player> player) {
 		return true;
 	}
 
-	cleanupList(info->priorityWaitList);
-	cleanupList(info->waitList);
+	cleanupLists();
 
-	addPlayerToList(player);
-
-	auto it = info->playerReferences.find(player->getGUID());
-	std::size_t slot = it->second.second;
+	const std::size_t slot = addPlayerToList(player);
 	if ((g_game().getPlayersOnline() + slot) <= maxPlayers) {
 		// should be able to login now
-		info->waitList.erase(it->second.first);
-		info->playerReferences.erase(it);
+		if (!info->priorityWaitList.erase(player->getGUID())) {
+			info->waitList.erase(player->getGUID());
+		}
 		return true;
 	}
 	return false;
 }
 
-void WaitingList::addPlayerToList(std::shared_ptr<Player> player) {
-	auto it = info->playerReferences.find(player->getGUID());
-	if (it != info->playerReferences.end()) {
-		std::size_t slot;
-		if (player->isPremium()) {
-			slot = std::distance(info->priorityWaitList.begin(), it->second.first) + 1;
-		} else {
-			slot = info->priorityWaitList.size() + std::distance(info->waitList.begin(), it->second.first) + 1;
-		}
-		it->second.second = slot;
-		it->second.first->timeout = OTSYS_TIME() + (getTimeout(slot) * 1000);
-	} else {
-		std::size_t slot = info->priorityWaitList.size();
-		if (player->isPremium()) {
-			info->priorityWaitList.emplace_back(OTSYS_TIME() + (getTimeout(slot + 1) * 1000), player->getGUID());
-			auto insertedIt = std::prev(info->priorityWaitList.end());
-			info->playerReferences[player->getGUID()] = { insertedIt, slot + 1 };
-		} else {
-			slot += info->waitList.size();
-			info->waitList.emplace_back(OTSYS_TIME() + (getTimeout(slot + 1) * 1000), player->getGUID());
-			auto insertedIt = std::prev(info->waitList.end());
-			info->playerReferences[player->getGUID()] = { insertedIt, slot + 1 };
-		}
+std::size_t WaitingList::addPlayerToList(std::shared_ptr<Player> player) {
+	const uint32_t guid = player->getGUID();
+	auto &list = player->isPremium() ? info->priorityWaitList : info->waitList;
+	// The premium time may have started or run out since the last attempt
+	(player->isPremium() ? info->waitList : info->priorityWaitList).erase(guid);
+
+	if (list.contains(guid)) {
+		const std::size_t slot = getClientSlot(player);
+		list.setTimeout(guid, OTSYS_TIME() + (getTimeout(slot) * 1000));
+		return slot;
 	}
+
+	// Last of its list, the normal one comes after every premium player
+	const std::size_t slot = info->priorityWaitList.size() + (&list == &info->waitList ? info->waitList.size() : 0) + 1;
+	list.push(guid, OTSYS_TIME() + (getTimeout(slot) * 1000));
+	return slot;
 }
 
 std::size_t WaitingList::getClientSlot(std::shared_ptr<Player> player) {
-	auto it = info->playerReferences.find(player->getGUID());
-	if (it == info->playerReferences.end()) {
-		return 0;
+	const uint32_t guid = player->getGUID();
+	if (const auto position = info->priorityWaitList.getPosition(guid); position != 0) {
+		return position;
 	}
 
-	std::size_t slot;
-	if (player->isPremium()) {
-		slot = std::distance(info->priorityWaitList.begin(), it->second.first) + 1;
-	} else {
-		slot = info->priorityWaitList.size() + std::distance(info->waitList.begin(), it->second.first) + 1;
-	}
-	return slot;
+	const auto position = info->waitList.getPosition(guid);
+	return position != 0 ? info->priorityWaitList.size() + position : 0;
 }
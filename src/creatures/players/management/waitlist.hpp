@@ -11,23 +11,62 @@
 
 class Player;
 
-struct WaitListInfo;
+/**
+ * Players in arrival order. Every one gets the next sequence number, a
+ * Fenwick tree counts the queued ones per sequence number, so the place of
+ * a player is a prefix sum. Leaving the queue clears the count, the tree
+ * is rebuilt over the ones left when the sequence numbers run out.
+ *
+ * Timeouts go to a min-heap, a refreshed one leaves its old heap entry
+ * behind to be skipped when it comes up.
+ */
+class WaitQueue {
+public:
+	void push(uint32_t guid, int64_t timeout);
+	bool erase(uint32_t guid);
+	bool contains(uint32_t guid) const;
+	void setTimeout(uint32_t guid, int64_t timeout);
+	// 1 for the first one, 0 when the guid is not queued
+	std::size_t getPosition(uint32_t guid) const;
+	// Drops the ones whose timeout passed
+	void expire(int64_t now);
 
-struct Wait {
-	constexpr Wait(std::size_t initTimeout, uint32_t initPlayerGUID) :
-		timeout(initTimeout), playerGUID(initPlayerGUID) { }
+	std::size_t size() const {
+		return entries.size();
+	}
 
-	std::size_t timeout;
-	uint32_t playerGUID;
-};
+	bool empty() const {
+		return entries.empty();
+	}
 
-using WaitList = std::list<Wait>;
+private:
+	struct Entry {
+		uint32_t sequence;
+		int64_t timeout;
+	};
 
-struct WaitListInfo {
-	WaitList priorityWaitList;
-	WaitList waitList;
+	struct Timeout {
+		int64_t timeout;
+		uint32_t guid;
 
-	phmap::flat_hash_map<uint32_t, std::pair<WaitList::iterator, std::size_t>> playerReferences;
+		bool operator>(const Timeout &other) const {
+			return timeout > other.timeout;
+		}
+	};
+
+	void add(uint32_t sequence, int32_t delta);
+	void rebuild();
+
+	phmap::flat_hash_map<uint32_t, Entry> entries;
+	// 1-based, tree[i] holds the count of the sequence numbers (i - lowbit(i), i]
+	std::vector<int32_t> tree = std::vector<int32_t>(1);
+	uint32_t nextSequence = 1;
+	std::priority_queue<Timeout, std::vector<Timeout>, std::greater<>> timeouts;
+};
+
+struct WaitListInfo {
+	WaitQueue priorityWaitList;
+	WaitQueue waitList;
 };
 
 class WaitingList {
@@ -39,8 +78,9 @@ public:
 	static std::size_t getTime(std::size_t slot);
 
 private:
-	void cleanupList(WaitList &list);
+	void cleanupLists();
 	std::size_t getTimeout(std::size_t slot);
-	void addPlayerToList(std::shared_ptr<Player> player);
+	// Returns the slot of the player, queuing it when it was not
+	std::size_t addPlayerToList(std::shared_ptr<Player> player);
 	std::unique_ptr<WaitListInfo> info;
 };
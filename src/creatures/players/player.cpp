@@ -20,6 +20,7 @@
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/scheduler.hpp"
 #include "game/scheduling/task.hpp"
+#include "lib/thread/job_group.hpp"
 #include "grouping/familiars.hpp"
 #include "lua/creature/creatureevent.hpp"
 #include "lua/creature/events.hpp"
@@ -28,6 +29,7 @@
 #include "lua/creature/movement.hpp"
 #include "io/iologindata.hpp"
 #include "items/bed.hpp"
+#include "items/item_pools.hpp"
 #include "items/weapons/weapons.hpp"
 #include "core.hpp"
 
@@ -37,7 +39,7 @@ Player::Player(ProtocolGame_ptr p) :
 	Creature(),
 	lastPing(OTSYS_TIME()),
 	lastPong(lastPing),
-	inbox(std::make_shared<Inbox>(ITEM_INBOX)),
+	inbox(makePooled<Inbox>(ITEM_INBOX)),
 	client(std::move(p)) {
 	m_wheelPlayer = std::make_unique<PlayerWheel>(*this);
 }
@@ -81,8 +83,8 @@ bool Player::isPushable() {
 	return Creature::isPushable();
 }
 
-std::shared_ptr<Task> Player::createPlayerTask(uint32_t delay, std::function<void(void)> f, std::string context) {
-	return std::make_shared<Task>(std::move(f), std::move(context), delay);
+std::shared_ptr<Task> Player::createPlayerTask(uint32_t delay, TaskFunction &&f, std::string_view context) {
+	return std::make_shared<Task>(std::move(f), context, delay);
 }
 
 uint32_t Player::playerFirstID = 0x10000000;
@@ -276,16 +278,29 @@ std::shared_ptr<Item> Player::getQuiverAmmoOfType(const ItemType &it) const {
 }
 
 std::shared_ptr<Item> Player::getWeapon(bool ignoreAmmo /* = false*/) const {
-	std::shared_ptr<Item> item = getWeapon(CONST_SLOT_LEFT, ignoreAmmo);
-	if (item) {
-		return item;
-	}
+	const auto &cache = getWeaponCache();
+	return ignoreAmmo ? cache.weaponIgnoringAmmo : cache.weapon;
+}
 
-	item = getWeapon(CONST_SLOT_RIGHT, ignoreAmmo);
-	if (item) {
-		return item;
+const Weapon* Player::getWeaponScript() const {
+	return getWeaponCache().script;
+}
+
+const Player::WeaponCache &Player::getWeaponCache() const {
+	if (weaponCache.valid && weaponCache.generation == g_weapons().getGeneration()) {
+		return weaponCache;
 	}
-	return nullptr;
+
+	const auto resolve = [this](bool ignoreAmmo) {
+		std::shared_ptr<Item> item = getWeapon(CONST_SLOT_LEFT, ignoreAmmo);
+		return item ? item : getWeapon(CONST_SLOT_RIGHT, ignoreAmmo);
+	};
+	weaponCache.weapon = resolve(false);
+	weaponCache.weaponIgnoringAmmo = resolve(true);
+	weaponCache.script = g_weapons().getWeapon(weaponCache.weapon);
+	weaponCache.generation = g_weapons().getGeneration();
+	weaponCache.valid = true;
+	return weaponCache;
 }
 
 WeaponType_t Player::getWeaponType() const {
@@ -399,8 +414,8 @@ int32_t Player::getDefense() const {
 	if (shield) {
 		defenseValue = weapon != nullptr ? shield->getDefense() + weapon->getExtraDefense() : shield->getDefense();
 		// Wheel of destiny - Combat Mastery
-		if (shield->getDefense() > 0) {
-			defenseValue += wheel()->getMajorStatConditional("Combat Mastery", WheelMajor_t::DEFENSE);
+		if (wheel()->getCombatBonus().combatMastery && shield->getDefense() > 0) {
+			defenseValue += wheel()->getMajorStat(WheelMajor_t::DEFENSE);
 		}
 		defenseSkill = getSkillLevel(SKILL_SHIELD);
 	}
@@ -548,19 +563,19 @@ void Player::updateInventoryWeight() {
 }
 
 void Player::updateInventoryImbuement() {
-	// Get the tile the player is currently on
-	std::shared_ptr<Tile> playerTile = getTile();
-	// Check if the player is in a protection zone
-	bool isInProtectionZone = playerTile && playerTile->hasFlag(TILESTATE_PROTECTIONZONE);
-	// Check if the player is in fight mode
-	bool isInFightMode = hasCondition(CONDITION_INFIGHT);
-	bool nonAggressiveFightOnly = g_configManager().getBoolean(TOGGLE_IMBUEMENT_NON_AGGRESSIVE_FIGHT_ONLY);
+	// The player state is only looked up once an imbued item is found, most players carry none
+	std::optional<bool> aggressiveDecays;
+	bool nonAggressiveFightOnly = false;
 
 	// Iterate through all items in the player's inventory
-	for (auto [key, item] : getAllSlotItems()) {
-		// Iterate through all imbuement slots on the item
+	for (int32_t slot = CONST_SLOT_FIRST; slot <= CONST_SLOT_LAST; ++slot) {
+		const auto &item = inventory[slot];
+		if (!item) {
+			continue;
+		}
 
-		for (uint8_t slotid = 0; slotid < item->getImbuementSlot(); slotid++) {
+		// Iterate through all imbuement slots on the item
+		for (uint8_t slotid = 0, imbuementSlots = item->getImbuementSlot(); slotid < imbuementSlots; slotid++) {
 			ImbuementInfo imbuementInfo;
 			// Get the imbuement information for the current slot
 			if (!item->getImbuementInfo(slotid, &imbuementInfo)) {
@@ -568,6 +583,16 @@ void Player::updateInventoryImbuement() {
 				continue;
 			}
 
+			if (!aggressiveDecays) {
+				// Check if the player is in a protection zone
+				std::shared_ptr<Tile> playerTile = getTile();
+				bool isInProtectionZone = playerTile && playerTile->hasFlag(TILESTATE_PROTECTIONZONE);
+				// Check if the player is in fight mode
+				bool isInFightMode = hasCondition(CONDITION_INFIGHT);
+				aggressiveDecays = !isInProtectionZone && isInFightMode;
+				nonAggressiveFightOnly = g_configManager().getBoolean(TOGGLE_IMBUEMENT_NON_AGGRESSIVE_FIGHT_ONLY);
+			}
+
 			// Imbuement from imbuementInfo, this variable reduces code complexity
 			auto imbuement = imbuementInfo.imbuement;
 			// Get the category of the imbuement
@@ -576,7 +601,7 @@ void Player::updateInventoryImbuement() {
 			auto parent = item->getParent();
 			bool isInBackpack = parent && parent->getContainer();
 			// If the imbuement is aggressive and the player is not in fight mode or is in a protection zone, or the item is in a container, ignore it.
-			if (categoryImbuement && (categoryImbuement->agressive || nonAggressiveFightOnly) && (isInProtectionZone || !isInFightMode || isInBackpack)) {
+			if (categoryImbuement && (categoryImbuement->agressive || nonAggressiveFightOnly) && (!*aggressiveDecays || isInBackpack)) {
 				continue;
 			}
 			// If the item is not in the backpack slot and it's not a agressive imbuement, ignore it.
@@ -584,23 +609,15 @@ void Player::updateInventoryImbuement() {
 				continue;
 			}
 
-			// If the imbuement's duration is 0, remove its stats and continue to the next slot
-			if (imbuementInfo.duration == 0) {
-				removeItemImbuementStats(imbuement);
-				updateImbuementTrackerStats();
-				continue;
-			}
-
 			g_logger().debug("Decaying imbuement {} from item {} of player {}", imbuement->getName(), item->getName(), getName());
 			// Calculate the new duration of the imbuement, making sure it doesn't go below 0
-			uint32_t duration = std::max<uint32_t>(0, imbuementInfo.duration - EVENT_IMBUEMENT_INTERVAL / 1000);
+			uint32_t duration = imbuementInfo.duration - std::min<uint32_t>(imbuementInfo.duration, EVENT_IMBUEMENT_INTERVAL / 1000);
 			// Update the imbuement's duration in the item
 			item->decayImbuementTime(slotid, imbuement->getID(), duration);
 
 			if (duration == 0) {
 				removeItemImbuementStats(imbuement);
 				updateImbuementTrackerStats();
-				continue;
 			}
 		}
 	}
@@ -621,11 +638,9 @@ phmap::flat_hash_map<uint8_t, std::shared_ptr<Item>> Player::getAllSlotItems() c
 }
 
 void Player::setTraining(bool value) {
-	for (const auto &[key, player] : g_game().getPlayers()) {
-		if (!this->isInGhostMode() || player->isAccessPlayer()) {
-			player->notifyStatusChange(static_self_cast<Player>(), value ? VIPSTATUS_TRAINING : VIPSTATUS_ONLINE, false);
-		}
-	}
+	g_game().notifyVipStatusChange(static_self_cast<Player>(), value ? VIPSTATUS_TRAINING : VIPSTATUS_ONLINE, false, [this](const std::shared_ptr<Player> &player) {
+		return !isInGhostMode() || player->isAccessPlayer();
+	});
 	this->statusVipList = VIPSTATUS_TRAINING;
 	setExerciseTraining(value);
 }
@@ -860,6 +875,10 @@ void Player::addStorageValue(const uint32_t key, const int32_t value, const bool
 		}
 	}
 
+	if (!isLogin) {
+		storageDirtyKeys.emplace(key);
+	}
+
 	if (value != -1) {
 		storageMap[key] = value;
 
@@ -874,34 +893,28 @@ void Player::addStorageValue(const uint32_t key, const int32_t value, const bool
 }
 
 int32_t Player::getStorageValue(const uint32_t key) const {
-	int32_t value = -1;
 	auto it = storageMap.find(key);
 	if (it == storageMap.end()) {
-		return value;
+		return -1;
 	}
-
-	value = it->second;
-	return value;
+	return it->second;
 }
 
 int32_t Player::getStorageValueByName(const std::string &storageName) const {
-	auto it = g_storages().getStorageMap().find(storageName);
-	if (it == g_storages().getStorageMap().end()) {
+	const auto key = g_storages().getStorageKey(storageName);
+	if (!key) {
 		return -1;
 	}
-	uint32_t key = it->second;
-
-	return getStorageValue(key);
+	return getStorageValue(*key);
 }
 
 void Player::addStorageValueByName(const std::string &storageName, const int32_t value, const bool isLogin /* = false*/) {
-	auto it = g_storages().getStorageMap().find(storageName);
-	if (it == g_storages().getStorageMap().end()) {
+	const auto key = g_storages().getStorageKey(storageName);
+	if (!key) {
 		g_logger().error("[{}] Storage name '{}' not found in storage map, register your storage in 'storages.xml' first for use", __func__, storageName);
 		return;
 	}
-	uint32_t key = it->second;
-	addStorageValue(key, value, isLogin);
+	addStorageValue(*key, value, isLogin);
 }
 
 bool Player::canSee(const Position &pos) {
@@ -1067,23 +1080,16 @@ void Player::checkLootContainers(std::shared_ptr<Item> item) {
 
 	bool shouldSend = false;
 
-	auto it = quickLootContainers.begin();
-	while (it != quickLootContainers.end()) {
-		std::shared_ptr<Container> lootContainer = (*it).second;
-
-		bool remove = false;
-		if (item->getHoldingPlayer() != getPlayer() && (item == lootContainer || container->isHoldingItem(lootContainer))) {
-			remove = true;
+	phmap::erase_if(quickLootContainers, [&](const auto &entry) {
+		const std::shared_ptr<Container> &lootContainer = entry.second;
+		if (item->getHoldingPlayer() == getPlayer() || (item != lootContainer && !container->isHoldingItem(lootContainer))) {
+			return false;
 		}
 
-		if (remove) {
-			shouldSend = true;
-			it = quickLootContainers.erase(it);
-			lootContainer->removeAttribute(ItemAttribute_t::QUICKLOOTCONTAINER);
-		} else {
-			++it;
-		}
-	}
+		shouldSend = true;
+		lootContainer->removeAttribute(ItemAttribute_t::QUICKLOOTCONTAINER);
+		return true;
+	});
 
 	if (shouldSend) {
 		sendLootContainers();
@@ -1129,13 +1135,13 @@ std::shared_ptr<DepotChest> Player::getDepotChest(uint32_t depotId, bool autoCre
 
 	std::shared_ptr<DepotChest> depotChest;
 	if (depotId > 0 && depotId < 18) {
-		depotChest = std::make_shared<DepotChest>(ITEM_DEPOT_NULL + depotId);
+		depotChest = makePooled<DepotChest>(ITEM_DEPOT_NULL + depotId);
 	} else if (depotId == 18) {
-		depotChest = std::make_shared<DepotChest>(ITEM_DEPOT_XVIII);
+		depotChest = makePooled<DepotChest>(ITEM_DEPOT_XVIII);
 	} else if (depotId == 19) {
-		depotChest = std::make_shared<DepotChest>(ITEM_DEPOT_XIX);
+		depotChest = makePooled<DepotChest>(ITEM_DEPOT_XIX);
 	} else {
-		depotChest = std::make_shared<DepotChest>(ITEM_DEPOT_XX);
+		depotChest = makePooled<DepotChest>(ITEM_DEPOT_XX);
 	}
 
 	depotChests[depotId] = depotChest;
@@ -1157,7 +1163,7 @@ std::shared_ptr<DepotLocker> Player::getDepotLocker(uint32_t depotId) {
 	// We need to make room for supply stash on 12+ protocol versions and remove it for 10x.
 	bool createSupplyStash = !client->oldProtocol;
 
-	std::shared_ptr<DepotLocker> depotLocker = std::make_shared<DepotLocker>(ITEM_LOCKER, createSupplyStash ? 4 : 3);
+	std::shared_ptr<DepotLocker> depotLocker = makePooled<DepotLocker>(ITEM_LOCKER, createSupplyStash ? 4 : 3);
 	depotLocker->setDepotId(depotId);
 	depotLocker->internalAddThing(Item::CreateItem(ITEM_MARKET));
 	depotLocker->internalAddThing(inbox);
@@ -1175,12 +1181,27 @@ std::shared_ptr<DepotLocker> Player::getDepotLocker(uint32_t depotId) {
 	return depotLocker;
 }
 
+const DepotIndex &Player::getDepotIndex() {
+	std::vector<std::shared_ptr<Container>> boxes;
+	const auto depotBoxes = static_cast<uint32_t>(g_configManager().getNumber(DEPOT_BOXES));
+	boxes.reserve(depotBoxes);
+	for (uint32_t i = 1; i <= depotBoxes; ++i) {
+		if (std::shared_ptr<DepotChest> depotBox = getDepotChest(i, false)) {
+			boxes.push_back(depotBox);
+		}
+	}
+
+	DepotIndex &depotIndex = getColdData().depotIndex;
+	depotIndex.update(boxes, inbox);
+	return depotIndex;
+}
+
 std::shared_ptr<RewardChest> Player::getRewardChest() {
 	if (rewardChest != nullptr) {
 		return rewardChest;
 	}
 
-	rewardChest = std::make_shared<RewardChest>(ITEM_REWARD_CHEST);
+	rewardChest = makePooled<RewardChest>(ITEM_REWARD_CHEST);
 	return rewardChest;
 }
 
@@ -1193,8 +1214,28 @@ std::shared_ptr<Reward> Player::getReward(const uint64_t rewardId, const bool au
 		return nullptr;
 	}
 
-	auto reward = std::make_shared<Reward>();
+	auto reward = makePooled<Reward>();
+	reward->setAttribute(ItemAttribute_t::DATE, rewardId);
+	rewardMap[rewardId] = reward;
+	g_game().internalAddItem(getRewardChest(), reward, INDEX_WHEREEVER, FLAG_NOLIMIT);
+
+	return reward;
+}
+
+std::shared_ptr<Reward> Player::addRewardItems(uint64_t rewardId, const std::vector<std::shared_ptr<Item>> &items) {
+	if (auto reward = getReward(rewardId, false)) {
+		for (const auto &item : items) {
+			g_game().internalAddItem(reward, item, INDEX_WHEREEVER, FLAG_NOLIMIT);
+		}
+		return reward;
+	}
+
+	auto reward = makePooled<Reward>();
 	reward->setAttribute(ItemAttribute_t::DATE, rewardId);
+	// Without a parent yet, nobody is told about these
+	for (const auto &item : items) {
+		reward->addItemBack(item);
+	}
 	rewardMap[rewardId] = reward;
 	g_game().internalAddItem(getRewardChest(), reward, INDEX_WHEREEVER, FLAG_NOLIMIT);
 
@@ -1232,11 +1273,82 @@ void Player::sendCancelMessage(ReturnValue message) const {
 	sendCancelMessage(getReturnMessage(message));
 }
 
-void Player::sendStats() {
-	if (client) {
+void Player::queueClientUpdate(uint8_t update) const {
+	if (!client) {
+		return;
+	}
+
+	static bool handlerAdded = false;
+	if (!handlerAdded) {
+		handlerAdded = true;
+		g_dispatcher().prependCycleEndHandler(&Player::sendAllPendingClientUpdates);
+	}
+
+	pendingClientUpdates |= update;
+	if (!hasPendingClientUpdates) {
+		hasPendingClientUpdates = true;
+		playersWithPendingClientUpdates.emplace_back(const_cast<Player*>(this)->getPlayer());
+	}
+}
+
+void Player::sendAllPendingClientUpdates() {
+	if (playersWithPendingClientUpdates.empty()) {
+		return;
+	}
+
+	const auto players = std::move(playersWithPendingClientUpdates);
+	playersWithPendingClientUpdates.clear();
+	if (players.size() < PARALLEL_CLIENT_UPDATES_MIN_PLAYERS) {
+		for (const auto &player : players) {
+			player->sendPendingClientUpdates();
+		}
+		return;
+	}
+
+	// The packets only read the state of their player, they are built on the pool while the game thread waits
+	for (const auto &player : players) {
+		if (player->client) {
+			player->client->beginStagedWrites();
+		}
+	}
+	parallelFor(inject<ThreadPool>(), 0, players.size(), [&players](size_t index) {
+		players[index]->sendPendingClientUpdates();
+	});
+	for (const auto &player : players) {
+		if (player->client) {
+			player->client->endStagedWrites();
+		}
+	}
+}
+
+void Player::sendPendingClientUpdates() {
+	const uint8_t updates = std::exchange(pendingClientUpdates, 0);
+	uint32_t slots = std::exchange(pendingInventorySlots, 0);
+	hasPendingClientUpdates = false;
+	if (!client) {
+		return;
+	}
+
+	if (updates & PENDING_STATS) {
 		client->sendStats();
 		lastStatsTrainingTime = getOfflineTrainingTime() / 60 / 1000;
 	}
+	if (updates & PENDING_BASIC_DATA) {
+		client->sendBasicData();
+	}
+	if (updates & PENDING_SKILLS) {
+		client->sendSkills();
+	}
+	if (updates & PENDING_ICONS) {
+		client->sendIcons(getClientIcons());
+	}
+	for (; slots != 0; slots &= slots - 1) {
+		const auto slot = static_cast<Slots_t>(std::countr_zero(slots));
+		client->sendInventoryItem(slot, getInventoryItem(slot));
+	}
+	if (updates & PENDING_INVENTORY_IDS) {
+		client->sendInventoryIds();
+	}
 }
 
 void Player::updateSupplyTracker(std::shared_ptr<Item> item) {
@@ -1601,6 +1713,7 @@ void Player::onCreatureAppear(std::shared_ptr<Creature> creature, bool isLogin)
 
 		updateRegeneration();
 
+		g_game().map.houses.loadPendingItems(static_self_cast<Player>());
 		std::shared_ptr<BedItem> bed = g_game().getBedBySleeper(guid);
 		if (bed) {
 			bed->wakeUp(static_self_cast<Player>());
@@ -1848,7 +1961,6 @@ void Player::onCreatureMove(std::shared_ptr<Creature> creature, std::shared_ptr<
 	}
 
 	if (party) {
-		party->updateSharedExperience();
 		party->updatePlayerStatus(static_self_cast<Player>(), oldPos, newPos);
 	}
 
@@ -2249,7 +2361,7 @@ void Player::addExperience(std::shared_ptr<Creature> target, uint64_t exp, bool
 		if (!spectators.empty()) {
 			message.type = MESSAGE_EXPERIENCE_OTHERS;
 			message.text = getName() + " gained " + expString;
-			for (std::shared_ptr<Creature> spectator : spectators) {
+			for (const auto &spectator : spectators) {
 				spectator->getPlayer()->sendTextMessage(message);
 			}
 		}
@@ -2285,6 +2397,7 @@ void Player::addExperience(std::shared_ptr<Creature> target, uint64_t exp, bool
 	if (prevLevel != level) {
 		health = healthMax;
 		mana = manaMax;
+		resetWeaponCache();
 
 		updateBaseSpeed();
 		setBaseSpeed(getBaseSpeed());
@@ -2343,7 +2456,7 @@ void Player::removeExperience(uint64_t exp, bool sendText /* = false*/) {
 		if (!spectators.empty()) {
 			message.type = MESSAGE_EXPERIENCE_OTHERS;
 			message.text = getName() + " lost " + expString;
-			for (std::shared_ptr<Creature> spectator : spectators) {
+			for (const auto &spectator : spectators) {
 				spectator->getPlayer()->sendTextMessage(message);
 			}
 		}
@@ -2371,6 +2484,7 @@ void Player::removeExperience(uint64_t exp, bool sendText /* = false*/) {
 	if (oldLevel != level) {
 		health = healthMax;
 		mana = manaMax;
+		resetWeaponCache();
 
 		updateBaseSpeed();
 		setBaseSpeed(getBaseSpeed());
@@ -2586,11 +2700,8 @@ void Player::death(std::shared_ptr<Creature> lastHitCreature) {
 
 		// Charm bless bestiary
 		if (lastHitCreature && lastHitCreature->getMonster()) {
-			if (charmRuneBless != 0) {
-				const auto mType = g_monsters().getMonsterType(lastHitCreature->getName());
-				if (mType && mType->info.raceid == charmRuneBless) {
-					deathLossPercent = (deathLossPercent * 90) / 100;
-				}
+			if (getCharmByRaceId(lastHitCreature->getMonster()->getRaceId()) == CHARM_BLESS) {
+				deathLossPercent = (deathLossPercent * 90) / 100;
 			}
 		}
 
@@ -2665,6 +2776,7 @@ void Player::death(std::shared_ptr<Creature> lastHitCreature) {
 			}
 
 			if (oldLevel != level) {
+				resetWeaponCache();
 				std::ostringstream ss;
 				ss << "You were downgraded from Level " << oldLevel << " to Level " << level << '.';
 				sendTextMessage(MESSAGE_EVENT_ADVANCE, ss.str());
@@ -2719,32 +2831,32 @@ void Player::death(std::shared_ptr<Creature> lastHitCreature) {
 			mana = manaMax;
 		}
 
-		auto it = conditions.begin(), end = conditions.end();
-		while (it != end) {
-			std::shared_ptr<Condition> condition = *it;
+		size_t index = 0;
+		while (index < conditions.size()) {
+			std::shared_ptr<Condition> condition = conditions[index];
 			// isSupress block to delete spells conditions (ensures that the player cannot, for example, reset the cooldown time of the familiar and summon several)
 			if (condition->isPersistent() && condition->isRemovableOnDeath()) {
-				it = conditions.erase(it);
+				eraseCondition(index);
 
 				condition->endCondition(static_self_cast<Player>());
 				onEndCondition(condition->getType());
 			} else {
-				++it;
+				++index;
 			}
 		}
 	} else {
 		setSkillLoss(true);
 
-		auto it = conditions.begin(), end = conditions.end();
-		while (it != end) {
-			std::shared_ptr<Condition> condition = *it;
+		size_t index = 0;
+		while (index < conditions.size()) {
+			std::shared_ptr<Condition> condition = conditions[index];
 			if (condition->isPersistent()) {
-				it = conditions.erase(it);
+				eraseCondition(index);
 
 				condition->endCondition(static_self_cast<Player>());
 				onEndCondition(condition->getType());
 			} else {
-				++it;
+				++index;
 			}
 		}
 
@@ -2771,7 +2883,7 @@ bool Player::spawn() {
 
 	SpectatorHashSet spectators;
 	g_game().map.getSpectators(spectators, position, true);
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (!spectator) {
 			continue;
 		}
@@ -2815,7 +2927,7 @@ void Player::despawn() {
 	SpectatorHashSet spectators;
 	g_game().map.getSpectators(spectators, tile->getPosition(), true);
 	size_t i = 0;
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (!spectator) {
 			continue;
 		}
@@ -2837,9 +2949,7 @@ void Player::despawn() {
 	g_game().removePlayer(static_self_cast<Player>());
 
 	// show player as pending
-	for (const auto &[key, player] : g_game().getPlayers()) {
-		player->notifyStatusChange(static_self_cast<Player>(), VIPSTATUS_PENDING, false);
-	}
+	g_game().notifyVipStatusChange(static_self_cast<Player>(), VIPSTATUS_PENDING, false);
 
 	setDead(true);
 }
@@ -2884,22 +2994,21 @@ void Player::addInFightTicks(bool pzlock /*= false*/) {
 
 	updateImbuementTrackerStats();
 
-	std::shared_ptr<Condition> condition = Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_INFIGHT, g_configManager().getNumber(PZ_LOCKED), 0);
-	addCondition(condition);
+	// Every hit lands here, the running in fight condition is extended instead of merging a new one into it
+	const auto ticks = g_configManager().getNumber(PZ_LOCKED);
+	if (!refreshCondition(CONDITION_INFIGHT, CONDITIONID_DEFAULT, ticks)) {
+		addCondition(Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_INFIGHT, ticks, 0));
+	}
 }
 
 void Player::removeList() {
 	g_game().removePlayer(static_self_cast<Player>());
 
-	for (const auto &[key, player] : g_game().getPlayers()) {
-		player->notifyStatusChange(static_self_cast<Player>(), VIPSTATUS_OFFLINE);
-	}
+	g_game().notifyVipStatusChange(static_self_cast<Player>(), VIPSTATUS_OFFLINE);
 }
 
 void Player::addList() {
-	for (const auto &[key, player] : g_game().getPlayers()) {
-		player->notifyStatusChange(static_self_cast<Player>(), this->statusVipList);
-	}
+	g_game().notifyVipStatusChange(static_self_cast<Player>(), this->statusVipList);
 
 	g_game().addPlayer(static_self_cast<Player>());
 }
@@ -2914,22 +3023,26 @@ void Player::removePlayer(bool displayEffect, bool forced /*= true*/) {
 }
 
 void Player::notifyStatusChange(std::shared_ptr<Player> loginPlayer, VipStatus_t status, bool message) {
+	notifyStatusChange(loginPlayer->guid, loginPlayer->getName(), status, message);
+}
+
+void Player::notifyStatusChange(uint32_t guid, const std::string &name, VipStatus_t status, bool message /* = true*/) {
 	if (!client) {
 		return;
 	}
 
-	auto it = VIPList.find(loginPlayer->guid);
+	auto it = VIPList.find(guid);
 	if (it == VIPList.end()) {
 		return;
 	}
 
-	client->sendUpdatedVIPStatus(loginPlayer->guid, status);
+	client->sendUpdatedVIPStatus(guid, status);
 
 	if (message) {
 		if (status == VIPSTATUS_ONLINE) {
-			client->sendTextMessage(TextMessage(MESSAGE_FAILURE, loginPlayer->getName() + " has logged in."));
+			client->sendTextMessage(TextMessage(MESSAGE_FAILURE, name + " has logged in."));
 		} else if (status == VIPSTATUS_OFFLINE) {
-			client->sendTextMessage(TextMessage(MESSAGE_FAILURE, loginPlayer->getName() + " has logged out."));
+			client->sendTextMessage(TextMessage(MESSAGE_FAILURE, name + " has logged out."));
 		}
 	}
 }
@@ -2939,6 +3052,8 @@ bool Player::removeVIP(uint32_t vipGuid) {
 		return false;
 	}
 
+	g_game().removeVipWatcher(vipGuid, getID());
+
 	if (account) {
 		IOLoginData::removeVIPEntry(account->getID(), vipGuid);
 	}
@@ -2958,6 +3073,8 @@ bool Player::addVIP(uint32_t vipGuid, const std::string &vipName, VipStatus_t st
 		return false;
 	}
 
+	g_game().addVipWatcher(vipGuid, getID());
+
 	if (account) {
 		IOLoginData::addVIPEntry(account->getID(), vipGuid, "", 0, false);
 	}
@@ -2974,7 +3091,12 @@ bool Player::addVIPInternal(uint32_t vipGuid) {
 		return false;
 	}
 
-	return VIPList.insert(vipGuid).second;
+	if (!VIPList.insert(vipGuid).second) {
+		return false;
+	}
+
+	g_game().addVipWatcher(vipGuid, getID());
+	return true;
 }
 
 bool Player::editVIP(uint32_t vipGuid, const std::string &description, uint32_t icon, bool notify) {
@@ -3029,7 +3151,7 @@ bool Player::hasCapacity(std::shared_ptr<Item> item, uint32_t count) const {
 	return itemWeight <= getFreeCapacity();
 }
 
-ReturnValue Player::queryAdd(int32_t index, const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, std::shared_ptr<Creature>) {
+ReturnValue Player::queryAdd(int32_t index, const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, const std::shared_ptr<Creature> &) {
 	std::shared_ptr<Item> item = thing->getItem();
 	if (item == nullptr) {
 		g_logger().error("[Player::queryAdd] - Item is nullptr");
@@ -3310,7 +3432,7 @@ ReturnValue Player::queryMaxCount(int32_t index, const std::shared_ptr<Thing> &t
 	}
 }
 
-ReturnValue Player::queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, std::shared_ptr<Creature> /*= nullptr*/) {
+ReturnValue Player::queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, const std::shared_ptr<Creature> & /*= nullptr*/) {
 	int32_t index = getThingIndex(thing);
 	if (index == -1) {
 		return RETURNVALUE_NOTPOSSIBLE;
@@ -3478,6 +3600,7 @@ void Player::addThing(int32_t index, std::shared_ptr<Thing> thing) {
 
 	item->setParent(static_self_cast<Player>());
 	inventory[index] = item;
+	resetWeaponCache();
 
 	// send to client
 	sendInventoryItem(static_cast<Slots_t>(index), item);
@@ -3496,6 +3619,7 @@ void Player::updateThing(std::shared_ptr<Thing> thing, uint16_t itemId, uint32_t
 
 	item->setID(itemId);
 	item->setSubType(count);
+	resetWeaponCache();
 
 	// send to client
 	sendInventoryItem(static_cast<Slots_t>(index), item);
@@ -3528,6 +3652,7 @@ void Player::replaceThing(uint32_t index, std::shared_ptr<Thing> thing) {
 	item->setParent(static_self_cast<Player>());
 
 	inventory[index] = item;
+	resetWeaponCache();
 }
 
 void Player::removeThing(std::shared_ptr<Thing> thing, uint32_t count) {
@@ -3551,6 +3676,7 @@ void Player::removeThing(std::shared_ptr<Thing> thing, uint32_t count) {
 
 			item->resetParent();
 			inventory[index] = nullptr;
+			resetWeaponCache();
 		} else {
 			uint8_t newCount = static_cast<uint8_t>(std::max<int32_t>(0, item->getItemCount() - count));
 			item->setItemCount(newCount);
@@ -3570,6 +3696,7 @@ void Player::removeThing(std::shared_ptr<Thing> thing, uint32_t count) {
 
 		item->resetParent();
 		inventory[index] = nullptr;
+		resetWeaponCache();
 	}
 }
 
@@ -3602,7 +3729,10 @@ uint32_t Player::getItemTypeCount(uint16_t itemId, int32_t subType /*= -1*/) con
 			count += Item::countByType(item, subType);
 		}
 
-		if (std::shared_ptr<Container> container = item->getContainer()) {
+		std::shared_ptr<Container> container = item->getContainer();
+		if (container && subType == -1) {
+			count += container->getHoldingItemTypeCount(itemId);
+		} else if (container) {
 			for (ContainerIterator it = container->iterator(); it.hasNext(); it.advance()) {
 				if ((*it)->getID() == itemId) {
 					count += Item::countByType(*it, subType);
@@ -3613,21 +3743,48 @@ uint32_t Player::getItemTypeCount(uint16_t itemId, int32_t subType /*= -1*/) con
 	return count;
 }
 
+uint32_t Player::getStashSlots(uint16_t itemId, uint32_t amount) {
+	const uint32_t stackSize = std::max<uint32_t>(1, Item::items[itemId].stackSize);
+	return (amount + stackSize - 1) / stackSize;
+}
+
+void Player::addItemOnStash(uint16_t itemId, uint32_t amount) {
+	uint32_t &count = stashItems[itemId];
+	stashSize -= getStashSlots(itemId, count);
+	count += amount;
+	stashSize += getStashSlots(itemId, count);
+}
+
+bool Player::withdrawItem(uint16_t itemId, uint32_t amount) {
+	auto it = stashItems.find(itemId);
+	if (it == stashItems.end() || it->second < amount) {
+		return false;
+	}
+
+	stashSize -= getStashSlots(itemId, it->second);
+	if (it->second == amount) {
+		stashItems.erase(it);
+	} else {
+		it->second -= amount;
+		stashSize += getStashSlots(itemId, it->second);
+	}
+	return true;
+}
+
 void Player::stashContainer(StashContainerList itemDict) {
-	StashItemList stashItemDict; // ItemID - Count
-	for (auto it_dict : itemDict) {
-		stashItemDict[(it_dict.first)->getID()] = it_dict.second;
+	// Slots the stash ends up with, from the stacks each item id grows to
+	phmap::flat_hash_map<uint16_t, uint32_t> stowedCounts;
+	for (const auto &[item, count] : itemDict) {
+		stowedCounts[item->getID()] += count;
 	}
 
-	for (auto it : stashItems) {
-		if (!stashItemDict[it.first]) {
-			stashItemDict[it.first] = it.second;
-		} else {
-			stashItemDict[it.first] += it.second;
-		}
+	uint32_t newStashSize = stashSize;
+	for (const auto &[itemId, count] : stowedCounts) {
+		const uint32_t stashCount = getStashItemCount(itemId);
+		newStashSize += getStashSlots(itemId, stashCount + count) - getStashSlots(itemId, stashCount);
 	}
 
-	if (getStashSize(stashItemDict) > g_configManager().getNumber(STASH_ITEMS)) {
+	if (newStashSize > g_configManager().getNumber(STASH_ITEMS)) {
 		sendCancelMessage("You don't have capacity in the Supply Stash to stow all this item->");
 		return;
 	}
@@ -3635,13 +3792,17 @@ void Player::stashContainer(StashContainerList itemDict) {
 	uint32_t totalStowed = 0;
 	std::ostringstream retString;
 	uint16_t refreshDepotSearchOnItem = 0;
-	for (auto stashIterator : itemDict) {
-		uint16_t iteratorCID = (stashIterator.first)->getID();
-		if (g_game().internalRemoveItem(stashIterator.first, stashIterator.second) == RETURNVALUE_NOERROR) {
-			addItemOnStash(iteratorCID, stashIterator.second);
-			totalStowed += stashIterator.second;
-			if (isDepotSearchOpenOnItem(iteratorCID)) {
-				refreshDepotSearchOnItem = iteratorCID;
+	{
+		// Weight, light and stats go to the client once, after the last item
+		PlayerInventoryBatch inventoryBatch(static_self_cast<Player>());
+		for (const auto &[item, count] : itemDict) {
+			const uint16_t itemId = item->getID();
+			if (g_game().internalRemoveItem(item, count) == RETURNVALUE_NOERROR) {
+				addItemOnStash(itemId, count);
+				totalStowed += count;
+				if (isDepotSearchOpenOnItem(itemId)) {
+					refreshDepotSearchOnItem = itemId;
+				}
 			}
 		}
 	}
@@ -3730,15 +3891,8 @@ bool Player::hasItemCountById(uint16_t itemId, uint32_t itemAmount, bool checkSt
 	}
 
 	// Check items from stash
-	for (StashItemList stashToSend = getStashItems();
-		 auto [stashItemId, itemCount] : stashToSend) {
-		if (!checkStash) {
-			break;
-		}
-
-		if (stashItemId == itemId) {
-			newCount += itemCount;
-		}
+	if (checkStash) {
+		newCount += getStashItemCount(itemId);
 	}
 
 	return newCount >= itemAmount;
@@ -3937,19 +4091,77 @@ std::vector<std::shared_ptr<Item>> Player::getEquippedItems() const {
 }
 
 std::map<uint32_t, uint32_t> &Player::getAllItemTypeCount(std::map<uint32_t, uint32_t> &countMap) const {
-	for (const auto item : getAllInventoryItems()) {
+	for (int32_t i = CONST_SLOT_FIRST; i <= CONST_SLOT_LAST; ++i) {
+		std::shared_ptr<Item> item = inventory[i];
+		if (!item) {
+			continue;
+		}
+
 		countMap[static_cast<uint32_t>(item->getID())] += Item::countByType(item, -1);
+		if (std::shared_ptr<Container> container = item->getContainer()) {
+			for (const auto &[itemId, count] : container->getHoldingItemTypeCounts()) {
+				countMap[static_cast<uint32_t>(itemId)] += count;
+			}
+		}
 	}
 	return countMap;
 }
 
 std::map<uint16_t, uint16_t> &Player::getAllSaleItemIdAndCount(std::map<uint16_t, uint16_t> &countMap) const {
-	for (const auto item : getAllInventoryItems(false, true)) {
-		if (!item->hasImbuements()) {
-			countMap[item->getID()] += item->getItemCount();
+	if (!shopOwner) {
+		for (const auto item : getAllInventoryItems(false, true)) {
+			if (!item->hasImbuements()) {
+				countMap[item->getID()] += item->getItemCount();
+			}
 		}
+		return countMap;
 	}
 
+	// The sale list only reads the items the shop buys and the money, their counts come from the container aggregates
+	phmap::flat_hash_set<uint16_t> walkedIds;
+	const auto addCount = [&](uint16_t itemId) {
+		const ItemType &itemType = Item::items[itemId];
+		// Imbued and tiered items are not sold, the aggregates do not tell them apart
+		if (itemType.imbuementSlot > 0 || itemType.upgradeClassification > 0) {
+			walkedIds.emplace(itemId);
+			return;
+		}
+
+		uint32_t count = 0;
+		for (int32_t slot = CONST_SLOT_FIRST; slot <= CONST_SLOT_LAST; ++slot) {
+			const auto &item = inventory[slot];
+			if (!item) {
+				continue;
+			}
+
+			if (item->getID() == itemId) {
+				count += item->getItemCount();
+			}
+			if (const auto container = item->getContainer()) {
+				count += container->getHoldingItemTypeCount(itemId);
+			}
+		}
+		if (count != 0) {
+			countMap[itemId] = static_cast<uint16_t>(std::min<uint32_t>(count, std::numeric_limits<uint16_t>::max()));
+		}
+	};
+
+	for (const auto &[itemId, sellPrice] : shopOwner->getShopSellPrices()) {
+		addCount(itemId);
+	}
+	for (const uint16_t itemId : std::initializer_list<uint16_t> { ITEM_CRYSTAL_COIN, ITEM_PLATINUM_COIN, ITEM_GOLD_COIN, shopOwner->getCurrency() }) {
+		if (!countMap.contains(itemId) && !walkedIds.contains(itemId)) {
+			addCount(itemId);
+		}
+	}
+
+	if (!walkedIds.empty()) {
+		for (const auto item : getAllInventoryItems(false, true)) {
+			if (walkedIds.contains(item->getID()) && !item->hasImbuements()) {
+				countMap[item->getID()] += item->getItemCount();
+			}
+		}
+	}
 	return countMap;
 }
 
@@ -3986,6 +4198,9 @@ std::shared_ptr<Thing> Player::getThing(size_t index) const {
 }
 
 void Player::postAddNotification(std::shared_ptr<Thing> thing, std::shared_ptr<Cylinder> oldParent, int32_t index, CylinderLink_t link /*= LINK_OWNER*/) {
+	// Also reached for the contents of the containers carried, such as the ammo of the quiver
+	resetWeaponCache();
+
 	if (link == LINK_OWNER) {
 		// calling movement scripts
 		g_moveEvents().onPlayerEquip(getPlayer(), thing->getItem(), static_cast<Slots_t>(index), false);
@@ -4007,9 +4222,13 @@ void Player::postAddNotification(std::shared_ptr<Thing> thing, std::shared_ptr<C
 		}
 
 		updateInventoryWeight();
-		updateItemsLight();
-		sendInventoryIds();
-		sendStats();
+		if (inventoryBatchDepth > 0) {
+			inventoryBatchChanged = true;
+		} else {
+			updateItemsLight();
+			sendInventoryIds();
+			sendStats();
+		}
 	}
 
 	if (std::shared_ptr<Item> item = thing->getItem()) {
@@ -4044,6 +4263,8 @@ void Player::postAddNotification(std::shared_ptr<Thing> thing, std::shared_ptr<C
 }
 
 void Player::postRemoveNotification(std::shared_ptr<Thing> thing, std::shared_ptr<Cylinder> newParent, int32_t index, CylinderLink_t link /*= LINK_OWNER*/) {
+	resetWeaponCache();
+
 	if (link == LINK_OWNER) {
 		// calling movement scripts
 		g_moveEvents().onPlayerDeEquip(getPlayer(), thing->getItem(), static_cast<Slots_t>(index));
@@ -4065,9 +4286,13 @@ void Player::postRemoveNotification(std::shared_ptr<Thing> thing, std::shared_pt
 		}
 
 		updateInventoryWeight();
-		updateItemsLight();
-		sendInventoryIds();
-		sendStats();
+		if (inventoryBatchDepth > 0) {
+			inventoryBatchChanged = true;
+		} else {
+			updateItemsLight();
+			sendInventoryIds();
+			sendStats();
+		}
 	}
 
 	if (std::shared_ptr<Item> item = thing->getItem()) {
@@ -4112,6 +4337,17 @@ void Player::postRemoveNotification(std::shared_ptr<Thing> thing, std::shared_pt
 	}
 }
 
+void Player::endInventoryBatch() {
+	if (--inventoryBatchDepth > 0 || !inventoryBatchChanged) {
+		return;
+	}
+
+	inventoryBatchChanged = false;
+	updateItemsLight();
+	sendInventoryIds();
+	sendStats();
+}
+
 // i will keep this function so it can be reviewed
 bool Player::updateSaleShopList(std::shared_ptr<Item> item) {
 	uint16_t itemId = item->getID();
@@ -4130,7 +4366,12 @@ bool Player::hasShopItemForSale(uint16_t itemId, uint8_t subType) const {
 	}
 
 	const ItemType &itemType = Item::items[itemId];
-	std::vector<ShopBlock> shoplist = shopOwner->getShopItemVector();
+	if (!itemType.isFluidContainer()) {
+		return shopOwner->getShopBuyPrice(itemId) != 0;
+	}
+
+	// Fluids are sold per subtype
+	const auto &shoplist = shopOwner->getShopItemVector();
 	return std::any_of(shoplist.begin(), shoplist.end(), [&](const ShopBlock &shopBlock) {
 		return shopBlock.itemId == itemId && shopBlock.itemBuyPrice != 0 && (!itemType.isFluidContainer() || shopBlock.itemSubType == subType);
 	});
@@ -4158,6 +4399,7 @@ void Player::internalAddThing(uint32_t index, std::shared_ptr<Thing> thing) {
 
 		inventory[index] = item;
 		item->setParent(static_self_cast<Player>());
+		resetWeaponCache();
 	}
 }
 
@@ -4232,7 +4474,7 @@ void Player::doAttacking(uint32_t) {
 		bool result = false;
 
 		std::shared_ptr<Item> tool = getWeapon();
-		const Weapon* weapon = g_weapons().getWeapon(tool);
+		const Weapon* weapon = getWeaponScript();
 		uint32_t delay = getAttackSpeed();
 		bool classicSpeed = g_configManager().getBoolean(CLASSIC_ATTACK_SPEED);
 
@@ -4779,12 +5021,20 @@ void Player::genReservedStorageRange() {
 	// generate outfits range
 	uint32_t outfits_key = PSTRG_OUTFITS_RANGE_START;
 	for (const OutfitEntry &entry : outfits) {
-		storageMap[++outfits_key] = (entry.lookType << 16) | entry.addons;
+		setReservedStorage(++outfits_key, (entry.lookType << 16) | entry.addons);
 	}
 	// generate familiars range
 	uint32_t familiar_key = PSTRG_FAMILIARS_RANGE_START;
 	for (const FamiliarEntry &entry : familiars) {
-		storageMap[++familiar_key] = (entry.lookType << 16);
+		setReservedStorage(++familiar_key, (entry.lookType << 16));
+	}
+}
+
+void Player::setReservedStorage(uint32_t key, int32_t value) {
+	auto [it, inserted] = storageMap.try_emplace(key, value);
+	if (inserted || it->second != value) {
+		it->second = value;
+		storageDirtyKeys.emplace(key);
 	}
 }
 
@@ -5134,11 +5384,7 @@ bool Player::isInWar(std::shared_ptr<Player> player) const {
 		return false;
 	}
 
-	return isInWarList(playerGuild->getId()) && player->isInWarList(guild->getId());
-}
-
-bool Player::isInWarList(uint32_t guildId) const {
-	return std::find(guildWarVector.begin(), guildWarVector.end(), guildId) != guildWarVector.end();
+	return g_game().isGuildsAtWar(guild->getId(), playerGuild->getId());
 }
 
 uint32_t Player::getMagicLevel() const {
@@ -5514,7 +5760,7 @@ GuildEmblems_t Player::getGuildEmblem(std::shared_ptr<Player> player) const {
 		return GUILDEMBLEM_NONE;
 	}
 
-	if (player->getGuildWarVector().empty()) {
+	if (!g_game().hasGuildWars(playerGuild->getId())) {
 		if (guild == playerGuild) {
 			return GUILDEMBLEM_MEMBER;
 		} else {
@@ -5952,35 +6198,19 @@ void Player::sendClosePrivate(uint16_t channelId) {
 }
 
 uint64_t Player::getMoney() const {
-	std::vector<std::shared_ptr<Container>> containers;
 	uint64_t moneyCount = 0;
-
 	for (int32_t i = CONST_SLOT_FIRST; i <= CONST_SLOT_LAST; ++i) {
 		std::shared_ptr<Item> item = inventory[i];
 		if (!item) {
 			continue;
 		}
 
-		std::shared_ptr<Container> container = item->getContainer();
-		if (container) {
-			containers.push_back(container);
+		if (std::shared_ptr<Container> container = item->getContainer()) {
+			moneyCount += container->getHoldingMoney();
 		} else {
 			moneyCount += item->getWorth();
 		}
 	}
-
-	size_t i = 0;
-	while (i < containers.size()) {
-		std::shared_ptr<Container> container = containers[i++];
-		for (std::shared_ptr<Item> item : container->getItemList()) {
-			std::shared_ptr<Container> tmpContainer = item->getContainer();
-			if (tmpContainer) {
-				containers.push_back(tmpContainer);
-			} else {
-				moneyCount += item->getWorth();
-			}
-		}
-	}
 	return moneyCount;
 }
 
@@ -5999,15 +6229,8 @@ std::pair<uint64_t, uint64_t> Player::getForgeSliversAndCores() const {
 	}
 
 	// Check items from stash
-	for (StashItemList stashToSend = getStashItems();
-		 auto [itemId, itemCount] : stashToSend) {
-		if (itemId == ITEM_FORGE_SLIVER) {
-			sliverCount += itemCount;
-		}
-		if (itemId == ITEM_FORGE_CORE) {
-			coreCount += itemCount;
-		}
-	}
+	sliverCount += getStashItemCount(ITEM_FORGE_SLIVER);
+	coreCount += getStashItemCount(ITEM_FORGE_CORE);
 
 	return std::make_pair(sliverCount, coreCount);
 }
@@ -6059,6 +6282,7 @@ void Player::setGuild(const std::shared_ptr<Guild> newGuild) {
 
 	guildNick.clear();
 	guildRank = nullptr;
+	guildRankVersion = ++lastGuildRankVersion;
 
 	if (newGuild) {
 		const auto rank = newGuild->getRankByLevel(1);
@@ -6106,9 +6330,10 @@ bool Player::isImmuneFear() const {
 }
 
 uint64_t Player::getItemCustomPrice(uint16_t itemId, bool buyPrice /* = false*/) const {
-	auto it = itemPriceMap.find(itemId);
-	if (it != itemPriceMap.end()) {
-		return it->second;
+	if (coldData) {
+		if (auto it = coldData->itemPrices.find(itemId); it != coldData->itemPrices.end()) {
+			return it->second;
+		}
 	}
 
 	std::map<uint16_t, uint64_t> itemMap { { itemId, 1 } };
@@ -6492,29 +6717,14 @@ void Player::requestDepotItems() {
 		return;
 	}
 
-	for (std::shared_ptr<Item> locker : depotLocker->getItemList()) {
-		std::shared_ptr<Container> c = locker->getContainer();
-		if (!c || c->empty()) {
-			continue;
-		}
-
-		for (ContainerIterator it = c->iterator(); it.hasNext(); it.advance()) {
-			auto itemMap_it = itemMap.find((*it)->getID());
-
-			uint8_t itemTier = Item::items[(*it)->getID()].upgradeClassification > 0 ? (*it)->getTier() + 1 : 0;
-			if (itemMap_it == itemMap.end()) {
-				std::map<uint8_t, uint32_t> itemTierMap;
-				itemTierMap[itemTier] = Item::countByType((*it), -1);
-				itemMap[(*it)->getID()] = itemTierMap;
-				count++;
-			} else if (auto itemTier_it = itemMap[(*it)->getID()].find(itemTier); itemTier_it == itemMap[(*it)->getID()].end()) {
-				itemMap[(*it)->getID()][itemTier] = Item::countByType((*it), -1);
-				count++;
-			} else {
-				itemMap[(*it)->getID()][itemTier] += Item::countByType((*it), -1);
-			}
+	getDepotIndex().forEachEntry([&itemMap, &count](uint16_t itemId, uint8_t tier, const DepotIndex::Entry &entry) {
+		const uint8_t itemTier = Item::items[itemId].upgradeClassification > 0 ? tier + 1 : 0;
+		auto [it, inserted] = itemMap[itemId].try_emplace(itemTier, 0);
+		if (inserted) {
+			count++;
 		}
-	}
+		it->second += entry.count;
+	});
 
 	for (const auto &[itemId, itemCount] : getStashItems()) {
 		auto itemMap_it = itemMap.find(itemId);
@@ -6558,31 +6768,12 @@ void Player::requestDepotSearchItem(uint16_t itemId, uint8_t tier) {
 		return;
 	}
 
-	for (std::shared_ptr<Item> locker : depotLocker->getItemList()) {
-		std::shared_ptr<Container> c = locker->getContainer();
-		if (!c || c->empty()) {
-			continue;
-		}
-
-		for (ContainerIterator it = c->iterator(); it.hasNext(); it.advance()) {
-			std::shared_ptr<Item> item = *it;
-			if (!item || item->getID() != itemId || item->getTier() != tier) {
-				continue;
-			}
-
-			if (c->isInbox()) {
-				if (inboxItems.size() < 255) {
-					inboxItems.push_back(item);
-				}
-				inboxCount += Item::countByType(item, -1);
-			} else {
-				if (depotItems.size() < 255) {
-					depotItems.push_back(item);
-				}
-				depotCount += Item::countByType(item, -1);
-			}
-		}
-	}
+	getDepotIndex().forEachEntry(itemId, tier, [&](const DepotIndex::Entry &entry, bool isInbox) {
+		auto &items = isInbox ? inboxItems : depotItems;
+		const auto room = std::min<size_t>(255 - std::min<size_t>(255, items.size()), entry.items.size());
+		items.insert(items.end(), entry.items.begin(), entry.items.begin() + room);
+		(isInbox ? inboxCount : depotCount) += entry.count;
+	});
 
 	setDepotSearchIsOpen(itemId, tier);
 	sendDepotSearchResultDetail(itemId, tier, depotCount, depotItems, inboxCount, inboxItems, stashCount);
@@ -6594,28 +6785,13 @@ void Player::retrieveAllItemsFromDepotSearch(uint16_t itemId, uint8_t tier, bool
 		return;
 	}
 
+	// Copied, moving the items away changes the index
 	std::vector<std::shared_ptr<Item>> itemsVector;
-	for (std::shared_ptr<Item> locker : depotLocker->getItemList()) {
-		std::shared_ptr<Container> c = locker->getContainer();
-		if (!c || c->empty() ||
-			// Retrieve from inbox.
-			(c->isInbox() && isDepot) ||
-			// Retrieve from depot.
-			(!c->isInbox() && !isDepot)) {
-			continue;
+	getDepotIndex().forEachEntry(itemId, depotSearchOnItem.second, [&itemsVector, isDepot](const DepotIndex::Entry &entry, bool isInbox) {
+		if (isInbox != isDepot) {
+			itemsVector.insert(itemsVector.end(), entry.items.begin(), entry.items.end());
 		}
-
-		for (ContainerIterator it = c->iterator(); it.hasNext(); it.advance()) {
-			std::shared_ptr<Item> item = *it;
-			if (!item) {
-				continue;
-			}
-
-			if (item->getID() == itemId && item->getTier() == depotSearchOnItem.second) {
-				itemsVector.push_back(item);
-			}
-		}
-	}
+	});
 
 	ReturnValue ret = RETURNVALUE_NOERROR;
 	for (std::shared_ptr<Item> item : itemsVector) {
@@ -6663,31 +6839,29 @@ std::shared_ptr<Item> Player::getItemFromDepotSearch(uint16_t itemId, const Posi
 		return nullptr;
 	}
 
-	uint8_t index = 0;
-	for (std::shared_ptr<Item> locker : depotLocker->getItemList()) {
-		std::shared_ptr<Container> c = locker->getContainer();
-		if (!c || c->empty() || (c->isInbox() && pos.y != 0x21) || // From inbox.
-			(!c->isInbox() && pos.y != 0x20)) { // From depot.
-			continue;
-		}
-
-		for (ContainerIterator it = c->iterator(); it.hasNext(); it.advance()) {
-			std::shared_ptr<Item> item = *it;
-			if (!item || item->getID() != itemId || item->getTier() != depotSearchOnItem.second) {
-				continue;
-			}
+	// Same order as sent by requestDepotSearchItem, 0x20 is the depot and 0x21 the inbox
+	if (pos.y != 0x20 && pos.y != 0x21) {
+		return nullptr;
+	}
 
-			if (pos.z == index) {
-				return item;
-			}
-			index++;
+	const bool fromInbox = pos.y == 0x21;
+	size_t index = pos.z;
+	std::shared_ptr<Item> found;
+	getDepotIndex().forEachEntry(itemId, depotSearchOnItem.second, [&](const DepotIndex::Entry &entry, bool isInbox) {
+		if (found || isInbox != fromInbox) {
+			return;
 		}
-	}
 
-	return nullptr;
+		if (index < entry.items.size()) {
+			found = entry.items[index];
+		} else {
+			index -= entry.items.size();
+		}
+	});
+	return found;
 }
 
-std::pair<std::vector<std::shared_ptr<Item>>, std::map<uint16_t, std::map<uint8_t, uint32_t>>> Player::requestLockerItems(std::shared_ptr<DepotLocker> depotLocker, bool sendToClient /*= false*/, uint8_t tier /*= 0*/) const {
+std::pair<std::vector<std::shared_ptr<Item>>, std::map<uint16_t, std::map<uint8_t, uint32_t>>> Player::requestLockerItems(std::shared_ptr<DepotLocker> depotLocker, bool sendToClient /*= false*/, uint8_t tier /*= 0*/) {
 	if (depotLocker == nullptr) {
 		g_logger().error("{} - Depot locker is nullptr", __FUNCTION__);
 		return {};
@@ -6695,76 +6869,38 @@ std::pair<std::vector<std::shared_ptr<Item>>, std::map<uint16_t, std::map<uint8_
 
 	std::map<uint16_t, std::map<uint8_t, uint32_t>> lockerItems;
 	std::vector<std::shared_ptr<Item>> itemVector;
-	std::vector<std::shared_ptr<Container>> containers { depotLocker };
-
-	size_t size = 0;
-	do {
-		std::shared_ptr<Container> container = containers[size];
-		size++;
-
-		for (std::shared_ptr<Item> item : container->getItemList()) {
-			std::shared_ptr<Container> lockerContainers = item->getContainer();
-			if (lockerContainers && !lockerContainers->empty()) {
-				containers.push_back(lockerContainers);
-				continue;
-			}
-
-			const ItemType &itemType = Item::items[item->getID()];
-			if (itemType.wareId == 0) {
-				continue;
-			}
-
-			if (lockerContainers && (!itemType.isContainer() || lockerContainers->capacity() != itemType.maxItems)) {
-				continue;
-			}
-
-			if (!item->hasMarketAttributes()) {
-				continue;
-			}
-
-			if (!sendToClient && item->getTier() != tier) {
-				continue;
-			}
-
-			(lockerItems[itemType.wareId])[item->getTier()] += Item::countByType(item, -1);
-			itemVector.push_back(item);
+	getDepotIndex().forEachEntry([&](uint16_t itemId, uint8_t itemTier, const DepotIndex::Entry &entry) {
+		if (entry.marketCount == 0 || (!sendToClient && itemTier != tier)) {
+			return;
 		}
-	} while (size < containers.size());
-	StashItemList stashToSend = getStashItems();
-	uint32_t countSize = 0;
-	for (auto [itemId, itemCount] : stashToSend) {
-		countSize += itemCount;
-	}
-
-	do {
-		for (auto [itemId, itemCount] : stashToSend) {
-			const ItemType &itemType = Item::items[itemId];
-			if (itemType.wareId == 0) {
-				continue;
-			}
 
-			countSize = countSize - itemCount;
+		(lockerItems[Item::items[itemId].wareId])[itemTier] += entry.marketCount;
+		std::ranges::copy_if(entry.items, std::back_inserter(itemVector), DepotIndex::isMarketItem);
+	});
+	for (const auto &[itemId, itemCount] : stashItems) {
+		const ItemType &itemType = Item::items[itemId];
+		if (itemType.wareId != 0) {
 			(lockerItems[itemType.wareId])[0] += itemCount;
 		}
-	} while (countSize > 0);
+	}
 
 	return std::make_pair(itemVector, lockerItems);
 }
 
 std::pair<std::vector<std::shared_ptr<Item>>, uint16_t> Player::getLockerItemsAndCountById(const std::shared_ptr<DepotLocker> &depotLocker, uint8_t tier, uint16_t itemId) {
 	std::vector<std::shared_ptr<Item>> lockerItems;
-	auto [itemVector, itemMap] = requestLockerItems(depotLocker, false, tier);
-	uint16_t totalCount = 0;
-	for (auto item : itemVector) {
-		if (!item || item->getID() != itemId) {
-			continue;
-		}
-
-		totalCount++;
-		lockerItems.push_back(item);
+	if (depotLocker == nullptr) {
+		g_logger().error("{} - Depot locker is nullptr", __FUNCTION__);
+		return {};
 	}
 
-	return std::make_pair(lockerItems, totalCount);
+	getDepotIndex().forEachEntry(itemId, tier, [&lockerItems](const DepotIndex::Entry &entry, bool) {
+		if (entry.marketCount > 0) {
+			std::ranges::copy_if(entry.items, std::back_inserter(lockerItems), DepotIndex::isMarketItem);
+		}
+	});
+
+	return std::make_pair(lockerItems, static_cast<uint16_t>(lockerItems.size()));
 }
 
 bool Player::saySpell(
@@ -6801,7 +6937,7 @@ bool Player::saySpell(
 
 	int32_t valueEmote = 0;
 	// Send to client
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (std::shared_ptr<Player> tmpPlayer = spectator->getPlayer()) {
 			valueEmote = tmpPlayer->getStorageValue(STORAGEVALUE_EMOTE);
 			if (!ghostMode || tmpPlayer->canSeeCreature(static_self_cast<Player>())) {
@@ -6815,7 +6951,7 @@ bool Player::saySpell(
 	}
 
 	// Execute lua event method
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		auto tmpPlayer = spectator->getPlayer();
 		if (!tmpPlayer) {
 			continue;
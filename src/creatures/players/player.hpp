@@ -15,6 +15,7 @@
 #include "items/cylinder.hpp"
 #include "declarations.hpp"
 #include "items/containers/depot/depotchest.hpp"
+#include "items/containers/depot/depotindex.hpp"
 #include "items/containers/depot/depotlocker.hpp"
 #include "grouping/familiars.hpp"
 #include "grouping/groups.hpp"
@@ -33,9 +34,11 @@
 #include "vocations/vocation.hpp"
 #include "creatures/npcs/npc.hpp"
 #include "game/bank/bank.hpp"
+#include "game/scheduling/task.hpp"
 
 class House;
 class NetworkMessage;
+class BroadcastPacket;
 class Weapon;
 class ProtocolGame;
 class Party;
@@ -56,6 +59,24 @@ enum class ForgeConversion_t : uint8_t {
 	FORGE_ACTION_INCREASELIMIT = 4
 };
 
+// Player tables IOLoginDataSave::saveSection only rewrites when their rows changed
+enum class PlayerSaveSection_t : uint8_t {
+	STASH,
+	SPELLS,
+	KILLS,
+	BESTIARY,
+	ITEMS,
+	DEPOT,
+	REWARDS,
+	INBOX,
+	PREY,
+	TASK_HUNTING,
+	FORGE_HISTORY,
+	BOSSTIARY,
+	WHEEL,
+	STORAGE,
+};
+
 struct ForgeHistory {
 	ForgeConversion_t actionType = ForgeConversion_t::FORGE_ACTION_FUSION;
 	uint8_t tier = 0;
@@ -90,6 +111,8 @@ using MuteCountMap = std::map<uint32_t, uint32_t>;
 static constexpr int32_t PLAYER_MAX_SPEED = 65535;
 static constexpr int32_t PLAYER_MIN_SPEED = 10;
 static constexpr int32_t PLAYER_SOUND_HEALTH_CHANGE = 10;
+// Recent deaths and PvP kills the cyclopedia keeps in memory per player
+static constexpr size_t MAX_RECENT_DEATH_RECORDS = 100;
 
 class Player final : public Creature, public Cylinder, public Bankable {
 public:
@@ -104,7 +127,7 @@ public:
 		return static_self_cast<Player>();
 	}
 
-	static std::shared_ptr<Task> createPlayerTask(uint32_t delay, std::function<void(void)> f, std::string context);
+	static std::shared_ptr<Task> createPlayerTask(uint32_t delay, TaskFunction &&f, std::string_view context);
 
 	void setID() override;
 
@@ -255,6 +278,12 @@ public:
 	}
 	void setGuildRank(GuildRank_ptr newGuildRank) {
 		guildRank = newGuildRank;
+		guildRankVersion = ++lastGuildRankVersion;
+	}
+	// Changes with every new guild or rank, for the answers cached by rank. Unique across
+	// players, so a player logging in again does not match what was cached for the last login
+	uint32_t getGuildRankVersion() const {
+		return guildRankVersion;
 	}
 
 	bool isGuildMate(std::shared_ptr<Player> player) const;
@@ -267,7 +296,6 @@ public:
 	}
 
 	bool isInWar(std::shared_ptr<Player> player) const;
-	bool isInWarList(uint32_t guild_id) const;
 
 	void setLastWalkthroughAttempt(int64_t walkthroughAttempt) {
 		lastWalkthroughAttempt = walkthroughAttempt;
@@ -282,10 +310,6 @@ public:
 
 	uint32_t getClientIcons();
 
-	const GuildWarVector &getGuildWarVector() const {
-		return guildWarVector;
-	}
-
 	const phmap::parallel_flat_hash_set<std::shared_ptr<MonsterType>> &getCyclopediaMonsterTrackerSet(bool isBoss) const {
 		return isBoss ? m_bosstiaryMonsterTracker : m_bestiaryMonsterTracker;
 	}
@@ -538,6 +562,13 @@ public:
 		return lastDepotId;
 	}
 
+	// Forces the next save to rewrite every table, e.g. when a previous save did not reach the database
+	void invalidateSaveDigests() {
+		savedSectionDigests = {};
+		savedDepotRows.clear();
+		storageSynced = false;
+	}
+
 	void resetIdleTime() {
 		idleTime = 0;
 	}
@@ -660,15 +691,7 @@ public:
 	 */
 	bool removeItemCountById(uint16_t itemId, uint32_t itemAmount, bool removeFromStash = true);
 
-	void addItemOnStash(uint16_t itemId, uint32_t amount) {
-		auto it = stashItems.find(itemId);
-		if (it != stashItems.end()) {
-			stashItems[itemId] += amount;
-			return;
-		}
-
-		stashItems[itemId] = amount;
-	}
+	void addItemOnStash(uint16_t itemId, uint32_t amount);
 	uint32_t getStashItemCount(uint16_t itemId) const {
 		auto it = stashItems.find(itemId);
 		if (it != stashItems.end()) {
@@ -676,23 +699,15 @@ public:
 		}
 		return 0;
 	}
-	bool withdrawItem(uint16_t itemId, uint32_t amount) {
-		auto it = stashItems.find(itemId);
-		if (it != stashItems.end()) {
-			if (it->second > amount) {
-				stashItems[itemId] -= amount;
-			} else if (it->second == amount) {
-				stashItems.erase(itemId);
-			} else {
-				return false;
-			}
-			return true;
-		}
-		return false;
-	}
-	StashItemList getStashItems() const {
+	bool withdrawItem(uint16_t itemId, uint32_t amount);
+	const StashItemList &getStashItems() const {
 		return stashItems;
 	}
+	// Stash slots in use, a slot per full or partial stack of each item
+	uint32_t getStashSize() const {
+		return stashSize;
+	}
+	static uint32_t getStashSlots(uint16_t itemId, uint32_t amount);
 
 	uint32_t getBaseCapacity() const {
 		if (hasFlag(PlayerFlags_t::CannotPickupItem)) {
@@ -738,6 +753,8 @@ public:
 	void removeConditionSuppressions();
 
 	std::shared_ptr<Reward> getReward(const uint64_t rewardId, const bool autoCreate);
+	// Fills a new reward before it goes to the reward chest, so only the reward itself is announced
+	std::shared_ptr<Reward> addRewardItems(uint64_t rewardId, const std::vector<std::shared_ptr<Item>> &items);
 	void removeReward(uint64_t rewardId);
 	void getRewardList(std::vector<uint64_t> &rewards) const;
 	std::shared_ptr<RewardChest> getRewardChest();
@@ -787,6 +804,7 @@ public:
 
 	// V.I.P. functions
 	void notifyStatusChange(std::shared_ptr<Player> player, VipStatus_t status, bool message = true);
+	void notifyStatusChange(uint32_t guid, const std::string &name, VipStatus_t status, bool message = true);
 	bool removeVIP(uint32_t vipGuid);
 	bool addVIP(uint32_t vipGuid, const std::string &vipName, VipStatus_t status);
 	bool addVIPInternal(uint32_t vipGuid);
@@ -868,6 +886,8 @@ public:
 
 	std::shared_ptr<Item> getWeapon(Slots_t slot, bool ignoreAmmo) const;
 	std::shared_ptr<Item> getWeapon(bool ignoreAmmo = false) const;
+	// Weapon event of getWeapon(), nullptr when the item has none
+	const Weapon* getWeaponScript() const;
 	WeaponType_t getWeaponType() const;
 	int32_t getWeaponSkill(std::shared_ptr<Item> item) const;
 	void getShieldAndWeapon(std::shared_ptr<Item> &shield, std::shared_ptr<Item> &weapon) const;
@@ -990,6 +1010,11 @@ public:
 			client->sendChannelMessage(author, text, type, channel);
 		}
 	}
+	void sendChannelMessage(const std::string &author, const std::string &text, SpeakClasses type, uint16_t channel, BroadcastPacket &packet) {
+		if (client) {
+			client->sendChannelMessage(author, text, type, channel, packet);
+		}
+	}
 	void sendChannelEvent(uint16_t channelId, const std::string &playerName, ChannelEvent_t channelEvent) {
 		if (client) {
 			client->sendChannelEvent(channelId, playerName, channelEvent);
@@ -1036,6 +1061,11 @@ public:
 			client->sendCreatureSay(creature, type, text, pos);
 		}
 	}
+	void sendCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, const Position* pos, BroadcastPacket &packet) {
+		if (client) {
+			client->sendCreatureSay(creature, type, text, pos, packet);
+		}
+	}
 	void sendCreatureReload(std::shared_ptr<Creature> creature) {
 		if (client) {
 			client->reloadCreature(creature);
@@ -1171,15 +1201,15 @@ public:
 			client->sendCoinBalance();
 		}
 	}
-	void sendInventoryItem(Slots_t slot, std::shared_ptr<Item> item) {
+	// Sent at the end of the dispatcher cycle with what the slot holds by then
+	void sendInventoryItem(Slots_t slot, std::shared_ptr<Item>) {
 		if (client) {
-			client->sendInventoryItem(slot, item);
+			pendingInventorySlots |= 1U << slot;
+			queueClientUpdate(0);
 		}
 	}
 	void sendInventoryIds() {
-		if (client) {
-			client->sendInventoryIds();
-		}
+		queueClientUpdate(PENDING_INVENTORY_IDS);
 	}
 
 	void openPlayerContainers();
@@ -1301,6 +1331,11 @@ public:
 			client->sendDistanceShoot(from, to, type);
 		}
 	}
+	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type, BroadcastPacket &packet) const {
+		if (client) {
+			client->sendDistanceShoot(from, to, type, packet);
+		}
+	}
 	void sendHouseWindow(std::shared_ptr<House> house, uint32_t listId) const;
 	void sendCreatePrivateChannel(uint16_t channelId, const std::string &channelName) {
 		if (client) {
@@ -1309,9 +1344,7 @@ public:
 	}
 	void sendClosePrivate(uint16_t channelId);
 	void sendIcons() {
-		if (client) {
-			client->sendIcons(getClientIcons());
-		}
+		queueClientUpdate(PENDING_ICONS);
 	}
 	void sendClientCheck() const {
 		if (client) {
@@ -1328,22 +1361,37 @@ public:
 			client->sendMagicEffect(pos, type);
 		}
 	}
+	void sendMagicEffect(const Position &pos, uint16_t type, BroadcastPacket &packet) const {
+		if (client) {
+			client->sendMagicEffect(pos, type, packet);
+		}
+	}
 	void removeMagicEffect(const Position &pos, uint16_t type) const {
 		if (client) {
 			client->removeMagicEffect(pos, type);
 		}
 	}
+	void removeMagicEffect(const Position &pos, uint16_t type, BroadcastPacket &packet) const {
+		if (client) {
+			client->removeMagicEffect(pos, type, packet);
+		}
+	}
 	void sendPing();
 	void sendPingBack() const {
 		if (client) {
 			client->sendPingBack();
 		}
 	}
-	void sendStats();
+	/**
+	 * Stats, basic data, skills, icons, inventory ids and slots are sent at
+	 * the end of the dispatcher cycle, each at most once and with the values
+	 * of that moment, however many times the cycle asked for them.
+	 */
+	void sendStats() {
+		queueClientUpdate(PENDING_STATS);
+	}
 	void sendBasicData() const {
-		if (client) {
-			client->sendBasicData();
-		}
+		queueClientUpdate(PENDING_BASIC_DATA);
 	}
 	void sendBlessStatus() const {
 		if (client) {
@@ -1351,9 +1399,7 @@ public:
 		}
 	}
 	void sendSkills() const {
-		if (client) {
-			client->sendSkills();
-		}
+		queueClientUpdate(PENDING_SKILLS);
 	}
 	void sendTextMessage(MessageClasses mclass, const std::string &message) const {
 		if (client) {
@@ -1380,6 +1426,11 @@ public:
 			client->sendToChannel(creature, type, text, channelId);
 		}
 	}
+	void sendToChannel(const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, uint16_t channelId, BroadcastPacket &packet) const {
+		if (client) {
+			client->sendToChannel(creature, type, text, channelId, packet);
+		}
+	}
 	void sendShop(std::shared_ptr<Npc> npc) const {
 		if (client) {
 			client->sendShop(npc);
@@ -1448,6 +1499,16 @@ public:
 			client->sendTibiaTime(time);
 		}
 	}
+	void sendWorldLight(const LightInfo &lightInfo, BroadcastPacket &packet) {
+		if (client) {
+			client->sendWorldLight(lightInfo, packet);
+		}
+	}
+	void sendTibiaTime(int32_t time, BroadcastPacket &packet) {
+		if (client) {
+			client->sendTibiaTime(time, packet);
+		}
+	}
 	void sendChannelsDialog() {
 		if (client) {
 			client->sendChannelsDialog();
@@ -1601,6 +1662,35 @@ public:
 	void resetAsyncOngoingTask(uint64_t flags) {
 		asyncOngoingTasks &= ~(flags);
 	}
+
+	// Cyclopedia recent deaths and PvP kills, newest first, std::nullopt until loaded
+	std::optional<std::deque<PlayerDeathRecord>> &getRecentDeaths() {
+		return getColdData().recentDeaths;
+	}
+	std::optional<std::deque<PlayerDeathRecord>> &getRecentPvPKills() {
+		return getColdData().recentPvPKills;
+	}
+	void addRecentDeath(const PlayerDeathRecord &record) {
+		if (coldData) {
+			addDeathRecord(coldData->recentDeaths, record);
+		}
+	}
+	void addRecentPvPKill(const PlayerDeathRecord &record) {
+		if (coldData) {
+			addDeathRecord(coldData->recentPvPKills, record);
+		}
+	}
+	// Only kept once loaded, the loading query reads the record from the database otherwise
+	static void addDeathRecord(std::optional<std::deque<PlayerDeathRecord>> &records, const PlayerDeathRecord &record) {
+		if (!records) {
+			return;
+		}
+
+		records->push_front(record);
+		if (records->size() > MAX_RECENT_DEATH_RECORDS) {
+			records->pop_back();
+		}
+	}
 	void sendEnterWorld() {
 		if (client) {
 			client->sendEnterWorld();
@@ -1652,15 +1742,12 @@ public:
 
 	void cancelPush();
 
-	void setModuleDelay(uint8_t byteortype, int16_t delay) {
-		moduleDelayMap[byteortype] = OTSYS_TIME() + delay;
+	void setModuleDelay(uint8_t recvbyte, int16_t delay) {
+		moduleDelays[recvbyte] = OTSYS_TIME() + delay;
 	}
 
-	bool canRunModule(uint8_t byteortype) {
-		if (!moduleDelayMap[byteortype]) {
-			return true;
-		}
-		return moduleDelayMap[byteortype] <= OTSYS_TIME();
+	bool canRunModule(uint8_t recvbyte) const {
+		return moduleDelays[recvbyte] <= OTSYS_TIME();
 	}
 
 	uint32_t getNextActionTime() const;
@@ -1686,6 +1773,17 @@ public:
 		return scheduledSaleUpdate;
 	}
 
+	/**
+	 * Holds back the light, inventory ids and stats sent on every item added
+	 * to or taken from the inventory until the outermost batch ends, which
+	 * sends them once. The weight stays current, capacity checks in between
+	 * see every move.
+	 */
+	void beginInventoryBatch() {
+		++inventoryBatchDepth;
+	}
+	void endInventoryBatch();
+
 	bool inPushEvent() {
 		return inEventMovePush;
 	}
@@ -1818,7 +1916,7 @@ public:
 	}
 
 	void setItemCustomPrice(uint16_t itemId, uint64_t price) {
-		itemPriceMap[itemId] = price;
+		getColdData().itemPrices[itemId] = price;
 	}
 	uint32_t getCharmPoints() {
 		return charmPoints;
@@ -1859,146 +1957,26 @@ public:
 	void setImmuneFear();
 	bool isImmuneFear() const;
 	uint16_t parseRacebyCharm(charmRune_t charmId, bool set, uint16_t newRaceid) {
-		uint16_t raceid = 0;
-		switch (charmId) {
-			case CHARM_WOUND:
-				if (set) {
-					charmRuneWound = newRaceid;
-				} else {
-					raceid = charmRuneWound;
-				}
-				break;
-			case CHARM_ENFLAME:
-				if (set) {
-					charmRuneEnflame = newRaceid;
-				} else {
-					raceid = charmRuneEnflame;
-				}
-				break;
-			case CHARM_POISON:
-				if (set) {
-					charmRunePoison = newRaceid;
-				} else {
-					raceid = charmRunePoison;
-				}
-				break;
-			case CHARM_FREEZE:
-				if (set) {
-					charmRuneFreeze = newRaceid;
-				} else {
-					raceid = charmRuneFreeze;
-				}
-				break;
-			case CHARM_ZAP:
-				if (set) {
-					charmRuneZap = newRaceid;
-				} else {
-					raceid = charmRuneZap;
-				}
-				break;
-			case CHARM_CURSE:
-				if (set) {
-					charmRuneCurse = newRaceid;
-				} else {
-					raceid = charmRuneCurse;
-				}
-				break;
-			case CHARM_CRIPPLE:
-				if (set) {
-					charmRuneCripple = newRaceid;
-				} else {
-					raceid = charmRuneCripple;
-				}
-				break;
-			case CHARM_PARRY:
-				if (set) {
-					charmRuneParry = newRaceid;
-				} else {
-					raceid = charmRuneParry;
-				}
-				break;
-			case CHARM_DODGE:
-				if (set) {
-					charmRuneDodge = newRaceid;
-				} else {
-					raceid = charmRuneDodge;
-				}
-				break;
-			case CHARM_ADRENALINE:
-				if (set) {
-					charmRuneAdrenaline = newRaceid;
-				} else {
-					raceid = charmRuneAdrenaline;
-				}
-				break;
-			case CHARM_NUMB:
-				if (set) {
-					charmRuneNumb = newRaceid;
-				} else {
-					raceid = charmRuneNumb;
-				}
-				break;
-			case CHARM_CLEANSE:
-				if (set) {
-					charmRuneCleanse = newRaceid;
-				} else {
-					raceid = charmRuneCleanse;
-				}
-				break;
-			case CHARM_BLESS:
-				if (set) {
-					charmRuneBless = newRaceid;
-				} else {
-					raceid = charmRuneBless;
-				}
-				break;
-			case CHARM_SCAVENGE:
-				if (set) {
-					charmRuneScavenge = newRaceid;
-				} else {
-					raceid = charmRuneScavenge;
-				}
-				break;
-			case CHARM_GUT:
-				if (set) {
-					charmRuneGut = newRaceid;
-				} else {
-					raceid = charmRuneGut;
-				}
-				break;
-			case CHARM_LOW:
-				if (set) {
-					charmRuneLowBlow = newRaceid;
-				} else {
-					raceid = charmRuneLowBlow;
-				}
-				break;
-			case CHARM_DIVINE:
-				if (set) {
-					charmRuneDivine = newRaceid;
-				} else {
-					raceid = charmRuneDivine;
-				}
-				break;
-			case CHARM_VAMP:
-				if (set) {
-					charmRuneVamp = newRaceid;
-				} else {
-					raceid = charmRuneVamp;
-				}
-				break;
-			case CHARM_VOID:
-				if (set) {
-					charmRuneVoid = newRaceid;
-				} else {
-					raceid = charmRuneVoid;
-				}
-				break;
-			default:
-				raceid = 0;
-				break;
+		if (charmId < CHARM_WOUND || charmId > CHARM_LAST) {
+			return 0;
+		}
+		if (set) {
+			charmRuneRaces[charmId] = newRaceid;
+			return 0;
 		}
-		return raceid;
+		return charmRuneRaces[charmId];
+	}
+	// Charm currently set on the given race, CHARM_NONE when there is none
+	charmRune_t getCharmByRaceId(uint16_t raceId) const {
+		if (raceId == 0) {
+			return CHARM_NONE;
+		}
+		for (int8_t charmId = CHARM_WOUND; charmId <= CHARM_LAST; ++charmId) {
+			if (charmRuneRaces[charmId] == raceId && (UsedRunesBit & (1 << charmId)) != 0) {
+				return static_cast<charmRune_t>(charmId);
+			}
+		}
+		return CHARM_NONE;
 	}
 
 	uint64_t getItemCustomPrice(uint16_t itemId, bool buyPrice = false) const;
@@ -2265,7 +2243,7 @@ public:
 	void openContainerFromDepotSearch(const Position &pos);
 	std::shared_ptr<Item> getItemFromDepotSearch(uint16_t itemId, const Position &pos);
 
-	std::pair<std::vector<std::shared_ptr<Item>>, std::map<uint16_t, std::map<uint8_t, uint32_t>>> requestLockerItems(std::shared_ptr<DepotLocker> depotLocker, bool sendToClient = false, uint8_t tier = 0) const;
+	std::pair<std::vector<std::shared_ptr<Item>>, std::map<uint16_t, std::map<uint8_t, uint32_t>>> requestLockerItems(std::shared_ptr<DepotLocker> depotLocker, bool sendToClient = false, uint8_t tier = 0);
 
 	/**
 	This function returns a pair of an array of items and a 16-bit integer from a DepotLocker instance, a 8-bit byte and a 16-bit integer.
@@ -2364,12 +2342,13 @@ public:
 		return forgeDustLevel;
 	}
 
-	std::vector<ForgeHistory> &getForgeHistory() {
-		return forgeHistoryVector;
+	const std::vector<ForgeHistory> &getForgeHistory() const {
+		static const std::vector<ForgeHistory> noHistory;
+		return coldData ? coldData->forgeHistory : noHistory;
 	}
 
 	void setForgeHistory(const ForgeHistory &history) {
-		forgeHistoryVector.push_back(history);
+		getColdData().forgeHistory.push_back(history);
 	}
 
 	void registerForgeHistoryDescription(ForgeHistory history);
@@ -2466,7 +2445,7 @@ public:
 			activeConcoctions[itemId] = timeLeft;
 		}
 	}
-	std::map<uint16_t, uint16_t> getActiveConcoctions() const {
+	const phmap::flat_hash_map<uint16_t, uint16_t> &getActiveConcoctions() const {
 		return activeConcoctions;
 	}
 
@@ -2513,6 +2492,9 @@ private:
 
 	void checkLootContainers(std::shared_ptr<Item> item);
 
+	// Writes a key of the reserved ranges, marking it dirty only when the value changed
+	void setReservedStorage(uint32_t key, int32_t value);
+
 	void gainExperience(uint64_t exp, std::shared_ptr<Creature> target);
 	void addExperience(std::shared_ptr<Creature> target, uint64_t exp, bool sendText = false);
 	void removeExperience(uint64_t exp, bool sendText = false);
@@ -2537,9 +2519,9 @@ private:
 	std::shared_ptr<Item> getCorpse(std::shared_ptr<Creature> lastHitCreature, std::shared_ptr<Creature> mostDamageCreature) override;
 
 	// cylinder implementations
-	ReturnValue queryAdd(int32_t index, const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, std::shared_ptr<Creature> actor = nullptr) override;
+	ReturnValue queryAdd(int32_t index, const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, const std::shared_ptr<Creature> &actor = nullptr) override;
 	ReturnValue queryMaxCount(int32_t index, const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t &maxQueryCount, uint32_t flags) override;
-	ReturnValue queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, std::shared_ptr<Creature> actor = nullptr) override;
+	ReturnValue queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, const std::shared_ptr<Creature> &actor = nullptr) override;
 	std::shared_ptr<Cylinder> queryDestination(int32_t &index, const std::shared_ptr<Thing> &thing, std::shared_ptr<Item>* destItem, uint32_t &flags) override;
 
 	void addThing(std::shared_ptr<Thing>) override { }
@@ -2559,7 +2541,7 @@ private:
 
 	// This function is a override function of base class
 	std::map<uint32_t, uint32_t> &getAllItemTypeCount(std::map<uint32_t, uint32_t> &countMap) const override;
-	// Function from player class with correct type sizes (uint16_t)
+	// Function from player class with correct type sizes (uint16_t), with a shop open only the items it buys and the money are counted
 	std::map<uint16_t, uint16_t> &getAllSaleItemIdAndCount(std::map<uint16_t, uint16_t> &countMap) const;
 	void getAllItemTypeCountAndSubtype(std::map<uint32_t, uint32_t> &countMap) const;
 	std::shared_ptr<Item> getForgeItemFromId(uint16_t itemId, uint8_t tier);
@@ -2572,23 +2554,50 @@ private:
 
 	phmap::flat_hash_set<uint32_t> VIPList;
 
+	// Ordered, the open containers are saved and reopened by container id
 	std::map<uint8_t, OpenContainer> openContainers;
-	std::map<uint32_t, std::shared_ptr<DepotLocker>> depotLockerMap;
+	phmap::flat_hash_map<uint32_t, std::shared_ptr<DepotLocker>> depotLockerMap;
+	// Ordered, depot items are saved chest by chest and their row digests depend on it
 	std::map<uint32_t, std::shared_ptr<DepotChest>> depotChests;
-	std::map<uint8_t, int64_t> moduleDelayMap;
-	std::map<uint32_t, int32_t> storageMap;
-	std::map<uint16_t, uint64_t> itemPriceMap;
-
-	std::map<uint8_t, uint16_t> maxValuePerSkill = {
+	// Time each recvbyte module may run again, by recvbyte
+	std::array<int64_t, std::numeric_limits<uint8_t>::max() + 1> moduleDelays {};
+	phmap::flat_hash_map<uint32_t, int32_t> storageMap;
+	// Keys changed since player_storage last matched storageMap, the only rows a save has to write
+	phmap::flat_hash_set<uint32_t> storageDirtyKeys;
+	// Whether player_storage holds storageMap but for storageDirtyKeys, false until loaded or after a failed save
+	bool storageSynced = false;
+
+	phmap::flat_hash_map<uint8_t, uint16_t> maxValuePerSkill = {
 		{ SKILL_LIFE_LEECH_CHANCE, 100 },
 		{ SKILL_MANA_LEECH_CHANCE, 100 },
 		{ SKILL_CRITICAL_HIT_CHANCE, g_configManager().getNumber(CRITICALCHANCE) }
 	};
 
+	// Ordered by the time of the rewards, the reward chest lists them in that order
 	std::map<uint64_t, std::shared_ptr<Reward>> rewardMap;
 
-	std::map<ObjectCategory_t, std::shared_ptr<Container>> quickLootContainers;
-	std::vector<ForgeHistory> forgeHistoryVector;
+	phmap::flat_hash_map<ObjectCategory_t, std::shared_ptr<Container>> quickLootContainers;
+
+	// What only some players ever use, allocated the first time a part of it is needed
+	struct ColdData {
+		std::vector<ForgeHistory> forgeHistory;
+		// Cyclopedia recent deaths and PvP kills, newest first, std::nullopt until loaded
+		std::optional<std::deque<PlayerDeathRecord>> recentDeaths;
+		std::optional<std::deque<PlayerDeathRecord>> recentPvPKills;
+		// Prices set in the party analyzer, by item id
+		phmap::flat_hash_map<uint16_t, uint64_t> itemPrices;
+		DepotIndex depotIndex;
+	};
+	std::unique_ptr<ColdData> coldData;
+
+	ColdData &getColdData() {
+		if (!coldData) {
+			coldData = std::make_unique<ColdData>();
+		}
+		return *coldData;
+	}
+	// Brought up to date with the depot boxes and inbox on every call
+	const DepotIndex &getDepotIndex();
 
 	std::vector<uint16_t> quickLootListItemIds;
 
@@ -2598,7 +2607,6 @@ private:
 	std::vector<std::unique_ptr<PreySlot>> preys;
 	std::vector<std::unique_ptr<TaskHuntingSlot>> taskHunting;
 
-	GuildWarVector guildWarVector;
 
 	std::forward_list<std::shared_ptr<Party>> invitePartyList;
 	std::forward_list<uint32_t> modalWindows;
@@ -2652,6 +2660,8 @@ private:
 	std::shared_ptr<BedItem> bedItem = nullptr;
 	std::shared_ptr<Guild> guild = nullptr;
 	GuildRank_ptr guildRank;
+	uint32_t guildRankVersion = 0;
+	static inline uint32_t lastGuildRankVersion = 0;
 	Group* group = nullptr;
 	std::shared_ptr<Inbox> inbox;
 	std::shared_ptr<Item> imbuingItem = nullptr;
@@ -2716,7 +2726,14 @@ private:
 	uint16_t storeXpBoost = 0;
 	uint16_t staminaXpBoost = 100;
 	int16_t lastDepotId = -1;
+	// Digest of the queries each section wrote on the last save, zero when unknown
+	std::array<uint64_t, magic_enum::enum_count<PlayerSaveSection_t>()> savedSectionDigests {};
+	std::array<uint64_t, magic_enum::enum_count<PlayerSaveSection_t>()> pendingSectionDigests {};
+	// Row digest by sid of what player_depotitems holds, used by playerDepotItemDiff
+	std::map<int32_t, uint64_t> savedDepotRows;
+	std::optional<std::map<int32_t, uint64_t>> pendingDepotRows;
 	StashItemList stashItems; // [ItemID] = amount
+	uint32_t stashSize = 0;
 	uint32_t movedItems = 0;
 
 	// Depot search system
@@ -2725,25 +2742,8 @@ private:
 
 	// Bestiary
 	bool charmExpansion = false;
-	uint16_t charmRuneWound = 0;
-	uint16_t charmRuneEnflame = 0;
-	uint16_t charmRunePoison = 0;
-	uint16_t charmRuneFreeze = 0;
-	uint16_t charmRuneZap = 0;
-	uint16_t charmRuneCurse = 0;
-	uint16_t charmRuneCripple = 0;
-	uint16_t charmRuneParry = 0;
-	uint16_t charmRuneDodge = 0;
-	uint16_t charmRuneAdrenaline = 0;
-	uint16_t charmRuneNumb = 0;
-	uint16_t charmRuneCleanse = 0;
-	uint16_t charmRuneBless = 0;
-	uint16_t charmRuneScavenge = 0;
-	uint16_t charmRuneGut = 0;
-	uint16_t charmRuneLowBlow = 0;
-	uint16_t charmRuneDivine = 0;
-	uint16_t charmRuneVamp = 0;
-	uint16_t charmRuneVoid = 0;
+	// Race id each charm rune is set on, indexed by charmRune_t
+	std::array<uint16_t, CHARM_LAST + 1> charmRuneRaces {};
 	uint32_t charmPoints = 0;
 	int32_t UsedRunesBit = 0;
 	int32_t UnlockedRunesBit = 0;
@@ -2778,6 +2778,27 @@ private:
 	bool quickLootFallbackToMainContainer = false;
 	bool logged = false;
 	bool scheduledSaleUpdate = false;
+	bool inventoryBatchChanged = false;
+	uint16_t inventoryBatchDepth = 0;
+
+	enum PendingClientUpdate_t : uint8_t {
+		PENDING_STATS = 1 << 0,
+		PENDING_BASIC_DATA = 1 << 1,
+		PENDING_SKILLS = 1 << 2,
+		PENDING_ICONS = 1 << 3,
+		PENDING_INVENTORY_IDS = 1 << 4,
+	};
+	// Client sections and inventory slots asked for during this dispatcher cycle, the sends are const for their callers
+	mutable uint8_t pendingClientUpdates = 0;
+	mutable uint32_t pendingInventorySlots = 0;
+	mutable bool hasPendingClientUpdates = false;
+	static inline std::vector<std::shared_ptr<Player>> playersWithPendingClientUpdates;
+	// Below it the updates are sent on the game thread, the pool hand-off would cost more than it saves
+	static constexpr size_t PARALLEL_CLIENT_UPDATES_MIN_PLAYERS = 64;
+
+	void queueClientUpdate(uint8_t update) const;
+	void sendPendingClientUpdates();
+	static void sendAllPendingClientUpdates();
 	bool inEventMovePush = false;
 	bool supplyStash = false; // Menu option 'stow, stow container ...'
 	bool marketMenu = false; // Menu option 'show in market'
@@ -2793,11 +2814,11 @@ private:
 
 	// Concoctions
 	// [ConcoctionID] = time
-	std::map<uint16_t, uint16_t> activeConcoctions;
+	phmap::flat_hash_map<uint16_t, uint16_t> activeConcoctions;
 
 	int32_t specializedMagicLevel[COMBAT_COUNT] = { 0 };
 	int32_t cleavePercent = 0;
-	std::map<uint8_t, int32_t> perfectShot;
+	phmap::flat_hash_map<uint8_t, int32_t> perfectShot;
 	int32_t magicShieldCapacityFlat = 0;
 	int32_t magicShieldCapacityPercent = 0;
 
@@ -2887,6 +2908,21 @@ private:
 
 	std::shared_ptr<Item> getQuiverAmmoOfType(const ItemType &it) const;
 
+	// What getWeapon resolves to, kept until the inventory, the level or the registered weapons change
+	struct WeaponCache {
+		std::shared_ptr<Item> weapon;
+		std::shared_ptr<Item> weaponIgnoringAmmo;
+		const Weapon* script = nullptr;
+		uint32_t generation = 0;
+		bool valid = false;
+	};
+	mutable WeaponCache weaponCache;
+
+	const WeaponCache &getWeaponCache() const;
+	void resetWeaponCache() {
+		weaponCache = {};
+	}
+
 	std::array<double_t, COMBAT_COUNT> getFinalDamageReduction() const;
 	void calculateDamageReductionFromEquipedItems(std::array<double_t, COMBAT_COUNT> &combatReductionMap) const;
 	void calculateDamageReductionFromItem(std::array<double_t, COMBAT_COUNT> &combatReductionMap, std::shared_ptr<Item> item) const;
@@ -2894,3 +2930,25 @@ private:
 	void updateDamageReductionFromItemAbility(std::array<double_t, COMBAT_COUNT> &combatReductionMap, std::shared_ptr<Item> item, uint16_t combatTypeIndex) const;
 	double_t calculateDamageReduction(double_t currentTotal, int16_t resistance) const;
 };
+
+/**
+ * Groups the inventory updates of a bulk move, as looting a stack of
+ * corpses, so the player gets one refresh after the last item.
+ */
+class PlayerInventoryBatch {
+public:
+	explicit PlayerInventoryBatch(std::shared_ptr<Player> player) :
+		player(std::move(player)) {
+		this->player->beginInventoryBatch();
+	}
+	~PlayerInventoryBatch() {
+		player->endInventoryBatch();
+	}
+
+	// Ensures that we don't accidentally copy it
+	PlayerInventoryBatch(const PlayerInventoryBatch &) = delete;
+	PlayerInventoryBatch operator=(const PlayerInventoryBatch &) = delete;
+
+private:
+	std::shared_ptr<Player> player;
+};
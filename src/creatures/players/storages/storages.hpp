@@ -25,10 +25,18 @@ public:
 
 	bool loadFromXML();
 
-	const std::map<std::string, uint32_t> &getStorageMap() const;
+	const phmap::flat_hash_map<std::string, uint32_t> &getStorageMap() const;
+
+	// Key registered under the name in storages.xml
+	std::optional<uint32_t> getStorageKey(const std::string &name) const {
+		if (auto it = m_storageMap.find(name); it != m_storageMap.end()) {
+			return it->second;
+		}
+		return std::nullopt;
+	}
 
 private:
-	std::map<std::string, uint32_t> m_storageMap;
+	phmap::flat_hash_map<std::string, uint32_t> m_storageMap;
 };
 
 constexpr auto g_storages = Storages::getInstance;
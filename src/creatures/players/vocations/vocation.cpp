@@ -165,6 +165,8 @@ bool Vocations::loadFromXml() {
 				}
 			}
 		}
+
+		voc.buildRequirementTables();
 	}
 	return true;
 }
@@ -200,65 +202,88 @@ uint16_t Vocations::getPromotedVocation(uint16_t vocationId) const {
 
 uint32_t Vocation::skillBase[SKILL_LAST + 1] = { 50, 50, 50, 50, 30, 100, 20 };
 const uint16_t minSkillLevel = 10;
+// Levels past it are computed when asked for, it bounds the tables of multipliers close to 1
+const uint32_t maxTableLevel = 1000;
 
-absl::uint128 Vocation::getTotalSkillTries(uint8_t skill, uint16_t level) {
-	if (skill > SKILL_LAST) {
-		return 0;
+namespace {
+	uint64_t saturatedRequirement(double value) {
+		constexpr auto max = std::numeric_limits<uint64_t>::max();
+		return value >= static_cast<double>(max) ? max : static_cast<uint64_t>(value);
 	}
 
-	auto it = cacheSkillTotal[skill].find(level);
-	if (it != cacheSkillTotal[skill].end()) {
-		return it->second;
+	template <typename Compute>
+	void buildTable(std::vector<uint64_t> &table, std::vector<absl::uint128> &totalTable, uint32_t firstLevel, Compute &&compute) {
+		table.assign(firstLevel, 0);
+		totalTable.assign(firstLevel, 0);
+		for (uint32_t level = firstLevel; level <= maxTableLevel; ++level) {
+			const uint64_t requirement = compute(level);
+			if (requirement == std::numeric_limits<uint64_t>::max()) {
+				break;
+			}
+			table.push_back(requirement);
+			totalTable.push_back(totalTable.back() + requirement);
+		}
 	}
+}
 
-	absl::uint128 totalTries = 0;
-	for (uint16_t i = minSkillLevel; i <= level; ++i) {
-		totalTries += getReqSkillTries(skill, i);
+void Vocation::buildRequirementTables() {
+	buildTable(manaTable, manaTotalTable, 1, [this](uint32_t level) { return computeReqMana(level); });
+	for (uint8_t skill = SKILL_FIRST; skill <= SKILL_LAST; ++skill) {
+		buildTable(skillTable[skill], skillTotalTable[skill], minSkillLevel + 1, [this, skill](uint32_t level) { return computeReqSkillTries(skill, level); });
 	}
-	cacheSkillTotal[skill][level] = totalTries;
-	return totalTries;
 }
 
-uint64_t Vocation::getReqSkillTries(uint8_t skill, uint16_t level) {
-	if (skill > SKILL_LAST || level <= minSkillLevel) {
+uint64_t Vocation::computeReqSkillTries(uint8_t skill, uint32_t level) const {
+	return saturatedRequirement(skillBase[skill] * std::pow(static_cast<double>(skillMultipliers[skill]), static_cast<int32_t>(level) - (minSkillLevel + 1)));
+}
+
+uint64_t Vocation::computeReqMana(uint32_t magLevel) const {
+	return saturatedRequirement(std::floor(1600 * std::pow<double>(manaMultiplier, static_cast<int32_t>(magLevel) - 1)));
+}
+
+absl::uint128 Vocation::getTotalSkillTries(uint8_t skill, uint16_t level) const {
+	if (skill > SKILL_LAST) {
 		return 0;
 	}
 
-	auto it = cacheSkill[skill].find(level);
-	if (it != cacheSkill[skill].end()) {
-		return it->second;
+	const auto &totalTable = skillTotalTable[skill];
+	if (level < totalTable.size()) {
+		return totalTable[level];
 	}
 
-	uint64_t tries = static_cast<uint64_t>(skillBase[skill] * std::pow(static_cast<double>(skillMultipliers[skill]), level - (minSkillLevel + 1)));
-	cacheSkill[skill][level] = tries;
-	return tries;
+	// Past the table, only reached with multipliers out of the usual range
+	absl::uint128 totalTries = totalTable.empty() ? 0 : totalTable.back();
+	for (uint32_t i = std::max<uint32_t>(totalTable.size(), minSkillLevel + 1); i <= level; ++i) {
+		totalTries += computeReqSkillTries(skill, i);
+	}
+	return totalTries;
 }
 
-absl::uint128 Vocation::getTotalMana(uint32_t magLevel) {
-	if (magLevel == 0) {
+uint64_t Vocation::getReqSkillTries(uint8_t skill, uint16_t level) const {
+	if (skill > SKILL_LAST || level <= minSkillLevel) {
 		return 0;
 	}
-	auto it = cacheManaTotal.find(magLevel);
-	if (it != cacheManaTotal.end()) {
-		return it->second;
+
+	const auto &table = skillTable[skill];
+	return level < table.size() ? table[level] : computeReqSkillTries(skill, level);
+}
+
+absl::uint128 Vocation::getTotalMana(uint32_t magLevel) const {
+	if (magLevel < manaTotalTable.size()) {
+		return manaTotalTable[magLevel];
 	}
-	absl::uint128 totalMana = 0;
-	for (uint32_t i = 1; i <= magLevel; ++i) {
-		totalMana += getReqMana(i);
+
+	absl::uint128 totalMana = manaTotalTable.empty() ? 0 : manaTotalTable.back();
+	for (uint32_t i = std::max<uint32_t>(manaTotalTable.size(), 1); i <= magLevel; ++i) {
+		totalMana += computeReqMana(i);
 	}
 	return totalMana;
 }
 
-uint64_t Vocation::getReqMana(uint32_t magLevel) {
+uint64_t Vocation::getReqMana(uint32_t magLevel) const {
 	if (magLevel == 0) {
 		return 0;
 	}
-	auto it = cacheMana.find(magLevel);
-	if (it != cacheMana.end()) {
-		return it->second;
-	}
 
-	uint64_t reqMana = std::floor<uint64_t>(1600 * std::pow<double>(manaMultiplier, static_cast<int32_t>(magLevel) - 1));
-	cacheMana[magLevel] = reqMana;
-	return reqMana;
+	return magLevel < manaTable.size() ? manaTable[magLevel] : computeReqMana(magLevel);
 }
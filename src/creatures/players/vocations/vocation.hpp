@@ -24,10 +24,10 @@ public:
 	const std::string &getVocDescription() const {
 		return description;
 	}
-	absl::uint128 getTotalSkillTries(uint8_t skill, uint16_t level);
-	uint64_t getReqSkillTries(uint8_t skill, uint16_t level);
-	absl::uint128 getTotalMana(uint32_t magLevel);
-	uint64_t getReqMana(uint32_t magLevel);
+	absl::uint128 getTotalSkillTries(uint8_t skill, uint16_t level) const;
+	uint64_t getReqSkillTries(uint8_t skill, uint16_t level) const;
+	absl::uint128 getTotalMana(uint32_t magLevel) const;
+	uint64_t getReqMana(uint32_t magLevel) const;
 
 	uint16_t getId() const {
 		return id;
@@ -110,10 +110,16 @@ public:
 private:
 	friend class Vocations;
 
-	std::map<uint32_t, uint64_t> cacheMana;
-	std::map<uint32_t, absl::uint128> cacheManaTotal;
-	std::map<uint32_t, uint32_t> cacheSkill[SKILL_LAST + 1];
-	std::map<uint32_t, absl::uint128> cacheSkillTotal[SKILL_LAST + 1];
+	// Fills the tables below, once the multipliers are loaded
+	void buildRequirementTables();
+	uint64_t computeReqSkillTries(uint8_t skill, uint32_t level) const;
+	uint64_t computeReqMana(uint32_t magLevel) const;
+
+	// Requirements and their running totals by level, up to the level the requirement stops fitting in 64 bits
+	std::vector<uint64_t> manaTable;
+	std::vector<absl::uint128> manaTotalTable;
+	std::array<std::vector<uint64_t>, SKILL_LAST + 1> skillTable;
+	std::array<std::vector<absl::uint128>, SKILL_LAST + 1> skillTotalTable;
 
 	std::string name = "none";
 	std::string description;
@@ -84,6 +84,14 @@ namespace {
 		{ 43950, "wheel.scroll.advanced", 20 },
 	};
 
+	// Value of the highest reached stage, stages above the third count as the third
+	int32_t getStageValue(uint8_t stage, const std::array<int32_t, 3> &values) {
+		if (stage == 0) {
+			return 0;
+		}
+		return values[std::min<uint8_t>(stage, 3) - 1];
+	}
+
 } // namespace
 
 PlayerWheel::PlayerWheel(Player &initPlayer) :
@@ -784,7 +792,7 @@ void PlayerWheel::saveSlotPointsOnPressSaveButton(NetworkMessage &msg) {
 		return;
 	}
 
-	auto startSaveTime = OTSYS_TIME();
+	auto startSaveTime = getPreciseTimeMs();
 	if (!canOpenWheel()) {
 		return;
 	}
@@ -849,7 +857,7 @@ void PlayerWheel::saveSlotPointsOnPressSaveButton(NetworkMessage &msg) {
 	initializePlayerData();
 	registerPlayerBonusData();
 
-	g_logger().debug("Player: {} is saved the all slots info in: {} seconds", m_player.getName(), (OTSYS_TIME() - startSaveTime) / (1000.));
+	g_logger().debug("Player: {} is saved the all slots info in: {} seconds", m_player.getName(), (getPreciseTimeMs() - startSaveTime) / (1000.));
 }
 
 /*
@@ -1224,10 +1232,37 @@ void PlayerWheel::registerPlayerBonusData() {
 		m_player.changeMana(-difference);
 	}
 
+	compileCombatBonus();
+
 	onThink(false); // Not forcing the reload
 	reloadPlayerData();
 }
 
+void PlayerWheel::compileCombatBonus() {
+	m_combatBonus = PlayerWheelCombatBonus();
+	m_combatBonus.runicMastery = getInstant(WheelInstant_t::RUNIC_MASTERY);
+	m_combatBonus.ballisticMastery = getInstant(WheelInstant_t::BALLISTIC_MASTERY);
+	m_combatBonus.battleHealing = getInstant(WheelInstant_t::BATTLE_HEALING);
+	m_combatBonus.healingLink = getInstant(WheelInstant_t::HEALING_LINK);
+	m_combatBonus.focusMastery = getInstant(WheelInstant_t::FOCUS_MASTERY);
+	m_combatBonus.combatMastery = getStage(WheelStage_t::COMBAT_MASTERY) > 0;
+	m_combatBonus.divineEmpowerment = getStage(WheelStage_t::DIVINE_EMPOWERMENT) > 0;
+
+	for (const auto avatar : { WheelStage_t::AVATAR_OF_LIGHT, WheelStage_t::AVATAR_OF_STEEL, WheelStage_t::AVATAR_OF_NATURE, WheelStage_t::AVATAR_OF_STORM }) {
+		if (uint8_t stage = getStage(avatar); stage > 0) {
+			m_combatBonus.avatarStage = stage;
+			break;
+		}
+	}
+
+	m_combatBonus.giftOfLife = getGiftOfLifeValue();
+	const uint8_t groveStage = getStage(WheelStage_t::BLESSING_OF_THE_GROVE);
+	m_combatBonus.blessingOfTheGrove = { getStageValue(groveStage, { 12, 18, 24 }), getStageValue(groveStage, { 6, 9, 12 }) };
+	m_combatBonus.twinBurst = getStageValue(getStage(WheelStage_t::TWIN_BURST), { 20, 40, 60 });
+	m_combatBonus.executionersThrow = getStageValue(getStage(WheelStage_t::EXECUTIONERS_THROW), { 100, 125, 150 });
+	m_combatBonus.beamMastery = checkBeamMasteryDamage();
+}
+
 void PlayerWheel::loadPlayerBonusData() {
 	// Check if the player can use the wheel, otherwise we dont need to do unnecessary loops and checks
 	if (!canOpenWheel()) {
@@ -1853,28 +1888,19 @@ int32_t PlayerWheel::checkBlessingGroveHealingByTarget(std::shared_ptr<Creature>
 		return 0;
 	}
 
-	int32_t healingBonus = 0;
-	uint8_t stage = getStage(WheelStage_t::BLESSING_OF_THE_GROVE);
+	const auto &healingBonus = m_combatBonus.blessingOfTheGrove;
+	if (healingBonus[0] == 0) {
+		return 0;
+	}
+
 	int32_t healthPercent = std::round((static_cast<double>(target->getHealth()) * 100) / static_cast<double>(target->getMaxHealth()));
 	if (healthPercent <= 30) {
-		if (stage >= 3) {
-			healingBonus = 24;
-		} else if (stage >= 2) {
-			healingBonus = 18;
-		} else if (stage >= 1) {
-			healingBonus = 12;
-		}
+		return healingBonus[0];
 	} else if (healthPercent <= 60) {
-		if (stage >= 3) {
-			healingBonus = 12;
-		} else if (stage >= 2) {
-			healingBonus = 9;
-		} else if (stage >= 1) {
-			healingBonus = 6;
-		}
+		return healingBonus[1];
 	}
 
-	return healingBonus;
+	return 0;
 }
 
 int32_t PlayerWheel::checkTwinBurstByTarget(std::shared_ptr<Creature> target) const {
@@ -1882,20 +1908,12 @@ int32_t PlayerWheel::checkTwinBurstByTarget(std::shared_ptr<Creature> target) co
 		return 0;
 	}
 
-	int32_t damageBonus = 0;
-	uint8_t stage = getStage(WheelStage_t::TWIN_BURST);
-	int32_t healthPercent = std::round((static_cast<double>(target->getHealth()) * 100) / static_cast<double>(target->getMaxHealth()));
-	if (healthPercent > 60) {
-		if (stage >= 3) {
-			damageBonus = 60;
-		} else if (stage >= 2) {
-			damageBonus = 40;
-		} else if (stage >= 1) {
-			damageBonus = 20;
-		}
+	if (m_combatBonus.twinBurst == 0) {
+		return 0;
 	}
 
-	return damageBonus;
+	int32_t healthPercent = std::round((static_cast<double>(target->getHealth()) * 100) / static_cast<double>(target->getMaxHealth()));
+	return healthPercent > 60 ? m_combatBonus.twinBurst : 0;
 }
 
 int32_t PlayerWheel::checkExecutionersThrow(std::shared_ptr<Creature> target) const {
@@ -1903,20 +1921,12 @@ int32_t PlayerWheel::checkExecutionersThrow(std::shared_ptr<Creature> target) co
 		return 0;
 	}
 
-	int32_t damageBonus = 0;
-	uint8_t stage = getStage(WheelStage_t::EXECUTIONERS_THROW);
-	int32_t healthPercent = std::round((static_cast<double>(target->getHealth()) * 100) / static_cast<double>(target->getMaxHealth()));
-	if (healthPercent <= 30) {
-		if (stage >= 3) {
-			damageBonus = 150;
-		} else if (stage >= 2) {
-			damageBonus = 125;
-		} else if (stage >= 1) {
-			damageBonus = 100;
-		}
+	if (m_combatBonus.executionersThrow == 0) {
+		return 0;
 	}
 
-	return damageBonus;
+	int32_t healthPercent = std::round((static_cast<double>(target->getHealth()) * 100) / static_cast<double>(target->getMaxHealth()));
+	return healthPercent <= 30 ? m_combatBonus.executionersThrow : 0;
 }
 
 int32_t PlayerWheel::checkBeamMasteryDamage() const {
@@ -1982,16 +1992,8 @@ int32_t PlayerWheel::checkAvatarSkill(WheelAvatarSkill_t skill) const {
 		return 0;
 	}
 
-	uint8_t stage = 0;
-	if (getInstant("Avatar of Light")) {
-		stage = getStage(WheelStage_t::AVATAR_OF_LIGHT);
-	} else if (getInstant("Avatar of Steel")) {
-		stage = getStage(WheelStage_t::AVATAR_OF_STEEL);
-	} else if (getInstant("Avatar of Nature")) {
-		stage = getStage(WheelStage_t::AVATAR_OF_NATURE);
-	} else if (getInstant("Avatar of Storm")) {
-		stage = getStage(WheelStage_t::AVATAR_OF_STORM);
-	} else {
+	const uint8_t stage = m_combatBonus.avatarStage;
+	if (stage == 0) {
 		return 0;
 	}
 
@@ -2027,10 +2029,13 @@ int32_t PlayerWheel::checkFocusMasteryDamage() {
 }
 int32_t PlayerWheel::checkElementSensitiveReduction(CombatType_t type) const {
 	int32_t rt = 0;
+	if (!m_combatBonus.ballisticMastery) {
+		return rt;
+	}
 	if (type == COMBAT_PHYSICALDAMAGE) {
-		rt += getMajorStatConditional("Ballistic Mastery", WheelMajor_t::PHYSICAL_DMG);
+		rt += getMajorStat(WheelMajor_t::PHYSICAL_DMG);
 	} else if (type == COMBAT_HOLYDAMAGE) {
-		rt += getMajorStatConditional("Ballistic Mastery", WheelMajor_t::HOLY_DMG);
+		rt += getMajorStat(WheelMajor_t::HOLY_DMG);
 	}
 	return rt;
 }
@@ -2143,7 +2148,9 @@ void PlayerWheel::downgradeSpell(const std::string &name) {
 
 std::shared_ptr<Spell> PlayerWheel::getCombatDataSpell(CombatDamage &damage) {
 	std::shared_ptr<Spell> spell = nullptr;
-	damage.damageMultiplier += getMajorStatConditional("Divine Empowerment", WheelMajor_t::DAMAGE);
+	if (m_combatBonus.divineEmpowerment) {
+		damage.damageMultiplier += getMajorStat(WheelMajor_t::DAMAGE);
+	}
 	WheelSpellGrade_t spellGrade = WheelSpellGrade_t::NONE;
 	if (!(damage.instantSpellName).empty()) {
 		spellGrade = getSpellUpgrade(damage.instantSpellName);
@@ -2156,7 +2163,7 @@ std::shared_ptr<Spell> PlayerWheel::getCombatDataSpell(CombatDamage &damage) {
 		if (getHealingLinkUpgrade(spell->getName())) {
 			damage.healingLink += 10;
 		}
-		if (spell->getSecondaryGroup() == SPELLGROUP_FOCUS && getInstant("Focus Mastery")) {
+		if (m_combatBonus.focusMastery && spell->getSecondaryGroup() == SPELLGROUP_FOCUS) {
 			setOnThinkTimer(WheelOnThink_t::FOCUS_MASTERY, (OTSYS_TIME() + 12000));
 		}
 
@@ -2438,10 +2445,8 @@ int32_t PlayerWheel::getResistance(CombatType_t type) const {
 }
 
 WheelSpellGrade_t PlayerWheel::getSpellUpgrade(const std::string &name) const {
-	for (const auto &[name_it, grade_it] : m_spellsSelected) {
-		if (name_it == name) {
-			return grade_it;
-		}
+	if (auto it = m_spellsSelected.find(name); it != m_spellsSelected.end()) {
+		return it->second;
 	}
 	return WheelSpellGrade_t::NONE;
 }
@@ -2451,7 +2456,7 @@ double PlayerWheel::getMitigationMultiplier() const {
 }
 
 bool PlayerWheel::getHealingLinkUpgrade(const std::string &spell) const {
-	if (!getInstant("Healing Link")) {
+	if (!m_combatBonus.healingLink) {
 		return false;
 	}
 	if (spell == "Nature's Embrace" || spell == "Heal Friend") {
@@ -2610,7 +2615,7 @@ void PlayerWheel::setWheelBonusData(const PlayerWheelMethodsBonusData &newBonusD
 // Functions used to Manage Combat
 uint8_t PlayerWheel::getBeamAffectedTotal(const CombatDamage &tmpDamage) const {
 	uint8_t beamAffectedTotal = 0; // Removed const
-	if (tmpDamage.runeSpellName == "Beam Mastery" && getInstant("Beam Mastery")) {
+	if (m_combatBonus.beamMastery > 0 && tmpDamage.runeSpellName == "Beam Mastery") {
 		beamAffectedTotal = 3;
 	}
 	return beamAffectedTotal;
@@ -2618,14 +2623,14 @@ uint8_t PlayerWheel::getBeamAffectedTotal(const CombatDamage &tmpDamage) const {
 
 void PlayerWheel::updateBeamMasteryDamage(CombatDamage &tmpDamage, uint8_t &beamAffectedTotal, uint8_t &beamAffectedCurrent) const {
 	if (beamAffectedTotal > 0) {
-		tmpDamage.damageMultiplier += checkBeamMasteryDamage();
+		tmpDamage.damageMultiplier += m_combatBonus.beamMastery;
 		--beamAffectedTotal;
 		beamAffectedCurrent++;
 	}
 }
 
 void PlayerWheel::healIfBattleHealingActive() const {
-	if (getInstant("Battle Healing")) {
+	if (m_combatBonus.battleHealing) {
 		CombatDamage damage;
 		damage.primary.value = checkBattleHealingAmount();
 		damage.primary.type = COMBAT_HEALING;
@@ -2676,8 +2681,8 @@ float PlayerWheel::calculateMitigation() const {
 		}
 		defenseValue = shield->getDefense();
 		// Wheel of destiny
-		if (shield->getDefense() > 0) {
-			defenseValue += getMajorStatConditional("Combat Mastery", WheelMajor_t::DEFENSE);
+		if (m_combatBonus.combatMastery && shield->getDefense() > 0) {
+			defenseValue += getMajorStat(WheelMajor_t::DEFENSE);
 		}
 	}
 
@@ -101,6 +101,9 @@ public:
 
 	void loadPlayerBonusData();
 
+	// Resolves the current stages and instants into the combat bonus table
+	void compileCombatBonus();
+
 	void loadDedicationAndConvictionPerks();
 
 	/**
@@ -284,6 +287,10 @@ public:
 
 	void setWheelBonusData(const PlayerWheelMethodsBonusData &newBonusData);
 
+	const PlayerWheelCombatBonus &getCombatBonus() const {
+		return m_combatBonus;
+	}
+
 	// Combat functions
 	uint8_t getBeamAffectedTotal(const CombatDamage &tmpDamage) const;
 	void updateBeamMasteryDamage(CombatDamage &tmpDamage, uint8_t &beamAffectedTotal, uint8_t &beamAffectedCurrent) const;
@@ -324,6 +331,7 @@ private:
 	std::array<uint16_t, 37> m_wheelSlots = {};
 
 	PlayerWheelMethodsBonusData m_playerBonusData;
+	PlayerWheelCombatBonus m_combatBonus;
 
 	std::array<uint8_t, static_cast<size_t>(WheelStage_t::TOTAL_COUNT)> m_stages = { 0 };
 	std::array<int64_t, static_cast<size_t>(WheelOnThink_t::TOTAL_COUNT)> m_onThink = { 0 };
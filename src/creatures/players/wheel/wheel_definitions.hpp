@@ -252,6 +252,35 @@ struct PlayerWheelMethodsBonusData {
 	std::vector<std::string> spells;
 };
 
+/**
+ * @brief Combat values resolved from the wheel stages and instants.
+ *
+ * Stages and instants only change when the bonus data is registered (login and
+ * saving the wheel), so the table is rebuilt there and the damage and healing
+ * paths read plain fields instead of resolving stages by name on every hit.
+ */
+struct PlayerWheelCombatBonus {
+	bool runicMastery = false;
+	bool ballisticMastery = false;
+	bool battleHealing = false;
+	bool healingLink = false;
+	bool focusMastery = false;
+	bool combatMastery = false;
+	bool divineEmpowerment = false;
+	// Stage of the selected avatar, 0 when there is none
+	uint8_t avatarStage = 0;
+	// Maximum overkill, in percent of the max health, Gift of Life saves from. 0 when not selected
+	uint8_t giftOfLife = 0;
+	// Healing bonus in percent on targets at or below 30% and 60% of their health
+	std::array<int32_t, 2> blessingOfTheGrove = {};
+	// Damage bonus in percent on targets above 60% of their health
+	int32_t twinBurst = 0;
+	// Damage bonus in percent on targets at or below 30% of their health
+	int32_t executionersThrow = 0;
+	// Damage bonus in percent on the targets hit by a beam
+	int32_t beamMastery = 0;
+};
+
 /**
  * @brief Slot information struct.
  *
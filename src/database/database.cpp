@@ -12,8 +12,13 @@
 #include "config/configmanager.hpp"
 #include "database/database.hpp"
 #include "lib/di/container.hpp"
+#include "lib/profiling/profiler.hpp"
 
 Database::~Database() {
+	for (const auto &[query, statement] : statements) {
+		mysql_stmt_close(statement);
+	}
+
 	if (handle != nullptr) {
 		mysql_close(handle);
 	}
@@ -57,6 +62,11 @@ bool Database::connect(const std::string* host, const std::string* user, const s
 }
 
 bool Database::beginTransaction() {
+	if (auto capture = DBWriteCapture::getActive()) {
+		capture->beginTransaction();
+		return true;
+	}
+
 	if (!executeQuery("BEGIN")) {
 		return false;
 	}
@@ -65,6 +75,11 @@ bool Database::beginTransaction() {
 }
 
 bool Database::rollback() {
+	if (auto capture = DBWriteCapture::getActive()) {
+		capture->rollback();
+		return true;
+	}
+
 	if (!handle) {
 		g_logger().error("Database not initialized!");
 		return false;
@@ -81,6 +96,11 @@ bool Database::rollback() {
 }
 
 bool Database::commit() {
+	if (auto capture = DBWriteCapture::getActive()) {
+		capture->commit();
+		return true;
+	}
+
 	if (!handle) {
 		g_logger().error("Database not initialized!");
 		return false;
@@ -114,6 +134,12 @@ bool Database::retryQuery(const std::string_view &query, int retries) {
 }
 
 bool Database::executeQuery(const std::string_view &query) {
+	CANARY_PROFILE_ZONE("Database::executeQuery");
+	if (auto capture = DBWriteCapture::getActive()) {
+		capture->record(query);
+		return true;
+	}
+
 	if (!handle) {
 		g_logger().error("Database not initialized!");
 		return false;
@@ -128,6 +154,13 @@ bool Database::executeQuery(const std::string_view &query) {
 }
 
 DBResult_ptr Database::storeQuery(const std::string_view &query) {
+	CANARY_PROFILE_ZONE("Database::storeQuery");
+	if (auto prefetch = DBPrefetch::getActive()) {
+		if (auto result = prefetch->take(query)) {
+			return *result;
+		}
+	}
+
 	if (!handle) {
 		g_logger().error("Database not initialized!");
 		return nullptr;
@@ -158,6 +191,331 @@ retry:
 	return nullptr;
 }
 
+bool Database::executeStatement(std::string_view query, std::initializer_list<DBParam> params) {
+	if (auto capture = DBWriteCapture::getActive()) {
+		capture->record(formatStatement(query, params));
+		return true;
+	}
+
+	if (!handle) {
+		g_logger().error("Database not initialized!");
+		return false;
+	}
+
+	std::scoped_lock lock { databaseLock };
+	MYSQL_STMT* statement = runStatement(query, params);
+	if (!statement) {
+		return false;
+	}
+
+	mysql_stmt_free_result(statement);
+	return true;
+}
+
+std::vector<DBResult_ptr> Database::storeQueries(const std::vector<std::string> &queries) {
+	std::vector<DBResult_ptr> results;
+	if (queries.empty()) {
+		return results;
+	}
+
+	if (!handle) {
+		g_logger().error("Database not initialized!");
+		return results;
+	}
+
+	std::string batch;
+	for (const auto &query : queries) {
+		batch.append(query).append(";");
+	}
+
+	std::scoped_lock lock { databaseLock };
+	// Only enabled for the batch, a single query must never be able to carry a second one
+	if (mysql_set_server_option(handle, MYSQL_OPTION_MULTI_STATEMENTS_ON) != 0) {
+		g_logger().error("Message: {}", mysql_error(handle));
+		return results;
+	}
+
+	if (mysql_real_query(handle, batch.data(), batch.size()) != 0) {
+		g_logger().error("Query: {}", batch);
+		g_logger().error("Message: {}", mysql_error(handle));
+	} else {
+		results.reserve(queries.size());
+		int status;
+		do {
+			if (MYSQL_RES* res = mysql_store_result(handle)) {
+				auto result = std::make_shared<DBResult>(res);
+				results.emplace_back(result->hasNext() ? result : nullptr);
+			} else {
+				results.emplace_back(nullptr);
+			}
+		} while ((status = mysql_next_result(handle)) == 0);
+
+		if (status > 0) {
+			g_logger().error("Query: {}", queries[std::min(results.size(), queries.size() - 1)]);
+			g_logger().error("Message: {}", mysql_error(handle));
+			results.clear();
+		}
+	}
+
+	mysql_set_server_option(handle, MYSQL_OPTION_MULTI_STATEMENTS_OFF);
+	if (results.size() != queries.size()) {
+		results.clear();
+	}
+	return results;
+}
+
+DBResult_ptr Database::storeStatement(std::string_view query, std::initializer_list<DBParam> params) {
+	if (auto prefetch = DBPrefetch::getActive()) {
+		if (auto result = prefetch->take(formatStatement(query, params))) {
+			return *result;
+		}
+	}
+
+	if (!handle) {
+		g_logger().error("Database not initialized!");
+		return nullptr;
+	}
+
+	std::scoped_lock lock { databaseLock };
+	MYSQL_STMT* statement = runStatement(query, params);
+	if (!statement) {
+		return nullptr;
+	}
+
+	MYSQL_RES* metadata = mysql_stmt_result_metadata(statement);
+	if (!metadata) {
+		mysql_stmt_free_result(statement);
+		return nullptr;
+	}
+
+	// Lets the BLOB buffers be sized from the longest value of each column
+	std::remove_pointer_t<decltype(MYSQL_BIND::is_null)> updateMaxLength = 1;
+	mysql_stmt_attr_set(statement, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+	if (mysql_stmt_store_result(statement) != 0) {
+		g_logger().error("Query: {}", query);
+		g_logger().error("Message: {}", mysql_stmt_error(statement));
+		mysql_free_result(metadata);
+		return nullptr;
+	}
+
+	const auto columnCount = mysql_num_fields(metadata);
+	const MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+
+	struct ColumnBuffer {
+		int64_t integer = 0;
+		double real = 0;
+		std::string bytes;
+		unsigned long length = 0;
+		std::remove_pointer_t<decltype(MYSQL_BIND::is_null)> isNull = 0;
+	};
+
+	std::vector<std::string> columnNames;
+	std::vector<ColumnBuffer> buffers(columnCount);
+	std::vector<MYSQL_BIND> binds(columnCount);
+	columnNames.reserve(columnCount);
+	for (size_t i = 0; i < columnCount; ++i) {
+		const MYSQL_FIELD &field = fields[i];
+		columnNames.emplace_back(field.name);
+
+		MYSQL_BIND &bind = binds[i];
+		ColumnBuffer &buffer = buffers[i];
+		switch (field.type) {
+			case MYSQL_TYPE_TINY:
+			case MYSQL_TYPE_SHORT:
+			case MYSQL_TYPE_INT24:
+			case MYSQL_TYPE_LONG:
+			case MYSQL_TYPE_LONGLONG:
+			case MYSQL_TYPE_YEAR:
+				bind.buffer_type = MYSQL_TYPE_LONGLONG;
+				bind.buffer = &buffer.integer;
+				bind.is_unsigned = (field.flags & UNSIGNED_FLAG) != 0;
+				break;
+			case MYSQL_TYPE_FLOAT:
+			case MYSQL_TYPE_DOUBLE:
+				bind.buffer_type = MYSQL_TYPE_DOUBLE;
+				bind.buffer = &buffer.real;
+				break;
+			default:
+				buffer.bytes.resize(std::max<unsigned long>(1, field.max_length));
+				bind.buffer_type = MYSQL_TYPE_BLOB;
+				bind.buffer = buffer.bytes.data();
+				bind.buffer_length = buffer.bytes.size();
+				break;
+		}
+		bind.length = &buffer.length;
+		bind.is_null = &buffer.isNull;
+	}
+
+	std::vector<std::vector<DBValue>> rows;
+	if (mysql_stmt_bind_result(statement, binds.data()) == 0) {
+		rows.reserve(mysql_stmt_num_rows(statement));
+		int status;
+		while ((status = mysql_stmt_fetch(statement)) == 0 || status == MYSQL_DATA_TRUNCATED) {
+			auto &values = rows.emplace_back(columnCount);
+			for (size_t i = 0; i < columnCount; ++i) {
+				const ColumnBuffer &buffer = buffers[i];
+				if (buffer.isNull) {
+					continue;
+				}
+
+				if (binds[i].buffer_type == MYSQL_TYPE_LONGLONG) {
+					if (binds[i].is_unsigned) {
+						values[i] = static_cast<uint64_t>(buffer.integer);
+					} else {
+						values[i] = buffer.integer;
+					}
+				} else if (binds[i].buffer_type == MYSQL_TYPE_DOUBLE) {
+					values[i] = buffer.real;
+				} else {
+					values[i] = std::string(buffer.bytes.data(), std::min<size_t>(buffer.length, buffer.bytes.size()));
+				}
+			}
+		}
+	} else {
+		g_logger().error("Query: {}", query);
+		g_logger().error("Message: {}", mysql_stmt_error(statement));
+	}
+
+	mysql_stmt_free_result(statement);
+	mysql_free_result(metadata);
+
+	if (rows.empty()) {
+		return nullptr;
+	}
+	return std::make_shared<DBResult>(std::move(columnNames), std::move(rows));
+}
+
+MYSQL_STMT* Database::runStatement(std::string_view query, std::initializer_list<DBParam> params) {
+	std::vector<MYSQL_BIND> binds(params.size());
+	size_t index = 0;
+	for (const DBParam &param : params) {
+		MYSQL_BIND &bind = binds[index++];
+		std::visit(
+			[&bind](const auto &value) {
+				using Value = std::decay_t<decltype(value)>;
+				if constexpr (std::is_same_v<Value, std::nullptr_t>) {
+					bind.buffer_type = MYSQL_TYPE_NULL;
+				} else if constexpr (std::is_same_v<Value, int64_t> || std::is_same_v<Value, uint64_t>) {
+					bind.buffer_type = MYSQL_TYPE_LONGLONG;
+					bind.buffer = const_cast<Value*>(&value);
+					bind.is_unsigned = std::is_same_v<Value, uint64_t>;
+				} else if constexpr (std::is_same_v<Value, double>) {
+					bind.buffer_type = MYSQL_TYPE_DOUBLE;
+					bind.buffer = const_cast<double*>(&value);
+				} else if constexpr (std::is_same_v<Value, std::string_view>) {
+					bind.buffer_type = MYSQL_TYPE_STRING;
+					bind.buffer = const_cast<char*>(value.data());
+					bind.buffer_length = value.size();
+				} else {
+					bind.buffer_type = MYSQL_TYPE_BLOB;
+					bind.buffer = const_cast<char*>(value.data.data());
+					bind.buffer_length = value.data.size();
+				}
+			},
+			param.value
+		);
+	}
+
+	for (int retries = 10; retries > 0; --retries) {
+		MYSQL_STMT* statement = getStatement(query);
+		if (!statement) {
+			if (!isRecoverableError(mysql_errno(handle))) {
+				return nullptr;
+			}
+			std::this_thread::sleep_for(std::chrono::seconds(1));
+			continue;
+		}
+
+		if (mysql_stmt_param_count(statement) != params.size()) {
+			g_logger().error("Query: {}", query);
+			g_logger().error("Statement takes {} parameters, {} given", mysql_stmt_param_count(statement), params.size());
+			return nullptr;
+		}
+
+		if (mysql_stmt_bind_param(statement, binds.data()) == 0 && mysql_stmt_execute(statement) == 0) {
+			return statement;
+		}
+
+		const unsigned int error = mysql_stmt_errno(statement);
+		g_logger().error("Query: {}", query.substr(0, 256));
+		g_logger().error("MySQL error [{}]: {}", error, mysql_stmt_error(statement));
+		// A reconnect drops the prepared statements of the old connection
+		dropStatement(query);
+		if (error != 1243 /*ER_UNKNOWN_STMT_HANDLER*/) {
+			if (!isRecoverableError(error)) {
+				return nullptr;
+			}
+			std::this_thread::sleep_for(std::chrono::seconds(1));
+		}
+	}
+
+	g_logger().error("Query {} failed after {} retries.", query, 10);
+	return nullptr;
+}
+
+MYSQL_STMT* Database::getStatement(std::string_view query) {
+	if (auto it = statements.find(query); it != statements.end()) {
+		return it->second;
+	}
+
+	MYSQL_STMT* statement = mysql_stmt_init(handle);
+	if (!statement) {
+		g_logger().error("Message: {}", mysql_error(handle));
+		return nullptr;
+	}
+
+	if (mysql_stmt_prepare(statement, query.data(), static_cast<unsigned long>(query.size())) != 0) {
+		g_logger().error("Query: {}", query);
+		g_logger().error("Message: {}", mysql_stmt_error(statement));
+		mysql_stmt_close(statement);
+		return nullptr;
+	}
+
+	statements.emplace(std::string(query), statement);
+	return statement;
+}
+
+void Database::dropStatement(std::string_view query) {
+	if (auto it = statements.find(query); it != statements.end()) {
+		mysql_stmt_close(it->second);
+		statements.erase(it);
+	}
+}
+
+std::string Database::formatStatement(std::string_view query, std::initializer_list<DBParam> params) const {
+	std::string formatted;
+	formatted.reserve(query.size());
+
+	auto param = params.begin();
+	char quote = 0;
+	for (const char c : query) {
+		if (quote != 0) {
+			quote = c == quote ? 0 : quote;
+		} else if (c == '\'' || c == '"' || c == '`') {
+			quote = c;
+		} else if (c == '?' && param != params.end()) {
+			std::visit(
+				[this, &formatted](const auto &value) {
+					using Value = std::decay_t<decltype(value)>;
+					if constexpr (std::is_same_v<Value, std::nullptr_t>) {
+						formatted.append("NULL");
+					} else if constexpr (std::is_same_v<Value, std::string_view>) {
+						formatted.append(escapeBlob(value.data(), static_cast<uint32_t>(value.size())));
+					} else if constexpr (std::is_same_v<Value, DBBlob>) {
+						formatted.append(escapeBlob(value.data.data(), static_cast<uint32_t>(value.data.size())));
+					} else {
+						formatted.append(fmt::format("{}", value));
+					}
+				},
+				(param++)->value
+			);
+			continue;
+		}
+		formatted.push_back(c);
+	}
+	return formatted;
+}
+
 std::string Database::escapeString(const std::string &s) const {
 	std::string::size_type len = s.length();
 	auto length = static_cast<uint32_t>(len);
@@ -198,8 +556,17 @@ DBResult::DBResult(MYSQL_RES* res) {
 	row = mysql_fetch_row(handle);
 }
 
+DBResult::DBResult(std::vector<std::string> columnNames, std::vector<std::vector<DBValue>> rows) :
+	handle(nullptr), row(nullptr), statementColumns(std::move(columnNames)), statementRows(std::move(rows)) {
+	for (size_t i = 0; i < statementColumns.size(); i++) {
+		listNames[statementColumns[i]] = i;
+	}
+}
+
 DBResult::~DBResult() {
-	mysql_free_result(handle);
+	if (handle) {
+		mysql_free_result(handle);
+	}
 }
 
 std::string DBResult::getString(const std::string &s) const {
@@ -208,6 +575,22 @@ std::string DBResult::getString(const std::string &s) const {
 		g_logger().error("Column '{}' does not exist in result set", s);
 		return std::string();
 	}
+	if (!handle) {
+		const DBValue &value = statementRows[statementRow][it->second];
+		if (const auto* text = std::get_if<std::string>(&value)) {
+			return *text;
+		}
+		return std::visit(
+			[](const auto &number) -> std::string {
+				if constexpr (std::is_arithmetic_v<std::decay_t<decltype(number)>>) {
+					return std::to_string(number);
+				} else {
+					return std::string();
+				}
+			},
+			value
+		);
+	}
 	if (row[it->second] == nullptr) {
 		return std::string();
 	}
@@ -222,6 +605,12 @@ const char* DBResult::getStream(const std::string &s, unsigned long &size) const
 		return nullptr;
 	}
 
+	if (!handle) {
+		const auto* bytes = std::get_if<std::string>(&statementRows[statementRow][it->second]);
+		size = bytes ? bytes->size() : 0;
+		return bytes ? bytes->data() : nullptr;
+	}
+
 	if (row[it->second] == nullptr) {
 		size = 0;
 		return nullptr;
@@ -252,17 +641,22 @@ int8_t DBResult::getInt8FromString(const std::string &string, const std::string
 }
 
 size_t DBResult::countResults() const {
+	if (!handle) {
+		return statementRows.size();
+	}
 	return static_cast<size_t>(mysql_num_rows(handle));
 }
 
 bool DBResult::hasNext() const {
+	if (!handle) {
+		return statementRow < statementRows.size();
+	}
 	return row != nullptr;
 }
 
 bool DBResult::next() {
 	if (!handle) {
-		g_logger().error("Database not initialized!");
-		return false;
+		return ++statementRow < statementRows.size();
 	}
 	row = mysql_fetch_row(handle);
 	return row != nullptr;
@@ -270,30 +664,27 @@ bool DBResult::next() {
 
 DBInsert::DBInsert(std::string insertQuery) :
 	query(std::move(insertQuery)) {
-	this->length = this->query.length();
+	const auto maxPacketSize = static_cast<size_t>(Database::getInstance().getMaxPacketSize());
+	const auto configuredLimit = static_cast<size_t>(std::max<int32_t>(1024, g_configManager().getNumber(DATABASE_INSERT_BATCH_SIZE)));
+	batchLimit = std::min(configuredLimit, maxPacketSize);
 }
 
 bool DBInsert::addRow(std::string_view row) {
-	const size_t rowLength = row.length();
-	length += rowLength;
-	auto max_packet_size = Database::getInstance().getMaxPacketSize();
-
-	if (length > max_packet_size && !execute()) {
+	// The query and the upsert clause are part of the packet too
+	const size_t queryLength = query.length() + upsertClause.length() + 1;
+	if (!values.empty() && queryLength + values.length() + row.length() + 3 > batchLimit && !execute()) {
 		return false;
 	}
 
 	if (values.empty()) {
-		values.reserve(rowLength + 2);
-		values.push_back('(');
-		values.append(row);
-		values.push_back(')');
+		// Grows geometrically from here instead of reallocating on every row
+		values.reserve(std::min<size_t>(batchLimit, 16 * 1024));
 	} else {
-		values.reserve(values.length() + rowLength + 3);
 		values.push_back(',');
-		values.push_back('(');
-		values.append(row);
-		values.push_back(')');
 	}
+	values.push_back('(');
+	values.append(row);
+	values.push_back(')');
 	return true;
 }
 
@@ -304,7 +695,11 @@ bool DBInsert::addRow(std::ostringstream &row) {
 }
 
 void DBInsert::upsert(const std::vector<std::string> &columns) {
-	upsertColumns = columns;
+	upsertClause.clear();
+	for (size_t i = 0; i < columns.size(); ++i) {
+		upsertClause.append(i == 0 ? " ON DUPLICATE KEY UPDATE " : ", ");
+		upsertClause.append(fmt::format("`{0}` = VALUES(`{0}`)", columns[i]));
+	}
 }
 
 bool DBInsert::execute() {
@@ -312,17 +707,91 @@ bool DBInsert::execute() {
 		return true;
 	}
 
-	std::ostringstream query;
-	query << this->query << " " << values;
+	std::string statement;
+	statement.reserve(query.length() + values.length() + upsertClause.length() + 1);
+	statement.append(query);
+	statement.push_back(' ');
+	statement.append(values);
+	statement.append(upsertClause);
 
-	if (!upsertColumns.empty()) {
-		query << " ON DUPLICATE KEY UPDATE ";
-		for (size_t i = 0; i < upsertColumns.size(); ++i) {
-			query << "`" << upsertColumns[i] << "` = VALUES(`" << upsertColumns[i] << "`)";
-			if (i < upsertColumns.size() - 1) {
-				query << ", ";
-			}
-		}
+	// The batch is sent either way, a failed one must not be resent with the next rows
+	values.clear();
+	return Database::getInstance().executeQuery(statement);
+}
+
+namespace {
+	thread_local DBWriteCapture* activeCapture = nullptr;
+	thread_local DBPrefetch* activePrefetch = nullptr;
+}
+
+DBPrefetch::DBPrefetch(Results results) :
+	results(std::move(results)), previous(activePrefetch) {
+	activePrefetch = this;
+}
+
+DBPrefetch::~DBPrefetch() {
+	activePrefetch = previous;
+}
+
+DBPrefetch::Results DBPrefetch::fetch(const std::vector<std::string> &queries) {
+	Results fetched;
+	auto results = Database::getInstance().storeQueries(queries);
+	for (size_t i = 0; i < results.size(); ++i) {
+		fetched.try_emplace(queries[i], std::move(results[i]));
+	}
+	return fetched;
+}
+
+DBPrefetch* DBPrefetch::getActive() {
+	return activePrefetch;
+}
+
+std::optional<DBResult_ptr> DBPrefetch::take(std::string_view query) {
+	auto it = results.find(query);
+	if (it == results.end()) {
+		return std::nullopt;
+	}
+
+	auto result = std::move(it->second);
+	results.erase(it);
+	return result;
+}
+
+DBWriteCapture::DBWriteCapture() :
+	previous(activeCapture) {
+	activeCapture = this;
+}
+
+DBWriteCapture::~DBWriteCapture() {
+	activeCapture = previous;
+}
+
+DBWriteCapture* DBWriteCapture::getActive() {
+	return activeCapture;
+}
+
+void DBWriteCapture::record(std::string_view query) {
+	if (!inTransaction) {
+		writes.emplace_back(DBWrite { key, {}, false });
+	}
+	writes.back().queries.emplace_back(query);
+}
+
+void DBWriteCapture::beginTransaction() {
+	writes.emplace_back(DBWrite { key, {}, true });
+	inTransaction = true;
+}
+
+void DBWriteCapture::commit() {
+	if (inTransaction && writes.back().queries.empty()) {
+		writes.pop_back();
+	}
+	inTransaction = false;
+}
+
+void DBWriteCapture::rollback() {
+	if (inTransaction) {
+		writes.pop_back();
 	}
-	return Database::getInstance().executeQuery(query.str());
+	inTransaction = false;
 }
@@ -14,6 +14,49 @@
 
 class DBResult;
 using DBResult_ptr = std::shared_ptr<DBResult>;
+class DBWriteCapture;
+
+// Value of a column read through a prepared statement
+using DBValue = std::variant<std::monostate, int64_t, uint64_t, double, std::string>;
+
+// Binary parameter of a prepared statement, e.g. serialized item attributes
+struct DBBlob {
+	std::string_view data;
+};
+
+/**
+ * Parameter of a prepared statement. Holds a view for text and BLOBs,
+ * so the bound data must outlive the call.
+ */
+class DBParam {
+public:
+	DBParam(std::nullptr_t) { }
+	template <typename T>
+		requires std::is_integral_v<T>
+	DBParam(T number) {
+		if constexpr (std::is_signed_v<T> || std::is_same_v<T, bool>) {
+			value = static_cast<int64_t>(number);
+		} else {
+			value = static_cast<uint64_t>(number);
+		}
+	}
+	template <typename T>
+		requires std::is_enum_v<T>
+	DBParam(T enumValue) :
+		DBParam(magic_enum::enum_integer(enumValue)) { }
+	DBParam(double number) :
+		value(number) { }
+	DBParam(std::string_view text) :
+		value(text) { }
+	DBParam(const std::string &text) :
+		value(std::string_view(text)) { }
+	DBParam(const char* text) :
+		value(std::string_view(text)) { }
+	DBParam(DBBlob blob) :
+		value(blob) { }
+
+	std::variant<std::nullptr_t, int64_t, uint64_t, double, std::string_view, DBBlob> value = nullptr;
+};
 
 class Database {
 public:
@@ -34,6 +77,23 @@ public:
 	bool executeQuery(const std::string_view &query);
 
 	DBResult_ptr storeQuery(const std::string_view &query);
+	/**
+	 * Sends the queries in one multi-statement round trip and returns their
+	 * results in the same order, nullptr for the ones without rows. Returns
+	 * an empty vector when any of them failed.
+	 */
+	std::vector<DBResult_ptr> storeQueries(const std::vector<std::string> &queries);
+
+	/**
+	 * Prepared statements, cached per connection by their SQL. Parameters
+	 * ('?' in the query) are bound with their type and the rows come back
+	 * typed, so neither side goes through text conversion or escaping.
+	 * Under a DBWriteCapture executeStatement is recorded as a plain query.
+	 */
+	bool executeStatement(std::string_view query, std::initializer_list<DBParam> params);
+	DBResult_ptr storeStatement(std::string_view query, std::initializer_list<DBParam> params);
+	// Text form of a statement, for the paths that only take queries
+	std::string formatStatement(std::string_view query, std::initializer_list<DBParam> params) const;
 
 	std::string escapeString(const std::string &s) const;
 
@@ -60,16 +120,107 @@ private:
 		return error == CR_SERVER_LOST || error == CR_SERVER_GONE_ERROR || error == CR_CONN_HOST_ERROR || error == 1053 /*ER_SERVER_SHUTDOWN*/ || error == CR_CONNECTION_ERROR;
 	}
 
+	// Binds and runs a cached statement, preparing it again when a reconnect dropped it
+	MYSQL_STMT* runStatement(std::string_view query, std::initializer_list<DBParam> params);
+	MYSQL_STMT* getStatement(std::string_view query);
+	void dropStatement(std::string_view query);
+
 	MYSQL* handle = nullptr;
 	std::recursive_mutex databaseLock;
 	uint64_t maxPacketSize = 1048576;
+	std::map<std::string, MYSQL_STMT*, std::less<>> statements;
 
 	friend class DBTransaction;
 };
 
+// A write recorded by DBWriteCapture: a single query, or the queries of one transaction
+struct DBWrite {
+	// Owner of the rows written, see DatabaseTasks::cancelWrites
+	std::string key;
+	std::vector<std::string> queries;
+	bool transaction = false;
+	// Snapshots can be dropped for a newer one, writes that move items or money must land
+	bool cancelable = true;
+};
+
+/**
+ * While alive, the writes the calling thread sends to the database are
+ * recorded instead of run: executeQuery, DBInsert and transactions are
+ * captured, reads still go to the server. The recorded queries are a
+ * snapshot a database thread can write later, see DatabaseTasks::enqueueWrites.
+ */
+class DBWriteCapture {
+public:
+	DBWriteCapture();
+	~DBWriteCapture();
+
+	// Ensures that we don't accidentally copy it
+	DBWriteCapture(const DBWriteCapture &) = delete;
+	DBWriteCapture &operator=(const DBWriteCapture &) = delete;
+
+	// The capture of the calling thread, nullptr when its writes run right away
+	static DBWriteCapture* getActive();
+
+	// Key of the writes recorded from now on
+	void setKey(std::string newKey) {
+		key = std::move(newKey);
+	}
+
+	std::vector<DBWrite> takeWrites() {
+		return std::move(writes);
+	}
+
+private:
+	void record(std::string_view query);
+	void beginTransaction();
+	void commit();
+	void rollback();
+
+	std::vector<DBWrite> writes;
+	std::string key;
+	bool inTransaction = false;
+	DBWriteCapture* previous;
+
+	friend class Database;
+};
+
+/**
+ * Results read ahead of time, keyed by their query text (statements by
+ * Database::formatStatement). While alive, a matching storeQuery or
+ * storeStatement of the calling thread is answered from it, once, instead
+ * of going to the server.
+ */
+class DBPrefetch {
+public:
+	using Results = phmap::flat_hash_map<std::string, DBResult_ptr>;
+
+	explicit DBPrefetch(Results results);
+	~DBPrefetch();
+
+	// Ensures that we don't accidentally copy it
+	DBPrefetch(const DBPrefetch &) = delete;
+	DBPrefetch &operator=(const DBPrefetch &) = delete;
+
+	// Reads the queries in one round trip, empty when it failed
+	static Results fetch(const std::vector<std::string> &queries);
+
+	static DBPrefetch* getActive();
+
+private:
+	// nullopt when the query was not read ahead, or was already answered
+	std::optional<DBResult_ptr> take(std::string_view query);
+
+	Results results;
+	DBPrefetch* previous;
+
+	friend class Database;
+};
+
 class DBResult {
 public:
 	explicit DBResult(MYSQL_RES* res);
+	// Rows fetched from a prepared statement
+	DBResult(std::vector<std::string> columnNames, std::vector<std::vector<DBValue>> rows);
 	~DBResult();
 
 	// Non copyable
@@ -84,6 +235,10 @@ public:
 			return T();
 		}
 
+		if (!handle) {
+			return getValueNumber<T>(s, statementRows[statementRow][it->second]);
+		}
+
 		if (row[it->second] == nullptr) {
 			return T();
 		}
@@ -150,16 +305,48 @@ public:
 	bool next();
 
 private:
+	template <typename T>
+	T getValueNumber(const std::string &s, const DBValue &value) const {
+		if (const auto* text = std::get_if<std::string>(&value)) {
+			// DECIMAL and the like arrive as text
+			std::conditional_t<std::is_same_v<T, bool>, int, T> data {};
+			if (std::from_chars(text->data(), text->data() + text->size(), data).ec != std::errc()) {
+				g_logger().error("Column '{}' has an invalid value set", s);
+				return T();
+			}
+			return static_cast<T>(data);
+		}
+
+		return std::visit(
+			[](const auto &number) -> T {
+				if constexpr (std::is_arithmetic_v<std::decay_t<decltype(number)>>) {
+					return static_cast<T>(number);
+				} else {
+					return T();
+				}
+			},
+			value
+		);
+	}
+
 	MYSQL_RES* handle;
 	MYSQL_ROW row;
 
 	std::map<std::string_view, size_t> listNames;
 
+	// Set instead of handle for prepared statement results
+	std::vector<std::string> statementColumns;
+	std::vector<std::vector<DBValue>> statementRows;
+	size_t statementRow = 0;
+
 	friend class Database;
 };
 
 /**
- * INSERT statement.
+ * Multi-row INSERT statement.
+ * Rows are batched into one query, which is sent whenever the next row
+ * would take it past databaseInsertBatchSize (or max_allowed_packet), so
+ * a big rewrite runs as a few bounded queries instead of one huge one.
  */
 class DBInsert {
 public:
@@ -167,13 +354,14 @@ public:
 	void upsert(const std::vector<std::string> &columns);
 	bool addRow(const std::string_view row);
 	bool addRow(std::ostringstream &row);
+	// Sends the rows batched so far, if any
 	bool execute();
 
 private:
-	std::vector<std::string> upsertColumns;
 	std::string query;
+	std::string upsertClause;
 	std::string values;
-	size_t length;
+	size_t batchLimit;
 };
 
 class DBTransaction {
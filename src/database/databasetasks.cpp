@@ -9,33 +9,223 @@
 
 #include "pch.hpp"
 
+#include "config/configmanager.hpp"
 #include "database/databasetasks.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "lib/thread/thread_pool.hpp"
 #include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
+
+namespace {
+	const std::vector<uint64_t> QUERY_LATENCY_BUCKETS = { 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 1000000 };
+
+	MetricHistogram &getQueryLatency(std::string_view kind) {
+		return g_metrics().getHistogram(
+			"canary_database_query_seconds", "Time the asynchronous database queries took, by kind",
+			QUERY_LATENCY_BUCKETS, 1e6, fmt::format("kind=\"{}\"", kind)
+		);
+	}
+
+	uint64_t getElapsedUs(std::chrono::steady_clock::time_point since) {
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - since).count();
+	}
+}
 
 DatabaseTasks::DatabaseTasks(ThreadPool &threadPool, Database &db) :
-	db(db), threadPool(threadPool) {
+	db(db), threadPool(threadPool),
+	executeLatency(getQueryLatency("execute")), storeLatency(getQueryLatency("store")), writeLatency(getQueryLatency("write")) {
 }
 
 DatabaseTasks &DatabaseTasks::getInstance() {
 	return inject<DatabaseTasks>();
 }
 
-void DatabaseTasks::execute(const std::string &query, std::function<void(DBResult_ptr, bool)> callback /* nullptr */) {
-	threadPool.addLoad([this, query, callback]() {
-		bool success = db.executeQuery(query);
+bool DatabaseTasks::connectPool() {
+	const auto &user = g_configManager().getString(MYSQL_USER);
+	const auto &password = g_configManager().getString(MYSQL_PASS);
+	const auto &database = g_configManager().getString(MYSQL_DB);
+	const auto &socket = g_configManager().getString(MYSQL_SOCK);
+	const auto connect = [&](std::vector<std::unique_ptr<PoolConnection>> &connections, const std::string &host, uint32_t port) {
+		const auto size = std::max<int32_t>(0, g_configManager().getNumber(DATABASE_POOL_SIZE));
+		for (int32_t i = 0; i < size; ++i) {
+			auto connection = std::make_unique<PoolConnection>();
+			if (!connection->db.connect(&host, &user, &password, &database, port, &socket)) {
+				return false;
+			}
+			connections.emplace_back(std::move(connection));
+		}
+		return true;
+	};
+
+	if (!connect(writeConnections, g_configManager().getString(MYSQL_HOST), g_configManager().getNumber(SQL_PORT))) {
+		g_logger().error("[{}] Failed to open the database pool connections", __FUNCTION__);
+		return false;
+	}
+
+	const auto &replicaHost = g_configManager().getString(MYSQL_REPLICA_HOST);
+	if (!replicaHost.empty() && !connect(readConnections, replicaHost, g_configManager().getNumber(SQL_REPLICA_PORT))) {
+		g_logger().error("[{}] Failed to open the read replica connections", __FUNCTION__);
+		return false;
+	}
+	return true;
+}
+
+DatabaseTasks::PoolConnection* DatabaseTasks::getConnection(bool read, uint32_t orderKey) {
+	// Keyed reads stay with the writes of the same key, so they see them
+	const auto &connections = read && orderKey == 0 && !readConnections.empty() ? readConnections : writeConnections;
+	if (connections.empty()) {
+		return nullptr;
+	}
+
+	const uint32_t index = orderKey != 0 ? orderKey : nextConnection.fetch_add(1, std::memory_order_relaxed);
+	return connections[index % connections.size()].get();
+}
+
+void DatabaseTasks::post(PoolConnection* connection, std::function<void(Database &)> &&task) {
+	if (!connection) {
+		startPoolTask();
+		threadPool.addBlockingLoad([this, task = std::move(task)]() {
+			task(db);
+			finishPoolTask();
+		});
+		return;
+	}
+
+	std::scoped_lock lock(connection->queueMutex);
+	connection->queue.emplace_back(std::move(task));
+	if (!connection->running) {
+		connection->running = true;
+		startPoolTask();
+		threadPool.addBlockingLoad([this, connection]() { runConnection(*connection); });
+	}
+}
+
+void DatabaseTasks::startPoolTask() {
+	std::scoped_lock lock(poolMutex);
+	++poolTasks;
+}
+
+void DatabaseTasks::finishPoolTask() {
+	std::scoped_lock lock(poolMutex);
+	if (--poolTasks == 0) {
+		poolCondition.notify_all();
+	}
+}
+
+void DatabaseTasks::runConnection(PoolConnection &connection) {
+	std::unique_lock lock(connection.queueMutex);
+	while (!connection.queue.empty()) {
+		auto task = std::move(connection.queue.front());
+		connection.queue.pop_front();
+		lock.unlock();
+		task(connection.db);
+		lock.lock();
+	}
+	connection.running = false;
+	lock.unlock();
+	finishPoolTask();
+}
+
+void DatabaseTasks::execute(const std::string &query, std::function<void(DBResult_ptr, bool)> callback /* nullptr */, uint32_t orderKey /* 0 */) {
+	post(getConnection(false, orderKey), [this, query, callback](Database &connection) {
+		const auto startedAt = std::chrono::steady_clock::now();
+		bool success = connection.executeQuery(query);
+		executeLatency.observe(getElapsedUs(startedAt));
 		if (callback != nullptr) {
 			g_dispatcher().addTask([callback, success]() { callback(nullptr, success); }, "DatabaseTasks::execute");
 		}
 	});
 }
 
-void DatabaseTasks::store(const std::string &query, std::function<void(DBResult_ptr, bool)> callback /* nullptr */) {
-	threadPool.addLoad([this, query, callback]() {
-		DBResult_ptr result = db.storeQuery(query);
+void DatabaseTasks::store(const std::string &query, std::function<void(DBResult_ptr, bool)> callback /* nullptr */, uint32_t orderKey /* 0 */) {
+	post(getConnection(true, orderKey), [this, query, callback](Database &connection) {
+		const auto startedAt = std::chrono::steady_clock::now();
+		DBResult_ptr result = connection.storeQuery(query);
+		storeLatency.observe(getElapsedUs(startedAt));
 		if (callback != nullptr) {
 			g_dispatcher().addTask([callback, result]() { callback(result, true); }, "DatabaseTasks::store");
 		}
 	});
 }
+
+void DatabaseTasks::enqueueWrites(std::vector<DBWrite> &&writes) {
+	if (writes.empty()) {
+		return;
+	}
+
+	std::scoped_lock lock(writesMutex);
+	std::ranges::move(writes, std::back_inserter(pendingWrites));
+
+	if (!writing) {
+		writing = true;
+		threadPool.addBlockingLoad([this]() { runWrites(); });
+	}
+}
+
+bool DatabaseTasks::cancelWrites(const std::string &key) {
+	std::unique_lock lock(writesMutex);
+	const auto dropped = std::erase_if(pendingWrites, [&key](const DBWrite &pending) {
+		return pending.key == key && pending.cancelable;
+	});
+	writesCondition.wait(lock, [this, &key]() {
+		const bool running = runningWriteKey && (*runningWriteKey == key || !runningWriteCancelable);
+		return !running && std::ranges::all_of(pendingWrites, &DBWrite::cancelable);
+	});
+	return failedWriteKeys.erase(key) > 0 || dropped > 0;
+}
+
+bool DatabaseTasks::takeFailedWrites(const std::string &key) {
+	std::scoped_lock lock(writesMutex);
+	return failedWriteKeys.erase(key) > 0;
+}
+
+void DatabaseTasks::flushWrites() {
+	std::unique_lock lock(writesMutex);
+	writesCondition.wait(lock, [this]() { return !writing; });
+}
+
+void DatabaseTasks::flushPool() {
+	std::unique_lock lock(poolMutex);
+	poolCondition.wait(lock, [this]() { return poolTasks == 0; });
+}
+
+void DatabaseTasks::runWrites() {
+	std::unique_lock lock(writesMutex);
+	while (!pendingWrites.empty()) {
+		DBWrite write = std::move(pendingWrites.front());
+		pendingWrites.pop_front();
+		runningWriteKey = write.key;
+		runningWriteCancelable = write.cancelable;
+		lock.unlock();
+
+		const auto startedAt = std::chrono::steady_clock::now();
+		const bool success = executeWrite(write);
+		writeLatency.observe(getElapsedUs(startedAt));
+		if (!success) {
+			g_logger().error("[{}] Failed to write {}", __FUNCTION__, write.key.empty() ? write.queries.front().substr(0, 64) : write.key);
+		}
+
+		lock.lock();
+		if (!success && !write.key.empty()) {
+			failedWriteKeys.emplace(write.key);
+		}
+		runningWriteKey.reset();
+		writesCondition.notify_all();
+	}
+
+	writing = false;
+	writesCondition.notify_all();
+}
+
+bool DatabaseTasks::executeWrite(const DBWrite &write) {
+	const auto executeQueries = [this, &write]() {
+		return std::ranges::all_of(write.queries, [this](const std::string &query) {
+			return db.executeQuery(query);
+		});
+	};
+
+	if (!write.transaction) {
+		return executeQueries();
+	}
+	return DBTransaction::executeWithinTransaction(executeQueries);
+}
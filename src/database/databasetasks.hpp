@@ -12,6 +12,8 @@
 #include "database/database.hpp"
 #include "lib/thread/thread_pool.hpp"
 
+class MetricHistogram;
+
 class DatabaseTasks {
 public:
 	DatabaseTasks(ThreadPool &threadPool, Database &db);
@@ -22,12 +24,77 @@ public:
 
 	static DatabaseTasks &getInstance();
 
-	void execute(const std::string &query, std::function<void(DBResult_ptr, bool)> callback = nullptr);
-	void store(const std::string &query, std::function<void(DBResult_ptr, bool)> callback = nullptr);
+	// Opens the databasePoolSize connections, and as many to the read replica when one is set
+	bool connectPool();
+
+	/**
+	 * Queries run on the pool, one at a time per connection. Queries with the
+	 * same non-zero orderKey (a player or account id) go to the same
+	 * connection, so they run in the order they were issued. Stores without
+	 * a key are sent to the read replica when there is one.
+	 */
+	void execute(const std::string &query, std::function<void(DBResult_ptr, bool)> callback = nullptr, uint32_t orderKey = 0);
+	void store(const std::string &query, std::function<void(DBResult_ptr, bool)> callback = nullptr, uint32_t orderKey = 0);
+
+	// Runs captured writes in order on a blocking thread
+	void enqueueWrites(std::vector<DBWrite> &&writes);
+	/**
+	 * Drops the pending writes of the key and waits for the one running, so a
+	 * write run right away is not overwritten. Writes that are not cancelable
+	 * are waited for, whatever their key, so they land before it. Returns true
+	 * when a dropped or failed write means the database may be behind what the
+	 * caller last saved.
+	 */
+	bool cancelWrites(const std::string &key);
+	// Returns true, once, when a write of the key failed since the last call
+	bool takeFailedWrites(const std::string &key);
+	// Waits until every enqueued write ran
+	void flushWrites();
+	// Waits until every query sent to the pool ran, before the thread pool stops
+	void flushPool();
 
 private:
+	struct PoolConnection {
+		Database db;
+		std::mutex queueMutex;
+		std::deque<std::function<void(Database &)>> queue;
+		bool running = false;
+	};
+
+	// nullptr when the pool is empty and the query should use the main connection
+	PoolConnection* getConnection(bool read, uint32_t orderKey);
+	void post(PoolConnection* connection, std::function<void(Database &)> &&task);
+	void runConnection(PoolConnection &connection);
+	void startPoolTask();
+	void finishPoolTask();
+
+	void runWrites();
+	bool executeWrite(const DBWrite &write);
+
 	Database &db;
 	ThreadPool &threadPool;
+
+	// Time a query took on its connection, in microseconds
+	MetricHistogram &executeLatency;
+	MetricHistogram &storeLatency;
+	MetricHistogram &writeLatency;
+
+	std::vector<std::unique_ptr<PoolConnection>> writeConnections;
+	std::vector<std::unique_ptr<PoolConnection>> readConnections;
+	std::atomic<uint32_t> nextConnection = 0;
+
+	// Pool connections draining their queue plus queries run without a connection
+	std::mutex poolMutex;
+	std::condition_variable poolCondition;
+	uint32_t poolTasks = 0;
+
+	std::mutex writesMutex;
+	std::condition_variable writesCondition;
+	std::deque<DBWrite> pendingWrites;
+	std::optional<std::string> runningWriteKey;
+	bool runningWriteCancelable = true;
+	phmap::flat_hash_set<std::string> failedWriteKeys;
+	bool writing = false;
 };
 
 constexpr auto g_databaseTasks = DatabaseTasks::getInstance;
@@ -95,23 +95,50 @@ bool Bank::transferTo(const std::shared_ptr<Bank> destination, uint64_t amount)
 		g_logger().error("Bank::transferTo: destinationBankable is nullptr");
 		return false;
 	}
-	if (destinationBankable->getPlayer() != nullptr) {
-		auto player = bankable->getPlayer();
-		auto name = asLowerCaseString(player->getName());
-		replaceString(name, " ", "");
-		if (deniedNames.contains(name)) {
-			g_logger().warn("Bank::transferTo: denied name: {}", name);
-			return false;
-		}
-		if (player->getTown()->getID() < minTownId) {
-			g_logger().warn("Bank::transferTo: denied town: {}", player->getTown()->getID());
-			return false;
-		}
+	if (destinationBankable->getPlayer() != nullptr && !canTransferToPlayer()) {
+		return false;
 	}
 
 	return debit(amount) && destination->credit(amount);
 }
 
+bool Bank::transferToOffline(uint32_t guid, uint64_t amount) {
+	auto bankable = getBankable();
+	if (!bankable) {
+		g_logger().error("Bank::transferToOffline: bankable is nullptr");
+		return false;
+	}
+	if (!canTransferToPlayer() || !debit(amount)) {
+		return false;
+	}
+
+	IOLoginData::increaseBankBalance(guid, amount, [bankable, amount](bool success) {
+		if (!success) {
+			std::make_shared<Bank>(bankable)->credit(amount);
+		}
+	});
+	return true;
+}
+
+bool Bank::canTransferToPlayer() const {
+	auto player = getBankable()->getPlayer();
+	if (!player) {
+		return true;
+	}
+
+	auto name = asLowerCaseString(player->getName());
+	replaceString(name, " ", "");
+	if (deniedNames.contains(name)) {
+		g_logger().warn("Bank::transferTo: denied name: {}", name);
+		return false;
+	}
+	if (player->getTown()->getID() < minTownId) {
+		g_logger().warn("Bank::transferTo: denied town: {}", player->getTown()->getID());
+		return false;
+	}
+	return true;
+}
+
 bool Bank::withdraw(std::shared_ptr<Player> player, uint64_t amount) {
 	if (!debit(amount)) {
 		return false;
@@ -43,6 +43,8 @@ public:
 	uint64_t balance();
 	bool hasBalance(uint64_t amount);
 	bool transferTo(const std::shared_ptr<Bank> destination, uint64_t amount);
+	// Credits an offline player through the bank ledger instead of loading them, refunded if the write fails
+	bool transferToOffline(uint32_t guid, uint64_t amount);
 	bool withdraw(std::shared_ptr<Player> player, uint64_t amount);
 	bool deposit(const std::shared_ptr<Bank> destination);
 	bool deposit(const std::shared_ptr<Bank> destination, uint64_t amount);
@@ -51,5 +53,6 @@ private:
 	std::shared_ptr<Bankable> getBankable() const {
 		return m_bankable;
 	}
+	bool canTransferToPlayer() const;
 	std::shared_ptr<Bankable> m_bankable;
 };
@@ -18,6 +18,10 @@
 #include "lua/modules/modules.hpp"
 #include "lua/scripts/scripts.hpp"
 #include "game/zones/zone.hpp"
+#include "io/ioprey.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "game/scheduling/scheduler.hpp"
+#include "lib/thread/thread_pool.hpp"
 
 GameReload::GameReload() = default;
 GameReload::~GameReload() = default;
@@ -61,6 +65,76 @@ uint8_t GameReload::getReloadNumber(Reload_t reloadTypes) const {
 	return magic_enum::enum_integer(reloadTypes);
 }
 
+void GameReload::startScriptsWatcher() {
+	if (g_configManager().getNumber(SCRIPTS_HOT_RELOAD_INTERVAL) <= 0) {
+		return;
+	}
+
+	inject<ThreadPool>().addBlockingLoad([this] { scanScripts(); });
+}
+
+void GameReload::scanScripts() {
+	const auto datapackFolder = g_configManager().getString(DATA_DIRECTORY);
+	const auto coreFolder = g_configManager().getString(CORE_DIRECTORY);
+
+	// Same files and paths as Scripts::loadScripts, the events are tagged with the path it loaded
+	std::map<std::filesystem::path, std::filesystem::file_time_type> writeTimes;
+	for (const auto &folder : { datapackFolder + "/scripts", coreFolder + "/scripts" }) {
+		std::error_code error;
+		const auto dir = std::filesystem::current_path() / folder;
+		for (auto it = std::filesystem::recursive_directory_iterator(dir, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+			const auto &path = it->path();
+			const auto fileFolder = path.parent_path().filename().string();
+			if (!it->is_regular_file(error) || path.extension() != ".lua" || path.filename().string().front() == '#' || fileFolder == "lib" || fileFolder == "events") {
+				continue;
+			}
+
+			const auto writeTime = it->last_write_time(error);
+			if (!error) {
+				writeTimes.emplace(path, writeTime);
+			}
+		}
+	}
+
+	std::vector<std::filesystem::path> changedFiles;
+	if (scriptsScanned) {
+		for (const auto &[path, writeTime] : writeTimes) {
+			if (auto it = scriptsWriteTimes.find(path); it == scriptsWriteTimes.end() || it->second != writeTime) {
+				changedFiles.emplace_back(path);
+			}
+		}
+		for (const auto &[path, writeTime] : scriptsWriteTimes) {
+			if (!writeTimes.contains(path)) {
+				changedFiles.emplace_back(path);
+			}
+		}
+	}
+	scriptsWriteTimes = std::move(writeTimes);
+	scriptsScanned = true;
+
+	g_dispatcher().addTask(
+		[this, changedFiles = std::move(changedFiles)] {
+			for (const auto &file : changedFiles) {
+				g_scripts().reloadScriptFile(file);
+			}
+
+			// A config reload may have turned it off
+			const auto interval = g_configManager().getNumber(SCRIPTS_HOT_RELOAD_INTERVAL);
+			if (interval <= 0) {
+				scriptsScanned = false;
+				return;
+			}
+
+			g_scheduler().addEvent(
+				static_cast<uint32_t>(interval),
+				[this] { inject<ThreadPool>().addBlockingLoad([this] { scanScripts(); }); },
+				"GameReload::scanScripts"
+			);
+		},
+		"GameReload::reloadScriptFiles"
+	);
+}
+
 /*
  * From here down have the private members functions
  * These should only be used within the class itself
@@ -130,6 +204,7 @@ bool GameReload::reloadMonsters() const {
 	}
 
 	if (g_scripts().loadScripts(datapackFolder + "/monster", false, true) && g_scripts().loadScripts(datapackFolder + "/scripts/lib", true, true)) {
+		g_ioprey().initializeMonsterPools();
 		return true;
 	}
 	return false;
@@ -50,7 +50,16 @@ public:
 	bool init(Reload_t reloadType) const;
 	uint8_t getReloadNumber(Reload_t reloadTypes) const;
 
+	/**
+	 * Starts polling the datapack and core scripts folders every
+	 * scriptsHotReloadInterval ms. The folders are scanned on a blocking
+	 * thread, only the changed files are then reloaded on the game thread.
+	 */
+	void startScriptsWatcher();
+
 private:
+	void scanScripts();
+
 	bool reloadAll() const;
 	bool reloadChat() const;
 	bool reloadConfig() const;
@@ -66,6 +75,10 @@ private:
 	bool reloadScripts() const;
 	bool reloadTalkaction() const;
 	bool reloadGroups() const;
+
+	// Only the scan job touches it, the next scan is scheduled once the previous one reloaded its files
+	std::map<std::filesystem::path, std::filesystem::file_time_type> scriptsWriteTimes;
+	bool scriptsScanned = false;
 };
 
 constexpr auto g_gameReload = GameReload::getInstance;
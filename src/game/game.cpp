@@ -20,10 +20,13 @@
 #include "game/game.hpp"
 #include "game/functions/game_reload.hpp"
 #include "game/zones/zone.hpp"
+#include "map/spectators.hpp"
 #include "lua/global/globalevent.hpp"
 #include "io/iologindata.hpp"
 #include "io/io_wheel.hpp"
 #include "io/iomarket.hpp"
+#include "io/iohighscores.hpp"
+#include "io/worldsnapshot.hpp"
 #include "items/items.hpp"
 #include "lua/scripts/lua_environment.hpp"
 #include "creatures/monsters/monster.hpp"
@@ -31,6 +34,8 @@
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/scheduler.hpp"
 #include "server/server.hpp"
+#include "server/cluster/cluster_bus.hpp"
+#include "server/network/message/outputmessage.hpp"
 #include "creatures/combat/spells.hpp"
 #include "lua/creature/talkaction.hpp"
 #include "items/weapons/weapons.hpp"
@@ -47,6 +52,8 @@
 #include "server/network/protocol/protocolstatus.hpp"
 
 #include "kv/kv.hpp"
+#include "lib/profiling/allocation_profiler.hpp"
+#include "lib/profiling/profiler.hpp"
 
 namespace InternalGame {
 	void sendBlockEffect(BlockType_t blockType, CombatType_t combatType, const Position &targetPos, std::shared_ptr<Creature> source) {
@@ -278,14 +285,21 @@ void Game::loadBoostedCreature() {
 }
 
 void Game::start(ServiceManager* manager) {
-	// Game client protocols
-	manager->add<ProtocolGame>(static_cast<uint16_t>(g_configManager().getNumber(GAME_PORT)));
-	manager->add<ProtocolLogin>(static_cast<uint16_t>(g_configManager().getNumber(LOGIN_PORT)));
-	// OT protocols
-	manager->add<ProtocolStatus>(static_cast<uint16_t>(g_configManager().getNumber(STATUS_PORT)));
+	// A replay feeds recorded sessions instead of clients
+	if (g_configManager().getString(SESSION_REPLAY).empty()) {
+		// Game client protocols
+		manager->add<ProtocolGame>(static_cast<uint16_t>(g_configManager().getNumber(GAME_PORT)));
+		manager->add<ProtocolLogin>(static_cast<uint16_t>(g_configManager().getNumber(LOGIN_PORT)));
+		// OT protocols
+		manager->add<ProtocolStatus>(static_cast<uint16_t>(g_configManager().getNumber(STATUS_PORT)));
+	}
 
 	serviceManager = manager;
 
+	g_clusterBus().appendListener(ClusterMessageType::vipStatus, [this](const ClusterMessage &message) {
+		notifyRemoteVipStatusChange(message.guid, message.text, static_cast<VipStatus_t>(message.value));
+	});
+
 	time_t now = time(0);
 	const tm* tms = localtime(&now);
 	int minutes = tms->tm_min;
@@ -298,6 +312,22 @@ void Game::start(ServiceManager* manager) {
 	g_scheduler().addEvent(EVENT_MS + 1000, std::bind_front(&Game::createFiendishMonsters, this), "Game::createFiendishMonsters");
 	g_scheduler().addEvent(EVENT_MS + 1000, std::bind_front(&Game::createInfluencedMonsters, this), "Game::createInfluencedMonsters");
 
+	if (g_configManager().getNumber(TASK_PROFILER_LOG_INTERVAL) > 0) {
+		g_scheduler().addEvent(g_configManager().getNumber(TASK_PROFILER_LOG_INTERVAL) * 1000, std::bind(&Game::checkTaskProfiler, this), "Game::checkTaskProfiler");
+	}
+
+	if (AllocationProfiler::isEnabled() && g_configManager().getNumber(ALLOCATION_PROFILER_LOG_INTERVAL) > 0) {
+		g_scheduler().addEvent(g_configManager().getNumber(ALLOCATION_PROFILER_LOG_INTERVAL) * 1000, std::bind(&Game::checkAllocationProfiler, this), "Game::checkAllocationProfiler");
+	}
+
+	if (g_configManager().getNumber(MAP_TILE_EVICTION_INTERVAL) > 0) {
+		g_scheduler().addEvent(g_configManager().getNumber(MAP_TILE_EVICTION_INTERVAL) * 1000, std::bind(&Game::evictUntouchedTiles, this), "Game::evictUntouchedTiles");
+	}
+
+	if (g_configManager().getNumber(KV_FLUSH_INTERVAL) > 0) {
+		g_scheduler().addEvent(g_configManager().getNumber(KV_FLUSH_INTERVAL) * 1000, std::bind(&Game::flushKV, this), "Game::flushKV");
+	}
+
 	static const std::function<void()> &LUA_GC = [] {
 		g_scheduler().addEvent(EVENT_LUA_GARBAGE_COLLECTION, LUA_GC, "Calling GC");
 		g_luaEnvironment().collectGarbage();
@@ -368,6 +398,11 @@ void Game::setGameState(GameState_t newState) {
 			saveMotdNum();
 			saveGameState();
 
+			// After the players and houses, what is left on the map belongs to nobody
+			if (g_configManager().getBoolean(WORLD_SNAPSHOT)) {
+				WorldSnapshot::store(map, getMainMapFile());
+			}
+
 			g_dispatcher().addTask(std::bind(&Game::shutdown, this), "Game::shutdown");
 
 			break;
@@ -401,57 +436,79 @@ void Game::saveGameState() {
 
 	g_logger().info("Saving server...");
 
-	for (const auto &it : players) {
-		it.second->loginPosition = it.second->getPosition();
-		IOLoginData::savePlayer(it.second);
-	}
+	// Serializes the state here and leaves the queries to the database thread
+	const auto startedAt = getPreciseTimeMs();
+	std::vector<DBWrite> writes;
+	{
+		DBWriteCapture capture;
+		for (const auto &it : players) {
+			it.second->loginPosition = it.second->getPosition();
+			IOLoginData::savePlayer(it.second);
+		}
 
-	for (const auto &it : guilds) {
-		IOGuild::saveGuild(it.second);
-	}
+		for (const auto &it : guilds) {
+			capture.setKey(fmt::format("guild:{}", it.first));
+			IOGuild::saveGuild(it.second);
+		}
+
+		capture.setKey("houses");
+		Map::save();
 
-	Map::save();
+		capture.setKey("kv");
+		g_kv().saveAll();
 
-	g_kv().saveAll();
+		writes = capture.takeWrites();
+	}
+
+	g_logger().info("Server state serialized in {} ms, {} writes queued", getPreciseTimeMs() - startedAt, writes.size());
+	g_databaseTasks().enqueueWrites(std::move(writes));
 
 	if (gameState == GAME_STATE_MAINTAIN) {
 		setGameState(GAME_STATE_NORMAL);
+	} else if (gameState == GAME_STATE_SHUTDOWN) {
+		g_databaseTasks().flushPool();
+		g_databaseTasks().flushWrites();
 	}
 }
 
 bool Game::loadItemsPrice() {
 	itemsSaleCount = 0;
-	std::ostringstream query, marketQuery;
-	query << "SELECT DISTINCT `itemtype` FROM `market_offers`;";
+	itemsPriceMap.clear();
 
-	Database &db = Database::getInstance();
-	DBResult_ptr result = db.storeQuery(query.str());
-	if (!result) {
-		return false;
+	// Highest priced offer of each item, from the in-memory order book
+	phmap::flat_hash_map<uint16_t, const MarketOfferRecord*> highestOffers;
+	for (const auto &[offerId, offer] : IOMarket::getInstance().getOffers()) {
+		auto &highest = highestOffers[offer.itemId];
+		if (!highest || offer.price > highest->price) {
+			highest = &offer;
+		}
 	}
 
-	do {
-		marketQuery.str(std::string());
-		uint16_t itemId = result->getNumber<uint16_t>("itemtype");
-		marketQuery << "SELECT `price`, `tier` FROM `market_offers` WHERE `itemtype` = " << itemId << " ORDER BY `price` DESC LIMIT 1";
-		DBResult_ptr marketOffersResult = db.storeQuery(marketQuery.str());
-		if (marketOffersResult) {
-			std::map<uint8_t, uint64_t> tierAndCount;
-			auto tier = marketOffersResult->getNumber<uint8_t>("tier");
-			auto price = marketOffersResult->getNumber<uint64_t>("price");
-			tierAndCount[tier] = price;
-			itemsPriceMap[itemId] = tierAndCount;
-			itemsSaleCount++;
-		}
-	} while (result->next());
+	for (const auto &[itemId, offer] : highestOffers) {
+		itemsPriceMap[itemId] = { { offer->tier, offer->price } };
+		itemsSaleCount++;
+	}
 
-	return true;
+	return !highestOffers.empty();
 }
 
 void Game::loadMainMap(const std::string &filename) {
+	loadMainMapTiles(filename);
+	loadMainMapData();
+}
+
+void Game::loadMainMapTiles(const std::string &filename) {
 	Monster::despawnRange = g_configManager().getNumber(DEFAULT_DESPAWNRANGE);
 	Monster::despawnRadius = g_configManager().getNumber(DEFAULT_DESPAWNRADIUS);
-	map.loadMap(g_configManager().getString(DATA_DIRECTORY) + "/world/" + filename + ".otbm", true, true, true, true);
+	map.loadMapTiles(g_configManager().getString(DATA_DIRECTORY) + "/world/" + filename + ".otbm", true);
+}
+
+std::string Game::getMainMapFile() const {
+	return g_configManager().getString(DATA_DIRECTORY) + "/world/" + g_configManager().getString(MAP_NAME) + ".otbm";
+}
+
+void Game::loadMainMapData() {
+	map.loadMapData(true, true, true, true);
 }
 
 void Game::loadCustomMaps(const std::filesystem::path &customMapPath) {
@@ -689,9 +746,9 @@ void Game::internalGetPosition(std::shared_ptr<Item> item, Position &pos, uint8_
 std::shared_ptr<Creature> Game::getCreatureByID(uint32_t id) {
 	if (id >= Player::getFirstID() && id <= Player::getLastID()) {
 		return getPlayerByID(id);
-	} else if (id <= Monster::monsterAutoID) {
+	} else if (monsters.isInRange(id)) {
 		return getMonsterByID(id);
-	} else if (id <= Npc::npcAutoID) {
+	} else if (npcs.isInRange(id)) {
 		return getNpcByID(id);
 	} else {
 		g_logger().warn("Creature with id {} not exists");
@@ -700,27 +757,13 @@ std::shared_ptr<Creature> Game::getCreatureByID(uint32_t id) {
 }
 
 std::shared_ptr<Monster> Game::getMonsterByID(uint32_t id) {
-	if (id == 0) {
-		return nullptr;
-	}
-
-	auto it = monsters.find(id);
-	if (it == monsters.end()) {
-		return nullptr;
-	}
-	return it->second;
+	const auto monster = monsters.find(id);
+	return monster ? *monster : nullptr;
 }
 
 std::shared_ptr<Npc> Game::getNpcByID(uint32_t id) {
-	if (id == 0) {
-		return nullptr;
-	}
-
-	auto it = npcs.find(id);
-	if (it == npcs.end()) {
-		return nullptr;
-	}
-	return it->second;
+	const auto npc = npcs.find(id);
+	return npc ? *npc : nullptr;
 }
 
 std::shared_ptr<Player> Game::getPlayerByID(uint32_t id, bool loadTmp /* = false */) {
@@ -744,21 +787,19 @@ std::shared_ptr<Creature> Game::getCreatureByName(const std::string &s) {
 		return nullptr;
 	}
 
-	const std::string &lowerCaseName = asLowerCaseString(s);
-
-	auto m_it = mappedPlayerNames.find(lowerCaseName);
+	auto m_it = mappedPlayerNames.find(s);
 	if (m_it != mappedPlayerNames.end()) {
 		return m_it->second.lock();
 	}
 
 	for (const auto &it : npcs) {
-		if (lowerCaseName == asLowerCaseString(it.second->getName())) {
+		if (caseInsensitiveEquals(s, it.second->getName())) {
 			return it.second;
 		}
 	}
 
 	for (const auto &it : monsters) {
-		if (lowerCaseName == asLowerCaseString(it.second->getName())) {
+		if (caseInsensitiveEquals(s, it.second->getName())) {
 			return it.second;
 		}
 	}
@@ -770,9 +811,8 @@ std::shared_ptr<Npc> Game::getNpcByName(const std::string &s) {
 		return nullptr;
 	}
 
-	const char* npcName = s.c_str();
 	for (const auto &it : npcs) {
-		if (strcasecmp(npcName, it.second->getName().c_str()) == 0) {
+		if (caseInsensitiveEquals(s, it.second->getName())) {
 			return it.second;
 		}
 	}
@@ -784,7 +824,7 @@ std::shared_ptr<Player> Game::getPlayerByName(const std::string &s, bool loadTmp
 		return nullptr;
 	}
 
-	auto it = mappedPlayerNames.find(asLowerCaseString(s));
+	auto it = mappedPlayerNames.find(s);
 	if (it == mappedPlayerNames.end() || it->second.expired()) {
 		if (!loadTmp) {
 			return nullptr;
@@ -804,12 +844,8 @@ std::shared_ptr<Player> Game::getPlayerByGUID(const uint32_t &guid) {
 	if (guid == 0) {
 		return nullptr;
 	}
-	for (const auto &it : players) {
-		if (guid == it.second->getGUID()) {
-			return it.second;
-		}
-	}
-	return nullptr;
+	auto it = mappedPlayerGuids.find(guid);
+	return it != mappedPlayerGuids.end() ? it->second.lock() : nullptr;
 }
 
 ReturnValue Game::getPlayerByNameWildcard(const std::string &s, std::shared_ptr<Player> &player) {
@@ -819,9 +855,8 @@ ReturnValue Game::getPlayerByNameWildcard(const std::string &s, std::shared_ptr<
 	}
 
 	if (s.back() == '~') {
-		const std::string &query = asLowerCaseString(s.substr(0, strlen - 1));
 		std::string result;
-		ReturnValue ret = wildcardTree.findOne(query, result);
+		ReturnValue ret = wildcardTree.findOne(std::string_view(s).substr(0, strlen - 1), result);
 		if (ret != RETURNVALUE_NOERROR) {
 			return ret;
 		}
@@ -879,7 +914,7 @@ bool Game::placeCreature(std::shared_ptr<Creature> creature, const Position &pos
 	bool hasPlayerSpectators = false;
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, creature->getPosition(), true);
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (std::shared_ptr<Player> tmpPlayer = spectator->getPlayer()) {
 			tmpPlayer->sendCreatureAppear(creature, creature->getPosition(), true);
 			hasPlayerSpectators = true;
@@ -907,7 +942,7 @@ bool Game::removeCreature(std::shared_ptr<Creature> creature, bool isLogout /* =
 
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, tile->getPosition(), true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (auto player = spectator->getPlayer()) {
 			oldStackPosVector.push_back(player->canSeeCreature(creature) ? tile->getStackposOfCreature(player, creature) : -1);
 		}
@@ -919,14 +954,14 @@ bool Game::removeCreature(std::shared_ptr<Creature> creature, bool isLogout /* =
 
 	// Send to client
 	size_t i = 0;
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (auto player = spectator->getPlayer()) {
 			player->sendRemoveTileThing(tilePosition, oldStackPosVector[i++]);
 		}
 	}
 
 	// event method
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->onRemoveCreature(creature, isLogout);
 	}
 
@@ -1010,39 +1045,38 @@ FILELOADER_ERRORS Game::loadAppearanceProtobuf(const std::string &file) {
 	// Verify that the version of the library that we linked against is
 	// compatible with the version of the headers we compiled against.
 	GOOGLE_PROTOBUF_VERIFY_VERSION;
-	appearances = Appearances();
-	if (!appearances.ParseFromIstream(&fileStream)) {
+	// The whole message is freed at once with the arena, in large blocks instead of one allocation per field
+	google::protobuf::ArenaOptions arenaOptions;
+	arenaOptions.start_block_size = 64 * 1024;
+	arenaOptions.max_block_size = 4 * 1024 * 1024;
+	google::protobuf::Arena arena(arenaOptions);
+	const auto appearances = google::protobuf::Arena::Create<Appearances>(&arena);
+	if (!appearances->ParseFromIstream(&fileStream)) {
 		g_logger().error("[Game::loadAppearanceProtobuf] - Failed to parse binary file {}, file is invalid", file);
 		fileStream.close();
 		return ERROR_NOT_OPEN;
 	}
+	fileStream.close();
 
 	// Parsing all items into ItemType
-	Item::items.loadFromProtobuf();
+	Item::items.loadFromProtobuf(*appearances);
 
 	// Only iterate other objects if necessary
 	if (g_configManager().getBoolean(WARN_UNSAFE_SCRIPTS)) {
-		// Registering distance effects
-		for (uint32_t it = 0; it < appearances.effect_size(); it++) {
-			registeredMagicEffects.push_back(static_cast<uint16_t>(appearances.effect(it).id()));
-		}
-
-		// Registering missile effects
-		for (uint32_t it = 0; it < appearances.missile_size(); it++) {
-			registeredDistanceEffects.push_back(static_cast<uint16_t>(appearances.missile(it).id()));
-		}
+		const auto registerIds = [](const auto &appearanceList, std::vector<uint16_t> &ids) {
+			ids.clear();
+			ids.reserve(appearanceList.size());
+			for (const auto &appearance : appearanceList) {
+				ids.push_back(static_cast<uint16_t>(appearance.id()));
+			}
+			std::ranges::sort(ids);
+		};
 
-		// Registering outfits
-		for (uint32_t it = 0; it < appearances.outfit_size(); it++) {
-			registeredLookTypes.push_back(static_cast<uint16_t>(appearances.outfit(it).id()));
-		}
+		registerIds(appearances->effect(), registeredMagicEffects);
+		registerIds(appearances->missile(), registeredDistanceEffects);
+		registerIds(appearances->outfit(), registeredLookTypes);
 	}
 
-	fileStream.close();
-
-	// Disposing allocated objects.
-	google::protobuf::ShutdownProtobufLibrary();
-
 	return ERROR_NONE;
 }
 
@@ -1624,7 +1658,8 @@ ReturnValue Game::checkMoveItemToCylinder(std::shared_ptr<Player> player, std::s
 		}
 
 		if (item->getContainer() && !item->isStoreItem()) {
-			for (std::shared_ptr<Item> containerItem : item->getContainer()->getItems(true)) {
+			for (ContainerIterator it = item->getContainer()->iterator(); it.hasNext(); it.advance()) {
+				std::shared_ptr<Item> containerItem = *it;
 				if (containerItem->isStoreItem() && ((containerID != ITEM_GOLD_POUCH && containerID != ITEM_DEPOT && containerID != ITEM_STORE_INBOX) || (topParentContainer->getParent() && topParentContainer->getParent()->getContainer() && (!topParentContainer->getParent()->getContainer()->isDepotChest() || topParentContainer->getParent()->getContainer()->getID() != ITEM_STORE_INBOX)))) {
 					return RETURNVALUE_NOTPOSSIBLE;
 				}
@@ -1639,8 +1674,8 @@ ReturnValue Game::checkMoveItemToCylinder(std::shared_ptr<Player> player, std::s
 				}
 			}
 			if (item->getContainer() && !item->isStoreItem()) {
-				for (std::shared_ptr<Item> containerItem : item->getContainer()->getItems(true)) {
-					if (containerItem->isStoreItem()) {
+				for (ContainerIterator it = item->getContainer()->iterator(); it.hasNext(); it.advance()) {
+					if ((*it)->isStoreItem()) {
 						return RETURNVALUE_NOTPOSSIBLE;
 					}
 				}
@@ -1657,24 +1692,7 @@ ReturnValue Game::checkMoveItemToCylinder(std::shared_ptr<Player> player, std::s
 	return RETURNVALUE_NOERROR;
 }
 
-ReturnValue Game::internalMoveItem(std::shared_ptr<Cylinder> fromCylinder, std::shared_ptr<Cylinder> toCylinder, int32_t index, std::shared_ptr<Item> item, uint32_t count, std::shared_ptr<Item>* movedItem, uint32_t flags /*= 0*/, std::shared_ptr<Creature> actor /*=nullptr*/, std::shared_ptr<Item> tradeItem /* = nullptr*/, bool checkTile /* = true*/) {
-	if (fromCylinder == nullptr) {
-		g_logger().error("[{}] fromCylinder is nullptr", __FUNCTION__);
-		return RETURNVALUE_NOTPOSSIBLE;
-	}
-	if (toCylinder == nullptr) {
-		g_logger().error("[{}] toCylinder is nullptr", __FUNCTION__);
-		return RETURNVALUE_NOTPOSSIBLE;
-	}
-
-	if (checkTile) {
-		if (std::shared_ptr<Tile> fromTile = fromCylinder->getTile()) {
-			if (fromTile && browseFields.contains(fromTile) && browseFields[fromTile].lock() == fromCylinder) {
-				fromCylinder = fromTile;
-			}
-		}
-	}
-
+ReturnValue Game::planMoveItem(const std::shared_ptr<Cylinder> &fromCylinder, std::shared_ptr<Cylinder> toCylinder, int32_t index, const std::shared_ptr<Item> &item, uint32_t count, uint32_t flags, const std::shared_ptr<Creature> &actor, const std::shared_ptr<Item> &tradeItem, ItemMovePlan &plan) {
 	std::shared_ptr<Item> toItem = nullptr;
 
 	std::shared_ptr<Cylinder> subCylinder;
@@ -1692,6 +1710,7 @@ ReturnValue Game::internalMoveItem(std::shared_ptr<Cylinder> fromCylinder, std::
 
 	// destination is the same as the source?
 	if (item == toItem) {
+		plan.inPlace = true;
 		return RETURNVALUE_NOERROR; // silently ignore move
 	}
 
@@ -1753,7 +1772,6 @@ ReturnValue Game::internalMoveItem(std::shared_ptr<Cylinder> fromCylinder, std::
 		m = maxQueryCount;
 	}
 
-	std::shared_ptr<Item> moveItem = item;
 	// check if we can remove this item
 	ret = fromCylinder->queryRemove(item, m, flags, actor);
 	if (ret != RETURNVALUE_NOERROR) {
@@ -1775,6 +1793,47 @@ ReturnValue Game::internalMoveItem(std::shared_ptr<Cylinder> fromCylinder, std::
 		}
 	}
 
+	plan.toCylinder = std::move(toCylinder);
+	plan.toItem = std::move(toItem);
+	plan.index = index;
+	plan.flags = flags;
+	plan.count = count;
+	plan.moveCount = m;
+	plan.maxCountReturn = retMaxCount;
+	return RETURNVALUE_NOERROR;
+}
+
+ReturnValue Game::internalMoveItem(std::shared_ptr<Cylinder> fromCylinder, std::shared_ptr<Cylinder> toCylinder, int32_t index, std::shared_ptr<Item> item, uint32_t count, std::shared_ptr<Item>* movedItem, uint32_t flags /*= 0*/, std::shared_ptr<Creature> actor /*=nullptr*/, std::shared_ptr<Item> tradeItem /* = nullptr*/, bool checkTile /* = true*/) {
+	if (fromCylinder == nullptr) {
+		g_logger().error("[{}] fromCylinder is nullptr", __FUNCTION__);
+		return RETURNVALUE_NOTPOSSIBLE;
+	}
+	if (toCylinder == nullptr) {
+		g_logger().error("[{}] toCylinder is nullptr", __FUNCTION__);
+		return RETURNVALUE_NOTPOSSIBLE;
+	}
+
+	if (checkTile) {
+		if (std::shared_ptr<Tile> fromTile = fromCylinder->getTile()) {
+			if (fromTile && browseFields.contains(fromTile) && browseFields[fromTile].lock() == fromCylinder) {
+				fromCylinder = fromTile;
+			}
+		}
+	}
+
+	ItemMovePlan plan;
+	if (ReturnValue ret = planMoveItem(fromCylinder, toCylinder, index, item, count, flags, actor, tradeItem, plan);
+		ret != RETURNVALUE_NOERROR || plan.inPlace) {
+		return ret;
+	}
+
+	toCylinder = plan.toCylinder;
+	index = plan.index;
+	count = plan.count;
+	const std::shared_ptr<Item> &toItem = plan.toItem;
+	const uint32_t m = plan.moveCount;
+	std::shared_ptr<Item> moveItem = item;
+
 	// remove the item
 	int32_t itemIndex = fromCylinder->getThingIndex(item);
 	std::shared_ptr<Item> updateItem = nullptr;
@@ -1862,8 +1921,8 @@ ReturnValue Game::internalMoveItem(std::shared_ptr<Cylinder> fromCylinder, std::
 	}
 
 	// we could not move all, inform the player
-	if (item->isStackable() && maxQueryCount < count) {
-		return retMaxCount;
+	if (item->isStackable() && m < count) {
+		return plan.maxCountReturn;
 	}
 
 	auto fromContainer = fromCylinder ? fromCylinder->getContainer() : nullptr;
@@ -2130,7 +2189,7 @@ bool Game::removeMoney(std::shared_ptr<Cylinder> cylinder, uint64_t money, uint3
 		return true;
 	}
 	std::vector<std::shared_ptr<Container>> containers;
-	std::multimap<uint32_t, std::shared_ptr<Item>> moneyMap;
+	std::vector<std::pair<uint32_t, std::shared_ptr<Item>>> moneyItems;
 	uint64_t moneyCount = 0;
 	for (size_t i = cylinder->getFirstIndex(), j = cylinder->getLastIndex(); i < j; ++i) {
 		std::shared_ptr<Thing> thing = cylinder->getThing(i);
@@ -2143,28 +2202,16 @@ bool Game::removeMoney(std::shared_ptr<Cylinder> cylinder, uint64_t money, uint3
 		}
 		std::shared_ptr<Container> container = item->getContainer();
 		if (container) {
-			containers.push_back(container);
+			// The container keeps the worth of everything inside, no need to open it yet
+			if (const uint64_t containerMoney = container->getHoldingMoney(); containerMoney != 0) {
+				moneyCount += containerMoney;
+				containers.push_back(container);
+			}
 		} else {
 			const uint32_t worth = item->getWorth();
 			if (worth != 0) {
 				moneyCount += worth;
-				moneyMap.emplace(worth, item);
-			}
-		}
-	}
-	size_t i = 0;
-	while (i < containers.size()) {
-		std::shared_ptr<Container> container = containers[i++];
-		for (std::shared_ptr<Item> item : container->getItemList()) {
-			std::shared_ptr<Container> tmpContainer = item->getContainer();
-			if (tmpContainer) {
-				containers.push_back(tmpContainer);
-			} else {
-				const uint32_t worth = item->getWorth();
-				if (worth != 0) {
-					moneyCount += worth;
-					moneyMap.emplace(worth, item);
-				}
+				moneyItems.emplace_back(worth, item);
 			}
 		}
 	}
@@ -2179,7 +2226,23 @@ bool Game::removeMoney(std::shared_ptr<Cylinder> cylinder, uint64_t money, uint3
 		return false;
 	}
 
-	for (const auto &moneyEntry : moneyMap) {
+	// Only containers with money somewhere inside are walked
+	for (size_t i = 0; i < containers.size(); ++i) {
+		const std::shared_ptr<Container> container = containers[i];
+		for (const std::shared_ptr<Item> &item : container->getItemList()) {
+			if (std::shared_ptr<Container> tmpContainer = item->getContainer()) {
+				if (tmpContainer->getHoldingMoney() != 0) {
+					containers.push_back(tmpContainer);
+				}
+			} else if (const uint32_t worth = item->getWorth(); worth != 0) {
+				moneyItems.emplace_back(worth, item);
+			}
+		}
+	}
+
+	// Smallest stacks go first, the first one worth more than what is left is split
+	std::ranges::stable_sort(moneyItems, {}, &std::pair<uint32_t, std::shared_ptr<Item>>::first);
+	for (const auto &moneyEntry : moneyItems) {
 		std::shared_ptr<Item> item = moneyEntry.second;
 		if (moneyEntry.first < money) {
 			internalRemoveItem(item);
@@ -2422,6 +2485,10 @@ void Game::internalQuickLootCorpse(std::shared_ptr<Player> player, std::shared_p
 	bool missedAnyGold = false;
 	bool missedAnyItem = false;
 
+	// Looting any number of items ends in one inventory refresh and one analyzer update per party
+	PlayerInventoryBatch inventoryBatch(player);
+	PartyAnalyzerBatch analyzerBatch;
+
 	for (ContainerIterator it = corpse->iterator(); it.hasNext(); it.advance()) {
 		std::shared_ptr<Item> item = *it;
 		bool listed = player->isQuickLootListedItem(item);
@@ -2696,6 +2763,7 @@ ReturnValue Game::collectRewardChestItems(std::shared_ptr<Player> player, uint32
 	auto rewardCount = rewardItemsVector.size();
 	uint32_t movedRewardItems = 0;
 	std::string lootedItemsMessage;
+	PlayerInventoryBatch inventoryBatch(player);
 	for (auto item : rewardItemsVector) {
 		// Stop if player not have free capacity
 		if (item && player->getCapacity() < item->getWeight()) {
@@ -3070,7 +3138,7 @@ void Game::playerCloseNpcChannel(uint32_t playerId) {
 
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, player->getPosition());
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (auto npc = spectator->getNpc()) {
 			npc->onPlayerCloseChannel(player);
 		}
@@ -3753,7 +3821,7 @@ void Game::playerSetShowOffSocket(uint32_t playerId, Outfit_t &outfit, const Pos
 	g_game().map.getSpectators(spectators, pos, true);
 
 	// Send to client
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (auto tmpPlayer = spectator->getPlayer()) {
 			tmpPlayer->sendUpdateTileItem(tile, pos, item);
 		}
@@ -4888,6 +4956,8 @@ void Game::playerLootAllCorpses(std::shared_ptr<Player> player, const Position &
 
 		const TileItemVector* itemVector = tile->getItemList();
 		uint16_t corpses = 0;
+		PlayerInventoryBatch inventoryBatch(player);
+		PartyAnalyzerBatch analyzerBatch;
 		for (auto &tileItem : *itemVector) {
 			if (!tileItem) {
 				continue;
@@ -5165,20 +5235,36 @@ void Game::playerRequestAddVip(uint32_t playerId, const std::string &name) {
 
 	std::shared_ptr<Player> vipPlayer = getPlayerByName(name);
 	if (!vipPlayer) {
-		uint32_t guid;
-		bool specialVip;
-		std::string formattedName = name;
-		if (!IOLoginData::getGuidByNameEx(guid, specialVip, formattedName)) {
-			player->sendTextMessage(MESSAGE_FAILURE, "A player with this name does not exist.");
-			return;
-		}
+		// Offline, looked up without holding the dispatcher
+		const std::string query = fmt::format("SELECT `name`, `id`, `group_id` FROM `players` WHERE `name` = {}", Database::getInstance().escapeString(name));
+		g_databaseTasks().store(query, [this, playerId](DBResult_ptr result, bool) {
+			std::shared_ptr<Player> player = getPlayerByID(playerId);
+			if (!player) {
+				return;
+			}
 
-		if (specialVip && !player->hasFlag(PlayerFlags_t::SpecialVIP)) {
-			player->sendTextMessage(MESSAGE_FAILURE, "You can not add this player->");
-			return;
-		}
+			if (!result) {
+				player->sendTextMessage(MESSAGE_FAILURE, "A player with this name does not exist.");
+				return;
+			}
 
-		player->addVIP(guid, formattedName, VIPSTATUS_OFFLINE);
+			const auto guid = result->getNumber<uint32_t>("id");
+			const std::string formattedName = result->getString("name");
+			// Logged in meanwhile, it is added with its current status
+			if (getPlayerByGUID(guid)) {
+				playerRequestAddVip(playerId, formattedName);
+				return;
+			}
+
+			const auto group = groups.getGroup(result->getNumber<uint16_t>("group_id"));
+			const bool specialVip = group && group->flags[Groups::getFlagNumber(PlayerFlags_t::SpecialVIP)];
+			if (specialVip && !player->hasFlag(PlayerFlags_t::SpecialVIP)) {
+				player->sendTextMessage(MESSAGE_FAILURE, "You can not add this player->");
+				return;
+			}
+
+			player->addVIP(guid, formattedName, VIPSTATUS_OFFLINE);
+		});
 	} else {
 		if (vipPlayer->hasFlag(PlayerFlags_t::SpecialVIP) && !player->hasFlag(PlayerFlags_t::SpecialVIP)) {
 			player->sendTextMessage(MESSAGE_FAILURE, "You can not add this player->");
@@ -5493,7 +5579,7 @@ void Game::playerWhisper(std::shared_ptr<Player> player, const std::string &text
 	map.getSpectators(spectators, player->getPosition(), false, false, MAP_MAX_CLIENT_VIEW_PORT_X, MAP_MAX_CLIENT_VIEW_PORT_X, MAP_MAX_CLIENT_VIEW_PORT_Y, MAP_MAX_CLIENT_VIEW_PORT_Y);
 
 	// Send to client
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (auto spectatorPlayer = spectator->getPlayer()) {
 			if (!Position::areInRange<1, 1>(player->getPosition(), spectatorPlayer->getPosition())) {
 				spectatorPlayer->sendCreatureSay(player, TALKTYPE_WHISPER, "pspsps");
@@ -5504,7 +5590,7 @@ void Game::playerWhisper(std::shared_ptr<Player> player, const std::string &text
 	}
 
 	// event method
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->onCreatureSay(player, TALKTYPE_WHISPER, text);
 	}
 }
@@ -5569,7 +5655,7 @@ void Game::playerSpeakToNpc(std::shared_ptr<Player> player, const std::string &t
 
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, player->getPosition());
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (spectator->getNpc()) {
 			spectator->onCreatureSay(player, TALKTYPE_PRIVATE_PN, text);
 		}
@@ -5578,8 +5664,8 @@ void Game::playerSpeakToNpc(std::shared_ptr<Player> player, const std::string &t
 	player->updateUIExhausted();
 }
 
-std::shared_ptr<Task> Game::createPlayerTask(uint32_t delay, std::function<void(void)> f, std::string context) const {
-	return Player::createPlayerTask(delay, f, context);
+std::shared_ptr<Task> Game::createPlayerTask(uint32_t delay, TaskFunction &&f, std::string_view context) const {
+	return Player::createPlayerTask(delay, std::move(f), context);
 }
 
 //--
@@ -5604,7 +5690,7 @@ bool Game::internalCreatureTurn(std::shared_ptr<Creature> creature, Direction di
 	// Send to client
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, creature->getPosition(), true, true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		auto tmpPlayer = spectator->getPlayer();
 		if (!tmpPlayer) {
 			continue;
@@ -5640,19 +5726,23 @@ bool Game::internalCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses
 	}
 
 	// Send to client
-	for (auto spectator : spectators) {
+	BroadcastPacket packet;
+	for (const auto &spectator : spectators) {
 		if (auto tmpPlayer = spectator->getPlayer()) {
 			if (!ghostMode || tmpPlayer->canSeeCreature(creature)) {
-				tmpPlayer->sendCreatureSay(creature, type, text, pos);
+				tmpPlayer->sendCreatureSay(creature, type, text, pos, packet);
 			}
 		}
 	}
 
 	// event method
-	for (auto spectator : spectators) {
+	const bool hasHearHandler = g_events().hasHandler(EventHandler_t::CREATURE_ON_HEAR);
+	for (const auto &spectator : spectators) {
 		spectator->onCreatureSay(creature, type, text);
 		if (creature != spectator) {
-			g_events().eventCreatureOnHear(spectator, creature, text, type);
+			if (hasHearHandler) {
+				g_events().eventCreatureOnHear(spectator, creature, text, type);
+			}
 			g_callbacks().executeCallback(EventCallback_t::creatureOnHear, &EventCallback::creatureOnHear, spectator, creature, text, type);
 		}
 	}
@@ -5681,7 +5771,7 @@ void Game::checkCreatureAttack(uint32_t creatureId) {
 	}
 }
 
-void Game::addCreatureCheck(std::shared_ptr<Creature> creature) {
+void Game::addCreatureCheck(const std::shared_ptr<Creature> &creature) {
 	creature->creatureCheck = true;
 
 	if (creature->inCheckCreaturesVector) {
@@ -5693,24 +5783,34 @@ void Game::addCreatureCheck(std::shared_ptr<Creature> creature) {
 	checkCreatureLists[uniform_random(0, EVENT_CREATURECOUNT - 1)].push_back(creature);
 }
 
-void Game::removeCreatureCheck(std::shared_ptr<Creature> creature) {
+void Game::removeCreatureCheck(const std::shared_ptr<Creature> &creature) {
 	if (creature->inCheckCreaturesVector) {
 		creature->creatureCheck = false;
 	}
 }
 
 void Game::checkCreatures(size_t index) {
+	CANARY_PROFILE_ZONE("Game::checkCreatures");
 	g_scheduler().addEvent(EVENT_CHECK_CREATURE_INTERVAL, std::bind(&Game::checkCreatures, this, (index + 1) % EVENT_CREATURECOUNT), "Game::checkCreatures");
 
 	auto &checkCreatureList = checkCreatureLists[index];
+	checkCreatureBatch.clear();
+
+	// Compact the bucket and gather the live creatures into a flat batch
 	size_t it = 0, end = checkCreatureList.size();
 	while (it < end) {
 		std::shared_ptr<Creature> creature = checkCreatureList[it];
 		if (creature && creature->creatureCheck) {
 			if (creature->getHealth() > 0) {
-				creature->onThink(EVENT_CREATURE_THINK_INTERVAL);
-				creature->onAttacking(EVENT_CREATURE_THINK_INTERVAL);
-				creature->executeConditions(EVENT_CREATURE_THINK_INTERVAL);
+				if (creature->getPlayer()) {
+					map.markActiveSectors(creature->getPosition());
+				} else if (!map.isSectorActive(creature->getPosition())) {
+					// Nobody can see it, sleep until a player wakes the sector up
+					creature->suspendedThinkInterval += EVENT_CREATURE_THINK_INTERVAL;
+					++it;
+					continue;
+				}
+				checkCreatureBatch.push_back(creature.get());
 			} else {
 				creature->onDeath();
 			}
@@ -5723,6 +5823,40 @@ void Game::checkCreatures(size_t index) {
 			--end;
 		}
 	}
+
+	// Creatures of a region are checked one after the other, so their tiles and spectator results stay in cache
+	std::ranges::sort(checkCreatureBatch, {}, [](Creature* creature) {
+		const Position &position = creature->getPosition();
+		return (static_cast<uint64_t>(position.z) << 32) | (static_cast<uint64_t>(position.x >> MAP_REGION_BITS) << 16) | (position.y >> MAP_REGION_BITS);
+	});
+
+	/**
+	 * Each phase runs over the whole batch, so the same code stays hot across creatures.
+	 * A creature may die or be removed from the map in an earlier phase, every phase checks it again.
+	 */
+	const auto isCheckable = [](Creature* creature) {
+		return !creature->isRemoved() && creature->getHealth() > 0;
+	};
+
+	for (Creature* creature : checkCreatureBatch) {
+		if (isCheckable(creature)) {
+			creature->onThink(EVENT_CREATURE_THINK_INTERVAL);
+		}
+	}
+
+	for (Creature* creature : checkCreatureBatch) {
+		if (isCheckable(creature)) {
+			creature->onAttacking(EVENT_CREATURE_THINK_INTERVAL);
+		}
+	}
+
+	for (Creature* creature : checkCreatureBatch) {
+		if (isCheckable(creature)) {
+			// Conditions catch up on the time slept in an inactive sector in one go
+			creature->executeConditions(EVENT_CREATURE_THINK_INTERVAL + std::exchange(creature->suspendedThinkInterval, 0));
+		}
+	}
+
 	cleanup();
 }
 
@@ -5735,7 +5869,7 @@ void Game::changeSpeed(std::shared_ptr<Creature> creature, int32_t varSpeedDelta
 	// Send to clients
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, creature->getPosition(), false, true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		auto player = spectator->getPlayer();
 		if (!player) {
 			continue;
@@ -5751,7 +5885,7 @@ void Game::setCreatureSpeed(std::shared_ptr<Creature> creature, int32_t speed) {
 	// Send creature speed to client
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, creature->getPosition(), false, true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		auto player = spectator->getPlayer();
 		if (!player) {
 			continue;
@@ -5770,7 +5904,7 @@ void Game::changePlayerSpeed(const std::shared_ptr<Player> &player, int32_t varS
 	// Send new player speed to the spectators
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, player->getPosition(), false, true);
-	for (std::shared_ptr<Creature> creatureSpectator : spectators) {
+	for (const auto &creatureSpectator : spectators) {
 		if (creatureSpectator == nullptr) {
 			g_logger().error("[Game::changePlayerSpeed] - Creature spectator is nullptr");
 			continue;
@@ -5804,7 +5938,7 @@ void Game::internalCreatureChangeOutfit(std::shared_ptr<Creature> creature, cons
 	// Send to clients
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, creature->getPosition(), true, true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		auto player = spectator->getPlayer();
 		if (!player) {
 			continue;
@@ -5818,7 +5952,7 @@ void Game::internalCreatureChangeVisible(std::shared_ptr<Creature> creature, boo
 	// Send to clients
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, creature->getPosition(), true, true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		auto player = spectator->getPlayer();
 		if (!player) {
 			continue;
@@ -5832,7 +5966,7 @@ void Game::changeLight(std::shared_ptr<Creature> creature) {
 	// Send to clients
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, creature->getPosition(), true, true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		auto player = spectator->getPlayer();
 		if (!player) {
 			continue;
@@ -5846,7 +5980,7 @@ void Game::updateCreatureIcon(std::shared_ptr<Creature> creature) {
 	// Send to clients
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, creature->getPosition(), true, true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		auto player = spectator->getPlayer();
 		if (!player) {
 			continue;
@@ -5864,7 +5998,7 @@ void Game::reloadCreature(std::shared_ptr<Creature> creature) {
 
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, creature->getPosition(), false, true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		auto tmpPlayer = spectator->getPlayer();
 		if (!tmpPlayer) {
 			continue;
@@ -5873,14 +6007,20 @@ void Game::reloadCreature(std::shared_ptr<Creature> creature) {
 	}
 }
 
+void Game::getCombatSpectators(SpectatorHashSet &spectators, const Position &pos, bool multifloor) {
+	if (!CombatSpectators::find(spectators, pos, multifloor)) {
+		map.getSpectators(spectators, pos, multifloor, true);
+	}
+}
+
 void Game::sendSingleSoundEffect(const Position &pos, SoundEffect_t soundId, std::shared_ptr<Creature> actor /* = nullptr*/) {
 	if (soundId == SoundEffect_t::SILENCE) {
 		return;
 	}
 
 	SpectatorHashSet spectators;
-	map.getSpectators(spectators, pos, false, true);
-	for (auto spectator : spectators) {
+	getCombatSpectators(spectators, pos, false);
+	for (const auto &spectator : spectators) {
 		if (auto tmpPlayer = spectator->getPlayer()) {
 			SourceEffect_t source = SourceEffect_t::CREATURES;
 			if (!actor || actor->getNpc()) {
@@ -5903,8 +6043,8 @@ void Game::sendDoubleSoundEffect(const Position &pos, SoundEffect_t mainSoundEff
 	}
 
 	SpectatorHashSet spectators;
-	map.getSpectators(spectators, pos, false, true);
-	for (auto spectator : spectators) {
+	getCombatSpectators(spectators, pos, false);
+	for (const auto &spectator : spectators) {
 		if (auto tmpPlayer = spectator->getPlayer()) {
 			SourceEffect_t source = SourceEffect_t::CREATURES;
 			if (!actor || actor->getNpc()) {
@@ -6105,7 +6245,7 @@ bool Game::combatBlockHit(CombatDamage &damage, std::shared_ptr<Creature> attack
 	return (primaryBlockType != BLOCK_NONE) && (secondaryBlockType != BLOCK_NONE);
 }
 
-void Game::combatGetTypeInfo(CombatType_t combatType, std::shared_ptr<Creature> target, TextColor_t &color, uint16_t &effect) {
+void Game::combatGetTypeInfo(CombatType_t combatType, const std::shared_ptr<Creature> &target, TextColor_t &color, uint16_t &effect) {
 	switch (combatType) {
 		case COMBAT_PHYSICALDAMAGE: {
 			std::shared_ptr<Item> splash = nullptr;
@@ -6228,7 +6368,7 @@ void Game::handleHazardSystemAttack(CombatDamage &damage, std::shared_ptr<Player
 
 void Game::notifySpectators(const SpectatorHashSet &spectators, const Position &targetPos, std::shared_ptr<Player> attackerPlayer, std::shared_ptr<Monster> targetMonster) {
 	if (!spectators.empty()) {
-		for (auto spectator : spectators) {
+		for (const auto &spectator : spectators) {
 			if (!spectator) {
 				continue;
 			}
@@ -6272,7 +6412,7 @@ void Game::applyWheelOfDestinyHealing(CombatDamage &damage, std::shared_ptr<Play
 			combatChangeHealth(attackerPlayer, attackerPlayer, tmpDamage);
 		}
 
-		if (attackerPlayer->wheel()->getInstant("Blessing of the Grove")) {
+		if (attackerPlayer->wheel()->getCombatBonus().blessingOfTheGrove[0] > 0) {
 			damage.primary.value += (damage.primary.value * attackerPlayer->wheel()->checkBlessingGroveHealingByTarget(target)) / 100.;
 		}
 	}
@@ -6294,14 +6434,15 @@ void Game::applyWheelOfDestinyEffectsToDamage(CombatDamage &damage, std::shared_
 		if (damage.secondary.value != 0) {
 			damage.secondary.value -= attackerPlayer->wheel()->getStat(WheelStat_t::DAMAGE);
 		}
-		if (damage.instantSpellName == "Twin Burst") {
+		const auto &wheelBonus = attackerPlayer->wheel()->getCombatBonus();
+		if (wheelBonus.twinBurst > 0 && damage.instantSpellName == "Twin Burst") {
 			int32_t damageBonus = attackerPlayer->wheel()->checkTwinBurstByTarget(target);
 			if (damageBonus != 0) {
 				damage.primary.value += (damage.primary.value * damageBonus) / 100.;
 				damage.secondary.value += (damage.secondary.value * damageBonus) / 100.;
 			}
 		}
-		if (damage.instantSpellName == "Executioner's Throw") {
+		if (wheelBonus.executionersThrow > 0 && damage.instantSpellName == "Executioner's Throw") {
 			int32_t damageBonus = attackerPlayer->wheel()->checkExecutionersThrow(target);
 			if (damageBonus != 0) {
 				damage.primary.value += (damage.primary.value * damageBonus) / 100.;
@@ -6316,10 +6457,11 @@ int32_t Game::applyHealthChange(CombatDamage &damage, std::shared_ptr<Creature>
 
 	// Wheel of destiny (Gift of Life)
 	if (std::shared_ptr<Player> targetPlayer = target->getPlayer()) {
-		if (targetPlayer->wheel()->getInstant("Gift of Life") && targetPlayer->wheel()->getGiftOfCooldown() == 0 && (damage.primary.value + damage.secondary.value) >= targetHealth) {
+		const uint8_t giftOfLife = targetPlayer->wheel()->getCombatBonus().giftOfLife;
+		if (giftOfLife > 0 && (damage.primary.value + damage.secondary.value) >= targetHealth && targetPlayer->wheel()->getGiftOfCooldown() == 0) {
 			int32_t overkillMultiplier = (damage.primary.value + damage.secondary.value) - targetHealth;
 			overkillMultiplier = (overkillMultiplier * 100) / targetPlayer->getMaxHealth();
-			if (overkillMultiplier <= targetPlayer->wheel()->getGiftOfLifeValue()) {
+			if (overkillMultiplier <= giftOfLife) {
 				targetPlayer->wheel()->checkGiftOfLife();
 				targetHealth = target->getHealth();
 			}
@@ -6336,7 +6478,7 @@ int32_t Game::applyHealthChange(CombatDamage &damage, std::shared_ptr<Creature>
 	return targetHealth;
 }
 
-bool Game::combatChangeHealth(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target, CombatDamage &damage, bool isEvent /*= false*/) {
+bool Game::combatChangeHealth(const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, CombatDamage &damage, bool isEvent /*= false*/) {
 	using namespace std;
 	const Position &targetPos = target->getPosition();
 	if (damage.primary.value > 0) {
@@ -6397,8 +6539,8 @@ bool Game::combatChangeHealth(std::shared_ptr<Creature> attacker, std::shared_pt
 			message.primary.color = TEXTCOLOR_PASTELRED;
 
 			SpectatorHashSet spectators;
-			map.getSpectators(spectators, targetPos, false, true);
-			for (auto spectator : spectators) {
+			getCombatSpectators(spectators, targetPos, false);
+			for (const auto &spectator : spectators) {
 				auto tmpPlayer = spectator->getPlayer();
 				if (!tmpPlayer) {
 					continue;
@@ -6536,7 +6678,7 @@ bool Game::combatChangeHealth(std::shared_ptr<Creature> attacker, std::shared_pt
 		}
 
 		SpectatorHashSet spectators;
-		map.getSpectators(spectators, targetPos, true, true);
+		getCombatSpectators(spectators, targetPos, true);
 
 		if (targetPlayer && attackerMonster) {
 			handleHazardSystemAttack(damage, targetPlayer, attackerMonster, false);
@@ -6557,7 +6699,7 @@ bool Game::combatChangeHealth(std::shared_ptr<Creature> attacker, std::shared_pt
 
 		if (!damage.extension && attackerMonster && targetPlayer) {
 			// Charm rune (target as player)
-			if (charmRune_t activeCharm = g_iobestiary().getCharmFromTarget(targetPlayer, g_monsters().getMonsterTypeByRaceId(attackerMonster->getRaceId()));
+			if (charmRune_t activeCharm = targetPlayer->getCharmByRaceId(attackerMonster->getRaceId());
 				activeCharm != CHARM_NONE && activeCharm != CHARM_CLEANSE) {
 				if (const auto charm = g_iobestiary().getBestiaryCharm(activeCharm);
 					charm->type == CHARM_DEFENSIVE && charm->chance > normal_random(0, 100) && g_iobestiary().parseCharmCombat(charm, targetPlayer, attacker, (damage.primary.value + damage.secondary.value))) {
@@ -6614,7 +6756,7 @@ bool Game::combatChangeHealth(std::shared_ptr<Creature> attacker, std::shared_pt
 				message.primary.value = manaDamage;
 				message.primary.color = TEXTCOLOR_BLUE;
 
-				for (std::shared_ptr<Creature> spectator : spectators) {
+				for (const auto &spectator : spectators) {
 					if (!spectator) {
 						continue;
 					}
@@ -6726,7 +6868,7 @@ bool Game::combatChangeHealth(std::shared_ptr<Creature> attacker, std::shared_pt
 		}
 
 		if (spectators.empty()) {
-			map.getSpectators(spectators, targetPos, true, true);
+			getCombatSpectators(spectators, targetPos, true);
 		}
 
 		addCreatureHealth(spectators, target);
@@ -6821,7 +6963,7 @@ void Game::sendMessages(
 
 	std::string spectatorMessage;
 
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		std::shared_ptr<Player> tmpPlayer = spectator->getPlayer();
 		if (!tmpPlayer || tmpPlayer->getPosition().z != targetPos.z) {
 			continue;
@@ -6932,7 +7074,7 @@ void Game::applyCharmRune(
 	if (!targetMonster || !attackerPlayer) {
 		return;
 	}
-	if (charmRune_t activeCharm = g_iobestiary().getCharmFromTarget(attackerPlayer, g_monsters().getMonsterTypeByRaceId(targetMonster->getRaceId()));
+	if (charmRune_t activeCharm = attackerPlayer->getCharmByRaceId(targetMonster->getRaceId());
 		activeCharm != CHARM_NONE) {
 		const auto charm = g_iobestiary().getBestiaryCharm(activeCharm);
 		int8_t chance = charm->id == CHARM_CRIPPLE ? charm->chance : charm->chance + attackerPlayer->getCharmChanceModifier();
@@ -7012,7 +7154,7 @@ int32_t Game::calculateLeechAmount(const int32_t &realDamage, const uint16_t &sk
 	return std::clamp<int32_t>(static_cast<int32_t>(std::lround(intermediateResult)), 0, realDamage);
 }
 
-bool Game::combatChangeMana(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target, CombatDamage &damage) {
+bool Game::combatChangeMana(const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, CombatDamage &damage) {
 	const Position &targetPos = target->getPosition();
 	auto manaChange = damage.primary.value + damage.secondary.value;
 	if (manaChange > 0) {
@@ -7067,8 +7209,8 @@ bool Game::combatChangeMana(std::shared_ptr<Creature> attacker, std::shared_ptr<
 			message.primary.color = TEXTCOLOR_MAYABLUE;
 
 			SpectatorHashSet spectators;
-			map.getSpectators(spectators, targetPos, false, true);
-			for (auto spectator : spectators) {
+			getCombatSpectators(spectators, targetPos, false);
+			for (const auto &spectator : spectators) {
 				auto tmpPlayer = spectator->getPlayer();
 				if (!tmpPlayer) {
 					continue;
@@ -7166,8 +7308,8 @@ bool Game::combatChangeMana(std::shared_ptr<Creature> attacker, std::shared_ptr<
 		message.primary.color = TEXTCOLOR_BLUE;
 
 		SpectatorHashSet spectators;
-		map.getSpectators(spectators, targetPos, false, true);
-		for (auto spectator : spectators) {
+		getCombatSpectators(spectators, targetPos, false);
+		for (const auto &spectator : spectators) {
 			auto tmpPlayer = spectator->getPlayer();
 			if (!tmpPlayer) {
 				continue;
@@ -7234,7 +7376,7 @@ void Game::addCreatureHealth(const SpectatorHashSet &spectators, std::shared_ptr
 			}
 		}
 	}
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (std::shared_ptr<Player> tmpPlayer = spectator->getPlayer()) {
 			tmpPlayer->sendCreatureHealth(target);
 		}
@@ -7253,10 +7395,8 @@ void Game::addPlayerVocation(std::shared_ptr<Player> target) {
 		party->updatePlayerVocation(target);
 	}
 
-	SpectatorHashSet spectators;
-	map.getSpectators(spectators, target->getPosition(), true, true);
-
-	for (auto spectator : spectators) {
+	Spectators spectators;
+	for (const auto &spectator : spectators.find(target->getPosition(), true, true)) {
 		if (auto tmpPlayer = spectator->getPlayer()) {
 			tmpPlayer->sendPlayerVocation(target);
 		}
@@ -7264,44 +7404,58 @@ void Game::addPlayerVocation(std::shared_ptr<Player> target) {
 }
 
 void Game::addMagicEffect(const Position &pos, uint16_t effect) {
-	SpectatorHashSet spectators;
-	map.getSpectators(spectators, pos, true, true);
-	addMagicEffect(spectators, pos, effect);
+	Spectators spectators;
+	BroadcastPacket packet;
+	for (const auto &spectator : spectators.find(pos, true, true)) {
+		if (auto tmpPlayer = spectator->getPlayer()) {
+			tmpPlayer->sendMagicEffect(pos, effect, packet);
+		}
+	}
 }
 
 void Game::addMagicEffect(const SpectatorHashSet &spectators, const Position &pos, uint16_t effect) {
-	for (auto spectator : spectators) {
+	BroadcastPacket packet;
+	for (const auto &spectator : spectators) {
 		if (auto tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendMagicEffect(pos, effect);
+			tmpPlayer->sendMagicEffect(pos, effect, packet);
 		}
 	}
 }
 
 void Game::removeMagicEffect(const Position &pos, uint16_t effect) {
-	SpectatorHashSet spectators;
-	map.getSpectators(spectators, pos, true, true);
-	removeMagicEffect(spectators, pos, effect);
+	Spectators spectators;
+	BroadcastPacket packet;
+	for (const auto &spectator : spectators.find(pos, true, true)) {
+		if (const auto tmpPlayer = spectator->getPlayer()) {
+			tmpPlayer->removeMagicEffect(pos, effect, packet);
+		}
+	}
 }
 
 void Game::removeMagicEffect(const SpectatorHashSet &spectators, const Position &pos, uint16_t effect) {
-	for (auto spectator : spectators) {
+	BroadcastPacket packet;
+	for (const auto &spectator : spectators) {
 		if (const auto tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->removeMagicEffect(pos, effect);
+			tmpPlayer->removeMagicEffect(pos, effect, packet);
 		}
 	}
 }
 
 void Game::addDistanceEffect(const Position &fromPos, const Position &toPos, uint16_t effect) {
-	SpectatorHashSet spectators;
-	map.getSpectators(spectators, fromPos, false, true);
-	map.getSpectators(spectators, toPos, false, true);
-	addDistanceEffect(spectators, fromPos, toPos, effect);
+	Spectators spectators;
+	BroadcastPacket packet;
+	for (const auto &spectator : spectators.find(fromPos, false, true).find(toPos, false, true)) {
+		if (auto tmpPlayer = spectator->getPlayer()) {
+			tmpPlayer->sendDistanceShoot(fromPos, toPos, effect, packet);
+		}
+	}
 }
 
 void Game::addDistanceEffect(const SpectatorHashSet &spectators, const Position &fromPos, const Position &toPos, uint16_t effect) {
-	for (auto spectator : spectators) {
+	BroadcastPacket packet;
+	for (const auto &spectator : spectators) {
 		if (auto tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendDistanceShoot(fromPos, toPos, effect);
+			tmpPlayer->sendDistanceShoot(fromPos, toPos, effect, packet);
 		}
 	}
 }
@@ -7318,6 +7472,100 @@ void Game::checkImbuements() {
 	}
 }
 
+void Game::checkTaskProfiler() {
+	const auto interval = g_configManager().getNumber(TASK_PROFILER_LOG_INTERVAL);
+	if (interval <= 0) {
+		return;
+	}
+
+	g_scheduler().addEvent(interval * 1000, std::bind(&Game::checkTaskProfiler, this), "Game::checkTaskProfiler");
+
+	if (!g_configManager().getBoolean(TOGGLE_TASK_PROFILER)) {
+		return;
+	}
+
+	auto &profiler = g_dispatcher().getProfiler();
+	profiler.logProfiles(static_cast<size_t>(std::max(0, g_configManager().getNumber(TASK_PROFILER_LOG_CONTEXTS))));
+	profiler.reset();
+}
+
+void Game::checkAllocationProfiler() {
+	const auto interval = g_configManager().getNumber(ALLOCATION_PROFILER_LOG_INTERVAL);
+	if (interval <= 0) {
+		return;
+	}
+
+	g_scheduler().addEvent(interval * 1000, std::bind(&Game::checkAllocationProfiler, this), "Game::checkAllocationProfiler");
+	AllocationProfiler::logReport(static_cast<size_t>(std::max(0, g_configManager().getNumber(ALLOCATION_PROFILER_LOG_CONTEXTS))));
+}
+
+void Game::evictUntouchedTiles() {
+	const auto interval = g_configManager().getNumber(MAP_TILE_EVICTION_INTERVAL);
+	if (interval <= 0) {
+		return;
+	}
+
+	g_scheduler().addEvent(interval * 1000, std::bind(&Game::evictUntouchedTiles, this), "Game::evictUntouchedTiles");
+
+	if (const size_t evicted = map.evictUntouchedTiles(MAP_TILE_EVICTION_BATCH); evicted > 0) {
+		g_logger().debug("[{}] {} tiles released back to the map cache", __FUNCTION__, evicted);
+	}
+}
+
+size_t Game::startIncrementalClean() {
+	if (incrementalClean.cursor < incrementalClean.tiles.size() || tilesToClean.empty()) {
+		return 0;
+	}
+
+	incrementalClean.tiles.assign(tilesToClean.begin(), tilesToClean.end());
+	incrementalClean.cursor = 0;
+	incrementalClean.removed = 0;
+	incrementalClean.startedAt = getPreciseTimeMs();
+
+	// Every slice takes the same share, so the last one runs before the window closes
+	const auto window = std::max<int64_t>(0, g_configManager().getNumber(MAP_CLEAN_INCREMENTAL_WINDOW)) * 1000;
+	const auto slices = std::max<size_t>(1, static_cast<size_t>(window / MAP_CLEAN_SLICE_INTERVAL));
+	incrementalClean.tilesPerSlice = (incrementalClean.tiles.size() + slices - 1) / slices;
+
+	const size_t queued = incrementalClean.tiles.size();
+	cleanMapSlice();
+	return queued;
+}
+
+void Game::cleanMapSlice() {
+	auto &[tiles, cursor, tilesPerSlice, removed, startedAt] = incrementalClean;
+	const size_t end = std::min(tiles.size(), cursor + tilesPerSlice);
+	{
+		TileUpdateBatch batch(map);
+		for (; cursor < end; ++cursor) {
+			if (const auto tile = tiles[cursor].lock()) {
+				removed += Map::cleanTile(tile);
+				// Protection zone tiles are not dropped by the item removal itself
+				removeTileToClean(tile);
+			}
+		}
+	}
+
+	if (cursor < tiles.size()) {
+		g_scheduler().addEvent(MAP_CLEAN_SLICE_INTERVAL, std::bind(&Game::cleanMapSlice, this), "Game::cleanMapSlice");
+		return;
+	}
+
+	g_logger().info("CLEAN: Removed {} item{} from {} tile{} in {} seconds, incremental", removed, (removed != 1 ? "s" : ""), tiles.size(), (tiles.size() != 1 ? "s" : ""), (getPreciseTimeMs() - startedAt) / (1000.f));
+	tiles.clear();
+	cursor = 0;
+}
+
+void Game::flushKV() {
+	const auto interval = g_configManager().getNumber(KV_FLUSH_INTERVAL);
+	if (interval <= 0) {
+		return;
+	}
+
+	g_scheduler().addEvent(interval * 1000, std::bind(&Game::flushKV, this), "Game::flushKV");
+	g_kv().saveDirtyAsync();
+}
+
 void Game::checkLight() {
 	g_scheduler().addEvent(EVENT_LIGHTINTERVAL_MS, std::bind(&Game::checkLight, this), "Game::checkLight");
 
@@ -7363,15 +7611,14 @@ void Game::checkLight() {
 
 	LightInfo lightInfo = getWorldLightInfo();
 
-	if (lightChange) {
-		for ([[maybe_unused]] const auto &[mapPlayerId, mapPlayer] : getPlayers()) {
-			mapPlayer->sendWorldLight(lightInfo);
-			mapPlayer->sendTibiaTime(lightHour);
-		}
-	} else {
-		for ([[maybe_unused]] const auto &[mapPlayerId, mapPlayer] : getPlayers()) {
-			mapPlayer->sendTibiaTime(lightHour);
+	// Serialized once and shared by every client that does not have it yet
+	BroadcastPacket lightPacket;
+	BroadcastPacket timePacket;
+	for ([[maybe_unused]] const auto &[mapPlayerId, mapPlayer] : getPlayers()) {
+		if (lightChange) {
+			mapPlayer->sendWorldLight(lightInfo, lightPacket);
 		}
+		mapPlayer->sendTibiaTime(lightHour, timePacket);
 	}
 	if (currentLightState != lightState) {
 		currentLightState = lightState;
@@ -7451,7 +7698,7 @@ void Game::updateCreatureWalkthrough(std::shared_ptr<Creature> creature) {
 	// Send to clients
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, creature->getPosition(), true, true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		auto tmpPlayer = spectator->getPlayer();
 		if (!tmpPlayer) {
 			continue;
@@ -7468,7 +7715,7 @@ void Game::updateCreatureSkull(std::shared_ptr<Creature> creature) {
 
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, creature->getPosition(), true, true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		auto player = spectator->getPlayer();
 		if (!player) {
 			continue;
@@ -7481,7 +7728,7 @@ void Game::updateCreatureSkull(std::shared_ptr<Creature> creature) {
 void Game::updatePlayerShield(std::shared_ptr<Player> player) {
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, player->getPosition(), true, true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		auto player = spectator->getPlayer();
 		if (!player) {
 			continue;
@@ -7515,7 +7762,7 @@ void Game::updateCreatureType(std::shared_ptr<Creature> creature) {
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, creature->getPosition(), true, true);
 	if (creatureType == CREATURETYPE_SUMMON_OTHERS) {
-		for (auto spectator : spectators) {
+		for (const auto &spectator : spectators) {
 			auto player = spectator->getPlayer();
 			if (!player) {
 				continue;
@@ -7528,7 +7775,7 @@ void Game::updateCreatureType(std::shared_ptr<Creature> creature) {
 			}
 		}
 	} else {
-		for (auto spectator : spectators) {
+		for (const auto &spectator : spectators) {
 			if (auto player = spectator->getPlayer()) {
 				player->sendCreatureType(creature, creatureType);
 			}
@@ -7643,7 +7890,7 @@ void Game::updatePlayerHelpers(std::shared_ptr<Player> player) {
 
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, player->getPosition(), true, true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		auto specPlayer = spectator->getPlayer();
 		if (!specPlayer) {
 			continue;
@@ -7765,6 +8012,126 @@ void Game::kickPlayer(uint32_t playerId, bool displayEffect) {
 	player->removePlayer(displayEffect);
 }
 
+namespace {
+	std::deque<PlayerDeathRecord> readDeathRecords(const DBResult_ptr &result, const std::string &name) {
+		std::deque<PlayerDeathRecord> records;
+		if (!result) {
+			return records;
+		}
+
+		do {
+			PlayerDeathRecord &record = records.emplace_back();
+			record.time = result->getNumber<uint32_t>("time");
+			record.level = result->getNumber<uint32_t>("level");
+			record.killedBy = result->getString("killed_by");
+			record.mostDamageBy = result->getString("mostdamage_by");
+			record.name = name.empty() ? result->getString("name") : name;
+			record.unjustified = result->getNumber<uint32_t>("unjustified") == 1;
+			record.mostDamageUnjustified = result->getNumber<uint32_t>("mostdamage_unjustified") == 1;
+		} while (result->next());
+		return records;
+	}
+
+	// Records of the requested page, empty when it is past the last one
+	std::span<const PlayerDeathRecord> getDeathRecordsPage(const std::deque<PlayerDeathRecord> &records, uint16_t page, uint16_t entriesPerPage, uint16_t &pages, std::vector<PlayerDeathRecord> &buffer) {
+		pages = entriesPerPage == 0 ? 0 : static_cast<uint16_t>((records.size() + entriesPerPage - 1) / entriesPerPage);
+		const size_t offset = static_cast<size_t>(std::max<uint16_t>(page, 1) - 1) * entriesPerPage;
+		if (entriesPerPage == 0 || offset >= records.size()) {
+			return {};
+		}
+
+		buffer.assign(records.begin() + offset, records.begin() + std::min(records.size(), offset + entriesPerPage));
+		return buffer;
+	}
+
+	void appendCause(std::ostringstream &cause, const std::string &name) {
+		const char &character = name.front();
+		if (character == 'a' || character == 'e' || character == 'i' || character == 'o' || character == 'u') {
+			cause << " an ";
+		} else {
+			cause << " a ";
+		}
+		cause << name;
+	}
+
+	void sendRecentDeathsPage(const std::shared_ptr<Player> &player, uint16_t page, uint16_t entriesPerPage) {
+		uint16_t pages;
+		std::vector<PlayerDeathRecord> buffer;
+		const auto records = getDeathRecordsPage(*player->getRecentDeaths(), page, entriesPerPage, pages, buffer);
+		if (records.empty()) {
+			player->sendCyclopediaCharacterRecentDeaths(0, 0, {});
+			return;
+		}
+
+		std::vector<RecentDeathEntry> entries;
+		entries.reserve(records.size());
+		for (const auto &record : records) {
+			const std::string &cause1 = record.killedBy;
+			const std::string &cause2 = record.mostDamageBy;
+
+			std::ostringstream cause;
+			cause << "Died at Level " << record.level << " by";
+			if (!cause1.empty()) {
+				appendCause(cause, cause1);
+			}
+
+			if (!cause2.empty()) {
+				if (!cause1.empty()) {
+					cause << " and ";
+				}
+				appendCause(cause, cause2);
+			}
+			cause << '.';
+			entries.emplace_back(std::move(cause.str()), record.time);
+		}
+		player->sendCyclopediaCharacterRecentDeaths(page, pages, entries);
+	}
+
+	void sendRecentPvPKillsPage(const std::shared_ptr<Player> &player, uint16_t page, uint16_t entriesPerPage) {
+		uint16_t pages;
+		std::vector<PlayerDeathRecord> buffer;
+		const auto records = getDeathRecordsPage(*player->getRecentPvPKills(), page, entriesPerPage, pages, buffer);
+		if (records.empty()) {
+			player->sendCyclopediaCharacterRecentPvPKills(0, 0, {});
+			return;
+		}
+
+		std::vector<RecentPvPKillEntry> entries;
+		entries.reserve(records.size());
+		for (const auto &record : records) {
+			uint8_t status = CYCLOPEDIA_CHARACTERINFO_RECENTKILLSTATUS_JUSTIFIED;
+			if (player->getName() == record.killedBy) {
+				if (record.unjustified) {
+					status = CYCLOPEDIA_CHARACTERINFO_RECENTKILLSTATUS_UNJUSTIFIED;
+				}
+			} else if (player->getName() == record.mostDamageBy) {
+				if (record.mostDamageUnjustified) {
+					status = CYCLOPEDIA_CHARACTERINFO_RECENTKILLSTATUS_UNJUSTIFIED;
+				}
+			}
+
+			std::ostringstream description;
+			description << "Killed " << record.name << '.';
+			entries.emplace_back(std::move(description.str()), record.time, status);
+		}
+		player->sendCyclopediaCharacterRecentPvPKills(page, pages, entries);
+	}
+}
+
+void Game::addPlayerDeathRecord(const std::shared_ptr<Player> &player, PlayerDeathRecord record, bool killedByPlayer, bool mostDamageByPlayer) {
+	record.name = player->getName();
+	player->addRecentDeath(record);
+
+	// Both may be the same player, it is a single kill then
+	std::shared_ptr<Player> killer = killedByPlayer ? getPlayerByName(record.killedBy) : nullptr;
+	if (killer) {
+		killer->addRecentPvPKill(record);
+	}
+	if (std::shared_ptr<Player> mostDamageKiller = mostDamageByPlayer ? getPlayerByName(record.mostDamageBy) : nullptr; mostDamageKiller && mostDamageKiller != killer) {
+		mostDamageKiller->addRecentPvPKill(record);
+	}
+}
+
 void Game::playerCyclopediaCharacterInfo(std::shared_ptr<Player> player, uint32_t characterID, CyclopediaCharacterInfoType_t characterInfoType, uint16_t entriesPerPage, uint16_t page) {
 	uint32_t playerGUID = player->getGUID();
 	if (characterID != playerGUID) {
@@ -7784,9 +8151,17 @@ void Game::playerCyclopediaCharacterInfo(std::shared_ptr<Player> player, uint32_
 			player->sendCyclopediaCharacterCombatStats();
 			break;
 		case CYCLOPEDIA_CHARACTERINFO_RECENTDEATHS: {
+			if (player->getRecentDeaths()) {
+				sendRecentDeathsPage(player, page, entriesPerPage);
+				break;
+			}
+
+			if (player->hasAsyncOngoingTask(PlayerAsyncTask_RecentDeaths)) {
+				break;
+			}
+
 			std::ostringstream query;
-			uint32_t offset = static_cast<uint32_t>(page - 1) * entriesPerPage;
-			query << "SELECT `time`, `level`, `killed_by`, `mostdamage_by`, (select count(*) FROM `player_deaths` WHERE `player_id` = " << playerGUID << ") as `entries` FROM `player_deaths` WHERE `player_id` = " << playerGUID << " ORDER BY `time` DESC LIMIT " << offset << ", " << entriesPerPage;
+			query << "SELECT `time`, `level`, `killed_by`, `mostdamage_by`, `unjustified`, `mostdamage_unjustified` FROM `player_deaths` WHERE `player_id` = " << playerGUID << " ORDER BY `time` DESC LIMIT " << MAX_RECENT_DEATH_RECORDS;
 
 			uint32_t playerID = player->getID();
 			std::function<void(DBResult_ptr, bool)> callback = [playerID, page, entriesPerPage](DBResult_ptr result, bool) {
@@ -7796,62 +8171,30 @@ void Game::playerCyclopediaCharacterInfo(std::shared_ptr<Player> player, uint32_
 				}
 
 				player->resetAsyncOngoingTask(PlayerAsyncTask_RecentDeaths);
-				if (!result) {
-					player->sendCyclopediaCharacterRecentDeaths(0, 0, {});
-					return;
-				}
-
-				uint32_t pages = result->getNumber<uint32_t>("entries");
-				pages += entriesPerPage - 1;
-				pages /= entriesPerPage;
-
-				std::vector<RecentDeathEntry> entries;
-				entries.reserve(result->countResults());
-				do {
-					std::string cause1 = result->getString("killed_by");
-					std::string cause2 = result->getString("mostdamage_by");
-
-					std::ostringstream cause;
-					cause << "Died at Level " << result->getNumber<uint32_t>("level") << " by";
-					if (!cause1.empty()) {
-						const char &character = cause1.front();
-						if (character == 'a' || character == 'e' || character == 'i' || character == 'o' || character == 'u') {
-							cause << " an ";
-						} else {
-							cause << " a ";
-						}
-						cause << cause1;
-					}
-
-					if (!cause2.empty()) {
-						if (!cause1.empty()) {
-							cause << " and ";
-						}
-
-						const char &character = cause2.front();
-						if (character == 'a' || character == 'e' || character == 'i' || character == 'o' || character == 'u') {
-							cause << " an ";
-						} else {
-							cause << " a ";
-						}
-						cause << cause2;
-					}
-					cause << '.';
-					entries.emplace_back(std::move(cause.str()), result->getNumber<uint32_t>("time"));
-				} while (result->next());
-				player->sendCyclopediaCharacterRecentDeaths(page, static_cast<uint16_t>(pages), entries);
+				player->getRecentDeaths() = readDeathRecords(result, player->getName());
+				sendRecentDeathsPage(player, page, entriesPerPage);
 			};
 			g_databaseTasks().store(query.str(), callback);
 			player->addAsyncOngoingTask(PlayerAsyncTask_RecentDeaths);
 			break;
 		}
 		case CYCLOPEDIA_CHARACTERINFO_RECENTPVPKILLS: {
+			if (player->getRecentPvPKills()) {
+				sendRecentPvPKillsPage(player, page, entriesPerPage);
+				break;
+			}
+
+			if (player->hasAsyncOngoingTask(PlayerAsyncTask_RecentPvPKills)) {
+				break;
+			}
+
 			// TODO: add guildwar, assists and arena kills
+			// One query per column instead of the OR of both, so each can use its index
 			Database &db = Database::getInstance();
 			const std::string &escapedName = db.escapeString(player->getName());
+			const std::string columns = "SELECT `d`.`time`, `d`.`level`, `d`.`killed_by`, `d`.`mostdamage_by`, `d`.`unjustified`, `d`.`mostdamage_unjustified`, `p`.`name` FROM `player_deaths` AS `d` INNER JOIN `players` AS `p` ON `d`.`player_id` = `p`.`id` WHERE ";
 			std::ostringstream query;
-			uint32_t offset = static_cast<uint32_t>(page - 1) * entriesPerPage;
-			query << "SELECT `d`.`time`, `d`.`killed_by`, `d`.`mostdamage_by`, `d`.`unjustified`, `d`.`mostdamage_unjustified`, `p`.`name`, (select count(*) FROM `player_deaths` WHERE ((`killed_by` = " << escapedName << " AND `is_player` = 1) OR (`mostdamage_by` = " << escapedName << " AND `mostdamage_is_player` = 1))) as `entries` FROM `player_deaths` AS `d` INNER JOIN `players` AS `p` ON `d`.`player_id` = `p`.`id` WHERE ((`d`.`killed_by` = " << escapedName << " AND `d`.`is_player` = 1) OR (`d`.`mostdamage_by` = " << escapedName << " AND `d`.`mostdamage_is_player` = 1)) ORDER BY `time` DESC LIMIT " << offset << ", " << entriesPerPage;
+			query << '(' << columns << "`d`.`killed_by` = " << escapedName << " AND `d`.`is_player` = 1) UNION (" << columns << "`d`.`mostdamage_by` = " << escapedName << " AND `d`.`mostdamage_is_player` = 1) ORDER BY `time` DESC LIMIT " << MAX_RECENT_DEATH_RECORDS;
 
 			uint32_t playerID = player->getID();
 			std::function<void(DBResult_ptr, bool)> callback = [playerID, page, entriesPerPage](DBResult_ptr result, bool) {
@@ -7861,38 +8204,8 @@ void Game::playerCyclopediaCharacterInfo(std::shared_ptr<Player> player, uint32_
 				}
 
 				player->resetAsyncOngoingTask(PlayerAsyncTask_RecentPvPKills);
-				if (!result) {
-					player->sendCyclopediaCharacterRecentPvPKills(0, 0, {});
-					return;
-				}
-
-				uint32_t pages = result->getNumber<uint32_t>("entries");
-				pages += entriesPerPage - 1;
-				pages /= entriesPerPage;
-
-				std::vector<RecentPvPKillEntry> entries;
-				entries.reserve(result->countResults());
-				do {
-					std::string cause1 = result->getString("killed_by");
-					std::string cause2 = result->getString("mostdamage_by");
-					std::string name = result->getString("name");
-
-					uint8_t status = CYCLOPEDIA_CHARACTERINFO_RECENTKILLSTATUS_JUSTIFIED;
-					if (player->getName() == cause1) {
-						if (result->getNumber<uint32_t>("unjustified") == 1) {
-							status = CYCLOPEDIA_CHARACTERINFO_RECENTKILLSTATUS_UNJUSTIFIED;
-						}
-					} else if (player->getName() == cause2) {
-						if (result->getNumber<uint32_t>("mostdamage_unjustified") == 1) {
-							status = CYCLOPEDIA_CHARACTERINFO_RECENTKILLSTATUS_UNJUSTIFIED;
-						}
-					}
-
-					std::ostringstream description;
-					description << "Killed " << name << '.';
-					entries.emplace_back(std::move(description.str()), result->getNumber<uint32_t>("time"), status);
-				} while (result->next());
-				player->sendCyclopediaCharacterRecentPvPKills(page, static_cast<uint16_t>(pages), entries);
+				player->getRecentPvPKills() = readDeathRecords(result, {});
+				sendRecentPvPKillsPage(player, page, entriesPerPage);
 			};
 			g_databaseTasks().store(query.str(), callback);
 			player->addAsyncOngoingTask(PlayerAsyncTask_RecentPvPKills);
@@ -7926,121 +8239,13 @@ void Game::playerCyclopediaCharacterInfo(std::shared_ptr<Player> player, uint32_
 }
 
 void Game::playerHighscores(std::shared_ptr<Player> player, HighscoreType_t type, uint8_t category, uint32_t vocation, const std::string &, uint16_t page, uint8_t entriesPerPage) {
-	if (player->hasAsyncOngoingTask(PlayerAsyncTask_Highscore)) {
-		return;
-	}
-
-	std::string categoryName;
-	switch (category) {
-		case HIGHSCORE_CATEGORY_FIST_FIGHTING:
-			categoryName = "skill_fist";
-			break;
-		case HIGHSCORE_CATEGORY_CLUB_FIGHTING:
-			categoryName = "skill_club";
-			break;
-		case HIGHSCORE_CATEGORY_SWORD_FIGHTING:
-			categoryName = "skill_sword";
-			break;
-		case HIGHSCORE_CATEGORY_AXE_FIGHTING:
-			categoryName = "skill_axe";
-			break;
-		case HIGHSCORE_CATEGORY_DISTANCE_FIGHTING:
-			categoryName = "skill_dist";
-			break;
-		case HIGHSCORE_CATEGORY_SHIELDING:
-			categoryName = "skill_shielding";
-			break;
-		case HIGHSCORE_CATEGORY_FISHING:
-			categoryName = "skill_fishing";
-			break;
-		case HIGHSCORE_CATEGORY_MAGIC_LEVEL:
-			categoryName = "maglevel";
-			break;
-		default: {
-			category = HIGHSCORE_CATEGORY_EXPERIENCE;
-			categoryName = "experience";
-			break;
-		}
+	if (category >= IOHighscores::CATEGORY_COUNT) {
+		category = HIGHSCORE_CATEGORY_EXPERIENCE;
 	}
 
-	std::ostringstream query;
-	if (type == HIGHSCORE_GETENTRIES) {
-		uint32_t startPage = (static_cast<uint32_t>(page - 1) * static_cast<uint32_t>(entriesPerPage));
-		uint32_t endPage = startPage + static_cast<uint32_t>(entriesPerPage);
-		query << "SELECT *, @row AS `entries`, " << page << " AS `page` FROM (SELECT *, (@row := @row + 1) AS `rn` FROM (SELECT `id`, `name`, `level`, `vocation`, `" << categoryName << "` AS `points`, @curRank := IF(@prevRank = `" << categoryName << "`, @curRank, IF(@prevRank := `" << categoryName << "`, @curRank + 1, @curRank + 1)) AS `rank` FROM `players` `p`, (SELECT @curRank := 0, @prevRank := NULL, @row := 0) `r` WHERE `group_id` < " << static_cast<int>(account::GROUP_TYPE_GAMEMASTER) << " ORDER BY `" << categoryName << "` DESC) `t`";
-		if (vocation != 0xFFFFFFFF) {
-			bool firstVocation = true;
-
-			const auto vocationsMap = g_vocations().getVocations();
-			for (const auto &it : vocationsMap) {
-				const Vocation &voc = it.second;
-				if (voc.getFromVocation() == vocation) {
-					if (firstVocation) {
-						query << " WHERE `vocation` = " << voc.getId();
-						firstVocation = false;
-					} else {
-						query << " OR `vocation` = " << voc.getId();
-					}
-				}
-			}
-		}
-		query << ") `T` WHERE `rn` > " << startPage << " AND `rn` <= " << endPage;
-	} else if (type == HIGHSCORE_OURRANK) {
-		std::string entriesStr = std::to_string(entriesPerPage);
-		query << "SELECT *, @row AS `entries`, (@ourRow DIV " << entriesStr << ") + 1 AS `page` FROM (SELECT *, (@row := @row + 1) AS `rn`, @ourRow := IF(`id` = " << player->getGUID() << ", @row - 1, @ourRow) AS `rw` FROM (SELECT `id`, `name`, `level`, `vocation`, `" << categoryName << "` AS `points`, @curRank := IF(@prevRank = `" << categoryName << "`, @curRank, IF(@prevRank := `" << categoryName << "`, @curRank + 1, @curRank + 1)) AS `rank` FROM `players` `p`, (SELECT @curRank := 0, @prevRank := NULL, @row := 0, @ourRow := 0) `r` WHERE `group_id` < " << static_cast<int>(account::GROUP_TYPE_GAMEMASTER) << " ORDER BY `" << categoryName << "` DESC) `t`";
-		if (vocation != 0xFFFFFFFF) {
-			bool firstVocation = true;
-
-			const auto vocationsMap = g_vocations().getVocations();
-			for (const auto &it : vocationsMap) {
-				const Vocation &voc = it.second;
-				if (voc.getFromVocation() == vocation) {
-					if (firstVocation) {
-						query << " WHERE `vocation` = " << voc.getId();
-						firstVocation = false;
-					} else {
-						query << " OR `vocation` = " << voc.getId();
-					}
-				}
-			}
-		}
-		query << ") `T` WHERE `rn` > ((@ourRow DIV " << entriesStr << ") * " << entriesStr << ") AND `rn` <= (((@ourRow DIV " << entriesStr << ") * " << entriesStr << ") + " << entriesStr << ")";
+	if (!IOHighscores::getInstance().sendEntries(player, type, category, vocation, page, entriesPerPage)) {
+		player->sendHighscoresNoData();
 	}
-
-	uint32_t playerID = player->getID();
-	std::function<void(DBResult_ptr, bool)> callback = [playerID, category, vocation, entriesPerPage](DBResult_ptr result, bool) {
-		std::shared_ptr<Player> player = g_game().getPlayerByID(playerID);
-		if (!player) {
-			return;
-		}
-
-		player->resetAsyncOngoingTask(PlayerAsyncTask_Highscore);
-		if (!result) {
-			player->sendHighscoresNoData();
-			return;
-		}
-
-		uint16_t page = result->getNumber<uint16_t>("page");
-		uint32_t pages = result->getNumber<uint32_t>("entries");
-		pages += entriesPerPage - 1;
-		pages /= entriesPerPage;
-
-		std::vector<HighscoreCharacter> characters;
-		characters.reserve(result->countResults());
-		do {
-			uint8_t characterVocation;
-			const Vocation* voc = g_vocations().getVocation(result->getNumber<uint16_t>("vocation"));
-			if (voc) {
-				characterVocation = voc->getClientId();
-			} else {
-				characterVocation = 0;
-			}
-			characters.emplace_back(std::move(result->getString("name")), result->getNumber<uint64_t>("points"), result->getNumber<uint32_t>("id"), result->getNumber<uint32_t>("rank"), result->getNumber<uint16_t>("level"), characterVocation);
-		} while (result->next());
-		player->sendHighscores(characters, category, vocation, page, static_cast<uint16_t>(pages));
-	};
-	g_databaseTasks().store(query.str(), callback);
-	player->addAsyncOngoingTask(PlayerAsyncTask_Highscore);
 }
 
 void Game::playerReportRuleViolationReport(uint32_t playerId, const std::string &targetName, uint8_t reportType, uint8_t reportReason, const std::string &comment, const std::string &translation) {
@@ -9019,7 +9224,7 @@ void Game::playerSetMonsterPodium(uint32_t playerId, uint32_t monsterRaceId, con
 	g_game().map.getSpectators(spectators, pos, true);
 
 	// Send to client
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (auto tmpPlayer = spectator->getPlayer()) {
 			tmpPlayer->sendUpdateTileItem(tile, pos, item);
 		}
@@ -9193,21 +9398,99 @@ void Game::updatePlayerSaleItems(uint32_t playerId) {
 }
 
 void Game::addPlayer(std::shared_ptr<Player> player) {
-	const std::string &lowercase_name = asLowerCaseString(player->getName());
-	mappedPlayerNames[lowercase_name] = player;
-	wildcardTree.insert(lowercase_name);
+	mappedPlayerNames[player->getName()] = player;
+	wildcardTree.insert(player->getName());
 	players[player->getID()] = player;
+	mappedPlayerGuids[player->getGUID()] = player;
+
+	for (uint32_t guid : player->VIPList) {
+		vipWatchers[guid].emplace(player->getID());
+	}
 }
 
 void Game::removePlayer(std::shared_ptr<Player> player) {
-	const std::string &lowercase_name = asLowerCaseString(player->getName());
-	mappedPlayerNames.erase(lowercase_name);
-	wildcardTree.remove(lowercase_name);
+	mappedPlayerNames.erase(player->getName());
+	wildcardTree.remove(player->getName());
 	players.erase(player->getID());
+	if (auto it = mappedPlayerGuids.find(player->getGUID()); it != mappedPlayerGuids.end() && it->second.lock() == player) {
+		mappedPlayerGuids.erase(it);
+	}
+
+	for (uint32_t guid : player->VIPList) {
+		removeVipWatcher(guid, player->getID());
+	}
+}
+
+void Game::addVipWatcher(uint32_t guid, uint32_t watcherId) {
+	if (players.contains(watcherId)) {
+		vipWatchers[guid].emplace(watcherId);
+	}
+}
+
+void Game::removeVipWatcher(uint32_t guid, uint32_t watcherId) {
+	auto it = vipWatchers.find(guid);
+	if (it == vipWatchers.end()) {
+		return;
+	}
+
+	it->second.erase(watcherId);
+	if (it->second.empty()) {
+		vipWatchers.erase(it);
+	}
+}
+
+void Game::notifyVipStatusChange(const std::shared_ptr<Player> &player, VipStatus_t status, bool message /* = true*/, const std::function<bool(const std::shared_ptr<Player> &)> &filter /* = nullptr*/) {
+	// The other worlds do not know who has access, a player in ghost mode only shows up there as offline
+	if (g_clusterBus().isEnabled() && (!player->isInGhostMode() || status == VIPSTATUS_OFFLINE)) {
+		ClusterMessage clusterMessage;
+		clusterMessage.type = ClusterMessageType::vipStatus;
+		clusterMessage.guid = player->getGUID();
+		clusterMessage.value = status;
+		clusterMessage.text = player->getName();
+		g_clusterBus().publish(std::move(clusterMessage));
+	}
+
+	auto it = vipWatchers.find(player->getGUID());
+	if (it == vipWatchers.end()) {
+		return;
+	}
+
+	for (uint32_t watcherId : it->second) {
+		const auto watcherIt = players.find(watcherId);
+		if (watcherIt == players.end() || (filter && !filter(watcherIt->second))) {
+			continue;
+		}
+
+		watcherIt->second->notifyStatusChange(player, status, message);
+	}
+}
+
+void Game::notifyRemoteVipStatusChange(uint32_t guid, const std::string &name, VipStatus_t status) {
+	// Only a player of another world, the local one already told its watchers
+	if (mappedPlayerGuids.contains(guid)) {
+		return;
+	}
+
+	auto it = vipWatchers.find(guid);
+	if (it == vipWatchers.end()) {
+		return;
+	}
+
+	for (uint32_t watcherId : it->second) {
+		if (const auto watcherIt = players.find(watcherId); watcherIt != players.end()) {
+			watcherIt->second->notifyStatusChange(guid, name, status);
+		}
+	}
 }
 
 void Game::addNpc(std::shared_ptr<Npc> npc) {
-	npcs[npc->getID()] = npc;
+	if (npcs.contains(npc->id)) {
+		return;
+	}
+	npc->id = npcs.insert(npc);
+	if (npc->id == 0) {
+		g_logger().error("[Game::addNpc] - Every npc id is in use, npc {} is left without one", npc->getName());
+	}
 }
 
 void Game::removeNpc(std::shared_ptr<Npc> npc) {
@@ -9215,34 +9498,45 @@ void Game::removeNpc(std::shared_ptr<Npc> npc) {
 }
 
 void Game::addMonster(std::shared_ptr<Monster> monster) {
-	monsters[monster->getID()] = monster;
+	if (monsters.contains(monster->id)) {
+		return;
+	}
+	monster->id = monsters.insert(monster);
+	if (monster->id == 0) {
+		g_logger().error("[Game::addMonster] - Every monster id is in use, monster {} is left without one", monster->getName());
+		return;
+	}
+	updateForgeableMonster(monster);
 }
 
 void Game::removeMonster(std::shared_ptr<Monster> monster) {
+	removeForgeableMonster(monster->getID());
 	monsters.erase(monster->getID());
 }
 
-std::shared_ptr<Guild> Game::getGuild(uint32_t id, bool allowOffline /* = flase */) const {
-	auto it = guilds.find(id);
-	if (it == guilds.end()) {
-		if (allowOffline) {
-			return IOGuild::loadGuild(id);
-		}
+std::shared_ptr<Guild> Game::getGuild(uint32_t id, bool allowOffline /* = false */) {
+	if (id == 0) {
 		return nullptr;
 	}
-	return it->second;
-}
 
-std::shared_ptr<Guild> Game::getGuildByName(const std::string &name, bool allowOffline /* = flase */) const {
-	auto id = IOGuild::getGuildIdByName(name);
 	auto it = guilds.find(id);
-	if (it == guilds.end()) {
-		if (allowOffline) {
-			return IOGuild::loadGuild(id);
-		}
+	if (it != guilds.end()) {
+		return allowOffline || it->second->isOnline() ? it->second : nullptr;
+	}
+
+	if (!allowOffline) {
 		return nullptr;
 	}
-	return it->second;
+
+	// Created after the startup load
+	const auto guild = IOGuild::loadGuild(id);
+	addGuild(guild);
+	return guild;
+}
+
+std::shared_ptr<Guild> Game::getGuildByName(const std::string &name, bool allowOffline /* = false */) {
+	auto it = guildIdsByName.find(name);
+	return getGuild(it != guildIdsByName.end() ? it->second : IOGuild::getGuildIdByName(name), allowOffline);
 }
 
 void Game::addGuild(const std::shared_ptr<Guild> guild) {
@@ -9250,14 +9544,39 @@ void Game::addGuild(const std::shared_ptr<Guild> guild) {
 		return;
 	}
 	guilds[guild->getId()] = guild;
+	guildIdsByName[guild->getName()] = guild->getId();
 }
 
-void Game::removeGuild(uint32_t guildId) {
+void Game::saveOfflineGuild(uint32_t guildId) {
 	auto it = guilds.find(guildId);
 	if (it != guilds.end()) {
 		IOGuild::saveGuild(it->second);
 	}
-	guilds.erase(guildId);
+}
+
+namespace {
+	uint64_t getGuildWarKey(uint32_t guildId, uint32_t enemyGuildId) {
+		return (static_cast<uint64_t>(std::min(guildId, enemyGuildId)) << 32) | std::max(guildId, enemyGuildId);
+	}
+}
+
+bool Game::isGuildsAtWar(uint32_t guildId, uint32_t enemyGuildId) const {
+	return guildWars.contains(getGuildWarKey(guildId, enemyGuildId));
+}
+
+bool Game::hasGuildWars(uint32_t guildId) const {
+	return guildWarCounts.contains(guildId);
+}
+
+void Game::setGuildWars(const std::vector<std::pair<uint32_t, uint32_t>> &wars) {
+	guildWars.clear();
+	guildWarCounts.clear();
+	for (const auto &[guildId, enemyGuildId] : wars) {
+		if (guildWars.emplace(getGuildWarKey(guildId, enemyGuildId)).second) {
+			++guildWarCounts[guildId];
+			++guildWarCounts[enemyGuildId];
+		}
+	}
 }
 
 void Game::internalRemoveItems(const std::vector<std::shared_ptr<Item>> &itemVector, uint32_t amount, bool stackable) {
@@ -9341,6 +9660,7 @@ bool Game::hasDistanceEffect(uint16_t effectId) {
 }
 
 void Game::createLuaItemsOnMap() {
+	TileUpdateBatch batch(map);
 	for (const auto [position, itemId] : mapLuaItemsStored) {
 		std::shared_ptr<Item> item = Item::CreateItem(itemId, 1);
 		if (!item) {
@@ -9374,7 +9694,7 @@ void Game::sendUpdateCreature(std::shared_ptr<Creature> creature) {
 
 	SpectatorHashSet spectators;
 	map.getSpectators(spectators, creature->getPosition(), true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (const auto tmpPlayer = spectator->getPlayer()) {
 			tmpPlayer->sendUpdateCreature(creature);
 		}
@@ -9388,63 +9708,22 @@ uint32_t Game::makeInfluencedMonster() {
 		return 0;
 	}
 
-	if (forgeableMonsters.empty()) {
+	const auto monster = takeForgeableMonster(true);
+	if (!monster) {
 		return 0;
 	}
 
-	auto maxTries = forgeableMonsters.size();
-	uint16_t tries = 0;
-	std::shared_ptr<Monster> monster = nullptr;
-	while (true) {
-		if (tries == maxTries) {
-			return 0;
-		}
-
-		tries++;
-
-		auto random = static_cast<uint32_t>(normal_random(0, static_cast<int32_t>(forgeableMonsters.size() - 1)));
-		auto monsterId = forgeableMonsters.at(random);
-		monster = getMonsterByID(monsterId);
-		if (monster == nullptr) {
-			continue;
-		}
-
-		// Avoiding replace forgeable monster with another
-		if (monster->getForgeStack() == 0) {
-			auto it = std::ranges::find(forgeableMonsters.begin(), forgeableMonsters.end(), monsterId);
-			if (it == forgeableMonsters.end()) {
-				monster = nullptr;
-				continue;
-			}
-			forgeableMonsters.erase(it);
-			break;
-		}
-	}
-
-	if (monster && monster->canBeForgeMonster()) {
-		monster->setMonsterForgeClassification(ForgeClassifications_t::FORGE_INFLUENCED_MONSTER);
-		monster->configureForgeSystem();
-		influencedMonsters.insert(monster->getID());
-		return monster->getID();
-	}
-
-	return 0;
+	monster->setMonsterForgeClassification(ForgeClassifications_t::FORGE_INFLUENCED_MONSTER);
+	monster->configureForgeSystem();
+	influencedMonsters.insert(monster->getID());
+	return monster->getID();
 }
 
 uint32_t Game::makeFiendishMonster(uint32_t forgeableMonsterId /* = 0*/, bool createForgeableMonsters /* = false*/) {
 	if (createForgeableMonsters) {
-		forgeableMonsters.clear();
-		// If the forgeable monsters haven't been created
-		// Then we'll create them so they don't return in the next if (forgeableMonsters.empty())
-		for (auto [monsterId, monster] : monsters) {
-			auto monsterTile = monster->getTile();
-			if (!monster || !monsterTile) {
-				continue;
-			}
-
-			if (monster->canBeForgeMonster() && !monsterTile->hasFlag(TILESTATE_NOLOGOUT)) {
-				forgeableMonsters.push_back(monster->getID());
-			}
+		// The candidates are kept as monsters come and go, only the ones that became eligible unnoticed are missing
+		for (const auto &[monsterId, monster] : monsters) {
+			updateForgeableMonster(monster);
 		}
 		for (const auto monsterId : getFiendishMonsters()) {
 			// If the fiendish is no longer on the map, we remove it from the vector
@@ -9469,35 +9748,15 @@ uint32_t Game::makeFiendishMonster(uint32_t forgeableMonsterId /* = 0*/, bool cr
 		return 0;
 	}
 
-	auto maxTries = forgeableMonsters.size();
-	uint16_t tries = 0;
 	std::shared_ptr<Monster> monster = nullptr;
-	while (true) {
-		if (tries == maxTries) {
-			return 0;
-		}
-
-		tries++;
-
-		auto random = static_cast<uint32_t>(uniform_random(0, static_cast<int32_t>(forgeableMonsters.size() - 1)));
-		uint32_t fiendishMonsterId = forgeableMonsterId;
-		if (fiendishMonsterId == 0) {
-			fiendishMonsterId = forgeableMonsters.at(random);
-		}
-		monster = getMonsterByID(fiendishMonsterId);
-		if (monster == nullptr) {
-			continue;
-		}
-
+	if (forgeableMonsterId == 0) {
+		monster = takeForgeableMonster(false);
+	} else if (forgeableMonsterIndexes.contains(forgeableMonsterId)) {
 		// Avoiding replace forgeable monster with another
-		if (monster->getForgeStack() == 0) {
-			auto it = std::find(forgeableMonsters.begin(), forgeableMonsters.end(), fiendishMonsterId);
-			if (it == forgeableMonsters.end()) {
-				monster = nullptr;
-				continue;
-			}
-			forgeableMonsters.erase(it);
-			break;
+		monster = getMonsterByID(forgeableMonsterId);
+		removeForgeableMonster(forgeableMonsterId);
+		if (monster && !isForgeableMonster(monster)) {
+			monster = nullptr;
 		}
 	}
 
@@ -9600,18 +9859,8 @@ bool Game::removeFiendishMonster(uint32_t id, bool create /* = true*/) {
 }
 
 void Game::updateForgeableMonsters() {
+	// The candidates themselves are kept up to date as monsters change, only the fiendish are checked here
 	g_scheduler().addEvent(EVENT_FORGEABLEMONSTERCHECKINTERVAL, std::bind_front(&Game::updateForgeableMonsters, this), "Game::updateForgeableMonsters");
-	forgeableMonsters.clear();
-	for (auto [monsterId, monster] : monsters) {
-		auto monsterTile = monster->getTile();
-		if (!monsterTile) {
-			continue;
-		}
-
-		if (monster->canBeForgeMonster() && !monsterTile->hasFlag(TILESTATE_NOLOGOUT)) {
-			forgeableMonsters.push_back(monster->getID());
-		}
-	}
 
 	for (const auto monsterId : getFiendishMonsters()) {
 		if (!getMonsterByID(monsterId)) {
@@ -9625,6 +9874,55 @@ void Game::updateForgeableMonsters() {
 	}
 }
 
+bool Game::isForgeableMonster(const std::shared_ptr<Monster> &monster) const {
+	const auto monsterTile = monster->getTile();
+	return monsterTile && monster->canBeForgeMonster() && !monsterTile->hasFlag(TILESTATE_NOLOGOUT);
+}
+
+void Game::updateForgeableMonster(const std::shared_ptr<Monster> &monster) {
+	const uint32_t monsterId = monster->getID();
+	if (monsterId == 0 || monster->isRemoved() || !isForgeableMonster(monster)) {
+		removeForgeableMonster(monsterId);
+		return;
+	}
+
+	if (forgeableMonsterIndexes.try_emplace(monsterId, forgeableMonsters.size()).second) {
+		forgeableMonsters.push_back(monsterId);
+	}
+}
+
+void Game::removeForgeableMonster(uint32_t monsterId) {
+	const auto it = forgeableMonsterIndexes.find(monsterId);
+	if (it == forgeableMonsterIndexes.end()) {
+		return;
+	}
+
+	// The last candidate takes the place of the removed one
+	const size_t index = it->second;
+	forgeableMonsterIndexes.erase(it);
+	if (index != forgeableMonsters.size() - 1) {
+		forgeableMonsters[index] = forgeableMonsters.back();
+		forgeableMonsterIndexes[forgeableMonsters[index]] = index;
+	}
+	forgeableMonsters.pop_back();
+}
+
+std::shared_ptr<Monster> Game::takeForgeableMonster(bool normalDistribution) {
+	while (!forgeableMonsters.empty()) {
+		const auto last = static_cast<int32_t>(forgeableMonsters.size() - 1);
+		const auto index = static_cast<size_t>(normalDistribution ? normal_random(0, last) : uniform_random(0, last));
+		const uint32_t monsterId = forgeableMonsters[index];
+		removeForgeableMonster(monsterId);
+
+		// Those no longer eligible come back when they are again, see updateForgeableMonster
+		auto monster = getMonsterByID(monsterId);
+		if (monster && isForgeableMonster(monster)) {
+			return monster;
+		}
+	}
+	return nullptr;
+}
+
 void Game::createFiendishMonsters() {
 	uint32_t created = 0;
 	uint32_t fiendishLimit = g_configManager().getNumber(FORGE_FIENDISH_CREATURES_LIMIT); // Fiendish Creatures limit
@@ -9725,8 +10023,7 @@ void Game::addPlayerUniqueLogin(std::shared_ptr<Player> player) {
 		return;
 	}
 
-	const std::string &lowercase_name = asLowerCaseString(player->getName());
-	m_uniqueLoginPlayerNames[lowercase_name] = player;
+	m_uniqueLoginPlayerNames[player->getName()] = player;
 }
 
 std::shared_ptr<Player> Game::getPlayerUniqueLogin(const std::string &playerName) const {
@@ -9735,7 +10032,7 @@ std::shared_ptr<Player> Game::getPlayerUniqueLogin(const std::string &playerName
 		return nullptr;
 	}
 
-	auto it = m_uniqueLoginPlayerNames.find(asLowerCaseString(playerName));
+	auto it = m_uniqueLoginPlayerNames.find(playerName);
 	return (it != m_uniqueLoginPlayerNames.end()) ? it->second.lock() : nullptr;
 }
 
@@ -9745,8 +10042,7 @@ void Game::removePlayerUniqueLogin(const std::string &playerName) {
 		return;
 	}
 
-	const std::string &lowercase_name = asLowerCaseString(playerName);
-	m_uniqueLoginPlayerNames.erase(lowercase_name);
+	m_uniqueLoginPlayerNames.erase(playerName);
 }
 
 void Game::removePlayerUniqueLogin(std::shared_ptr<Player> player) {
@@ -9755,8 +10051,7 @@ void Game::removePlayerUniqueLogin(std::shared_ptr<Player> player) {
 		return;
 	}
 
-	const std::string &lowercaseName = asLowerCaseString(player->getName());
-	m_uniqueLoginPlayerNames.erase(lowercaseName);
+	m_uniqueLoginPlayerNames.erase(player->getName());
 }
 
 void Game::playerCheckActivity(const std::string &playerName, int interval) {
@@ -9887,22 +10182,28 @@ void Game::setTransferPlayerHouseItems(uint32_t houseId, uint32_t playerId) {
 	transferHouseItemsToPlayer[houseId] = playerId;
 }
 
+// Zone lists hold a few zones at most, a copy so callbacks can change the zones
 template <typename T>
-phmap::parallel_flat_hash_set<T> setDifference(const phmap::parallel_flat_hash_set<T> &setA, const phmap::parallel_flat_hash_set<T> &setB) {
-	phmap::parallel_flat_hash_set<T> setResult;
+std::vector<T> setDifference(std::span<const T> setA, std::span<const T> setB) {
+	std::vector<T> setResult;
 	for (const auto &elem : setA) {
-		if (setB.find(elem) == setB.end()) {
-			setResult.insert(elem);
+		if (std::ranges::find(setB, elem) == setB.end()) {
+			setResult.emplace_back(elem);
 		}
 	}
 	return setResult;
 }
 
-ReturnValue Game::beforeCreatureZoneChange(std::shared_ptr<Creature> creature, const phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> &fromZones, const phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> &toZones, bool force /* = false*/) const {
+ReturnValue Game::beforeCreatureZoneChange(std::shared_ptr<Creature> creature, std::span<const std::shared_ptr<Zone>> fromZones, std::span<const std::shared_ptr<Zone>> toZones, bool force /* = false*/) const {
 	if (!creature) {
 		return RETURNVALUE_NOTPOSSIBLE;
 	}
 
+	// Most of the map is in no zone
+	if (fromZones.empty() && toZones.empty()) {
+		return RETURNVALUE_NOERROR;
+	}
+
 	// fromZones - toZones = zones that creature left
 	auto zonesLeaving = setDifference(fromZones, toZones);
 	// toZones - fromZones = zones that creature entered
@@ -9928,8 +10229,8 @@ ReturnValue Game::beforeCreatureZoneChange(std::shared_ptr<Creature> creature, c
 	return RETURNVALUE_NOERROR;
 }
 
-void Game::afterCreatureZoneChange(std::shared_ptr<Creature> creature, const phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> &fromZones, const phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> &toZones) const {
-	if (!creature) {
+void Game::afterCreatureZoneChange(std::shared_ptr<Creature> creature, std::span<const std::shared_ptr<Zone>> fromZones, std::span<const std::shared_ptr<Zone>> toZones) const {
+	if (!creature || (fromZones.empty() && toZones.empty())) {
 		return;
 	}
 
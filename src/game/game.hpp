@@ -21,9 +21,9 @@
 #include "creatures/players/player.hpp"
 #include "lua/creature/raids.hpp"
 #include "creatures/players/grouping/team_finder.hpp"
+#include "utils/slot_map.hpp"
 #include "utils/wildcardtree.hpp"
 #include "items/items_classification.hpp"
-#include "protobuf/appearances.pb.h"
 
 class ServiceManager;
 class Creature;
@@ -43,6 +43,29 @@ static constexpr int32_t EVENT_DECAYINTERVAL = 250;
 static constexpr int32_t EVENT_DECAY_BUCKETS = 4;
 static constexpr int32_t EVENT_FORGEABLEMONSTERCHECKINTERVAL = 300000;
 static constexpr int32_t EVENT_LUA_GARBAGE_COLLECTION = 60000 * 10; // 10min
+// Up to 1M monsters and as many npcs at once, the rest of their id ranges are the generations of the slots
+static constexpr uint8_t CREATURE_SLOT_BITS = 20;
+
+/**
+ * What the cylinder checks of an item move settled on, worked out once by
+ * Game::planMoveItem and then carried out by Game::internalMoveItem without
+ * asking the cylinders again.
+ */
+struct ItemMovePlan {
+	// The cylinder the item ends up in, after following queryDestination
+	std::shared_ptr<Cylinder> toCylinder;
+	// Stack the item merges into, nullptr to add it as a thing of its own
+	std::shared_ptr<Item> toItem;
+	int32_t index = INDEX_WHEREEVER;
+	uint32_t flags = 0;
+	// Count asked for and count that fits, less only for stackables
+	uint32_t count = 0;
+	uint32_t moveCount = 0;
+	// Why not all of count fits
+	ReturnValue maxCountReturn = RETURNVALUE_NOERROR;
+	// The item already is where it would go, there is nothing to do
+	bool inPlace = false;
+};
 
 class Game {
 public:
@@ -71,6 +94,10 @@ public:
 	 * \returns true if the custom map was loaded successfully
 	 */
 	void loadMainMap(const std::string &filename);
+	// loadMainMap split in two, see Map::loadMapTiles and Map::loadMapData
+	void loadMainMapTiles(const std::string &filename);
+	std::string getMainMapFile() const;
+	void loadMainMapData();
 	/**
 	 * Load the custom map
 	 * \param filename Is the map custom name (Example: "map".otbm, not is necessary add extension .otbm)
@@ -148,8 +175,8 @@ public:
 	bool removeCreature(std::shared_ptr<Creature> creature, bool isLogout = true);
 	void executeDeath(uint32_t creatureId);
 
-	void addCreatureCheck(std::shared_ptr<Creature> creature);
-	static void removeCreatureCheck(std::shared_ptr<Creature> creature);
+	void addCreatureCheck(const std::shared_ptr<Creature> &creature);
+	static void removeCreatureCheck(const std::shared_ptr<Creature> &creature);
 
 	size_t getPlayersOnline() const {
 		return players.size();
@@ -194,6 +221,12 @@ public:
 	ReturnValue internalMoveCreature(const std::shared_ptr<Creature> &creature, const std::shared_ptr<Tile> &toTile, uint32_t flags = 0);
 
 	ReturnValue checkMoveItemToCylinder(std::shared_ptr<Player> player, std::shared_ptr<Cylinder> fromCylinder, std::shared_ptr<Cylinder> toCylinder, std::shared_ptr<Item> item, Position toPos);
+	/**
+	 * Runs the checks of moving the item, an item in the way of a non stackable
+	 * one is swapped into fromCylinder when it fits there, as the client expects.
+	 * \returns RETURNVALUE_NOERROR when the plan can be carried out
+	 */
+	ReturnValue planMoveItem(const std::shared_ptr<Cylinder> &fromCylinder, std::shared_ptr<Cylinder> toCylinder, int32_t index, const std::shared_ptr<Item> &item, uint32_t count, uint32_t flags, const std::shared_ptr<Creature> &actor, const std::shared_ptr<Item> &tradeItem, ItemMovePlan &plan);
 	ReturnValue internalMoveItem(std::shared_ptr<Cylinder> fromCylinder, std::shared_ptr<Cylinder> toCylinder, int32_t index, std::shared_ptr<Item> item, uint32_t count, std::shared_ptr<Item>* movedItem, uint32_t flags = 0, std::shared_ptr<Creature> actor = nullptr, std::shared_ptr<Item> tradeItem = nullptr, bool checkTile = true);
 
 	ReturnValue internalAddItem(std::shared_ptr<Cylinder> toCylinder, std::shared_ptr<Item> item, int32_t index = INDEX_WHEREEVER, uint32_t flags = 0, bool test = false);
@@ -225,6 +258,9 @@ public:
 	void loadPlayersRecord();
 	void checkPlayersRecord();
 
+	// Players in view of pos, taken from the cast in progress when it covers pos (see CombatSpectators)
+	void getCombatSpectators(SpectatorHashSet &spectators, const Position &pos, bool multifloor);
+
 	void sendSingleSoundEffect(const Position &pos, SoundEffect_t soundId, std::shared_ptr<Creature> actor = nullptr);
 	void sendDoubleSoundEffect(const Position &pos, SoundEffect_t mainSoundEffect, SoundEffect_t secondarySoundEffect, std::shared_ptr<Creature> actor = nullptr);
 
@@ -264,6 +300,8 @@ public:
 
 	void playerReportRuleViolationReport(uint32_t playerId, const std::string &targetName, uint8_t reportType, uint8_t reportReason, const std::string &comment, const std::string &translation);
 
+	// Keeps the cyclopedia records of the victim and its killers current, the row itself is written by the script
+	void addPlayerDeathRecord(const std::shared_ptr<Player> &player, PlayerDeathRecord record, bool killedByPlayer, bool mostDamageByPlayer);
 	void playerCyclopediaCharacterInfo(std::shared_ptr<Player> player, uint32_t characterID, CyclopediaCharacterInfoType_t characterInfoType, uint16_t entriesPerPage, uint16_t page);
 
 	void playerHighscores(std::shared_ptr<Player> player, HighscoreType_t type, uint8_t category, uint32_t vocation, const std::string &worldName, uint16_t page, uint8_t entriesPerPage);
@@ -421,10 +459,15 @@ public:
 	void checkCreatureAttack(uint32_t creatureId);
 	void checkCreatures(size_t index);
 	void checkLight();
+	void checkTaskProfiler();
+	void checkAllocationProfiler();
+	void evictUntouchedTiles();
+	void flushKV();
+	void cleanMapSlice();
 
 	bool combatBlockHit(CombatDamage &damage, std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target, bool checkDefense, bool checkArmor, bool field);
 
-	void combatGetTypeInfo(CombatType_t combatType, std::shared_ptr<Creature> target, TextColor_t &color, uint16_t &effect);
+	void combatGetTypeInfo(CombatType_t combatType, const std::shared_ptr<Creature> &target, TextColor_t &color, uint16_t &effect);
 
 	// Hazard combat helpers
 	void handleHazardSystemAttack(CombatDamage &damage, std::shared_ptr<Player> player, const std::shared_ptr<Monster> monster, bool isPlayerAttacker);
@@ -435,7 +478,7 @@ public:
 	void applyWheelOfDestinyEffectsToDamage(CombatDamage &damage, std::shared_ptr<Player> attackerPlayer, std::shared_ptr<Creature> target) const;
 	int32_t applyHealthChange(CombatDamage &damage, std::shared_ptr<Creature> target) const;
 
-	bool combatChangeHealth(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target, CombatDamage &damage, bool isEvent = false);
+	bool combatChangeHealth(const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, CombatDamage &damage, bool isEvent = false);
 	void applyCharmRune(std::shared_ptr<Monster> targetMonster, std::shared_ptr<Player> attackerPlayer, std::shared_ptr<Creature> target, const int32_t &realDamage) const;
 	void applyManaLeech(
 		std::shared_ptr<Player> attackerPlayer, std::shared_ptr<Monster> targetMonster,
@@ -446,7 +489,7 @@ public:
 		std::shared_ptr<Creature> target, const CombatDamage &damage, const int32_t &realDamage
 	) const;
 	int32_t calculateLeechAmount(const int32_t &realDamage, const uint16_t &skillAmount, int targetsAffected) const;
-	bool combatChangeMana(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target, CombatDamage &damage);
+	bool combatChangeMana(const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, CombatDamage &damage);
 
 	// Animation help functions
 	void addCreatureHealth(const std::shared_ptr<Creature> target);
@@ -486,10 +529,10 @@ public:
 	const phmap::flat_hash_map<uint32_t, std::shared_ptr<Player>> &getPlayers() const {
 		return players;
 	}
-	const std::map<uint32_t, std::shared_ptr<Monster>> &getMonsters() const {
+	const SlotMap<std::shared_ptr<Monster>, CREATURE_SLOT_BITS> &getMonsters() const {
 		return monsters;
 	}
-	const std::map<uint32_t, std::shared_ptr<Npc>> &getNpcs() const {
+	const SlotMap<std::shared_ptr<Npc>, CREATURE_SLOT_BITS> &getNpcs() const {
 		return npcs;
 	}
 
@@ -500,16 +543,30 @@ public:
 	void addPlayer(std::shared_ptr<Player> player);
 	void removePlayer(std::shared_ptr<Player> player);
 
+	// The watcher must be online, the ones loading are added with their whole VIP list by addPlayer
+	void addVipWatcher(uint32_t guid, uint32_t watcherId);
+	void removeVipWatcher(uint32_t guid, uint32_t watcherId);
+	// Sends the status of the player to the online players having it on their VIP list, the ones passing the filter when given
+	void notifyVipStatusChange(const std::shared_ptr<Player> &player, VipStatus_t status, bool message = true, const std::function<bool(const std::shared_ptr<Player> &)> &filter = nullptr);
+	// A player of another world of the cluster changed status
+	void notifyRemoteVipStatusChange(uint32_t guid, const std::string &name, VipStatus_t status);
+
 	void addNpc(std::shared_ptr<Npc> npc);
 	void removeNpc(std::shared_ptr<Npc> npc);
 
 	void addMonster(std::shared_ptr<Monster> npc);
 	void removeMonster(std::shared_ptr<Monster> npc);
 
-	std::shared_ptr<Guild> getGuild(uint32_t id, bool allowOffline = false) const;
-	std::shared_ptr<Guild> getGuildByName(const std::string &name, bool allowOffline = false) const;
+	// Guilds without online members are only returned with allowOffline, guilds missing from the cache are loaded then
+	std::shared_ptr<Guild> getGuild(uint32_t id, bool allowOffline = false);
+	std::shared_ptr<Guild> getGuildByName(const std::string &name, bool allowOffline = false);
 	void addGuild(const std::shared_ptr<Guild> guild);
-	void removeGuild(uint32_t guildId);
+	// The guild stays cached, only its changes are written
+	void saveOfflineGuild(uint32_t guildId);
+
+	bool isGuildsAtWar(uint32_t guildId, uint32_t enemyGuildId) const;
+	bool hasGuildWars(uint32_t guildId) const;
+	void setGuildWars(const std::vector<std::pair<uint32_t, uint32_t>> &wars);
 
 	phmap::flat_hash_map<std::shared_ptr<Tile>, std::weak_ptr<Container>> browseFields;
 
@@ -530,7 +587,6 @@ public:
 	Map map;
 	Mounts mounts;
 	Raids raids;
-	Canary::protobuf::appearances::Appearances appearances;
 
 	phmap::flat_hash_set<std::shared_ptr<Tile>> getTilesToClean() const {
 		return tilesToClean;
@@ -545,6 +601,14 @@ public:
 		tilesToClean.clear();
 	}
 
+	/**
+	 * Map::clean spread over mapCleanIncrementalWindow, a slice of the tiles to clean
+	 * every MAP_CLEAN_SLICE_INTERVAL instead of the whole map in one task.
+	 * Map::clean stays for shutdown and anything that needs the items gone right away.
+	 * Returns the tiles queued, 0 if there was nothing to clean or a clean is already running.
+	 */
+	size_t startIncrementalClean();
+
 	void playerInspectItem(std::shared_ptr<Player> player, const Position &pos);
 	void playerInspectItem(std::shared_ptr<Player> player, uint16_t itemId, uint8_t itemCount, bool cyclopedia);
 
@@ -557,17 +621,18 @@ public:
 		return CharmList;
 	}
 
+	// The message is parsed on an arena freed once the item types and the ids below are taken from it
 	FILELOADER_ERRORS loadAppearanceProtobuf(const std::string &file);
 	bool isMagicEffectRegistered(uint16_t type) const {
-		return std::find(registeredMagicEffects.begin(), registeredMagicEffects.end(), type) != registeredMagicEffects.end();
+		return std::ranges::binary_search(registeredMagicEffects, type);
 	}
 
 	bool isDistanceEffectRegistered(uint16_t type) const {
-		return std::find(registeredDistanceEffects.begin(), registeredDistanceEffects.end(), type) != registeredDistanceEffects.end();
+		return std::ranges::binary_search(registeredDistanceEffects, type);
 	}
 
 	bool isLookTypeRegistered(uint16_t type) const {
-		return std::find(registeredLookTypes.begin(), registeredLookTypes.end(), type) != registeredLookTypes.end();
+		return std::ranges::binary_search(registeredLookTypes, type);
 	}
 
 	void setCreateLuaItems(Position position, uint16_t itemId) {
@@ -589,6 +654,8 @@ public:
 	void createFiendishMonsters();
 	void createInfluencedMonsters();
 	void updateForgeableMonsters();
+	// Adds the monster to the forge candidates or takes it out, as it may become fiendish or influenced or not
+	void updateForgeableMonster(const std::shared_ptr<Monster> &monster);
 	void checkForgeEventId(uint32_t monsterId);
 	uint32_t makeFiendishMonster(uint32_t forgeableMonsterId = 0, bool createForgeableMonsters = false);
 	uint32_t makeInfluencedMonster();
@@ -648,8 +715,8 @@ public:
 	 */
 	bool tryRetrieveStashItems(std::shared_ptr<Player> player, std::shared_ptr<Item> item);
 
-	ReturnValue beforeCreatureZoneChange(std::shared_ptr<Creature> creature, const phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> &fromZones, const phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> &toZones, bool force = false) const;
-	void afterCreatureZoneChange(std::shared_ptr<Creature> creature, const phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> &fromZones, const phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> &toZones) const;
+	ReturnValue beforeCreatureZoneChange(std::shared_ptr<Creature> creature, std::span<const std::shared_ptr<Zone>> fromZones, std::span<const std::shared_ptr<Zone>> toZones, bool force = false) const;
+	void afterCreatureZoneChange(std::shared_ptr<Creature> creature, std::span<const std::shared_ptr<Zone>> fromZones, std::span<const std::shared_ptr<Zone>> toZones) const;
 
 	std::unique_ptr<IOWheel> &getIOWheel();
 	const std::unique_ptr<IOWheel> &getIOWheel() const;
@@ -667,7 +734,7 @@ private:
 	bool playerYell(std::shared_ptr<Player> player, const std::string &text);
 	bool playerSpeakTo(std::shared_ptr<Player> player, SpeakClasses type, const std::string &receiver, const std::string &text);
 	void playerSpeakToNpc(std::shared_ptr<Player> player, const std::string &text);
-	std::shared_ptr<Task> createPlayerTask(uint32_t delay, std::function<void(void)> f, std::string context) const;
+	std::shared_ptr<Task> createPlayerTask(uint32_t delay, TaskFunction &&f, std::string_view context) const;
 
 	/**
 	 * Player wants to loot a corpse
@@ -752,10 +819,17 @@ private:
 	 */
 	ReturnValue collectRewardChestItems(std::shared_ptr<Player> player, uint32_t maxMoveItems = 0);
 
-	phmap::flat_hash_map<std::string, std::weak_ptr<Player>> m_uniqueLoginPlayerNames;
+	phmap::flat_hash_map<std::string, std::weak_ptr<Player>, CaseInsensitiveHash, CaseInsensitiveEqual> m_uniqueLoginPlayerNames;
 	phmap::flat_hash_map<uint32_t, std::shared_ptr<Player>> players;
-	phmap::flat_hash_map<std::string, std::weak_ptr<Player>> mappedPlayerNames;
+	phmap::flat_hash_map<std::string, std::weak_ptr<Player>, CaseInsensitiveHash, CaseInsensitiveEqual> mappedPlayerNames;
+	phmap::flat_hash_map<uint32_t, std::weak_ptr<Player>> mappedPlayerGuids;
+	// Player guid to the ids of the online players having it on their VIP list
+	phmap::flat_hash_map<uint32_t, phmap::flat_hash_set<uint32_t>> vipWatchers;
 	phmap::flat_hash_map<uint32_t, std::shared_ptr<Guild>> guilds;
+	phmap::flat_hash_map<std::string, uint32_t, CaseInsensitiveHash, CaseInsensitiveEqual> guildIdsByName;
+	// The active wars by the lower and higher guild id, and how many each guild is in
+	phmap::flat_hash_set<uint64_t> guildWars;
+	phmap::flat_hash_map<uint32_t, uint32_t> guildWarCounts;
 	phmap::flat_hash_map<uint16_t, std::shared_ptr<Item>> uniqueItems;
 	std::map<uint32_t, uint32_t> stages;
 
@@ -763,14 +837,17 @@ private:
 	 * For example: ActionFunctions::luaActionPosition
 	 * This basically works so that the item is created after the map is loaded, because the scripts are loaded before the map is loaded, we will use this table to create items that don't exist in the map natively through each script
 	 */
-	std::map<Position, uint16_t> mapLuaItemsStored;
+	phmap::flat_hash_map<Position, uint16_t> mapLuaItemsStored;
 
 	std::map<uint16_t, std::string> BestiaryList;
 	std::string boostedCreature = "";
 
 	std::vector<std::shared_ptr<Charm>> CharmList;
 	std::vector<std::shared_ptr<Creature>> checkCreatureLists[EVENT_CREATURECOUNT];
+	// Live creatures of the bucket being checked, kept alive by checkCreatureLists, reused between ticks
+	std::vector<Creature*> checkCreatureBatch;
 
+	// Sorted ids
 	std::vector<uint16_t> registeredMagicEffects;
 	std::vector<uint16_t> registeredDistanceEffects;
 	std::vector<uint16_t> registeredLookTypes;
@@ -778,11 +855,19 @@ private:
 	size_t lastBucket = 0;
 	size_t lastImbuedBucket = 0;
 
-	WildcardTreeNode wildcardTree { false };
+	WildcardTree wildcardTree;
 
-	std::map<uint32_t, std::shared_ptr<Npc>> npcs;
-	std::map<uint32_t, std::shared_ptr<Monster>> monsters;
+	// Players keep the ids of their guids, monsters and npcs get theirs from these
+	SlotMap<std::shared_ptr<Npc>, CREATURE_SLOT_BITS> npcs { Npc::FIRST_ID, Npc::LAST_ID };
+	SlotMap<std::shared_ptr<Monster>, CREATURE_SLOT_BITS> monsters { Monster::FIRST_ID, Monster::LAST_ID };
+	// Forge candidates, kept on monster add, remove and eligibility changes and dense for O(1) random picks
 	std::vector<uint32_t> forgeableMonsters;
+	phmap::flat_hash_map<uint32_t, size_t> forgeableMonsterIndexes;
+
+	bool isForgeableMonster(const std::shared_ptr<Monster> &monster) const;
+	void removeForgeableMonster(uint32_t monsterId);
+	// Takes a random candidate out of the set, dropping the ones no longer eligible on the way; nullptr when none is left
+	std::shared_ptr<Monster> takeForgeableMonster(bool normalDistribution);
 
 	std::map<uint32_t, std::unique_ptr<TeamFinder>> teamFinderMap; // [leaderGUID] = TeamFinder*
 
@@ -795,6 +880,16 @@ private:
 
 	phmap::flat_hash_set<std::shared_ptr<Tile>> tilesToClean;
 
+	struct IncrementalClean {
+		// Snapshot of tilesToClean, the tiles may be evicted meanwhile
+		std::vector<std::weak_ptr<Tile>> tiles;
+		size_t cursor = 0;
+		size_t tilesPerSlice = 0;
+		uint32_t removed = 0;
+		int64_t startedAt = 0;
+	};
+	IncrementalClean incrementalClean;
+
 	ModalWindow offlineTrainingWindow { std::numeric_limits<uint32_t>::max(), "Choose a Skill", "Please choose a skill:" };
 
 	static constexpr int32_t DAY_LENGTH_SECONDS = 3600;
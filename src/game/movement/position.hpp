@@ -70,6 +70,11 @@ struct Position {
 
 	static Direction getRandomDirection();
 
+	// x, y and z side by side in one integer, distinct for every position
+	constexpr uint64_t pack() const {
+		return static_cast<uint64_t>(x) | (static_cast<uint64_t>(y) << 16) | (static_cast<uint64_t>(z) << 32);
+	}
+
 	uint16_t x = 0;
 	uint16_t y = 0;
 	uint8_t z = 0;
@@ -124,7 +129,7 @@ namespace std {
 	template <>
 	struct hash<Position> {
 		std::size_t operator()(const Position &p) const {
-			return static_cast<std::size_t>(p.x) | (static_cast<std::size_t>(p.y) << 16) | (static_cast<std::size_t>(p.z) << 32);
+			return static_cast<std::size_t>(p.pack());
 		}
 	};
 }
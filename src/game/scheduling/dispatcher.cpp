@@ -9,24 +9,40 @@
 
 #include "pch.hpp"
 
+#include "config/configmanager.hpp"
 #include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
+#include "lib/profiling/allocation_profiler.hpp"
+#include "lib/profiling/profiler.hpp"
 #include "lib/thread/thread_pool.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/task.hpp"
+#include "utils/tools.hpp"
 
 Dispatcher::Dispatcher(ThreadPool &threadPool) :
-	threadPool(threadPool) { }
+	threadPool(threadPool),
+	gameThread([this](const std::stop_token &stopToken) { gameThreadMain(stopToken); }) { }
+
+Dispatcher::~Dispatcher() {
+	// The jthread would join itself when the game thread is the one destroying it
+	if (gameThread.joinable() && isGameThread()) {
+		gameThread.request_stop();
+		gameThread.detach();
+	}
+}
 
 Dispatcher &Dispatcher::getInstance() {
 	return inject<Dispatcher>();
 }
 
-void Dispatcher::addTask(std::function<void(void)> f, const std::string &context) {
-	addTask(std::make_shared<Task>(std::move(f), context));
+void Dispatcher::addTask(TaskFunction &&f, std::string_view context) {
+	enqueue(Task(std::move(f), context));
 }
 
-void Dispatcher::addTask(std::function<void(void)> f, const std::string &context, uint32_t expiresAfterMs) {
-	addTask(std::make_shared<Task>(std::move(f), context), expiresAfterMs);
+void Dispatcher::addTask(TaskFunction &&f, std::string_view context, uint32_t expiresAfterMs) {
+	Task task(std::move(f), context);
+	task.setExpiration(expiresAfterMs);
+	enqueue(std::move(task));
 }
 
 void Dispatcher::addTask(const std::shared_ptr<Task> task) {
@@ -34,41 +50,194 @@ void Dispatcher::addTask(const std::shared_ptr<Task> task) {
 }
 
 void Dispatcher::addTask(const std::shared_ptr<Task> task, uint32_t expiresAfterMs) {
-	auto executeTask = [this, task]() {
-		std::lock_guard lockClass(threadSafetyMutex);
+	Task wrapper([task]() { (*task)(); }, task->getContext());
+	wrapper.setLane(task->getLane());
+	wrapper.setExpiration(expiresAfterMs);
+	enqueue(std::move(wrapper));
+}
 
-		if (task->hasTraceableContext()) {
-			g_logger().trace("Executing task {}.", task->getContext());
-		} else {
-			g_logger().debug("Executing task {}.", task->getContext());
+void Dispatcher::addTasks(std::vector<std::shared_ptr<Task>> &&tasks) {
+	if (tasks.empty()) {
+		return;
+	}
+
+	// One queue entry per lane, so scheduled background work does not run ahead of input
+	std::array<std::vector<std::shared_ptr<Task>>, TASK_LANE_COUNT> lanes;
+	const auto now = std::chrono::steady_clock::now();
+	for (auto &task : tasks) {
+		task->setQueuedAt(now);
+		lanes[task->getLane()].emplace_back(std::move(task));
+	}
+
+	for (uint8_t lane = 0; lane < TASK_LANE_COUNT; ++lane) {
+		if (lanes[lane].empty()) {
+			continue;
 		}
 
-		++dispatcherCycle;
-		(*task)();
-	};
-
-	if (expiresAfterMs == 0) {
-		threadPool.addLoad(executeTask);
+		Task batch(
+			[this, tasks = std::move(lanes[lane])]() {
+				for (const auto &task : tasks) {
+					executeTask(*task);
+				}
+			},
+			"Dispatcher::addTasks"
+		);
+		batch.setLane(static_cast<TaskLane_t>(lane));
+		enqueue(std::move(batch));
+	}
+}
 
+void Dispatcher::shutdown() {
+	if (!gameThread.joinable()) {
 		return;
-	};
+	}
 
-	auto timer = std::make_shared<asio::steady_timer>(threadPool.getIoContext());
-	timer->expires_after(std::chrono::milliseconds(expiresAfterMs));
+	watchdog.stop();
+	gameThread.request_stop();
 
-	timer->async_wait([task, expiresAfterMs](const std::error_code &error) {
-		if (error == asio::error::operation_aborted) {
-			return;
-		}
+	// The game thread itself may trigger the shutdown, it leaves the loop on its own and the owner joins it
+	if (!isGameThread()) {
+		gameThread.join();
+	}
+}
+
+void Dispatcher::enqueue(Task &&task) {
+	task.setQueuedAt(std::chrono::steady_clock::now());
+	taskQueues[task.getLane()].push(std::move(task));
+
+	// Only the producer that flips the flag needs to wake the game thread up
+	if (!hasPendingTasks.exchange(true, std::memory_order_acq_rel)) {
+		hasPendingTasks.notify_one();
+	}
+}
 
-		g_logger().info("Task '{}' was not executed within {} ms, so it was cancelled.", task->getContext(), expiresAfterMs);
+void Dispatcher::gameThreadMain(const std::stop_token &stopToken) {
+	CANARY_PROFILE_THREAD("game");
+	std::stop_callback wakeUpOnStop(stopToken, [this]() {
+		hasPendingTasks.store(true, std::memory_order_release);
+		hasPendingTasks.notify_one();
 	});
 
-	threadPool.addLoad([timer, executeTask]() {
-		if (timer->cancel() <= 0) {
-			return;
+	auto &backgroundBatch = laneBatches[TASK_LANE_BACKGROUND];
+	auto &cycleTime = g_metrics().getHistogram(
+		"canary_dispatcher_cycle_seconds", "Time the game thread spent per dispatcher cycle",
+		{ 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000 }, 1e6
+	);
+	while (!stopToken.stop_requested()) {
+		// Background tasks carried over from the last cycle must not wait for a producer
+		if (backgroundBatch.empty()) {
+			hasPendingTasks.wait(false, std::memory_order_acquire);
 		}
+		// Must be a read-modify-write, so we synchronize with every producer that saw the flag already set
+		hasPendingTasks.exchange(false, std::memory_order_acq_rel);
 
-		executeTask();
-	});
+		// Tasks added while this cycle runs belong to the next one
+		size_t popped = 0;
+		for (uint8_t lane = 0; lane < TASK_LANE_COUNT; ++lane) {
+			popped += taskQueues[lane].popAll(laneBatches[lane]);
+		}
+
+		if (popped == 0 && backgroundBatch.empty()) {
+			continue;
+		}
+
+		dispatcherCycle.fetch_add(1, std::memory_order_relaxed);
+		const auto cycleStartedAt = std::chrono::steady_clock::now();
+
+		for (uint8_t lane = 0; lane < TASK_LANE_BACKGROUND; ++lane) {
+			for (auto &task : laneBatches[lane]) {
+				executeTask(task);
+			}
+			laneBatches[lane].clear();
+		}
+
+		runBackgroundLane();
+
+		refreshGameTime();
+		for (const auto &handler : cycleEndHandlers) {
+			handler();
+		}
+
+		const auto cycleFinishedAt = std::chrono::steady_clock::now();
+		const auto cycleUs = std::chrono::duration_cast<std::chrono::microseconds>(cycleFinishedAt - cycleStartedAt).count();
+		cycleTime.observe(cycleUs);
+		busyTime.fetch_add(cycleUs, std::memory_order_relaxed);
+		if (recorder.isRunning()) {
+			recorder.endCycle(cycleStartedAt, cycleFinishedAt);
+		}
+		g_metrics().collect();
+		CANARY_PROFILE_FRAME("dispatcher cycle");
+	}
+}
+
+void Dispatcher::runBackgroundLane() {
+	auto &batch = laneBatches[TASK_LANE_BACKGROUND];
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(DISPATCHER_BACKGROUND_BUDGET_MS);
+	const auto &networkQueue = taskQueues[TASK_LANE_NETWORK];
+
+	// Always runs at least one task, so the lane can not starve
+	size_t executed = 0;
+	while (executed < batch.size()) {
+		executeTask(batch[executed++]);
+		if (!networkQueue.empty() || std::chrono::steady_clock::now() >= deadline) {
+			break;
+		}
+	}
+
+	batch.erase(batch.begin(), batch.begin() + executed);
+}
+
+void Dispatcher::executeTask(Task &task) {
+	if (task.hasExpired(std::chrono::steady_clock::now())) {
+		g_logger().info("Task '{}' was not executed within {} ms, so it was cancelled.", task.getContext(), task.getExpiration());
+		return;
+	}
+
+	refreshGameTime();
+
+	CANARY_PROFILE_ZONE("Dispatcher::executeTask");
+	CANARY_PROFILE_ZONE_TEXT(task.getContext());
+	const AllocationProfiler::Scope allocationScope(task.getContext());
+
+	if (task.hasTraceableContext()) {
+		g_logger().trace("Executing task {}.", task.getContext());
+	} else {
+		g_logger().debug("Executing task {}.", task.getContext());
+	}
+
+	// A batch is watched through the tasks it runs
+	const bool watched = watchdog.isRunning() && task.getContext() != "Dispatcher::addTasks";
+	if (watched) {
+		watchdog.enter(task.getContext());
+	}
+
+	const bool profiled = g_configManager().getBoolean(TOGGLE_TASK_PROFILER);
+	if (!profiled && !recorder.isRunning()) {
+		task();
+		if (watched) {
+			watchdog.leave();
+		}
+		return;
+	}
+
+	const auto startedAt = std::chrono::steady_clock::now();
+	task();
+	const auto finishedAt = std::chrono::steady_clock::now();
+	if (watched) {
+		watchdog.leave();
+	}
+
+	// Batched scheduler tasks are only accounted individually
+	if (task.getContext() == "Dispatcher::addTasks") {
+		return;
+	}
+
+	const auto wait = std::chrono::duration_cast<std::chrono::microseconds>(startedAt - task.getQueuedAt());
+	if (recorder.isRunning()) {
+		recorder.record(task.getContext(), startedAt, finishedAt, wait);
+	}
+
+	if (profiled) {
+		profiler.record(task.getContext(), wait.count(), std::chrono::duration_cast<std::chrono::microseconds>(finishedAt - startedAt).count());
+	}
 }
@@ -10,19 +10,36 @@
 #pragma once
 
 #include "lib/thread/thread_pool.hpp"
+#include "lib/thread/mpsc_queue.hpp"
+#include "game/scheduling/task.hpp"
+#include "game/scheduling/task_profiler.hpp"
+#include "game/scheduling/task_recorder.hpp"
+#include "game/scheduling/task_watchdog.hpp"
 
 const int DISPATCHER_TASK_EXPIRATION = 2000;
-
-class Task;
+// Time the background lane may take per cycle before yielding to the other lanes
+const int DISPATCHER_BACKGROUND_BUDGET_MS = 10;
 
 /**
  * Dispatcher allow you to dispatch a task async to be executed
  * in the dispatching thread. You can dispatch with an expiration
  * time, after which the task will be ignored.
+ *
+ * All game logic runs on a single dedicated game thread: producers push
+ * into a lock-free queue and the game thread drains it in batches, one
+ * batch per dispatcher cycle. The thread pool is left free for I/O and
+ * offloaded work.
+ *
+ * Every task lane (see TaskLane_t) has its own queue. A cycle runs the
+ * network, combat and AI lanes in full, then background tasks until the
+ * budget is spent or network input arrives; the rest carries over.
+ * Expiration is checked against the queue timestamp right before running.
+ * Cycle end handlers run last, e.g. to flush what the cycle sent to clients.
  */
 class Dispatcher {
 public:
 	explicit Dispatcher(ThreadPool &threadPool);
+	~Dispatcher();
 
 	// Ensures that we don't accidentally copy it
 	Dispatcher(const Dispatcher &) = delete;
@@ -30,20 +47,78 @@ public:
 
 	static Dispatcher &getInstance();
 
-	void addTask(std::function<void(void)> f, const std::string &context);
-	void addTask(std::function<void(void)> f, const std::string &context, uint32_t expiresAfterMs);
+	void addTask(TaskFunction &&f, std::string_view context);
+	void addTask(TaskFunction &&f, std::string_view context, uint32_t expiresAfterMs);
 
 	void addTask(const std::shared_ptr<Task> task);
 	void addTask(const std::shared_ptr<Task> task, uint32_t expiresAfterMs);
 
+	// Dispatches every task with a single queue entry, they run in order in the same cycle
+	void addTasks(std::vector<std::shared_ptr<Task>> &&tasks);
+
+	// Game thread only, the handler runs at the end of every dispatcher cycle
+	void addCycleEndHandler(std::function<void()> &&handler) {
+		cycleEndHandlers.emplace_back(std::move(handler));
+	}
+	// Same, but runs before the handlers added so far, for output the cycle end flush should still send
+	void prependCycleEndHandler(std::function<void()> &&handler) {
+		cycleEndHandlers.emplace(cycleEndHandlers.begin(), std::move(handler));
+	}
+
+	// Stops the game thread and waits for it, from the game thread itself it only asks it to stop
+	void shutdown();
+
 	[[nodiscard]] uint64_t getDispatcherCycle() const {
-		return dispatcherCycle;
+		return dispatcherCycle.load(std::memory_order_relaxed);
+	}
+
+	// Time the game thread spent running cycles since it started
+	[[nodiscard]] std::chrono::microseconds getBusyTime() const {
+		return std::chrono::microseconds(busyTime.load(std::memory_order_relaxed));
+	}
+
+	// Game thread only
+	[[nodiscard]] TaskProfiler &getProfiler() {
+		return profiler;
+	}
+
+	[[nodiscard]] TaskWatchdog &getWatchdog() {
+		return watchdog;
+	}
+
+	// Game thread only
+	[[nodiscard]] TaskRecorder &getRecorder() {
+		return recorder;
+	}
+
+	[[nodiscard]] bool isGameThread() const {
+		return std::this_thread::get_id() == gameThread.get_id();
 	}
 
 private:
+	void enqueue(Task &&task);
+	void gameThreadMain(const std::stop_token &stopToken);
+	void runBackgroundLane();
+	void executeTask(Task &task);
+
 	ThreadPool &threadPool;
-	uint64_t dispatcherCycle = 0;
-	std::mutex threadSafetyMutex;
+	std::atomic<uint64_t> dispatcherCycle = 0;
+	std::atomic<uint64_t> busyTime = 0;
+
+	std::array<MPSCQueue<Task>, TASK_LANE_COUNT> taskQueues;
+	std::atomic_bool hasPendingTasks = false;
+
+	// Reused between cycles to avoid reallocating the batches every tick
+	std::array<std::vector<Task>, TASK_LANE_COUNT> laneBatches;
+
+	std::vector<std::function<void()>> cycleEndHandlers;
+
+	TaskProfiler profiler;
+	TaskWatchdog watchdog;
+	TaskRecorder recorder;
+
+	// Must be the last member, so the queue outlives the thread
+	std::jthread gameThread;
 };
 
 constexpr auto g_dispatcher = Dispatcher::getInstance;
@@ -14,16 +14,21 @@
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/scheduler.hpp"
 #include "game/scheduling/task.hpp"
+#include "lib/profiling/profiler.hpp"
 
 Scheduler::Scheduler(ThreadPool &threadPool) :
-	threadPool(threadPool) { }
+	threadPool(threadPool),
+	startTime(std::chrono::steady_clock::now()),
+	tickTimer(threadPool.getIoContext()) {
+	scheduleNextTick();
+}
 
 Scheduler &Scheduler::getInstance() {
 	return inject<Scheduler>();
 }
 
-uint64_t Scheduler::addEvent(uint32_t delay, std::function<void(void)> f, std::string context) {
-	return addEvent(std::make_shared<Task>(std::move(f), std::move(context), delay));
+uint64_t Scheduler::addEvent(uint32_t delay, TaskFunction &&f, std::string_view context) {
+	return addEvent(std::make_shared<Task>(std::move(f), context, delay));
 }
 
 uint64_t Scheduler::addEvent(const std::shared_ptr<Task> task) {
@@ -31,41 +36,61 @@ uint64_t Scheduler::addEvent(const std::shared_ptr<Task> task) {
 		task->setEventId(++lastEventId);
 	}
 
-	threadPool.addLoad([this, task]() {
-		std::lock_guard lockAdd(threadSafetyMutex);
-		auto [item, wasAdded] = eventIds.try_emplace(task->getEventId(), threadPool.getIoContext());
+	const auto expiresAt = std::chrono::steady_clock::now() + std::chrono::milliseconds(task->getDelay());
 
-		asio::steady_timer &timer = item->second;
-		timer.expires_from_now(std::chrono::milliseconds(task->getDelay()));
+	std::lock_guard lockAdd(threadSafetyMutex);
+	wheel.add(task, getTick(expiresAt, true));
 
-		timer.async_wait([this, task](const asio::error_code &error) {
-			std::lock_guard lockAsyncCallback(threadSafetyMutex);
-			eventIds.erase(task->getEventId());
+	return task->getEventId();
+}
+
+void Scheduler::stopEvent(uint64_t eventId) {
+	std::lock_guard lockClass(threadSafetyMutex);
+	wheel.remove(eventId);
+}
 
-			if (error == asio::error::operation_aborted || threadPool.getIoContext().stopped()) {
-				return;
-			}
+size_t Scheduler::getEventCount() {
+	std::lock_guard lockClass(threadSafetyMutex);
+	return wheel.size();
+}
 
-			if (task->hasTraceableContext()) {
-				g_logger().trace("Dispatching scheduled task {}.", task->getContext());
-			} else {
-				g_logger().debug("Dispatching scheduled task {}.", task->getContext());
-			}
+void Scheduler::scheduleNextTick() {
+	tickTimer.expires_at(startTime + std::chrono::milliseconds(SCHEDULER_MINTICKS) * (getTick(std::chrono::steady_clock::now(), false) + 1));
+	tickTimer.async_wait([this](const asio::error_code &error) {
+		if (error == asio::error::operation_aborted || threadPool.getIoContext().stopped()) {
+			return;
+		}
 
-			g_dispatcher().addTask(task);
-		});
+		onTick();
+		scheduleNextTick();
 	});
-
-	return task->getEventId();
 }
 
-void Scheduler::stopEvent(uint64_t eventId) {
-	threadPool.addLoad([this, eventId]() {
-		std::lock_guard lockClass(threadSafetyMutex);
-		auto it = eventIds.find(eventId);
+void Scheduler::onTick() {
+	CANARY_PROFILE_ZONE("Scheduler::onTick");
+	std::vector<std::shared_ptr<Task>> expiredTasks;
+	{
+		std::lock_guard lockTick(threadSafetyMutex);
+		wheel.advance(getTick(std::chrono::steady_clock::now(), false), expiredTasks);
+	}
 
-		if (it != eventIds.end()) {
-			it->second.cancel();
+	if (expiredTasks.empty()) {
+		return;
+	}
+
+	for (const auto &task : expiredTasks) {
+		if (task->hasTraceableContext()) {
+			g_logger().trace("Dispatching scheduled task {}.", task->getContext());
+		} else {
+			g_logger().debug("Dispatching scheduled task {}.", task->getContext());
 		}
-	});
+	}
+
+	g_dispatcher().addTasks(std::move(expiredTasks));
+}
+
+uint64_t Scheduler::getTick(std::chrono::steady_clock::time_point time, bool roundUp) const {
+	const auto elapsed = time - startTime;
+	const auto elapsedMs = roundUp ? std::chrono::ceil<std::chrono::milliseconds>(elapsed).count() : std::chrono::floor<std::chrono::milliseconds>(elapsed).count();
+	return static_cast<uint64_t>((elapsedMs + (roundUp ? SCHEDULER_MINTICKS - 1 : 0)) / SCHEDULER_MINTICKS);
 }
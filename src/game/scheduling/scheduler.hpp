@@ -10,14 +10,18 @@
 #pragma once
 
 #include "lib/thread/thread_pool.hpp"
+#include "game/scheduling/task.hpp"
+#include "game/scheduling/timing_wheel.hpp"
 
 static constexpr int32_t SCHEDULER_MINTICKS = 50;
 
-class Task;
-
 /**
  * Scheduler allow you to schedule a task async to be executed after a
  * given period. Once the time has passed, scheduler calls the task.
+ *
+ * Events are kept in a timing wheel with SCHEDULER_MINTICKS buckets and a
+ * single timer drives it, so an event never fires before its delay and at
+ * most one bucket after. Every expired batch goes to the dispatcher at once.
  */
 class Scheduler {
 public:
@@ -29,15 +33,24 @@ public:
 
 	static Scheduler &getInstance();
 
-	uint64_t addEvent(uint32_t delay, std::function<void(void)> f, std::string context);
+	uint64_t addEvent(uint32_t delay, TaskFunction &&f, std::string_view context);
 	uint64_t addEvent(const std::shared_ptr<Task> task);
 	void stopEvent(uint64_t eventId);
 
+	[[nodiscard]] size_t getEventCount();
+
 private:
+	void scheduleNextTick();
+	void onTick();
+	uint64_t getTick(std::chrono::steady_clock::time_point time, bool roundUp) const;
+
 	ThreadPool &threadPool;
 	std::mutex threadSafetyMutex;
 	std::atomic<uint64_t> lastEventId { 0 };
-	phmap::flat_hash_map<uint64_t, asio::steady_timer> eventIds;
+
+	const std::chrono::steady_clock::time_point startTime;
+	asio::steady_timer tickTimer;
+	TimingWheel wheel;
 };
 
 constexpr auto g_scheduler = Scheduler::getInstance;
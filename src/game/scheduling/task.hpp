@@ -9,20 +9,136 @@
 
 #pragma once
 
-class Task {
+#include "utils/small_function.hpp"
+#include "lib/profiling/allocation_profiler.hpp"
+
+using TaskFunction = SmallFunction<void(void)>;
+
+enum TaskFlags_t : uint8_t {
+	TASK_FLAG_NONE = 0,
+	TASK_FLAG_TRACEABLE = 1 << 0,
+};
+
+/**
+ * Contexts that would flood the debug log, they are logged as trace instead.
+ * Must be kept sorted, it is binary searched.
+ */
+static constexpr auto TASK_TRACEABLE_CONTEXTS = std::to_array<std::string_view>({
+	"Creature::checkCreatureWalk",
+	"CreatureWalkWheel::tick",
+	"Decay::checkDecay",
+	"Dispatcher::addTasks",
+	"Game::checkCreatureAttack",
+	"Game::checkCreatures",
+	"Game::checkImbuements",
+	"Game::checkLight",
+	"Game::createFiendishMonsters",
+	"Game::createInfluencedMonsters",
+	"Game::updateCreatureWalk",
+	"Game::updateForgeableMonsters",
+	"GlobalEvents::think",
+	"LuaEnvironment::executeTimerEvents",
+	"Modules::executeOnRecvbyte",
+	"ProtocolGame::addGameTask",
+	"ProtocolGame::parsePacketFromDispatcher",
+	"Raids::checkRaids",
+	"SpawnMonster::scheduleSpawn",
+	"SpawnMonsterWheel::tick",
+	"SpawnNpc::checkSpawnNpc",
+	"Webhook::run",
+	"sendRecvMessageCallback",
+});
+
+static_assert(std::ranges::is_sorted(TASK_TRACEABLE_CONTEXTS), "TASK_TRACEABLE_CONTEXTS must be sorted");
+
+constexpr uint8_t getTaskContextFlags(std::string_view context) {
+	uint8_t flags = TASK_FLAG_NONE;
+	if (std::ranges::binary_search(TASK_TRACEABLE_CONTEXTS, context)) {
+		flags |= TASK_FLAG_TRACEABLE;
+	}
+	return flags;
+}
+
+/**
+ * Dispatcher lanes, drained in this order every cycle.
+ * Background work is time boxed and yields to pending network input.
+ */
+enum TaskLane_t : uint8_t {
+	TASK_LANE_NETWORK,
+	TASK_LANE_COMBAT,
+	// Creature AI and any game logic without a dedicated lane
+	TASK_LANE_AI,
+	TASK_LANE_BACKGROUND,
+
+	TASK_LANE_COUNT
+};
+
+/**
+ * Contexts with a lane other than TASK_LANE_AI.
+ * Must be kept sorted by context, it is binary searched.
+ */
+static constexpr auto TASK_CONTEXT_LANES = std::to_array<std::pair<std::string_view, TaskLane_t>>({
+	{ "ConditionFeared::executeCondition", TASK_LANE_COMBAT },
+	{ "DatabaseTasks::execute", TASK_LANE_BACKGROUND },
+	{ "DatabaseTasks::store", TASK_LANE_BACKGROUND },
+	{ "Game::checkAllocationProfiler", TASK_LANE_BACKGROUND },
+	{ "Game::checkCreatureAttack", TASK_LANE_COMBAT },
+	{ "Game::checkLight", TASK_LANE_BACKGROUND },
+	{ "Game::checkTaskProfiler", TASK_LANE_BACKGROUND },
+	{ "Game::cleanMapSlice", TASK_LANE_BACKGROUND },
+	{ "Game::createFiendishMonsters", TASK_LANE_BACKGROUND },
+	{ "Game::createInfluencedMonsters", TASK_LANE_BACKGROUND },
+	{ "Game::evictUntouchedTiles", TASK_LANE_BACKGROUND },
+	{ "Game::flushKV", TASK_LANE_BACKGROUND },
+	{ "Game::executeDeath", TASK_LANE_COMBAT },
+	{ "Game::forceRemoveCondition", TASK_LANE_COMBAT },
+	{ "Game::makeFiendishMonster", TASK_LANE_BACKGROUND },
+	{ "Game::makeInfluencedMonster", TASK_LANE_BACKGROUND },
+	{ "Game::updateFiendishMonsterStatus", TASK_LANE_BACKGROUND },
+	{ "Game::updateForgeableMonsters", TASK_LANE_BACKGROUND },
+	{ "IOLoginData::updateOnlineStatus", TASK_LANE_BACKGROUND },
+	{ "Modules::executeOnRecvbyte", TASK_LANE_NETWORK },
+	{ "Raids::checkRaids", TASK_LANE_BACKGROUND },
+	{ "SpawnMonsterWheel::tick", TASK_LANE_BACKGROUND },
+	{ "SpawnNpc::checkSpawnNpc", TASK_LANE_BACKGROUND },
+	{ "SpawnsMonster::startupPendingBatch", TASK_LANE_BACKGROUND },
+	{ "Webhook::run", TASK_LANE_BACKGROUND },
+});
+
+static_assert(std::ranges::is_sorted(TASK_CONTEXT_LANES, {}, &std::pair<std::string_view, TaskLane_t>::first), "TASK_CONTEXT_LANES must be sorted");
+
+constexpr TaskLane_t getTaskContextLane(std::string_view context) {
+	const auto it = std::ranges::lower_bound(TASK_CONTEXT_LANES, context, {}, &std::pair<std::string_view, TaskLane_t>::first);
+	if (it != TASK_CONTEXT_LANES.end() && it->first == context) {
+		return it->second;
+	}
+
+	// Packet handlers, either parsed on the dispatcher or forwarded as Game::playerXxx
+	if (context.starts_with("Protocol") || context.starts_with("Game::player")) {
+		return TASK_LANE_NETWORK;
+	}
+	return TASK_LANE_AI;
+}
+
+class Task : public AllocationTracked<Task> {
 public:
-	// DO NOT allocate this class on the stack
-	Task(std::function<void(void)> &&f, std::string context) :
-		context(std::move(context)), func(std::move(f)) {
+	/**
+	 * The context is kept as a view, it must have static storage duration
+	 * (a string literal or __FUNCTION__), so tasks never copy it.
+	 */
+	Task(TaskFunction &&f, std::string_view context) :
+		context(context), flags(getTaskContextFlags(context)), lane(getTaskContextLane(context)), func(std::move(f)) {
 		assert(!this->context.empty() && "Context cannot be empty!");
 	}
 
-	Task(std::function<void(void)> &&f, std::string context, uint32_t delay) :
-		delay(delay), context(std::move(context)), func(std::move(f)) {
+	Task(TaskFunction &&f, std::string_view context, uint32_t delay) :
+		delay(delay), context(context), flags(getTaskContextFlags(context)), lane(getTaskContextLane(context)), func(std::move(f)) {
 		assert(!this->context.empty() && "Context cannot be empty!");
 	}
 
-	virtual ~Task() = default;
+	Task(Task &&) noexcept = default;
+	Task &operator=(Task &&) noexcept = default;
+
 	void operator()() {
 		func();
 	}
@@ -39,41 +155,54 @@ public:
 		return delay;
 	}
 
-	std::string getContext() const {
+	std::string_view getContext() const {
 		return context;
 	}
 
+	uint8_t getFlags() const {
+		return flags;
+	}
+
+	void setQueuedAt(std::chrono::steady_clock::time_point time) {
+		queuedAt = time;
+	}
+
+	std::chrono::steady_clock::time_point getQueuedAt() const {
+		return queuedAt;
+	}
+
 	bool hasTraceableContext() const {
-		return std::set<std::string> {
-			"Creature::checkCreatureWalk",
-			"Decay::checkDecay",
-			"Game::checkCreatureAttack",
-			"Game::checkCreatures",
-			"Game::checkImbuements",
-			"Game::checkLight",
-			"Game::createFiendishMonsters",
-			"Game::createInfluencedMonsters",
-			"Game::updateCreatureWalk",
-			"Game::updateForgeableMonsters",
-			"GlobalEvents::think",
-			"LuaEnvironment::executeTimerEvent",
-			"Modules::executeOnRecvbyte",
-			"OutputMessagePool::sendAll",
-			"ProtocolGame::addGameTask",
-			"ProtocolGame::parsePacketFromDispatcher",
-			"Raids::checkRaids",
-			"SpawnMonster::checkSpawnMonster",
-			"SpawnMonster::scheduleSpawn",
-			"SpawnNpc::checkSpawnNpc",
-			"Webhook::run",
-			"sendRecvMessageCallback",
-		}
-			.contains(context);
+		return (flags & TASK_FLAG_TRACEABLE) != 0;
+	}
+
+	TaskLane_t getLane() const {
+		return lane;
+	}
+
+	void setLane(TaskLane_t newLane) {
+		lane = newLane;
+	}
+
+	// Milliseconds since it was queued after which the dispatcher drops it, 0 never expires
+	void setExpiration(uint32_t expiresAfterMs) {
+		expiration = expiresAfterMs;
+	}
+
+	uint32_t getExpiration() const {
+		return expiration;
+	}
+
+	bool hasExpired(std::chrono::steady_clock::time_point now) const {
+		return expiration != 0 && now - queuedAt > std::chrono::milliseconds(expiration);
 	}
 
 private:
 	uint32_t delay = 0;
+	uint32_t expiration = 0;
 	uint64_t eventId = 0;
-	std::string context {};
-	std::function<void(void)> func {};
+	std::string_view context {};
+	uint8_t flags = TASK_FLAG_NONE;
+	TaskLane_t lane = TASK_LANE_AI;
+	std::chrono::steady_clock::time_point queuedAt {};
+	TaskFunction func {};
 };
@@ -0,0 +1,58 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/scheduling/task_profiler.hpp"
+
+uint64_t TaskHistogram::percentile(uint64_t count, uint8_t percent) const {
+	if (count == 0) {
+		return 0;
+	}
+
+	const uint64_t rank = std::max<uint64_t>(1, (count * percent + 99) / 100);
+	uint64_t seen = 0;
+	for (size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+		seen += buckets[bucket];
+		if (seen >= rank) {
+			return bucket == 0 ? 0 : std::min(max, (uint64_t { 1 } << bucket) - 1);
+		}
+	}
+
+	return max;
+}
+
+std::vector<std::pair<std::string_view, const TaskProfile*>> TaskProfiler::getSortedProfiles() const {
+	std::vector<std::pair<std::string_view, const TaskProfile*>> sorted;
+	sorted.reserve(profiles.size());
+	for (const auto &[context, profile] : profiles) {
+		sorted.emplace_back(context, &profile);
+	}
+
+	std::ranges::sort(sorted, [](const auto &lhs, const auto &rhs) {
+		return lhs.second->execution.total > rhs.second->execution.total;
+	});
+	return sorted;
+}
+
+void TaskProfiler::logProfiles(size_t maxContexts) const {
+	const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - startedAt).count();
+	g_logger().info("[TaskProfiler] {} contexts in the last {} seconds, top {} by execution time:", profiles.size(), elapsed, maxContexts);
+
+	const auto sorted = getSortedProfiles();
+	for (const auto &[context, profile] : sorted | std::views::take(maxContexts)) {
+		const auto &[calls, execution, wait] = *profile;
+		g_logger().info(
+			"[TaskProfiler] {}: {} calls, {} ms total, exec p50 {} us, p99 {} us, max {} us, wait p99 {} us, max {} us",
+			context, calls, execution.total / 1000,
+			execution.percentile(calls, 50), execution.percentile(calls, 99), execution.max,
+			wait.percentile(calls, 99), wait.max
+		);
+	}
+}
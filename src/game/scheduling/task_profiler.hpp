@@ -0,0 +1,74 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Log2 histogram of durations in microseconds.
+ * Bucket 0 holds zero, bucket N holds [2^(N-1), 2^N).
+ */
+struct TaskHistogram {
+	static constexpr size_t BUCKETS = 32;
+
+	void add(uint64_t microseconds) {
+		++buckets[std::min<size_t>(std::bit_width(microseconds), BUCKETS - 1)];
+		total += microseconds;
+		max = std::max(max, microseconds);
+	}
+
+	// Upper bound of the bucket holding the given percentile (0-100)
+	uint64_t percentile(uint64_t count, uint8_t percent) const;
+
+	std::array<uint64_t, BUCKETS> buckets {};
+	uint64_t total = 0;
+	uint64_t max = 0;
+};
+
+struct TaskProfile {
+	uint64_t calls = 0;
+	TaskHistogram execution;
+	TaskHistogram wait;
+};
+
+/**
+ * Per context accounting of tasks executed by the dispatcher.
+ * Only the game thread records and reads it, so it takes no lock.
+ */
+class TaskProfiler {
+public:
+	// Ensures that we don't accidentally copy it
+	TaskProfiler() = default;
+	TaskProfiler(const TaskProfiler &) = delete;
+	TaskProfiler operator=(const TaskProfiler &) = delete;
+
+	void record(std::string_view context, uint64_t waitUs, uint64_t executionUs) {
+		auto &profile = profiles[context];
+		++profile.calls;
+		profile.execution.add(executionUs);
+		profile.wait.add(waitUs);
+	}
+
+	// Contexts sorted by total execution time, most expensive first
+	std::vector<std::pair<std::string_view, const TaskProfile*>> getSortedProfiles() const;
+
+	void logProfiles(size_t maxContexts) const;
+
+	void reset() {
+		profiles.clear();
+		startedAt = std::chrono::steady_clock::now();
+	}
+
+	std::chrono::steady_clock::time_point getStartedAt() const {
+		return startedAt;
+	}
+
+private:
+	phmap::flat_hash_map<std::string_view, TaskProfile> profiles;
+	std::chrono::steady_clock::time_point startedAt = std::chrono::steady_clock::now();
+};
@@ -0,0 +1,102 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/scheduling/task_recorder.hpp"
+#include "lib/di/container.hpp"
+#include "lib/thread/thread_pool.hpp"
+
+void TaskRecorder::start(uint32_t windowSeconds, uint32_t taskThresholdMs, uint32_t cycleThresholdMs) {
+	if (windowSeconds == 0 || running) {
+		return;
+	}
+
+	window = std::chrono::seconds(windowSeconds);
+	taskThreshold = std::chrono::milliseconds(taskThresholdMs);
+	cycleThreshold = std::chrono::milliseconds(cycleThresholdMs);
+	records.resize(RECORD_CAPACITY);
+	running = true;
+}
+
+void TaskRecorder::record(std::string_view context, std::chrono::steady_clock::time_point startedAt, std::chrono::steady_clock::time_point finishedAt, std::chrono::microseconds wait) {
+	const auto execution = std::chrono::duration_cast<std::chrono::microseconds>(finishedAt - startedAt);
+	current.context = context;
+	current.startedAt = startedAt;
+	current.executionUs = static_cast<uint32_t>(std::min<int64_t>(execution.count(), std::numeric_limits<uint32_t>::max()));
+	current.waitUs = static_cast<uint32_t>(std::clamp<int64_t>(wait.count(), 0, std::numeric_limits<uint32_t>::max()));
+	push(current);
+	current = {};
+
+	if (taskThreshold.count() > 0 && execution >= taskThreshold) {
+		dump(fmt::format("task {} took {} ms", context, execution.count() / 1000));
+	}
+}
+
+void TaskRecorder::endCycle(std::chrono::steady_clock::time_point startedAt, std::chrono::steady_clock::time_point finishedAt) {
+	const auto execution = std::chrono::duration_cast<std::chrono::microseconds>(finishedAt - startedAt);
+	Record record;
+	record.context = "dispatcher cycle";
+	record.startedAt = startedAt;
+	record.executionUs = static_cast<uint32_t>(std::min<int64_t>(execution.count(), std::numeric_limits<uint32_t>::max()));
+	record.cycleEnd = true;
+	push(record);
+
+	if (cycleThreshold.count() > 0 && execution >= cycleThreshold) {
+		dump(fmt::format("dispatcher cycle took {} ms", execution.count() / 1000));
+	}
+}
+
+void TaskRecorder::push(const Record &record) {
+	records[next] = record;
+	next = (next + 1) % records.size();
+	count = std::min(count + 1, records.size());
+}
+
+void TaskRecorder::dump(std::string_view reason) {
+	const auto now = std::chrono::steady_clock::now();
+	if (lastDump.time_since_epoch().count() != 0 && now - lastDump < window) {
+		return;
+	}
+	lastDump = now;
+
+	// Oldest first, only what falls in the window
+	std::vector<Record> snapshot;
+	snapshot.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		const auto &record = records[(next + records.size() - count + i) % records.size()];
+		if (now - record.startedAt <= window) {
+			snapshot.emplace_back(record);
+		}
+	}
+
+	const auto fileName = fmt::format("{}/{:%Y%m%d-%H%M%S}.log", FLIGHT_RECORDER_DIRECTORY, fmt::localtime(std::time(nullptr)));
+	g_logger().warn("[TaskRecorder] {}, writing the last {} tasks to {}", reason, snapshot.size(), fileName);
+
+	// Contexts are static strings, the records can be written once the game thread moved on
+	inject<ThreadPool>().addBlockingLoad([snapshot = std::move(snapshot), fileName, reason = std::string(reason), now] {
+		std::error_code error;
+		std::filesystem::create_directories(FLIGHT_RECORDER_DIRECTORY, error);
+		std::ofstream file(fileName, std::ios::trunc);
+		if (!file) {
+			g_logger().error("[TaskRecorder] Can not write {}", fileName);
+			return;
+		}
+
+		file << fmt::format("# {}\n# offset_ms execution_us wait_us context creature_id detail\n", reason);
+		for (const auto &record : snapshot) {
+			const auto offsetMs = std::chrono::duration_cast<std::chrono::milliseconds>(record.startedAt - now).count();
+			if (record.cycleEnd) {
+				file << fmt::format("{} {} - {}\n", offsetMs, record.executionUs, record.context);
+				continue;
+			}
+			file << fmt::format("{} {} {} {} {} {}\n", offsetMs, record.executionUs, record.waitUs, record.context, record.creatureId, record.detail);
+		}
+	});
+}
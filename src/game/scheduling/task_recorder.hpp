@@ -0,0 +1,78 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Flight recorder of the game thread: the last RECORD_CAPACITY tasks it
+ * ran, with their context, queue wait, execution time and the creature
+ * they were for when the task tagged one. When a task or a dispatcher
+ * cycle goes over its threshold the records of the last window seconds
+ * are written to FLIGHT_RECORDER_DIRECTORY, off the game thread, so a slow
+ * tick can be explained after the fact.
+ *
+ * Recording is a store into a preallocated ring, the game thread records
+ * and triggers dumps without taking any lock.
+ */
+class TaskRecorder {
+public:
+	static constexpr std::string_view FLIGHT_RECORDER_DIRECTORY = "logs/flight-recorder";
+	static constexpr size_t RECORD_CAPACITY = 64 * 1024;
+
+	TaskRecorder() = default;
+
+	// Ensures that we don't accidentally copy it
+	TaskRecorder(const TaskRecorder &) = delete;
+	TaskRecorder operator=(const TaskRecorder &) = delete;
+
+	// Game thread only, a zero window disables the recorder
+	void start(uint32_t windowSeconds, uint32_t taskThresholdMs, uint32_t cycleThresholdMs);
+
+	[[nodiscard]] bool isRunning() const {
+		return running;
+	}
+
+	// Game thread only, tags the task being run, e.g. with the player whose packet it parses
+	void setTaskInfo(uint32_t creatureId, int32_t detail = -1) {
+		current.creatureId = creatureId;
+		current.detail = detail;
+	}
+
+	// Game thread only, the context must have static storage duration like the task ones
+	void record(std::string_view context, std::chrono::steady_clock::time_point startedAt, std::chrono::steady_clock::time_point finishedAt, std::chrono::microseconds wait);
+	void endCycle(std::chrono::steady_clock::time_point startedAt, std::chrono::steady_clock::time_point finishedAt);
+
+private:
+	struct Record {
+		std::string_view context;
+		std::chrono::steady_clock::time_point startedAt;
+		uint32_t executionUs = 0;
+		uint32_t waitUs = 0;
+		uint32_t creatureId = 0;
+		// Task specific, like the packet opcode, -1 when not set
+		int32_t detail = -1;
+		// Marks the dispatcher cycle the tasks before it belong to
+		bool cycleEnd = false;
+	};
+
+	void push(const Record &record);
+	void dump(std::string_view reason);
+
+	bool running = false;
+	std::chrono::seconds window { 0 };
+	std::chrono::microseconds taskThreshold { 0 };
+	std::chrono::microseconds cycleThreshold { 0 };
+	// One dump per window, a lag spike would otherwise dump the same records over and over
+	std::chrono::steady_clock::time_point lastDump;
+
+	Record current;
+	std::vector<Record> records;
+	size_t next = 0;
+	size_t count = 0;
+};
@@ -0,0 +1,84 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/scheduling/task_watchdog.hpp"
+
+std::string_view TaskWatchdog::internScriptName(const std::string &name) {
+	// Never freed, a sample may still read a name after a reload dropped its script
+	static auto* names = new phmap::node_hash_set<std::string>();
+	return *names->emplace(name).first;
+}
+
+void TaskWatchdog::start(uint32_t thresholdMs) {
+	if (thresholdMs == 0 || running) {
+		return;
+	}
+
+	threshold = std::chrono::milliseconds(thresholdMs);
+	running = true;
+	thread = std::jthread([this](const std::stop_token &stopToken) { run(stopToken); });
+}
+
+void TaskWatchdog::stop() {
+	if (!running) {
+		return;
+	}
+
+	thread.request_stop();
+	if (thread.joinable()) {
+		thread.join();
+	}
+	running = false;
+}
+
+void TaskWatchdog::run(const std::stop_token &stopToken) {
+	// Checked a few times per threshold, so a report comes at most a quarter late
+	const auto interval = std::max(threshold / 4, std::chrono::milliseconds(1));
+	// A task publishes again for each script it calls, so it is told apart by its start
+	int64_t reportedStartedAt = 0;
+
+	std::mutex mutex;
+	std::condition_variable_any wakeUp;
+	while (!stopToken.stop_requested()) {
+		{
+			std::unique_lock lock(mutex);
+			wakeUp.wait_for(lock, stopToken, interval, [] { return false; });
+		}
+
+		const auto before = sequence.load(std::memory_order_acquire);
+		const auto taskStartedAt = startedAt.load(std::memory_order_relaxed);
+		const std::string_view context(contextData.load(std::memory_order_relaxed), contextSize.load(std::memory_order_relaxed));
+		const std::string_view scriptName(scriptData.load(std::memory_order_relaxed), scriptSize.load(std::memory_order_relaxed));
+		// Odd while the game thread is publishing, zero between tasks
+		if ((before & 1) || taskStartedAt == 0 || taskStartedAt == reportedStartedAt) {
+			continue;
+		}
+
+		// Changed if the game thread moved on while it was read, the fence keeps the loads above before the check
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (sequence.load(std::memory_order_relaxed) != before) {
+			continue;
+		}
+
+		const auto elapsed = std::chrono::steady_clock::now().time_since_epoch() - std::chrono::steady_clock::duration(taskStartedAt);
+		if (elapsed < threshold) {
+			continue;
+		}
+
+		reportedStartedAt = taskStartedAt;
+		const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+		if (!scriptName.empty()) {
+			g_logger().warn("[TaskWatchdog] Game thread busy for {} ms in task {}, running script {}", elapsedMs, context, scriptName);
+		} else {
+			g_logger().warn("[TaskWatchdog] Game thread busy for {} ms in task {}", elapsedMs, context);
+		}
+	}
+}
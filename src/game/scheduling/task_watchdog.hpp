@@ -0,0 +1,88 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Reports game thread tasks that run longer than a threshold, while they
+ * still run, so a stuck task shows up in the log before the tick is over.
+ *
+ * The game thread only publishes what it runs with a few atomic stores,
+ * its own thread samples them. The published state is guarded by a
+ * sequence number, a sample taken while it changed is dropped. Only views
+ * of storage that is never freed are published, so even a dropped sample
+ * never reads freed memory. Each task is reported once, with the Lua script
+ * it was running if any.
+ */
+class TaskWatchdog {
+public:
+	TaskWatchdog() = default;
+
+	// Ensures that we don't accidentally copy it
+	TaskWatchdog(const TaskWatchdog &) = delete;
+	TaskWatchdog operator=(const TaskWatchdog &) = delete;
+
+	void start(uint32_t thresholdMs);
+	void stop();
+
+	[[nodiscard]] bool isRunning() const {
+		return running.load(std::memory_order_relaxed);
+	}
+
+	// Game thread only, the context must have static storage duration like the task ones
+	void enter(std::string_view context) {
+		beginPublish();
+		contextData.store(context.data(), std::memory_order_relaxed);
+		contextSize.store(context.size(), std::memory_order_relaxed);
+		scriptData.store(nullptr, std::memory_order_relaxed);
+		scriptSize.store(0, std::memory_order_relaxed);
+		startedAt.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+		endPublish();
+	}
+
+	void leave() {
+		beginPublish();
+		startedAt.store(0, std::memory_order_relaxed);
+		endPublish();
+	}
+
+	// Game thread only, the script the task is running, an empty name when it is done
+	void setLuaContext(std::string_view scriptName) {
+		beginPublish();
+		scriptData.store(scriptName.data(), std::memory_order_relaxed);
+		scriptSize.store(scriptName.size(), std::memory_order_relaxed);
+		endPublish();
+	}
+
+	// Game thread only, a copy of the name that lives as long as the process, as setLuaContext needs
+	static std::string_view internScriptName(const std::string &name);
+
+private:
+	void run(const std::stop_token &stopToken);
+
+	void beginPublish() {
+		sequence.fetch_add(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+
+	void endPublish() {
+		sequence.fetch_add(1, std::memory_order_release);
+	}
+
+	std::atomic<uint64_t> sequence = 0;
+	std::atomic<int64_t> startedAt = 0;
+	std::atomic<const char*> contextData = nullptr;
+	std::atomic<size_t> contextSize = 0;
+	std::atomic<const char*> scriptData = nullptr;
+	std::atomic<size_t> scriptSize = 0;
+
+	std::atomic_bool running = false;
+	std::chrono::milliseconds threshold { 0 };
+	std::jthread thread;
+};
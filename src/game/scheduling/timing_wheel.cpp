@@ -0,0 +1,84 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/scheduling/timing_wheel.hpp"
+#include "game/scheduling/task.hpp"
+
+void TimingWheel::add(const std::shared_ptr<Task> &task, uint64_t expirationTick) {
+	// The current tick was already expired, so the earliest we can run is the next one
+	expirationTick = std::clamp(expirationTick, currentTick + 1, currentTick + MAX_TICKS);
+
+	auto [it, inserted] = pending.insert_or_assign(task->getEventId(), PendingTask { task, expirationTick, ++lastSequence });
+	insert(task->getEventId(), it->second);
+}
+
+bool TimingWheel::remove(uint64_t eventId) {
+	return pending.erase(eventId) > 0;
+}
+
+void TimingWheel::advance(uint64_t targetTick, std::vector<std::shared_ptr<Task>> &expired) {
+	while (currentTick < targetTick) {
+		++currentTick;
+
+		if ((currentTick & SLOT_MASK) == 0) {
+			cascade(1);
+		}
+
+		auto &slot = wheels[0][currentTick & SLOT_MASK];
+		for (const auto &[eventId, sequence] : slot) {
+			auto it = pending.find(eventId);
+			// Cancelled or rescheduled after this entry was added
+			if (it == pending.end() || it->second.sequence != sequence) {
+				continue;
+			}
+
+			expired.emplace_back(std::move(it->second.task));
+			pending.erase(it);
+		}
+
+		slot.clear();
+	}
+}
+
+void TimingWheel::insert(uint64_t eventId, const PendingTask &pendingTask) {
+	const uint64_t ticksLeft = pendingTask.expirationTick - currentTick;
+
+	uint8_t level = 0;
+	while (level < LEVELS - 1 && ticksLeft >= (uint64_t { 1 } << (SLOT_BITS * (level + 1)))) {
+		++level;
+	}
+
+	const auto slot = (pendingTask.expirationTick >> (SLOT_BITS * level)) & SLOT_MASK;
+	wheels[level][slot].emplace_back(SlotEntry { eventId, pendingTask.sequence });
+}
+
+void TimingWheel::cascade(uint8_t level) {
+	if (level >= LEVELS) {
+		return;
+	}
+
+	const auto index = (currentTick >> (SLOT_BITS * level)) & SLOT_MASK;
+	if (index == 0) {
+		cascade(level + 1);
+	}
+
+	// Entries are re-inserted relative to the current tick, landing on the lower levels
+	std::vector<SlotEntry> entries;
+	entries.swap(wheels[level][index]);
+	for (const auto &[eventId, sequence] : entries) {
+		auto it = pending.find(eventId);
+		if (it == pending.end() || it->second.sequence != sequence) {
+			continue;
+		}
+
+		insert(eventId, it->second);
+	}
+}
@@ -0,0 +1,74 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class Task;
+
+/**
+ * Hierarchical timing wheel keyed by event id.
+ * Time is measured in ticks, the caller decides how long a tick is.
+ * Insert and cancel are O(1); cancelled entries are left in their slot
+ * and skipped when the slot is reached. Not thread safe.
+ */
+class TimingWheel {
+public:
+	static constexpr uint8_t LEVELS = 4;
+	static constexpr uint8_t SLOT_BITS = 8;
+	static constexpr uint32_t SLOTS = 1 << SLOT_BITS;
+	static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+	static constexpr uint64_t MAX_TICKS = (uint64_t { 1 } << (SLOT_BITS * LEVELS)) - 1;
+
+	TimingWheel() = default;
+
+	// Ensures that we don't accidentally copy it
+	TimingWheel(const TimingWheel &) = delete;
+	TimingWheel operator=(const TimingWheel &) = delete;
+
+	/**
+	 * Schedules the task to expire at the given tick. Re-adding an event
+	 * id that is still pending reschedules it.
+	 */
+	void add(const std::shared_ptr<Task> &task, uint64_t expirationTick);
+	bool remove(uint64_t eventId);
+
+	/**
+	 * Moves the wheel forward up to targetTick (inclusive), appending the
+	 * expired tasks to the given vector in expiration order.
+	 */
+	void advance(uint64_t targetTick, std::vector<std::shared_ptr<Task>> &expired);
+
+	[[nodiscard]] uint64_t getCurrentTick() const {
+		return currentTick;
+	}
+
+	[[nodiscard]] size_t size() const {
+		return pending.size();
+	}
+
+private:
+	struct SlotEntry {
+		uint64_t eventId;
+		uint64_t sequence;
+	};
+
+	struct PendingTask {
+		std::shared_ptr<Task> task;
+		uint64_t expirationTick;
+		uint64_t sequence;
+	};
+
+	void insert(uint64_t eventId, const PendingTask &pendingTask);
+	void cascade(uint8_t level);
+
+	uint64_t currentTick = 0;
+	uint64_t lastSequence = 0;
+	std::array<std::array<std::vector<SlotEntry>, SLOTS>, LEVELS> wheels;
+	phmap::flat_hash_map<uint64_t, PendingTask> pending;
+};
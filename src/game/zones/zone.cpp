@@ -17,6 +17,8 @@
 #include "game/scheduling/dispatcher.hpp"
 
 phmap::parallel_flat_hash_map<std::string, std::shared_ptr<Zone>> Zone::zones = {};
+Zone::PositionIndex Zone::positionIndex;
+uint32_t Zone::lastId = 0;
 const static std::shared_ptr<Zone> nullZone = nullptr;
 
 std::shared_ptr<Zone> Zone::addZone(const std::string &name) {
@@ -33,6 +35,10 @@ std::shared_ptr<Zone> Zone::addZone(const std::string &name) {
 }
 
 void Zone::addArea(Area area) {
+	if (const auto it = zones.find(name); it != zones.end() && it->second.get() == this) {
+		positionIndex.add(it->second, area);
+	}
+
 	for (const Position &pos : area) {
 		positions.insert(pos);
 		std::shared_ptr<Tile> tile = g_game().map.getTile(pos);
@@ -48,6 +54,10 @@ void Zone::addArea(Area area) {
 }
 
 void Zone::subtractArea(Area area) {
+	if (const auto it = zones.find(name); it != zones.end() && it->second.get() == this) {
+		positionIndex.subtract(it->second, area);
+	}
+
 	for (const Position &pos : area) {
 		positions.erase(pos);
 		std::shared_ptr<Tile> tile = g_game().map.getTile(pos);
@@ -171,16 +181,92 @@ void Zone::removeNpcs() const {
 
 void Zone::clearZones() {
 	zones.clear();
+	positionIndex.clear();
 }
 
-phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> Zone::getZones(const Position postion) {
-	phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> zonesSet;
-	for (const auto &[_, zone] : zones) {
-		if (zone && zone->isPositionInZone(postion)) {
-			zonesSet.insert(zone);
+std::span<const std::shared_ptr<Zone>> Zone::getZones(const Position &position) {
+	return positionIndex.getZones(position);
+}
+
+std::span<const std::shared_ptr<Zone>> Zone::PositionIndex::getZones(const Position &position) const {
+	const auto it = listByPosition.find(position);
+	if (it == listByPosition.end()) {
+		return {};
+	}
+	return lists[it->second];
+}
+
+void Zone::PositionIndex::add(const std::shared_ptr<Zone> &zone, Area area) {
+	update(zone, area, true);
+}
+
+void Zone::PositionIndex::subtract(const std::shared_ptr<Zone> &zone, Area area) {
+	update(zone, area, false);
+}
+
+void Zone::PositionIndex::clear() {
+	listByPosition.clear();
+	lists.assign(1, {});
+	listByZoneIds.clear();
+}
+
+void Zone::PositionIndex::update(const std::shared_ptr<Zone> &zone, Area area, bool adding) {
+	Transitions transitions;
+	for (const Position &position : area) {
+		const auto it = listByPosition.find(position);
+		const uint32_t list = it != listByPosition.end() ? it->second : 0;
+		auto [transition, inserted] = transitions.try_emplace(list, 0);
+		if (inserted) {
+			transition->second = getList(list, zone, adding);
+		}
+
+		const uint32_t newList = transition->second;
+		if (newList == list) {
+			continue;
+		}
+		if (newList == 0) {
+			listByPosition.erase(it);
+		} else if (it != listByPosition.end()) {
+			it->second = newList;
+		} else {
+			listByPosition.emplace(position, newList);
 		}
 	}
-	return zonesSet;
+}
+
+uint32_t Zone::PositionIndex::getList(uint32_t list, const std::shared_ptr<Zone> &zone, bool adding) {
+	std::vector<uint32_t> zoneIds;
+	zoneIds.reserve(lists[list].size() + 1);
+	for (const auto &listZone : lists[list]) {
+		zoneIds.emplace_back(listZone->id);
+	}
+
+	const auto position = std::ranges::lower_bound(zoneIds, zone->id);
+	const bool present = position != zoneIds.end() && *position == zone->id;
+	if (adding == present) {
+		return list;
+	}
+	if (adding) {
+		zoneIds.insert(position, zone->id);
+	} else {
+		zoneIds.erase(position);
+	}
+	if (zoneIds.empty()) {
+		return 0;
+	}
+
+	const auto [it, inserted] = listByZoneIds.try_emplace(zoneIds, static_cast<uint32_t>(lists.size()));
+	if (inserted) {
+		auto zonesOfList = lists[list];
+		if (adding) {
+			const auto insertAt = std::ranges::lower_bound(zonesOfList, zone->id, {}, &Zone::id);
+			zonesOfList.insert(insertAt, zone);
+		} else {
+			std::erase(zonesOfList, zone);
+		}
+		lists.emplace_back(std::move(zonesOfList));
+	}
+	return it->second;
 }
 
 const phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> &Zone::getZones() {
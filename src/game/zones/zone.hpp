@@ -82,7 +82,7 @@ struct Area {
 class Zone {
 public:
 	explicit Zone(const std::string &name) :
-		name(name) { }
+		name(name), id(++lastId) { }
 
 	// Deleted copy constructor and assignment operator.
 	Zone(const Zone &) = delete;
@@ -119,13 +119,41 @@ public:
 
 	static std::shared_ptr<Zone> addZone(const std::string &name);
 	static std::shared_ptr<Zone> getZone(const std::string &name);
-	static phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> getZones(const Position position);
+	// Zones containing the position, valid until the zones are cleared; never allocates
+	static std::span<const std::shared_ptr<Zone>> getZones(const Position &position);
 	const static phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> &getZones();
 	static void clearZones();
 
 private:
+	/**
+	 * Zones of every position in any zone, so the tile of each step finds
+	 * them without testing every zone. Positions keep the index of their
+	 * list of zones. Each distinct combination of zones is stored once, in
+	 * the order they were created, and never changes, so the spans handed
+	 * out live until clearZones.
+	 */
+	class PositionIndex {
+	public:
+		std::span<const std::shared_ptr<Zone>> getZones(const Position &position) const;
+		void add(const std::shared_ptr<Zone> &zone, Area area);
+		void subtract(const std::shared_ptr<Zone> &zone, Area area);
+		void clear();
+
+	private:
+		// The list of the zones of a position once the zone is added or removed, remembered for the rest of the area
+		using Transitions = phmap::flat_hash_map<uint32_t, uint32_t>;
+		void update(const std::shared_ptr<Zone> &zone, Area area, bool adding);
+		uint32_t getList(uint32_t list, const std::shared_ptr<Zone> &zone, bool adding);
+
+		phmap::flat_hash_map<Position, uint32_t> listByPosition;
+		// The empty list is the first one
+		std::vector<std::vector<std::shared_ptr<Zone>>> lists { {} };
+		std::map<std::vector<uint32_t>, uint32_t> listByZoneIds;
+	};
+
 	Position removeDestination = Position();
 	std::string name;
+	uint32_t id;
 	phmap::parallel_flat_hash_set<Position> positions;
 
 	phmap::parallel_flat_hash_set<std ::shared_ptr<Item>> itemsCache;
@@ -135,4 +163,6 @@ private:
 	phmap::parallel_flat_hash_set<uint32_t> playersCache;
 
 	static phmap::parallel_flat_hash_map<std::string, std::shared_ptr<Zone>> zones;
+	static PositionIndex positionIndex;
+	static uint32_t lastId;
 };
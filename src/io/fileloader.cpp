@@ -28,53 +28,70 @@ namespace OTB {
 		}
 	}
 
-	using NodeStack = std::stack<Node*, std::vector<Node*>>;
-	static Node &getCurrentNode(const NodeStack &nodeStack) {
-		if (nodeStack.empty()) {
-			throw InvalidOTBFormat {};
-		}
-		return *nodeStack.top();
-	}
-
 	const Node &Loader::parseTree() {
 		auto it = fileContents.begin() + sizeof(Identifier);
 		if (static_cast<uint8_t>(*it) != Node::START) {
 			throw InvalidOTBFormat {};
 		}
+
+		nodes.clear();
+		auto &root = nodes.emplace_back();
 		root.type = *(++it);
 		root.propsBegin = ++it;
-		NodeStack parseStack;
-		parseStack.push(&root);
+
+		// Every open node with its last child so far, indexes as the array grows
+		std::vector<std::pair<uint32_t, uint32_t>> parseStack;
+		parseStack.emplace_back(0, 0);
 
 		for (; it != fileContents.end(); ++it) {
 			switch (static_cast<uint8_t>(*it)) {
 				case Node::START: {
-					auto &currentNode = getCurrentNode(parseStack);
-					if (currentNode.children.empty()) {
-						currentNode.propsEnd = it;
+					if (parseStack.empty()) {
+						throw InvalidOTBFormat {};
+					}
+
+					auto &[parent, lastChild] = parseStack.back();
+					if (lastChild == 0) {
+						nodes[parent].propsEnd = it;
 					}
-					currentNode.children.emplace_back();
-					auto &child = currentNode.children.back();
 					if (++it == fileContents.end()) {
 						throw InvalidOTBFormat {};
 					}
-					child.type = *it;
-					child.propsBegin = it + sizeof(Node::type);
-					parseStack.push(&child);
+
+					const auto child = static_cast<uint32_t>(nodes.size());
+					auto &node = nodes.emplace_back();
+					node.type = *it;
+					node.propsBegin = it + sizeof(Node::type);
+					if (lastChild == 0) {
+						nodes[parent].firstChild = child;
+					} else {
+						nodes[lastChild].nextSibling = child;
+					}
+					lastChild = child;
+					parseStack.emplace_back(child, 0);
 					break;
 				}
 				case Node::END: {
-					auto &currentNode = getCurrentNode(parseStack);
-					if (currentNode.children.empty()) {
-						currentNode.propsEnd = it;
+					if (parseStack.empty()) {
+						throw InvalidOTBFormat {};
 					}
-					parseStack.pop();
+
+					const auto [index, lastChild] = parseStack.back();
+					if (lastChild == 0) {
+						nodes[index].propsEnd = it;
+					}
+					parseStack.pop_back();
 					break;
 				}
 				case Node::ESCAPE: {
 					if (++it == fileContents.end()) {
 						throw InvalidOTBFormat {};
 					}
+
+					// Props come before the children, only those are unescaped
+					if (!parseStack.empty() && parseStack.back().second == 0) {
+						nodes[parseStack.back().first].escaped = true;
+					}
 					break;
 				}
 				default: {
@@ -86,7 +103,7 @@ namespace OTB {
 			throw InvalidOTBFormat {};
 		}
 
-		return root;
+		return nodes.front();
 	}
 
 	bool Loader::getProps(const Node &node, PropStream &props) {
@@ -94,6 +111,12 @@ namespace OTB {
 		if (size == 0) {
 			return false;
 		}
+
+		if (!node.escaped) {
+			props.init(node.propsBegin, size);
+			return true;
+		}
+
 		propBuffer.resize(size);
 		bool lastEscaped = false;
 
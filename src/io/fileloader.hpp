@@ -14,17 +14,19 @@ class PropStream;
 namespace OTB {
 	using Identifier = std::array<char, 4>;
 
+	/**
+	 * Node of the tree the Loader parsed. Nodes live in one array owned by
+	 * the Loader and refer to each other by index, 0 meaning none (the root
+	 * is never anyone's child or sibling). Use Loader::getChildren to walk them.
+	 */
 	struct Node {
-		Node() = default;
-		Node(Node &&) = default;
-		Node &operator=(Node &&) = default;
-		Node(const Node &) = delete;
-		Node &operator=(const Node &) = delete;
-
-		std::list<Node> children;
 		mio::mmap_source::const_iterator propsBegin;
 		mio::mmap_source::const_iterator propsEnd;
-		uint8_t type;
+		uint32_t firstChild = 0;
+		uint32_t nextSibling = 0;
+		uint8_t type = 0;
+		// Whether the props hold escaped bytes, the others are read in place
+		bool escaped = false;
 		enum NodeChar : uint8_t {
 			ESCAPE = 0xFD,
 			START = 0xFE,
@@ -44,13 +46,65 @@ namespace OTB {
 
 	class Loader {
 		mio::mmap_source fileContents;
-		Node root;
+		std::vector<Node> nodes;
 		std::vector<char> propBuffer;
 
 	public:
+		class ChildRange {
+		public:
+			class iterator {
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = Node;
+				using difference_type = std::ptrdiff_t;
+				using pointer = const Node*;
+				using reference = const Node &;
+
+				iterator(const std::vector<Node> &nodes, uint32_t index) :
+					nodes(&nodes), index(index) { }
+
+				reference operator*() const {
+					return (*nodes)[index];
+				}
+				pointer operator->() const {
+					return &(*nodes)[index];
+				}
+				iterator &operator++() {
+					index = (*nodes)[index].nextSibling;
+					return *this;
+				}
+				bool operator==(const iterator &other) const {
+					return index == other.index;
+				}
+
+			private:
+				const std::vector<Node>* nodes;
+				uint32_t index;
+			};
+
+			ChildRange(const std::vector<Node> &nodes, uint32_t firstChild) :
+				nodes(nodes), firstChild(firstChild) { }
+
+			iterator begin() const {
+				return { nodes, firstChild };
+			}
+			iterator end() const {
+				return { nodes, 0 };
+			}
+
+		private:
+			const std::vector<Node> &nodes;
+			uint32_t firstChild;
+		};
+
 		Loader(const std::string &fileName, const Identifier &acceptedIdentifier);
+		// The props stay valid until the next call, escaped ones are unescaped into a buffer reused between calls
 		bool getProps(const Node &node, PropStream &props);
 		const Node &parseTree();
+
+		ChildRange getChildren(const Node &node) const {
+			return { nodes, node.firstChild };
+		}
 	};
 } // namespace OTB
 
@@ -77,6 +131,17 @@ public:
 	}
 
 	bool readString(std::string &ret) {
+		std::string_view view;
+		if (!readString(view)) {
+			return false;
+		}
+
+		ret.assign(view);
+		return true;
+	}
+
+	// The view points into the stream buffer, it is only valid while the buffer is
+	bool readString(std::string_view &ret) {
 		uint16_t strLen;
 		if (!read<uint16_t>(strLen)) {
 			return false;
@@ -86,11 +151,7 @@ public:
 			return false;
 		}
 
-		char* str = new char[strLen + 1];
-		memcpy(str, p, strLen);
-		str[strLen] = 0;
-		ret.assign(str, strLen);
-		delete[] str;
+		ret = std::string_view(p, strLen);
 		p += strLen;
 		return true;
 	}
@@ -144,6 +144,39 @@ bool FileStream::startNode(uint8_t type) {
 	return false;
 }
 
+bool FileStream::skipNode(uint8_t type) {
+	if (!startNode(type)) {
+		return false;
+	}
+
+	for (uint32_t depth = 1; depth > 0;) {
+		if (m_pos >= m_data.size()) {
+			throw std::ios_base::failure("[FileStream::skipNode] - Node is not closed");
+		}
+
+		const uint8_t byte = m_data[m_pos++];
+		if (byte == OTB::Node::ESCAPE) {
+			++m_pos;
+		} else if (byte == OTB::Node::START) {
+			++depth;
+		} else if (byte == OTB::Node::END) {
+			--depth;
+		}
+	}
+
+	--m_nodes;
+	return true;
+}
+
+FileStream FileStream::slice(uint32_t begin, uint32_t end) const {
+	if (begin > end || end > m_data.size()) {
+		throw std::ios_base::failure("[FileStream::slice] - Out of range");
+	}
+
+	const auto data = reinterpret_cast<const char*>(m_data.data());
+	return { data + begin, data + end };
+}
+
 bool FileStream::endNode() {
 	if (getU8() == OTB::Node::END) {
 		--m_nodes;
@@ -9,15 +9,14 @@
 
 #pragma once
 
+/**
+ * Reads OTB nodes from a buffer it does not own, the caller keeps
+ * the data (usually the mapped file) alive while the stream is used.
+ */
 class FileStream {
 public:
-	FileStream(const char* begin, const char* end) {
-		m_data.insert(m_data.end(), begin, end);
-	}
-
-	explicit FileStream(mio::mmap_source source) {
-		m_data.insert(m_data.end(), source.begin(), source.end());
-	}
+	FileStream(const char* begin, const char* end) :
+		m_data(reinterpret_cast<const uint8_t*>(begin), reinterpret_cast<const uint8_t*>(end)) { }
 
 	void back(uint32_t pos = 1);
 	void seek(uint32_t pos);
@@ -28,6 +27,10 @@ public:
 	bool startNode(uint8_t type = 0);
 	bool endNode();
 	bool isProp(uint8_t prop, bool toNext = true);
+	// Moves past the whole node starting at the current position, children included
+	bool skipNode(uint8_t type = 0);
+	// Stream over [begin, end) of the same data, positions as given by tell()
+	FileStream slice(uint32_t begin, uint32_t end) const;
 
 	uint8_t getU8();
 	uint16_t getU16();
@@ -41,5 +44,5 @@ private:
 	uint32_t m_nodes { 0 };
 	uint32_t m_pos { 0 };
 
-	std::vector<uint8_t> m_data;
+	std::span<const uint8_t> m_data;
 };
@@ -13,6 +13,28 @@
 #include "io/functions/iologindata_load_player.hpp"
 #include "game/game.hpp"
 
+namespace {
+	// Read by guid or account alone, so getPrefetchQueries can read them ahead
+	constexpr auto KILLS_QUERY = "SELECT `player_id`, `time`, `target`, `unavenged` FROM `player_kills` WHERE `player_id` = {}";
+	constexpr auto GUILD_MEMBERSHIP_QUERY = "SELECT `guild_id`, `rank_id`, `nick` FROM `guild_membership` WHERE `player_id` = {}";
+	constexpr auto STASH_QUERY = "SELECT `item_count`, `item_id`  FROM `player_stash` WHERE `player_id` = {}";
+	constexpr auto CHARMS_QUERY = "SELECT * FROM `player_charms` WHERE `player_guid` = {}";
+	constexpr auto SPELLS_QUERY = "SELECT `player_id`, `name` FROM `player_spells` WHERE `player_id` = {}";
+	constexpr auto STORAGE_QUERY = "SELECT `key`, `value` FROM `player_storage` WHERE `player_id` = {}";
+	constexpr auto VIP_QUERY = "SELECT `player_id` FROM `account_viplist` WHERE `account_id` = {}";
+	constexpr auto PREY_QUERY = "SELECT * FROM `player_prey` WHERE `player_id` = {}";
+	constexpr auto TASK_HUNTING_QUERY = "SELECT * FROM `player_taskhunt` WHERE `player_id` = {}";
+	constexpr auto FORGE_HISTORY_QUERY = "SELECT * FROM `forge_history` WHERE `player_id` = {}";
+	constexpr auto BOSSTIARY_QUERY = "SELECT * FROM `player_bosstiary` WHERE `player_id` = {}";
+
+	// Prepared statements, read ahead in their formatted text
+	constexpr auto ITEMS_STATEMENT = "SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_items` WHERE `player_id` = ? ORDER BY `sid` DESC";
+	constexpr auto REWARDS_STATEMENT = "SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_rewards` WHERE `player_id` = ? ORDER BY `pid`, `sid` ASC";
+	constexpr auto DEPOT_ITEMS_STATEMENT = "SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_depotitems` WHERE `player_id` = ? ORDER BY `sid` DESC";
+	constexpr auto INBOX_ITEMS_STATEMENT = "SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_inboxitems` WHERE `player_id` = ? ORDER BY `sid` DESC";
+	constexpr auto PRELOAD_STATEMENT = "SELECT `id`, `account_id`, `group_id`, `deletion` FROM `players` WHERE `name` = ?";
+}
+
 void IOLoginDataLoad::loadItems(ItemsMap &itemsMap, DBResult_ptr result, const std::shared_ptr<Player> &player) {
 	try {
 		do {
@@ -52,9 +74,7 @@ void IOLoginDataLoad::loadItems(ItemsMap &itemsMap, DBResult_ptr result, const s
 bool IOLoginDataLoad::preLoadPlayer(std::shared_ptr<Player> player, const std::string &name) {
 	Database &db = Database::getInstance();
 
-	std::ostringstream query;
-	query << "SELECT `id`, `account_id`, `group_id`, `deletion` FROM `players` WHERE `name` = " << db.escapeString(name);
-	DBResult_ptr result = db.storeQuery(query.str());
+	DBResult_ptr result = db.storeStatement(PRELOAD_STATEMENT, { name });
 	if (!result) {
 		return false;
 	}
@@ -321,9 +341,7 @@ void IOLoginDataLoad::loadPlayerKills(std::shared_ptr<Player> player, DBResult_p
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `player_id`, `time`, `target`, `unavenged` FROM `player_kills` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(fmt::format(KILLS_QUERY, player->getGUID())))) {
 		do {
 			time_t killTime = result->getNumber<time_t>("time");
 			if ((time(nullptr) - killTime) <= g_configManager().getNumber(FRAG_TIME)) {
@@ -340,27 +358,17 @@ void IOLoginDataLoad::loadPlayerGuild(std::shared_ptr<Player> player, DBResult_p
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `guild_id`, `rank_id`, `nick` FROM `guild_membership` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(fmt::format(GUILD_MEMBERSHIP_QUERY, player->getGUID())))) {
 		uint32_t guildId = result->getNumber<uint32_t>("guild_id");
 		uint32_t playerRankId = result->getNumber<uint32_t>("rank_id");
 		player->guildNick = result->getString("nick");
 
-		auto guild = g_game().getGuild(guildId);
-		if (!guild) {
-			guild = IOGuild::loadGuild(guildId);
-			g_game().addGuild(guild);
-		}
-
+		const auto guild = g_game().getGuild(guildId, true);
 		if (guild) {
 			player->guild = guild;
 			GuildRank_ptr rank = guild->getRankById(playerRankId);
 			if (!rank) {
-				query.str("");
-				query << "SELECT `id`, `name`, `level` FROM `guild_ranks` WHERE `id` = " << playerRankId;
-
-				if ((result = db.storeQuery(query.str()))) {
+				if ((result = db.storeQuery(fmt::format("SELECT `id`, `name`, `level` FROM `guild_ranks` WHERE `id` = {}", playerRankId)))) {
 					guild->addRank(result->getNumber<uint32_t>("id"), result->getString("name"), static_cast<uint8_t>(result->getNumber<uint16_t>("level")));
 				}
 
@@ -370,15 +378,7 @@ void IOLoginDataLoad::loadPlayerGuild(std::shared_ptr<Player> player, DBResult_p
 				}
 			}
 
-			player->guildRank = rank;
-
-			IOGuild::getWarList(guildId, player->guildWarVector);
-
-			query.str("");
-			query << "SELECT COUNT(*) AS `members` FROM `guild_membership` WHERE `guild_id` = " << guildId;
-			if ((result = db.storeQuery(query.str()))) {
-				guild->setMemberCount(result->getNumber<uint32_t>("members"));
-			}
+			player->setGuildRank(rank);
 		}
 	}
 }
@@ -390,9 +390,7 @@ void IOLoginDataLoad::loadPlayerStashItems(std::shared_ptr<Player> player, DBRes
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `item_count`, `item_id`  FROM `player_stash` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(fmt::format(STASH_QUERY, player->getGUID())))) {
 		do {
 			player->addItemOnStash(result->getNumber<uint16_t>("item_id"), result->getNumber<uint32_t>("item_count"));
 		} while (result->next());
@@ -406,30 +404,28 @@ void IOLoginDataLoad::loadPlayerBestiaryCharms(std::shared_ptr<Player> player, D
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT * FROM `player_charms` WHERE `player_guid` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(fmt::format(CHARMS_QUERY, player->getGUID())))) {
 		player->charmPoints = result->getNumber<uint32_t>("charm_points");
 		player->charmExpansion = result->getNumber<bool>("charm_expansion");
-		player->charmRuneWound = result->getNumber<uint16_t>("rune_wound");
-		player->charmRuneEnflame = result->getNumber<uint16_t>("rune_enflame");
-		player->charmRunePoison = result->getNumber<uint16_t>("rune_poison");
-		player->charmRuneFreeze = result->getNumber<uint16_t>("rune_freeze");
-		player->charmRuneZap = result->getNumber<uint16_t>("rune_zap");
-		player->charmRuneCurse = result->getNumber<uint16_t>("rune_curse");
-		player->charmRuneCripple = result->getNumber<uint16_t>("rune_cripple");
-		player->charmRuneParry = result->getNumber<uint16_t>("rune_parry");
-		player->charmRuneDodge = result->getNumber<uint16_t>("rune_dodge");
-		player->charmRuneAdrenaline = result->getNumber<uint16_t>("rune_adrenaline");
-		player->charmRuneNumb = result->getNumber<uint16_t>("rune_numb");
-		player->charmRuneCleanse = result->getNumber<uint16_t>("rune_cleanse");
-		player->charmRuneBless = result->getNumber<uint16_t>("rune_bless");
-		player->charmRuneScavenge = result->getNumber<uint16_t>("rune_scavenge");
-		player->charmRuneGut = result->getNumber<uint16_t>("rune_gut");
-		player->charmRuneLowBlow = result->getNumber<uint16_t>("rune_low_blow");
-		player->charmRuneDivine = result->getNumber<uint16_t>("rune_divine");
-		player->charmRuneVamp = result->getNumber<uint16_t>("rune_vamp");
-		player->charmRuneVoid = result->getNumber<uint16_t>("rune_void");
+		player->charmRuneRaces[CHARM_WOUND] = result->getNumber<uint16_t>("rune_wound");
+		player->charmRuneRaces[CHARM_ENFLAME] = result->getNumber<uint16_t>("rune_enflame");
+		player->charmRuneRaces[CHARM_POISON] = result->getNumber<uint16_t>("rune_poison");
+		player->charmRuneRaces[CHARM_FREEZE] = result->getNumber<uint16_t>("rune_freeze");
+		player->charmRuneRaces[CHARM_ZAP] = result->getNumber<uint16_t>("rune_zap");
+		player->charmRuneRaces[CHARM_CURSE] = result->getNumber<uint16_t>("rune_curse");
+		player->charmRuneRaces[CHARM_CRIPPLE] = result->getNumber<uint16_t>("rune_cripple");
+		player->charmRuneRaces[CHARM_PARRY] = result->getNumber<uint16_t>("rune_parry");
+		player->charmRuneRaces[CHARM_DODGE] = result->getNumber<uint16_t>("rune_dodge");
+		player->charmRuneRaces[CHARM_ADRENALINE] = result->getNumber<uint16_t>("rune_adrenaline");
+		player->charmRuneRaces[CHARM_NUMB] = result->getNumber<uint16_t>("rune_numb");
+		player->charmRuneRaces[CHARM_CLEANSE] = result->getNumber<uint16_t>("rune_cleanse");
+		player->charmRuneRaces[CHARM_BLESS] = result->getNumber<uint16_t>("rune_bless");
+		player->charmRuneRaces[CHARM_SCAVENGE] = result->getNumber<uint16_t>("rune_scavenge");
+		player->charmRuneRaces[CHARM_GUT] = result->getNumber<uint16_t>("rune_gut");
+		player->charmRuneRaces[CHARM_LOW] = result->getNumber<uint16_t>("rune_low_blow");
+		player->charmRuneRaces[CHARM_DIVINE] = result->getNumber<uint16_t>("rune_divine");
+		player->charmRuneRaces[CHARM_VAMP] = result->getNumber<uint16_t>("rune_vamp");
+		player->charmRuneRaces[CHARM_VOID] = result->getNumber<uint16_t>("rune_void");
 		player->UsedRunesBit = result->getNumber<int32_t>("UsedRunesBit");
 		player->UnlockedRunesBit = result->getNumber<int32_t>("UnlockedRunesBit");
 
@@ -459,9 +455,7 @@ void IOLoginDataLoad::loadPlayerInstantSpellList(std::shared_ptr<Player> player,
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `player_id`, `name` FROM `player_spells` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(fmt::format(SPELLS_QUERY, player->getGUID())))) {
 		do {
 			player->learnedInstantSpellList.emplace_front(result->getString("name"));
 		} while (result->next());
@@ -476,14 +470,12 @@ void IOLoginDataLoad::loadPlayerInventoryItems(std::shared_ptr<Player> player, D
 
 	bool oldProtocol = g_configManager().getBoolean(OLD_PROTOCOL) && player->getProtocolVersion() < 1200;
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_items` WHERE `player_id` = " << player->getGUID() << " ORDER BY `sid` DESC";
 
 	ItemsMap inventoryItems;
 	std::vector<std::pair<uint8_t, std::shared_ptr<Container>>> openContainersList;
 
 	try {
-		if ((result = db.storeQuery(query.str()))) {
+		if ((result = db.storeStatement(ITEMS_STATEMENT, { player->getGUID() }))) {
 			loadItems(inventoryItems, result, player);
 
 			for (ItemsMap::const_reverse_iterator it = inventoryItems.rbegin(), end = inventoryItems.rend(); it != end; ++it) {
@@ -564,11 +556,7 @@ void IOLoginDataLoad::loadRewardItems(std::shared_ptr<Player> player) {
 	}
 
 	ItemsMap rewardItems;
-	std::ostringstream query;
-	query.str(std::string());
-	query << "SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_rewards` WHERE `player_id` = "
-		  << player->getGUID() << " ORDER BY `pid`, `sid` ASC";
-	if (auto result = Database::getInstance().storeQuery(query.str())) {
+	if (auto result = Database::getInstance().storeStatement(REWARDS_STATEMENT, { player->getGUID() })) {
 		loadItems(rewardItems, result, player);
 		bindRewardBag(player, rewardItems);
 		insertItemsIntoRewardBag(rewardItems);
@@ -583,9 +571,7 @@ void IOLoginDataLoad::loadPlayerDepotItems(std::shared_ptr<Player> player, DBRes
 
 	Database &db = Database::getInstance();
 	ItemsMap depotItems;
-	std::ostringstream query;
-	query << "SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_depotitems` WHERE `player_id` = " << player->getGUID() << " ORDER BY `sid` DESC";
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeStatement(DEPOT_ITEMS_STATEMENT, { player->getGUID() }))) {
 		loadItems(depotItems, result, player);
 		for (ItemsMap::const_reverse_iterator it = depotItems.rbegin(), end = depotItems.rend(); it != end; ++it) {
 			const std::pair<std::shared_ptr<Item>, int32_t> &pair = it->second;
@@ -621,9 +607,7 @@ void IOLoginDataLoad::loadPlayerInboxItems(std::shared_ptr<Player> player, DBRes
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_inboxitems` WHERE `player_id` = " << player->getGUID() << " ORDER BY `sid` DESC";
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeStatement(INBOX_ITEMS_STATEMENT, { player->getGUID() }))) {
 		ItemsMap inboxItems;
 		loadItems(inboxItems, result, player);
 
@@ -657,13 +641,13 @@ void IOLoginDataLoad::loadPlayerStorageMap(std::shared_ptr<Player> player, DBRes
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `key`, `value` FROM `player_storage` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(fmt::format(STORAGE_QUERY, player->getGUID())))) {
 		do {
 			player->addStorageValue(result->getNumber<uint32_t>("key"), result->getNumber<int32_t>("value"), true);
 		} while (result->next());
 	}
+	player->storageDirtyKeys.clear();
+	player->storageSynced = true;
 }
 
 void IOLoginDataLoad::loadPlayerVip(std::shared_ptr<Player> player, DBResult_ptr result) {
@@ -673,9 +657,7 @@ void IOLoginDataLoad::loadPlayerVip(std::shared_ptr<Player> player, DBResult_ptr
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `player_id` FROM `account_viplist` WHERE `account_id` = " << player->getAccountId();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(fmt::format(VIP_QUERY, player->getAccountId())))) {
 		do {
 			player->addVIPInternal(result->getNumber<uint32_t>("player_id"));
 		} while (result->next());
@@ -690,9 +672,7 @@ void IOLoginDataLoad::loadPlayerPreyClass(std::shared_ptr<Player> player, DBResu
 
 	if (g_configManager().getBoolean(PREY_ENABLED)) {
 		Database &db = Database::getInstance();
-		std::ostringstream query;
-		query << "SELECT * FROM `player_prey` WHERE `player_id` = " << player->getGUID();
-		if (result = db.storeQuery(query.str())) {
+		if ((result = db.storeQuery(fmt::format(PREY_QUERY, player->getGUID())))) {
 			do {
 				auto slot = std::make_unique<PreySlot>(static_cast<PreySlot_t>(result->getNumber<uint16_t>("slot")));
 				auto state = static_cast<PreyDataState_t>(result->getNumber<uint16_t>("state"));
@@ -737,9 +717,7 @@ void IOLoginDataLoad::loadPlayerTaskHuntingClass(std::shared_ptr<Player> player,
 
 	if (g_configManager().getBoolean(TASK_HUNTING_ENABLED)) {
 		Database &db = Database::getInstance();
-		std::ostringstream query;
-		query << "SELECT * FROM `player_taskhunt` WHERE `player_id` = " << player->getGUID();
-		if (result = db.storeQuery(query.str())) {
+		if ((result = db.storeQuery(fmt::format(TASK_HUNTING_QUERY, player->getGUID())))) {
 			do {
 				auto slot = std::make_unique<TaskHuntingSlot>(static_cast<PreySlot_t>(result->getNumber<uint16_t>("slot")));
 				auto state = static_cast<PreyTaskDataState_t>(result->getNumber<uint16_t>("state"));
@@ -785,9 +763,7 @@ void IOLoginDataLoad::loadPlayerForgeHistory(std::shared_ptr<Player> player, DBR
 		return;
 	}
 
-	std::ostringstream query;
-	query << "SELECT * FROM `forge_history` WHERE `player_id` = " << player->getGUID();
-	if (result = Database::getInstance().storeQuery(query.str())) {
+	if ((result = Database::getInstance().storeQuery(fmt::format(FORGE_HISTORY_QUERY, player->getGUID())))) {
 		do {
 			auto actionEnum = magic_enum::enum_value<ForgeConversion_t>(result->getNumber<uint16_t>("action_type"));
 			ForgeHistory history;
@@ -806,9 +782,7 @@ void IOLoginDataLoad::loadPlayerBosstiary(std::shared_ptr<Player> player, DBResu
 		return;
 	}
 
-	std::ostringstream query;
-	query << "SELECT * FROM `player_bosstiary` WHERE `player_id` = " << player->getGUID();
-	if (result = Database::getInstance().storeQuery(query.str())) {
+	if ((result = Database::getInstance().storeQuery(fmt::format(BOSSTIARY_QUERY, player->getGUID())))) {
 		do {
 			player->setSlotBossId(1, result->getNumber<uint16_t>("bossIdSlotOne"));
 			player->setSlotBossId(2, result->getNumber<uint16_t>("bossIdSlotTwo"));
@@ -896,3 +870,25 @@ void IOLoginDataLoad::loadPlayerUpdateSystem(std::shared_ptr<Player> player) {
 	player->updateInventoryWeight();
 	player->updateItemsLight(true);
 }
+
+std::vector<std::string> IOLoginDataLoad::getPrefetchQueries(const std::string &name, uint32_t guid, uint32_t accountId) {
+	const auto &db = Database::getInstance();
+	return {
+		db.formatStatement(PRELOAD_STATEMENT, { name }),
+		db.formatStatement(PLAYER_BY_ID_STATEMENT, { guid }),
+		fmt::format(KILLS_QUERY, guid),
+		fmt::format(GUILD_MEMBERSHIP_QUERY, guid),
+		fmt::format(STASH_QUERY, guid),
+		fmt::format(CHARMS_QUERY, guid),
+		db.formatStatement(ITEMS_STATEMENT, { guid }),
+		db.formatStatement(DEPOT_ITEMS_STATEMENT, { guid }),
+		db.formatStatement(REWARDS_STATEMENT, { guid }),
+		db.formatStatement(INBOX_ITEMS_STATEMENT, { guid }),
+		fmt::format(STORAGE_QUERY, guid),
+		fmt::format(VIP_QUERY, accountId),
+		fmt::format(PREY_QUERY, guid),
+		fmt::format(TASK_HUNTING_QUERY, guid),
+		fmt::format(FORGE_HISTORY_QUERY, guid),
+		fmt::format(BOSSTIARY_QUERY, guid),
+	};
+}
@@ -40,6 +40,13 @@ public:
 	static void loadPlayerInitializeSystem(std::shared_ptr<Player> player);
 	static void loadPlayerUpdateSystem(std::shared_ptr<Player> player);
 
+	/**
+	 * Queries preLoadPlayer and loadPlayer send for the character, to be read
+	 * in one round trip with DBPrefetch before the load runs. The ones that
+	 * depend on earlier results (guild ranks and members) are left out.
+	 */
+	static std::vector<std::string> getPrefetchQueries(const std::string &name, uint32_t guid, uint32_t accountId);
+
 private:
 	using ItemsMap = std::map<uint32_t, std::pair<std::shared_ptr<Item>, uint32_t>>;
 
@@ -13,6 +13,27 @@
 #include "game/game.hpp"
 
 bool IOLoginDataSave::saveItems(std::shared_ptr<Player> player, const ItemBlockList &itemList, DBInsert &query_insert, PropWriteStream &propWriteStream) {
+	ItemRowList rows;
+	if (!serializeItems(player, itemList, rows, propWriteStream)) {
+		return false;
+	}
+
+	for (const auto &[sid, row] : rows) {
+		if (!query_insert.addRow(row)) {
+			g_logger().error("Error adding row to query.");
+			return false;
+		}
+	}
+
+	// Execute query
+	if (!query_insert.execute()) {
+		g_logger().error("Error executing query.");
+		return false;
+	}
+	return true;
+}
+
+bool IOLoginDataSave::serializeItems(std::shared_ptr<Player> player, const ItemBlockList &itemList, ItemRowList &rows, PropWriteStream &propWriteStream) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
@@ -71,12 +92,10 @@ bool IOLoginDataSave::saveItems(std::shared_ptr<Player> player, const ItemBlockL
 		size_t attributesSize;
 		const char* attributes = propWriteStream.getStream(attributesSize);
 
-		// Build query string and add row
+		// Build row string
 		ss << player->getGUID() << ',' << pid << ',' << runningId << ',' << item->getID() << ',' << item->getSubType() << ',' << db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize));
-		if (!query_insert.addRow(ss)) {
-			g_logger().error("Error adding row to query.");
-			return false;
-		}
+		rows.emplace_back(runningId, ss.str());
+		ss.str(std::string());
 	}
 
 	// Loop through containers in queue
@@ -131,20 +150,12 @@ bool IOLoginDataSave::saveItems(std::shared_ptr<Player> player, const ItemBlockL
 			size_t attributesSize;
 			const char* attributes = propWriteStream.getStream(attributesSize);
 
-			// Build query string and add row
+			// Build row string
 			ss << player->getGUID() << ',' << parentId << ',' << runningId << ',' << item->getID() << ',' << item->getSubType() << ',' << db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize));
-			if (!query_insert.addRow(ss)) {
-				g_logger().error("Error adding row to query for container item.");
-				return false;
-			}
+			rows.emplace_back(runningId, ss.str());
+			ss.str(std::string());
 		}
 	}
-
-	// Execute query
-	if (!query_insert.execute()) {
-		g_logger().error("Error executing query.");
-		return false;
-	}
 	return true;
 }
 
@@ -161,8 +172,7 @@ bool IOLoginDataSave::savePlayerFirst(std::shared_ptr<Player> player) {
 	Database &db = Database::getInstance();
 
 	std::ostringstream query;
-	query << "SELECT `save` FROM `players` WHERE `id` = " << player->getGUID();
-	DBResult_ptr result = db.storeQuery(query.str());
+	DBResult_ptr result = db.storeStatement("SELECT `save` FROM `players` WHERE `id` = ?", { player->getGUID() });
 	if (!result) {
 		g_logger().warn("[IOLoginData::savePlayer] - Error for select result query from player: {}", player->getName());
 		return false;
@@ -409,25 +419,25 @@ bool IOLoginDataSave::savePlayerBestiarySystem(std::shared_ptr<Player> player) {
 	query << "UPDATE `player_charms` SET ";
 	query << "`charm_points` = " << player->charmPoints << ",";
 	query << "`charm_expansion` = " << ((player->charmExpansion) ? 1 : 0) << ",";
-	query << "`rune_wound` = " << player->charmRuneWound << ",";
-	query << "`rune_enflame` = " << player->charmRuneEnflame << ",";
-	query << "`rune_poison` = " << player->charmRunePoison << ",";
-	query << "`rune_freeze` = " << player->charmRuneFreeze << ",";
-	query << "`rune_zap` = " << player->charmRuneZap << ",";
-	query << "`rune_curse` = " << player->charmRuneCurse << ",";
-	query << "`rune_cripple` = " << player->charmRuneCripple << ",";
-	query << "`rune_parry` = " << player->charmRuneParry << ",";
-	query << "`rune_dodge` = " << player->charmRuneDodge << ",";
-	query << "`rune_adrenaline` = " << player->charmRuneAdrenaline << ",";
-	query << "`rune_numb` = " << player->charmRuneNumb << ",";
-	query << "`rune_cleanse` = " << player->charmRuneCleanse << ",";
-	query << "`rune_bless` = " << player->charmRuneBless << ",";
-	query << "`rune_scavenge` = " << player->charmRuneScavenge << ",";
-	query << "`rune_gut` = " << player->charmRuneGut << ",";
-	query << "`rune_low_blow` = " << player->charmRuneLowBlow << ",";
-	query << "`rune_divine` = " << player->charmRuneDivine << ",";
-	query << "`rune_vamp` = " << player->charmRuneVamp << ",";
-	query << "`rune_void` = " << player->charmRuneVoid << ",";
+	query << "`rune_wound` = " << player->charmRuneRaces[CHARM_WOUND] << ",";
+	query << "`rune_enflame` = " << player->charmRuneRaces[CHARM_ENFLAME] << ",";
+	query << "`rune_poison` = " << player->charmRuneRaces[CHARM_POISON] << ",";
+	query << "`rune_freeze` = " << player->charmRuneRaces[CHARM_FREEZE] << ",";
+	query << "`rune_zap` = " << player->charmRuneRaces[CHARM_ZAP] << ",";
+	query << "`rune_curse` = " << player->charmRuneRaces[CHARM_CURSE] << ",";
+	query << "`rune_cripple` = " << player->charmRuneRaces[CHARM_CRIPPLE] << ",";
+	query << "`rune_parry` = " << player->charmRuneRaces[CHARM_PARRY] << ",";
+	query << "`rune_dodge` = " << player->charmRuneRaces[CHARM_DODGE] << ",";
+	query << "`rune_adrenaline` = " << player->charmRuneRaces[CHARM_ADRENALINE] << ",";
+	query << "`rune_numb` = " << player->charmRuneRaces[CHARM_NUMB] << ",";
+	query << "`rune_cleanse` = " << player->charmRuneRaces[CHARM_CLEANSE] << ",";
+	query << "`rune_bless` = " << player->charmRuneRaces[CHARM_BLESS] << ",";
+	query << "`rune_scavenge` = " << player->charmRuneRaces[CHARM_SCAVENGE] << ",";
+	query << "`rune_gut` = " << player->charmRuneRaces[CHARM_GUT] << ",";
+	query << "`rune_low_blow` = " << player->charmRuneRaces[CHARM_LOW] << ",";
+	query << "`rune_divine` = " << player->charmRuneRaces[CHARM_DIVINE] << ",";
+	query << "`rune_vamp` = " << player->charmRuneRaces[CHARM_VAMP] << ",";
+	query << "`rune_void` = " << player->charmRuneRaces[CHARM_VOID] << ",";
 	query << "`UsedRunesBit` = " << player->UsedRunesBit << ",";
 	query << "`UnlockedRunesBit` = " << player->UnlockedRunesBit << ",";
 
@@ -506,6 +516,10 @@ bool IOLoginDataSave::savePlayerDepotItems(std::shared_ptr<Player> player) {
 			}
 		}
 
+		if (g_configManager().getBoolean(PLAYER_DEPOT_ITEM_DIFF)) {
+			return saveDepotItemsDiff(player, depotList, propWriteStream);
+		}
+
 		if (!saveItems(player, depotList, depotQuery, propWriteStream)) {
 			return false;
 		}
@@ -514,6 +528,46 @@ bool IOLoginDataSave::savePlayerDepotItems(std::shared_ptr<Player> player) {
 	return true;
 }
 
+bool IOLoginDataSave::saveDepotItemsDiff(std::shared_ptr<Player> player, const ItemDepotList &depotList, PropWriteStream &propWriteStream) {
+	ItemRowList rows;
+	if (!serializeItems(player, depotList, rows, propWriteStream)) {
+		return false;
+	}
+
+	// Sids are assigned in order from 101, so the rows of the items that left the depot are past the last one
+	const int32_t lastSid = rows.empty() ? 100 : rows.back().first;
+	std::ostringstream query;
+	query << "DELETE FROM `player_depotitems` WHERE `player_id` = " << player->getGUID() << " AND `sid` > " << lastSid;
+	if (!Database::getInstance().executeQuery(query.str())) {
+		return false;
+	}
+
+	DBInsert depotQuery("INSERT INTO `player_depotitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
+	depotQuery.upsert({ "pid", "itemtype", "count", "attributes" });
+
+	std::map<int32_t, uint64_t> rowDigests;
+	for (const auto &[sid, row] : rows) {
+		const uint64_t digest = std::hash<std::string> {}(row);
+		rowDigests.emplace(sid, digest);
+
+		const auto it = player->savedDepotRows.find(sid);
+		if (it != player->savedDepotRows.end() && it->second == digest) {
+			continue;
+		}
+
+		if (!depotQuery.addRow(row)) {
+			return false;
+		}
+	}
+
+	if (!depotQuery.execute()) {
+		return false;
+	}
+
+	player->pendingDepotRows = std::move(rowDigests);
+	return true;
+}
+
 bool IOLoginDataSave::saveRewardItems(std::shared_ptr<Player> player) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
@@ -766,6 +820,11 @@ bool IOLoginDataSave::savePlayerStorage(std::shared_ptr<Player> player) {
 		return false;
 	}
 
+	player->genReservedStorageRange();
+	if (player->storageSynced) {
+		return savePlayerStorageDiff(player);
+	}
+
 	Database &db = Database::getInstance();
 	std::ostringstream query;
 	query << "DELETE FROM `player_storage` WHERE `player_id` = " << player->getGUID();
@@ -776,8 +835,7 @@ bool IOLoginDataSave::savePlayerStorage(std::shared_ptr<Player> player) {
 	query.str("");
 
 	DBInsert storageQuery("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES ");
-	player->genReservedStorageRange();
-
+	player->storageDirtyKeys.clear();
 	for (const auto &[key, value] : player->storageMap) {
 		query << player->getGUID() << ',' << key << ',' << value;
 		if (!storageQuery.addRow(query)) {
@@ -790,3 +848,78 @@ bool IOLoginDataSave::savePlayerStorage(std::shared_ptr<Player> player) {
 	}
 	return true;
 }
+
+bool IOLoginDataSave::savePlayerStorageDiff(std::shared_ptr<Player> player) {
+	if (player->storageDirtyKeys.empty()) {
+		return true;
+	}
+
+	// Sorted, so the same changes always make the same queries for the section digest
+	std::vector<uint32_t> keys(player->storageDirtyKeys.begin(), player->storageDirtyKeys.end());
+	std::ranges::sort(keys);
+	player->storageDirtyKeys.clear();
+
+	DBInsert storageQuery("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES ");
+	storageQuery.upsert({ "value" });
+
+	std::ostringstream removed;
+	std::ostringstream query;
+	for (const auto key : keys) {
+		const auto it = player->storageMap.find(key);
+		if (it == player->storageMap.end()) {
+			removed << (removed.tellp() > 0 ? "," : "") << key;
+			continue;
+		}
+
+		query << player->getGUID() << ',' << key << ',' << it->second;
+		if (!storageQuery.addRow(query)) {
+			return false;
+		}
+	}
+
+	if (removed.tellp() > 0) {
+		const auto deleteQuery = fmt::format("DELETE FROM `player_storage` WHERE `player_id` = {} AND `key` IN ({})", player->getGUID(), removed.str());
+		if (!Database::getInstance().executeQuery(deleteQuery)) {
+			return false;
+		}
+	}
+
+	return storageQuery.execute();
+}
+
+bool IOLoginDataSave::saveSection(std::shared_ptr<Player> player, PlayerSaveSection_t section, const std::function<bool(std::shared_ptr<Player>)> &save) {
+	if (!g_configManager().getBoolean(PLAYER_INCREMENTAL_SAVE)) {
+		return save(player);
+	}
+
+	std::vector<DBWrite> writes;
+	{
+		DBWriteCapture capture;
+		if (!save(player)) {
+			return false;
+		}
+		writes = capture.takeWrites();
+	}
+
+	uint64_t digest = 0;
+	for (const auto &write : writes) {
+		for (const auto &query : write.queries) {
+			digest ^= std::hash<std::string> {}(query) + 0x9e3779b97f4a7c15 + (digest << 6) + (digest >> 2);
+		}
+	}
+	// Zero is kept for sections never saved
+	digest |= 1;
+
+	const auto index = magic_enum::enum_integer(section);
+	player->pendingSectionDigests[index] = digest;
+	if (player->savedSectionDigests[index] == digest) {
+		return true;
+	}
+
+	Database &db = Database::getInstance();
+	return std::ranges::all_of(writes, [&db](const DBWrite &write) {
+		return std::ranges::all_of(write.queries, [&db](const std::string &query) {
+			return db.executeQuery(query);
+		});
+	});
+}
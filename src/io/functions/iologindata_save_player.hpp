@@ -27,6 +27,15 @@ public:
 	static bool savePlayerForgeHistory(std::shared_ptr<Player> player);
 	static bool savePlayerBosstiary(std::shared_ptr<Player> player);
 	static bool savePlayerStorage(std::shared_ptr<Player> palyer);
+	// Writes only the storageDirtyKeys rows, once player_storage is known to match the rest
+	static bool savePlayerStorageDiff(std::shared_ptr<Player> player);
+
+	/**
+	 * Runs a save function with its queries captured and only sends them when
+	 * they differ from the ones the section sent on the last successful save.
+	 * The new digest is staged in Player::pendingSectionDigests.
+	 */
+	static bool saveSection(std::shared_ptr<Player> player, PlayerSaveSection_t section, const std::function<bool(std::shared_ptr<Player>)> &save);
 
 protected:
 	using ItemBlockList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
@@ -34,5 +43,10 @@ protected:
 	using ItemRewardList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
 	using ItemInboxList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
 
+	using ItemRowList = std::vector<std::pair<int32_t, std::string>>;
+
 	static bool saveItems(std::shared_ptr<Player> player, const ItemBlockList &itemList, DBInsert &query_insert, PropWriteStream &stream);
+	// Serializes the items and their containers into (sid, row) pairs in the order saveItems inserts them
+	static bool serializeItems(std::shared_ptr<Player> player, const ItemBlockList &itemList, ItemRowList &rows, PropWriteStream &stream);
+	static bool saveDepotItemsDiff(std::shared_ptr<Player> player, const ItemDepotList &depotList, PropWriteStream &stream);
 };
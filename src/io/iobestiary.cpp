@@ -95,8 +95,8 @@ bool IOBestiary::parseCharmCombat(const std::shared_ptr<Charm> charm, std::share
 }
 
 std::shared_ptr<Charm> IOBestiary::getBestiaryCharm(charmRune_t activeCharm, bool force /*= false*/) const {
-	const auto charmInternal = g_game().getCharmList();
-	for (const auto tmpCharm : charmInternal) {
+	const auto &charmInternal = g_game().getCharmList();
+	for (const auto &tmpCharm : charmInternal) {
 		if (tmpCharm->id == activeCharm) {
 			return tmpCharm;
 		}
@@ -166,18 +166,14 @@ void IOBestiary::setCharmRuneCreature(std::shared_ptr<Player> player, const std:
 	player->setUsedRunesBit(Toggle);
 }
 
-std::list<charmRune_t> IOBestiary::getCharmUsedRuneBitAll(std::shared_ptr<Player> player) {
-	int32_t input = player->getUsedRunesBit();
-	;
-	int8_t i = 0;
-	std::list<charmRune_t> rtn;
-	while (input != 0) {
-		if ((input & 1) == 1) {
-			charmRune_t tmpcharm = static_cast<charmRune_t>(i);
-			rtn.push_front(tmpcharm);
+std::vector<charmRune_t> IOBestiary::getCharmUsedRuneBitAll(std::shared_ptr<Player> player) {
+	const auto input = static_cast<uint32_t>(player->getUsedRunesBit());
+	std::vector<charmRune_t> rtn;
+	rtn.reserve(std::popcount(input));
+	for (int8_t i = std::bit_width(input) - 1; i >= 0; --i) {
+		if ((input & (1u << i)) != 0) {
+			rtn.push_back(static_cast<charmRune_t>(i));
 		}
-		input = input >> 1;
-		i += 1;
 	}
 	return rtn;
 }
@@ -188,9 +184,9 @@ uint16_t IOBestiary::getBestiaryRaceUnlocked(std::shared_ptr<Player> player, Bes
 	}
 
 	uint16_t count = 0;
-	std::map<uint16_t, std::string> besty_l = g_game().getBestiaryList();
+	const auto &besty_l = g_game().getBestiaryList();
 
-	for (auto it : besty_l) {
+	for (const auto &it : besty_l) {
 		const auto mtype = g_monsters().getMonsterType(it.second);
 		if (mtype && mtype->info.bestiaryRace == race && player->getBestiaryKillCount(mtype->info.raceid) > 0) {
 			count++;
@@ -246,16 +242,7 @@ charmRune_t IOBestiary::getCharmFromTarget(std::shared_ptr<Player> player, const
 		return CHARM_NONE;
 	}
 
-	uint16_t bestiaryEntry = mtype->info.raceid;
-	std::list<charmRune_t> usedRunes = getCharmUsedRuneBitAll(player);
-
-	for (charmRune_t it : usedRunes) {
-		const auto charm = getBestiaryCharm(it);
-		if (bestiaryEntry == player->parseRacebyCharm(charm->id, false, 0)) {
-			return charm->id;
-		}
-	}
-	return CHARM_NONE;
+	return player->getCharmByRaceId(mtype->info.raceid);
 }
 
 bool IOBestiary::hasCharmUnlockedRuneBit(const std::shared_ptr<Charm> charm, int32_t input) const {
@@ -307,7 +294,7 @@ void IOBestiary::sendBuyCharmRune(std::shared_ptr<Player> player, charmRune_t ru
 		player->setUnlockedRunesBit(value);
 
 	} else if (action == 1) {
-		std::list<charmRune_t> usedRunes = getCharmUsedRuneBitAll(player);
+		const auto usedRunes = std::popcount(static_cast<uint32_t>(player->getUsedRunesBit()));
 		uint16_t limitRunes = 0;
 
 		if (player->isPremium()) {
@@ -320,7 +307,7 @@ void IOBestiary::sendBuyCharmRune(std::shared_ptr<Player> player, charmRune_t ru
 			limitRunes = 3;
 		}
 
-		if (limitRunes <= usedRunes.size()) {
+		if (limitRunes <= usedRunes) {
 			player->sendFYIBox("You don't have any charm slots available.");
 			player->BestiarysendCharms();
 			return;
@@ -398,9 +385,7 @@ std::map<uint16_t, uint32_t> IOBestiary::getBestiaryKillCountByMonsterIDs(std::s
 
 phmap::parallel_flat_hash_set<uint16_t> IOBestiary::getBestiaryFinished(std::shared_ptr<Player> player) const {
 	phmap::parallel_flat_hash_set<uint16_t> finishedMonsters;
-	auto bestiaryMap = g_game().getBestiaryList();
-
-	for (const auto &[monsterTypeRaceId, monsterTypeName] : bestiaryMap) {
+	for (const auto &[monsterTypeRaceId, monsterTypeName] : g_game().getBestiaryList()) {
 		uint32_t thisKilled = player->getBestiaryKillCount(monsterTypeRaceId);
 		auto mtype = g_monsters().getMonsterType(monsterTypeName);
 		if (mtype && thisKilled >= mtype->info.bestiaryFirstUnlock) {
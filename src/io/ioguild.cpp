@@ -10,9 +10,80 @@
 #include "pch.hpp"
 
 #include "database/database.hpp"
+#include "database/databasetasks.hpp"
 #include "creatures/players/grouping/guild.hpp"
+#include "game/game.hpp"
+#include "game/scheduling/scheduler.hpp"
 #include "io/ioguild.hpp"
 
+namespace {
+	constexpr std::string_view GUILD_WARS_QUERY = "SELECT `guild1`, `guild2` FROM `guild_wars` WHERE `ended` = 0 AND `status` = 1";
+	constexpr std::string_view GUILD_MEMBER_COUNTS_QUERY = "SELECT `guild_id`, COUNT(*) AS `members` FROM `guild_membership` GROUP BY `guild_id`";
+
+	void setGuildWars(const DBResult_ptr &result) {
+		std::vector<std::pair<uint32_t, uint32_t>> wars;
+		if (result) {
+			do {
+				wars.emplace_back(result->getNumber<uint32_t>("guild1"), result->getNumber<uint32_t>("guild2"));
+			} while (result->next());
+		}
+		g_game().setGuildWars(wars);
+	}
+
+	void setMemberCounts(const DBResult_ptr &result) {
+		if (!result) {
+			return;
+		}
+
+		do {
+			if (const auto guild = g_game().getGuild(result->getNumber<uint32_t>("guild_id"), true)) {
+				guild->setMemberCount(result->getNumber<uint32_t>("members"));
+			}
+		} while (result->next());
+	}
+}
+
+void IOGuild::loadGuilds() {
+	Database &db = Database::getInstance();
+	DBResult_ptr result = db.storeQuery("SELECT `id`, `name`, `balance` FROM `guilds`");
+	if (!result) {
+		return;
+	}
+
+	phmap::flat_hash_map<uint32_t, std::shared_ptr<Guild>> loaded;
+	do {
+		const auto guild = std::make_shared<Guild>(result->getNumber<uint32_t>("id"), result->getString("name"));
+		guild->setBankBalance(result->getNumber<uint64_t>("balance"));
+		guild->setSaved();
+		loaded.emplace(guild->getId(), guild);
+	} while (result->next());
+
+	if ((result = db.storeQuery("SELECT `id`, `guild_id`, `name`, `level` FROM `guild_ranks` ORDER BY `id`"))) {
+		do {
+			if (auto it = loaded.find(result->getNumber<uint32_t>("guild_id")); it != loaded.end()) {
+				it->second->addRank(result->getNumber<uint32_t>("id"), result->getString("name"), result->getNumber<uint16_t>("level"));
+			}
+		} while (result->next());
+	}
+
+	for (const auto &[guildId, guild] : loaded) {
+		g_game().addGuild(guild);
+	}
+	setMemberCounts(db.storeQuery(GUILD_MEMBER_COUNTS_QUERY));
+	setGuildWars(db.storeQuery(GUILD_WARS_QUERY));
+	g_logger().info("Loaded {} guilds", loaded.size());
+}
+
+void IOGuild::refresh() {
+	g_databaseTasks().store(std::string(GUILD_WARS_QUERY), [](DBResult_ptr result, bool) {
+		setGuildWars(result);
+	});
+	g_databaseTasks().store(std::string(GUILD_MEMBER_COUNTS_QUERY), [](DBResult_ptr result, bool) {
+		setMemberCounts(result);
+	});
+	g_scheduler().addEvent(REFRESH_INTERVAL_MS, [] { IOGuild::refresh(); }, "IOGuild::refresh");
+}
+
 std::shared_ptr<Guild> IOGuild::loadGuild(uint32_t guildId) {
 	Database &db = Database::getInstance();
 	std::ostringstream query;
@@ -20,6 +91,7 @@ std::shared_ptr<Guild> IOGuild::loadGuild(uint32_t guildId) {
 	if (DBResult_ptr result = db.storeQuery(query.str())) {
 		const auto guild = std::make_shared<Guild>(guildId, result->getString("name"));
 		guild->setBankBalance(result->getNumber<uint64_t>("balance"));
+		guild->setSaved();
 		query.str(std::string());
 		query << "SELECT `id`, `name`, `level` FROM `guild_ranks` WHERE `guild_id` = " << guildId;
 
@@ -34,9 +106,11 @@ std::shared_ptr<Guild> IOGuild::loadGuild(uint32_t guildId) {
 }
 
 void IOGuild::saveGuild(const std::shared_ptr<Guild> guild) {
-	if (!guild) {
+	if (!guild || !guild->hasUnsavedChanges()) {
 		return;
 	}
+	guild->setSaved();
+
 	Database &db = Database::getInstance();
 	std::ostringstream updateQuery;
 	updateQuery << "UPDATE `guilds` SET ";
@@ -57,22 +131,3 @@ uint32_t IOGuild::getGuildIdByName(const std::string &name) {
 	}
 	return result->getNumber<uint32_t>("id");
 }
-
-void IOGuild::getWarList(uint32_t guildId, GuildWarVector &guildWarVector) {
-	std::ostringstream query;
-	query << "SELECT `guild1`, `guild2` FROM `guild_wars` WHERE (`guild1` = " << guildId << " OR `guild2` = " << guildId << ") AND `ended` = 0 AND `status` = 1";
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
-		return;
-	}
-
-	do {
-		uint32_t guild1 = result->getNumber<uint32_t>("guild1");
-		if (guildId != guild1) {
-			guildWarVector.push_back(guild1);
-		} else {
-			guildWarVector.push_back(result->getNumber<uint32_t>("guild2"));
-		}
-	} while (result->next());
-}
@@ -10,12 +10,22 @@
 #pragma once
 
 class Guild;
-using GuildWarVector = std::vector<uint32_t>;
 
+/**
+ * Every guild is loaded at startup with its ranks and member count, the
+ * wars going on are kept in Game. Guilds created later are loaded when
+ * first asked for. The wars and member counts are changed from outside
+ * (the website), refresh() reads them again every REFRESH_INTERVAL_MS.
+ */
 class IOGuild {
 public:
+	static constexpr uint32_t REFRESH_INTERVAL_MS = 60 * 1000;
+
+	static void loadGuilds();
+	// Reads the wars and member counts on the database pool and schedules the next refresh
+	static void refresh();
 	static std::shared_ptr<Guild> loadGuild(uint32_t guildId);
+	// Writes the guild only when it changed since it was loaded or last saved
 	static void saveGuild(const std::shared_ptr<Guild> guild);
 	static uint32_t getGuildIdByName(const std::string &name);
-	static void getWarList(uint32_t guildId, GuildWarVector &guildWarVector);
 };
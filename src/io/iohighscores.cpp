@@ -0,0 +1,174 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "io/iohighscores.hpp"
+#include "creatures/players/player.hpp"
+#include "creatures/players/vocations/vocation.hpp"
+#include "database/databasetasks.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "game/scheduling/scheduler.hpp"
+
+namespace {
+	// Column of each HighscoreCategories_t
+	constexpr std::array<std::string_view, IOHighscores::CATEGORY_COUNT> CATEGORY_COLUMNS = {
+		"experience",
+		"skill_fist",
+		"skill_club",
+		"skill_sword",
+		"skill_axe",
+		"skill_dist",
+		"skill_shielding",
+		"skill_fishing",
+		"maglevel",
+	};
+}
+
+void IOHighscores::start() {
+	refresh();
+}
+
+void IOHighscores::refresh() {
+	if (refreshing) {
+		return;
+	}
+
+	// Copied here, the vocations are only safe to read on the game thread
+	phmap::flat_hash_map<uint16_t, uint32_t> baseVocations;
+	for (const auto &[id, vocation] : g_vocations().getVocations()) {
+		baseVocations[id] = vocation.getFromVocation();
+	}
+
+	std::ostringstream query;
+	query << "SELECT `id`, `name`, `level`, `vocation`";
+	for (const auto &column : CATEGORY_COLUMNS) {
+		query << ", `" << column << '`';
+	}
+	query << " FROM `players` WHERE `group_id` < " << static_cast<int>(account::GROUP_TYPE_GAMEMASTER);
+
+	refreshing = true;
+	g_databaseTasks().store(query.str(), [baseVocations = std::move(baseVocations)](DBResult_ptr result, bool) {
+		inject<ThreadPool>().addLoad([result, baseVocations]() {
+			auto snapshot = buildSnapshot(result, baseVocations);
+			g_dispatcher().addTask([snapshot = std::move(snapshot)]() {
+				auto &highscores = IOHighscores::getInstance();
+				highscores.refreshing = false;
+				if (snapshot) {
+					highscores.snapshot = snapshot;
+				}
+
+				const auto interval = g_configManager().getNumber(HIGHSCORES_REFRESH_INTERVAL);
+				if (interval > 0) {
+					g_scheduler().addEvent(static_cast<uint32_t>(interval) * 1000, [] { IOHighscores::getInstance().refresh(); }, "IOHighscores::refresh");
+				}
+			},
+			                       "IOHighscores::refresh");
+		});
+	});
+}
+
+std::shared_ptr<const IOHighscores::Snapshot> IOHighscores::buildSnapshot(const DBResult_ptr &result, const phmap::flat_hash_map<uint16_t, uint32_t> &baseVocations) {
+	if (!result) {
+		return nullptr;
+	}
+
+	auto snapshot = std::make_shared<Snapshot>();
+	auto &characters = snapshot->characters;
+	characters.reserve(result->countResults());
+	do {
+		auto &character = characters.emplace_back();
+		character.id = result->getNumber<uint32_t>("id");
+		character.name = result->getString("name");
+		character.level = result->getNumber<uint16_t>("level");
+		character.vocation = result->getNumber<uint16_t>("vocation");
+		for (size_t category = 0; category < CATEGORY_COUNT; ++category) {
+			character.points[category] = result->getNumber<uint64_t>(std::string(CATEGORY_COLUMNS[category]));
+		}
+	} while (result->next());
+
+	for (size_t category = 0; category < CATEGORY_COUNT; ++category) {
+		auto &ranking = snapshot->rankings[category];
+		ranking.order.resize(characters.size());
+		std::iota(ranking.order.begin(), ranking.order.end(), 0);
+		std::ranges::stable_sort(ranking.order, [&characters, category](uint32_t lhs, uint32_t rhs) {
+			return characters[lhs].points[category] > characters[rhs].points[category];
+		});
+
+		ranking.ranks.resize(characters.size());
+		uint32_t rank = 0;
+		for (size_t position = 0; position < ranking.order.size(); ++position) {
+			const auto &character = characters[ranking.order[position]];
+			if (position == 0 || character.points[category] != characters[ranking.order[position - 1]].points[category]) {
+				++rank;
+			}
+			ranking.ranks[position] = rank;
+
+			if (auto it = baseVocations.find(character.vocation); it != baseVocations.end()) {
+				ranking.vocations[it->second].push_back(static_cast<uint32_t>(position));
+			}
+		}
+	}
+
+	return snapshot;
+}
+
+bool IOHighscores::sendEntries(const std::shared_ptr<Player> &player, HighscoreType_t type, uint8_t category, uint32_t vocation, uint16_t page, uint8_t entriesPerPage) const {
+	if (!snapshot || entriesPerPage == 0) {
+		return false;
+	}
+
+	const auto &ranking = snapshot->rankings[category];
+	const std::vector<uint32_t>* positions = nullptr;
+	if (vocation != ALL_VOCATIONS) {
+		auto it = ranking.vocations.find(vocation);
+		if (it == ranking.vocations.end()) {
+			player->sendHighscoresNoData();
+			return true;
+		}
+		positions = &it->second;
+	}
+
+	const size_t entries = positions ? positions->size() : ranking.order.size();
+	const auto getPosition = [positions](size_t row) {
+		return positions ? (*positions)[row] : static_cast<uint32_t>(row);
+	};
+
+	if (type == HIGHSCORE_OURRANK) {
+		// Like the old query, a character outside of the ranking sees the first page
+		size_t ourRow = 0;
+		for (size_t row = 0; row < entries; ++row) {
+			if (snapshot->characters[ranking.order[getPosition(row)]].id == player->getGUID()) {
+				ourRow = row;
+				break;
+			}
+		}
+		page = static_cast<uint16_t>(ourRow / entriesPerPage + 1);
+	}
+
+	const size_t firstRow = static_cast<size_t>(std::max<uint16_t>(page, 1) - 1) * entriesPerPage;
+	if (firstRow >= entries) {
+		player->sendHighscoresNoData();
+		return true;
+	}
+
+	const size_t lastRow = std::min(entries, firstRow + entriesPerPage);
+	std::vector<HighscoreCharacter> characters;
+	characters.reserve(lastRow - firstRow);
+	for (size_t row = firstRow; row < lastRow; ++row) {
+		const auto position = getPosition(row);
+		const auto &character = snapshot->characters[ranking.order[position]];
+		const Vocation* voc = g_vocations().getVocation(character.vocation);
+		characters.emplace_back(character.name, character.points[category], character.id, ranking.ranks[position], character.level, voc ? voc->getClientId() : 0);
+	}
+
+	const auto pages = static_cast<uint16_t>((entries + entriesPerPage - 1) / entriesPerPage);
+	player->sendHighscores(characters, category, vocation, page, pages);
+	return true;
+}
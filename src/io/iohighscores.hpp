@@ -0,0 +1,77 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "database/database.hpp"
+#include "game/game_definitions.hpp"
+#include "lib/di/container.hpp"
+#include "server/server_definitions.hpp"
+
+class Player;
+
+/**
+ * Highscores served from a snapshot of the players table, rebuilt every
+ * highscoresRefreshInterval seconds: one query on the database pool, the
+ * rankings of every category are sorted on the compute pool and the new
+ * snapshot is swapped in on the game thread. Requests never reach the
+ * database and are answered right away.
+ *
+ * Ranks are dense and computed over every vocation, like the old ranking
+ * query, the per vocation lists only filter them.
+ */
+class IOHighscores {
+public:
+	static constexpr size_t CATEGORY_COUNT = HIGHSCORE_CATEGORY_MAGIC_LEVEL + 1;
+	static constexpr uint32_t ALL_VOCATIONS = 0xFFFFFFFF;
+
+	IOHighscores() = default;
+
+	// Ensures that we don't accidentally copy it
+	IOHighscores(const IOHighscores &) = delete;
+	IOHighscores operator=(const IOHighscores &) = delete;
+
+	static IOHighscores &getInstance() {
+		return inject<IOHighscores>();
+	}
+
+	// Game thread only, builds the first snapshot and keeps refreshing it
+	void start();
+
+	// Game thread only, false until the first snapshot is ready
+	bool sendEntries(const std::shared_ptr<Player> &player, HighscoreType_t type, uint8_t category, uint32_t vocation, uint16_t page, uint8_t entriesPerPage) const;
+
+private:
+	struct Character {
+		uint32_t id;
+		uint16_t level;
+		uint16_t vocation;
+		std::string name;
+		std::array<uint64_t, CATEGORY_COUNT> points;
+	};
+
+	struct Ranking {
+		// Characters by points, most first, with their rank
+		std::vector<uint32_t> order;
+		std::vector<uint32_t> ranks;
+		// [base vocation, positions in order of its characters]
+		phmap::flat_hash_map<uint32_t, std::vector<uint32_t>> vocations;
+	};
+
+	struct Snapshot {
+		std::vector<Character> characters;
+		std::array<Ranking, CATEGORY_COUNT> rankings;
+	};
+
+	void refresh();
+	static std::shared_ptr<const Snapshot> buildSnapshot(const DBResult_ptr &result, const phmap::flat_hash_map<uint16_t, uint32_t> &baseVocations);
+
+	std::shared_ptr<const Snapshot> snapshot;
+	bool refreshing = false;
+};
@@ -16,8 +16,42 @@
 #include "creatures/monsters/monster.hpp"
 #include "creatures/players/wheel/player_wheel.hpp"
 #include "io/ioprey.hpp"
+#include "database/databasetasks.hpp"
+
+namespace {
+	// Past it the expired logins are dropped before another one is remembered
+	constexpr size_t LOGIN_CACHE_PRUNE_SIZE = 4096;
+
+	struct CachedLogin {
+		// Hash of the password, the session key is already the descriptor
+		std::string secret;
+		uint32_t accountId;
+		int64_t expiresAt;
+	};
+
+	std::mutex loginCacheMutex;
+	phmap::flat_hash_map<std::string, CachedLogin> loginCache;
+
+	std::string getLoginCacheKey(const std::string &accountDescriptor, const std::string &characterName, bool oldProtocol) {
+		return fmt::format("{}\n{}\n{}", oldProtocol, accountDescriptor, characterName);
+	}
+}
 
 bool IOLoginData::gameWorldAuthentication(const std::string &accountDescriptor, const std::string &password, std::string &characterName, uint32_t &accountId, bool oldProtocol) {
+	const auto cacheTime = g_configManager().getNumber(LOGIN_CACHE_TIME);
+	const auto cacheKey = getLoginCacheKey(accountDescriptor, characterName, oldProtocol);
+	const auto secret = transformToSHA1(password);
+	if (cacheTime > 0) {
+		std::scoped_lock lock(loginCacheMutex);
+		if (auto it = loginCache.find(cacheKey); it != loginCache.end()) {
+			if (it->second.expiresAt > OTSYS_TIME() && it->second.secret == secret) {
+				accountId = it->second.accountId;
+				return true;
+			}
+			loginCache.erase(it);
+		}
+	}
+
 	account::Account account(accountDescriptor);
 	account.setProtocolCompat(oldProtocol);
 
@@ -36,11 +70,6 @@ bool IOLoginData::gameWorldAuthentication(const std::string &accountDescriptor,
 		}
 	}
 
-	if (account::ERROR_NO != account.load()) {
-		g_logger().error("Failed to load account [{}]", accountDescriptor);
-		return false;
-	}
-
 	auto [players, result] = account.getAccountPlayers();
 	if (account::ERROR_NO != result) {
 		g_logger().error("Failed to load account [{}] players", accountDescriptor);
@@ -54,6 +83,14 @@ bool IOLoginData::gameWorldAuthentication(const std::string &accountDescriptor,
 
 	accountId = account.getID();
 
+	if (cacheTime > 0) {
+		std::scoped_lock lock(loginCacheMutex);
+		const auto now = OTSYS_TIME();
+		if (loginCache.size() >= LOGIN_CACHE_PRUNE_SIZE) {
+			phmap::erase_if(loginCache, [now](const auto &entry) { return entry.second.expiresAt <= now; });
+		}
+		loginCache[cacheKey] = CachedLogin { secret, accountId, now + cacheTime * 1000 };
+	}
 	return true;
 }
 
@@ -87,16 +124,12 @@ void IOLoginData::updateOnlineStatus(uint32_t guid, bool login) {
 // The boolean "disable" will desactivate the loading of information that is not relevant to the preload, for example, forge, bosstiary, etc. None of this we need to access if the player is offline
 bool IOLoginData::loadPlayerById(std::shared_ptr<Player> player, uint32_t id, bool disable /* = true*/) {
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT * FROM `players` WHERE `id` = " << id;
-	return loadPlayer(player, db.storeQuery(query.str()), disable);
+	return loadPlayer(player, db.storeStatement(PLAYER_BY_ID_STATEMENT, { id }), disable);
 }
 
 bool IOLoginData::loadPlayerByName(std::shared_ptr<Player> player, const std::string &name, bool disable /* = true*/) {
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT * FROM `players` WHERE `name` = " << db.escapeString(name);
-	return loadPlayer(player, db.storeQuery(query.str()), disable);
+	return loadPlayer(player, db.storeStatement("SELECT * FROM `players` WHERE `name` = ?", { name }), disable);
 }
 
 bool IOLoginData::loadPlayer(std::shared_ptr<Player> player, DBResult_ptr result, bool disable /* = false*/) {
@@ -110,6 +143,9 @@ bool IOLoginData::loadPlayer(std::shared_ptr<Player> player, DBResult_ptr result
 		// First
 		IOLoginDataLoad::loadPlayerFirst(player, result);
 
+		// Credits received while offline
+		applyBankLedger(player);
+
 		// Experience load
 		IOLoginDataLoad::loadPlayerExperience(player, result);
 
@@ -187,12 +223,39 @@ bool IOLoginData::loadPlayer(std::shared_ptr<Player> player, DBResult_ptr result
 }
 
 bool IOLoginData::savePlayer(std::shared_ptr<Player> player) {
+	if (player) {
+		// A global save may still hold an older snapshot of this player, it must not land after this one
+		const auto key = fmt::format("player:{}", player->getGUID());
+		bool stale;
+		if (auto capture = DBWriteCapture::getActive()) {
+			capture->setKey(key);
+			stale = g_databaseTasks().takeFailedWrites(key);
+		} else {
+			stale = g_databaseTasks().cancelWrites(key);
+		}
+
+		// The tables skipped as unchanged must be written again
+		if (stale) {
+			player->invalidateSaveDigests();
+		}
+		player->pendingSectionDigests = player->savedSectionDigests;
+		player->pendingDepotRows.reset();
+	}
+
 	bool success = DBTransaction::executeWithinTransaction([player]() {
 		return savePlayerGuard(player);
 	});
 
 	if (!success) {
 		g_logger().error("[{}] Error occurred saving player", __FUNCTION__);
+		// The dirty keys were already taken, the next save rewrites the whole table
+		player->storageSynced = false;
+	} else {
+		player->storageSynced = true;
+		player->savedSectionDigests = player->pendingSectionDigests;
+		if (player->pendingDepotRows) {
+			player->savedDepotRows = std::move(*player->pendingDepotRows);
+		}
 	}
 
 	return success;
@@ -207,59 +270,62 @@ bool IOLoginData::savePlayerGuard(std::shared_ptr<Player> player) {
 		throw DatabaseException("[" + std::string(__FUNCTION__) + "] - Failed to save player first: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerStash(player)) {
+	if (!IOLoginDataSave::saveSection(player, PlayerSaveSection_t::STASH, IOLoginDataSave::savePlayerStash)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerFirst] - Failed to save player stash: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerSpells(player)) {
+	if (!IOLoginDataSave::saveSection(player, PlayerSaveSection_t::SPELLS, IOLoginDataSave::savePlayerSpells)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerSpells] - Failed to save player spells: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerKills(player)) {
+	if (!IOLoginDataSave::saveSection(player, PlayerSaveSection_t::KILLS, IOLoginDataSave::savePlayerKills)) {
 		throw DatabaseException("IOLoginDataSave::savePlayerKills] - Failed to save player kills: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerBestiarySystem(player)) {
+	if (!IOLoginDataSave::saveSection(player, PlayerSaveSection_t::BESTIARY, IOLoginDataSave::savePlayerBestiarySystem)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerBestiarySystem] - Failed to save player bestiary system: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerItem(player)) {
+	if (!IOLoginDataSave::saveSection(player, PlayerSaveSection_t::ITEMS, IOLoginDataSave::savePlayerItem)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerItem] - Failed to save player item: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerDepotItems(player)) {
+	if (!IOLoginDataSave::saveSection(player, PlayerSaveSection_t::DEPOT, IOLoginDataSave::savePlayerDepotItems)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerDepotItems] - Failed to save player depot items: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::saveRewardItems(player)) {
+	if (!IOLoginDataSave::saveSection(player, PlayerSaveSection_t::REWARDS, IOLoginDataSave::saveRewardItems)) {
 		throw DatabaseException("[IOLoginDataSave::saveRewardItems] - Failed to save player reward items: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerInbox(player)) {
+	if (!IOLoginDataSave::saveSection(player, PlayerSaveSection_t::INBOX, IOLoginDataSave::savePlayerInbox)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerInbox] - Failed to save player inbox: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerPreyClass(player)) {
+	if (!IOLoginDataSave::saveSection(player, PlayerSaveSection_t::PREY, IOLoginDataSave::savePlayerPreyClass)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerPreyClass] - Failed to save player prey class: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerTaskHuntingClass(player)) {
+	if (!IOLoginDataSave::saveSection(player, PlayerSaveSection_t::TASK_HUNTING, IOLoginDataSave::savePlayerTaskHuntingClass)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerTaskHuntingClass] - Failed to save player task hunting class: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerForgeHistory(player)) {
+	if (!IOLoginDataSave::saveSection(player, PlayerSaveSection_t::FORGE_HISTORY, IOLoginDataSave::savePlayerForgeHistory)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerForgeHistory] - Failed to save player forge history: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerBosstiary(player)) {
+	if (!IOLoginDataSave::saveSection(player, PlayerSaveSection_t::BOSSTIARY, IOLoginDataSave::savePlayerBosstiary)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerBosstiary] - Failed to save player bosstiary: " + player->getName());
 	}
 
-	if (!player->wheel()->saveDBPlayerSlotPointsOnLogout()) {
+	const auto saveWheel = [](std::shared_ptr<Player> owner) {
+		return owner->wheel()->saveDBPlayerSlotPointsOnLogout();
+	};
+	if (!IOLoginDataSave::saveSection(player, PlayerSaveSection_t::WHEEL, saveWheel)) {
 		throw DatabaseException("[PlayerWheel::saveDBPlayerSlotPointsOnLogout] - Failed to save player wheel info: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerStorage(player)) {
+	if (!IOLoginDataSave::saveSection(player, PlayerSaveSection_t::STORAGE, IOLoginDataSave::savePlayerStorage)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerStorage] - Failed to save player storage: " + player->getName());
 	}
 
@@ -267,9 +333,7 @@ bool IOLoginData::savePlayerGuard(std::shared_ptr<Player> player) {
 }
 
 std::string IOLoginData::getNameByGuid(uint32_t guid) {
-	std::ostringstream query;
-	query << "SELECT `name` FROM `players` WHERE `id` = " << guid;
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
+	DBResult_ptr result = Database::getInstance().storeStatement("SELECT `name` FROM `players` WHERE `id` = ?", { guid });
 	if (!result) {
 		return std::string();
 	}
@@ -279,9 +343,7 @@ std::string IOLoginData::getNameByGuid(uint32_t guid) {
 uint32_t IOLoginData::getGuidByName(const std::string &name) {
 	Database &db = Database::getInstance();
 
-	std::ostringstream query;
-	query << "SELECT `id` FROM `players` WHERE `name` = " << db.escapeString(name);
-	DBResult_ptr result = db.storeQuery(query.str());
+	DBResult_ptr result = db.storeStatement("SELECT `id` FROM `players` WHERE `name` = ?", { name });
 	if (!result) {
 		return 0;
 	}
@@ -291,9 +353,7 @@ uint32_t IOLoginData::getGuidByName(const std::string &name) {
 bool IOLoginData::getGuidByNameEx(uint32_t &guid, bool &specialVip, std::string &name) {
 	Database &db = Database::getInstance();
 
-	std::ostringstream query;
-	query << "SELECT `name`, `id`, `group_id`, `account_id` FROM `players` WHERE `name` = " << db.escapeString(name);
-	DBResult_ptr result = db.storeQuery(query.str());
+	DBResult_ptr result = db.storeStatement("SELECT `name`, `id`, `group_id`, `account_id` FROM `players` WHERE `name` = ?", { name });
 	if (!result) {
 		return false;
 	}
@@ -311,10 +371,7 @@ bool IOLoginData::getGuidByNameEx(uint32_t &guid, bool &specialVip, std::string
 bool IOLoginData::formatPlayerName(std::string &name) {
 	Database &db = Database::getInstance();
 
-	std::ostringstream query;
-	query << "SELECT `name` FROM `players` WHERE `name` = " << db.escapeString(name);
-
-	DBResult_ptr result = db.storeQuery(query.str());
+	DBResult_ptr result = db.storeStatement("SELECT `name` FROM `players` WHERE `name` = ?", { name });
 	if (!result) {
 		return false;
 	}
@@ -323,10 +380,51 @@ bool IOLoginData::formatPlayerName(std::string &name) {
 	return true;
 }
 
-void IOLoginData::increaseBankBalance(uint32_t guid, uint64_t bankBalance) {
-	std::ostringstream query;
-	query << "UPDATE `players` SET `balance` = `balance` + " << bankBalance << " WHERE `id` = " << guid;
-	Database::getInstance().executeQuery(query.str());
+void IOLoginData::increaseBankBalance(uint32_t guid, uint64_t bankBalance, std::function<void(bool)> callback /* = nullptr*/) {
+	const auto query = fmt::format("INSERT INTO `player_bank_ledger` (`player_id`, `amount`, `created_at`) VALUES ({}, {}, {})", guid, bankBalance, getTimeNow());
+	g_databaseTasks().execute(
+		query,
+		[guid, bankBalance, callback](DBResult_ptr, bool success) {
+			if (!success) {
+				g_logger().error("[IOLoginData::increaseBankBalance] - Failed to credit {} gold to player with guid {}", bankBalance, guid);
+			}
+			if (callback) {
+				callback(success);
+			}
+		},
+		guid
+	);
+}
+
+void IOLoginData::applyBankLedger(std::shared_ptr<Player> player) {
+	Database &db = Database::getInstance();
+	const uint32_t guid = player->getGUID();
+	DBResult_ptr result = db.storeQuery(fmt::format("SELECT SUM(`amount`) AS `amount`, MAX(`id`) AS `last_id` FROM `player_bank_ledger` WHERE `player_id` = {}", guid));
+	if (!result) {
+		return;
+	}
+
+	const auto amount = result->getNumber<uint64_t>("amount");
+	const auto lastId = result->getNumber<uint64_t>("last_id");
+	if (lastId == 0) {
+		return;
+	}
+
+	// Rows added after the select stay for the next load
+	const bool applied = DBTransaction::executeWithinTransaction([&db, guid, amount, lastId]() {
+		// Both or neither, a balance raised with its rows kept would be credited twice
+		if (!db.executeQuery(fmt::format("UPDATE `players` SET `balance` = `balance` + {} WHERE `id` = {}", amount, guid))
+			|| !db.executeQuery(fmt::format("DELETE FROM `player_bank_ledger` WHERE `player_id` = {} AND `id` <= {}", guid, lastId))) {
+			throw std::runtime_error("bank ledger query failed");
+		}
+		return true;
+	});
+	if (!applied) {
+		g_logger().error("[{}] - Failed to apply the bank ledger of player {}", __FUNCTION__, player->getName());
+		return;
+	}
+
+	player->setBankBalance(player->getBankBalance() + amount);
 }
 
 bool IOLoginData::hasBiddedOnHouse(uint32_t guid) {
@@ -363,7 +461,7 @@ void IOLoginData::addVIPEntry(uint32_t accountId, uint32_t guid, const std::stri
 
 	std::ostringstream query;
 	query << "INSERT INTO `account_viplist` (`account_id`, `player_id`, `description`, `icon`, `notify`) VALUES (" << accountId << ',' << guid << ',' << db.escapeString(description) << ',' << icon << ',' << notify << ')';
-	db.executeQuery(query.str());
+	g_databaseTasks().execute(query.str(), nullptr, accountId);
 }
 
 void IOLoginData::editVIPEntry(uint32_t accountId, uint32_t guid, const std::string &description, uint32_t icon, bool notify) {
@@ -371,11 +469,11 @@ void IOLoginData::editVIPEntry(uint32_t accountId, uint32_t guid, const std::str
 
 	std::ostringstream query;
 	query << "UPDATE `account_viplist` SET `description` = " << db.escapeString(description) << ", `icon` = " << icon << ", `notify` = " << notify << " WHERE `account_id` = " << accountId << " AND `player_id` = " << guid;
-	db.executeQuery(query.str());
+	g_databaseTasks().execute(query.str(), nullptr, accountId);
 }
 
 void IOLoginData::removeVIPEntry(uint32_t accountId, uint32_t guid) {
 	std::ostringstream query;
 	query << "DELETE FROM `account_viplist` WHERE `account_id` = " << accountId << " AND `player_id` = " << guid;
-	Database::getInstance().executeQuery(query.str());
+	g_databaseTasks().execute(query.str(), nullptr, accountId);
 }
@@ -28,7 +28,12 @@ public:
 	static bool getGuidByNameEx(uint32_t &guid, bool &specialVip, std::string &name);
 	static std::string getNameByGuid(uint32_t guid);
 	static bool formatPlayerName(std::string &name);
-	static void increaseBankBalance(uint32_t guid, uint64_t bankBalance);
+	/**
+	 * Credits an offline player through the bank ledger, on the database
+	 * pool. The rows are added to the balance the next time the player is
+	 * loaded, so a save of a copy loaded earlier does not overwrite them.
+	 */
+	static void increaseBankBalance(uint32_t guid, uint64_t bankBalance, std::function<void(bool)> callback = nullptr);
 	static bool hasBiddedOnHouse(uint32_t guid);
 
 	static std::forward_list<VIPEntry> getVIPEntries(uint32_t accountId);
@@ -36,6 +41,11 @@ public:
 	static void editVIPEntry(uint32_t accountId, uint32_t guid, const std::string &description, uint32_t icon, bool notify);
 	static void removeVIPEntry(uint32_t accountId, uint32_t guid);
 
+protected:
+	static constexpr auto PLAYER_BY_ID_STATEMENT = "SELECT * FROM `players` WHERE `id` = ?";
+
 private:
 	static bool savePlayerGuard(std::shared_ptr<Player> player);
+	// Moves the ledger rows of the player into the balance, in the loaded player and the players table
+	static void applyBankLedger(std::shared_ptr<Player> player);
 };
@@ -12,6 +12,8 @@
 #include "game/movement/teleport.hpp"
 #include "game/game.hpp"
 #include "io/filestream.hpp"
+#include "io/mapsnapshot.hpp"
+#include "lib/thread/thread_pool.hpp"
 
 /*
 	OTBM_ROOTV1
@@ -38,9 +40,21 @@
 */
 
 void IOMap::loadMap(Map* map, const Position &pos) {
-	const int64_t start = OTSYS_TIME();
+	const int64_t start = getPreciseTimeMs();
 
 	const auto &fileByte = mio::mmap_source(map->path.string());
+	const std::string_view source(fileByte.data(), fileByte.size());
+
+	std::optional<MapSnapshot> snapshot;
+	if (g_configManager().getBoolean(MAP_SNAPSHOT)) {
+		snapshot.emplace(map->path, pos);
+		if (snapshot->load(*map, source)) {
+			map->flush();
+			g_logger().info("Map Loaded {} ({}x{}) from its snapshot in {} seconds", map->path.filename().string(), map->width, map->height, static_cast<double>(getPreciseTimeMs() - start) / 1000.f);
+			return;
+		}
+	}
+	MapSnapshot* recorder = snapshot ? &*snapshot : nullptr;
 
 	const auto begin = fileByte.begin() + sizeof(OTB::Identifier { { 'O', 'T', 'B', 'M' } });
 
@@ -67,20 +81,24 @@ void IOMap::loadMap(Map* map, const Position &pos) {
 	}
 
 	if (stream.startNode(OTBM_MAP_DATA)) {
-		parseMapDataAttributes(stream, map);
-		parseTileArea(stream, *map, pos);
+		parseMapDataAttributes(stream, map, recorder);
+		parseTileArea(stream, *map, pos, recorder);
 		stream.endNode();
 	}
 
-	parseTowns(stream, *map);
-	parseWaypoints(stream, *map);
+	parseTowns(stream, *map, recorder);
+	parseWaypoints(stream, *map, recorder);
 
 	map->flush();
 
-	g_logger().info("Map Loaded {} ({}x{}) in {} seconds", map->path.filename().string(), map->width, map->height, static_cast<double>(OTSYS_TIME() - start) / 1000.f);
+	if (recorder) {
+		recorder->store(*map, source);
+	}
+
+	g_logger().info("Map Loaded {} ({}x{}) in {} seconds", map->path.filename().string(), map->width, map->height, static_cast<double>(getPreciseTimeMs() - start) / 1000.f);
 }
 
-void IOMap::parseMapDataAttributes(FileStream &stream, Map* map) {
+void IOMap::parseMapDataAttributes(FileStream &stream, Map* map, MapSnapshot* snapshot) {
 	bool end = false;
 	while (!end) {
 		const uint8_t attr = stream.getU8();
@@ -92,15 +110,24 @@ void IOMap::parseMapDataAttributes(FileStream &stream, Map* map) {
 			case OTBM_ATTR_EXT_SPAWN_MONSTER_FILE: {
 				map->monsterfile = map->path.string().substr(0, map->path.string().rfind('/') + 1);
 				map->monsterfile += stream.getString();
+				if (snapshot) {
+					snapshot->addAttribute(attr, map->monsterfile);
+				}
 			} break;
 
 			case OTBM_ATTR_EXT_SPAWN_NPC_FILE: {
 				map->npcfile = map->path.string().substr(0, map->path.string().rfind('/') + 1);
 				map->npcfile += stream.getString();
+				if (snapshot) {
+					snapshot->addAttribute(attr, map->npcfile);
+				}
 			} break;
 			case OTBM_ATTR_EXT_HOUSE_FILE: {
 				map->housefile = map->path.string().substr(0, map->path.string().rfind('/') + 1);
 				map->housefile += stream.getString();
+				if (snapshot) {
+					snapshot->addAttribute(attr, map->housefile);
+				}
 			} break;
 
 			default:
@@ -111,132 +138,214 @@ void IOMap::parseMapDataAttributes(FileStream &stream, Map* map) {
 	}
 }
 
-void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos) {
-	while (stream.startNode(OTBM_TILE_AREA)) {
-		const uint16_t base_x = stream.getU16();
-		const uint16_t base_y = stream.getU16();
-		const uint8_t base_z = stream.getU8();
-
-		bool tileIsStatic = false;
+void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos, MapSnapshot* snapshot) {
+	// Areas do not depend on each other: their extents are indexed first, then
+	// decoded on the thread pool a window at a time and merged here in file order
+	std::vector<std::pair<uint32_t, uint32_t>> areas;
+	for (uint32_t begin = stream.tell(); stream.skipNode(OTBM_TILE_AREA); begin = stream.tell()) {
+		areas.emplace_back(begin, stream.tell());
+	}
 
-		while (stream.startNode()) {
-			const uint8_t tileType = stream.getU8();
-			if (tileType != OTBM_HOUSETILE && tileType != OTBM_TILE) {
-				throw IOMapException("Could not read tile type node.");
+	for (size_t first = 0; first < areas.size(); first += TILE_AREA_WINDOW) {
+		const auto window = std::span(areas).subspan(first, std::min(TILE_AREA_WINDOW, areas.size() - first));
+		for (auto &area : decodeTileAreas(stream, window, pos)) {
+			if (area.error) {
+				std::rethrow_exception(area.error);
 			}
 
-			const auto tile = std::make_shared<BasicTile>();
-
-			const uint8_t tileCoordsX = stream.getU8();
-			const uint8_t tileCoordsY = stream.getU8();
-
-			const uint16_t x = base_x + tileCoordsX + pos.x;
-			const uint16_t y = base_y + tileCoordsY + pos.y;
-			const uint8_t z = static_cast<uint8_t>(base_z + pos.z);
-
-			if (tileType == OTBM_HOUSETILE) {
-				tile->houseId = stream.getU32();
-				if (!map.houses.addHouse(tile->houseId)) {
+			for (const auto &[x, y, z, tile] : area.tiles) {
+				if (tile->isHouse() && !map.houses.addHouse(tile->houseId)) {
 					throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not create house id: {}", x, y, z, tile->houseId));
 				}
-			}
+				if (tile->isHouse() && snapshot) {
+					snapshot->addHouse(tile->houseId);
+				}
 
-			if (stream.isProp(OTBM_ATTR_TILE_FLAGS)) {
-				const uint32_t flags = stream.getU32();
-				if ((flags & OTBM_TILEFLAG_PROTECTIONZONE) != 0) {
-					tile->flags |= TILESTATE_PROTECTIONZONE;
-				} else if ((flags & OTBM_TILEFLAG_NOPVPZONE) != 0) {
-					tile->flags |= TILESTATE_NOPVPZONE;
-				} else if ((flags & OTBM_TILEFLAG_PVPZONE) != 0) {
-					tile->flags |= TILESTATE_PVPZONE;
+				if (tile->isEmpty(true)) {
+					continue;
 				}
 
-				if ((flags & OTBM_TILEFLAG_NOLOGOUT) != 0) {
-					tile->flags |= TILESTATE_NOLOGOUT;
+				tile->ground = map.tryReplaceItemFromCache(tile->ground);
+				for (auto &item : tile->items) {
+					item = map.tryReplaceItemFromCache(item);
+				}
+				const uint32_t cacheIndex = map.setBasicTile(x, y, z, tile);
+				if (snapshot) {
+					snapshot->addTile(x, y, z, cacheIndex);
 				}
 			}
+		}
+	}
+}
 
-			if (stream.isProp(OTBM_ATTR_ITEM)) {
-				const uint16_t id = stream.getU16();
-				const auto &iType = Item::items[id];
-
-				if (!tile->isHouse() || !iType.isBed()) {
-					if (iType.blockSolid) {
-						tileIsStatic = true;
-					}
-
-					const auto item = std::make_shared<BasicItem>();
-					item->id = id;
-
-					if (tile->isHouse() && iType.moveable) {
-						g_logger().warn("[IOMap::loadMap] - "
-										"Moveable item with ID: {}, in house: {}, "
-										"at position: x {}, y {}, z {}",
-										id, tile->houseId, x, y, z);
-					} else if (iType.isGroundTile()) {
-						tile->ground = map.tryReplaceItemFromCache(item);
-					} else {
-						tile->items.emplace_back(map.tryReplaceItemFromCache(item));
-					}
+std::vector<IOMap::TileAreaBatch> IOMap::decodeTileAreas(const FileStream &stream, std::span<const std::pair<uint32_t, uint32_t>> areas, const Position &pos) {
+	std::vector<TileAreaBatch> decoded(areas.size());
+
+	// The caller decodes too and only waits for areas a worker already took,
+	// so this finishes even when every compute thread is busy
+	struct Batch {
+		Batch(const FileStream &stream, std::span<const std::pair<uint32_t, uint32_t>> areas, std::vector<TileAreaBatch> &decoded, const Position &pos) :
+			stream(stream), areas(areas), decoded(decoded), pos(pos) { }
+
+		// Only touched while an index is left, workers may run after decodeTileAreas returned
+		const FileStream &stream;
+		const std::span<const std::pair<uint32_t, uint32_t>> areas;
+		std::vector<TileAreaBatch> &decoded;
+		const Position pos;
+		std::atomic<size_t> next = 0;
+		std::atomic<size_t> done = 0;
+		std::mutex mutex;
+		std::condition_variable finished;
+
+		void run() {
+			for (size_t index = next++; index < areas.size(); index = next++) {
+				try {
+					auto areaStream = stream.slice(areas[index].first, areas[index].second);
+					parseTileAreaNode(areaStream, pos, decoded[index].tiles);
+				} catch (...) {
+					decoded[index].error = std::current_exception();
 				}
-			}
 
-			while (stream.startNode()) {
-				if (stream.getU8() != OTBM_ITEM) {
-					throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not read item node.", x, y, z));
+				if (++done == areas.size()) {
+					std::scoped_lock lock(mutex);
+					finished.notify_all();
 				}
+			}
+		}
+	};
 
-				const uint16_t id = stream.getU16();
+	if (areas.empty()) {
+		return decoded;
+	}
 
-				const auto &iType = Item::items[id];
+	const auto batch = std::make_shared<Batch>(stream, areas, decoded, pos);
+	const auto workers = std::min(inject<ThreadPool>().getThreadCount(), areas.size() - 1);
+	for (size_t i = 0; i < workers; ++i) {
+		inject<ThreadPool>().addLoad([batch] {
+			batch->run();
+		});
+	}
 
-				if (iType.blockSolid) {
-					tileIsStatic = true;
-				}
+	batch->run();
+	std::unique_lock lock(batch->mutex);
+	batch->finished.wait(lock, [&batch] { return batch->done == batch->areas.size(); });
+	return decoded;
+}
+
+void IOMap::parseTileAreaNode(FileStream &stream, const Position &pos, std::vector<LoadedTile> &tiles) {
+	if (!stream.startNode(OTBM_TILE_AREA)) {
+		throw IOMapException("Could not read tile area node.");
+	}
+
+	const uint16_t base_x = stream.getU16();
+	const uint16_t base_y = stream.getU16();
+	const uint8_t base_z = stream.getU8();
+
+	while (stream.startNode()) {
+		const uint8_t tileType = stream.getU8();
+		if (tileType != OTBM_HOUSETILE && tileType != OTBM_TILE) {
+			throw IOMapException("Could not read tile type node.");
+		}
+
+		const auto tile = std::make_shared<BasicTile>();
+
+		const uint8_t tileCoordsX = stream.getU8();
+		const uint8_t tileCoordsY = stream.getU8();
 
+		const uint16_t x = base_x + tileCoordsX + pos.x;
+		const uint16_t y = base_y + tileCoordsY + pos.y;
+		const uint8_t z = static_cast<uint8_t>(base_z + pos.z);
+
+		if (tileType == OTBM_HOUSETILE) {
+			tile->houseId = stream.getU32();
+		}
+
+		if (stream.isProp(OTBM_ATTR_TILE_FLAGS)) {
+			const uint32_t flags = stream.getU32();
+			if ((flags & OTBM_TILEFLAG_PROTECTIONZONE) != 0) {
+				tile->flags |= TILESTATE_PROTECTIONZONE;
+			} else if ((flags & OTBM_TILEFLAG_NOPVPZONE) != 0) {
+				tile->flags |= TILESTATE_NOPVPZONE;
+			} else if ((flags & OTBM_TILEFLAG_PVPZONE) != 0) {
+				tile->flags |= TILESTATE_PVPZONE;
+			}
+
+			if ((flags & OTBM_TILEFLAG_NOLOGOUT) != 0) {
+				tile->flags |= TILESTATE_NOLOGOUT;
+			}
+		}
+
+		if (stream.isProp(OTBM_ATTR_ITEM)) {
+			const uint16_t id = stream.getU16();
+			const auto &iType = Item::items[id];
+
+			if (!tile->isHouse() || !iType.isBed()) {
 				const auto item = std::make_shared<BasicItem>();
 				item->id = id;
 
-				if (!item->unserializeItemNode(stream, x, y, z)) {
-					throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Failed to load item {}, Node Type.", x, y, z, id));
-				}
-
-				if (tile->isHouse() && iType.isBed()) {
-					// nothing
-				} else if (tile->isHouse() && iType.moveable) {
+				if (tile->isHouse() && iType.moveable) {
 					g_logger().warn("[IOMap::loadMap] - "
 									"Moveable item with ID: {}, in house: {}, "
 									"at position: x {}, y {}, z {}",
 									id, tile->houseId, x, y, z);
 				} else if (iType.isGroundTile()) {
-					tile->ground = map.tryReplaceItemFromCache(item);
+					tile->ground = item;
 				} else {
-					tile->items.emplace_back(map.tryReplaceItemFromCache(item));
+					tile->items.emplace_back(item);
 				}
+			}
+		}
 
-				if (!stream.endNode()) {
-					throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
-				}
+		while (stream.startNode()) {
+			if (stream.getU8() != OTBM_ITEM) {
+				throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not read item node.", x, y, z));
 			}
 
-			if (!stream.endNode()) {
-				throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
+			const uint16_t id = stream.getU16();
+
+			const auto &iType = Item::items[id];
+
+			const auto item = std::make_shared<BasicItem>();
+			item->id = id;
+
+			if (!item->unserializeItemNode(stream, x, y, z)) {
+				throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Failed to load item {}, Node Type.", x, y, z, id));
 			}
 
-			if (tile->isEmpty(true)) {
-				continue;
+			if (tile->isHouse() && iType.isBed()) {
+				// nothing
+			} else if (tile->isHouse() && iType.moveable) {
+				g_logger().warn("[IOMap::loadMap] - "
+								"Moveable item with ID: {}, in house: {}, "
+								"at position: x {}, y {}, z {}",
+								id, tile->houseId, x, y, z);
+			} else if (iType.isGroundTile()) {
+				tile->ground = item;
+			} else {
+				tile->items.emplace_back(item);
 			}
 
-			map.setBasicTile(x, y, z, tile);
+			if (!stream.endNode()) {
+				throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
+			}
 		}
 
 		if (!stream.endNode()) {
-			throw IOMapException("Could not end node.");
+			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
 		}
+
+		// House tiles are kept even when empty, the merge still creates their house
+		if (tile->isHouse() || !tile->isEmpty(true)) {
+			tiles.emplace_back(x, y, z, tile);
+		}
+	}
+
+	if (!stream.endNode()) {
+		throw IOMapException("Could not end node.");
 	}
 }
 
-void IOMap::parseTowns(FileStream &stream, Map &map) {
+void IOMap::parseTowns(FileStream &stream, Map &map, MapSnapshot* snapshot) {
 	if (!stream.startNode(OTBM_TOWNS)) {
 		throw IOMapException("Could not read towns node.");
 	}
@@ -251,6 +360,9 @@ void IOMap::parseTowns(FileStream &stream, Map &map) {
 		auto town = map.towns.getOrCreateTown(townId);
 		town->setName(townName);
 		town->setTemplePos(Position(x, y, z));
+		if (snapshot) {
+			snapshot->addTown(townId, townName, town->getTemplePosition());
+		}
 
 		if (!stream.endNode()) {
 			throw IOMapException("Could not end node.");
@@ -262,7 +374,7 @@ void IOMap::parseTowns(FileStream &stream, Map &map) {
 	}
 }
 
-void IOMap::parseWaypoints(FileStream &stream, Map &map) {
+void IOMap::parseWaypoints(FileStream &stream, Map &map, MapSnapshot* snapshot) {
 	if (!stream.startNode(OTBM_WAYPOINTS)) {
 		throw IOMapException("Could not read waypoints node.");
 	}
@@ -274,6 +386,9 @@ void IOMap::parseWaypoints(FileStream &stream, Map &map) {
 		const uint8_t z = stream.getU8();
 
 		map.waypoints[name] = Position(x, y, z);
+		if (snapshot) {
+			snapshot->addWaypoint(name, Position(x, y, z));
+		}
 
 		if (!stream.endNode()) {
 			throw IOMapException("Could not end node.");
@@ -18,6 +18,8 @@
 #include "creatures/monsters/spawns/spawn_monster.hpp"
 #include "creatures/npcs/spawns/spawn_npc.hpp"
 
+class MapSnapshot;
+
 class IOMap {
 public:
 	static void loadMap(Map* map, const Position &pos = Position());
@@ -117,10 +119,30 @@ public:
 	}
 
 private:
-	static void parseMapDataAttributes(FileStream &stream, Map* map);
-	static void parseWaypoints(FileStream &stream, Map &map);
-	static void parseTowns(FileStream &stream, Map &map);
-	static void parseTileArea(FileStream &stream, Map &map, const Position &pos);
+	// Tile areas decoded per window, bounds how many unmerged tiles are held at once
+	static constexpr size_t TILE_AREA_WINDOW = 4096;
+
+	struct LoadedTile {
+		uint16_t x;
+		uint16_t y;
+		uint8_t z;
+		std::shared_ptr<BasicTile> tile;
+	};
+
+	struct TileAreaBatch {
+		std::vector<LoadedTile> tiles;
+		std::exception_ptr error;
+	};
+
+	// The snapshot, when given, records what the parse put in the map
+	static void parseMapDataAttributes(FileStream &stream, Map* map, MapSnapshot* snapshot);
+	static void parseWaypoints(FileStream &stream, Map &map, MapSnapshot* snapshot);
+	static void parseTowns(FileStream &stream, Map &map, MapSnapshot* snapshot);
+	static void parseTileArea(FileStream &stream, Map &map, const Position &pos, MapSnapshot* snapshot);
+	// Decodes the given area extents in parallel, one batch per area in the same order
+	static std::vector<TileAreaBatch> decodeTileAreas(const FileStream &stream, std::span<const std::pair<uint32_t, uint32_t>> areas, const Position &pos);
+	// Touches no shared state, items are replaced from the cache by the merge
+	static void parseTileAreaNode(FileStream &stream, const Position &pos, std::vector<LoadedTile> &tiles);
 };
 
 class IOMapException : public std::exception {
@@ -15,13 +15,14 @@
 #include "items/bed.hpp"
 
 void IOMapSerialize::loadHouseItems(Map* map) {
-	int64_t start = OTSYS_TIME();
+	int64_t start = getPreciseTimeMs();
 
 	DBResult_ptr result = Database::getInstance().storeQuery("SELECT `data` FROM `tile_store`");
 	if (!result) {
 		return;
 	}
 
+	size_t pendingRows = 0;
 	do {
 		unsigned long attrSize;
 		const char* attr = result->getStream("data", attrSize);
@@ -35,72 +36,133 @@ void IOMapSerialize::loadHouseItems(Map* map) {
 			continue;
 		}
 
-		std::shared_ptr<Tile> tile = map->getTile(x, y, z);
-		if (!tile) {
+		// Rows of house tiles not built yet wait for the first tile of their house, most houses are never visited
+		if (const auto house = map->houses.getHouse(map->getPendingHouseId(x, y, z))) {
+			house->addPendingItems(Position(x, y, z), std::string(attr, attrSize));
+			++pendingRows;
 			continue;
 		}
 
-		uint32_t item_count;
-		if (!propStream.read<uint32_t>(item_count)) {
-			continue;
-		}
-
-		while (item_count--) {
-			loadItem(propStream, tile, true);
+		if (std::shared_ptr<Tile> tile = map->getTile(x, y, z)) {
+			loadHouseTileItems(tile, std::string_view(attr, attrSize));
 		}
 	} while (result->next());
-	g_logger().info("Loaded house items in {} seconds", (OTSYS_TIME() - start) / (1000.));
+	g_logger().info("Loaded house items in {} seconds, {} tiles kept serialized until their house is visited", (getPreciseTimeMs() - start) / (1000.), pendingRows);
+}
+
+void IOMapSerialize::loadHouseTileItems(const std::shared_ptr<Tile> &tile, std::string_view data) {
+	PropStream propStream;
+	propStream.init(data.data(), data.size());
+
+	// The position was already read to find the tile
+	uint16_t x, y;
+	uint8_t z;
+	uint32_t item_count;
+	if (!propStream.read<uint16_t>(x) || !propStream.read<uint16_t>(y) || !propStream.read<uint8_t>(z) || !propStream.read<uint32_t>(item_count)) {
+		return;
+	}
+
+	while (item_count--) {
+		loadItem(propStream, tile, true);
+	}
 }
 bool IOMapSerialize::saveHouseItems() {
-	bool success = DBTransaction::executeWithinTransaction([]() {
-		return SaveHouseItemsGuard();
+	HouseDigests digests;
+	bool success = DBTransaction::executeWithinTransaction([&digests]() {
+		return SaveHouseItemsGuard(digests);
 	});
 
 	if (!success) {
 		g_logger().error("[{}] Error occurred saving houses", __FUNCTION__);
+		return false;
 	}
 
-	return success;
+	for (const auto &[house, digest] : digests) {
+		house->setSavedItemsDigest(digest);
+	}
+	return true;
 }
 
-bool IOMapSerialize::SaveHouseItemsGuard() {
-	int64_t start = OTSYS_TIME();
+bool IOMapSerialize::SaveHouseItemsGuard(HouseDigests &digests) {
+	int64_t start = getPreciseTimeMs();
 	Database &db = Database::getInstance();
 	std::ostringstream query;
 
-	// clear old tile data
-	if (!db.executeQuery("DELETE FROM `tile_store`")) {
-		return false;
-	}
-
-	DBInsert stmt("INSERT INTO `tile_store` (`house_id`, `data`) VALUES ");
-
+	// Only the houses whose tiles serialize differently from the last save are rewritten
+	std::vector<std::string> rows;
+	std::string changedHouses;
 	PropWriteStream stream;
 	for (const auto &[key, house] : g_game().map.houses.getHouses()) {
-		// save house items
+		const size_t firstRow = rows.size();
+		uint64_t digest = 0;
 		for (std::shared_ptr<HouseTile> tile : house->getTiles()) {
 			saveTile(stream, tile);
 
 			size_t attributesSize;
 			const char* attributes = stream.getStream(attributesSize);
 			if (attributesSize > 0) {
+				digest = combineDigest(digest, std::string_view(attributes, attributesSize));
 				query << house->getId() << ',' << db.escapeBlob(attributes, attributesSize);
-				if (!stmt.addRow(query)) {
-					return false;
-				}
+				rows.emplace_back(query.str());
+				query.str(std::string());
 				stream.clear();
 			}
 		}
+
+		// Rows still pending are written back as they were read
+		for (const auto &[pos, data] : house->getPendingItems()) {
+			digest = combineDigest(digest, data);
+			query << house->getId() << ',' << db.escapeBlob(data.data(), data.size());
+			rows.emplace_back(query.str());
+			query.str(std::string());
+		}
+
+		// Zero is kept for houses never saved
+		digest |= 1;
+		if (digest == house->getSavedItemsDigest()) {
+			rows.resize(firstRow);
+			continue;
+		}
+
+		digests.emplace_back(house, digest);
+		changedHouses.append(changedHouses.empty() ? "" : ",").append(std::to_string(house->getId()));
 	}
 
-	if (!stmt.execute()) {
-		return false;
+	if (!changedHouses.empty()) {
+		// The rows of a house are replaced together, tile_store has no key per tile to upsert on.
+		// When every house changed (the first save) the rows of houses removed from the map go too
+		const bool allHouses = digests.size() == g_game().map.houses.getHouses().size();
+		if (!db.executeQuery(allHouses ? "DELETE FROM `tile_store`" : fmt::format("DELETE FROM `tile_store` WHERE `house_id` IN ({})", changedHouses))) {
+			return false;
+		}
+
+		DBInsert stmt("INSERT INTO `tile_store` (`house_id`, `data`) VALUES ");
+		for (const auto &row : rows) {
+			if (!stmt.addRow(row)) {
+				return false;
+			}
+		}
+
+		if (!stmt.execute()) {
+			return false;
+		}
 	}
 
-	g_logger().info("Saved house items in {} seconds", (OTSYS_TIME() - start) / (1000.));
+	g_logger().info("Saved items of {} changed houses in {} seconds", digests.size(), (getPreciseTimeMs() - start) / (1000.));
 	return true;
 }
 
+void IOMapSerialize::invalidateHouseDigests() {
+	for (const auto &[key, house] : g_game().map.houses.getHouses()) {
+		house->setSavedItemsDigest(0);
+		house->setSavedInfoDigest(0);
+	}
+}
+
+uint64_t IOMapSerialize::combineDigest(uint64_t digest, std::string_view data) {
+	return digest ^ (std::hash<std::string_view> {}(data) + 0x9e3779b97f4a7c15 + (digest << 6) + (digest >> 2));
+}
+
 bool IOMapSerialize::loadContainer(PropStream &propStream, std::shared_ptr<Container> container) {
 	while (container->serializationCount > 0) {
 		if (!loadItem(propStream, container)) {
@@ -259,7 +321,7 @@ void IOMapSerialize::saveTile(PropWriteStream &stream, std::shared_ptr<Tile> til
 bool IOMapSerialize::loadHouseInfo() {
 	Database &db = Database::getInstance();
 
-	DBResult_ptr result = db.storeQuery("SELECT `id`, `owner`, `new_owner`, `paid`, `warnings` FROM `houses`");
+	DBResult_ptr result = db.storeQuery("SELECT `id`, `owner`, `new_owner`, `paid`, `warnings`, `beds` FROM `houses`");
 	if (!result) {
 		return false;
 	}
@@ -286,6 +348,7 @@ bool IOMapSerialize::loadHouseInfo() {
 			}
 			house->setPaidUntil(result->getNumber<time_t>("paid"));
 			house->setPayRentWarnings(result->getNumber<uint32_t>("warnings"));
+			house->setSavedBedCount(result->getNumber<uint32_t>("beds"));
 		}
 	} while (result->next());
 
@@ -302,72 +365,104 @@ bool IOMapSerialize::loadHouseInfo() {
 }
 
 bool IOMapSerialize::saveHouseInfo() {
-	bool success = DBTransaction::executeWithinTransaction([]() {
-		return SaveHouseInfoGuard();
+	HouseDigests digests;
+	bool success = DBTransaction::executeWithinTransaction([&digests]() {
+		return SaveHouseInfoGuard(digests);
 	});
 
 	if (!success) {
 		g_logger().error("[{}] Error occurred saving houses info", __FUNCTION__);
+		return false;
 	}
 
-	return success;
+	for (const auto &[house, digest] : digests) {
+		house->setSavedInfoDigest(digest);
+	}
+	return true;
 }
 
-bool IOMapSerialize::SaveHouseInfoGuard() {
+bool IOMapSerialize::SaveHouseInfoGuard(HouseDigests &digests) {
 	Database &db = Database::getInstance();
 
-	if (!db.executeQuery("DELETE FROM `house_lists`")) {
-		return false;
-	}
-
+	// Only the houses whose row or access lists changed since the last save are rewritten
+	std::vector<std::string> houseRows;
+	std::vector<std::string> listRows;
+	std::string changedHouses;
 	std::ostringstream query;
 	for (const auto &[key, house] : g_game().map.houses.getHouses()) {
-		query << "SELECT `id` FROM `houses` WHERE `id` = " << house->getId();
-		DBResult_ptr result = db.storeQuery(query.str());
-		if (result) {
-			query.str(std::string());
-			query << "UPDATE `houses` SET `owner` = " << house->getOwner() << ", `paid` = " << house->getPaidUntil() << ", `warnings` = " << house->getPayRentWarnings() << ", `name` = " << db.escapeString(house->getName()) << ", `town_id` = " << house->getTownId() << ", `rent` = " << house->getRent() << ", `size` = " << house->getSize() << ", `beds` = " << house->getBedCount() << " WHERE `id` = " << house->getId();
-		} else {
-			query.str(std::string());
-			query << "INSERT INTO `houses` (`id`, `owner`, `paid`, `warnings`, `name`, `town_id`, `rent`, `size`, `beds`) VALUES (" << house->getId() << ',' << house->getOwner() << ',' << house->getPaidUntil() << ',' << house->getPayRentWarnings() << ',' << db.escapeString(house->getName()) << ',' << house->getTownId() << ',' << house->getRent() << ',' << house->getSize() << ',' << house->getBedCount() << ')';
-		}
-
-		db.executeQuery(query.str());
+		query << house->getId() << ',' << house->getOwner() << ',' << house->getPaidUntil() << ',' << house->getPayRentWarnings() << ',' << db.escapeString(house->getName()) << ',' << house->getTownId() << ',' << house->getRent() << ',' << house->getSize() << ',' << house->getBedCount();
+		std::string houseRow = query.str();
 		query.str(std::string());
-	}
+		uint64_t digest = combineDigest(0, houseRow);
 
-	DBInsert stmt("INSERT INTO `house_lists` (`house_id` , `listid` , `list`) VALUES ");
+		const size_t firstListRow = listRows.size();
+		const auto addList = [&](uint32_t listId, const std::string &listText) {
+			query << house->getId() << ',' << listId << ',' << db.escapeString(listText);
+			listRows.emplace_back(query.str());
+			query.str(std::string());
+			digest = combineDigest(digest, listRows.back());
+		};
 
-	for (const auto &[key, house] : g_game().map.houses.getHouses()) {
 		std::string listText;
 		if (house->getAccessList(GUEST_LIST, listText) && !listText.empty()) {
-			query << house->getId() << ',' << GUEST_LIST << ',' << db.escapeString(listText);
-			if (!stmt.addRow(query)) {
-				return false;
-			}
-
+			addList(GUEST_LIST, listText);
 			listText.clear();
 		}
 
 		if (house->getAccessList(SUBOWNER_LIST, listText) && !listText.empty()) {
-			query << house->getId() << ',' << SUBOWNER_LIST << ',' << db.escapeString(listText);
-			if (!stmt.addRow(query)) {
-				return false;
-			}
-
+			addList(SUBOWNER_LIST, listText);
 			listText.clear();
 		}
 
 		for (std::shared_ptr<Door> door : house->getDoors()) {
 			if (door->getAccessList(listText) && !listText.empty()) {
-				query << house->getId() << ',' << door->getDoorId() << ',' << db.escapeString(listText);
-				if (!stmt.addRow(query)) {
-					return false;
-				}
-
+				addList(door->getDoorId(), listText);
 				listText.clear();
 			}
 		}
+
+		for (const auto &[doorId, doorList] : house->getPendingDoorLists()) {
+			addList(doorId, doorList);
+		}
+
+		// Zero is kept for houses never saved
+		digest |= 1;
+		if (digest == house->getSavedInfoDigest()) {
+			listRows.resize(firstListRow);
+			continue;
+		}
+
+		digests.emplace_back(house, digest);
+		houseRows.emplace_back(std::move(houseRow));
+		changedHouses.append(changedHouses.empty() ? "" : ",").append(std::to_string(house->getId()));
+	}
+
+	if (changedHouses.empty()) {
+		return true;
+	}
+
+	DBInsert houseStmt("INSERT INTO `houses` (`id`, `owner`, `paid`, `warnings`, `name`, `town_id`, `rent`, `size`, `beds`) VALUES ");
+	houseStmt.upsert({ "owner", "paid", "warnings", "name", "town_id", "rent", "size", "beds" });
+	for (const auto &row : houseRows) {
+		if (!houseStmt.addRow(row)) {
+			return false;
+		}
+	}
+
+	if (!houseStmt.execute()) {
+		return false;
+	}
+
+	const bool allHouses = digests.size() == g_game().map.houses.getHouses().size();
+	if (!db.executeQuery(allHouses ? "DELETE FROM `house_lists`" : fmt::format("DELETE FROM `house_lists` WHERE `house_id` IN ({})", changedHouses))) {
+		return false;
+	}
+
+	DBInsert stmt("INSERT INTO `house_lists` (`house_id` , `listid` , `list`) VALUES ");
+	for (const auto &row : listRows) {
+		if (!stmt.addRow(row)) {
+			return false;
+		}
 	}
 
 	if (!stmt.execute()) {
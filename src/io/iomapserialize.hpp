@@ -14,14 +14,22 @@
 class IOMapSerialize {
 public:
 	static void loadHouseItems(Map* map);
+	// Loads a tile_store row into its tile
+	static void loadHouseTileItems(const std::shared_ptr<Tile> &tile, std::string_view data);
 	static bool saveHouseItems();
 	static bool loadHouseInfo();
 	static bool saveHouseInfo();
+	// Makes the next save write every house, e.g. when a deferred write of them failed
+	static void invalidateHouseDigests();
+	// Item, its attributes and its container items, as loadItem reads them
+	static void saveItem(PropWriteStream &stream, std::shared_ptr<Item> item);
 
 private:
-	static bool SaveHouseInfoGuard();
-	static bool SaveHouseItemsGuard();
-	static void saveItem(PropWriteStream &stream, std::shared_ptr<Item> item);
+	using HouseDigests = std::vector<std::pair<std::shared_ptr<House>, uint64_t>>;
+
+	static bool SaveHouseInfoGuard(HouseDigests &digests);
+	static bool SaveHouseItemsGuard(HouseDigests &digests);
+	static uint64_t combineDigest(uint64_t digest, std::string_view data);
 	static void saveTile(PropWriteStream &stream, std::shared_ptr<Tile> tile);
 
 	static bool loadContainer(PropStream &propStream, std::shared_ptr<Container> container);
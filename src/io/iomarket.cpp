@@ -15,6 +15,20 @@
 #include "game/game.hpp"
 #include "game/scheduling/scheduler.hpp"
 
+namespace {
+	// Items and money moved with the offers, so the write queue keeps them ordered with the player saves
+	void enqueueMarketWrite(std::string &&query) {
+		DBWrite write;
+		write.key = "market";
+		write.queries.emplace_back(std::move(query));
+		write.cancelable = false;
+
+		std::vector<DBWrite> writes;
+		writes.emplace_back(std::move(write));
+		g_databaseTasks().enqueueWrites(std::move(writes));
+	}
+}
+
 uint8_t IOMarket::getTierFromDatabaseTable(const std::string &string) {
 	auto tier = static_cast<uint8_t>(std::atoi(string.c_str()));
 	if (tier > g_configManager().getNumber(FORGE_MAX_ITEM_TIER)) {
@@ -25,71 +39,144 @@ uint8_t IOMarket::getTierFromDatabaseTable(const std::string &string) {
 	return tier;
 }
 
-MarketOfferList IOMarket::getActiveOffers(MarketAction_t action, uint16_t itemId, uint8_t tier) {
-	MarketOfferList offerList;
+bool IOMarket::loadOffers() {
+	offers.clear();
+	orderBook.clear();
+	playerOffers.clear();
+	offersByCounter.clear();
+	nextOfferId = 1;
 
-	std::ostringstream query;
-	query << "SELECT `id`, `amount`, `price`, `tier`, `created`, `anonymous`, (SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` FROM `market_offers` WHERE `sale` = " << action << " AND `itemtype` = " << itemId << " AND `tier` = " << std::to_string(tier);
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
+	DBResult_ptr result = Database::getInstance().storeQuery("SELECT `market_offers`.`id`, `player_id`, `sale`, `itemtype`, `amount`, `created`, `anonymous`, `price`, `tier`, `players`.`name` AS `player_name` FROM `market_offers` LEFT JOIN `players` ON `players`.`id` = `market_offers`.`player_id`");
 	if (!result) {
-		return offerList;
+		return false;
 	}
 
-	const int32_t marketOfferDuration = g_configManager().getNumber(MARKET_OFFER_DURATION);
-
 	do {
-		MarketOffer offer;
+		MarketOfferRecord offer;
+		offer.id = result->getNumber<uint32_t>("id");
+		offer.playerId = result->getNumber<uint32_t>("player_id");
+		offer.type = static_cast<MarketAction_t>(result->getNumber<uint16_t>("sale"));
+		offer.itemId = result->getNumber<uint16_t>("itemtype");
 		offer.amount = result->getNumber<uint16_t>("amount");
+		offer.created = result->getNumber<uint32_t>("created");
+		offer.anonymous = result->getNumber<uint16_t>("anonymous") != 0;
 		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("created") + marketOfferDuration;
-		offer.counter = result->getNumber<uint32_t>("id") & 0xFFFF;
-		if (result->getNumber<uint16_t>("anonymous") == 0) {
-			offer.playerName = result->getString("player_name");
-		} else {
-			offer.playerName = "Anonymous";
-		}
 		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
-		offerList.push_back(offer);
+		offer.playerName = result->getString("player_name");
+		nextOfferId = std::max(nextOfferId, offer.id + 1);
+		addOffer(std::move(offer));
 	} while (result->next());
-	return offerList;
+
+	g_logger().info("Loaded {} market offers", offers.size());
+	return true;
 }
 
-MarketOfferList IOMarket::getOwnOffers(MarketAction_t action, uint32_t playerId) {
+void IOMarket::addOffer(MarketOfferRecord &&offer) {
+	auto &side = orderBook[getBookKey(offer.itemId, offer.tier, offer.type)];
+	const std::pair<uint64_t, uint32_t> entry { offer.price, offer.id };
+	side.insert(std::ranges::upper_bound(side, entry), entry);
+	playerOffers[offer.playerId].push_back(offer.id);
+	offersByCounter[getCounterKey(offer.created, offer.id & 0xFFFF)] = offer.id;
+	offers.emplace(offer.id, std::move(offer));
+}
+
+void IOMarket::removeOffer(uint32_t offerId) {
+	auto it = offers.find(offerId);
+	if (it == offers.end()) {
+		return;
+	}
+
+	const auto &offer = it->second;
+	if (auto bookIt = orderBook.find(getBookKey(offer.itemId, offer.tier, offer.type)); bookIt != orderBook.end()) {
+		auto &side = bookIt->second;
+		std::erase(side, std::pair<uint64_t, uint32_t> { offer.price, offer.id });
+		if (side.empty()) {
+			orderBook.erase(bookIt);
+		}
+	}
+
+	if (auto playerIt = playerOffers.find(offer.playerId); playerIt != playerOffers.end()) {
+		std::erase(playerIt->second, offerId);
+		if (playerIt->second.empty()) {
+			playerOffers.erase(playerIt);
+		}
+	}
+
+	if (auto counterIt = offersByCounter.find(getCounterKey(offer.created, offer.id & 0xFFFF)); counterIt != offersByCounter.end() && counterIt->second == offerId) {
+		offersByCounter.erase(counterIt);
+	}
+
+	offers.erase(it);
+}
+
+MarketOfferList IOMarket::getActiveOffers(MarketAction_t action, uint16_t itemId, uint8_t tier) {
 	MarketOfferList offerList;
 
+	const auto &market = getInstance();
+	auto bookIt = market.orderBook.find(getBookKey(itemId, tier, action));
+	if (bookIt == market.orderBook.end()) {
+		return offerList;
+	}
+
 	const int32_t marketOfferDuration = g_configManager().getNumber(MARKET_OFFER_DURATION);
 
-	std::ostringstream query;
-	query << "SELECT `id`, `amount`, `price`, `created`, `itemtype`, `tier` FROM `market_offers` WHERE `player_id` = " << playerId << " AND `sale` = " << action;
+	for (const auto &[price, offerId] : bookIt->second) {
+		const auto &record = market.offers.at(offerId);
+		MarketOffer offer;
+		offer.amount = record.amount;
+		offer.price = record.price;
+		offer.timestamp = record.created + marketOfferDuration;
+		offer.counter = record.id & 0xFFFF;
+		offer.playerName = record.anonymous ? "Anonymous" : record.playerName;
+		offer.tier = record.tier;
+		offerList.push_back(offer);
+	}
+	return offerList;
+}
 
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
+MarketOfferList IOMarket::getOwnOffers(MarketAction_t action, uint32_t playerId) {
+	MarketOfferList offerList;
+
+	const auto &market = getInstance();
+	auto playerIt = market.playerOffers.find(playerId);
+	if (playerIt == market.playerOffers.end()) {
 		return offerList;
 	}
 
-	do {
+	const int32_t marketOfferDuration = g_configManager().getNumber(MARKET_OFFER_DURATION);
+
+	for (const auto offerId : playerIt->second) {
+		const auto &record = market.offers.at(offerId);
+		if (record.type != action) {
+			continue;
+		}
+
 		MarketOffer offer;
-		offer.amount = result->getNumber<uint16_t>("amount");
-		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("created") + marketOfferDuration;
-		offer.counter = result->getNumber<uint32_t>("id") & 0xFFFF;
-		offer.itemId = result->getNumber<uint16_t>("itemtype");
-		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
+		offer.amount = record.amount;
+		offer.price = record.price;
+		offer.timestamp = record.created + marketOfferDuration;
+		offer.counter = record.id & 0xFFFF;
+		offer.itemId = record.itemId;
+		offer.tier = record.tier;
 		offerList.push_back(offer);
-	} while (result->next());
+	}
 	return offerList;
 }
 
 HistoryMarketOfferList IOMarket::getOwnHistory(MarketAction_t action, uint32_t playerId) {
-	HistoryMarketOfferList offerList;
+	auto &market = getInstance();
+	if (auto it = market.histories.find(playerId); it != market.histories.end()) {
+		return it->second[action];
+	}
+
+	auto &history = market.histories[playerId];
 
 	std::ostringstream query;
-	query << "SELECT `itemtype`, `amount`, `price`, `expires_at`, `state`, `tier` FROM `market_history` WHERE `player_id` = " << playerId << " AND `sale` = " << action;
+	query << "SELECT `sale`, `itemtype`, `amount`, `price`, `expires_at`, `state`, `tier` FROM `market_history` WHERE `player_id` = " << playerId;
 
 	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
 	if (!result) {
-		return offerList;
+		return history[action];
 	}
 
 	do {
@@ -107,99 +194,97 @@ HistoryMarketOfferList IOMarket::getOwnHistory(MarketAction_t action, uint32_t p
 
 		offer.state = offerState;
 
-		offerList.push_back(offer);
+		history[result->getNumber<uint16_t>("sale") == MARKETACTION_SELL ? MARKETACTION_SELL : MARKETACTION_BUY].push_back(offer);
 	} while (result->next());
-	return offerList;
+	return history[action];
 }
 
-void IOMarket::processExpiredOffers(DBResult_ptr result, bool) {
-	if (!result) {
-		return;
-	}
-
-	do {
-		if (!IOMarket::moveOfferToHistory(result->getNumber<uint32_t>("id"), OFFERSTATE_EXPIRED)) {
-			continue;
+void IOMarket::deliverExpiredOffer(const MarketOfferRecord &offer) {
+	const uint32_t playerId = offer.playerId;
+	const uint16_t amount = offer.amount;
+	const auto tier = offer.tier;
+	if (offer.type == MARKETACTION_SELL) {
+		const ItemType &itemType = Item::items[offer.itemId];
+		if (itemType.id == 0) {
+			return;
 		}
 
-		const uint32_t playerId = result->getNumber<uint32_t>("player_id");
-		const uint16_t amount = result->getNumber<uint16_t>("amount");
-		auto tier = getTierFromDatabaseTable(result->getString("tier"));
-		if (result->getNumber<uint16_t>("sale") == 1) {
-			const ItemType &itemType = Item::items[result->getNumber<uint16_t>("itemtype")];
-			if (itemType.id == 0) {
-				continue;
+		std::shared_ptr<Player> player = g_game().getPlayerByGUID(playerId);
+		if (!player) {
+			player = std::make_shared<Player>(nullptr);
+			if (!IOLoginData::loadPlayerById(player, playerId)) {
+				return;
 			}
+		}
 
-			std::shared_ptr<Player> player = g_game().getPlayerByGUID(playerId);
-			if (!player) {
-				player = std::make_shared<Player>(nullptr);
-				if (!IOLoginData::loadPlayerById(player, playerId)) {
+		if (itemType.stackable) {
+			uint16_t tmpAmount = amount;
+			while (tmpAmount > 0) {
+				uint16_t stackCount = std::min<uint16_t>(100, tmpAmount);
+				std::shared_ptr<Item> item = Item::CreateItem(itemType.id, stackCount);
+				if (g_game().internalAddItem(player->getInbox(), item, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
+					g_logger().error("[{}] Ocurred an error to add item with id {} to player {}", __FUNCTION__, itemType.id, player->getName());
 
-					continue;
+					break;
 				}
-			}
 
-			if (itemType.stackable) {
-				uint16_t tmpAmount = amount;
-				while (tmpAmount > 0) {
-					uint16_t stackCount = std::min<uint16_t>(100, tmpAmount);
-					std::shared_ptr<Item> item = Item::CreateItem(itemType.id, stackCount);
-					if (g_game().internalAddItem(player->getInbox(), item, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
-						g_logger().error("[{}] Ocurred an error to add item with id {} to player {}", __FUNCTION__, itemType.id, player->getName());
-
-						break;
-					}
-
-					if (tier != 0) {
-						item->setAttribute(ItemAttribute_t::TIER, tier);
-					}
-
-					tmpAmount -= stackCount;
+				if (tier != 0) {
+					item->setAttribute(ItemAttribute_t::TIER, tier);
 				}
+
+				tmpAmount -= stackCount;
+			}
+		} else {
+			int32_t subType;
+			if (itemType.charges != 0) {
+				subType = itemType.charges;
 			} else {
-				int32_t subType;
-				if (itemType.charges != 0) {
-					subType = itemType.charges;
-				} else {
-					subType = -1;
-				}
+				subType = -1;
+			}
 
-				for (uint16_t i = 0; i < amount; ++i) {
-					std::shared_ptr<Item> item = Item::CreateItem(itemType.id, subType);
-					if (g_game().internalAddItem(player->getInbox(), item, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
+			for (uint16_t i = 0; i < amount; ++i) {
+				std::shared_ptr<Item> item = Item::CreateItem(itemType.id, subType);
+				if (g_game().internalAddItem(player->getInbox(), item, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
 
-						break;
-					}
+					break;
+				}
 
-					if (tier != 0) {
-						item->setAttribute(ItemAttribute_t::TIER, tier);
-					}
+				if (tier != 0) {
+					item->setAttribute(ItemAttribute_t::TIER, tier);
 				}
 			}
+		}
 
-			if (player->isOffline()) {
-				IOLoginData::savePlayer(player);
-			}
-		} else {
-			uint64_t totalPrice = result->getNumber<uint64_t>("price") * amount;
+		if (player->isOffline()) {
+			IOLoginData::savePlayer(player);
+		}
+	} else {
+		uint64_t totalPrice = offer.price * amount;
 
-			std::shared_ptr<Player> player = g_game().getPlayerByGUID(playerId);
-			if (player) {
-				player->setBankBalance(player->getBankBalance() + totalPrice);
-			} else {
-				IOLoginData::increaseBankBalance(playerId, totalPrice);
-			}
+		std::shared_ptr<Player> player = g_game().getPlayerByGUID(playerId);
+		if (player) {
+			player->setBankBalance(player->getBankBalance() + totalPrice);
+		} else {
+			IOLoginData::increaseBankBalance(playerId, totalPrice);
 		}
-	} while (result->next());
+	}
 }
 
 void IOMarket::checkExpiredOffers() {
 	const time_t lastExpireDate = getTimeNow() - g_configManager().getNumber(MARKET_OFFER_DURATION);
 
-	std::ostringstream query;
-	query << "SELECT `id`, `amount`, `price`, `itemtype`, `player_id`, `sale`, `tier` FROM `market_offers` WHERE `created` <= " << lastExpireDate;
-	g_databaseTasks().store(query.str(), IOMarket::processExpiredOffers);
+	std::vector<MarketOfferRecord> expiredOffers;
+	for (const auto &[offerId, offer] : getInstance().offers) {
+		if (offer.created <= lastExpireDate) {
+			expiredOffers.push_back(offer);
+		}
+	}
+
+	for (const auto &offer : expiredOffers) {
+		if (moveOfferToHistory(offer.id, OFFERSTATE_EXPIRED)) {
+			deliverExpiredOffer(offer);
+		}
+	}
 
 	int32_t checkExpiredMarketOffersEachMinutes = g_configManager().getNumber(CHECK_EXPIRED_MARKET_OFFERS_EACH_MINUTES);
 	if (checkExpiredMarketOffersEachMinutes <= 0) {
@@ -210,63 +295,83 @@ void IOMarket::checkExpiredOffers() {
 }
 
 uint32_t IOMarket::getPlayerOfferCount(uint32_t playerId) {
-	std::ostringstream query;
-	query << "SELECT COUNT(*) AS `count` FROM `market_offers` WHERE `player_id` = " << playerId;
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
-		return 0;
-	}
-	return result->getNumber<int32_t>("count");
+	const auto &market = getInstance();
+	auto it = market.playerOffers.find(playerId);
+	return it != market.playerOffers.end() ? static_cast<uint32_t>(it->second.size()) : 0;
 }
 
 MarketOfferEx IOMarket::getOfferByCounter(uint32_t timestamp, uint16_t counter) {
 	MarketOfferEx offer;
 
-	const int32_t created = timestamp - g_configManager().getNumber(MARKET_OFFER_DURATION);
+	const uint32_t created = timestamp - g_configManager().getNumber(MARKET_OFFER_DURATION);
 
-	std::ostringstream query;
-	query << "SELECT `id`, `sale`, `itemtype`, `amount`, `created`, `price`, `player_id`, `anonymous`, `tier`, (SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` FROM `market_offers` WHERE `created` = " << created << " AND (`id` & 65535) = " << counter << " LIMIT 1";
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
+	const auto &market = getInstance();
+	auto it = market.offersByCounter.find(getCounterKey(created, counter));
+	if (it == market.offersByCounter.end()) {
 		offer.id = 0;
 		return offer;
 	}
 
-	offer.id = result->getNumber<uint32_t>("id");
-	offer.type = static_cast<MarketAction_t>(result->getNumber<uint16_t>("sale"));
-	offer.amount = result->getNumber<uint16_t>("amount");
-	offer.counter = result->getNumber<uint32_t>("id") & 0xFFFF;
-	offer.timestamp = result->getNumber<uint32_t>("created");
-	offer.price = result->getNumber<uint64_t>("price");
-	offer.itemId = result->getNumber<uint16_t>("itemtype");
-	offer.playerId = result->getNumber<uint32_t>("player_id");
-	offer.tier = getTierFromDatabaseTable(result->getString("tier"));
-	if (result->getNumber<uint16_t>("anonymous") == 0) {
-		offer.playerName = result->getString("player_name");
-	} else {
-		offer.playerName = "Anonymous";
-	}
+	const auto &record = market.offers.at(it->second);
+	offer.id = record.id;
+	offer.type = record.type;
+	offer.amount = record.amount;
+	offer.counter = record.id & 0xFFFF;
+	offer.timestamp = record.created;
+	offer.price = record.price;
+	offer.itemId = record.itemId;
+	offer.playerId = record.playerId;
+	offer.tier = record.tier;
+	offer.playerName = record.anonymous ? "Anonymous" : record.playerName;
 	return offer;
 }
 
 void IOMarket::createOffer(uint32_t playerId, MarketAction_t action, uint32_t itemId, uint16_t amount, uint64_t price, uint8_t tier, bool anonymous) {
+	auto &market = getInstance();
+
+	MarketOfferRecord offer;
+	offer.id = market.nextOfferId++;
+	offer.playerId = playerId;
+	offer.type = action;
+	offer.itemId = static_cast<uint16_t>(itemId);
+	offer.amount = amount;
+	offer.created = static_cast<uint32_t>(getTimeNow());
+	offer.anonymous = anonymous;
+	offer.price = price;
+	offer.tier = tier;
+	if (const auto player = g_game().getPlayerByGUID(playerId)) {
+		offer.playerName = player->getName();
+	} else {
+		offer.playerName = IOLoginData::getNameByGuid(playerId);
+	}
+
 	std::ostringstream query;
-	query << "INSERT INTO `market_offers` (`player_id`, `sale`, `itemtype`, `amount`, `created`, `anonymous`, `price`, `tier`) VALUES (" << playerId << ',' << action << ',' << itemId << ',' << amount << ',' << getTimeNow() << ',' << anonymous << ',' << price << ',' << std::to_string(tier) << ')';
-	Database::getInstance().executeQuery(query.str());
+	query << "INSERT INTO `market_offers` (`id`, `player_id`, `sale`, `itemtype`, `amount`, `created`, `anonymous`, `price`, `tier`) VALUES (" << offer.id << ',' << playerId << ',' << action << ',' << itemId << ',' << amount << ',' << offer.created << ',' << anonymous << ',' << price << ',' << std::to_string(tier) << ')';
+	enqueueMarketWrite(query.str());
+
+	market.addOffer(std::move(offer));
 }
 
 void IOMarket::acceptOffer(uint32_t offerId, uint16_t amount) {
+	auto &market = getInstance();
+	auto it = market.offers.find(offerId);
+	if (it == market.offers.end()) {
+		return;
+	}
+
+	it->second.amount -= std::min(amount, it->second.amount);
+
 	std::ostringstream query;
 	query << "UPDATE `market_offers` SET `amount` = `amount` - " << amount << " WHERE `id` = " << offerId;
-	Database::getInstance().executeQuery(query.str());
+	enqueueMarketWrite(query.str());
 }
 
 void IOMarket::deleteOffer(uint32_t offerId) {
+	getInstance().removeOffer(offerId);
+
 	std::ostringstream query;
 	query << "DELETE FROM `market_offers` WHERE `id` = " << offerId;
-	Database::getInstance().executeQuery(query.str());
+	enqueueMarketWrite(query.str());
 }
 
 void IOMarket::appendHistory(uint32_t playerId, MarketAction_t type, uint16_t itemId, uint16_t amount, uint64_t price, time_t timestamp, uint8_t tier, MarketOfferState_t state) {
@@ -274,39 +379,43 @@ void IOMarket::appendHistory(uint32_t playerId, MarketAction_t type, uint16_t it
 	query << "INSERT INTO `market_history` (`player_id`, `sale`, `itemtype`, `amount`, `price`, `expires_at`, `inserted`, `state`, `tier`) VALUES ("
 		  << playerId << ',' << type << ',' << itemId << ',' << amount << ',' << price << ','
 		  << timestamp << ',' << getTimeNow() << ',' << state << ',' << std::to_string(tier) << ')';
-	g_databaseTasks().execute(query.str());
-}
+	enqueueMarketWrite(query.str());
 
-bool IOMarket::moveOfferToHistory(uint32_t offerId, MarketOfferState_t state) {
-	Database &db = Database::getInstance();
-
-	std::ostringstream query;
-	query << "SELECT `player_id`, `sale`, `itemtype`, `amount`, `price`, `created`, `tier` FROM `market_offers` WHERE `id` = " << offerId;
+	auto &market = getInstance();
+	if (state == OFFERSTATE_ACCEPTED) {
+		market.addStatistics(type, itemId, tier, price);
+	}
 
-	DBResult_ptr result = db.storeQuery(query.str());
-	if (!result) {
-		return false;
+	if (auto it = market.histories.find(playerId); it != market.histories.end()) {
+		HistoryMarketOffer offer;
+		offer.itemId = itemId;
+		offer.amount = amount;
+		offer.price = price;
+		offer.timestamp = static_cast<uint32_t>(timestamp);
+		offer.tier = tier;
+		offer.state = state == OFFERSTATE_ACCEPTEDEX ? OFFERSTATE_ACCEPTED : state;
+		it->second[type].push_back(offer);
 	}
+}
 
-	query.str(std::string());
-	query << "DELETE FROM `market_offers` WHERE `id` = " << offerId;
-	if (!db.executeQuery(query.str())) {
+bool IOMarket::moveOfferToHistory(uint32_t offerId, MarketOfferState_t state) {
+	auto &market = getInstance();
+	auto it = market.offers.find(offerId);
+	if (it == market.offers.end()) {
 		return false;
 	}
 
-	appendHistory(
-		result->getNumber<uint32_t>("player_id"),
-		static_cast<MarketAction_t>(result->getNumber<uint16_t>("sale")),
-		result->getNumber<uint16_t>("itemtype"),
-		result->getNumber<uint16_t>("amount"),
-		result->getNumber<uint64_t>("price"),
-		getTimeNow(),
-		getTierFromDatabaseTable(result->getString("tier")), state
-	);
+	const auto offer = it->second;
+	deleteOffer(offerId);
+
+	appendHistory(offer.playerId, offer.type, offer.itemId, offer.amount, offer.price, getTimeNow(), offer.tier, state);
 	return true;
 }
 
 void IOMarket::updateStatistics() {
+	purchaseStatistics.clear();
+	saleStatistics.clear();
+
 	std::ostringstream query;
 	query << "SELECT `sale` AS `sale`, `itemtype` AS `itemtype`, COUNT(`price`) AS `num`, MIN(`price`) AS `min`, MAX(`price`) AS `max`, SUM(`price`) AS `sum`, `tier` AS `tier` FROM `market_history` WHERE `state` = " << OFFERSTATE_ACCEPTED << " GROUP BY `itemtype`, `sale`, `tier`";
 	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
@@ -330,3 +439,22 @@ void IOMarket::updateStatistics() {
 		statistics->highestPrice = result->getNumber<uint64_t>("max");
 	} while (result->next());
 }
+
+void IOMarket::addStatistics(MarketAction_t action, uint16_t itemId, uint8_t tier, uint64_t price) {
+	auto &statistics = action == MARKETACTION_BUY ? purchaseStatistics[itemId][tier] : saleStatistics[itemId][tier];
+	statistics.lowestPrice = statistics.numTransactions == 0 ? price : std::min(statistics.lowestPrice, price);
+	statistics.highestPrice = std::max(statistics.highestPrice, price);
+	statistics.totalPrice += price;
+	++statistics.numTransactions;
+}
+
+MarketStatistics IOMarket::getStatistics(MarketAction_t action, uint16_t itemId, uint8_t tier) const {
+	const auto &statistics = action == MARKETACTION_BUY ? purchaseStatistics : saleStatistics;
+	auto itemIt = statistics.find(itemId);
+	if (itemIt == statistics.end()) {
+		return {};
+	}
+
+	auto tierIt = itemIt->second.find(tier);
+	return tierIt != itemIt->second.end() ? tierIt->second : MarketStatistics {};
+}
@@ -13,21 +13,49 @@
 #include "declarations.hpp"
 #include "lib/di/container.hpp"
 
+struct MarketOfferRecord {
+	uint32_t id = 0;
+	uint32_t playerId = 0;
+	uint32_t created = 0;
+	uint64_t price = 0;
+	uint16_t amount = 0;
+	uint16_t itemId = 0;
+	MarketAction_t type = MARKETACTION_BUY;
+	uint8_t tier = 0;
+	bool anonymous = false;
+	std::string playerName;
+};
+
+/**
+ * The market offers live in memory, loaded once at startup, so browsing
+ * never touches the database. Each (item id, tier, side) keeps its offers
+ * sorted by price, and every change is written through to market_offers
+ * on the database pool, ordered by offer id. Offer ids are handed out
+ * here, so the server must be the only writer of that table.
+ *
+ * History is cached per player the first time it is browsed and the
+ * statistics are updated as offers are accepted. Game thread only.
+ */
 class IOMarket {
 	using StatisticsMap = std::map<uint16_t, std::map<uint8_t, MarketStatistics>>;
 
 public:
 	IOMarket() = default;
 
+	// Ensures that we don't accidentally copy it
+	IOMarket(const IOMarket &) = delete;
+	IOMarket operator=(const IOMarket &) = delete;
+
 	static IOMarket &getInstance() {
 		return inject<IOMarket>();
 	}
 
+	bool loadOffers();
+
 	static MarketOfferList getActiveOffers(MarketAction_t action, uint16_t itemId, uint8_t tier);
 	static MarketOfferList getOwnOffers(MarketAction_t action, uint32_t playerId);
 	static HistoryMarketOfferList getOwnHistory(MarketAction_t action, uint32_t playerId);
 
-	static void processExpiredOffers(DBResult_ptr result, bool);
 	static void checkExpiredOffers();
 
 	static uint32_t getPlayerOfferCount(uint32_t playerId);
@@ -40,18 +68,43 @@ public:
 	static void appendHistory(uint32_t playerId, MarketAction_t type, uint16_t itemId, uint16_t amount, uint64_t price, time_t timestamp, uint8_t tier, MarketOfferState_t state);
 	static bool moveOfferToHistory(uint32_t offerId, MarketOfferState_t state);
 
+	// Loads the statistics from the history, they are kept up to date from then on
 	void updateStatistics();
 
-	StatisticsMap getPurchaseStatistics() const {
-		return purchaseStatistics;
-	}
-	StatisticsMap getSaleStatistics() const {
-		return saleStatistics;
+	MarketStatistics getStatistics(MarketAction_t action, uint16_t itemId, uint8_t tier) const;
+
+	const phmap::flat_hash_map<uint32_t, MarketOfferRecord> &getOffers() const {
+		return offers;
 	}
 
 	static uint8_t getTierFromDatabaseTable(const std::string &string);
 
 private:
+	// Price sorted offers of one (item id, tier, side), ties in creation order
+	using OrderBookSide = std::vector<std::pair<uint64_t, uint32_t>>;
+
+	static uint32_t getBookKey(uint16_t itemId, uint8_t tier, MarketAction_t action) {
+		return (static_cast<uint32_t>(itemId) << 16) | (static_cast<uint32_t>(tier) << 8) | static_cast<uint32_t>(action);
+	}
+	static uint64_t getCounterKey(uint32_t created, uint16_t counter) {
+		return (static_cast<uint64_t>(created) << 16) | counter;
+	}
+
+	void addOffer(MarketOfferRecord &&offer);
+	void removeOffer(uint32_t offerId);
+	void addStatistics(MarketAction_t action, uint16_t itemId, uint8_t tier, uint64_t price);
+	static void deliverExpiredOffer(const MarketOfferRecord &offer);
+
+	phmap::flat_hash_map<uint32_t, MarketOfferRecord> offers;
+	phmap::flat_hash_map<uint32_t, OrderBookSide> orderBook;
+	phmap::flat_hash_map<uint32_t, std::vector<uint32_t>> playerOffers;
+	// (created, id & 0xFFFF) the client identifies offers by, to offer id
+	phmap::flat_hash_map<uint64_t, uint32_t> offersByCounter;
+	uint32_t nextOfferId = 1;
+
+	// [player id, history of each side], loaded on first browse
+	phmap::flat_hash_map<uint32_t, std::array<HistoryMarketOfferList, 2>> histories;
+
 	// [uint16_t = item id, [uint8_t = item tier, MarketStatistics = structure of the statistics]]
 	StatisticsMap purchaseStatistics;
 	StatisticsMap saleStatistics;
@@ -53,79 +53,14 @@ void PreySlot::reloadBonusValue() {
 	}
 }
 
-void PreySlot::reloadMonsterGrid(std::vector<uint16_t> blackList, uint32_t level) {
+void PreySlot::reloadMonsterGrid(const std::vector<uint16_t> &blackList, uint32_t level) {
 	raceIdList.clear();
 
 	if (!g_configManager().getBoolean(PREY_ENABLED)) {
 		return;
 	}
 
-	// Disabling prey system if the server have less then 36 registered monsters on bestiary because:
-	// - Impossible to generate random lists without duplications on slots.
-	// - Stress the server with unnecessary loops.
-	std::map<uint16_t, std::string> bestiary = g_game().getBestiaryList();
-	if (bestiary.size() < 36) {
-		return;
-	}
-
-	uint8_t stageOne;
-	uint8_t stageTwo;
-	uint8_t stageThree;
-	uint8_t stageFour;
-	if (auto levelStage = static_cast<uint32_t>(std::floor(level / 100));
-		levelStage == 0) { // From level 0 to 99
-		stageOne = 3;
-		stageTwo = 3;
-		stageThree = 2;
-		stageFour = 1;
-	} else if (levelStage <= 2) { // From level 100 to 299
-		stageOne = 1;
-		stageTwo = 3;
-		stageThree = 3;
-		stageFour = 2;
-	} else if (levelStage <= 4) { // From level 300 to 499
-		stageOne = 1;
-		stageTwo = 2;
-		stageThree = 3;
-		stageFour = 3;
-	} else { // From level 500 to ...
-		stageOne = 1;
-		stageTwo = 1;
-		stageThree = 3;
-		stageFour = 4;
-	}
-
-	uint8_t tries = 0;
-	auto maxIndex = static_cast<int32_t>(bestiary.size() - 1);
-	while (raceIdList.size() < 9) {
-		uint16_t raceId = (*(std::next(bestiary.begin(), uniform_random(0, maxIndex)))).first;
-		tries++;
-
-		if (std::count(blackList.begin(), blackList.end(), raceId) != 0) {
-			continue;
-		}
-
-		blackList.push_back(raceId);
-		const auto mtype = g_monsters().getMonsterTypeByRaceId(raceId);
-		if (!mtype || mtype->info.experience == 0) {
-			continue;
-		} else if (stageOne != 0 && mtype->info.bestiaryStars <= 1) {
-			raceIdList.push_back(raceId);
-			--stageOne;
-		} else if (stageTwo != 0 && mtype->info.bestiaryStars == 2) {
-			raceIdList.push_back(raceId);
-			--stageTwo;
-		} else if (stageThree != 0 && mtype->info.bestiaryStars == 3) {
-			raceIdList.push_back(raceId);
-			--stageThree;
-		} else if (stageFour != 0 && mtype->info.bestiaryStars >= 4) {
-			raceIdList.push_back(raceId);
-			--stageFour;
-		} else if (tries >= 10) {
-			raceIdList.push_back(raceId);
-			tries = 0;
-		}
-	}
+	raceIdList = g_ioprey().getRandomMonsterGrid(blackList, level);
 }
 
 // Task hunting class
@@ -134,79 +69,14 @@ TaskHuntingSlot::TaskHuntingSlot(PreySlot_t id) :
 	freeRerollTimeStamp = OTSYS_TIME() + g_configManager().getNumber(TASK_HUNTING_FREE_REROLL_TIME) * 1000;
 }
 
-void TaskHuntingSlot::reloadMonsterGrid(std::vector<uint16_t> blackList, uint32_t level) {
+void TaskHuntingSlot::reloadMonsterGrid(const std::vector<uint16_t> &blackList, uint32_t level) {
 	raceIdList.clear();
 
 	if (!g_configManager().getBoolean(TASK_HUNTING_ENABLED)) {
 		return;
 	}
 
-	// Disabling task hunting system if the server have less then 36 registered monsters on bestiary because:
-	// - Impossible to generate random lists without duplications on slots.
-	// - Stress the server with unnecessary loops.
-	std::map<uint16_t, std::string> bestiary = g_game().getBestiaryList();
-	if (bestiary.size() < 36) {
-		return;
-	}
-
-	uint8_t stageOne;
-	uint8_t stageTwo;
-	uint8_t stageThree;
-	uint8_t stageFour;
-	if (auto levelStage = static_cast<uint32_t>(std::floor(level / 100));
-		levelStage == 0) { // From level 0 to 99
-		stageOne = 3;
-		stageTwo = 3;
-		stageThree = 2;
-		stageFour = 1;
-	} else if (levelStage <= 2) { // From level 100 to 299
-		stageOne = 1;
-		stageTwo = 3;
-		stageThree = 3;
-		stageFour = 2;
-	} else if (levelStage <= 4) { // From level 300 to 499
-		stageOne = 1;
-		stageTwo = 2;
-		stageThree = 3;
-		stageFour = 3;
-	} else { // From level 500 to ...
-		stageOne = 1;
-		stageTwo = 1;
-		stageThree = 3;
-		stageFour = 4;
-	}
-
-	uint8_t tries = 0;
-	auto maxIndex = static_cast<int32_t>(bestiary.size() - 1);
-	while (raceIdList.size() < 9) {
-		uint16_t raceId = (*(std::next(bestiary.begin(), uniform_random(0, maxIndex)))).first;
-		tries++;
-
-		if (std::count(blackList.begin(), blackList.end(), raceId) != 0) {
-			continue;
-		}
-
-		blackList.push_back(raceId);
-		const auto mtype = g_monsters().getMonsterTypeByRaceId(raceId);
-		if (!mtype || mtype->info.experience == 0) {
-			continue;
-		} else if (stageOne != 0 && mtype->info.bestiaryStars <= 1) {
-			raceIdList.push_back(raceId);
-			--stageOne;
-		} else if (stageTwo != 0 && mtype->info.bestiaryStars == 2) {
-			raceIdList.push_back(raceId);
-			--stageTwo;
-		} else if (stageThree != 0 && mtype->info.bestiaryStars == 3) {
-			raceIdList.push_back(raceId);
-			--stageThree;
-		} else if (stageFour != 0 && mtype->info.bestiaryStars >= 4) {
-			raceIdList.push_back(raceId);
-			--stageFour;
-		} else if (tries >= 10) {
-			raceIdList.push_back(raceId);
-			tries = 0;
-		}
-	}
+	raceIdList = g_ioprey().getRandomMonsterGrid(blackList, level);
 }
 
 void TaskHuntingSlot::reloadReward() {
@@ -522,6 +392,66 @@ void IOPrey::parseTaskHuntingAction(std::shared_ptr<Player> player, PreySlot_t s
 	player->reloadTaskSlot(slotId);
 }
 
+void IOPrey::initializeMonsterPools() {
+	for (auto &pool : monsterPools) {
+		pool.clear();
+	}
+	allMonsters.clear();
+
+	for (const auto &[raceId, name] : g_game().getBestiaryList()) {
+		const auto mtype = g_monsters().getMonsterType(name);
+		if (!mtype || mtype->info.experience == 0) {
+			continue;
+		}
+
+		const uint32_t stars = mtype->info.bestiaryStars;
+		monsterPools[stars <= 1 ? 0 : std::min<uint32_t>(stars, 4) - 1].push_back(raceId);
+		allMonsters.push_back(raceId);
+	}
+}
+
+std::vector<uint16_t> IOPrey::getRandomMonsterGrid(const std::vector<uint16_t> &blackList, uint32_t level) const {
+	std::vector<uint16_t> raceIdList;
+
+	// Disabling prey and task hunting if the server have less then 36 registered monsters on bestiary because:
+	// - Impossible to generate random lists without duplications on slots.
+	// - Stress the server with unnecessary loops.
+	if (g_game().getBestiaryList().size() < 36) {
+		return raceIdList;
+	}
+
+	// Monsters wanted from each pool
+	std::array<uint8_t, 4> stages;
+	if (auto levelStage = level / 100; levelStage == 0) { // From level 0 to 99
+		stages = { 3, 3, 2, 1 };
+	} else if (levelStage <= 2) { // From level 100 to 299
+		stages = { 1, 3, 3, 2 };
+	} else if (levelStage <= 4) { // From level 300 to 499
+		stages = { 1, 2, 3, 3 };
+	} else { // From level 500 to ...
+		stages = { 1, 1, 3, 4 };
+	}
+
+	raceIdList.reserve(9);
+	const auto pick = [&blackList, &raceIdList](const std::vector<uint16_t> &pool, size_t amount) {
+		// Twice the pool size in draws is plenty to get past the black listed and already picked ones
+		for (size_t draws = 0; amount > 0 && draws < pool.size() * 2; ++draws) {
+			const uint16_t raceId = pool[uniform_random(0, static_cast<int32_t>(pool.size() - 1))];
+			if (std::ranges::find(blackList, raceId) == blackList.end() && std::ranges::find(raceIdList, raceId) == raceIdList.end()) {
+				raceIdList.push_back(raceId);
+				--amount;
+			}
+		}
+	};
+
+	for (size_t pool = 0; pool < monsterPools.size(); ++pool) {
+		pick(monsterPools[pool], stages[pool]);
+	}
+	// Pools without enough monsters are completed from any of them
+	pick(allMonsters, 9 - raceIdList.size());
+	return raceIdList;
+}
+
 void IOPrey::initializeTaskHuntOptions() {
 	if (!g_configManager().getBoolean(TASK_HUNTING_ENABLED)) {
 		return;
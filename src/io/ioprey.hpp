@@ -127,7 +127,7 @@ public:
 
 	void reloadBonusType();
 	void reloadBonusValue();
-	void reloadMonsterGrid(std::vector<uint16_t> blackList, uint32_t level);
+	void reloadMonsterGrid(const std::vector<uint16_t> &blackList, uint32_t level);
 
 	PreySlot_t id = PreySlot_First;
 	PreyBonus_t bonus = PreyBonus_None;
@@ -180,7 +180,7 @@ public:
 	}
 
 	void reloadReward();
-	void reloadMonsterGrid(std::vector<uint16_t> blackList, uint32_t level);
+	void reloadMonsterGrid(const std::vector<uint16_t> &blackList, uint32_t level);
 
 	PreySlot_t id = PreySlot_First;
 	PreyTaskDataState_t state = PreyTaskDataState_Inactive;
@@ -231,6 +231,10 @@ public:
 	void parseTaskHuntingAction(std::shared_ptr<Player> player, PreySlot_t slotId, PreyTaskAction_t action, bool upgrade, uint16_t raceId) const;
 
 	void initializeTaskHuntOptions();
+	// Indexes the bestiary by stars, must run again whenever the monsters are reloaded
+	void initializeMonsterPools();
+	// Nine random race ids, none of them black listed, spread over the stars by the player level
+	std::vector<uint16_t> getRandomMonsterGrid(const std::vector<uint16_t> &blackList, uint32_t level) const;
 	const std::unique_ptr<TaskHuntingOption> &getTaskRewardOption(const std::unique_ptr<TaskHuntingSlot> &slot) const;
 
 	NetworkMessage getTaskHuntingBaseDate() const {
@@ -239,6 +243,11 @@ public:
 
 	NetworkMessage baseDataMessage;
 	std::vector<std::unique_ptr<TaskHuntingOption>> taskOption;
+
+private:
+	// Race ids of the monsters giving experience, by bestiary stars: up to one, two, three and four or more
+	std::array<std::vector<uint16_t>, 4> monsterPools;
+	std::vector<uint16_t> allMonsters;
 };
 
 constexpr auto g_ioprey = IOPrey::getInstance;
@@ -0,0 +1,514 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "io/mapsnapshot.hpp"
+
+#include "io/io_definitions.hpp"
+#include "items/item.hpp"
+#include "map/map.hpp"
+#include "utils/hash.hpp"
+
+namespace {
+	constexpr std::array<char, 8> SNAPSHOT_MAGIC = { 'C', 'N', 'R', 'Y', 'M', 'A', 'P', '1' };
+	// Bumped whenever a record below changes
+	constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+	struct Section {
+		uint64_t offset;
+		uint64_t count;
+	};
+
+	struct StringRef {
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	struct SnapshotHeader {
+		std::array<char, 8> magic;
+		uint32_t version;
+		uint32_t width;
+		uint32_t height;
+		uint16_t posX, posY;
+		uint8_t posZ;
+		uint64_t itemTypesHash;
+		uint64_t sourceSize;
+		int64_t sourceMtime;
+		uint64_t sourceHash;
+		Section attributes, items, itemChildren, tiles, tileItems, placements, houses, towns, waypoints, strings;
+	};
+
+	struct SnapshotAttribute {
+		uint8_t attribute;
+		StringRef value;
+	};
+
+	// Children are stored before their container, so an item only refers to lower indexes
+	struct SnapshotItem {
+		StringRef text;
+		uint32_t firstChild, childCount;
+		uint16_t id, charges, actionId, uniqueId, destX, destY, doorOrDepotId;
+		uint8_t destZ;
+	};
+
+	struct SnapshotTile {
+		// Index + 1 in the items section, 0 without ground
+		uint32_t ground;
+		uint32_t firstItem, itemCount;
+		uint32_t flags, houseId;
+		uint8_t type;
+		uint8_t isStatic;
+	};
+
+	struct SnapshotPlacement {
+		uint32_t tile;
+		uint16_t x, y;
+		uint8_t z;
+	};
+
+	struct SnapshotTown {
+		uint32_t id;
+		StringRef name;
+		uint16_t x, y;
+		uint8_t z;
+	};
+
+	struct SnapshotWaypoint {
+		StringRef name;
+		uint16_t x, y;
+		uint8_t z;
+	};
+
+	// The loader files items as ground, moveable or bed, a snapshot is stale once any of those changes
+	uint64_t hashItemTypes() {
+		std::string flags(Item::items.size(), '\0');
+		for (size_t id = 0; id < flags.size(); ++id) {
+			const auto &itemType = Item::items[id];
+			flags[id] = static_cast<char>(itemType.isGroundTile() | (itemType.moveable << 1) | (itemType.isBed() << 2));
+		}
+		return stdext::hash_bytes(flags);
+	}
+
+	class SnapshotWriter {
+	public:
+		SnapshotWriter() {
+			buffer.resize(sizeof(SnapshotHeader));
+		}
+
+		template <typename T>
+		Section append(const std::vector<T> &records) {
+			buffer.resize((buffer.size() + 7) & ~size_t { 7 });
+			const Section section { buffer.size(), records.size() };
+			const auto bytes = reinterpret_cast<const char*>(records.data());
+			buffer.append(bytes, records.size() * sizeof(T));
+			return section;
+		}
+
+		StringRef addString(std::string_view value) {
+			const StringRef ref { static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size()) };
+			strings.append(value);
+			return ref;
+		}
+
+		Section appendStrings() {
+			buffer.resize((buffer.size() + 7) & ~size_t { 7 });
+			const Section section { buffer.size(), strings.size() };
+			buffer.append(strings);
+			return section;
+		}
+
+		std::string finish(const SnapshotHeader &header) {
+			std::memcpy(buffer.data(), &header, sizeof(header));
+			return std::move(buffer);
+		}
+
+	private:
+		std::string buffer;
+		std::string strings;
+	};
+
+	class SnapshotReader {
+	public:
+		explicit SnapshotReader(std::string_view bytes) :
+			bytes(bytes) { }
+
+		// Copied out, the mapping gives no alignment guarantee past the page
+		template <typename T>
+		bool read(const Section &section, std::vector<T> &records) const {
+			if (section.offset > bytes.size() || section.count > (bytes.size() - section.offset) / sizeof(T)) {
+				return false;
+			}
+
+			records.resize(section.count);
+			std::memcpy(records.data(), bytes.data() + section.offset, section.count * sizeof(T));
+			return true;
+		}
+
+		bool setStrings(const Section &section) {
+			if (section.offset > bytes.size() || section.count > bytes.size() - section.offset) {
+				return false;
+			}
+
+			strings = bytes.substr(section.offset, section.count);
+			return true;
+		}
+
+		bool getString(const StringRef &ref, std::string &value) const {
+			if (ref.offset > strings.size() || ref.size > strings.size() - ref.offset) {
+				return false;
+			}
+
+			value.assign(strings.substr(ref.offset, ref.size));
+			return true;
+		}
+
+	private:
+		std::string_view bytes;
+		std::string_view strings;
+	};
+}
+
+MapSnapshot::MapSnapshot(const std::filesystem::path &source, const Position &pos) :
+	pos(pos) {
+	std::error_code error;
+	sourceSize = std::filesystem::file_size(source, error);
+	sourceMtime = static_cast<int64_t>(std::filesystem::last_write_time(source, error).time_since_epoch().count());
+
+	const auto key = fmt::format("{}:{}:{}:{}", std::filesystem::absolute(source, error).generic_string(), pos.x, pos.y, pos.z);
+	snapshotFile = std::filesystem::current_path() / CACHE_DIRECTORY / fmt::format("{}_{:016x}.bin", source.stem().string(), stdext::hash_bytes(key));
+}
+
+void MapSnapshot::addAttribute(uint8_t attribute, const std::string &value) {
+	attributes.emplace_back(attribute, value);
+}
+
+void MapSnapshot::addTile(uint16_t x, uint16_t y, uint8_t z, uint32_t cacheIndex) {
+	if (cacheIndex != 0) {
+		tiles.emplace_back(x, y, z, cacheIndex);
+	}
+}
+
+void MapSnapshot::addHouse(uint32_t houseId) {
+	if (houseIds.emplace(houseId).second) {
+		houses.emplace_back(houseId);
+	}
+}
+
+void MapSnapshot::addTown(uint32_t townId, const std::string &name, const Position &templePos) {
+	towns.emplace_back(townId, name, templePos);
+}
+
+void MapSnapshot::addWaypoint(const std::string &name, const Position &waypointPos) {
+	waypoints.emplace_back(name, waypointPos);
+}
+
+bool MapSnapshot::load(Map &map, std::string_view source) const {
+	std::error_code error;
+	if (!std::filesystem::exists(snapshotFile, error)) {
+		return false;
+	}
+
+	mio::mmap_source mapping;
+	mapping.map(snapshotFile.string(), error);
+	if (error || mapping.size() < sizeof(SnapshotHeader)) {
+		return false;
+	}
+
+	SnapshotHeader header {};
+	std::memcpy(&header, mapping.data(), sizeof(header));
+	if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION) {
+		return false;
+	}
+
+	if (header.posX != pos.x || header.posY != pos.y || header.posZ != pos.z || header.itemTypesHash != hashItemTypes()) {
+		return false;
+	}
+
+	// A checkout may touch the file without changing it, the content hash still matches then
+	if ((header.sourceSize != sourceSize || header.sourceMtime != sourceMtime) && (header.sourceSize != source.size() || header.sourceHash != stdext::hash_bytes(source))) {
+		return false;
+	}
+
+	SnapshotReader reader({ mapping.data(), mapping.size() });
+	std::vector<SnapshotAttribute> attributeRecords;
+	std::vector<SnapshotItem> itemRecords;
+	std::vector<uint32_t> itemChildren;
+	std::vector<SnapshotTile> tileRecords;
+	std::vector<uint32_t> tileItems;
+	std::vector<SnapshotPlacement> placements;
+	std::vector<uint32_t> houseRecords;
+	std::vector<SnapshotTown> townRecords;
+	std::vector<SnapshotWaypoint> waypointRecords;
+	if (!reader.setStrings(header.strings) || !reader.read(header.attributes, attributeRecords) || !reader.read(header.items, itemRecords) || !reader.read(header.itemChildren, itemChildren) || !reader.read(header.tiles, tileRecords) || !reader.read(header.tileItems, tileItems) || !reader.read(header.placements, placements) || !reader.read(header.houses, houseRecords) || !reader.read(header.towns, townRecords) || !reader.read(header.waypoints, waypointRecords)) {
+		g_logger().warn("[MapSnapshot::load] - Snapshot {} is truncated, the map is parsed again", snapshotFile.filename().string());
+		return false;
+	}
+
+	// Everything is rebuilt and checked before the map is touched
+	const auto corrupted = [this] {
+		g_logger().warn("[MapSnapshot::load] - Snapshot {} is corrupted, the map is parsed again", snapshotFile.filename().string());
+		return false;
+	};
+
+	std::vector<std::shared_ptr<BasicItem>> items;
+	items.reserve(itemRecords.size());
+	for (const auto &record : itemRecords) {
+		if (record.firstChild > itemChildren.size() || record.childCount > itemChildren.size() - record.firstChild) {
+			return corrupted();
+		}
+
+		const auto item = std::make_shared<BasicItem>();
+		if (!reader.getString(record.text, item->text)) {
+			return corrupted();
+		}
+
+		item->id = record.id;
+		item->charges = record.charges;
+		item->actionId = record.actionId;
+		item->uniqueId = record.uniqueId;
+		item->destX = record.destX;
+		item->destY = record.destY;
+		item->destZ = record.destZ;
+		item->doorOrDepotId = record.doorOrDepotId;
+
+		item->items.reserve(record.childCount);
+		for (uint32_t i = 0; i < record.childCount; ++i) {
+			const uint32_t child = itemChildren[record.firstChild + i];
+			if (child >= items.size()) {
+				return corrupted();
+			}
+			item->items.emplace_back(items[child]);
+		}
+		items.emplace_back(item);
+	}
+
+	std::vector<std::shared_ptr<BasicTile>> basicTiles;
+	basicTiles.reserve(tileRecords.size());
+	for (const auto &record : tileRecords) {
+		if (record.ground > items.size() || record.firstItem > tileItems.size() || record.itemCount > tileItems.size() - record.firstItem) {
+			return corrupted();
+		}
+
+		const auto tile = std::make_shared<BasicTile>();
+		tile->ground = record.ground != 0 ? items[record.ground - 1] : nullptr;
+		tile->flags = record.flags;
+		tile->houseId = record.houseId;
+		tile->type = record.type;
+		tile->isStatic = record.isStatic != 0;
+
+		tile->items.reserve(record.itemCount);
+		for (uint32_t i = 0; i < record.itemCount; ++i) {
+			const uint32_t item = tileItems[record.firstItem + i];
+			if (item >= items.size()) {
+				return corrupted();
+			}
+			tile->items.emplace_back(items[item]);
+		}
+		basicTiles.emplace_back(tile);
+	}
+
+	if (std::ranges::any_of(placements, [&basicTiles](const auto &placement) { return placement.tile >= basicTiles.size(); })) {
+		return corrupted();
+	}
+
+	std::vector<std::pair<uint8_t, std::string>> attributeValues(attributeRecords.size());
+	for (size_t i = 0; i < attributeRecords.size(); ++i) {
+		attributeValues[i].first = attributeRecords[i].attribute;
+		if (!reader.getString(attributeRecords[i].value, attributeValues[i].second)) {
+			return corrupted();
+		}
+	}
+
+	std::vector<std::string> townNames(townRecords.size());
+	for (size_t i = 0; i < townRecords.size(); ++i) {
+		if (!reader.getString(townRecords[i].name, townNames[i])) {
+			return corrupted();
+		}
+	}
+
+	std::vector<std::string> waypointNames(waypointRecords.size());
+	for (size_t i = 0; i < waypointRecords.size(); ++i) {
+		if (!reader.getString(waypointRecords[i].name, waypointNames[i])) {
+			return corrupted();
+		}
+	}
+
+	map.width = header.width;
+	map.height = header.height;
+
+	for (const auto &[attribute, value] : attributeValues) {
+		switch (attribute) {
+			case OTBM_ATTR_EXT_SPAWN_MONSTER_FILE:
+				map.monsterfile = value;
+				break;
+			case OTBM_ATTR_EXT_SPAWN_NPC_FILE:
+				map.npcfile = value;
+				break;
+			case OTBM_ATTR_EXT_HOUSE_FILE:
+				map.housefile = value;
+				break;
+			default:
+				break;
+		}
+	}
+
+	for (const uint32_t houseId : houseRecords) {
+		map.houses.addHouse(houseId);
+	}
+
+	for (const auto &placement : placements) {
+		map.setBasicTile(placement.x, placement.y, placement.z, basicTiles[placement.tile]);
+	}
+
+	for (size_t i = 0; i < townRecords.size(); ++i) {
+		const auto &record = townRecords[i];
+		const auto town = map.towns.getOrCreateTown(record.id);
+		town->setName(townNames[i]);
+		town->setTemplePos(Position(record.x, record.y, record.z));
+	}
+
+	for (size_t i = 0; i < waypointRecords.size(); ++i) {
+		const auto &record = waypointRecords[i];
+		map.waypoints[waypointNames[i]] = Position(record.x, record.y, record.z);
+	}
+
+	return true;
+}
+
+void MapSnapshot::store(const Map &map, std::string_view source) const {
+	SnapshotWriter writer;
+
+	std::vector<SnapshotAttribute> attributeRecords;
+	attributeRecords.reserve(attributes.size());
+	for (const auto &[attribute, value] : attributes) {
+		attributeRecords.emplace_back(attribute, writer.addString(value));
+	}
+
+	std::vector<SnapshotItem> itemRecords;
+	std::vector<uint32_t> itemChildren;
+	phmap::flat_hash_map<const BasicItem*, uint32_t> itemIndexes;
+	const std::function<uint32_t(const BasicItem &)> addItem = [&](const BasicItem &item) -> uint32_t {
+		if (const auto it = itemIndexes.find(&item); it != itemIndexes.end()) {
+			return it->second;
+		}
+
+		std::vector<uint32_t> children;
+		children.reserve(item.items.size());
+		for (const auto &child : item.items) {
+			children.emplace_back(addItem(*child));
+		}
+
+		SnapshotItem record {};
+		record.text = writer.addString(item.text);
+		record.firstChild = static_cast<uint32_t>(itemChildren.size());
+		record.childCount = static_cast<uint32_t>(children.size());
+		record.id = item.id;
+		record.charges = item.charges;
+		record.actionId = item.actionId;
+		record.uniqueId = item.uniqueId;
+		record.destX = item.destX;
+		record.destY = item.destY;
+		record.destZ = item.destZ;
+		record.doorOrDepotId = item.doorOrDepotId;
+		itemChildren.insert(itemChildren.end(), children.begin(), children.end());
+
+		const auto index = static_cast<uint32_t>(itemRecords.size());
+		itemRecords.emplace_back(record);
+		itemIndexes.emplace(&item, index);
+		return index;
+	};
+
+	std::vector<SnapshotTile> tileRecords;
+	std::vector<uint32_t> tileItems;
+	std::vector<SnapshotPlacement> placements;
+	phmap::flat_hash_map<uint32_t, uint32_t> tileIndexes;
+	placements.reserve(tiles.size());
+	for (const auto &[x, y, z, cacheIndex] : tiles) {
+		auto [it, inserted] = tileIndexes.try_emplace(cacheIndex, static_cast<uint32_t>(tileRecords.size()));
+		if (inserted) {
+			const auto &tile = MapCache::getCachedTile(cacheIndex);
+			SnapshotTile record {};
+			record.ground = tile.ground ? addItem(*tile.ground) + 1 : 0;
+			record.firstItem = static_cast<uint32_t>(tileItems.size());
+			record.itemCount = static_cast<uint32_t>(tile.items.size());
+			record.flags = tile.flags;
+			record.houseId = tile.houseId;
+			record.type = tile.type;
+			record.isStatic = tile.isStatic ? 1 : 0;
+			for (const auto &item : tile.items) {
+				tileItems.emplace_back(addItem(*item));
+			}
+			tileRecords.emplace_back(record);
+		}
+		placements.emplace_back(it->second, x, y, z);
+	}
+
+	std::vector<SnapshotTown> townRecords;
+	townRecords.reserve(towns.size());
+	for (const auto &[id, name, templePos] : towns) {
+		townRecords.emplace_back(id, writer.addString(name), templePos.x, templePos.y, templePos.z);
+	}
+
+	std::vector<SnapshotWaypoint> waypointRecords;
+	waypointRecords.reserve(waypoints.size());
+	for (const auto &[name, waypointPos] : waypoints) {
+		waypointRecords.emplace_back(writer.addString(name), waypointPos.x, waypointPos.y, waypointPos.z);
+	}
+
+	SnapshotHeader header {};
+	header.magic = SNAPSHOT_MAGIC;
+	header.version = SNAPSHOT_VERSION;
+	header.width = map.width;
+	header.height = map.height;
+	header.posX = pos.x;
+	header.posY = pos.y;
+	header.posZ = pos.z;
+	header.itemTypesHash = hashItemTypes();
+	header.sourceSize = sourceSize;
+	header.sourceMtime = sourceMtime;
+	header.sourceHash = stdext::hash_bytes(source);
+	header.attributes = writer.append(attributeRecords);
+	header.items = writer.append(itemRecords);
+	header.itemChildren = writer.append(itemChildren);
+	header.tiles = writer.append(tileRecords);
+	header.tileItems = writer.append(tileItems);
+	header.placements = writer.append(placements);
+	header.houses = writer.append(houses);
+	header.towns = writer.append(townRecords);
+	header.waypoints = writer.append(waypointRecords);
+	header.strings = writer.appendStrings();
+	const auto content = writer.finish(header);
+
+	std::error_code error;
+	std::filesystem::create_directories(snapshotFile.parent_path(), error);
+
+	// Written aside and renamed, a crash never leaves a truncated snapshot behind
+	auto temporaryFile = snapshotFile;
+	temporaryFile += ".tmp";
+	{
+		std::ofstream stream(temporaryFile, std::ios::binary | std::ios::trunc);
+		if (!stream) {
+			g_logger().warn("[MapSnapshot::store] - Could not write {}", temporaryFile.string());
+			return;
+		}
+		stream.write(content.data(), static_cast<std::streamsize>(content.size()));
+		if (!stream) {
+			g_logger().warn("[MapSnapshot::store] - Could not write {}", temporaryFile.string());
+			return;
+		}
+	}
+	std::filesystem::rename(temporaryFile, snapshotFile, error);
+	if (error) {
+		g_logger().warn("[MapSnapshot::store] - Could not write {}: {}", snapshotFile.string(), error.message());
+		return;
+	}
+
+	g_logger().info("Map snapshot {} written, {} tiles and {} items", snapshotFile.filename().string(), tileRecords.size(), itemRecords.size());
+}
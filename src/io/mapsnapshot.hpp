@@ -0,0 +1,78 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/movement/position.hpp"
+
+class Map;
+
+/**
+ * Binary image of what loading an .otbm leaves in the map: the unique
+ * tiles and items of the tile cache, where each tile goes, the houses,
+ * towns and waypoints. Records are flat and refer to each other by index,
+ * sections by their offset in the file, so a snapshot is mapped and copied
+ * into the tile cache without any parsing.
+ *
+ * With mapSnapshot one is kept under cache/map per map file and offset.
+ * It is only used while the .otbm (mtime and size, or content hash), the
+ * item types the loader looks at and the format version are the ones it
+ * was built from; otherwise the .otbm is parsed and the snapshot rebuilt
+ * from what the parse recorded.
+ */
+class MapSnapshot {
+public:
+	static constexpr std::string_view CACHE_DIRECTORY = "cache/map";
+
+	MapSnapshot(const std::filesystem::path &source, const Position &pos);
+
+	// Ensures that we don't accidentally copy it
+	MapSnapshot(const MapSnapshot &) = delete;
+	MapSnapshot operator=(const MapSnapshot &) = delete;
+
+	/**
+	 * Fills the map from the snapshot when there is one built from the
+	 * given source bytes. The map is left untouched otherwise.
+	 */
+	bool load(Map &map, std::string_view source) const;
+
+	// Writes what was recorded while the source was parsed
+	void store(const Map &map, std::string_view source) const;
+
+	void addAttribute(uint8_t attribute, const std::string &value);
+	void addTile(uint16_t x, uint16_t y, uint8_t z, uint32_t cacheIndex);
+	void addHouse(uint32_t houseId);
+	void addTown(uint32_t townId, const std::string &name, const Position &templePos);
+	void addWaypoint(const std::string &name, const Position &waypointPos);
+
+private:
+	struct RecordedTile {
+		uint16_t x, y;
+		uint8_t z;
+		uint32_t cacheIndex;
+	};
+
+	struct RecordedTown {
+		uint32_t id;
+		std::string name;
+		Position templePos;
+	};
+
+	std::filesystem::path snapshotFile;
+	Position pos;
+	uint64_t sourceSize = 0;
+	int64_t sourceMtime = 0;
+
+	std::vector<std::pair<uint8_t, std::string>> attributes;
+	std::vector<RecordedTile> tiles;
+	std::vector<uint32_t> houses;
+	phmap::flat_hash_set<uint32_t> houseIds;
+	std::vector<RecordedTown> towns;
+	std::vector<std::pair<std::string, Position>> waypoints;
+};
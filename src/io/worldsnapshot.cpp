@@ -0,0 +1,236 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "io/worldsnapshot.hpp"
+
+#include "game/game.hpp"
+#include "io/fileloader.hpp"
+#include "io/iomapserialize.hpp"
+#include "map/map.hpp"
+
+namespace {
+	constexpr std::array<char, 8> SNAPSHOT_MAGIC = { 'C', 'N', 'R', 'Y', 'W', 'L', 'D', '1' };
+	// Bumped whenever the layout below changes
+	constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+	struct SnapshotHeader {
+		std::array<char, 8> magic;
+		uint32_t version;
+		int64_t savedAt;
+		uint64_t mapSize;
+		int64_t mapMtime;
+		uint32_t tileCount;
+	};
+
+	// Items that only exist because the game created them, map items are rebuilt from the .otbm
+	bool isSnapshotItem(const std::shared_ptr<Item> &item) {
+		if (item->isLoadedFromMap() || item->hasAttribute(ItemAttribute_t::UNIQUEID)) {
+			return false;
+		}
+		return item->isMoveable() || item->getDecaying() != DECAYING_FALSE;
+	}
+
+	bool getMapIdentity(const std::filesystem::path &mapFile, uint64_t &size, int64_t &mtime) {
+		std::error_code error;
+		size = std::filesystem::file_size(mapFile, error);
+		if (error) {
+			return false;
+		}
+		mtime = std::filesystem::last_write_time(mapFile, error).time_since_epoch().count();
+		return !error;
+	}
+}
+
+void WorldSnapshot::store(const Map &map, const std::filesystem::path &mapFile) {
+	const auto start = getPreciseTimeMs();
+
+	SnapshotHeader header {};
+	header.magic = SNAPSHOT_MAGIC;
+	header.version = SNAPSHOT_VERSION;
+	header.savedAt = getTimeNow();
+	if (!getMapIdentity(mapFile, header.mapSize, header.mapMtime)) {
+		g_logger().warn("[WorldSnapshot::store] - Could not read {}", mapFile.string());
+		return;
+	}
+
+	PropWriteStream stream;
+	stream.write<SnapshotHeader>(header);
+
+	uint32_t tileCount = 0;
+	size_t itemCount = 0;
+	for (const auto &[x, y, z, stateHash] : map.materializedTiles) {
+		const auto &floor = map.getLeaf(x, y)->getFloor(z);
+		const auto tile = floor->getTile(x, y);
+		const TileItemVector* tileItems = tile ? tile->getItemList() : nullptr;
+		if (!tileItems) {
+			continue;
+		}
+
+		// Written last to first, so adding them back in order keeps the stack order
+		std::forward_list<std::shared_ptr<Item>> items;
+		uint32_t count = 0;
+		for (const auto &item : *tileItems) {
+			if (isSnapshotItem(item)) {
+				items.push_front(item);
+				++count;
+			}
+		}
+
+		if (count == 0) {
+			continue;
+		}
+
+		stream.write<uint16_t>(x);
+		stream.write<uint16_t>(y);
+		stream.write<uint8_t>(z);
+		stream.write<uint32_t>(count);
+		for (const auto &item : items) {
+			IOMapSerialize::saveItem(stream, item);
+		}
+		++tileCount;
+		itemCount += count;
+	}
+
+	size_t size;
+	const char* data = stream.getStream(size);
+	header.tileCount = tileCount;
+	std::string content(data, size);
+	std::memcpy(content.data(), &header, sizeof(header));
+
+	const std::filesystem::path snapshotFile(SNAPSHOT_FILE);
+	std::error_code error;
+	std::filesystem::create_directories(snapshotFile.parent_path(), error);
+
+	// Written aside and renamed, a crash never leaves a truncated snapshot behind
+	auto temporaryFile = snapshotFile;
+	temporaryFile += ".tmp";
+	{
+		std::ofstream file(temporaryFile, std::ios::binary | std::ios::trunc);
+		file.write(content.data(), static_cast<std::streamsize>(content.size()));
+		if (!file) {
+			g_logger().warn("[WorldSnapshot::store] - Could not write {}", temporaryFile.string());
+			return;
+		}
+	}
+	std::filesystem::rename(temporaryFile, snapshotFile, error);
+	if (error) {
+		g_logger().warn("[WorldSnapshot::store] - Could not write {}: {}", snapshotFile.string(), error.message());
+		return;
+	}
+
+	g_logger().info("World snapshot written in {} ms, {} items on {} tiles", getPreciseTimeMs() - start, itemCount, tileCount);
+}
+
+void WorldSnapshot::restore(Map &map, const std::filesystem::path &mapFile) {
+	const std::filesystem::path snapshotFile(SNAPSHOT_FILE);
+	std::error_code error;
+	if (!std::filesystem::exists(snapshotFile, error)) {
+		return;
+	}
+
+	std::string content;
+	{
+		std::ifstream file(snapshotFile, std::ios::binary);
+		content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+	// Used once, another restart must not bring the same items back
+	std::filesystem::remove(snapshotFile, error);
+
+	SnapshotHeader header {};
+	if (content.size() < sizeof(header)) {
+		return;
+	}
+	std::memcpy(&header, content.data(), sizeof(header));
+	if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION) {
+		return;
+	}
+
+	uint64_t mapSize;
+	int64_t mapMtime;
+	if (!getMapIdentity(mapFile, mapSize, mapMtime) || mapSize != header.mapSize || mapMtime != header.mapMtime) {
+		g_logger().info("World snapshot ignored, the map changed since it was written");
+		return;
+	}
+
+	const int64_t age = getTimeNow() - header.savedAt;
+	if (age < 0 || age > MAX_AGE_SECONDS) {
+		g_logger().info("World snapshot ignored, it was written {} seconds ago", age);
+		return;
+	}
+
+	const auto start = getPreciseTimeMs();
+	PropStream propStream;
+	propStream.init(content.data() + sizeof(header), content.size() - sizeof(header));
+
+	size_t itemCount = 0;
+	for (uint32_t i = 0; i < header.tileCount; ++i) {
+		uint16_t x, y;
+		uint8_t z;
+		uint32_t count;
+		if (!propStream.read<uint16_t>(x) || !propStream.read<uint16_t>(y) || !propStream.read<uint8_t>(z) || !propStream.read<uint32_t>(count)) {
+			g_logger().warn("[WorldSnapshot::restore] - Truncated snapshot, {} of {} tiles restored", i, header.tileCount);
+			break;
+		}
+
+		const auto tile = map.getTile(x, y, z);
+		if (!tile) {
+			g_logger().warn("[WorldSnapshot::restore] - No tile at {}, the rest of the snapshot is skipped", Position(x, y, z).toString());
+			break;
+		}
+
+		bool loaded = true;
+		while (count-- && (loaded = loadItem(propStream, tile))) {
+			++itemCount;
+		}
+		if (!loaded) {
+			g_logger().warn("[WorldSnapshot::restore] - Could not read the items at {}, the rest of the snapshot is skipped", Position(x, y, z).toString());
+			break;
+		}
+	}
+
+	g_logger().info("World snapshot restored in {} ms, {} items, written {} seconds ago", getPreciseTimeMs() - start, itemCount, age);
+}
+
+bool WorldSnapshot::loadItem(PropStream &propStream, const std::shared_ptr<Cylinder> &parent) {
+	uint16_t id;
+	if (!propStream.read<uint16_t>(id)) {
+		return false;
+	}
+
+	// Without the item its attributes cannot be skipped
+	const auto item = Item::CreateItem(id);
+	if (!item || !item->unserializeAttr(propStream)) {
+		return false;
+	}
+
+	if (const auto container = item->getContainer()) {
+		while (container->serializationCount > 0) {
+			if (!loadItem(propStream, container)) {
+				return false;
+			}
+			container->serializationCount--;
+		}
+
+		uint8_t endAttr;
+		if (!propStream.read<uint8_t>(endAttr) || endAttr != 0) {
+			return false;
+		}
+	}
+
+	// Static items added by scripts at startup (Action:position) are already there
+	if (!item->isMoveable() && !parent->getParent() && g_game().findItemOfType(parent->getTile(), id, false, -1)) {
+		return true;
+	}
+
+	parent->internalAddThing(item);
+	item->startDecaying();
+	return true;
+}
@@ -0,0 +1,37 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class Map;
+class Cylinder;
+class PropStream;
+
+/**
+ * Items lying on the map outside houses, kept across a planned restart.
+ * With worldSnapshot they are written on shutdown, after the players and
+ * houses were saved, as the tiles built from the map cache (the baseline)
+ * with the items that did not come from the map: loot, corpses, fields
+ * and whatever players dropped, with their remaining decay.
+ *
+ * The next startup puts them back and deletes the file, so a crash after
+ * that never restores the same items twice. A snapshot older than
+ * MAX_AGE_SECONDS or taken from another .otbm is ignored.
+ */
+class WorldSnapshot {
+public:
+	static constexpr std::string_view SNAPSHOT_FILE = "cache/world.bin";
+	static constexpr int64_t MAX_AGE_SECONDS = 15 * 60;
+
+	static void store(const Map &map, const std::filesystem::path &mapFile);
+	static void restore(Map &map, const std::filesystem::path &mapFile);
+
+private:
+	static bool loadItem(PropStream &propStream, const std::shared_ptr<Cylinder> &parent);
+};
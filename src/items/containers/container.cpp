@@ -10,6 +10,7 @@
 #include "pch.hpp"
 
 #include "items/containers/container.hpp"
+#include "items/item_pools.hpp"
 #include "items/decay/decay.hpp"
 #include "io/iomap.hpp"
 #include "game/game.hpp"
@@ -31,21 +32,22 @@ Container::Container(uint16_t initType, uint16_t initSize, bool initUnlocked /*=
 	pagination(initPagination) { }
 
 std::shared_ptr<Container> Container::create(uint16_t type) {
-	return std::make_shared<Container>(type);
+	return makePooled<Container>(type);
 }
 
 std::shared_ptr<Container> Container::create(uint16_t type, uint16_t size, bool unlocked /*= true*/, bool pagination /*= false*/) {
-	return std::make_shared<Container>(type, size, unlocked, pagination);
+	return makePooled<Container>(type, size, unlocked, pagination);
 }
 
 std::shared_ptr<Container> Container::create(std::shared_ptr<Tile> tile) {
-	auto container = std::make_shared<Container>(ITEM_BROWSEFIELD, 30, false, true);
+	auto container = makePooled<Container>(ITEM_BROWSEFIELD, 30, false, true);
 	TileItemVector* itemVector = tile->getItemList();
 	if (itemVector) {
 		for (auto &item : *itemVector) {
 			if (((item->getContainer() || item->hasProperty(CONST_PROP_MOVEABLE)) || (item->isWrapable() && !item->hasProperty(CONST_PROP_MOVEABLE) && !item->hasProperty(CONST_PROP_BLOCKPATH))) && !item->hasAttribute(ItemAttribute_t::UNIQUEID)) {
 				container->itemlist.push_front(item);
 				item->setParent(container);
+				container->updateItemAggregates(item, true);
 			}
 		}
 	}
@@ -115,6 +117,7 @@ bool Container::hasParent() {
 void Container::addItem(std::shared_ptr<Item> item) {
 	itemlist.push_back(item);
 	item->setParent(getContainer());
+	updateItemAggregates(item, true);
 }
 
 StashContainerList Container::getStowableItems() const {
@@ -150,7 +153,7 @@ bool Container::unserializeItemNode(OTB::Loader &loader, const OTB::Node &node,
 		return false;
 	}
 
-	for (auto &itemNode : node.children) {
+	for (const auto &itemNode : loader.getChildren(node)) {
 		// load container items
 		if (itemNode.type != OTBM_ITEM) {
 			// unknown type
@@ -206,6 +209,60 @@ uint32_t Container::getWeight() const {
 	return Item::getWeight() + totalWeight;
 }
 
+static void updateItemTypeCount(ContainerAggregates &aggregates, uint16_t itemId, uint32_t count, bool add) {
+	if (add) {
+		aggregates.itemTypeCounts[itemId] += count;
+		return;
+	}
+
+	auto it = aggregates.itemTypeCounts.find(itemId);
+	if (it == aggregates.itemTypeCounts.end()) {
+		return;
+	}
+
+	if (it->second <= count) {
+		aggregates.itemTypeCounts.erase(it);
+	} else {
+		it->second -= count;
+	}
+}
+
+static void updateAggregates(ContainerAggregates &aggregates, const Item &item, const ContainerAggregates* contents, bool add) {
+	const auto apply = [add](auto &total, auto value) {
+		total = add ? total + value : total - std::min<std::remove_reference_t<decltype(total)>>(total, value);
+	};
+
+	++aggregates.revision;
+	updateItemTypeCount(aggregates, item.getID(), item.getItemCount(), add);
+	apply(aggregates.itemCount, 1u);
+	apply(aggregates.money, static_cast<uint64_t>(item.getWorth()));
+	if (!contents) {
+		return;
+	}
+
+	apply(aggregates.itemCount, contents->itemCount);
+	apply(aggregates.containerCount, contents->containerCount + 1);
+	apply(aggregates.money, contents->money);
+	for (const auto &[itemId, count] : contents->itemTypeCounts) {
+		updateItemTypeCount(aggregates, itemId, count, add);
+	}
+}
+
+void Container::updateItemAggregates(const std::shared_ptr<Item> &item, bool add) {
+	const auto itemContainer = item->getContainer();
+	const ContainerAggregates* contents = itemContainer ? &itemContainer->aggregates : nullptr;
+
+	std::shared_ptr<Container> container = getContainer();
+	do {
+		updateAggregates(container->aggregates, *item, contents, add);
+	} while ((container = container->getParentContainer()) != nullptr);
+}
+
+uint32_t Container::getHoldingItemTypeCount(uint16_t itemId) const {
+	const auto it = aggregates.itemTypeCounts.find(itemId);
+	return it != aggregates.itemTypeCounts.end() ? it->second : 0;
+}
+
 std::string Container::getContentDescription(bool oldProtocol) {
 	std::ostringstream os;
 	return getContentDescription(os, oldProtocol).str();
@@ -323,24 +380,6 @@ std::shared_ptr<Item> Container::getItemByIndex(size_t index) const {
 	return itemlist[index];
 }
 
-uint32_t Container::getItemHoldingCount() {
-	uint32_t counter = 0;
-	for (ContainerIterator it = iterator(); it.hasNext(); it.advance()) {
-		++counter;
-	}
-	return counter;
-}
-
-uint32_t Container::getContainerHoldingCount() {
-	uint32_t counter = 0;
-	for (ContainerIterator it = iterator(); it.hasNext(); it.advance()) {
-		if ((*it)->getContainer()) {
-			++counter;
-		}
-	}
-	return counter;
-}
-
 bool Container::isHoldingItem(std::shared_ptr<Item> item) {
 	for (ContainerIterator it = iterator(); it.hasNext(); it.advance()) {
 		if (*it == item) {
@@ -350,14 +389,8 @@ bool Container::isHoldingItem(std::shared_ptr<Item> item) {
 	return false;
 }
 
-bool Container::isHoldingItemWithId(const uint16_t id) {
-	for (ContainerIterator it = iterator(); it.hasNext(); it.advance()) {
-		std::shared_ptr<Item> item = *it;
-		if (item->getID() == id) {
-			return true;
-		}
-	}
-	return false;
+bool Container::isHoldingItemWithId(const uint16_t id) const {
+	return aggregates.itemTypeCounts.contains(id);
 }
 
 void Container::onAddContainerItem(std::shared_ptr<Item> item) {
@@ -365,12 +398,12 @@ void Container::onAddContainerItem(std::shared_ptr<Item> item) {
 	g_game().map.getSpectators(spectators, getPosition(), false, true, 2, 2, 2, 2);
 
 	// send to client
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->getPlayer()->sendAddContainerItem(getContainer(), item);
 	}
 
 	// event methods
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->getPlayer()->onAddContainerItem(item);
 	}
 }
@@ -380,12 +413,12 @@ void Container::onUpdateContainerItem(uint32_t index, std::shared_ptr<Item> oldI
 	g_game().map.getSpectators(spectators, getPosition(), false, true, 2, 2, 2, 2);
 
 	// send to client
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->getPlayer()->sendUpdateContainerItem(getContainer(), index, newItem);
 	}
 
 	// event methods
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->getPlayer()->onUpdateContainerItem(getContainer(), oldItem, newItem);
 	}
 }
@@ -395,17 +428,17 @@ void Container::onRemoveContainerItem(uint32_t index, std::shared_ptr<Item> item
 	g_game().map.getSpectators(spectators, getPosition(), false, true, 2, 2, 2, 2);
 
 	// send change to client
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->getPlayer()->sendRemoveContainerItem(getContainer(), index);
 	}
 
 	// event methods
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->getPlayer()->onRemoveContainerItem(getContainer(), item);
 	}
 }
 
-ReturnValue Container::queryAdd(int32_t addIndex, const std::shared_ptr<Thing> &addThing, uint32_t addCount, uint32_t flags, std::shared_ptr<Creature> actor /* = nullptr*/) {
+ReturnValue Container::queryAdd(int32_t addIndex, const std::shared_ptr<Thing> &addThing, uint32_t addCount, uint32_t flags, const std::shared_ptr<Creature> &actor /* = nullptr*/) {
 	bool childIsOwner = hasBitSet(FLAG_CHILDISOWNER, flags);
 	if (childIsOwner) {
 		// a child container is querying, since we are the top container (not carried by a player)
@@ -502,11 +535,17 @@ ReturnValue Container::queryMaxCount(int32_t index, const std::shared_ptr<Thing>
 
 		if (index == INDEX_WHEREEVER) {
 			// Iterate through every item and check how much free stackable slots there is.
+			// Only the count changes between the queries, so each remainder is asked about once
+			std::vector<std::pair<uint32_t, bool>> addable;
 			uint32_t slotIndex = 0;
-			for (std::shared_ptr<Item> containerItem : itemlist) {
+			for (const std::shared_ptr<Item> &containerItem : itemlist) {
 				if (containerItem != item && containerItem->equals(item) && containerItem->getItemCount() < containerItem->getStackSize()) {
 					uint32_t remainder = (containerItem->getStackSize() - containerItem->getItemCount());
-					if (queryAdd(slotIndex++, item, remainder, flags) == RETURNVALUE_NOERROR) {
+					auto known = std::ranges::find(addable, remainder, &std::pair<uint32_t, bool>::first);
+					if (known == addable.end()) {
+						known = addable.emplace(addable.end(), remainder, queryAdd(slotIndex++, item, remainder, flags) == RETURNVALUE_NOERROR);
+					}
+					if (known->second) {
 						n += remainder;
 					}
 				}
@@ -532,7 +571,7 @@ ReturnValue Container::queryMaxCount(int32_t index, const std::shared_ptr<Thing>
 	return RETURNVALUE_NOERROR;
 }
 
-ReturnValue Container::queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, std::shared_ptr<Creature> actor /*= nullptr */) {
+ReturnValue Container::queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, const std::shared_ptr<Creature> &actor /*= nullptr */) {
 	int32_t index = getThingIndex(thing);
 	if (index == -1) {
 		g_logger().debug("{} - Failed to get thing index", __FUNCTION__);
@@ -653,6 +692,7 @@ void Container::addThing(int32_t index, std::shared_ptr<Thing> thing) {
 	item->setParent(getContainer());
 	itemlist.push_front(item);
 	updateItemWeight(item->getWeight());
+	updateItemAggregates(item, true);
 
 	// send change to client
 	if (getParent() && (getParent() != VirtualCylinder::virtualCylinder)) {
@@ -682,9 +722,11 @@ void Container::updateThing(std::shared_ptr<Thing> thing, uint16_t itemId, uint3
 	}
 
 	const int32_t oldWeight = item->getWeight();
+	updateItemAggregates(item, false);
 	item->setID(itemId);
 	item->setSubType(count);
 	updateItemWeight(-oldWeight + item->getWeight());
+	updateItemAggregates(item, true);
 
 	// send change to client
 	if (getParent()) {
@@ -706,6 +748,8 @@ void Container::replaceThing(uint32_t index, std::shared_ptr<Thing> thing) {
 	itemlist[index] = item;
 	item->setParent(getContainer());
 	updateItemWeight(-static_cast<int32_t>(replacedItem->getWeight()) + item->getWeight());
+	updateItemAggregates(replacedItem, false);
+	updateItemAggregates(item, true);
 
 	// send change to client
 	if (getParent()) {
@@ -729,8 +773,10 @@ void Container::removeThing(std::shared_ptr<Thing> thing, uint32_t count) {
 	if (item->isStackable() && count != item->getItemCount()) {
 		uint8_t newCount = static_cast<uint8_t>(std::max<int32_t>(0, item->getItemCount() - count));
 		const int32_t oldWeight = item->getWeight();
+		updateItemAggregates(item, false);
 		item->setItemCount(newCount);
 		updateItemWeight(-oldWeight + item->getWeight());
+		updateItemAggregates(item, true);
 
 		// send change to client
 		if (getParent()) {
@@ -738,6 +784,7 @@ void Container::removeThing(std::shared_ptr<Thing> thing, uint32_t count) {
 		}
 	} else {
 		updateItemWeight(-static_cast<int32_t>(item->getWeight()));
+		updateItemAggregates(item, false);
 
 		// send change to client
 		if (getParent()) {
@@ -792,6 +839,7 @@ std::shared_ptr<Thing> Container::getThing(size_t index) const {
 ItemVector Container::getItems(bool recursive /*= false*/) {
 	ItemVector containerItems;
 	if (recursive) {
+		containerItems.reserve(aggregates.itemCount);
 		for (ContainerIterator it = iterator(); it.hasNext(); it.advance()) {
 			containerItems.push_back(*it);
 		}
@@ -848,6 +896,7 @@ void Container::internalAddThing(uint32_t, std::shared_ptr<Thing> thing) {
 	item->setParent(getContainer());
 	itemlist.push_front(item);
 	updateItemWeight(item->getWeight());
+	updateItemAggregates(item, true);
 }
 
 void Container::startDecaying() {
@@ -903,6 +952,7 @@ void Container::removeItem(std::shared_ptr<Thing> thing, bool sendUpdateToClient
 		}
 
 		itemlist.erase(it);
+		updateItemAggregates(itemToRemove, false);
 		itemToRemove->resetParent();
 	}
 }
@@ -19,6 +19,17 @@ class DepotLocker;
 class RewardChest;
 class Reward;
 
+// Totals over everything a container holds, nested containers included
+struct ContainerAggregates {
+	// Item id to the sum of their counts
+	phmap::flat_hash_map<uint16_t, uint32_t> itemTypeCounts;
+	uint32_t itemCount = 0;
+	uint32_t containerCount = 0;
+	uint64_t money = 0;
+	// Moves on with every change of the contents, for caches built from them
+	uint32_t revision = 0;
+};
+
 class ContainerIterator {
 public:
 	bool hasNext() const {
@@ -113,10 +124,26 @@ public:
 	std::shared_ptr<Item> getFilteredItemByIndex(size_t index) const;
 	std::shared_ptr<Item> getItemByIndex(size_t index) const;
 	bool isHoldingItem(std::shared_ptr<Item> item);
-	bool isHoldingItemWithId(const uint16_t id);
+	bool isHoldingItemWithId(const uint16_t id) const;
 
-	uint32_t getItemHoldingCount();
-	uint32_t getContainerHoldingCount();
+	uint32_t getItemHoldingCount() const {
+		return aggregates.itemCount;
+	}
+	uint32_t getContainerHoldingCount() const {
+		return aggregates.containerCount;
+	}
+	// Count of the item id held anywhere inside, nested containers included
+	uint32_t getHoldingItemTypeCount(uint16_t itemId) const;
+	const phmap::flat_hash_map<uint16_t, uint32_t> &getHoldingItemTypeCounts() const {
+		return aggregates.itemTypeCounts;
+	}
+	// Worth of all the money held anywhere inside
+	uint64_t getHoldingMoney() const {
+		return aggregates.money;
+	}
+	uint32_t getContentRevision() const {
+		return aggregates.revision;
+	}
 	uint16_t getFreeSlots();
 	uint32_t getWeight() const override final;
 
@@ -128,9 +155,9 @@ public:
 	}
 
 	// cylinder implementations
-	virtual ReturnValue queryAdd(int32_t index, const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, std::shared_ptr<Creature> actor = nullptr) override;
+	virtual ReturnValue queryAdd(int32_t index, const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, const std::shared_ptr<Creature> &actor = nullptr) override;
 	ReturnValue queryMaxCount(int32_t index, const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t &maxQueryCount, uint32_t flags) override final;
-	ReturnValue queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, std::shared_ptr<Creature> actor = nullptr) override final;
+	ReturnValue queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, const std::shared_ptr<Creature> &actor = nullptr) override final;
 	std::shared_ptr<Cylinder> queryDestination(int32_t &index, const std::shared_ptr<Thing> &thing, std::shared_ptr<Item>* destItem, uint32_t &flags) override final;
 
 	void addThing(std::shared_ptr<Thing> thing) override final;
@@ -164,9 +191,13 @@ public:
 protected:
 	std::ostringstream &getContentDescription(std::ostringstream &os, bool oldProtocol);
 
+	// Adds or takes what item accounts for (itself and its contents) to this container and every parent container
+	void updateItemAggregates(const std::shared_ptr<Item> &item, bool add);
+
 	uint32_t m_maxItems;
 	uint32_t maxSize;
 	uint32_t totalWeight = 0;
+	ContainerAggregates aggregates;
 	ItemDeque itemlist;
 	uint32_t serializationCount = 0;
 
@@ -0,0 +1,70 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "items/containers/depot/depotindex.hpp"
+#include "items/containers/container.hpp"
+
+void DepotIndex::update(const std::vector<std::shared_ptr<Container>> &containers, const std::shared_ptr<Container> &inbox) {
+	const size_t total = containers.size() + (inbox ? 1 : 0);
+	if (sources.size() != total) {
+		sources.resize(total);
+	}
+
+	for (size_t i = 0; i < containers.size(); ++i) {
+		updateSource(i, containers[i], false);
+	}
+	if (inbox) {
+		updateSource(containers.size(), inbox, true);
+	}
+}
+
+bool DepotIndex::isMarketItem(const std::shared_ptr<Item> &item) {
+	const ItemType &itemType = Item::items[item->getID()];
+	if (itemType.wareId == 0) {
+		return false;
+	}
+
+	if (const auto container = item->getContainer(); container && (!container->empty() || !itemType.isContainer() || container->capacity() != itemType.maxItems)) {
+		return false;
+	}
+
+	return item->hasMarketAttributes();
+}
+
+void DepotIndex::build(Source &source) {
+	source.entries.clear();
+	for (ContainerIterator it = source.container->iterator(); it.hasNext(); it.advance()) {
+		const std::shared_ptr<Item> item = *it;
+		if (!item) {
+			continue;
+		}
+
+		auto &entry = source.entries[makeKey(item->getID(), item->getTier())];
+		const auto count = Item::countByType(item, -1);
+		entry.items.push_back(item);
+		entry.count += count;
+		if (isMarketItem(item)) {
+			entry.marketCount += count;
+		}
+	}
+}
+
+void DepotIndex::updateSource(size_t index, const std::shared_ptr<Container> &container, bool inbox) {
+	Source &source = sources[index];
+	if (source.container == container && source.revision == container->getContentRevision()) {
+		return;
+	}
+
+	source.container = container;
+	source.revision = container->getContentRevision();
+	source.inbox = inbox;
+	build(source);
+}
@@ -0,0 +1,75 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class Container;
+class Item;
+
+/**
+ * Items of a player's depot boxes and inbox by item id and tier, for the
+ * depot search and the market. Each box and the inbox is indexed on its
+ * own and only walked again once its content revision moved, so opening
+ * the search or the market on a big depot is a few lookups.
+ */
+class DepotIndex {
+public:
+	struct Entry {
+		// Nested containers included, in the order the depot search lists them
+		std::vector<std::shared_ptr<Item>> items;
+		// Sum of the counts of the items
+		uint32_t count = 0;
+		// Same for the items the market takes, see isMarketItem
+		uint32_t marketCount = 0;
+	};
+
+	// Walks again the containers that changed since the last call, the inbox goes last
+	void update(const std::vector<std::shared_ptr<Container>> &containers, const std::shared_ptr<Container> &inbox);
+
+	// Calls function(const Entry &, bool inbox) for every box holding the id and tier
+	template <typename Function>
+	void forEachEntry(uint16_t itemId, uint8_t tier, Function &&function) const {
+		const uint32_t key = makeKey(itemId, tier);
+		for (const auto &source : sources) {
+			if (const auto it = source.entries.find(key); it != source.entries.end()) {
+				function(it->second, source.inbox);
+			}
+		}
+	}
+
+	// Calls function(uint16_t itemId, uint8_t tier, const Entry &) for everything indexed
+	template <typename Function>
+	void forEachEntry(Function &&function) const {
+		for (const auto &source : sources) {
+			for (const auto &[key, entry] : source.entries) {
+				function(static_cast<uint16_t>(key >> 8), static_cast<uint8_t>(key & 0xFF), entry);
+			}
+		}
+	}
+
+	// Ware with its market attributes untouched, containers only when empty and as created
+	static bool isMarketItem(const std::shared_ptr<Item> &item);
+
+private:
+	struct Source {
+		std::shared_ptr<Container> container;
+		uint32_t revision = 0;
+		bool inbox = false;
+		phmap::flat_hash_map<uint32_t, Entry> entries;
+	};
+
+	static uint32_t makeKey(uint16_t itemId, uint8_t tier) {
+		return (static_cast<uint32_t>(itemId) << 8) | tier;
+	}
+
+	static void build(Source &source);
+	void updateSource(size_t index, const std::shared_ptr<Container> &container, bool inbox);
+
+	std::vector<Source> sources;
+};
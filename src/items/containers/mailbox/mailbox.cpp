@@ -13,7 +13,7 @@
 #include "game/game.hpp"
 #include "io/iologindata.hpp"
 
-ReturnValue Mailbox::queryAdd(int32_t, const std::shared_ptr<Thing> &thing, uint32_t, uint32_t, std::shared_ptr<Creature>) {
+ReturnValue Mailbox::queryAdd(int32_t, const std::shared_ptr<Thing> &thing, uint32_t, uint32_t, const std::shared_ptr<Creature> &) {
 	std::shared_ptr<Item> item = thing->getItem();
 	if (item && Mailbox::canSend(item)) {
 		return RETURNVALUE_NOERROR;
@@ -26,7 +26,7 @@ ReturnValue Mailbox::queryMaxCount(int32_t, const std::shared_ptr<Thing> &, uint
 	return RETURNVALUE_NOERROR;
 }
 
-ReturnValue Mailbox::queryRemove(const std::shared_ptr<Thing> &, uint32_t, uint32_t, std::shared_ptr<Creature> /*= nullptr */) {
+ReturnValue Mailbox::queryRemove(const std::shared_ptr<Thing> &, uint32_t, uint32_t, const std::shared_ptr<Creature> & /*= nullptr */) {
 	return RETURNVALUE_NOTPOSSIBLE;
 }
 
@@ -83,7 +83,7 @@ bool Mailbox::sendItem(std::shared_ptr<Item> item) const {
 	if (item && item->getContainer() && item->getTile()) {
 		SpectatorHashSet spectators;
 		g_game().map.getSpectators(spectators, item->getTile()->getPosition(), false, true);
-		for (auto spectator : spectators) {
+		for (const auto &spectator : spectators) {
 			if (spectator && spectator->getPlayer()) {
 				spectator->getPlayer()->autoCloseContainers(item->getContainer());
 			}
@@ -30,7 +30,7 @@ public:
 	 * \param actor the creature trying to add the thing
 	 * \returns ReturnValue holds the return value
 	 */
-	virtual ReturnValue queryAdd(int32_t index, const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, std::shared_ptr<Creature> actor = nullptr) = 0;
+	virtual ReturnValue queryAdd(int32_t index, const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, const std::shared_ptr<Creature> &actor = nullptr) = 0;
 
 	/**
 	 * Query the cylinder how much it can accept
@@ -51,7 +51,7 @@ public:
 	 * \param flags optional flags to modify the default behaviour
 	 * \returns ReturnValue holds the return value
 	 */
-	virtual ReturnValue queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, std::shared_ptr<Creature> = nullptr) = 0;
+	virtual ReturnValue queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, const std::shared_ptr<Creature> & = nullptr) = 0;
 
 	/**
 	 * Query the destination cylinder
@@ -176,13 +176,13 @@ class VirtualCylinder final : public Cylinder {
 public:
 	static std::shared_ptr<VirtualCylinder> virtualCylinder;
 
-	virtual ReturnValue queryAdd(int32_t, const std::shared_ptr<Thing> &, uint32_t, uint32_t, std::shared_ptr<Creature> = nullptr) override {
+	virtual ReturnValue queryAdd(int32_t, const std::shared_ptr<Thing> &, uint32_t, uint32_t, const std::shared_ptr<Creature> & = nullptr) override {
 		return RETURNVALUE_NOTPOSSIBLE;
 	}
 	virtual ReturnValue queryMaxCount(int32_t, const std::shared_ptr<Thing> &, uint32_t, uint32_t &, uint32_t) override {
 		return RETURNVALUE_NOTPOSSIBLE;
 	}
-	virtual ReturnValue queryRemove(const std::shared_ptr<Thing> &, uint32_t, uint32_t, std::shared_ptr<Creature> = nullptr) override {
+	virtual ReturnValue queryRemove(const std::shared_ptr<Thing> &, uint32_t, uint32_t, const std::shared_ptr<Creature> & = nullptr) override {
 		return RETURNVALUE_NOTPOSSIBLE;
 	}
 	virtual std::shared_ptr<Cylinder> queryDestination(int32_t &, const std::shared_ptr<Thing> &, std::shared_ptr<Item>*, uint32_t &) override {
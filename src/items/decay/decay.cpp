@@ -39,59 +39,27 @@ void Decay::startDecay(std::shared_ptr<Item> item) {
 			stopDecay(item);
 		}
 
-		int64_t timestamp = OTSYS_TIME() + duration;
-		if (decayMap.empty()) {
-			eventId = g_scheduler().addEvent(std::max<int32_t>(SCHEDULER_MINTICKS, duration), std::bind(&Decay::checkDecay, this), "Decay::checkDecay");
-		} else {
-			if (timestamp < decayMap.begin()->first) {
-				g_scheduler().stopEvent(eventId);
-				eventId = g_scheduler().addEvent(std::max<int32_t>(SCHEDULER_MINTICKS, duration), std::bind(&Decay::checkDecay, this), "Decay::checkDecay");
-			}
-		}
+		// Its decay attributes may have been reset while it was still linked, it must not be in two buckets
+		unlink(item);
 
+		int64_t timestamp = OTSYS_TIME() + duration;
 		item->setDecaying(DECAYING_TRUE);
 		item->setAttribute(ItemAttribute_t::DURATION_TIMESTAMP, timestamp);
-		decayMap[timestamp].push_back(item);
+		link(item, getTick(timestamp));
+		scheduleCheck();
 	}
 }
 
 void Decay::stopDecay(std::shared_ptr<Item> item) {
 	if (item->hasAttribute(ItemAttribute_t::DECAYSTATE)) {
-		auto timestamp = item->getAttribute<int64_t>(ItemAttribute_t::DURATION_TIMESTAMP);
 		if (item->hasAttribute(ItemAttribute_t::DURATION_TIMESTAMP)) {
-			auto it = decayMap.find(timestamp);
-			if (it != decayMap.end()) {
-				auto &decayItems = it->second;
-
-				size_t i = 0, end = decayItems.size();
-				auto decayItem = decayItems[i];
-				if (end == 1) {
-					if (item == decayItem) {
-						if (item->hasAttribute(ItemAttribute_t::DURATION)) {
-							// Incase we removed duration attribute don't assign new duration
-							item->setDuration(item->getDuration());
-						}
-						item->removeAttribute(ItemAttribute_t::DECAYSTATE);
-
-						decayMap.erase(it);
-					}
-					return;
-				}
-				while (i < end) {
-					decayItem = decayItems[i];
-					if (item == decayItem) {
-						if (item->hasAttribute(ItemAttribute_t::DURATION)) {
-							// Incase we removed duration attribute don't assign new duration
-							item->setDuration(item->getDuration());
-						}
-						item->removeAttribute(ItemAttribute_t::DECAYSTATE);
-
-						decayItems[i] = decayItems.back();
-						decayItems.pop_back();
-						return;
-					}
-					++i;
+			if (unlink(item)) {
+				if (item->hasAttribute(ItemAttribute_t::DURATION)) {
+					// Incase we removed duration attribute don't assign new duration
+					item->setDuration(item->getDuration());
 				}
+				item->removeAttribute(ItemAttribute_t::DECAYSTATE);
+				return;
 			}
 			item->removeAttribute(ItemAttribute_t::DURATION_TIMESTAMP);
 		} else {
@@ -100,25 +68,97 @@ void Decay::stopDecay(std::shared_ptr<Item> item) {
 	}
 }
 
+uint32_t Decay::getTick(int64_t timestamp) const {
+	const int64_t tick = (timestamp - epoch + DECAY_TICK_MS - 1) / DECAY_TICK_MS;
+	return static_cast<uint32_t>(std::max<int64_t>(tick, currentTick));
+}
+
+void Decay::link(const std::shared_ptr<Item> &item, uint32_t tick) {
+	DecayBucket* bucket;
+	if (tick < currentTick + DECAY_WHEEL_SLOTS) {
+		bucket = &wheel[tick % DECAY_WHEEL_SLOTS];
+		++wheelCount;
+	} else {
+		bucket = &overflow[tick];
+	}
+
+	item->decayTick = tick;
+	item->decayIndex = static_cast<uint32_t>(bucket->size());
+	bucket->emplace_back(item);
+}
+
+bool Decay::unlink(const std::shared_ptr<Item> &item) {
+	const uint32_t index = std::exchange(item->decayIndex, NOT_DECAYING);
+	if (index == NOT_DECAYING) {
+		return false;
+	}
+
+	const uint32_t tick = item->decayTick;
+	const bool inWheel = tick < currentTick + DECAY_WHEEL_SLOTS;
+	auto overflowIt = inWheel ? overflow.end() : overflow.find(tick);
+	if (!inWheel && overflowIt == overflow.end()) {
+		return false;
+	}
+
+	auto &bucket = inWheel ? wheel[tick % DECAY_WHEEL_SLOTS] : overflowIt->second;
+	if (index >= bucket.size() || bucket[index] != item) {
+		return false;
+	}
+
+	// Swap with the last one so the positions of the others stay valid
+	if (index + 1 != bucket.size()) {
+		bucket[index] = std::move(bucket.back());
+		bucket[index]->decayIndex = index;
+	}
+	bucket.pop_back();
+
+	if (inWheel) {
+		--wheelCount;
+	} else if (bucket.empty()) {
+		overflow.erase(overflowIt);
+	}
+	return true;
+}
+
+void Decay::scheduleCheck() {
+	if (eventId == 0) {
+		eventId = g_scheduler().addEvent(DECAY_TICK_MS, std::bind(&Decay::checkDecay, this), "Decay::checkDecay");
+	}
+}
+
 void Decay::checkDecay() {
-	int64_t timestamp = OTSYS_TIME();
+	eventId = 0;
+	const auto nowTick = static_cast<uint32_t>((OTSYS_TIME() - epoch) / DECAY_TICK_MS);
 
+	// Iterating the buckets while decaying is unsafe, so the expired items are moved out first
 	std::vector<std::shared_ptr<Item>> tempItems;
-	tempItems.reserve(32); // Small preallocation
-
-	auto it = decayMap.begin(), end = decayMap.end();
-	while (it != end) {
-		if (it->first > timestamp) {
-			break;
+	while (wheelCount > 0 && currentTick <= nowTick) {
+		auto &bucket = wheel[currentTick % DECAY_WHEEL_SLOTS];
+		for (auto &decayItem : bucket) {
+			decayItem->decayIndex = NOT_DECAYING;
+			tempItems.emplace_back(std::move(decayItem));
 		}
+		wheelCount -= bucket.size();
+		bucket.clear();
+		++currentTick;
+	}
+
+	// Nothing else is due before the current tick, the empty slots are skipped
+	if (wheelCount == 0) {
+		currentTick = std::max(currentTick, nowTick + 1);
+	}
 
-		// Iterating here is unsafe so let's copy our items into temporary vector
-		auto &decayItems = it->second;
-		tempItems.reserve(tempItems.size() + decayItems.size());
-		for (auto &decayItem : decayItems) {
-			tempItems.push_back(decayItem);
+	// The lap just reached takes over the items waiting for it
+	while (!overflow.empty() && overflow.begin()->first < currentTick + DECAY_WHEEL_SLOTS) {
+		auto node = overflow.extract(overflow.begin());
+		const uint32_t tick = std::max(node.key(), currentTick);
+		auto &bucket = wheel[tick % DECAY_WHEEL_SLOTS];
+		for (auto &decayItem : node.mapped()) {
+			decayItem->decayTick = tick;
+			decayItem->decayIndex = static_cast<uint32_t>(bucket.size());
+			bucket.emplace_back(std::move(decayItem));
+			++wheelCount;
 		}
-		it = decayMap.erase(it);
 	}
 
 	for (const auto &item : tempItems) {
@@ -131,8 +171,8 @@ void Decay::checkDecay() {
 		}
 	}
 
-	if (it != end) {
-		eventId = g_scheduler().addEvent(std::max<int32_t>(SCHEDULER_MINTICKS, static_cast<int32_t>(it->first - timestamp)), std::bind(&Decay::checkDecay, this), "Decay::checkDecay");
+	if (wheelCount > 0 || !overflow.empty()) {
+		scheduleCheck();
 	}
 }
 
@@ -11,6 +11,13 @@
 
 #include "items/item.hpp"
 
+/**
+ * Decaying items wait in a timer wheel of DECAY_TICK_MS buckets, so the
+ * ones due within the same tick expire in one batch. Items due later than
+ * a lap of the wheel wait in an overflow map until their lap comes. Every
+ * item knows its bucket and its position in it, so starting and stopping
+ * its decay is O(1).
+ */
 class Decay {
 public:
 	Decay() = default;
@@ -25,13 +32,38 @@ public:
 	void startDecay(std::shared_ptr<Item> item);
 	void stopDecay(std::shared_ptr<Item> item);
 
+	// Game thread only
+	[[nodiscard]] size_t getPendingCount() const {
+		size_t pending = wheelCount;
+		for (const auto &[tick, bucket] : overflow) {
+			pending += bucket.size();
+		}
+		return pending;
+	}
+
 private:
+	static constexpr int64_t DECAY_TICK_MS = 50;
+	static constexpr uint32_t DECAY_WHEEL_SLOTS = 4096;
+	static constexpr uint32_t NOT_DECAYING = std::numeric_limits<uint32_t>::max();
+
+	using DecayBucket = std::vector<std::shared_ptr<Item>>;
+
 	void checkDecay();
 	void internalDecayItem(std::shared_ptr<Item> item);
 
+	// First tick at or after the timestamp, never one already expired
+	uint32_t getTick(int64_t timestamp) const;
+	void link(const std::shared_ptr<Item> &item, uint32_t tick);
+	bool unlink(const std::shared_ptr<Item> &item);
+	void scheduleCheck();
+
 	uint32_t eventId { 0 };
-	// order is important, so we use an std::map
-	std::map<int64_t, std::vector<std::shared_ptr<Item>>> decayMap;
+	const int64_t epoch = OTSYS_TIME();
+	// Next tick to expire, the wheel holds the ticks [currentTick, currentTick + DECAY_WHEEL_SLOTS)
+	uint32_t currentTick = 0;
+	size_t wheelCount = 0;
+	std::array<DecayBucket, DECAY_WHEEL_SLOTS> wheel;
+	std::map<uint32_t, DecayBucket> overflow;
 };
 
 constexpr auto g_decay = Decay::getInstance;
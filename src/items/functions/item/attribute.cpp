@@ -11,6 +11,26 @@
 
 #include "items/functions/item/attribute.hpp"
 
+ItemAttribute::ItemAttribute(const ItemAttribute &other) :
+	attributeBits(other.attributeBits), integers(other.integers),
+	outOfLine(other.outOfLine ? std::make_unique<OutOfLineAttributes>(*other.outOfLine) : nullptr) { }
+
+ItemAttribute &ItemAttribute::operator=(const ItemAttribute &other) {
+	if (this != &other) {
+		attributeBits = other.attributeBits;
+		integers = other.integers;
+		outOfLine = other.outOfLine ? std::make_unique<OutOfLineAttributes>(*other.outOfLine) : nullptr;
+	}
+	return *this;
+}
+
+ItemAttribute::OutOfLineAttributes &ItemAttribute::getOutOfLine() {
+	if (!outOfLine) {
+		outOfLine = std::make_unique<OutOfLineAttributes>();
+	}
+	return *outOfLine;
+}
+
 /*
 =============================
 * ItemAttribute class (Attributes methods)
@@ -18,52 +38,25 @@
 */
 const std::string &ItemAttribute::getAttributeString(ItemAttribute_t type) const {
 	static std::string emptyString;
-	if (!isAttributeString(type)) {
+	if (!isAttributeString(type) || !hasAttribute(type)) {
 		return emptyString;
 	}
 
-	auto attribute = getAttribute(type);
-	if (!attribute) {
-		return emptyString;
+	for (const auto &[stringType, value] : outOfLine->strings) {
+		if (stringType == type) {
+			return value;
+		}
 	}
-
-	return *attribute->getString().get();
+	return emptyString;
 }
 
 const int64_t &ItemAttribute::getAttributeValue(ItemAttribute_t type) const {
 	static int64_t emptyInt;
-	if (!isAttributeInteger(type)) {
+	if (!isAttributeInteger(type) || !hasAttribute(type)) {
 		return emptyInt;
 	}
 
-	auto attribute = getAttribute(type);
-	if (!attribute) {
-		return emptyInt;
-	}
-
-	return attribute->getInteger();
-}
-
-const Attributes* ItemAttribute::getAttribute(ItemAttribute_t type) const {
-	if (hasAttribute(type)) {
-		for (const Attributes &attribute : attributeVector) {
-			if (attribute.getAttributeType() == type) {
-				return &attribute;
-			}
-		}
-	}
-	return nullptr;
-}
-
-Attributes &ItemAttribute::getAttributesByType(ItemAttribute_t type) {
-	for (Attributes &attribute : attributeVector) {
-		if (attribute.getAttributeType() == type) {
-			return attribute;
-		}
-	}
-
-	attributeVector.emplace_back(type);
-	return attributeVector.back();
+	return integers[getIntegerIndex(type)];
 }
 
 void ItemAttribute::setAttribute(ItemAttribute_t type, int64_t value) {
@@ -71,10 +64,17 @@ void ItemAttribute::setAttribute(ItemAttribute_t type, int64_t value) {
 		return;
 	}
 
-	getAttributesByType(type).setValue(value);
+	const auto index = getIntegerIndex(type);
+	if (hasAttribute(type)) {
+		integers[index] = value;
+		return;
+	}
+
+	integers.insert(integers.begin() + static_cast<std::ptrdiff_t>(index), value);
+	attributeBits |= attributeBit(type);
 }
 
-void ItemAttribute::setAttribute(ItemAttribute_t type, const std::string &value) {
+void ItemAttribute::setAttribute(ItemAttribute_t type, std::string_view value) {
 	if (!isAttributeString(type)) {
 		return;
 	}
@@ -83,18 +83,29 @@ void ItemAttribute::setAttribute(ItemAttribute_t type, const std::string &value)
 		return;
 	}
 
-	getAttributesByType(type).setValue(value);
+	auto &strings = getOutOfLine().strings;
+	auto it = std::ranges::lower_bound(strings, type, {}, &std::pair<ItemAttribute_t, std::string>::first);
+	if (it != strings.end() && it->first == type) {
+		it->second = value;
+		return;
+	}
+
+	strings.emplace(it, type, value);
+	attributeBits |= attributeBit(type);
 }
 
 bool ItemAttribute::removeAttribute(ItemAttribute_t type) {
-	for (auto it = attributeVector.begin(); it != attributeVector.end(); ++it) {
-		if (it->getAttributeType() == type) {
-			*it = std::move(attributeVector.back());
-			attributeVector.pop_back();
-			return true;
-		}
+	if (!hasAttribute(type)) {
+		return false;
 	}
-	return false;
+
+	if (isAttributeInteger(type)) {
+		integers.erase(integers.begin() + static_cast<std::ptrdiff_t>(getIntegerIndex(type)));
+	} else {
+		std::erase_if(outOfLine->strings, [type](const auto &string) { return string.first == type; });
+	}
+	attributeBits &= ~attributeBit(type);
+	return true;
 }
 
 /*
@@ -102,8 +113,14 @@ bool ItemAttribute::removeAttribute(ItemAttribute_t type) {
 * CustomAttribute map methods
 =============================
 */
-const std::map<std::string, CustomAttribute, std::less<>> &ItemAttribute::getCustomAttributeMap() const {
-	return customAttributeMap;
+const CustomAttributeList &ItemAttribute::getCustomAttributeMap() const {
+	static const CustomAttributeList emptyList;
+	return outOfLine ? outOfLine->customAttributes : emptyList;
+}
+
+CustomAttributeList::iterator ItemAttribute::findCustomAttribute(const std::string &lowerCaseKey) {
+	auto &customAttributes = getOutOfLine().customAttributes;
+	return std::ranges::lower_bound(customAttributes, lowerCaseKey, {}, &CustomAttributeList::value_type::first);
 }
 
 /*
@@ -112,42 +129,53 @@ const std::map<std::string, CustomAttribute, std::less<>> &ItemAttribute::getCus
 =============================
 */
 const CustomAttribute* ItemAttribute::getCustomAttribute(const std::string &attributeName) const {
-	if (customAttributeMap.contains(asLowerCaseString(attributeName))) {
-		return &customAttributeMap.at(asLowerCaseString(attributeName));
+	const auto &customAttributes = getCustomAttributeMap();
+	const auto key = asLowerCaseString(attributeName);
+	auto it = std::ranges::lower_bound(customAttributes, key, {}, &CustomAttributeList::value_type::first);
+	if (it != customAttributes.end() && it->first == key) {
+		return &it->second;
 	}
 	return nullptr;
 }
 
 void ItemAttribute::setCustomAttribute(const std::string &key, const int64_t value) {
-	CustomAttribute attribute(key, value);
-	customAttributeMap[asLowerCaseString(key)] = attribute;
+	addCustomAttribute(key, CustomAttribute(key, value));
 }
 
 void ItemAttribute::setCustomAttribute(const std::string &key, const std::string &value) {
-	CustomAttribute attribute(key, value);
-	customAttributeMap[asLowerCaseString(key)] = attribute;
+	addCustomAttribute(key, CustomAttribute(key, value));
 }
 
 void ItemAttribute::setCustomAttribute(const std::string &key, const double value) {
-	CustomAttribute attribute(key, value);
-	customAttributeMap[asLowerCaseString(key)] = attribute;
+	addCustomAttribute(key, CustomAttribute(key, value));
 }
 
 void ItemAttribute::setCustomAttribute(const std::string &key, const bool value) {
-	CustomAttribute attribute(key, value);
-	customAttributeMap[asLowerCaseString(key)] = attribute;
+	addCustomAttribute(key, CustomAttribute(key, value));
 }
 
 void ItemAttribute::addCustomAttribute(const std::string &key, const CustomAttribute &customAttribute) {
-	customAttributeMap[asLowerCaseString(key)] = customAttribute;
+	auto lowerCaseKey = asLowerCaseString(key);
+	auto it = findCustomAttribute(lowerCaseKey);
+	if (it != outOfLine->customAttributes.end() && it->first == lowerCaseKey) {
+		it->second = customAttribute;
+		return;
+	}
+
+	outOfLine->customAttributes.emplace(it, std::move(lowerCaseKey), customAttribute);
 }
 
 bool ItemAttribute::removeCustomAttribute(const std::string &attributeName) {
-	auto it = customAttributeMap.find(asLowerCaseString(attributeName));
-	if (it == customAttributeMap.end()) {
+	if (!outOfLine) {
+		return false;
+	}
+
+	const auto lowerCaseKey = asLowerCaseString(attributeName);
+	auto it = findCustomAttribute(lowerCaseKey);
+	if (it == outOfLine->customAttributes.end() || it->first != lowerCaseKey) {
 		return false;
 	}
 
-	customAttributeMap.erase(it);
+	outOfLine->customAttributes.erase(it);
 	return true;
 }
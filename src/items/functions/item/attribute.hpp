@@ -13,9 +13,10 @@
 #include "items/functions/item/custom_attribute.hpp"
 #include "utils/tools.hpp"
 
+
 class ItemAttributeHelper {
 public:
-	bool isAttributeInteger(ItemAttribute_t type) const {
+	static constexpr bool isAttributeInteger(ItemAttribute_t type) {
 		switch (type) {
 			case ItemAttribute_t::STORE:
 			case ItemAttribute_t::ACTIONID:
@@ -47,7 +48,7 @@ public:
 		}
 	}
 
-	bool isAttributeString(ItemAttribute_t type) const {
+	static constexpr bool isAttributeString(ItemAttribute_t type) {
 		switch (type) {
 			case ItemAttribute_t::DESCRIPTION:
 			case ItemAttribute_t::TEXT:
@@ -65,75 +66,24 @@ public:
 	}
 };
 
-class Attributes : public ItemAttributeHelper {
-public:
-	explicit Attributes(ItemAttribute_t type) :
-		type(type), value(getDefaultValueForType(type)) { }
-	~Attributes() = default;
-
-	Attributes(const Attributes &i) :
-		type(i.type), value(i.value) { }
-	Attributes(Attributes &&attribute) noexcept :
-		type(attribute.type), value(std::move(attribute.value)) { }
-
-	Attributes &operator=(Attributes &&other) noexcept {
-		type = other.type;
-		value = std::move(other.value);
-		return *this;
-	}
-
-	const ItemAttribute_t &getAttributeType() const {
-		return type;
-	}
-
-	std::variant<int64_t, std::shared_ptr<std::string>> getDefaultValueForType(ItemAttribute_t attributeType) const {
-		ItemAttributeHelper helper;
-		if (helper.isAttributeInteger(attributeType)) {
-			return 0;
-		} else if (helper.isAttributeString(attributeType)) {
-			return std::make_shared<std::string>();
-		} else {
-			return {};
-		}
-	}
-
-	void setValue(int64_t newValue) {
-		if (std::holds_alternative<int64_t>(value)) {
-			value = newValue;
-		}
-	}
-	void setValue(const std::string &newValue) {
-		if (std::holds_alternative<std::shared_ptr<std::string>>(value)) {
-			value = std::make_shared<std::string>(newValue);
-		}
-	}
-	const int64_t &getInteger() const {
-		if (std::holds_alternative<int64_t>(value)) {
-			return std::get<int64_t>(value);
-		}
-		static int64_t emptyValue;
-		return emptyValue;
-	}
-
-	const std::shared_ptr<std::string> getString() const {
-		if (std::holds_alternative<std::shared_ptr<std::string>>(value)) {
-			return std::get<std::shared_ptr<std::string>>(value);
-		}
-		static std::shared_ptr<std::string> emptyPtr;
-		return emptyPtr;
-	}
-
-private:
-	ItemAttribute_t type;
-	std::variant<int64_t, std::shared_ptr<std::string>> value;
-};
+// Custom attributes sorted by their lower case key
+using CustomAttributeList = std::vector<std::pair<std::string, CustomAttribute>>;
 
+/**
+ * Attributes of an item, kept compact since there are tens of millions of
+ * items and most of them carry a couple of small integers (charges,
+ * duration, decay state). A bitmask tells which attributes are set, the
+ * integers sit inline in type order, and the rarer strings and custom
+ * attributes live out of line, allocated on first use.
+ */
 class ItemAttribute : public ItemAttributeHelper {
 public:
 	ItemAttribute() = default;
+	ItemAttribute(const ItemAttribute &other);
+	ItemAttribute &operator=(const ItemAttribute &other);
 
-	// CustomAttribute map methods
-	const std::map<std::string, CustomAttribute, std::less<>> &getCustomAttributeMap() const;
+	// CustomAttribute list methods
+	const CustomAttributeList &getCustomAttributeMap() const;
 	// CustomAttribute object methods
 	const CustomAttribute* getCustomAttribute(const std::string &attributeName) const;
 
@@ -146,30 +96,50 @@ public:
 	bool removeCustomAttribute(const std::string &attributeName);
 
 	void setAttribute(ItemAttribute_t type, int64_t value);
-	void setAttribute(ItemAttribute_t type, const std::string &value);
+	void setAttribute(ItemAttribute_t type, std::string_view value);
 	bool removeAttribute(ItemAttribute_t type);
 
 	const std::string &getAttributeString(ItemAttribute_t type) const;
 	const int64_t &getAttributeValue(ItemAttribute_t type) const;
 
-	const std::vector<Attributes> &getAttributeVector() const {
-		return attributeVector;
+	// One bit per ItemAttribute_t set
+	uint64_t getAttributeBits() const {
+		return attributeBits;
 	}
 
 	bool hasAttribute(ItemAttribute_t type) const {
-		for (const auto &attr : attributeVector) {
-			if (attr.getAttributeType() == type) {
-				return true;
-			}
-		}
-		return false;
+		return (attributeBits & attributeBit(type)) != 0;
 	}
 
-	const Attributes* getAttribute(ItemAttribute_t type) const;
-
-	Attributes &getAttributesByType(ItemAttribute_t type);
+	static constexpr uint64_t attributeBit(ItemAttribute_t type) {
+		return uint64_t { 1 } << static_cast<uint8_t>(type);
+	}
 
 private:
-	std::map<std::string, CustomAttribute, std::less<>> customAttributeMap;
-	std::vector<Attributes> attributeVector;
+	struct OutOfLineAttributes {
+		// In type order
+		std::vector<std::pair<ItemAttribute_t, std::string>> strings;
+		CustomAttributeList customAttributes;
+	};
+
+	static constexpr uint64_t INTEGER_ATTRIBUTE_BITS = [] {
+		uint64_t bits = 0;
+		for (uint8_t type = 0; type < 64; ++type) {
+			if (isAttributeInteger(static_cast<ItemAttribute_t>(type))) {
+				bits |= uint64_t { 1 } << type;
+			}
+		}
+		return bits;
+	}();
+
+	// Position of the type among the integers set, they are kept in type order
+	size_t getIntegerIndex(ItemAttribute_t type) const {
+		return static_cast<size_t>(std::popcount(attributeBits & INTEGER_ATTRIBUTE_BITS & (attributeBit(type) - 1)));
+	}
+	OutOfLineAttributes &getOutOfLine();
+	CustomAttributeList::iterator findCustomAttribute(const std::string &lowerCaseKey);
+
+	uint64_t attributeBits = 0;
+	absl::InlinedVector<int64_t, 3> integers;
+	std::unique_ptr<OutOfLineAttributes> outOfLine;
 };
@@ -10,6 +10,7 @@
 #include "pch.hpp"
 
 #include "items/item.hpp"
+#include "items/item_pools.hpp"
 #include "items/functions/item/item_parse.hpp"
 #include "items/containers/container.hpp"
 #include "items/decay/decay.hpp"
@@ -38,29 +39,29 @@ std::shared_ptr<Item> Item::CreateItem(const uint16_t type, uint16_t count /*= 0
 
 	if (it.id != 0) {
 		if (it.isDepot()) {
-			newItem = std::make_shared<DepotLocker>(type, 4);
+			newItem = makePooled<DepotLocker>(type, 4);
 		} else if (it.isRewardChest()) {
-			newItem = std::make_shared<RewardChest>(type);
+			newItem = makePooled<RewardChest>(type);
 		} else if (it.isContainer()) {
-			newItem = std::make_shared<Container>(type);
+			newItem = makePooled<Container>(type);
 		} else if (it.isTeleport()) {
-			newItem = std::make_shared<Teleport>(type);
+			newItem = makePooled<Teleport>(type);
 		} else if (it.isMagicField()) {
-			newItem = std::make_shared<MagicField>(type);
+			newItem = makePooled<MagicField>(type);
 		} else if (it.isDoor()) {
-			newItem = std::make_shared<Door>(type);
+			newItem = makePooled<Door>(type);
 		} else if (it.isTrashHolder()) {
-			newItem = std::make_shared<TrashHolder>(type);
+			newItem = makePooled<TrashHolder>(type);
 		} else if (it.isMailbox()) {
-			newItem = std::make_shared<Mailbox>(type);
+			newItem = makePooled<Mailbox>(type);
 		} else if (it.isBed()) {
-			newItem = std::make_shared<BedItem>(type);
+			newItem = makePooled<BedItem>(type);
 		} else {
 			auto itemMap = ItemTransformationMap.find(static_cast<ItemID_t>(it.id));
 			if (itemMap != ItemTransformationMap.end()) {
-				newItem = std::make_shared<Item>(itemMap->second, count);
+				newItem = makePooled<Item>(itemMap->second, count);
 			} else {
-				newItem = std::make_shared<Item>(type, count);
+				newItem = makePooled<Item>(type, count);
 			}
 		}
 	} else if (type > 0 && itemPosition) {
@@ -140,7 +141,7 @@ std::shared_ptr<Container> Item::CreateItemAsContainer(const uint16_t type, uint
 		return nullptr;
 	}
 
-	std::shared_ptr<Container> newItem = std::make_shared<Container>(type, size);
+	std::shared_ptr<Container> newItem = makePooled<Container>(type, size);
 	return newItem;
 }
 
@@ -238,19 +239,15 @@ bool Item::equals(std::shared_ptr<Item> compareItem) const {
 		return false;
 	}
 
-	for (const auto &attribute : getAttributeVector()) {
-		for (const auto &compareAttribute : compareItem->getAttributeVector()) {
-			if (attribute.getAttributeType() != compareAttribute.getAttributeType()) {
-				continue;
-			}
-
-			if (isAttributeInteger(attribute.getAttributeType()) && attribute.getInteger() != compareAttribute.getInteger()) {
-				return false;
-			}
+	// Only the attributes both items have are compared
+	for (uint64_t bits = getAttributeBits() & compareItem->getAttributeBits(); bits != 0; bits &= bits - 1) {
+		const auto type = static_cast<ItemAttribute_t>(std::countr_zero(bits));
+		if (isAttributeInteger(type) && getInteger(type) != compareItem->getInteger(type)) {
+			return false;
+		}
 
-			if (isAttributeString(attribute.getAttributeType()) && attribute.getString() != compareAttribute.getString()) {
-				return false;
-			}
+		if (isAttributeString(type) && getString(type) != compareItem->getString(type)) {
+			return false;
 		}
 	}
 
@@ -418,7 +415,7 @@ Attr_ReadValue Item::readAttr(AttrTypes_t attr, PropStream &propStream) {
 		}
 
 		case ATTR_TEXT: {
-			std::string text;
+			std::string_view text;
 			if (!propStream.readString(text)) {
 				return ATTR_READ_ERROR;
 			}
@@ -438,7 +435,7 @@ Attr_ReadValue Item::readAttr(AttrTypes_t attr, PropStream &propStream) {
 		}
 
 		case ATTR_WRITTENBY: {
-			std::string writer;
+			std::string_view writer;
 			if (!propStream.readString(writer)) {
 				return ATTR_READ_ERROR;
 			}
@@ -448,7 +445,7 @@ Attr_ReadValue Item::readAttr(AttrTypes_t attr, PropStream &propStream) {
 		}
 
 		case ATTR_DESC: {
-			std::string text;
+			std::string_view text;
 			if (!propStream.readString(text)) {
 				return ATTR_READ_ERROR;
 			}
@@ -490,7 +487,7 @@ Attr_ReadValue Item::readAttr(AttrTypes_t attr, PropStream &propStream) {
 		}
 
 		case ATTR_NAME: {
-			std::string name;
+			std::string_view name;
 			if (!propStream.readString(name)) {
 				return ATTR_READ_ERROR;
 			}
@@ -500,7 +497,7 @@ Attr_ReadValue Item::readAttr(AttrTypes_t attr, PropStream &propStream) {
 		}
 
 		case ATTR_ARTICLE: {
-			std::string article;
+			std::string_view article;
 			if (!propStream.readString(article)) {
 				return ATTR_READ_ERROR;
 			}
@@ -510,7 +507,7 @@ Attr_ReadValue Item::readAttr(AttrTypes_t attr, PropStream &propStream) {
 		}
 
 		case ATTR_PLURALNAME: {
-			std::string pluralName;
+			std::string_view pluralName;
 			if (!propStream.readString(pluralName)) {
 				return ATTR_READ_ERROR;
 			}
@@ -610,7 +607,7 @@ Attr_ReadValue Item::readAttr(AttrTypes_t attr, PropStream &propStream) {
 		}
 
 		case ATTR_SPECIAL: {
-			std::string special;
+			std::string_view special;
 			if (!propStream.readString(special)) {
 				return ATTR_READ_ERROR;
 			}
@@ -622,7 +619,7 @@ Attr_ReadValue Item::readAttr(AttrTypes_t attr, PropStream &propStream) {
 				// Remove special attribute
 				removeAttribute(ItemAttribute_t::SPECIAL);
 				// Add custom attribute
-				setCustomAttribute("Hireling", static_cast<int64_t>(std::atoi(special.c_str())));
+				setCustomAttribute("Hireling", static_cast<int64_t>(std::atoi(std::string(special).c_str())));
 			}
 			break;
 		}
@@ -766,7 +763,7 @@ Attr_ReadValue Item::readAttr(AttrTypes_t attr, PropStream &propStream) {
 		}
 
 		case ATTR_STORE_INBOX_CATEGORY: {
-			std::string category;
+			std::string_view category;
 			if (!propStream.readString(category)) {
 				g_logger().error("[{}] failed to read store inbox category from item {}", __FUNCTION__, getName());
 				return ATTR_READ_ERROR;
@@ -943,7 +940,7 @@ void Item::serializeAttr(PropWriteStream &propWriteStream) const {
 
 	// Serialize custom attributes, only serialize if the map not is empty
 	if (hasCustomAttribute()) {
-		auto customAttributeMap = getCustomAttributeMap();
+		const auto &customAttributeMap = getCustomAttributeMap();
 		propWriteStream.write<uint8_t>(ATTR_CUSTOM);
 		propWriteStream.write<uint64_t>(customAttributeMap.size());
 		for (const auto &[attributeKey, customAttribute] : customAttributeMap) {
@@ -956,32 +953,32 @@ void Item::serializeAttr(PropWriteStream &propWriteStream) const {
 }
 
 bool Item::hasProperty(ItemProperty prop) const {
-	const ItemType &it = items[id];
+	const uint16_t flags = items.getTypeFlags(id);
 	switch (prop) {
 		case CONST_PROP_BLOCKSOLID:
-			return it.blockSolid;
+			return flags & ITEMTYPE_FLAG_BLOCKSOLID;
 		case CONST_PROP_MOVEABLE:
 			return canBeMoved();
 		case CONST_PROP_HASHEIGHT:
-			return it.hasHeight;
+			return flags & ITEMTYPE_FLAG_HASHEIGHT;
 		case CONST_PROP_BLOCKPROJECTILE:
-			return it.blockProjectile;
+			return flags & ITEMTYPE_FLAG_BLOCKPROJECTILE;
 		case CONST_PROP_BLOCKPATH:
-			return it.blockPathFind;
+			return flags & ITEMTYPE_FLAG_BLOCKPATH;
 		case CONST_PROP_ISVERTICAL:
-			return it.isVertical;
+			return flags & ITEMTYPE_FLAG_VERTICAL;
 		case CONST_PROP_ISHORIZONTAL:
-			return it.isHorizontal;
+			return flags & ITEMTYPE_FLAG_HORIZONTAL;
 		case CONST_PROP_IMMOVABLEBLOCKSOLID:
-			return it.blockSolid && !canBeMoved();
+			return (flags & ITEMTYPE_FLAG_BLOCKSOLID) && !canBeMoved();
 		case CONST_PROP_IMMOVABLEBLOCKPATH:
-			return it.blockPathFind && !canBeMoved();
+			return (flags & ITEMTYPE_FLAG_BLOCKPATH) && !canBeMoved();
 		case CONST_PROP_IMMOVABLENOFIELDBLOCKPATH:
-			return !it.isMagicField() && it.blockPathFind && !canBeMoved();
+			return (flags & (ITEMTYPE_FLAG_MAGICFIELD | ITEMTYPE_FLAG_BLOCKPATH)) == ITEMTYPE_FLAG_BLOCKPATH && !canBeMoved();
 		case CONST_PROP_NOFIELDBLOCKPATH:
-			return !it.isMagicField() && it.blockPathFind;
+			return (flags & (ITEMTYPE_FLAG_MAGICFIELD | ITEMTYPE_FLAG_BLOCKPATH)) == ITEMTYPE_FLAG_BLOCKPATH;
 		case CONST_PROP_SUPPORTHANGABLE:
-			return it.isHorizontal || it.isVertical;
+			return flags & (ITEMTYPE_FLAG_HORIZONTAL | ITEMTYPE_FLAG_VERTICAL);
 		default:
 			return false;
 	}
@@ -1009,6 +1006,11 @@ uint32_t Item::getWeight() const {
 
 std::vector<std::pair<std::string, std::string>>
 Item::getDescriptions(const ItemType &it, std::shared_ptr<Item> item /*= nullptr*/) {
+	// Without an item the inspection only depends on the type, as in the cyclopedia and the market
+	if (!item && it.inspectDescriptions) {
+		return *it.inspectDescriptions;
+	}
+
 	std::ostringstream ss;
 	std::vector<std::pair<std::string, std::string>> descriptions;
 	bool isTradeable = true;
@@ -1794,6 +1796,9 @@ Item::getDescriptions(const ItemType &it, std::shared_ptr<Item> item /*= nullptr
 		}
 	}
 	descriptions.shrink_to_fit();
+	if (!item) {
+		it.inspectDescriptions = descriptions;
+	}
 	return descriptions;
 }
 
@@ -2938,9 +2943,40 @@ std::string Item::getDescription(const ItemType &it, int32_t lookDistance, std::
 	return s.str();
 }
 
+bool Item::isDescriptionCacheable(const ItemType &it) const {
+	// Durations count down and container weights follow their contents, runes list the vocations of reloadable spells
+	if (it.showDuration || it.isContainer() || it.isRune()) {
+		return false;
+	}
+	return !hasAttribute(ItemAttribute_t::DURATION) && !hasAttribute(ItemAttribute_t::DURATION_TIMESTAMP);
+}
+
 std::string Item::getDescription(int32_t lookDistance) {
 	const ItemType &it = items[id];
-	return getDescription(it, lookDistance, getItem());
+	if (!isDescriptionCacheable(it) || getContainer()) {
+		return getDescription(it, lookDistance, getItem());
+	}
+
+	// The description only tells apart looks from next to the item, within reading range and farther
+	const uint8_t lookRange = lookDistance <= 1 ? 0 : (lookDistance <= 4 ? 1 : 2);
+	if (!isInitializedAttributePtr() && !it.hasSubType()) {
+		// Nothing sets this item apart from the others of its type
+		auto &description = it.lookDescriptions[lookRange];
+		if (description.empty()) {
+			description = getDescription(it, lookDistance, getItem());
+		}
+		return description;
+	}
+
+	const int32_t subType = getSubType();
+	const uint32_t itemsGeneration = Item::items.getGeneration();
+	if (descriptionCache && descriptionCache->attributeVersion == getAttributeVersion() && descriptionCache->itemsGeneration == itemsGeneration && descriptionCache->subType == subType && descriptionCache->lookRange == lookRange) {
+		return descriptionCache->text;
+	}
+
+	auto text = getDescription(it, lookDistance, getItem());
+	descriptionCache = std::make_unique<DescriptionCache>(DescriptionCache { text, getAttributeVersion(), itemsGeneration, subType, lookRange });
+	return text;
 }
 
 std::string Item::getNameDescription(const ItemType &it, std::shared_ptr<Item> item /*= nullptr*/, int32_t subType /*= -1*/, bool addArticle /*= true*/) {
@@ -3130,18 +3166,16 @@ bool Item::hasMarketAttributes() const {
 		return true;
 	}
 
-	for (const auto &attribute : getAttributeVector()) {
-		if (attribute.getAttributeType() == ItemAttribute_t::CHARGES && static_cast<uint16_t>(attribute.getInteger()) != items[id].charges) {
-			return false;
-		}
+	if (hasAttribute(ItemAttribute_t::CHARGES) && static_cast<uint16_t>(getInteger(ItemAttribute_t::CHARGES)) != items[id].charges) {
+		return false;
+	}
 
-		if (attribute.getAttributeType() == ItemAttribute_t::DURATION && static_cast<uint32_t>(attribute.getInteger()) != getDefaultDuration()) {
-			return false;
-		}
+	if (hasAttribute(ItemAttribute_t::DURATION) && static_cast<uint32_t>(getInteger(ItemAttribute_t::DURATION)) != getDefaultDuration()) {
+		return false;
+	}
 
-		if (attribute.getAttributeType() == ItemAttribute_t::TIER && static_cast<uint8_t>(attribute.getInteger()) != getTier()) {
-			return false;
-		}
+	if (hasAttribute(ItemAttribute_t::TIER) && static_cast<uint8_t>(getInteger(ItemAttribute_t::TIER)) != getTier()) {
+		return false;
 	}
 
 	if (hasImbuements()) {
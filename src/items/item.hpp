@@ -17,6 +17,7 @@
 #include "lua/scripts/luascript.hpp"
 #include "utils/tools.hpp"
 #include "io/fileloader.hpp"
+#include "lib/profiling/allocation_profiler.hpp"
 
 class Creature;
 class Player;
@@ -31,7 +32,7 @@ class BedItem;
 class Imbuement;
 class Item;
 
-// This class ItemProperties that serves as an interface to access and modify attributes of an item. The item's attributes are stored in an instance of ItemAttribute. The class ItemProperties has methods to get and set integer and string attributes, check if an attribute exists, remove an attribute, get the underlying attribute bits, and get a vector of attributes. It also has methods to get and set custom attributes, which are stored in a std::map<std::string, CustomAttribute, std::less<>>. The class has a data member attributePtr of type std::unique_ptr<ItemAttribute> that stores a pointer to the item's attributes methods.
+// This class ItemProperties that serves as an interface to access and modify attributes of an item. The item's attributes are stored in an instance of ItemAttribute. The class ItemProperties has methods to get and set integer and string attributes, check if an attribute exists, remove an attribute, get the underlying attribute bits, and get a vector of attributes. It also has methods to get and set custom attributes, which are stored in a CustomAttributeList sorted by key. The class has a data member attributePtr of type std::unique_ptr<ItemAttribute> that stores a pointer to the item's attributes methods.
 class ItemProperties {
 public:
 	template <typename T>
@@ -59,27 +60,29 @@ public:
 	void removeAttribute(ItemAttribute_t type) {
 		if (attributePtr) {
 			attributePtr->removeAttribute(type);
+			bumpAttributeVersion();
 		}
 	}
 
 	template <typename GenericAttribute>
 	void setAttribute(ItemAttribute_t type, GenericAttribute genericAttribute) {
 		initAttributePtr()->setAttribute(type, genericAttribute);
+		bumpAttributeVersion();
 	}
 
 	bool isAttributeInteger(ItemAttribute_t type) const {
-		return initAttributePtr()->isAttributeInteger(type);
+		return ItemAttributeHelper::isAttributeInteger(type);
 	}
 
 	bool isAttributeString(ItemAttribute_t type) const {
-		return initAttributePtr()->isAttributeString(type);
+		return ItemAttributeHelper::isAttributeString(type);
 	}
 
 	// Custom Attributes
-	const std::map<std::string, CustomAttribute, std::less<>> &getCustomAttributeMap() const {
-		static std::map<std::string, CustomAttribute, std::less<>> map = {};
+	const CustomAttributeList &getCustomAttributeMap() const {
+		static const CustomAttributeList emptyList;
 		if (!attributePtr) {
-			return map;
+			return emptyList;
 		}
 		return attributePtr->getCustomAttributeMap();
 	}
@@ -94,21 +97,33 @@ public:
 	template <typename GenericType>
 	void setCustomAttribute(const std::string &key, GenericType value) {
 		initAttributePtr()->setCustomAttribute(key, value);
+		bumpAttributeVersion();
 	}
 
 	void addCustomAttribute(const std::string &key, const CustomAttribute &customAttribute) {
 		initAttributePtr()->addCustomAttribute(key, customAttribute);
+		bumpAttributeVersion();
 	}
 
 	bool hasCustomAttribute() const {
 		return !getCustomAttributeMap().empty();
 	}
 
+	// True when every attribute set on the item is one of the given types
+	bool hasOnlyAttributes(std::span<const ItemAttribute_t> types) const {
+		uint64_t allowed = 0;
+		for (const auto type : types) {
+			allowed |= ItemAttribute::attributeBit(type);
+		}
+		return (getAttributeBits() & ~allowed) == 0;
+	}
+
 	bool removeCustomAttribute(const std::string &attributeName) {
 		if (!attributePtr) {
 			return false;
 		}
 
+		bumpAttributeVersion();
 		return attributePtr->removeCustomAttribute(attributeName);
 	}
 
@@ -172,13 +187,8 @@ protected:
 		return attributePtr;
 	}
 
-	const std::vector<Attributes> &getAttributeVector() const {
-		static std::vector<Attributes> emptyVector = {};
-		if (!attributePtr) {
-			return emptyVector;
-		}
-
-		return attributePtr->getAttributeVector();
+	uint64_t getAttributeBits() const {
+		return attributePtr ? attributePtr->getAttributeBits() : 0;
 	}
 
 	const int64_t &getInteger(ItemAttribute_t type) const {
@@ -206,13 +216,26 @@ protected:
 		return true;
 	}
 
+	// Changes with every write to the attributes, for what is derived from them. Versions are unique across items,
+	// 0 only stands for attributes never written
+	uint32_t getAttributeVersion() const {
+		return attributeVersion;
+	}
+
 private:
+	void bumpAttributeVersion() {
+		attributeVersion = lastAttributeVersion.fetch_add(1, std::memory_order_relaxed) + 1;
+	}
+
+	static inline std::atomic<uint32_t> lastAttributeVersion = 0;
+
 	std::unique_ptr<ItemAttribute> attributePtr;
+	uint32_t attributeVersion = 0;
 
 	friend class Item;
 };
 
-class Item : virtual public Thing, public ItemProperties, public SharedObject {
+class Item : virtual public Thing, public ItemProperties, public SharedObject, public AllocationTracked<Item> {
 public:
 	// Factory member to create item of right type based on type
 	static std::shared_ptr<Item> CreateItem(const uint16_t type, uint16_t count = 0, Position* itemPosition = nullptr);
@@ -402,34 +425,34 @@ public:
 
 	bool hasProperty(ItemProperty prop) const;
 	bool isBlocking() const {
-		return items[id].blockSolid;
+		return items.hasTypeFlag(id, ITEMTYPE_FLAG_BLOCKSOLID);
 	}
 	bool isStackable() const {
-		return items[id].stackable;
+		return items.hasTypeFlag(id, ITEMTYPE_FLAG_STACKABLE);
 	}
 	bool isStowable() const {
 		return items[id].stackable && items[id].wareId > 0;
 	}
 	bool isAlwaysOnTop() const {
-		return items[id].alwaysOnTopOrder != 0;
+		return items.hasTypeFlag(id, ITEMTYPE_FLAG_ALWAYSONTOP);
 	}
 	bool isGroundTile() const {
-		return items[id].isGroundTile();
+		return items.hasTypeFlag(id, ITEMTYPE_FLAG_GROUND);
 	}
 	bool isMagicField() const {
-		return items[id].isMagicField();
+		return items.hasTypeFlag(id, ITEMTYPE_FLAG_MAGICFIELD);
 	}
 	bool isWrapContainer() const {
 		return items[id].wrapContainer;
 	}
 	bool isMoveable() const {
-		return items[id].moveable;
+		return items.hasTypeFlag(id, ITEMTYPE_FLAG_MOVEABLE);
 	}
 	bool isCorpse() const {
 		return items[id].isCorpse;
 	}
 	bool isPickupable() const {
-		return items[id].pickupable;
+		return items.hasTypeFlag(id, ITEMTYPE_FLAG_PICKUPABLE);
 	}
 	bool isMultiUse() const {
 		return items[id].multiUse;
@@ -689,10 +712,26 @@ protected:
 	bool isLootTrackeable = false;
 	bool decayDisabled = false;
 
+	// Bucket of the decay wheel holding the item and its position in it, see Decay
+	uint32_t decayTick = 0;
+	uint32_t decayIndex = std::numeric_limits<uint32_t>::max();
+
 private:
+	// The last look description, valid while its key holds
+	struct DescriptionCache {
+		std::string text;
+		uint32_t attributeVersion;
+		uint32_t itemsGeneration;
+		int32_t subType;
+		uint8_t lookRange;
+	};
+
 	void setImbuement(uint8_t slot, uint16_t imbuementId, uint32_t duration);
 	// Don't add variables here, use the ItemAttribute class.
 	std::string getWeightDescription(uint32_t weight) const;
+	bool isDescriptionCacheable(const ItemType &it) const;
+
+	std::unique_ptr<DescriptionCache> descriptionCache;
 
 	friend class Decay;
 	friend class MapCache;
@@ -0,0 +1,50 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "utils/object_pool.hpp"
+
+// Every item type created through makePooled, with the name its pool stats are reported under
+
+class Item;
+class Container;
+class DepotChest;
+class DepotLocker;
+class Inbox;
+class Reward;
+class RewardChest;
+class Teleport;
+class MagicField;
+class Door;
+class TrashHolder;
+class Mailbox;
+class BedItem;
+
+#define ITEM_POOL_NAME(type)                                   \
+	template <>                                                \
+	struct ObjectPoolName<type> {                              \
+		static constexpr std::string_view value = #type;       \
+	}
+
+ITEM_POOL_NAME(Item);
+ITEM_POOL_NAME(Container);
+ITEM_POOL_NAME(DepotChest);
+ITEM_POOL_NAME(DepotLocker);
+ITEM_POOL_NAME(Inbox);
+ITEM_POOL_NAME(Reward);
+ITEM_POOL_NAME(RewardChest);
+ITEM_POOL_NAME(Teleport);
+ITEM_POOL_NAME(MagicField);
+ITEM_POOL_NAME(Door);
+ITEM_POOL_NAME(TrashHolder);
+ITEM_POOL_NAME(Mailbox);
+ITEM_POOL_NAME(BedItem);
+
+#undef ITEM_POOL_NAME
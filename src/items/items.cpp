@@ -10,6 +10,7 @@
 #include "pch.hpp"
 
 #include "items/functions/item/item_parse.hpp"
+#include "protobuf/appearances.pb.h"
 #include "items/items.hpp"
 #include "items/weapons/weapons.hpp"
 #include "game/game.hpp"
@@ -19,9 +20,11 @@ Items::Items() = default;
 
 void Items::clear() {
 	items.clear();
+	typeFlags.clear();
 	ladders.clear();
 	dummys.clear();
 	nameToItems.clear();
+	++generation;
 }
 
 using LootTypeNames = phmap::flat_hash_map<std::string, ItemTypes_t>;
@@ -64,7 +67,10 @@ ItemTypes_t Items::getLootType(const std::string &strValue) {
 
 bool Items::reload() {
 	clear();
-	loadFromProtobuf();
+	// The appearances are not kept after the startup, they are parsed again
+	if (g_game().loadAppearanceProtobuf(g_configManager().getString(CORE_DIRECTORY) + "/items/appearances.dat") != ERROR_NONE) {
+		return false;
+	}
 
 	if (!loadFromXml()) {
 		return false;
@@ -73,13 +79,11 @@ bool Items::reload() {
 	return true;
 }
 
-void Items::loadFromProtobuf() {
+void Items::loadFromProtobuf(const Canary::protobuf::appearances::Appearances &appearances) {
 	using namespace Canary::protobuf::appearances;
 
 	bool supportAnimation = g_configManager().getBoolean(OLD_PROTOCOL);
-	for (uint32_t it = 0; it < g_game().appearances.object_size(); ++it) {
-		Appearance object = g_game().appearances.object(it);
-
+	for (const Appearance &object : appearances.object()) {
 		// This scenario should never happen but on custom assets this can break the loader.
 		if (!object.has_flags()) {
 			g_logger().warn("[Items::loadFromProtobuf] - Item with id '{}' is invalid and was ignored.", object.id());
@@ -109,7 +113,7 @@ void Items::loadFromProtobuf() {
 		// This attribute is only used on 10x protocol, so we should not waste our time iterating it when it's disabled.
 		if (supportAnimation) {
 			for (uint32_t frame_it = 0; frame_it < object.frame_group_size(); ++frame_it) {
-				FrameGroup objectFrame = object.frame_group(frame_it);
+				const FrameGroup &objectFrame = object.frame_group(frame_it);
 				if (!objectFrame.has_sprite_info()) {
 					continue;
 				}
@@ -189,17 +193,25 @@ void Items::loadFromProtobuf() {
 	}
 
 	items.shrink_to_fit();
+	buildTypeFlags();
 }
 
 bool Items::loadFromXml() {
 	pugi::xml_document doc;
+	return parseXmlFile(doc) && loadFromXml(doc);
+}
+
+bool Items::parseXmlFile(pugi::xml_document &doc) {
 	auto folder = g_configManager().getString(CORE_DIRECTORY) + "/items/items.xml";
 	pugi::xml_parse_result result = doc.load_file(folder.c_str());
 	if (!result) {
 		printXMLError(__FUNCTION__, folder, result);
 		return false;
 	}
+	return true;
+}
 
+bool Items::loadFromXml(const pugi::xml_document &doc) {
 	for (auto itemNode : doc.child("items").children()) {
 		if (auto idAttribute = itemNode.attribute("id")) {
 			parseItemNode(itemNode, pugi::cast<uint16_t>(idAttribute.value()));
@@ -226,9 +238,44 @@ bool Items::loadFromXml() {
 			parseItemNode(itemNode, id++);
 		}
 	}
+
+	buildTypeFlags();
 	return true;
 }
 
+static uint16_t getItemTypeFlags(const ItemType &type) {
+	const auto flag = [](bool value, ItemTypeFlag_t typeFlag) {
+		return value ? static_cast<uint16_t>(typeFlag) : uint16_t { 0 };
+	};
+
+	return flag(type.blockSolid, ITEMTYPE_FLAG_BLOCKSOLID)
+		| flag(type.blockProjectile, ITEMTYPE_FLAG_BLOCKPROJECTILE)
+		| flag(type.blockPathFind, ITEMTYPE_FLAG_BLOCKPATH)
+		| flag(type.hasHeight, ITEMTYPE_FLAG_HASHEIGHT)
+		| flag(type.isVertical, ITEMTYPE_FLAG_VERTICAL)
+		| flag(type.isHorizontal, ITEMTYPE_FLAG_HORIZONTAL)
+		| flag(type.moveable, ITEMTYPE_FLAG_MOVEABLE)
+		| flag(type.isMagicField(), ITEMTYPE_FLAG_MAGICFIELD)
+		| flag(type.isGroundTile(), ITEMTYPE_FLAG_GROUND)
+		| flag(type.alwaysOnTopOrder != 0, ITEMTYPE_FLAG_ALWAYSONTOP)
+		| flag(type.floorChange != TILESTATE_NONE, ITEMTYPE_FLAG_FLOORCHANGE)
+		| flag(type.stackable, ITEMTYPE_FLAG_STACKABLE)
+		| flag(type.pickupable, ITEMTYPE_FLAG_PICKUPABLE);
+}
+
+void Items::buildTypeFlags() {
+	typeFlags.resize(items.size());
+	for (size_t id = 0; id < items.size(); ++id) {
+		typeFlags[id] = getItemTypeFlags(items[id]);
+	}
+}
+
+void Items::updateTypeFlags(uint16_t id) {
+	if (id < items.size() && id < typeFlags.size()) {
+		typeFlags[id] = getItemTypeFlags(items[id]);
+	}
+}
+
 void Items::buildInventoryList() {
 	inventory.reserve(items.size());
 	for (const auto &type : items) {
@@ -324,7 +371,7 @@ const ItemType &Items::getItemType(size_t id) const {
 }
 
 uint16_t Items::getItemIdByName(const std::string &name) {
-	auto result = nameToItems.find(asLowerCaseString(name));
+	auto result = nameToItems.find(name);
 
 	if (result == nameToItems.end()) {
 		return 0;
@@ -13,6 +13,11 @@
 #include "utils/utils_definitions.hpp"
 #include "declarations.hpp"
 #include "game/movement/position.hpp"
+#include "utils/tools.hpp"
+
+namespace Canary::protobuf::appearances {
+	class Appearances;
+}
 
 struct Abilities {
 public:
@@ -244,6 +249,11 @@ public:
 	std::unique_ptr<Abilities> abilities;
 	std::shared_ptr<ConditionDamage> conditionDamage;
 
+	// Look descriptions of the plain item by look range, built on first look
+	mutable std::array<std::string, 3> lookDescriptions;
+	// Inspection of the type without an item, built on first inspection
+	mutable std::optional<std::vector<std::pair<std::string, std::string>>> inspectDescriptions;
+
 	uint32_t levelDoor = 0;
 	uint32_t decayTime = 0;
 	uint32_t wieldInfo = 0;
@@ -344,9 +354,27 @@ public:
 	bool isWrapKit = false;
 };
 
+// ItemType fields the tile and pathing code checks all the time, packed per item id by Items::buildTypeFlags
+enum ItemTypeFlag_t : uint16_t {
+	ITEMTYPE_FLAG_BLOCKSOLID = 1 << 0,
+	ITEMTYPE_FLAG_BLOCKPROJECTILE = 1 << 1,
+	ITEMTYPE_FLAG_BLOCKPATH = 1 << 2,
+	ITEMTYPE_FLAG_HASHEIGHT = 1 << 3,
+	ITEMTYPE_FLAG_VERTICAL = 1 << 4,
+	ITEMTYPE_FLAG_HORIZONTAL = 1 << 5,
+	ITEMTYPE_FLAG_MOVEABLE = 1 << 6,
+	ITEMTYPE_FLAG_MAGICFIELD = 1 << 7,
+	ITEMTYPE_FLAG_GROUND = 1 << 8,
+	ITEMTYPE_FLAG_ALWAYSONTOP = 1 << 9,
+	ITEMTYPE_FLAG_FLOORCHANGE = 1 << 10,
+	ITEMTYPE_FLAG_STACKABLE = 1 << 11,
+	ITEMTYPE_FLAG_PICKUPABLE = 1 << 12,
+};
+
 class Items {
 public:
-	using NameMap = std::unordered_multimap<std::string, uint16_t>;
+	// Keys in lower case, looked up in any case
+	using NameMap = std::unordered_multimap<std::string, uint16_t, CaseInsensitiveHash, CaseInsensitiveEqual>;
 	using InventoryVector = std::vector<uint16_t>;
 
 	Items();
@@ -358,7 +386,12 @@ public:
 	bool reload();
 	void clear();
 
-	void loadFromProtobuf();
+	// Changes whenever the item types are cleared, what was derived from them is stale
+	uint32_t getGeneration() const {
+		return generation;
+	}
+
+	void loadFromProtobuf(const Canary::protobuf::appearances::Appearances &appearances);
 
 	const ItemType &operator[](size_t id) const {
 		return getItemType(id);
@@ -375,11 +408,27 @@ public:
 	 */
 	bool hasItemType(size_t hasId) const;
 
+	// ItemTypeFlag_t bits of the item type, reading them never touches the ItemType itself
+	uint16_t getTypeFlags(size_t id) const {
+		return id < typeFlags.size() ? typeFlags[id] : 0;
+	}
+	bool hasTypeFlag(size_t id, ItemTypeFlag_t flag) const {
+		return (getTypeFlags(id) & flag) != 0;
+	}
+	// Must run again whenever item types change, loadFromProtobuf and loadFromXml call it
+	void buildTypeFlags();
+	// Same as buildTypeFlags, for a single item type changed at runtime
+	void updateTypeFlags(uint16_t id);
+
 	uint16_t getItemIdByName(const std::string &name);
 
 	ItemTypes_t getLootType(const std::string &strValue);
 
 	bool loadFromXml();
+	// Only reads the file, it does not touch the item types and may run on any thread
+	static bool parseXmlFile(pugi::xml_document &doc);
+	// Applies a document read by parseXmlFile, after loadFromProtobuf
+	bool loadFromXml(const pugi::xml_document &doc);
 	void parseItemNode(const pugi::xml_node &itemNode, uint16_t id);
 
 	void buildInventoryList();
@@ -409,7 +458,9 @@ public:
 
 private:
 	std::vector<ItemType> items;
+	std::vector<uint16_t> typeFlags;
 	std::vector<uint16_t> ladders;
 	std::unordered_map<uint16_t, uint16_t> dummys;
 	InventoryVector inventory;
+	uint32_t generation = 0;
 };
@@ -431,10 +431,32 @@ enum TileFlags_t : uint32_t {
 	TILESTATE_IMMOVABLENOFIELDBLOCKPATH = 1 << 21,
 	TILESTATE_NOFIELDBLOCKPATH = 1 << 22,
 	TILESTATE_SUPPORTS_HANGABLE = 1 << 23,
+	TILESTATE_BLOCKPROJECTILE = 1 << 24,
 
 	TILESTATE_FLOORCHANGE = TILESTATE_FLOORCHANGE_DOWN | TILESTATE_FLOORCHANGE_NORTH | TILESTATE_FLOORCHANGE_SOUTH | TILESTATE_FLOORCHANGE_EAST | TILESTATE_FLOORCHANGE_WEST | TILESTATE_FLOORCHANGE_SOUTH_ALT | TILESTATE_FLOORCHANGE_EAST_ALT,
 };
 
+// Tile states mirrored into the per floor bitmaps, see Floor::getFlagMask
+enum SectorFlag_t : uint8_t {
+	SECTOR_FLAG_BLOCKSOLID,
+	SECTOR_FLAG_BLOCKPROJECTILE,
+	SECTOR_FLAG_BLOCKPATH,
+	SECTOR_FLAG_FLOORCHANGE,
+	SECTOR_FLAG_PROTECTIONZONE,
+
+	SECTOR_FLAG_COUNT,
+};
+
+constexpr std::array<uint32_t, SECTOR_FLAG_COUNT> SECTOR_FLAG_TILESTATES = {
+	TILESTATE_BLOCKSOLID,
+	TILESTATE_BLOCKPROJECTILE,
+	TILESTATE_BLOCKPATH,
+	TILESTATE_FLOORCHANGE,
+	TILESTATE_PROTECTIONZONE,
+};
+
+constexpr uint32_t SECTOR_TRACKED_TILESTATES = TILESTATE_BLOCKSOLID | TILESTATE_BLOCKPROJECTILE | TILESTATE_BLOCKPATH | TILESTATE_FLOORCHANGE | TILESTATE_PROTECTIONZONE;
+
 enum ZoneType_t {
 	ZONE_PROTECTION,
 	ZONE_NOPVP,
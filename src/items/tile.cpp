@@ -301,7 +301,7 @@ std::shared_ptr<Item> Tile::getItemByTopOrder(int32_t topOrder) {
 	// 3: doors etc
 	// 4: creatures
 	if (TileItemVector* items = getItemList()) {
-		for (auto it = ItemVector::const_reverse_iterator(items->getEndTopItem()), end = ItemVector::const_reverse_iterator(items->getBeginTopItem()); it != end; ++it) {
+		for (auto it = TileItemVector::const_reverse_iterator(items->getEndTopItem()), end = TileItemVector::const_reverse_iterator(items->getBeginTopItem()); it != end; ++it) {
 			if (Item::items[(*it)->getID()].alwaysOnTopOrder == topOrder) {
 				return (*it);
 			}
@@ -318,14 +318,14 @@ std::shared_ptr<Thing> Tile::getTopVisibleThing(std::shared_ptr<Creature> creatu
 
 	TileItemVector* items = getItemList();
 	if (items) {
-		for (ItemVector::const_iterator it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
+		for (TileItemVector::const_iterator it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
 			const ItemType &iit = Item::items[(*it)->getID()];
 			if (!iit.lookThrough) {
 				return (*it);
 			}
 		}
 
-		for (auto it = ItemVector::const_reverse_iterator(items->getEndTopItem()), end = ItemVector::const_reverse_iterator(items->getBeginTopItem()); it != end; ++it) {
+		for (auto it = TileItemVector::const_reverse_iterator(items->getEndTopItem()), end = TileItemVector::const_reverse_iterator(items->getBeginTopItem()); it != end; ++it) {
 			const ItemType &iit = Item::items[(*it)->getID()];
 			if (!iit.lookThrough) {
 				return (*it);
@@ -355,15 +355,19 @@ void Tile::onAddTileItem(std::shared_ptr<Item> item) {
 	SpectatorHashSet spectators;
 	g_game().map.getSpectators(spectators, cylinderMapPos, true);
 
-	// send to client
-	for (std::shared_ptr<Creature> spectator : spectators) {
-		if (std::shared_ptr<Player> tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendAddTileItem(static_self_cast<Tile>(), cylinderMapPos, item);
+	// send to client, a batch refreshes the whole tile once it ends
+	if (g_game().map.isBatchingTileUpdates()) {
+		g_game().map.addBatchedTile(cylinderMapPos);
+	} else {
+		for (const auto &spectator : spectators) {
+			if (std::shared_ptr<Player> tmpPlayer = spectator->getPlayer()) {
+				tmpPlayer->sendAddTileItem(static_self_cast<Tile>(), cylinderMapPos, item);
+			}
 		}
 	}
 
 	// event methods
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->onAddTileItem(static_self_cast<Tile>(), cylinderMapPos);
 	}
 
@@ -441,14 +445,18 @@ void Tile::onUpdateTileItem(std::shared_ptr<Item> oldItem, const ItemType &oldTy
 	g_game().map.getSpectators(spectators, cylinderMapPos, true);
 
 	// send to client
-	for (std::shared_ptr<Creature> spectator : spectators) {
-		if (std::shared_ptr<Player> tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendUpdateTileItem(static_self_cast<Tile>(), cylinderMapPos, newItem);
+	if (g_game().map.isBatchingTileUpdates()) {
+		g_game().map.addBatchedTile(cylinderMapPos);
+	} else {
+		for (const auto &spectator : spectators) {
+			if (std::shared_ptr<Player> tmpPlayer = spectator->getPlayer()) {
+				tmpPlayer->sendUpdateTileItem(static_self_cast<Tile>(), cylinderMapPos, newItem);
+			}
 		}
 	}
 
 	// event methods
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->onUpdateTileItem(static_self_cast<Tile>(), cylinderMapPos, oldItem, oldType, newItem, newType);
 	}
 }
@@ -463,7 +471,7 @@ void Tile::onRemoveTileItem(const SpectatorHashSet &spectators, const std::vecto
 			}
 		}
 	}
-	for (const auto zone : getZones()) {
+	for (const auto &zone : getZones()) {
 		zone->itemRemoved(item);
 	}
 
@@ -472,16 +480,20 @@ void Tile::onRemoveTileItem(const SpectatorHashSet &spectators, const std::vecto
 	const Position &cylinderMapPos = getPosition();
 	const ItemType &iType = Item::items[item->getID()];
 
-	// send to client
-	size_t i = 0;
-	for (std::shared_ptr<Creature> spectator : spectators) {
-		if (std::shared_ptr<Player> tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendRemoveTileThing(cylinderMapPos, oldStackPosVector[i++]);
+	// send to client, oldStackPosVector is left empty in a batch
+	if (g_game().map.isBatchingTileUpdates()) {
+		g_game().map.addBatchedTile(cylinderMapPos);
+	} else {
+		size_t i = 0;
+		for (const auto &spectator : spectators) {
+			if (std::shared_ptr<Player> tmpPlayer = spectator->getPlayer()) {
+				tmpPlayer->sendRemoveTileThing(cylinderMapPos, oldStackPosVector[i++]);
+			}
 		}
 	}
 
 	// event methods
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->onRemoveTileItem(static_self_cast<Tile>(), cylinderMapPos, iType, item);
 	}
 
@@ -540,12 +552,12 @@ void Tile::onUpdateTile(const SpectatorHashSet &spectators) {
 	const Position &cylinderMapPos = getPosition();
 
 	// send to clients
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->getPlayer()->sendUpdateTile(getTile(), cylinderMapPos);
 	}
 }
 
-ReturnValue Tile::queryAdd(int32_t, const std::shared_ptr<Thing> &thing, uint32_t, uint32_t tileFlags, std::shared_ptr<Creature>) {
+ReturnValue Tile::queryAdd(int32_t, const std::shared_ptr<Thing> &thing, uint32_t, uint32_t tileFlags, const std::shared_ptr<Creature> &) {
 	if (hasBitSet(FLAG_NOLIMIT, tileFlags)) {
 		return RETURNVALUE_NOERROR;
 	}
@@ -700,16 +712,16 @@ ReturnValue Tile::queryAdd(int32_t, const std::shared_ptr<Thing> &thing, uint32_
 		} else {
 			// FLAG_IGNOREBLOCKITEM is set
 			if (ground) {
-				const ItemType &iiType = Item::items[ground->getID()];
-				if (iiType.blockSolid && (!iiType.moveable || ground->hasAttribute(ItemAttribute_t::UNIQUEID))) {
+				const uint16_t groundFlags = Item::items.getTypeFlags(ground->getID());
+				if ((groundFlags & ITEMTYPE_FLAG_BLOCKSOLID) && (!(groundFlags & ITEMTYPE_FLAG_MOVEABLE) || ground->hasAttribute(ItemAttribute_t::UNIQUEID))) {
 					return RETURNVALUE_NOTPOSSIBLE;
 				}
 			}
 
 			if (const auto items = getItemList()) {
 				for (auto &item : *items) {
-					const ItemType &iiType = Item::items[item->getID()];
-					if (iiType.blockSolid && (!iiType.moveable || item->hasAttribute(ItemAttribute_t::UNIQUEID))) {
+					const uint16_t itemFlags = Item::items.getTypeFlags(item->getID());
+					if ((itemFlags & ITEMTYPE_FLAG_BLOCKSOLID) && (!(itemFlags & ITEMTYPE_FLAG_MOVEABLE) || item->hasAttribute(ItemAttribute_t::UNIQUEID))) {
 						return RETURNVALUE_NOTPOSSIBLE;
 					}
 				}
@@ -761,12 +773,13 @@ ReturnValue Tile::queryAdd(int32_t, const std::shared_ptr<Thing> &thing, uint32_
 
 			if (items) {
 				for (auto &tileItem : *items) {
-					const ItemType &iiType = Item::items[tileItem->getID()];
-					if (!iiType.blockSolid) {
+					const uint16_t tileItemFlags = Item::items.getTypeFlags(tileItem->getID());
+					if (!(tileItemFlags & ITEMTYPE_FLAG_BLOCKSOLID)) {
 						continue;
 					}
 
-					if (iiType.pickupable && !item->isMagicField() && !item->isBlocking()) {
+					const bool tileItemPickupable = tileItemFlags & ITEMTYPE_FLAG_PICKUPABLE;
+					if (tileItemPickupable && !item->isMagicField() && !item->isBlocking()) {
 						continue;
 					}
 
@@ -774,7 +787,7 @@ ReturnValue Tile::queryAdd(int32_t, const std::shared_ptr<Thing> &thing, uint32_
 						return RETURNVALUE_NOTENOUGHROOM;
 					}
 
-					if (!iiType.hasHeight || iiType.pickupable) {
+					if (!(tileItemFlags & ITEMTYPE_FLAG_HASHEIGHT) || tileItemPickupable) {
 						return RETURNVALUE_NOTENOUGHROOM;
 					}
 				}
@@ -801,7 +814,7 @@ ReturnValue Tile::queryMaxCount(int32_t, const std::shared_ptr<Thing> &, uint32_
 	return RETURNVALUE_NOERROR;
 }
 
-ReturnValue Tile::queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t tileFlags, std::shared_ptr<Creature> /*= nullptr */) {
+ReturnValue Tile::queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t tileFlags, const std::shared_ptr<Creature> & /*= nullptr */) {
 	int32_t index = getThingIndex(thing);
 	if (index == -1) {
 		return RETURNVALUE_NOTPOSSIBLE;
@@ -944,7 +957,7 @@ void Tile::addThing(int32_t, std::shared_ptr<Thing> thing) {
 
 	std::shared_ptr<Creature> creature = thing->getCreature();
 	if (creature) {
-		g_game().map.clearSpectatorCache();
+		g_game().map.invalidateSpectatorCache(getPosition());
 		creature->setParent(static_self_cast<Tile>());
 		CreatureVector* creatures = makeCreatures();
 		creatures->insert(creatures->begin(), creature);
@@ -980,7 +993,7 @@ void Tile::addThing(int32_t, std::shared_ptr<Thing> thing) {
 		} else if (item->isAlwaysOnTop()) {
 			if (itemType.isSplash() && items) {
 				// remove old splash if exists
-				for (ItemVector::const_iterator it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
+				for (TileItemVector::const_iterator it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
 					std::shared_ptr<Item> oldSplash = *it;
 					if (!Item::items[oldSplash->getID()].isSplash()) {
 						continue;
@@ -1017,7 +1030,7 @@ void Tile::addThing(int32_t, std::shared_ptr<Thing> thing) {
 			if (itemType.isMagicField()) {
 				// remove old field item if exists
 				if (items) {
-					for (ItemVector::const_iterator it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
+					for (TileItemVector::const_iterator it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
 						std::shared_ptr<MagicField> oldField = (*it)->getMagicField();
 						if (oldField) {
 							if (oldField->isReplaceable()) {
@@ -1142,7 +1155,7 @@ void Tile::removeThing(std::shared_ptr<Thing> thing, uint32_t count) {
 		if (creatures) {
 			auto it = std::find(creatures->begin(), creatures->end(), thing);
 			if (it != creatures->end()) {
-				g_game().map.clearSpectatorCache();
+				g_game().map.invalidateSpectatorCache(getPosition());
 				creatures->erase(it);
 			}
 		}
@@ -1184,9 +1197,11 @@ void Tile::removeThing(std::shared_ptr<Thing> thing, uint32_t count) {
 
 		SpectatorHashSet spectators;
 		g_game().map.getSpectators(spectators, getPosition(), true);
-		for (std::shared_ptr<Creature> spectator : spectators) {
-			if (std::shared_ptr<Player> tmpPlayer = spectator->getPlayer()) {
-				oldStackPosVector.push_back(getStackposOfItem(tmpPlayer, item));
+		if (!g_game().map.isBatchingTileUpdates()) {
+			for (const auto &spectator : spectators) {
+				if (std::shared_ptr<Player> tmpPlayer = spectator->getPlayer()) {
+					oldStackPosVector.push_back(getStackposOfItem(tmpPlayer, item));
+				}
 			}
 		}
 
@@ -1209,9 +1224,11 @@ void Tile::removeThing(std::shared_ptr<Thing> thing, uint32_t count) {
 
 			SpectatorHashSet spectators;
 			g_game().map.getSpectators(spectators, getPosition(), true);
-			for (std::shared_ptr<Creature> spectator : spectators) {
-				if (std::shared_ptr<Player> tmpPlayer = spectator->getPlayer()) {
-					oldStackPosVector.push_back(getStackposOfItem(tmpPlayer, item));
+			if (!g_game().map.isBatchingTileUpdates()) {
+				for (const auto &spectator : spectators) {
+					if (std::shared_ptr<Player> tmpPlayer = spectator->getPlayer()) {
+						oldStackPosVector.push_back(getStackposOfItem(tmpPlayer, item));
+					}
 				}
 			}
 
@@ -1224,7 +1241,7 @@ void Tile::removeThing(std::shared_ptr<Thing> thing, uint32_t count) {
 }
 
 void Tile::removeCreature(std::shared_ptr<Creature> creature) {
-	g_game().map.getQTNode(tilePos.x, tilePos.y)->removeCreature(creature);
+	g_game().map.getQTNode(tilePos.x, tilePos.y)->removeCreature(creature, tilePos.z);
 	removeThing(creature, 0);
 }
 
@@ -1442,7 +1459,7 @@ std::shared_ptr<Thing> Tile::getThing(size_t index) const {
 void Tile::postAddNotification(std::shared_ptr<Thing> thing, std::shared_ptr<Cylinder> oldParent, int32_t index, CylinderLink_t link /*= LINK_OWNER*/) {
 	SpectatorHashSet spectators;
 	g_game().map.getSpectators(spectators, getPosition(), true, true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->getPlayer()->postAddNotification(thing, oldParent, index, LINK_NEAR);
 	}
 
@@ -1486,11 +1503,13 @@ void Tile::postRemoveNotification(std::shared_ptr<Thing> thing, std::shared_ptr<
 	SpectatorHashSet spectators;
 	g_game().map.getSpectators(spectators, getPosition(), true, true);
 
-	if (getThingCount() > 8) {
+	if (g_game().map.isBatchingTileUpdates()) {
+		g_game().map.addBatchedTile(getPosition());
+	} else if (getThingCount() > 8) {
 		onUpdateTile(spectators);
 	}
 
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->getPlayer()->postRemoveNotification(thing, newParent, index, LINK_NEAR);
 	}
 
@@ -1530,7 +1549,7 @@ void Tile::internalAddThing(uint32_t, std::shared_ptr<Thing> thing) {
 	if (!thing) {
 		return;
 	}
-	for (const auto zone : getZones()) {
+	for (const auto &zone : getZones()) {
 		zone->thingAdded(thing);
 	}
 
@@ -1538,7 +1557,7 @@ void Tile::internalAddThing(uint32_t, std::shared_ptr<Thing> thing) {
 
 	std::shared_ptr<Creature> creature = thing->getCreature();
 	if (creature) {
-		g_game().map.clearSpectatorCache();
+		g_game().map.invalidateSpectatorCache(getPosition());
 		CreatureVector* creatures = makeCreatures();
 		creatures->insert(creatures->begin(), creature);
 	} else {
@@ -1589,11 +1608,10 @@ void Tile::updateTileFlags(std::shared_ptr<Item> item) {
 }
 
 void Tile::setTileFlags(std::shared_ptr<Item> item) {
-	if (!hasFlag(TILESTATE_FLOORCHANGE)) {
-		const ItemType &it = Item::items[item->getID()];
-		if (it.floorChange != 0) {
-			setFlag(it.floorChange);
-		}
+	g_game().map.invalidateFlowFields(tilePos);
+
+	if (!hasFlag(TILESTATE_FLOORCHANGE) && Item::items.hasTypeFlag(item->getID(), ITEMTYPE_FLAG_FLOORCHANGE)) {
+		setFlag(Item::items[item->getID()].floorChange);
 	}
 
 	if (item->hasProperty(CONST_PROP_IMMOVABLEBLOCKSOLID)) {
@@ -1632,6 +1650,10 @@ void Tile::setTileFlags(std::shared_ptr<Item> item) {
 		setFlag(TILESTATE_BLOCKSOLID);
 	}
 
+	if (item->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+		setFlag(TILESTATE_BLOCKPROJECTILE);
+	}
+
 	if (item->getBed()) {
 		setFlag(TILESTATE_BED);
 	}
@@ -1647,8 +1669,9 @@ void Tile::setTileFlags(std::shared_ptr<Item> item) {
 }
 
 void Tile::resetTileFlags(std::shared_ptr<Item> item) {
-	const ItemType &it = Item::items[item->getID()];
-	if (it.floorChange != 0) {
+	g_game().map.invalidateFlowFields(tilePos);
+
+	if (Item::items.hasTypeFlag(item->getID(), ITEMTYPE_FLAG_FLOORCHANGE)) {
 		resetFlag(TILESTATE_FLOORCHANGE);
 	}
 
@@ -1656,6 +1679,10 @@ void Tile::resetTileFlags(std::shared_ptr<Item> item) {
 		resetFlag(TILESTATE_BLOCKSOLID);
 	}
 
+	if (item->hasProperty(CONST_PROP_BLOCKPROJECTILE) && !hasProperty(item, CONST_PROP_BLOCKPROJECTILE)) {
+		resetFlag(TILESTATE_BLOCKPROJECTILE);
+	}
+
 	if (item->hasProperty(CONST_PROP_IMMOVABLEBLOCKSOLID) && !hasProperty(item, CONST_PROP_IMMOVABLEBLOCKSOLID)) {
 		resetFlag(TILESTATE_IMMOVABLEBLOCKSOLID);
 	}
@@ -1706,6 +1733,18 @@ void Tile::resetTileFlags(std::shared_ptr<Item> item) {
 	}
 }
 
+void Tile::updateSectorFlags() const {
+	if (tilePos.z >= MAP_MAX_LAYERS) {
+		return;
+	}
+
+	if (const auto leaf = g_game().map.getQTNode(tilePos.x, tilePos.y)) {
+		if (const auto &floor = leaf->getFloor(tilePos.z)) {
+			floor->setSectorFlags(tilePos.x, tilePos.y, flags);
+		}
+	}
+}
+
 bool Tile::isMoveableBlocking() const {
 	return !ground || hasFlag(TILESTATE_BLOCKSOLID);
 }
@@ -1741,6 +1780,6 @@ std::shared_ptr<Item> Tile::getDoorItem() const {
 	return nullptr;
 }
 
-const phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> Tile::getZones() {
+std::span<const std::shared_ptr<Zone>> Tile::getZones() {
 	return Zone::getZones(getPosition());
 }
@@ -13,6 +13,7 @@
 #include "declarations.hpp"
 #include "items/item.hpp"
 #include "utils/tools.hpp"
+#include "lib/profiling/allocation_profiler.hpp"
 
 class Creature;
 class Teleport;
@@ -23,28 +24,30 @@ class BedItem;
 class House;
 class Zone;
 
-using CreatureVector = std::vector<std::shared_ptr<Creature>>;
+// Most tiles hold a creature or two and a few items, those are kept inline in the tile
+using CreatureVector = absl::InlinedVector<std::shared_ptr<Creature>, 2>;
 using ItemVector = std::vector<std::shared_ptr<Item>>;
+using TileItemStorage = absl::InlinedVector<std::shared_ptr<Item>, 3>;
 using SpectatorHashSet = phmap::flat_hash_set<std::shared_ptr<Creature>>;
 
-class TileItemVector : private ItemVector {
+class TileItemVector : private TileItemStorage {
 public:
-	using ItemVector::at;
-	using ItemVector::begin;
-	using ItemVector::clear;
-	using ItemVector::const_iterator;
-	using ItemVector::const_reverse_iterator;
-	using ItemVector::empty;
-	using ItemVector::end;
-	using ItemVector::erase;
-	using ItemVector::insert;
-	using ItemVector::iterator;
-	using ItemVector::push_back;
-	using ItemVector::rbegin;
-	using ItemVector::rend;
-	using ItemVector::reverse_iterator;
-	using ItemVector::size;
-	using ItemVector::value_type;
+	using TileItemStorage::at;
+	using TileItemStorage::begin;
+	using TileItemStorage::clear;
+	using TileItemStorage::const_iterator;
+	using TileItemStorage::const_reverse_iterator;
+	using TileItemStorage::empty;
+	using TileItemStorage::end;
+	using TileItemStorage::erase;
+	using TileItemStorage::insert;
+	using TileItemStorage::iterator;
+	using TileItemStorage::push_back;
+	using TileItemStorage::rbegin;
+	using TileItemStorage::rend;
+	using TileItemStorage::reverse_iterator;
+	using TileItemStorage::size;
+	using TileItemStorage::value_type;
 
 	iterator getBeginDownItem() {
 		return begin();
@@ -100,7 +103,7 @@ private:
 	uint32_t downItemCount = 0;
 };
 
-class Tile : public Cylinder, public SharedObject {
+class Tile : public Cylinder, public SharedObject, public AllocationTracked<Tile> {
 public:
 	static const std::shared_ptr<Tile> &nullptr_tile;
 	Tile(uint16_t x, uint16_t y, uint8_t z) :
@@ -168,13 +171,24 @@ public:
 		return hasBitSet(flag, this->flags);
 	}
 	void setFlag(uint32_t flag) {
+		const uint32_t changed = flag & ~this->flags;
 		this->flags |= flag;
+		if (changed & SECTOR_TRACKED_TILESTATES) {
+			updateSectorFlags();
+		}
 	}
 	void resetFlag(uint32_t flag) {
+		const uint32_t changed = flag & this->flags;
 		this->flags &= ~flag;
+		if (changed & SECTOR_TRACKED_TILESTATES) {
+			updateSectorFlags();
+		}
+	}
+	uint32_t getFlags() const {
+		return flags;
 	}
 
-	const phmap::parallel_flat_hash_set<std::shared_ptr<Zone>> getZones();
+	std::span<const std::shared_ptr<Zone>> getZones();
 
 	ZoneType_t getZoneType() const {
 		if (hasFlag(TILESTATE_PROTECTIONZONE)) {
@@ -199,9 +213,9 @@ public:
 	int32_t getStackposOfItem(std::shared_ptr<Player> player, std::shared_ptr<Item> item) const;
 
 	// cylinder implementations
-	ReturnValue queryAdd(int32_t index, const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, std::shared_ptr<Creature> actor = nullptr) override;
+	ReturnValue queryAdd(int32_t index, const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, const std::shared_ptr<Creature> &actor = nullptr) override;
 	ReturnValue queryMaxCount(int32_t index, const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t &maxQueryCount, uint32_t flags) override final;
-	ReturnValue queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t tileFlags, std::shared_ptr<Creature> actor = nullptr) override;
+	ReturnValue queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t tileFlags, const std::shared_ptr<Creature> &actor = nullptr) override;
 	std::shared_ptr<Cylinder> queryDestination(int32_t &index, const std::shared_ptr<Thing> &thing, std::shared_ptr<Item>* destItem, uint32_t &flags) override;
 
 	std::vector<std::shared_ptr<Tile>> getSurroundingTiles();
@@ -256,6 +270,8 @@ private:
 	void setTileFlags(std::shared_ptr<Item> item);
 	void resetTileFlags(std::shared_ptr<Item> item);
 	bool hasHarmfulField() const;
+	// Mirrors the SECTOR_TRACKED_TILESTATES into the floor bitmaps
+	void updateSectorFlags() const;
 	ReturnValue checkNpcCanWalkIntoTile() const;
 
 protected:
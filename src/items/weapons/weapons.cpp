@@ -22,19 +22,31 @@ const Weapon* Weapons::getWeapon(std::shared_ptr<Item> item) const {
 		return nullptr;
 	}
 
-	auto it = weapons.find(item->getID());
-	if (it == weapons.end()) {
-		return nullptr;
-	}
-	return it->second;
+	const uint16_t itemId = item->getID();
+	return itemId < weapons.size() ? weapons[itemId] : nullptr;
 }
 
 void Weapons::clear() {
 	weapons.clear();
+	++generation;
+}
+
+void Weapons::clearFileEvents(const std::string &file) {
+	for (auto &weapon : weapons) {
+		if (weapon && weapon->getScriptFile() == file) {
+			weapon = nullptr;
+		}
+	}
+	++generation;
 }
 
 bool Weapons::registerLuaEvent(Weapon* event) {
-	weapons[event->getID()] = event;
+	const uint16_t itemId = event->getID();
+	if (itemId >= weapons.size()) {
+		weapons.resize(std::max<size_t>(itemId + 1, Item::items.size()), nullptr);
+	}
+	weapons[itemId] = event;
+	++generation;
 	return true;
 }
 
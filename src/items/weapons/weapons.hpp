@@ -37,15 +37,23 @@ public:
 	}
 
 	const Weapon* getWeapon(std::shared_ptr<Item> item) const;
+	// Moves on whenever weapons are registered or cleared, for caches of getWeapon results
+	uint32_t getGeneration() const {
+		return generation;
+	}
 
 	static int32_t getMaxMeleeDamage(int32_t attackSkill, int32_t attackValue);
 	static int32_t getMaxWeaponDamage(uint32_t level, int32_t attackSkill, int32_t attackValue, float attackFactor, bool isMelee);
 
 	bool registerLuaEvent(Weapon* event);
 	void clear();
+	// Unregisters the events the given script file registered, for hot reload
+	void clearFileEvents(const std::string &file);
 
 private:
-	std::map<uint32_t, Weapon*> weapons;
+	// By item id, nullptr for the ids without a weapon
+	std::vector<Weapon*> weapons;
+	uint32_t generation = 0;
 };
 
 constexpr auto g_weapons = Weapons::getInstance;
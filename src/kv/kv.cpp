@@ -11,6 +11,7 @@
 
 #include "kv/kv.hpp"
 #include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
 #include "utils/tools.hpp"
 
 KVStore &KVStore::getInstance() {
@@ -28,43 +29,166 @@ void KVStore::set(const std::string &key, const std::initializer_list<std::pair<
 }
 
 void KVStore::set(const std::string &key, const ValueWrapper &value) {
-	std::lock_guard lock(mutex_);
-	return setLocked(key, value);
+	auto &shard = getShard(key);
+	std::scoped_lock lock(shard.mutex);
+	setLocked(shard, key, value);
 }
 
-void KVStore::setLocked(const std::string &key, const ValueWrapper &value) {
+KVStore::Shard &KVStore::getShard(const std::string &key) const {
+	// The maps hash with their own function, so taking the shard from this one keeps them evenly filled
+	return (*shards_)[std::hash<std::string_view> {}(key) % SHARD_COUNT];
+}
+
+void KVStore::unlink(Shard &shard, Entry &entry) {
+	(entry.prev ? entry.prev->next : shard.head) = entry.next;
+	(entry.next ? entry.next->prev : shard.tail) = entry.prev;
+	entry.prev = entry.next = nullptr;
+}
+
+void KVStore::pushFront(Shard &shard, Entry &entry) {
+	entry.next = shard.head;
+	(shard.head ? shard.head->prev : shard.tail) = &entry;
+	shard.head = &entry;
+}
+
+void KVStore::setLocked(Shard &shard, const std::string &key, const ValueWrapper &value, bool dirty /*= true */) {
 	logger.debug("KVStore::set({})", key);
-	auto it = store_.find(key);
-	if (it != store_.end()) {
-		it->second.first = value;
-		lruQueue_.splice(lruQueue_.begin(), lruQueue_, it->second.second);
-	} else {
-		if (store_.size() >= MAX_SIZE) {
-			logger.debug("KVStore::set() - MAX_SIZE reached, removing last element");
-			auto last = lruQueue_.end();
-			last--;
-			save(*last, store_[*last].first);
-			store_.erase(*last);
-			lruQueue_.pop_back();
-		}
+	if (dirty) {
+		shard.evictedDirty.erase(key);
+	}
+
+	if (auto it = shard.entries.find(key); it != shard.entries.end()) {
+		auto &entry = it->second;
+		entry.value = value;
+		entry.dirty = entry.dirty || dirty;
+		unlink(shard, entry);
+		pushFront(shard, entry);
+		return;
+	}
 
-		lruQueue_.push_front(key);
-		store_.try_emplace(key, std::make_pair(value, lruQueue_.begin()));
+	if (shard.entries.size() >= SHARD_CAPACITY) {
+		logger.debug("KVStore::set() - MAX_SIZE reached, removing last element");
+		auto &last = *shard.tail;
+		unlink(shard, last);
+		// Saving it here would race the queued background writes, the next save takes it instead
+		if (last.dirty) {
+			shard.evictedDirty.try_emplace(*last.key, std::move(last.value));
+		}
+		shard.entries.erase(shard.entries.find(*last.key));
 	}
+
+	auto [it, inserted] = shard.entries.try_emplace(key);
+	auto &entry = it->second;
+	entry.value = value;
+	entry.key = &it->first;
+	entry.dirty = dirty;
+	pushFront(shard, entry);
 }
 
 std::optional<ValueWrapper> KVStore::get(const std::string &key, bool forceLoad /*= false */) {
 	logger.debug("KVStore::get({})", key);
-	std::lock_guard lock(mutex_);
-	if (forceLoad || !store_.contains(key)) {
-		auto value = load(key);
-		if (value) {
-			setLocked(key, *value);
+	static auto &hits = g_metrics().getCounter("canary_kv_cache_hits_total", "KV reads answered from the cache");
+	static auto &misses = g_metrics().getCounter("canary_kv_cache_misses_total", "KV reads that went to the database");
+	auto &shard = getShard(key);
+	{
+		std::scoped_lock lock(shard.mutex);
+		if (auto it = shard.entries.find(key); it != shard.entries.end()) {
+			if (!forceLoad) {
+				auto &entry = it->second;
+				unlink(shard, entry);
+				pushFront(shard, entry);
+				hits.add();
+				return entry.value;
+			}
+		} else if (auto evicted = shard.evictedDirty.extract(key)) {
+			// Not written yet, so the database would return an older value
+			auto value = std::move(evicted.mapped());
+			setLocked(shard, key, value);
+			hits.add();
+			return value;
 		}
-		return value;
 	}
 
-	auto &[value, timestamp] = store_[key];
-	lruQueue_.splice(lruQueue_.begin(), lruQueue_, timestamp);
+	misses.add();
+
+	// The shard is not held during the round trip, other keys of it stay available
+	auto value = load(key);
+	if (value) {
+		std::scoped_lock lock(shard.mutex);
+		// A set that ran meanwhile is newer than what was loaded
+		auto it = shard.entries.find(key);
+		if (it == shard.entries.end() || !it->second.dirty) {
+			setLocked(shard, key, *value, false);
+		}
+	}
 	return value;
 }
+
+void KVStore::prefetch(const std::string &scope /*= "" */) {
+	if (scope.empty()) {
+		return;
+	}
+
+	for (const auto &[key, value] : loadPrefix(scope + ".")) {
+		auto &shard = getShard(key);
+		std::scoped_lock lock(shard.mutex);
+		// Whatever is cached or waiting to be saved is at least as new
+		if (!shard.entries.contains(key) && !shard.evictedDirty.contains(key)) {
+			setLocked(shard, key, value, false);
+		}
+	}
+}
+
+void KVStore::flush() {
+	saveAll();
+	if (!shards_) {
+		return;
+	}
+
+	for (auto &shard : *shards_) {
+		std::scoped_lock lock(shard.mutex);
+		shard.entries.clear();
+		shard.head = shard.tail = nullptr;
+		shard.evictedDirty.clear();
+	}
+}
+
+std::vector<std::pair<std::string, ValueWrapper>> KVStore::takeDirty() {
+	std::vector<std::pair<std::string, ValueWrapper>> entries;
+	for (auto &shard : *shards_) {
+		std::scoped_lock lock(shard.mutex);
+		for (auto &[key, entry] : shard.entries) {
+			if (entry.dirty) {
+				entries.emplace_back(key, entry.value);
+				entry.dirty = false;
+			}
+		}
+		for (auto &[key, value] : shard.evictedDirty) {
+			entries.emplace_back(key, std::move(value));
+		}
+		shard.evictedDirty.clear();
+	}
+	return entries;
+}
+
+void KVStore::markAllDirty() {
+	for (auto &shard : *shards_) {
+		std::scoped_lock lock(shard.mutex);
+		for (auto &[key, entry] : shard.entries) {
+			entry.dirty = true;
+		}
+	}
+}
+
+void KVStore::markDirty(const std::vector<std::pair<std::string, ValueWrapper>> &entries) {
+	for (const auto &[key, value] : entries) {
+		auto &shard = getShard(key);
+		std::scoped_lock lock(shard.mutex);
+		if (auto it = shard.entries.find(key); it != shard.entries.end()) {
+			it->second.dirty = true;
+		} else {
+			// A newer value evicted since then is kept
+			shard.evictedDirty.try_emplace(key, value);
+		}
+	}
+}
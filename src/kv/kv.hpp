@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <array>
+#include <memory>
 #include <string>
 #include <mutex>
 #include <initializer_list>
@@ -18,16 +20,27 @@
 #include "lib/logging/logger.hpp"
 #include "kv/value_wrapper.hpp"
 
+/**
+ * Cache in front of the backing store, split in shards with their own lock
+ * so concurrent lookups of different keys don't wait on each other. Each
+ * shard evicts its least recently used entry through an intrusive list
+ * threaded in the entries, the key itself is only stored by the map.
+ */
 class KVStore {
 public:
-	static constexpr size_t MAX_SIZE = 10000;
+	static constexpr size_t MAX_SIZE = 100000;
+	static constexpr size_t SHARD_COUNT = 16;
 
 	static KVStore &getInstance();
 
 	explicit KVStore(Logger &logger) :
-		logger(logger) { }
+		logger(logger), shards_(std::make_unique<std::array<Shard, SHARD_COUNT>>()) { }
 	virtual ~KVStore() = default;
 
+	// Ensures that we don't accidentally copy it
+	KVStore(const KVStore &) = delete;
+	KVStore &operator=(const KVStore &) = delete;
+
 	template <typename T>
 	void set(const std::string &key, const std::vector<T> &vec);
 	virtual void set(const std::string &key, const std::initializer_list<ValueWrapper> &init_list);
@@ -39,39 +52,73 @@ public:
 	template <typename T>
 	T get(const std::string &key, bool forceLoad = false);
 
+	/**
+	 * Loads every key under the scope with a single query and caches the ones
+	 * not cached yet, e.g. the keys of a player before it enters the world.
+	 * It blocks on the database, so call it off the game thread.
+	 */
+	virtual void prefetch(const std::string &scope = "");
+
 	virtual bool saveAll() {
 		return true;
 	}
 
+	// Starts writing the entries changed since the last save in the background
+	virtual void saveDirtyAsync() { }
+
 	template <typename T>
 	std::shared_ptr<KVStore> scoped(const T &scope);
 
 	friend class ScopedKV;
 
-	void flush() {
-		saveAll();
-		store_.clear();
-	}
+	void flush();
 
 protected:
-	phmap::parallel_flat_hash_map<std::string, std::pair<ValueWrapper, std::list<std::string>::iterator>> getStore() {
-		std::scoped_lock lock(mutex_);
-		phmap::parallel_flat_hash_map<std::string, std::pair<ValueWrapper, std::list<std::string>::iterator>> copy;
-		for (const auto &[key, value] : store_) {
-			copy.try_emplace(key, value);
-		}
-		return copy;
-	}
+	// For wrappers forwarding every call to another store, they keep no cache of their own
+	KVStore(Logger &logger, std::nullptr_t) :
+		logger(logger) { }
+
+	// Copies the entries set since the last call, evicted ones included, and marks them clean
+	std::vector<std::pair<std::string, ValueWrapper>> takeDirty();
+	// Marks every cached entry dirty again, for when a save may not have reached the database
+	void markAllDirty();
+	void markDirty(const std::vector<std::pair<std::string, ValueWrapper>> &entries);
 	virtual std::optional<ValueWrapper> load(const std::string &key) = 0;
+	// Every stored key starting with the prefix
+	virtual std::vector<std::pair<std::string, ValueWrapper>> loadPrefix(const std::string &prefix) {
+		return {};
+	}
 	virtual bool save(const std::string &key, const ValueWrapper &value) = 0;
 	Logger &logger;
 
 private:
-	void setLocked(const std::string &key, const ValueWrapper &value);
-
-	phmap::parallel_flat_hash_map<std::string, std::pair<ValueWrapper, std::list<std::string>::iterator>> store_;
-	std::list<std::string> lruQueue_;
-	std::mutex mutex_;
+	struct Entry {
+		ValueWrapper value;
+		// Points at the map's own key, nodes don't move
+		const std::string* key = nullptr;
+		// Neighbours in the recency list, head is the most recently used
+		Entry* prev = nullptr;
+		Entry* next = nullptr;
+		bool dirty = false;
+	};
+
+	struct Shard {
+		std::mutex mutex;
+		phmap::node_hash_map<std::string, Entry> entries;
+		Entry* head = nullptr;
+		Entry* tail = nullptr;
+		// Dirty entries pushed out of the cache, still waiting for the next save
+		phmap::flat_hash_map<std::string, ValueWrapper> evictedDirty;
+	};
+
+	static constexpr size_t SHARD_CAPACITY = MAX_SIZE / SHARD_COUNT;
+
+	Shard &getShard(const std::string &key) const;
+	void setLocked(Shard &shard, const std::string &key, const ValueWrapper &value, bool dirty = true);
+	static void unlink(Shard &shard, Entry &entry);
+	static void pushFront(Shard &shard, Entry &entry);
+
+	std::unique_ptr<std::array<Shard, SHARD_COUNT>> shards_;
 };
 
 template <typename T>
@@ -92,7 +139,7 @@ T KVStore::get(const std::string &key, bool forceLoad /*= false */) {
 class ScopedKV final : public KVStore {
 public:
 	ScopedKV(KVStore &parentKV, const std::string &prefix) :
-		KVStore(parentKV.logger), parentKV_(parentKV), prefix_(prefix) { }
+		KVStore(parentKV.logger, nullptr), parentKV_(parentKV), prefix_(prefix) { }
 
 	template <typename T>
 	void set(const std::string &key, const std::vector<T> &vec) {
@@ -121,6 +168,10 @@ public:
 		return T {};
 	}
 
+	void prefetch(const std::string &scope = "") override {
+		parentKV_.prefetch(scope.empty() ? prefix_ : buildKey(scope));
+	}
+
 	bool saveAll() override {
 		return parentKV_.saveAll();
 	}
@@ -129,6 +180,9 @@ protected:
 	std::optional<ValueWrapper> load(const std::string &key) override {
 		return parentKV_.load(buildKey(key));
 	}
+	std::vector<std::pair<std::string, ValueWrapper>> loadPrefix(const std::string &prefix) override {
+		return parentKV_.loadPrefix(buildKey(prefix));
+	}
 	bool save(const std::string &key, const ValueWrapper &value) override {
 		return parentKV_.save(buildKey(key), value);
 	}
@@ -13,6 +13,8 @@
 #include <algorithm>
 
 #include "kv/kv_sql.hpp"
+#include "database/databasetasks.hpp"
+#include "kv/value_wrapper_codec.hpp"
 #include "kv/value_wrapper_proto.hpp"
 #include "protobuf/kv.pb.h"
 #include "utils/tools.hpp"
@@ -24,29 +26,64 @@ std::optional<ValueWrapper> KVSQL::load(const std::string &key) {
 		return std::nullopt;
 	}
 
+	return readValue(result, key);
+}
+
+std::vector<std::pair<std::string, ValueWrapper>> KVSQL::loadPrefix(const std::string &prefix) {
+	std::string pattern;
+	pattern.reserve(prefix.size() + 1);
+	for (const char c : prefix) {
+		if (c == '%' || c == '_' || c == '\\') {
+			pattern.push_back('\\');
+		}
+		pattern.push_back(c);
+	}
+	pattern.push_back('%');
+
+	std::vector<std::pair<std::string, ValueWrapper>> entries;
+	auto query = fmt::format("SELECT `key_name`, `timestamp`, `value` FROM `kv_store` WHERE `key_name` LIKE {}", db.escapeString(pattern));
+	auto result = db.storeQuery(query);
+	if (result == nullptr) {
+		return entries;
+	}
+
+	do {
+		auto key = result->getString("key_name");
+		if (auto value = readValue(result, key)) {
+			entries.emplace_back(std::move(key), std::move(*value));
+		}
+	} while (result->next());
+	return entries;
+}
+
+std::optional<ValueWrapper> KVSQL::readValue(const DBResult_ptr &result, const std::string &key) const {
 	unsigned long size;
 	auto data = result->getStream("value", size);
 	if (data == nullptr) {
 		return std::nullopt;
 	}
 
-	ValueWrapper valueWrapper;
 	auto timestamp = result->getNumber<uint64_t>("timestamp");
+	if (ValueWrapperCodec::isEncoded(data, size)) {
+		if (auto value = ValueWrapperCodec::decode(data, size, timestamp)) {
+			return value;
+		}
+		logger.error("Failed to decode value for key {}", key);
+		return std::nullopt;
+	}
+
+	// Rows saved before the compact encoding, rewritten with it on their next save
 	Canary::protobuf::kv::ValueWrapper protoValue;
 	if (protoValue.ParseFromArray(data, static_cast<int>(size))) {
-		valueWrapper = ProtoSerializable<ValueWrapper>::fromProto(protoValue, timestamp);
-		return valueWrapper;
+		return ProtoSerializable<ValueWrapper>::fromProto(protoValue, timestamp);
 	}
 	logger.error("Failed to deserialize value for key {}", key);
 	return std::nullopt;
 }
 
 bool KVSQL::save(const std::string &key, const ValueWrapper &value) {
-	auto protoValue = ProtoSerializable<ValueWrapper>::toProto(value);
 	std::string data;
-	if (!protoValue.SerializeToString(&data)) {
-		return false;
-	}
+	ValueWrapperCodec::encode(value, data);
 	auto query = fmt::format(
 		"REPLACE INTO `kv_store` (`key_name`, `timestamp`, `value`) VALUES ({}, {}, {})",
 		db.escapeString(key),
@@ -56,19 +93,88 @@ bool KVSQL::save(const std::string &key, const ValueWrapper &value) {
 	return db.executeQuery(query);
 }
 
+bool KVSQL::saveEntries(const std::vector<std::pair<std::string, ValueWrapper>> &entries) {
+	const auto timestamp = getTimeMsNow();
+	return DBTransaction::executeWithinTransaction([this, &entries, timestamp]() {
+		DBInsert insert("REPLACE INTO `kv_store` (`key_name`, `timestamp`, `value`) VALUES ");
+		std::string data;
+		for (const auto &[key, value] : entries) {
+			data.clear();
+			ValueWrapperCodec::encode(value, data);
+			if (!insert.addRow(fmt::format("{}, {}, {}", db.escapeString(key), timestamp, db.escapeString(data)))) {
+				return false;
+			}
+		}
+		return insert.execute();
+	});
+}
+
+void KVSQL::waitAsyncSaves() {
+	std::unique_lock lock(asyncMutex);
+	asyncCondition.wait(lock, [this] { return !asyncSaving; });
+}
+
 bool KVSQL::saveAll() {
-	auto store = getStore();
-	bool success = DBTransaction::executeWithinTransaction([this, &store]() {
-		return std::ranges::all_of(store, [this](const auto &kv) {
-			const auto &[key, value] = kv;
-			return save(key, value.first);
-		});
+	// A background save taken earlier must be queued before this one
+	waitAsyncSaves();
+
+	const bool capturing = DBWriteCapture::getActive() != nullptr;
+	if (!capturing) {
+		g_databaseTasks().flushWrites();
+	}
+	if (g_databaseTasks().takeFailedWrites("kv")) {
+		markAllDirty();
+	}
+
+	const auto entries = takeDirty();
+	if (entries.empty()) {
 		return true;
-	});
+	}
+
+	if (!saveEntries(entries)) {
+		g_logger().error("[{}] Error occurred saving {} kv entries", __FUNCTION__, entries.size());
+		if (!capturing) {
+			markDirty(entries);
+		}
+		return false;
+	}
+
+	return true;
+}
+
+void KVSQL::saveDirtyAsync() {
+	{
+		std::scoped_lock lock(asyncMutex);
+		// The previous one is still serializing, its keys are not lost, they go with the next
+		if (asyncSaving) {
+			return;
+		}
+		asyncSaving = true;
+	}
 
-	if (!success) {
-		g_logger().error("[{}] Error occurred saving player", __FUNCTION__);
+	if (g_databaseTasks().takeFailedWrites("kv")) {
+		markAllDirty();
 	}
 
-	return success;
+	auto entries = takeDirty();
+	if (entries.empty()) {
+		std::scoped_lock lock(asyncMutex);
+		asyncSaving = false;
+		return;
+	}
+
+	threadPool.addBlockingLoad([this, entries = std::move(entries)]() {
+		std::vector<DBWrite> writes;
+		{
+			DBWriteCapture capture;
+			capture.setKey("kv");
+			saveEntries(entries);
+			writes = capture.takeWrites();
+		}
+		g_databaseTasks().enqueueWrites(std::move(writes));
+
+		std::scoped_lock lock(asyncMutex);
+		asyncSaving = false;
+		asyncCondition.notify_all();
+	});
 }
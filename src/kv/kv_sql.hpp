@@ -13,21 +13,39 @@
 
 #include "database/database.hpp"
 #include "lib/logging/logger.hpp"
+#include "lib/thread/thread_pool.hpp"
 
 class Database;
 
+/**
+ * Writes are batched behind the cache: set only marks the key dirty, and
+ * saveAll or saveDirtyAsync send the dirty keys as multi-row REPLACEs.
+ * Background saves go through the DatabaseTasks write queue under the
+ * "kv" key, so they land in the order they were taken.
+ */
 class KVSQL final : public KVStore {
 public:
-	explicit KVSQL(Database &db, Logger &logger) :
+	explicit KVSQL(Database &db, ThreadPool &threadPool, Logger &logger) :
 		KVStore(logger),
-		db(db) { }
+		db(db), threadPool(threadPool) { }
 
 	bool saveAll() override;
+	void saveDirtyAsync() override;
 
 protected:
 	std::optional<ValueWrapper> load(const std::string &key) override;
+	std::vector<std::pair<std::string, ValueWrapper>> loadPrefix(const std::string &prefix) override;
 	bool save(const std::string &key, const ValueWrapper &value) override;
 
 private:
+	std::optional<ValueWrapper> readValue(const DBResult_ptr &result, const std::string &key) const;
+	bool saveEntries(const std::vector<std::pair<std::string, ValueWrapper>> &entries);
+	void waitAsyncSaves();
+
 	Database &db;
+	ThreadPool &threadPool;
+
+	std::mutex asyncMutex;
+	std::condition_variable asyncCondition;
+	bool asyncSaving = false;
 };
@@ -6,6 +6,9 @@ ValueWrapper::ValueWrapper(uint64_t timestamp) :
 ValueWrapper::ValueWrapper(const ValueVariant &value, uint64_t timestamp) :
 	data_(value), timestamp_(timestamp) { }
 
+ValueWrapper::ValueWrapper(ValueVariant &&value, uint64_t timestamp) :
+	data_(std::move(value)), timestamp_(timestamp) { }
+
 ValueWrapper::ValueWrapper(const std::string &value, uint64_t timestamp) :
 	data_(value), timestamp_(timestamp) { }
 
@@ -29,16 +32,12 @@ std::optional<ValueWrapper> ValueWrapper::get(const std::string &key) const {
 		return std::nullopt;
 	}
 
-	if (!pval->contains(key)) {
-		return std::nullopt;
-	}
-
-	const auto &[_, valuePtr] = *pval->find(key);
-	if (!valuePtr) {
+	const auto it = pval->find(key);
+	if (it == pval->end() || !it->second) {
 		return std::nullopt;
 	}
 
-	return *valuePtr;
+	return *it->second;
 }
 
 std::optional<ValueWrapper> ValueWrapper::get(size_t index) const {
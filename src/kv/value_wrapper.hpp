@@ -33,6 +33,7 @@ class ValueWrapper {
 public:
 	explicit ValueWrapper(uint64_t timestamp = 0);
 	explicit(false) ValueWrapper(const ValueVariant &value, uint64_t timestamp = 0);
+	explicit(false) ValueWrapper(ValueVariant &&value, uint64_t timestamp = 0);
 	explicit(false) ValueWrapper(const std::string &value, uint64_t timestamp = 0);
 	explicit(false) ValueWrapper(int value, uint64_t timestamp = 0);
 	explicit(false) ValueWrapper(double value, uint64_t timestamp = 0);
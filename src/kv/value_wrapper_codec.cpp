@@ -0,0 +1,234 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "kv/value_wrapper_codec.hpp"
+
+namespace {
+	enum ValueTag : uint8_t {
+		TAG_STRING = 0,
+		TAG_INT = 1,
+		TAG_DOUBLE = 2,
+		TAG_ARRAY = 3,
+		TAG_MAP = 4,
+	};
+
+	constexpr uint8_t TAG_BITS = 3;
+	constexpr uint8_t TAG_MASK = (1 << TAG_BITS) - 1;
+	// Inline values are stored plus one, 0 means a varint follows
+	constexpr uint64_t MAX_INLINE = (0xFF >> TAG_BITS) - 1;
+	// Deeper data is taken as corrupt rather than risking the stack
+	constexpr uint32_t MAX_DEPTH = 64;
+
+	void writeVarint(std::string &out, uint64_t value) {
+		while (value >= 0x80) {
+			out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<char>(value));
+	}
+
+	void writeTag(std::string &out, ValueTag tag, uint64_t value) {
+		if (value <= MAX_INLINE) {
+			out.push_back(static_cast<char>(tag | ((value + 1) << TAG_BITS)));
+			return;
+		}
+		out.push_back(static_cast<char>(tag));
+		writeVarint(out, value);
+	}
+
+	uint64_t zigzag(int64_t value) {
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+	}
+
+	int64_t unzigzag(uint64_t value) {
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+
+	void writeValue(std::string &out, const ValueWrapper &value) {
+		std::visit(
+			[&out](const auto &arg) {
+				using T = std::decay_t<decltype(arg)>;
+				if constexpr (std::is_same_v<T, StringType>) {
+					writeTag(out, TAG_STRING, arg.size());
+					out.append(arg);
+				} else if constexpr (std::is_same_v<T, IntType>) {
+					writeTag(out, TAG_INT, zigzag(arg));
+				} else if constexpr (std::is_same_v<T, DoubleType>) {
+					out.push_back(static_cast<char>(TAG_DOUBLE));
+					const auto bits = std::bit_cast<uint64_t>(arg);
+					for (int shift = 0; shift < 64; shift += 8) {
+						out.push_back(static_cast<char>((bits >> shift) & 0xFF));
+					}
+				} else if constexpr (std::is_same_v<T, ArrayType>) {
+					writeTag(out, TAG_ARRAY, arg.size());
+					for (const auto &element : arg) {
+						writeValue(out, element);
+					}
+				} else if constexpr (std::is_same_v<T, MapType>) {
+					writeTag(out, TAG_MAP, arg.size());
+					for (const auto &[key, element] : arg) {
+						writeVarint(out, key.size());
+						out.append(key);
+						// A null entry has nothing to load back, it goes as an empty string
+						writeValue(out, element ? *element : ValueWrapper(StringType()));
+					}
+				}
+			},
+			value.getVariant()
+		);
+	}
+
+	class Reader {
+	public:
+		Reader(const char* data, size_t size, uint64_t timestamp) :
+			position(data), end(data + size), timestamp(timestamp) { }
+
+		bool atEnd() const {
+			return position == end;
+		}
+
+		std::optional<ValueWrapper> readValue(uint32_t depth) {
+			if (depth > MAX_DEPTH || atEnd()) {
+				return std::nullopt;
+			}
+
+			const auto tagByte = static_cast<uint8_t>(*position++);
+			const auto tag = static_cast<ValueTag>(tagByte & TAG_MASK);
+			if (tag == TAG_DOUBLE) {
+				return readDouble();
+			}
+
+			uint64_t value = tagByte >> TAG_BITS;
+			if (value != 0) {
+				--value;
+			} else if (!readVarint(value)) {
+				return std::nullopt;
+			}
+
+			switch (tag) {
+				case TAG_STRING: {
+					auto string = readString(value);
+					return string ? std::optional<ValueWrapper>(ValueWrapper(*string, timestamp)) : std::nullopt;
+				}
+				case TAG_INT:
+					return ValueWrapper(static_cast<IntType>(unzigzag(value)), timestamp);
+				case TAG_ARRAY:
+					return readArray(value, depth);
+				case TAG_MAP:
+					return readMap(value, depth);
+				default:
+					return std::nullopt;
+			}
+		}
+
+	private:
+		size_t remaining() const {
+			return static_cast<size_t>(end - position);
+		}
+
+		bool readVarint(uint64_t &value) {
+			value = 0;
+			for (uint8_t shift = 0; shift < 64 && !atEnd(); shift += 7) {
+				const auto byte = static_cast<uint8_t>(*position++);
+				value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		std::optional<std::string> readString(uint64_t size) {
+			if (size > remaining()) {
+				return std::nullopt;
+			}
+			std::string string(position, static_cast<size_t>(size));
+			position += size;
+			return string;
+		}
+
+		std::optional<ValueWrapper> readDouble() {
+			if (remaining() < 8) {
+				return std::nullopt;
+			}
+			uint64_t bits = 0;
+			for (int shift = 0; shift < 64; shift += 8) {
+				bits |= static_cast<uint64_t>(static_cast<uint8_t>(*position++)) << shift;
+			}
+			return ValueWrapper(std::bit_cast<DoubleType>(bits), timestamp);
+		}
+
+		std::optional<ValueWrapper> readArray(uint64_t count, uint32_t depth) {
+			// Every element takes a byte at least, a bigger count is corrupt
+			if (count > remaining()) {
+				return std::nullopt;
+			}
+
+			ArrayType array;
+			array.reserve(static_cast<size_t>(count));
+			for (uint64_t i = 0; i < count; ++i) {
+				auto element = readValue(depth + 1);
+				if (!element) {
+					return std::nullopt;
+				}
+				array.emplace_back(std::move(*element));
+			}
+			return ValueWrapper(std::move(array), timestamp);
+		}
+
+		std::optional<ValueWrapper> readMap(uint64_t count, uint32_t depth) {
+			if (count > remaining() / 2) {
+				return std::nullopt;
+			}
+
+			MapType map;
+			map.reserve(static_cast<size_t>(count));
+			for (uint64_t i = 0; i < count; ++i) {
+				uint64_t keySize;
+				if (!readVarint(keySize)) {
+					return std::nullopt;
+				}
+				auto key = readString(keySize);
+				if (!key) {
+					return std::nullopt;
+				}
+				auto element = readValue(depth + 1);
+				if (!element) {
+					return std::nullopt;
+				}
+				map[std::move(*key)] = std::make_shared<ValueWrapper>(std::move(*element));
+			}
+			return ValueWrapper(std::move(map), timestamp);
+		}
+
+		const char* position;
+		const char* end;
+		uint64_t timestamp;
+	};
+}
+
+void ValueWrapperCodec::encode(const ValueWrapper &value, std::string &out) {
+	out.push_back(static_cast<char>(FORMAT_VERSION));
+	writeValue(out, value);
+}
+
+std::optional<ValueWrapper> ValueWrapperCodec::decode(const char* data, size_t size, uint64_t timestamp) {
+	if (!isEncoded(data, size)) {
+		return std::nullopt;
+	}
+
+	Reader reader(data + 1, size - 1, timestamp);
+	auto value = reader.readValue(0);
+	if (!value || !reader.atEnd()) {
+		return std::nullopt;
+	}
+	return value;
+}
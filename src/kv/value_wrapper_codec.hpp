@@ -0,0 +1,41 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "kv/value_wrapper.hpp"
+
+/**
+ * Compact encoding of the values the KV stores, written instead of the
+ * protobuf message.
+ *
+ * The first byte is the format version. Every value then starts with a tag
+ * byte: the low 3 bits are the type, the high 5 bits hold small integers,
+ * string lengths and element counts up to 30 inline, with 0 meaning a
+ * varint follows. Integers are zigzag encoded, doubles are 8 bytes little
+ * endian and map entries are the key followed by the value.
+ *
+ * So a single small integer takes two bytes, and a map entry costs a byte
+ * for the key length on top of its key and value.
+ */
+class ValueWrapperCodec {
+public:
+	// Rows in protobuf never start with it, their field numbers are all below 16
+	static constexpr uint8_t FORMAT_VERSION = 0xF1;
+
+	// Appends to out, so a buffer can be reused across values
+	static void encode(const ValueWrapper &value, std::string &out);
+
+	static bool isEncoded(const char* data, size_t size) {
+		return size > 0 && static_cast<uint8_t>(data[0]) == FORMAT_VERSION;
+	}
+
+	// std::nullopt when the data is not a value of this version or is cut short
+	static std::optional<ValueWrapper> decode(const char* data, size_t size, uint64_t timestamp);
+};
@@ -19,6 +19,8 @@ namespace di = boost::di;
 class DI final {
 private:
 	inline static di::extension::injector<>* testContainer;
+	// Changes with the test container, the instances get cached for an older one are resolved again
+	inline static std::atomic<uint32_t> containerGeneration = 0;
 	const inline static auto defaultContainer = di::make_injector(
 		di::bind<account::AccountRepository>().to<account::AccountRepositoryDB>().in(di::singleton),
 		di::bind<KVStore>().to<KVSQL>().in(di::singleton),
@@ -28,6 +30,7 @@ private:
 public:
 	inline static void setTestContainer(di::extension::injector<>* container) {
 		testContainer = container;
+		containerGeneration.fetch_add(1, std::memory_order_relaxed);
 	}
 
 	/**
@@ -44,10 +47,20 @@ public:
 	 * Get returns you a reference of a instance that the DI contains.
 	 * It will always return the same instance, it's used for singletons shared instances.
 	 * Instances acquired with get are managed by the DI and can be merely references.
+	 * The container resolves the instance once per thread, later calls are a load
+	 * and a compare of the container generation.
 	 */
 	template <class T>
 	inline static T &get() {
-		return create<T &>();
+		thread_local T* instance = nullptr;
+		thread_local uint32_t instanceGeneration = 0;
+
+		const auto generation = containerGeneration.load(std::memory_order_relaxed);
+		if (!instance || instanceGeneration != generation) [[unlikely]] {
+			instance = &create<T &>();
+			instanceGeneration = generation;
+		}
+		return *instance;
 	}
 };
 
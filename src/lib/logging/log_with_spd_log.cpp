@@ -7,11 +7,22 @@
  * Website: https://docs.opentibiabr.com/
  */
 #include <spdlog/spdlog.h>
+#include <spdlog/async.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
 
 #include "pch.hpp"
 #include "lib/di/container.hpp"
 
+static_assert(static_cast<int>(LogLevel::Trace) == spdlog::level::trace && static_cast<int>(LogLevel::Off) == spdlog::level::off);
+
 LogWithSpdLog::LogWithSpdLog() {
+	// Formatted messages go through a bounded queue to a single writer thread, the console never stalls the game thread.
+	// When it is full the oldest message is dropped, errors and above flush right away
+	spdlog::init_thread_pool(ASYNC_QUEUE_SIZE, 1);
+	auto asyncLogger = spdlog::stdout_color_mt<spdlog::async_factory_nonblock>("canary");
+	asyncLogger->flush_on(spdlog::level::err);
+	spdlog::set_default_logger(asyncLogger);
+
 	setLevel("debug");
 	spdlog::set_pattern("[%Y-%d-%m %H:%M:%S.%e] [%^%l%$] %v ");
 
@@ -26,8 +37,9 @@ Logger &LogWithSpdLog::getInstance() {
 
 void LogWithSpdLog::setLevel(const std::string &name) {
 	info("Setting log level to {}.", name);
-	auto level = spdlog::level::from_str(name);
-	spdlog::set_level(level);
+	const auto spdLevel = spdlog::level::from_str(name);
+	spdlog::set_level(spdLevel);
+	level.store(static_cast<LogLevel>(spdLevel), std::memory_order_relaxed);
 }
 
 std::string LogWithSpdLog::getLevel() const {
@@ -35,6 +47,6 @@ std::string LogWithSpdLog::getLevel() const {
 	return std::string { level.begin(), level.end() };
 }
 
-void LogWithSpdLog::log(const std::string lvl, const fmt::basic_string_view<char> msg) const {
-	spdlog::log(spdlog::level::from_str(lvl), msg);
+void LogWithSpdLog::log(LogLevel lvl, const fmt::basic_string_view<char> msg) const {
+	spdlog::log(static_cast<spdlog::level::level_enum>(lvl), msg);
 }
@@ -12,6 +12,8 @@
 
 class LogWithSpdLog final : public Logger {
 public:
+	static constexpr size_t ASYNC_QUEUE_SIZE = 8192;
+
 	LogWithSpdLog();
 	~LogWithSpdLog() override = default;
 
@@ -20,7 +22,7 @@ public:
 	void setLevel(const std::string &name) override;
 	[[nodiscard]] std::string getLevel() const override;
 
-	void log(std::string lvl, fmt::basic_string_view<char> msg) const override;
+	void log(LogLevel lvl, fmt::basic_string_view<char> msg) const override;
 };
 
 constexpr auto g_logger = LogWithSpdLog::getInstance;
@@ -8,30 +8,26 @@
  */
 #pragma once
 
-#define LOG_LEVEL_TRACE \
-	std::string {       \
-		"trace"         \
-	}
-#define LOG_LEVEL_DEBUG \
-	std::string {       \
-		"debug"         \
-	}
-#define LOG_LEVEL_INFO \
-	std::string {      \
-		"info"         \
-	}
-#define LOG_LEVEL_WARNING \
-	std::string {         \
-		"warning"         \
-	}
-#define LOG_LEVEL_ERROR \
-	std::string {       \
-		"error"         \
-	}
-#define LOG_LEVEL_CRITICAL \
-	std::string {          \
-		"critical"         \
-	}
+// Same order as the spdlog levels
+enum class LogLevel : uint8_t {
+	Trace,
+	Debug,
+	Info,
+	Warning,
+	Error,
+	Critical,
+	Off,
+};
+
+constexpr std::string_view getLogLevelName(LogLevel level) {
+	constexpr std::array<std::string_view, 7> names = { "trace", "debug", "info", "warning", "error", "critical", "off" };
+	return names[static_cast<size_t>(level)];
+}
+
+// Levels below it are compiled out, e.g. -DCOMPILED_LOG_LEVEL=2 drops every trace and debug call
+#ifndef COMPILED_LOG_LEVEL
+	#define COMPILED_LOG_LEVEL 0
+#endif
 
 class Logger {
 public:
@@ -44,65 +40,98 @@ public:
 
 	virtual void setLevel(const std::string &name) = 0;
 	[[nodiscard]] virtual std::string getLevel() const = 0;
-	virtual void log(std::string lvl, fmt::basic_string_view<char> msg) const = 0;
+	virtual void log(LogLevel lvl, fmt::basic_string_view<char> msg) const = 0;
+
+	// Checked before anything is formatted
+	[[nodiscard]] bool shouldLog(LogLevel lvl) const {
+		return lvl >= static_cast<LogLevel>(COMPILED_LOG_LEVEL) && lvl >= level.load(std::memory_order_relaxed);
+	}
 
 	template <typename... Args>
 	void trace(const fmt::format_string<Args...> &fmt, Args &&... args) {
-		trace(fmt::format(fmt, std::forward<Args>(args)...));
+		if (shouldLog(LogLevel::Trace)) {
+			trace(fmt::format(fmt, std::forward<Args>(args)...));
+		}
 	}
 
 	template <typename... Args>
 	void debug(const fmt::format_string<Args...> &fmt, Args &&... args) {
-		debug(fmt::format(fmt, std::forward<Args>(args)...));
+		if (shouldLog(LogLevel::Debug)) {
+			debug(fmt::format(fmt, std::forward<Args>(args)...));
+		}
 	}
 
 	template <typename... Args>
 	void info(fmt::format_string<Args...> fmt, Args &&... args) {
-		info(fmt::format(fmt, std::forward<Args>(args)...));
+		if (shouldLog(LogLevel::Info)) {
+			info(fmt::format(fmt, std::forward<Args>(args)...));
+		}
 	}
 
 	template <typename... Args>
 	void warn(const fmt::format_string<Args...> &fmt, Args &&... args) {
-		warn(fmt::format(fmt, std::forward<Args>(args)...));
+		if (shouldLog(LogLevel::Warning)) {
+			warn(fmt::format(fmt, std::forward<Args>(args)...));
+		}
 	}
 
 	template <typename... Args>
 	void error(const fmt::format_string<Args...> fmt, Args &&... args) {
-		error(fmt::format(fmt, std::forward<Args>(args)...));
+		if (shouldLog(LogLevel::Error)) {
+			error(fmt::format(fmt, std::forward<Args>(args)...));
+		}
 	}
 
 	template <typename... Args>
 	void critical(const fmt::format_string<Args...> fmt, Args &&... args) {
-		critical(fmt::format(fmt, std::forward<Args>(args)...));
+		if (shouldLog(LogLevel::Critical)) {
+			critical(fmt::format(fmt, std::forward<Args>(args)...));
+		}
 	}
 
 	template <typename T>
 	void trace(const T &msg) {
-		log(LOG_LEVEL_TRACE, msg);
+		if (shouldLog(LogLevel::Trace)) {
+			log(LogLevel::Trace, msg);
+		}
 	}
 
 	template <typename T>
 	void debug(const T &msg) {
-		log(LOG_LEVEL_DEBUG, msg);
+		if (shouldLog(LogLevel::Debug)) {
+			log(LogLevel::Debug, msg);
+		}
 	}
 
 	template <typename T>
 	void info(const T &msg) {
-		log(LOG_LEVEL_INFO, msg);
+		if (shouldLog(LogLevel::Info)) {
+			log(LogLevel::Info, msg);
+		}
 	}
 
 	template <typename T>
 	void warn(const T &msg) {
-		log(LOG_LEVEL_WARNING, msg);
+		if (shouldLog(LogLevel::Warning)) {
+			log(LogLevel::Warning, msg);
+		}
 	}
 
 	template <typename T>
 	void error(const T &msg) {
-		log(LOG_LEVEL_ERROR, msg);
+		if (shouldLog(LogLevel::Error)) {
+			log(LogLevel::Error, msg);
+		}
 	}
 
 	template <typename T>
 	void critical(const T &msg) {
-		log(LOG_LEVEL_CRITICAL, msg);
+		if (shouldLog(LogLevel::Critical)) {
+			log(LogLevel::Critical, msg);
+		}
 	}
+
+protected:
+	// Trace until a backend sets it, so a logger without a level drops nothing
+	std::atomic<LogLevel> level = LogLevel::Trace;
 };
@@ -0,0 +1,137 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lib/memory/allocator.hpp"
+#include "lib/profiling/allocation_profiler.hpp"
+#include "lib/profiling/profiler.hpp"
+#include "utils/tools.hpp"
+
+#if defined(CANARY_ALLOCATOR_MIMALLOC)
+	#include <mimalloc.h>
+#elif defined(CANARY_ALLOCATOR_JEMALLOC)
+	#include <jemalloc/jemalloc.h>
+#elif defined(__GLIBC__)
+	#include <malloc.h>
+#endif
+
+#if defined(CANARY_ALLOCATOR_MIMALLOC) || defined(CANARY_ALLOCATOR_JEMALLOC) || defined(CANARY_PROFILER) || defined(CANARY_ALLOCATION_PROFILER)
+	#define CANARY_REPLACE_OPERATOR_NEW
+#endif
+
+#ifdef CANARY_REPLACE_OPERATOR_NEW
+
+namespace {
+	void* allocateBlock(std::size_t size) noexcept {
+	#if defined(CANARY_ALLOCATOR_MIMALLOC)
+		return mi_malloc(size);
+	#elif defined(CANARY_ALLOCATOR_JEMALLOC)
+		return mallocx(size == 0 ? 1 : size, 0);
+	#else
+		return std::malloc(size == 0 ? 1 : size);
+	#endif
+	}
+
+	void freeBlock(void* pointer) noexcept {
+	#if defined(CANARY_ALLOCATOR_MIMALLOC)
+		mi_free(pointer);
+	#elif defined(CANARY_ALLOCATOR_JEMALLOC)
+		if (pointer) {
+			dallocx(pointer, 0);
+		}
+	#else
+		std::free(pointer);
+	#endif
+	}
+}
+
+// With the profilers every heap allocation is reported, Tracy then shows memory usage and leaks per call stack
+void* operator new(std::size_t size) {
+	auto pointer = allocateBlock(size);
+	if (!pointer) {
+		throw std::bad_alloc();
+	}
+	#ifdef CANARY_PROFILER
+	TracyAlloc(pointer, size);
+	#endif
+	#ifdef CANARY_ALLOCATION_PROFILER
+	AllocationProfiler::onAllocate(size);
+	#endif
+	return pointer;
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+	#ifdef CANARY_PROFILER
+	TracyFree(pointer);
+	#endif
+	freeBlock(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+	operator delete(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+	operator delete(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+	operator delete(pointer);
+}
+
+#endif
+
+AllocatorStats Allocator::getStats() {
+	AllocatorStats stats;
+	stats.name = getName();
+	stats.resident = getProcessResidentBytes();
+
+#if defined(CANARY_ALLOCATOR_MIMALLOC)
+	size_t elapsed, user, system, resident, peakResident, committed, peakCommitted, pageFaults;
+	mi_process_info(&elapsed, &user, &system, &resident, &peakResident, &committed, &peakCommitted, &pageFaults);
+	stats.committed = static_cast<int64_t>(committed);
+#elif defined(CANARY_ALLOCATOR_JEMALLOC)
+	// The statistics are a snapshot taken when the epoch advances
+	uint64_t epoch = 1;
+	size_t length = sizeof(epoch);
+	mallctl("epoch", &epoch, &length, &epoch, length);
+
+	const auto read = [](const char* name) {
+		size_t value = 0;
+		size_t valueLength = sizeof(value);
+		return mallctl(name, &value, &valueLength, nullptr, 0) == 0 ? static_cast<int64_t>(value) : 0;
+	};
+	stats.allocated = read("stats.allocated");
+	stats.committed = read("stats.mapped");
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+	const auto info = mallinfo2();
+	stats.allocated = static_cast<int64_t>(info.uordblks + info.hblkhd);
+	stats.committed = static_cast<int64_t>(info.arena + info.hblkhd);
+#endif
+	return stats;
+}
+
+void Allocator::purge() {
+#if defined(CANARY_ALLOCATOR_MIMALLOC)
+	// The heap of this thread and the ones threads left behind, the others purge on their own after mimalloc's purge delay
+	mi_collect(true);
+#elif defined(CANARY_ALLOCATOR_JEMALLOC)
+	mallctl("thread.tcache.flush", nullptr, nullptr, nullptr, 0);
+	mallctl(fmt::format("arena.{}.purge", MALLCTL_ARENAS_ALL).c_str(), nullptr, nullptr, nullptr, 0);
+#elif defined(__GLIBC__)
+	malloc_trim(0);
+#elif defined(_MSC_VER)
+	_heapmin();
+#endif
+}
@@ -0,0 +1,45 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+struct AllocatorStats {
+	std::string_view name;
+	// Bytes handed out to the program, 0 when the allocator does not tell
+	int64_t allocated = 0;
+	// Bytes the allocator holds from the system, 0 when it does not tell
+	int64_t committed = 0;
+	// Resident memory of the process
+	int64_t resident = 0;
+};
+
+/**
+ * The heap allocator the server was linked with, chosen with
+ * -DOPTIONS_ALLOCATOR=system|mimalloc|jemalloc. With mimalloc or jemalloc
+ * the global operator new and delete go to it, so shared_ptr control
+ * blocks, task captures and hash map buckets are served from its
+ * per-thread caches; C libraries keep using malloc.
+ */
+class Allocator {
+public:
+	static constexpr std::string_view getName() {
+#if defined(CANARY_ALLOCATOR_MIMALLOC)
+		return "mimalloc";
+#elif defined(CANARY_ALLOCATOR_JEMALLOC)
+		return "jemalloc";
+#else
+		return "system";
+#endif
+	}
+
+	static AllocatorStats getStats();
+
+	// Returns the free pages the allocator keeps cached to the system
+	static void purge();
+};
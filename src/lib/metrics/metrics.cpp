@@ -0,0 +1,134 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lib/metrics/metrics.hpp"
+#include "lib/di/container.hpp"
+
+MetricHistogram::MetricHistogram(std::vector<uint64_t> bounds, double divisor) :
+	bounds(std::move(bounds)), divisor(divisor) {
+	assert(this->bounds.size() <= MAX_BUCKETS && std::ranges::is_sorted(this->bounds));
+}
+
+MetricHistogram::Snapshot MetricHistogram::get() const {
+	Snapshot snapshot;
+	snapshot.buckets.resize(bounds.size() + 1);
+	for (const auto &shard : shards) {
+		for (size_t bucket = 0; bucket < snapshot.buckets.size(); ++bucket) {
+			const auto value = shard.buckets[bucket].load(std::memory_order_relaxed);
+			snapshot.buckets[bucket] += value;
+			snapshot.count += value;
+		}
+		snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+	}
+	return snapshot;
+}
+
+Metrics &Metrics::getInstance() {
+	return inject<Metrics>();
+}
+
+Metrics::Family &Metrics::getFamily(std::string_view name, std::string_view help, MetricType type) {
+	auto it = families.find(name);
+	if (it == families.end()) {
+		it = families.emplace(std::string(name), Family { type, std::string(help) }).first;
+	}
+	assert(it->second.type == type);
+	return it->second;
+}
+
+MetricCounter &Metrics::getCounter(std::string_view name, std::string_view help, std::string_view labels /* = "" */) {
+	std::scoped_lock lock(mutex);
+	auto &counters = getFamily(name, help, MetricType::Counter).counters;
+	auto it = counters.find(labels);
+	if (it == counters.end()) {
+		it = counters.emplace(std::string(labels), std::make_unique<MetricCounter>()).first;
+	}
+	return *it->second;
+}
+
+MetricGauge &Metrics::getGauge(std::string_view name, std::string_view help, std::string_view labels /* = "" */) {
+	std::scoped_lock lock(mutex);
+	auto &gauges = getFamily(name, help, MetricType::Gauge).gauges;
+	auto it = gauges.find(labels);
+	if (it == gauges.end()) {
+		it = gauges.emplace(std::string(labels), std::make_unique<MetricGauge>()).first;
+	}
+	return *it->second;
+}
+
+MetricHistogram &Metrics::getHistogram(std::string_view name, std::string_view help, const std::vector<uint64_t> &bounds, double divisor, std::string_view labels /* = "" */) {
+	std::scoped_lock lock(mutex);
+	auto &histograms = getFamily(name, help, MetricType::Histogram).histograms;
+	auto it = histograms.find(labels);
+	if (it == histograms.end()) {
+		it = histograms.emplace(std::string(labels), std::make_unique<MetricHistogram>(bounds, divisor)).first;
+	}
+	return *it->second;
+}
+
+void Metrics::addCollector(std::function<void()> &&collector) {
+	collectors.emplace_back(std::move(collector));
+}
+
+void Metrics::collect() {
+	if (collectors.empty()) {
+		return;
+	}
+
+	const auto now = std::chrono::steady_clock::now();
+	if (now - lastCollect < COLLECT_INTERVAL) {
+		return;
+	}
+
+	lastCollect = now;
+	for (const auto &collector : collectors) {
+		collector();
+	}
+}
+
+std::string Metrics::serialize() const {
+	const auto withLabels = [](std::string_view name, std::string_view labels, std::string_view extra = "") {
+		if (labels.empty() && extra.empty()) {
+			return std::string(name);
+		}
+		return fmt::format("{}{{{}{}{}}}", name, labels, !labels.empty() && !extra.empty() ? "," : "", extra);
+	};
+
+	std::string out;
+	std::scoped_lock lock(mutex);
+	for (const auto &[name, family] : families) {
+		static constexpr std::array<std::string_view, 3> typeNames = { "counter", "gauge", "histogram" };
+		fmt::format_to(std::back_inserter(out), "# HELP {} {}\n# TYPE {} {}\n", name, family.help, name, typeNames[static_cast<size_t>(family.type)]);
+
+		for (const auto &[labels, counter] : family.counters) {
+			fmt::format_to(std::back_inserter(out), "{} {}\n", withLabels(name, labels), counter->get());
+		}
+
+		for (const auto &[labels, gauge] : family.gauges) {
+			fmt::format_to(std::back_inserter(out), "{} {}\n", withLabels(name, labels), gauge->get());
+		}
+
+		for (const auto &[labels, histogram] : family.histograms) {
+			const auto snapshot = histogram->get();
+			const auto &bounds = histogram->getBounds();
+			const double divisor = histogram->getDivisor();
+			uint64_t cumulative = 0;
+			for (size_t bucket = 0; bucket < snapshot.buckets.size(); ++bucket) {
+				cumulative += snapshot.buckets[bucket];
+				const auto bound = bucket < bounds.size() ? fmt::format("le=\"{}\"", bounds[bucket] / divisor) : std::string("le=\"+Inf\"");
+				fmt::format_to(std::back_inserter(out), "{} {}\n", withLabels(name + "_bucket", labels, bound), cumulative);
+			}
+			fmt::format_to(std::back_inserter(out), "{} {}\n", withLabels(name + "_sum", labels), snapshot.sum / divisor);
+			fmt::format_to(std::back_inserter(out), "{} {}\n", withLabels(name + "_count", labels), snapshot.count);
+		}
+	}
+	return out;
+}
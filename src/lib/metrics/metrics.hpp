@@ -0,0 +1,176 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Every thread counts in its own shard, picked round robin the first time
+ * it records anything, so hot counters never bounce a cache line between
+ * the game, network and database threads. Shards are only summed up when
+ * the metrics are scraped.
+ */
+class MetricShards {
+public:
+	static constexpr size_t SHARD_COUNT = 16;
+
+	static size_t getShardIndex() {
+		static std::atomic<size_t> nextShard = 0;
+		static thread_local const size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+		return shard;
+	}
+};
+
+class MetricCounter {
+public:
+	void add(uint64_t value = 1) {
+		shards[MetricShards::getShardIndex()].value.fetch_add(value, std::memory_order_relaxed);
+	}
+
+	[[nodiscard]] uint64_t get() const {
+		uint64_t total = 0;
+		for (const auto &shard : shards) {
+			total += shard.value.load(std::memory_order_relaxed);
+		}
+		return total;
+	}
+
+private:
+	struct alignas(64) Shard {
+		std::atomic<uint64_t> value = 0;
+	};
+
+	std::array<Shard, MetricShards::SHARD_COUNT> shards;
+};
+
+// Set from the one place that knows the value, usually sampled on the game thread
+class MetricGauge {
+public:
+	void set(int64_t newValue) {
+		value.store(newValue, std::memory_order_relaxed);
+	}
+
+	void add(int64_t delta) {
+		value.fetch_add(delta, std::memory_order_relaxed);
+	}
+
+	[[nodiscard]] int64_t get() const {
+		return value.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<int64_t> value = 0;
+};
+
+/**
+ * Values are recorded as integers, e.g. microseconds, and exported divided
+ * by the divisor, e.g. 1e6 for seconds. Bucket bounds are upper bounds in the
+ * recorded unit, the +Inf bucket is implicit.
+ */
+class MetricHistogram {
+public:
+	static constexpr size_t MAX_BUCKETS = 16;
+
+	MetricHistogram(std::vector<uint64_t> bounds, double divisor);
+
+	// Ensures that we don't accidentally copy it
+	MetricHistogram(const MetricHistogram &) = delete;
+	MetricHistogram operator=(const MetricHistogram &) = delete;
+
+	void observe(uint64_t value) {
+		auto &shard = shards[MetricShards::getShardIndex()];
+		const auto bucket = std::ranges::lower_bound(bounds, value) - bounds.begin();
+		shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+		shard.sum.fetch_add(value, std::memory_order_relaxed);
+	}
+
+	struct Snapshot {
+		// Not cumulative, the last one is +Inf
+		std::vector<uint64_t> buckets;
+		uint64_t count = 0;
+		uint64_t sum = 0;
+	};
+
+	[[nodiscard]] Snapshot get() const;
+
+	[[nodiscard]] const std::vector<uint64_t> &getBounds() const {
+		return bounds;
+	}
+
+	[[nodiscard]] double getDivisor() const {
+		return divisor;
+	}
+
+private:
+	struct alignas(64) Shard {
+		std::array<std::atomic<uint64_t>, MAX_BUCKETS + 1> buckets {};
+		std::atomic<uint64_t> sum = 0;
+	};
+
+	const std::vector<uint64_t> bounds;
+	const double divisor;
+	std::array<Shard, MetricShards::SHARD_COUNT> shards;
+};
+
+/**
+ * Registry of every metric, written out in the Prometheus text format.
+ * Metrics are looked up once, by name and label set, and the reference
+ * kept by whoever records them: references stay valid for the process
+ * lifetime, lookups take a lock.
+ *
+ * Collectors run on the game thread about once a second, right before the
+ * dispatcher cycle ends, for gauges of state only the game thread may read.
+ */
+class Metrics {
+public:
+	static constexpr std::chrono::milliseconds COLLECT_INTERVAL { 1000 };
+
+	Metrics() = default;
+
+	// Ensures that we don't accidentally copy it
+	Metrics(const Metrics &) = delete;
+	Metrics operator=(const Metrics &) = delete;
+
+	static Metrics &getInstance();
+
+	// Labels are given already formatted, e.g. protocol="game"
+	MetricCounter &getCounter(std::string_view name, std::string_view help, std::string_view labels = "");
+	MetricGauge &getGauge(std::string_view name, std::string_view help, std::string_view labels = "");
+	MetricHistogram &getHistogram(std::string_view name, std::string_view help, const std::vector<uint64_t> &bounds, double divisor, std::string_view labels = "");
+
+	void addCollector(std::function<void()> &&collector);
+	// Game thread only, runs the collectors when the interval elapsed
+	void collect();
+
+	[[nodiscard]] std::string serialize() const;
+
+private:
+	enum class MetricType : uint8_t {
+		Counter,
+		Gauge,
+		Histogram,
+	};
+
+	struct Family {
+		MetricType type;
+		std::string help;
+		std::map<std::string, std::unique_ptr<MetricCounter>, std::less<>> counters;
+		std::map<std::string, std::unique_ptr<MetricGauge>, std::less<>> gauges;
+		std::map<std::string, std::unique_ptr<MetricHistogram>, std::less<>> histograms;
+	};
+
+	Family &getFamily(std::string_view name, std::string_view help, MetricType type);
+
+	mutable std::mutex mutex;
+	std::map<std::string, Family, std::less<>> families;
+
+	std::vector<std::function<void()>> collectors;
+	std::chrono::steady_clock::time_point lastCollect;
+};
+
+constexpr auto g_metrics = Metrics::getInstance;
@@ -0,0 +1,143 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lib/profiling/allocation_profiler.hpp"
+
+namespace {
+	// Contexts are string literals, a few hundred of them, the rest is charged to OTHER_CONTEXTS
+	constexpr size_t MAX_CONTEXTS = 1024;
+	constexpr size_t MAX_TYPES = 32;
+
+	struct ContextAllocations {
+		std::atomic<const char*> name = nullptr;
+		std::atomic<size_t> length = 0;
+		std::atomic<uint64_t> bytes = 0;
+		std::atomic<uint64_t> allocations = 0;
+	};
+
+	// Constant initialized, operator new can run before any constructor
+	constinit std::array<ContextAllocations, MAX_CONTEXTS> contexts {};
+	constinit ContextAllocations outsideTasks {};
+	constinit ContextAllocations otherContexts {};
+
+	constinit std::array<AllocationTypeCounter, MAX_TYPES> types {};
+	size_t typeCount = 0;
+	std::mutex typesMutex;
+	constinit AllocationTypeCounter otherTypes { "(other types)", 0 };
+
+	constinit thread_local const char* currentContext = nullptr;
+	constinit thread_local size_t currentLength = 0;
+
+	std::chrono::steady_clock::time_point lastReport = std::chrono::steady_clock::now();
+
+	// Open addressing by the address of the literal, an entry is never removed so a seen context is found again
+	ContextAllocations &findContext(const char* name, size_t length) noexcept {
+		auto index = (reinterpret_cast<uintptr_t>(name) >> 3) % MAX_CONTEXTS;
+		for (size_t probe = 0; probe < MAX_CONTEXTS; ++probe) {
+			auto &entry = contexts[index];
+			const char* expected = entry.name.load(std::memory_order_acquire);
+			if (expected == name) {
+				return entry;
+			}
+			if (!expected && entry.name.compare_exchange_strong(expected, name, std::memory_order_acq_rel)) {
+				entry.length.store(length, std::memory_order_release);
+				return entry;
+			}
+			if (expected == name) {
+				return entry;
+			}
+			index = (index + 1) % MAX_CONTEXTS;
+		}
+		return otherContexts;
+	}
+}
+
+#ifdef CANARY_ALLOCATION_PROFILER
+AllocationProfiler::Scope::Scope(std::string_view context) noexcept :
+	previousContext(currentContext), previousLength(currentLength) {
+	currentContext = context.data();
+	currentLength = context.size();
+}
+
+AllocationProfiler::Scope::~Scope() {
+	currentContext = previousContext;
+	currentLength = previousLength;
+}
+#endif
+
+void AllocationProfiler::onAllocate(size_t size) noexcept {
+	auto &entry = currentContext ? findContext(currentContext, currentLength) : outsideTasks;
+	entry.bytes.fetch_add(size, std::memory_order_relaxed);
+	entry.allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+AllocationTypeCounter &AllocationProfiler::registerType(std::string_view name, size_t size) noexcept {
+	std::scoped_lock lock(typesMutex);
+	if (typeCount == MAX_TYPES) {
+		return otherTypes;
+	}
+	auto &counter = types[typeCount++];
+	counter.name = name;
+	counter.size = size;
+	return counter;
+}
+
+void AllocationProfiler::logReport(size_t maxContexts) {
+	const auto now = std::chrono::steady_clock::now();
+	const auto elapsed = std::max<double>(1, std::chrono::duration_cast<std::chrono::seconds>(now - lastReport).count());
+	lastReport = now;
+
+	struct Sample {
+		std::string_view name;
+		uint64_t bytes;
+		uint64_t allocations;
+	};
+
+	std::vector<Sample> samples;
+	uint64_t totalBytes = 0;
+	uint64_t totalAllocations = 0;
+	const auto take = [&](ContextAllocations &entry, std::string_view name) {
+		const auto bytes = entry.bytes.exchange(0, std::memory_order_relaxed);
+		const auto allocations = entry.allocations.exchange(0, std::memory_order_relaxed);
+		totalBytes += bytes;
+		totalAllocations += allocations;
+		if (allocations != 0) {
+			samples.emplace_back(Sample { name, bytes, allocations });
+		}
+	};
+
+	for (auto &entry : contexts) {
+		const char* name = entry.name.load(std::memory_order_acquire);
+		const auto length = entry.length.load(std::memory_order_acquire);
+		// Still being inserted, its allocations are reported next time
+		if (name && length != 0) {
+			take(entry, std::string_view(name, length));
+		}
+	}
+	take(outsideTasks, OUTSIDE_TASKS);
+	take(otherContexts, OTHER_CONTEXTS);
+
+	std::ranges::sort(samples, std::ranges::greater {}, &Sample::bytes);
+	g_logger().info("[AllocationProfiler] {:.1f} KB/s in {:.0f} allocations/s over the last {:.0f} seconds, top {} contexts:", totalBytes / elapsed / 1024, totalAllocations / elapsed, elapsed, maxContexts);
+	for (const auto &sample : samples | std::views::take(maxContexts)) {
+		g_logger().info(
+			"[AllocationProfiler] {}: {:.1f} KB/s, {:.0f} allocations/s, {} bytes each on average",
+			sample.name, sample.bytes / elapsed / 1024, sample.allocations / elapsed, sample.bytes / sample.allocations
+		);
+	}
+
+	std::scoped_lock lock(typesMutex);
+	for (size_t i = 0; i < typeCount; ++i) {
+		const auto live = types[i].live.load(std::memory_order_relaxed);
+		// Subclasses are counted under their base, so the bytes are the least they take
+		g_logger().info("[AllocationProfiler] live {}: {} objects, at least {:.1f} KB", types[i].name, live, static_cast<double>(live) * types[i].size / 1024);
+	}
+}
@@ -0,0 +1,134 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Heap accounting, compiled in with -DOPTIONS_ENABLE_ALLOCATION_PROFILER=ON.
+ * The global operator new then charges every allocation to the dispatcher
+ * task context running on its thread, allocations outside a task go to
+ * OUTSIDE_TASKS. The types below count their live objects, whoever
+ * allocated them (Item comes from a slab pool, not from operator new).
+ *
+ * Freed bytes are not charged back: the unsized delete does not carry the
+ * size, so the report is allocation rate, which is what finds the code that
+ * calls make_shared on the hot path. Growth shows in the live objects.
+ *
+ * Without the option, Scope and AllocationTracked are empty and the hooks
+ * are not compiled.
+ */
+
+class Item;
+class Tile;
+class Creature;
+class Condition;
+class OutputMessage;
+class Task;
+
+// Name every tracked type is reported under
+template <typename T>
+struct AllocationTypeName;
+
+#define ALLOCATION_TYPE_NAME(type)                             \
+	template <>                                                \
+	struct AllocationTypeName<type> {                          \
+		static constexpr std::string_view value = #type;       \
+	}
+
+ALLOCATION_TYPE_NAME(Item);
+ALLOCATION_TYPE_NAME(Tile);
+ALLOCATION_TYPE_NAME(Creature);
+ALLOCATION_TYPE_NAME(Condition);
+ALLOCATION_TYPE_NAME(OutputMessage);
+ALLOCATION_TYPE_NAME(Task);
+
+#undef ALLOCATION_TYPE_NAME
+
+struct AllocationTypeCounter {
+	std::string_view name;
+	size_t size = 0;
+	std::atomic<int64_t> live = 0;
+};
+
+class AllocationProfiler {
+public:
+	static constexpr std::string_view OUTSIDE_TASKS = "(outside tasks)";
+	static constexpr std::string_view OTHER_CONTEXTS = "(other contexts)";
+
+	static constexpr bool isEnabled() {
+#ifdef CANARY_ALLOCATION_PROFILER
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	/**
+	 * Charges the allocations of this thread to the context until the end of
+	 * the scope. The context must have static storage duration, as the one
+	 * of a task, it is kept by its address.
+	 */
+	class Scope {
+	public:
+#ifdef CANARY_ALLOCATION_PROFILER
+		explicit Scope(std::string_view context) noexcept;
+		~Scope();
+#else
+		explicit Scope(std::string_view) noexcept { }
+#endif
+
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+#ifdef CANARY_ALLOCATION_PROFILER
+	private:
+		const char* previousContext;
+		size_t previousLength;
+#endif
+	};
+
+	// Called by operator new, must not allocate
+	static void onAllocate(size_t size) noexcept;
+
+	// Counter of a tracked type, registered once per type
+	static AllocationTypeCounter &registerType(std::string_view name, size_t size) noexcept;
+
+	// Logs and resets the allocations per context since the last report, the most allocated first, then the live objects per type
+	static void logReport(size_t maxContexts);
+};
+
+/**
+ * Base of the types whose live objects are reported, it counts their
+ * constructions and destructions.
+ */
+template <typename T>
+class AllocationTracked {
+#ifdef CANARY_ALLOCATION_PROFILER
+protected:
+	AllocationTracked() noexcept {
+		counter().live.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	AllocationTracked(const AllocationTracked &) noexcept {
+		counter().live.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	AllocationTracked &operator=(const AllocationTracked &) noexcept = default;
+
+	~AllocationTracked() {
+		counter().live.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+private:
+	static AllocationTypeCounter &counter() {
+		static AllocationTypeCounter &typeCounter = AllocationProfiler::registerType(AllocationTypeName<T>::value, sizeof(T));
+		return typeCounter;
+	}
+#endif
+};
@@ -0,0 +1,36 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Tracy instrumentation, compiled in with -DOPTIONS_ENABLE_PROFILER=ON.
+ * Otherwise every macro expands to nothing, so zones can stay in hot paths.
+ *
+ * CANARY_PROFILE_ZONE opens a zone until the end of the scope, the name
+ * must be a string literal. Dynamic names, like a task context, go in the
+ * zone text. Every dispatcher cycle is a frame.
+ */
+#ifdef CANARY_PROFILER
+	#include <tracy/Tracy.hpp>
+
+	#define CANARY_PROFILE_ZONE(name) ZoneScopedN(name)
+	#define CANARY_PROFILE_ZONE_TEXT(text) \
+		do { \
+			const std::string_view zoneText_(text); \
+			ZoneText(zoneText_.data(), zoneText_.size()); \
+		} while (false)
+	#define CANARY_PROFILE_FRAME(name) FrameMarkNamed(name)
+	#define CANARY_PROFILE_THREAD(name) tracy::SetThreadName(name)
+#else
+	#define CANARY_PROFILE_ZONE(name)
+	#define CANARY_PROFILE_ZONE_TEXT(text)
+	#define CANARY_PROFILE_FRAME(name)
+	#define CANARY_PROFILE_THREAD(name)
+#endif
@@ -0,0 +1,83 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lib/thread/job_group.hpp"
+
+JobGroup::JobGroup(ThreadPool &threadPool) :
+	threadPool(threadPool) { }
+
+JobGroup::~JobGroup() {
+	try {
+		wait();
+	} catch (...) {
+	}
+}
+
+void JobGroup::run(std::function<void(void)> job) {
+	{
+		std::scoped_lock lock(state->mutex);
+		state->jobs.emplace_back(std::move(job));
+		state->pending.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// One steal attempt per job, it finds the deque empty if the owner was faster
+	threadPool.addLoad([state = state]() {
+		runNext(*state, false);
+	});
+}
+
+void JobGroup::wait() {
+	while (runNext(*state, true)) { }
+
+	// The remaining jobs are running on pool threads
+	size_t pending = state->pending.load(std::memory_order_acquire);
+	while (pending != 0) {
+		state->pending.wait(pending, std::memory_order_acquire);
+		pending = state->pending.load(std::memory_order_acquire);
+	}
+
+	if (state->error) {
+		std::rethrow_exception(std::exchange(state->error, nullptr));
+	}
+}
+
+bool JobGroup::runNext(State &state, bool owner) {
+	std::function<void(void)> job;
+	{
+		std::scoped_lock lock(state.mutex);
+		if (state.jobs.empty()) {
+			return false;
+		}
+
+		// The owner works from the back, thieves from the front, so they rarely want the same job
+		if (owner) {
+			job = std::move(state.jobs.back());
+			state.jobs.pop_back();
+		} else {
+			job = std::move(state.jobs.front());
+			state.jobs.pop_front();
+		}
+	}
+
+	try {
+		job();
+	} catch (...) {
+		std::scoped_lock lock(state.mutex);
+		if (!state.error) {
+			state.error = std::current_exception();
+		}
+	}
+
+	if (state.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		state.pending.notify_all();
+	}
+	return true;
+}
@@ -0,0 +1,86 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#pragma once
+
+#include "lib/thread/thread_pool.hpp"
+
+/**
+ * Fork/join group of jobs on the compute pool.
+ * The thread that waits does not sleep: it takes jobs from the back of the
+ * group deque while pool threads steal from the front, so a group finishes
+ * even when every pool thread is busy (or the pool is not started yet).
+ *
+ * Meant for read-only phases of the game thread: it blocks in wait() until
+ * every job finished, so game state can not change under the jobs.
+ */
+class JobGroup {
+public:
+	explicit JobGroup(ThreadPool &threadPool);
+
+	// Waits for the remaining jobs, errors are discarded
+	~JobGroup();
+
+	// Ensures that we don't accidentally copy it
+	JobGroup(const JobGroup &) = delete;
+	JobGroup operator=(const JobGroup &) = delete;
+
+	void run(std::function<void(void)> job);
+
+	// Returns when every job finished, rethrows the first exception thrown by a job
+	void wait();
+
+private:
+	struct State {
+		std::mutex mutex;
+		std::deque<std::function<void(void)>> jobs;
+		std::atomic<size_t> pending = 0;
+		std::exception_ptr error;
+	};
+
+	static bool runNext(State &state, bool owner);
+
+	ThreadPool &threadPool;
+	// Shared with the pool threads, a late steal attempt may outlive the group
+	std::shared_ptr<State> state = std::make_shared<State>();
+};
+
+/**
+ * Calls fn(i) for every i in [begin, end) on the compute pool and the
+ * calling thread, returning once all calls finished.
+ * @param grain indexes per job, 0 picks one that gives every thread a few jobs
+ */
+template <typename F>
+void parallelFor(ThreadPool &threadPool, size_t begin, size_t end, F &&fn, size_t grain = 0) {
+	if (begin >= end) {
+		return;
+	}
+
+	const size_t count = end - begin;
+	if (grain == 0) {
+		grain = std::max<size_t>(1, count / (std::max<size_t>(1, threadPool.getThreadCount()) * 4));
+	}
+
+	if (count <= grain) {
+		for (size_t i = begin; i < end; ++i) {
+			fn(i);
+		}
+		return;
+	}
+
+	JobGroup group(threadPool);
+	for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += grain) {
+		const size_t chunkEnd = std::min(end, chunkBegin + grain);
+		group.run([&fn, chunkBegin, chunkEnd]() {
+			for (size_t i = chunkBegin; i < chunkEnd; ++i) {
+				fn(i);
+			}
+		});
+	}
+	group.wait();
+}
@@ -0,0 +1,90 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#pragma once
+
+/**
+ * Unbounded lock-free multi-producer single-consumer queue (Vyukov).
+ * Any thread may push, but only one thread at a time is allowed to pop.
+ * Producers never block each other: a push is a single atomic exchange.
+ */
+template <typename T>
+class MPSCQueue {
+public:
+	MPSCQueue() :
+		head(new Node()), tail(head.load(std::memory_order_relaxed)) { }
+
+	~MPSCQueue() {
+		while (consume([](T &&) { })) { }
+		delete tail;
+	}
+
+	// Ensures that we don't accidentally copy it
+	MPSCQueue(const MPSCQueue &) = delete;
+	MPSCQueue operator=(const MPSCQueue &) = delete;
+
+	void push(T value) {
+		auto node = new Node(std::move(value));
+		Node* prev = head.exchange(node, std::memory_order_acq_rel);
+		prev->next.store(node, std::memory_order_release);
+	}
+
+	/**
+	 * Consumer side only. Returns false when the queue is empty, or when
+	 * a producer is between its exchange and its link (it will be visible
+	 * on the next call).
+	 */
+	bool pop(T &value) {
+		return consume([&value](T &&element) { value = std::move(element); });
+	}
+
+	/**
+	 * Consumer side only. Moves every element currently visible into the
+	 * given container and returns how many were moved.
+	 */
+	template <typename Container>
+	size_t popAll(Container &container) {
+		size_t count = 0;
+		while (consume([&container](T &&element) { container.emplace_back(std::move(element)); })) {
+			++count;
+		}
+		return count;
+	}
+
+	[[nodiscard]] bool empty() const {
+		return tail->next.load(std::memory_order_acquire) == nullptr;
+	}
+
+private:
+	struct Node {
+		Node() = default;
+		explicit Node(T &&value) :
+			value(std::move(value)) { }
+
+		std::atomic<Node*> next { nullptr };
+		// Empty on the stub node, so T does not need to be default constructible
+		std::optional<T> value;
+	};
+
+	template <typename F>
+	bool consume(F &&f) {
+		Node* next = tail->next.load(std::memory_order_acquire);
+		if (next == nullptr) {
+			return false;
+		}
+
+		f(std::move(*next->value));
+		next->value.reset();
+		delete tail;
+		tail = next;
+		return true;
+	}
+
+	std::atomic<Node*> head;
+	Node* tail;
+};
@@ -9,33 +9,62 @@
 
 #include "pch.hpp"
 #include "lib/thread/thread_pool.hpp"
+#include "lib/profiling/profiler.hpp"
 #include "utils/tools.hpp"
 
+#ifdef __linux__
+	#include <pthread.h>
+#endif
+
 #ifndef DEFAULT_NUMBER_OF_THREADS
 	#define DEFAULT_NUMBER_OF_THREADS 4
 #endif
 
+#ifndef DEFAULT_NUMBER_OF_BLOCKING_THREADS
+	#define DEFAULT_NUMBER_OF_BLOCKING_THREADS 4
+#endif
+
 ThreadPool::ThreadPool(Logger &logger) :
 	logger(logger) {
-	start();
 }
 
-void ThreadPool::start() {
+void ThreadPool::start(uint16_t computeThreads /* = 0*/, uint16_t blockingThreadCount /* = 0*/, bool pinThreads /* = false*/) {
+	if (!threads.empty()) {
+		return;
+	}
+
 	logger.info("Setting up thread pool");
 
+	const auto cores = std::max<uint32_t>(1, getNumberOfCores());
+
 	/**
 	 * Regardless of how many cores your computer have, we want at least
 	 * 4 threads because, even though they won't improve processing they
 	 * will make processing non-blocking in some way and that would allow
 	 * single core computers to process things concurrently, but not in parallel.
 	 */
-	int nThreads = std::max<int>(static_cast<int>(getNumberOfCores()), DEFAULT_NUMBER_OF_THREADS);
+	const int nThreads = computeThreads != 0 ? computeThreads : std::max<int>(static_cast<int>(cores), DEFAULT_NUMBER_OF_THREADS);
+	const int nBlocking = blockingThreadCount != 0 ? blockingThreadCount : DEFAULT_NUMBER_OF_BLOCKING_THREADS;
+
+	size_t pinned = 0;
+	for (int i = 0; i < nThreads; ++i) {
+		auto &thread = threads.emplace_back([this] {
+			CANARY_PROFILE_THREAD("compute");
+			ioService.run();
+		});
+		if (pinThreads && pinThread(thread, i % cores)) {
+			++pinned;
+		}
+	}
 
-	for (std::size_t i = 0; i < nThreads; ++i) {
-		threads.emplace_back([this] { ioService.run(); });
+	for (int i = 0; i < nBlocking; ++i) {
+		blockingThreads.emplace_back([this] {
+			CANARY_PROFILE_THREAD("blocking");
+			blockingIoService.run();
+		});
 	}
 
-	logger.info("Running with {} threads.", threads.size());
+	logger.info("Running with {} compute threads ({} pinned) and {} blocking threads.", threads.size(), pinned, blockingThreads.size());
 }
 
 void ThreadPool::shutdown() {
@@ -46,6 +75,7 @@ void ThreadPool::shutdown() {
 	logger.info("Shutting down thread pool...");
 
 	ioService.stop();
+	blockingIoService.stop();
 
 	for (std::size_t i = 0; i < threads.size(); i++) {
 		logger.debug("Joining thread {}/{}.", i + 1, threads.size());
@@ -54,15 +84,33 @@ void ThreadPool::shutdown() {
 			threads[i].join();
 		}
 	}
+
+	for (auto &thread : blockingThreads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
 }
 
 asio::io_context &ThreadPool::getIoContext() {
 	return ioService;
 }
 
+asio::io_context &ThreadPool::getBlockingIoContext() {
+	return blockingIoService;
+}
+
 void ThreadPool::addLoad(const std::function<void(void)> &load) {
-	asio::post(ioService, [this, load]() {
-		if (ioService.stopped()) {
+	post(ioService, load);
+}
+
+void ThreadPool::addBlockingLoad(const std::function<void(void)> &load) {
+	post(blockingIoService, load);
+}
+
+void ThreadPool::post(asio::io_context &context, const std::function<void(void)> &load) {
+	asio::post(context, [this, &context, load]() {
+		if (context.stopped()) {
 			logger.error("Shutting down, cannot execute task.");
 			return;
 		}
@@ -70,3 +118,23 @@ void ThreadPool::addLoad(const std::function<void(void)> &load) {
 		load();
 	});
 }
+
+bool ThreadPool::pinThread(std::jthread &thread, uint32_t core) {
+#ifdef _WIN32
+	if (core >= sizeof(DWORD_PTR) * 8) {
+		return false;
+	}
+	return SetThreadAffinityMask(thread.native_handle(), DWORD_PTR { 1 } << core) != 0;
+#elif defined(__linux__)
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(core, &cpuSet);
+	if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet) != 0) {
+		logger.warn("Failed to pin thread pool thread to core {}", core);
+		return false;
+	}
+	return true;
+#else
+	return false;
+#endif
+}
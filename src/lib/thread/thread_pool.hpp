@@ -10,6 +10,16 @@
 
 #include "lib/logging/logger.hpp"
 
+/**
+ * Two pools of worker threads, each running its own io_context:
+ * - compute: timers and short CPU bound jobs (addLoad)
+ * - blocking: work that sleeps on I/O, like database queries and HTTP requests (addBlockingLoad)
+ * Keeping them apart means a slow query can not delay a timer or a compute job.
+ * Network connections run on the ServiceManager io_context, not here.
+ *
+ * The threads are only spawned by start(), once the config is loaded. Work added
+ * before that is queued and runs as soon as the pools are up.
+ */
 class ThreadPool {
 public:
 	explicit ThreadPool(Logger &logger);
@@ -18,14 +28,32 @@ public:
 	ThreadPool(const ThreadPool &) = delete;
 	ThreadPool operator=(const ThreadPool &) = delete;
 
-	void start();
+	/**
+	 * @param computeThreads 0 uses one thread per core
+	 * @param blockingThreadCount 0 uses the default
+	 * @param pinThreads pins each compute thread to its own core
+	 */
+	void start(uint16_t computeThreads = 0, uint16_t blockingThreadCount = 0, bool pinThreads = false);
 	void shutdown();
 	asio::io_context &getIoContext();
+	asio::io_context &getBlockingIoContext();
 	void addLoad(const std::function<void(void)> &load);
+	void addBlockingLoad(const std::function<void(void)> &load);
+
+	// Compute threads, 0 until start()
+	[[nodiscard]] size_t getThreadCount() const {
+		return threads.size();
+	}
 
 private:
+	void post(asio::io_context &context, const std::function<void(void)> &load);
+	bool pinThread(std::jthread &thread, uint32_t core);
+
 	Logger &logger;
 	asio::io_context ioService;
+	asio::io_context blockingIoService;
 	std::vector<std::jthread> threads;
+	std::vector<std::jthread> blockingThreads;
 	asio::io_context::work work { ioService };
+	asio::io_context::work blockingWork { blockingIoService };
 };
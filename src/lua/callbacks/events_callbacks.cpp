@@ -30,6 +30,7 @@ EventsCallbacks &EventsCallbacks::getInstance() {
 
 void EventsCallbacks::addCallback(const std::shared_ptr<EventCallback> callback) {
 	m_callbacks.push_back(callback);
+	m_callbacksByType[static_cast<size_t>(callback->getType())].push_back(callback);
 }
 
 std::vector<std::shared_ptr<EventCallback>> EventsCallbacks::getCallbacks() const {
@@ -37,18 +38,20 @@ std::vector<std::shared_ptr<EventCallback>> EventsCallbacks::getCallbacks() cons
 }
 
 std::vector<std::shared_ptr<EventCallback>> EventsCallbacks::getCallbacksByType(EventCallback_t type) const {
-	std::vector<std::shared_ptr<EventCallback>> eventCallbacks;
-	for (auto callback : getCallbacks()) {
-		if (callback->getType() != type) {
-			continue;
-		}
-
-		eventCallbacks.push_back(callback);
-	}
-
-	return eventCallbacks;
+	return m_callbacksByType[static_cast<size_t>(type)];
 }
 
 void EventsCallbacks::clear() {
 	m_callbacks.clear();
+	for (auto &callbacks : m_callbacksByType) {
+		callbacks.clear();
+	}
+}
+
+void EventsCallbacks::clearFileCallbacks(const std::string &file) {
+	const auto fromFile = [&file](const auto &callback) { return callback->getScriptFile() == file; };
+	std::erase_if(m_callbacks, fromFile);
+	for (auto &callbacks : m_callbacksByType) {
+		std::erase_if(callbacks, fromFile);
+	}
 }
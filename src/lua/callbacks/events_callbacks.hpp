@@ -69,6 +69,12 @@ public:
 	 */
 	void clear();
 
+	/**
+	 * @brief Removes the callbacks the given script file registered, for hot reload.
+	 * @param file Path of the script file, as it was loaded.
+	 */
+	void clearFileCallbacks(const std::string &file);
+
 	/**
 	 * @brief Executes the specified event callback.
 	 * @param eventType The type of event to trigger.
@@ -77,15 +83,16 @@ public:
 	 */
 	template <typename CallbackFunc, typename... Args>
 	void executeCallback(EventCallback_t eventType, CallbackFunc callbackFunc, Args &&... args) {
-		for (const auto &callback : getCallbacksByType(eventType)) {
-			auto argsCopy = std::make_tuple(args...);
+		const auto &callbacks = m_callbacksByType[static_cast<size_t>(eventType)];
+		if (callbacks.empty()) {
+			return;
+		}
+
+		// By index and holding the callback, a script may register or reload callbacks while it runs
+		for (size_t i = 0; i < callbacks.size(); ++i) {
+			const auto callback = callbacks[i];
 			if (callback && callback->isLoadedCallback()) {
-				std::apply(
-					[&callback, &callbackFunc](auto &&... args) {
-						((*callback).*callbackFunc)(std::forward<decltype(args)>(args)...);
-					},
-					argsCopy
-				);
+				((*callback).*callbackFunc)(args...);
 			}
 		}
 	}
@@ -99,17 +106,16 @@ public:
 	 */
 	template <typename CallbackFunc, typename... Args>
 	bool checkCallback(EventCallback_t eventType, CallbackFunc callbackFunc, Args &&... args) {
-		bool allCallbacksSucceeded = true;
+		const auto &callbacks = m_callbacksByType[static_cast<size_t>(eventType)];
+		if (callbacks.empty()) {
+			return true;
+		}
 
-		for (const auto &callback : getCallbacksByType(eventType)) {
-			auto argsCopy = std::make_tuple(args...);
+		bool allCallbacksSucceeded = true;
+		for (size_t i = 0; i < callbacks.size(); ++i) {
+			const auto callback = callbacks[i];
 			if (callback && callback->isLoadedCallback()) {
-				bool callbackResult = std::apply(
-					[&callback, &callbackFunc](auto &&... args) {
-						return ((*callback).*callbackFunc)(std::forward<decltype(args)>(args)...);
-					},
-					argsCopy
-				);
+				bool callbackResult = ((*callback).*callbackFunc)(args...);
 				allCallbacksSucceeded = allCallbacksSucceeded && callbackResult;
 			}
 		}
@@ -119,6 +125,8 @@ public:
 private:
 	// Container for storing registered event callbacks.
 	std::vector<std::shared_ptr<EventCallback>> m_callbacks;
+	// The same callbacks bucketed by event type, so dispatching never filters
+	std::array<std::vector<std::shared_ptr<EventCallback>>, magic_enum::enum_count<EventCallback_t>()> m_callbacksByType;
 };
 
 constexpr auto g_callbacks = EventsCallbacks::getInstance;
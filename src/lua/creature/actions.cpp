@@ -26,6 +26,18 @@ void Actions::clear() {
 	actionPositionMap.clear();
 }
 
+void Actions::clearFileEvents(const std::string &file) {
+	const auto fromFile = [&file](const auto &entry) { return entry.second->getScriptFile() == file; };
+	for (auto &action : useItemMap) {
+		if (action && action->getScriptFile() == file) {
+			action = nullptr;
+		}
+	}
+	phmap::erase_if(uniqueItemMap, fromFile);
+	phmap::erase_if(actionItemMap, fromFile);
+	phmap::erase_if(actionPositionMap, fromFile);
+}
+
 bool Actions::registerLuaItemEvent(const std::shared_ptr<Action> action) {
 	auto itemIdVector = action->getItemIdsVector();
 	if (itemIdVector.empty()) {
@@ -224,9 +236,8 @@ std::shared_ptr<Action> Actions::getAction(std::shared_ptr<Item> item) {
 		}
 	}
 
-	auto it = useItemMap.find(item->getID());
-	if (it != useItemMap.end()) {
-		return it->second;
+	if (hasItemId(item->getID())) {
+		return useItemMap[item->getID()];
 	}
 
 	if (auto iteratePositions = actionPositionMap.find(item->getPosition());
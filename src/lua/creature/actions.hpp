@@ -157,6 +157,8 @@ public:
 	bool registerLuaEvent(const std::shared_ptr<Action> action);
 	// Clear maps for reloading
 	void clear();
+	// Unregisters the events the given script file registered, for hot reload
+	void clearFileEvents(const std::string &file);
 
 private:
 	bool hasPosition(Position position) const {
@@ -167,7 +169,7 @@ private:
 		return false;
 	}
 
-	[[nodiscard]] std::map<Position, std::shared_ptr<Action>> getPositionsMap() const {
+	[[nodiscard]] const phmap::flat_hash_map<Position, std::shared_ptr<Action>> &getPositionsMap() const {
 		return actionPositionMap;
 	}
 
@@ -176,15 +178,14 @@ private:
 	}
 
 	bool hasItemId(uint16_t itemId) const {
-		if (auto it = useItemMap.find(itemId);
-			it != useItemMap.end()) {
-			return true;
-		}
-		return false;
+		return itemId < useItemMap.size() && useItemMap[itemId];
 	}
 
 	void setItemId(uint16_t itemId, const std::shared_ptr<Action> action) {
-		useItemMap.try_emplace(itemId, action);
+		if (itemId >= useItemMap.size()) {
+			useItemMap.resize(itemId + 1);
+		}
+		useItemMap[itemId] = action;
 	}
 
 	bool hasUniqueId(uint16_t uniqueId) const {
@@ -214,11 +215,12 @@ private:
 	ReturnValue internalUseItem(std::shared_ptr<Player> player, const Position &pos, uint8_t index, std::shared_ptr<Item> item, bool isHotkey);
 	static void showUseHotkeyMessage(std::shared_ptr<Player> player, std::shared_ptr<Item> item, uint32_t count);
 
-	using ActionUseMap = std::map<uint16_t, std::shared_ptr<Action>>;
-	ActionUseMap useItemMap;
+	using ActionUseMap = phmap::flat_hash_map<uint16_t, std::shared_ptr<Action>>;
+	// Indexed by item id, empty where no action is registered
+	std::vector<std::shared_ptr<Action>> useItemMap;
 	ActionUseMap uniqueItemMap;
 	ActionUseMap actionItemMap;
-	std::map<Position, std::shared_ptr<Action>> actionPositionMap;
+	phmap::flat_hash_map<Position, std::shared_ptr<Action>> actionPositionMap;
 
 	std::shared_ptr<Action> getAction(std::shared_ptr<Item> item);
 };
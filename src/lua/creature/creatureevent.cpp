@@ -19,6 +19,14 @@ void CreatureEvents::clear() {
 	}
 }
 
+void CreatureEvents::clearFileEvents(const std::string &file) {
+	for (auto &[name, event] : creatureEvents) {
+		if (event->isLoaded() && event->getScriptFile() == file) {
+			event->clearEvent();
+		}
+	}
+}
+
 bool CreatureEvents::registerLuaEvent(const std::shared_ptr<CreatureEvent> creatureEvent) {
 	if (creatureEvent->getEventType() == CREATURE_EVENT_NONE) {
 		g_logger().error(
@@ -161,6 +169,7 @@ void CreatureEvent::copyEvent(const std::shared_ptr<CreatureEvent> creatureEvent
 	setScriptId(creatureEvent->getScriptId());
 	setScriptInterface(creatureEvent->getScriptInterface());
 	setLoadedCallback(creatureEvent->isLoadedCallback());
+	setScriptFile(creatureEvent->getScriptFile());
 	loaded = creatureEvent->loaded;
 }
 
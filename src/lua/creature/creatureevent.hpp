@@ -87,6 +87,8 @@ public:
 	bool registerLuaEvent(const std::shared_ptr<CreatureEvent> event);
 	void removeInvalidEvents();
 	void clear();
+	// Unloads the events the given script file registered, creatures keep them until the file registers them again
+	void clearFileEvents(const std::string &file);
 
 private:
 	// creature events
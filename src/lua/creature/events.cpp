@@ -14,6 +14,69 @@
 #include "items/item.hpp"
 #include "creatures/players/player.hpp"
 
+namespace {
+	struct EventHandlerInfo {
+		std::string_view className;
+		std::string_view methodName;
+		EventHandler_t handler;
+	};
+
+	// The class and method events.xml names each handler with
+	constexpr std::array EVENT_HANDLERS = {
+		EventHandlerInfo { "Creature", "onChangeOutfit", EventHandler_t::CREATURE_ON_CHANGE_OUTFIT },
+		EventHandlerInfo { "Creature", "onAreaCombat", EventHandler_t::CREATURE_ON_AREA_COMBAT },
+		EventHandlerInfo { "Creature", "onTargetCombat", EventHandler_t::CREATURE_ON_TARGET_COMBAT },
+		EventHandlerInfo { "Creature", "onHear", EventHandler_t::CREATURE_ON_HEAR },
+		EventHandlerInfo { "Creature", "onDrainHealth", EventHandler_t::CREATURE_ON_DRAIN_HEALTH },
+		EventHandlerInfo { "Party", "onJoin", EventHandler_t::PARTY_ON_JOIN },
+		EventHandlerInfo { "Party", "onLeave", EventHandler_t::PARTY_ON_LEAVE },
+		EventHandlerInfo { "Party", "onDisband", EventHandler_t::PARTY_ON_DISBAND },
+		EventHandlerInfo { "Party", "onShareExperience", EventHandler_t::PARTY_ON_SHARE_EXPERIENCE },
+		EventHandlerInfo { "Player", "onBrowseField", EventHandler_t::PLAYER_ON_BROWSE_FIELD },
+		EventHandlerInfo { "Player", "onLook", EventHandler_t::PLAYER_ON_LOOK },
+		EventHandlerInfo { "Player", "onLookInBattleList", EventHandler_t::PLAYER_ON_LOOK_IN_BATTLE_LIST },
+		EventHandlerInfo { "Player", "onLookInTrade", EventHandler_t::PLAYER_ON_LOOK_IN_TRADE },
+		EventHandlerInfo { "Player", "onLookInShop", EventHandler_t::PLAYER_ON_LOOK_IN_SHOP },
+		EventHandlerInfo { "Player", "onMoveItem", EventHandler_t::PLAYER_ON_MOVE_ITEM },
+		EventHandlerInfo { "Player", "onItemMoved", EventHandler_t::PLAYER_ON_ITEM_MOVED },
+		EventHandlerInfo { "Player", "onChangeZone", EventHandler_t::PLAYER_ON_CHANGE_ZONE },
+		EventHandlerInfo { "Player", "onChangeHazard", EventHandler_t::PLAYER_ON_CHANGE_HAZARD },
+		EventHandlerInfo { "Player", "onMoveCreature", EventHandler_t::PLAYER_ON_MOVE_CREATURE },
+		EventHandlerInfo { "Player", "onReportRuleViolation", EventHandler_t::PLAYER_ON_REPORT_RULE_VIOLATION },
+		EventHandlerInfo { "Player", "onReportBug", EventHandler_t::PLAYER_ON_REPORT_BUG },
+		EventHandlerInfo { "Player", "onTurn", EventHandler_t::PLAYER_ON_TURN },
+		EventHandlerInfo { "Player", "onTradeRequest", EventHandler_t::PLAYER_ON_TRADE_REQUEST },
+		EventHandlerInfo { "Player", "onTradeAccept", EventHandler_t::PLAYER_ON_TRADE_ACCEPT },
+		EventHandlerInfo { "Player", "onGainExperience", EventHandler_t::PLAYER_ON_GAIN_EXPERIENCE },
+		EventHandlerInfo { "Player", "onLoseExperience", EventHandler_t::PLAYER_ON_LOSE_EXPERIENCE },
+		EventHandlerInfo { "Player", "onGainSkillTries", EventHandler_t::PLAYER_ON_GAIN_SKILL_TRIES },
+		EventHandlerInfo { "Player", "onRequestQuestLog", EventHandler_t::PLAYER_ON_REQUEST_QUEST_LOG },
+		EventHandlerInfo { "Player", "onRequestQuestLine", EventHandler_t::PLAYER_ON_REQUEST_QUEST_LINE },
+		EventHandlerInfo { "Player", "onStorageUpdate", EventHandler_t::PLAYER_ON_STORAGE_UPDATE },
+		EventHandlerInfo { "Player", "onRemoveCount", EventHandler_t::PLAYER_ON_REMOVE_COUNT },
+		EventHandlerInfo { "Player", "onCombat", EventHandler_t::PLAYER_ON_COMBAT },
+		EventHandlerInfo { "Player", "onInventoryUpdate", EventHandler_t::PLAYER_ON_INVENTORY_UPDATE },
+		EventHandlerInfo { "Monster", "onDropLoot", EventHandler_t::MONSTER_ON_DROP_LOOT },
+		EventHandlerInfo { "Monster", "onSpawn", EventHandler_t::MONSTER_ON_SPAWN },
+		EventHandlerInfo { "Npc", "onSpawn", EventHandler_t::NPC_ON_SPAWN },
+	};
+
+	// Looked up by handler, so the entries must follow the enum
+	constexpr bool isHandlerTableOrdered() {
+		for (size_t i = 0; i < EVENT_HANDLERS.size(); ++i) {
+			if (static_cast<size_t>(EVENT_HANDLERS[i].handler) != i) {
+				return false;
+			}
+		}
+		return EVENT_HANDLERS.size() == static_cast<size_t>(EventHandler_t::LAST);
+	}
+	static_assert(isHandlerTableOrdered(), "EVENT_HANDLERS must have one entry per EventHandler_t, in order");
+
+	constexpr const EventHandlerInfo &getHandlerInfo(EventHandler_t handler) {
+		return EVENT_HANDLERS[static_cast<size_t>(handler)];
+	}
+}
+
 Events::Events() :
 	scriptInterface("Event Interface") {
 	scriptInterface.initState();
@@ -28,7 +91,13 @@ bool Events::loadFromXml() {
 		return false;
 	}
 
-	info = {};
+	lua_State* L = scriptInterface.getLuaState();
+	for (auto &handler : handlers) {
+		if (handler.functionRef != LUA_NOREF) {
+			luaL_unref(L, LUA_REGISTRYINDEX, handler.functionRef);
+		}
+		handler = {};
+	}
 
 	std::set<std::string> classes;
 	for (auto eventNode : doc.child("events").children()) {
@@ -49,127 +118,67 @@ bool Events::loadFromXml() {
 		}
 
 		const std::string &methodName = eventNode.attribute("method").as_string();
-		const int32_t event = scriptInterface.getMetaEvent(className, methodName);
-		if (className == "Creature") {
-			if (methodName == "onChangeOutfit") {
-				info.creatureOnChangeOutfit = event;
-			} else if (methodName == "onAreaCombat") {
-				info.creatureOnAreaCombat = event;
-			} else if (methodName == "onTargetCombat") {
-				info.creatureOnTargetCombat = event;
-			} else if (methodName == "onHear") {
-				info.creatureOnHear = event;
-			} else if (methodName == "onDrainHealth") {
-				info.creatureOnDrainHealth = event;
+		const auto it = std::ranges::find_if(EVENT_HANDLERS, [&className, &methodName](const auto &entry) {
+			return entry.className == className && entry.methodName == methodName;
+		});
+		if (it == EVENT_HANDLERS.end()) {
+			if (std::ranges::any_of(EVENT_HANDLERS, [&className](const auto &entry) { return entry.className == className; })) {
+				g_logger().warn("{} - Unknown {} method: {}", __FUNCTION__, asLowerCaseString(className), methodName);
 			} else {
-				g_logger().warn("{} - Unknown creature method: {}", __FUNCTION__, methodName);
-			}
-		} else if (className == "Party") {
-			if (methodName == "onJoin") {
-				info.partyOnJoin = event;
-			} else if (methodName == "onLeave") {
-				info.partyOnLeave = event;
-			} else if (methodName == "onDisband") {
-				info.partyOnDisband = event;
-			} else if (methodName == "onShareExperience") {
-				info.partyOnShareExperience = event;
-			} else {
-				g_logger().warn("{} - Unknown party method: {}", __FUNCTION__, methodName);
-			}
-		} else if (className == "Player") {
-			if (methodName == "onBrowseField") {
-				info.playerOnBrowseField = event;
-			} else if (methodName == "onLook") {
-				info.playerOnLook = event;
-			} else if (methodName == "onLookInBattleList") {
-				info.playerOnLookInBattleList = event;
-			} else if (methodName == "onLookInTrade") {
-				info.playerOnLookInTrade = event;
-			} else if (methodName == "onLookInShop") {
-				info.playerOnLookInShop = event;
-			} else if (methodName == "onTradeRequest") {
-				info.playerOnTradeRequest = event;
-			} else if (methodName == "onTradeAccept") {
-				info.playerOnTradeAccept = event;
-			} else if (methodName == "onMoveItem") {
-				info.playerOnMoveItem = event;
-			} else if (methodName == "onInventoryUpdate") {
-				info.playerOnInventoryUpdate = event;
-			} else if (methodName == "onItemMoved") {
-				info.playerOnItemMoved = event;
-			} else if (methodName == "onChangeZone") {
-				info.playerOnChangeZone = event;
-			} else if (methodName == "onChangeHazard") {
-				info.playerOnChangeHazard = event;
-			} else if (methodName == "onMoveCreature") {
-				info.playerOnMoveCreature = event;
-			} else if (methodName == "onReportRuleViolation") {
-				info.playerOnReportRuleViolation = event;
-			} else if (methodName == "onReportBug") {
-				info.playerOnReportBug = event;
-			} else if (methodName == "onTurn") {
-				info.playerOnTurn = event;
-			} else if (methodName == "onGainExperience") {
-				info.playerOnGainExperience = event;
-			} else if (methodName == "onLoseExperience") {
-				info.playerOnLoseExperience = event;
-			} else if (methodName == "onGainSkillTries") {
-				info.playerOnGainSkillTries = event;
-			} else if (methodName == "onRequestQuestLog") {
-				info.playerOnRequestQuestLog = event;
-			} else if (methodName == "onRequestQuestLine") {
-				info.playerOnRequestQuestLine = event;
-			} else if (methodName == "onStorageUpdate") {
-				info.playerOnStorageUpdate = event;
-			} else if (methodName == "onRemoveCount") {
-				info.playerOnRemoveCount = event;
-			} else if (methodName == "onCombat") {
-				info.playerOnCombat = event;
-			} else {
-				g_logger().warn("{} - Unknown player method: {}", __FUNCTION__, methodName);
-			}
-		} else if (className == "Monster") {
-			if (methodName == "onDropLoot") {
-				info.monsterOnDropLoot = event;
-			} else if (methodName == "onSpawn") {
-				info.monsterOnSpawn = event;
-			} else {
-				g_logger().warn("{} - Unknown monster method: {}", __FUNCTION__, methodName);
-			}
-		} else if (className == "Npc") {
-			if (methodName == "onSpawn") {
-				info.monsterOnSpawn = event;
-			} else {
-				g_logger().warn("{} - Unknown npc method: {}", __FUNCTION__, methodName);
+				g_logger().warn("{} - Unknown class: {}", __FUNCTION__, className);
 			}
+			continue;
+		}
+
+		const int32_t event = scriptInterface.getMetaEvent(className, methodName);
+		if (event == -1) {
+			continue;
+		}
+
+		// The function is kept in the registry too, so a call pushes it with a single lookup
+		auto &handler = handlers[static_cast<size_t>(it->handler)];
+		handler.scriptId = event;
+		if (scriptInterface.pushFunction(event)) {
+			handler.functionRef = luaL_ref(L, LUA_REGISTRYINDEX);
 		} else {
-			g_logger().warn("{} - Unknown class: {}", __FUNCTION__, className);
+			lua_pop(L, 1);
 		}
 	}
 	return true;
 }
 
+lua_State* Events::prepareCall(EventHandler_t handler) {
+	const auto &[scriptId, functionRef] = handlers[static_cast<size_t>(handler)];
+	if (!scriptInterface.reserveScriptEnv()) {
+		const auto &handlerInfo = getHandlerInfo(handler);
+		g_logger().error("[Events::prepareCall - {}:{}] Call stack overflow. Too many lua script calls being nested.", handlerInfo.className, handlerInfo.methodName);
+		return nullptr;
+	}
+
+	ScriptEnvironment* env = scriptInterface.getScriptEnv();
+	env->setScriptId(scriptId, &scriptInterface);
+
+	lua_State* L = scriptInterface.getLuaState();
+	if (functionRef != LUA_NOREF) {
+		lua_rawgeti(L, LUA_REGISTRYINDEX, functionRef);
+	} else {
+		scriptInterface.pushFunction(scriptId);
+	}
+	return L;
+}
+
 // Monster
 void Events::eventMonsterOnSpawn(std::shared_ptr<Monster> monster, const Position &position) {
 	// Monster:onSpawn(position) or Monster.onSpawn(self, position)
-	if (info.monsterOnSpawn == -1) {
+	if (!hasHandler(EventHandler_t::MONSTER_ON_SPAWN)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("{} - "
-						 "Position {}"
-						 ". Call stack overflow. Too many lua script calls being nested.",
-						 __FUNCTION__, position.toString());
+	lua_State* L = prepareCall(EventHandler_t::MONSTER_ON_SPAWN);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.monsterOnSpawn, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.monsterOnSpawn);
-
 	LuaScriptInterface::pushUserdata<Monster>(L, monster);
 	LuaScriptInterface::setMetatable(L, -1, "Monster");
 	LuaScriptInterface::pushPosition(L, position);
@@ -186,24 +195,15 @@ void Events::eventMonsterOnSpawn(std::shared_ptr<Monster> monster, const Positio
 // Npc
 void Events::eventNpcOnSpawn(std::shared_ptr<Npc> npc, const Position &position) {
 	// Npc:onSpawn(position) or Npc.onSpawn(self, position)
-	if (info.npcOnSpawn == -1) {
+	if (!hasHandler(EventHandler_t::NPC_ON_SPAWN)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("{} - "
-						 "Position {}"
-						 ". Call stack overflow. Too many lua script calls being nested.",
-						 __FUNCTION__, position.toString());
+	lua_State* L = prepareCall(EventHandler_t::NPC_ON_SPAWN);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.npcOnSpawn, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.npcOnSpawn);
-
 	LuaScriptInterface::pushUserdata<Npc>(L, npc);
 	LuaScriptInterface::setMetatable(L, -1, "Npc");
 	LuaScriptInterface::pushPosition(L, position);
@@ -220,23 +220,15 @@ void Events::eventNpcOnSpawn(std::shared_ptr<Npc> npc, const Position &position)
 // Creature
 bool Events::eventCreatureOnChangeOutfit(std::shared_ptr<Creature> creature, const Outfit_t &outfit) {
 	// Creature:onChangeOutfit(outfit) or Creature.onChangeOutfit(self, outfit)
-	if (info.creatureOnChangeOutfit == -1) {
+	if (!hasHandler(EventHandler_t::CREATURE_ON_CHANGE_OUTFIT)) {
 		return true;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventCreatureOnChangeOutfit - Creature {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 creature->getName());
+	lua_State* L = prepareCall(EventHandler_t::CREATURE_ON_CHANGE_OUTFIT);
+	if (!L) {
 		return false;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.creatureOnChangeOutfit, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.creatureOnChangeOutfit);
-
 	LuaScriptInterface::pushUserdata<Creature>(L, creature);
 	LuaScriptInterface::setCreatureMetatable(L, -1, creature);
 
@@ -247,24 +239,15 @@ bool Events::eventCreatureOnChangeOutfit(std::shared_ptr<Creature> creature, con
 
 ReturnValue Events::eventCreatureOnAreaCombat(std::shared_ptr<Creature> creature, std::shared_ptr<Tile> tile, bool aggressive) {
 	// Creature:onAreaCombat(tile, aggressive) or Creature.onAreaCombat(self, tile, aggressive)
-	if (info.creatureOnAreaCombat == -1) {
+	if (!hasHandler(EventHandler_t::CREATURE_ON_AREA_COMBAT)) {
 		return RETURNVALUE_NOERROR;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventCreatureOnAreaCombat - "
-						 "Creature {} on tile position {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 creature->getName(), tile->getPosition().toString());
+	lua_State* L = prepareCall(EventHandler_t::CREATURE_ON_AREA_COMBAT);
+	if (!L) {
 		return RETURNVALUE_NOTPOSSIBLE;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.creatureOnAreaCombat, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.creatureOnAreaCombat);
-
 	if (creature) {
 		LuaScriptInterface::pushUserdata<Creature>(L, creature);
 		LuaScriptInterface::setCreatureMetatable(L, -1, creature);
@@ -292,24 +275,15 @@ ReturnValue Events::eventCreatureOnAreaCombat(std::shared_ptr<Creature> creature
 
 ReturnValue Events::eventCreatureOnTargetCombat(std::shared_ptr<Creature> creature, std::shared_ptr<Creature> target) {
 	// Creature:onTargetCombat(target) or Creature.onTargetCombat(self, target)
-	if (info.creatureOnTargetCombat == -1) {
+	if (!hasHandler(EventHandler_t::CREATURE_ON_TARGET_COMBAT)) {
 		return RETURNVALUE_NOERROR;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventCreatureOnTargetCombat - "
-						 "Creature {} target {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 creature->getName(), target->getName());
+	lua_State* L = prepareCall(EventHandler_t::CREATURE_ON_TARGET_COMBAT);
+	if (!L) {
 		return RETURNVALUE_NOTPOSSIBLE;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.creatureOnTargetCombat, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.creatureOnTargetCombat);
-
 	if (creature) {
 		LuaScriptInterface::pushUserdata<Creature>(L, creature);
 		LuaScriptInterface::setCreatureMetatable(L, -1, creature);
@@ -335,24 +309,15 @@ ReturnValue Events::eventCreatureOnTargetCombat(std::shared_ptr<Creature> creatu
 
 void Events::eventCreatureOnHear(std::shared_ptr<Creature> creature, std::shared_ptr<Creature> speaker, const std::string &words, SpeakClasses type) {
 	// Creature:onHear(speaker, words, type)
-	if (info.creatureOnHear == -1) {
+	if (!hasHandler(EventHandler_t::CREATURE_ON_HEAR)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventCreatureOnHear - "
-						 "Creature {} speaker {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 creature->getName(), speaker->getName());
+	lua_State* L = prepareCall(EventHandler_t::CREATURE_ON_HEAR);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.creatureOnHear, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.creatureOnHear);
-
 	LuaScriptInterface::pushUserdata<Creature>(L, creature);
 	LuaScriptInterface::setCreatureMetatable(L, -1, creature);
 
@@ -366,24 +331,15 @@ void Events::eventCreatureOnHear(std::shared_ptr<Creature> creature, std::shared
 }
 
 void Events::eventCreatureOnDrainHealth(std::shared_ptr<Creature> creature, std::shared_ptr<Creature> attacker, CombatType_t &typePrimary, int32_t &damagePrimary, CombatType_t &typeSecondary, int32_t &damageSecondary, TextColor_t &colorPrimary, TextColor_t &colorSecondary) {
-	if (info.creatureOnDrainHealth == -1) {
+	if (!hasHandler(EventHandler_t::CREATURE_ON_DRAIN_HEALTH)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventCreatureOnDrainHealth - "
-						 "Creature {} attacker {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 creature->getName(), attacker->getName());
+	lua_State* L = prepareCall(EventHandler_t::CREATURE_ON_DRAIN_HEALTH);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.creatureOnDrainHealth, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.creatureOnDrainHealth);
-
 	if (creature) {
 		LuaScriptInterface::pushUserdata<Creature>(L, creature);
 		LuaScriptInterface::setCreatureMetatable(L, -1, creature);
@@ -423,24 +379,15 @@ void Events::eventCreatureOnDrainHealth(std::shared_ptr<Creature> creature, std:
 // Party
 bool Events::eventPartyOnJoin(std::shared_ptr<Party> party, std::shared_ptr<Player> player) {
 	// Party:onJoin(player) or Party.onJoin(self, player)
-	if (info.partyOnJoin == -1) {
+	if (!hasHandler(EventHandler_t::PARTY_ON_JOIN)) {
 		return true;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPartyOnJoin - "
-						 "Player {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName());
+	lua_State* L = prepareCall(EventHandler_t::PARTY_ON_JOIN);
+	if (!L) {
 		return false;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.partyOnJoin, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.partyOnJoin);
-
 	LuaScriptInterface::pushUserdata<Party>(L, party);
 	LuaScriptInterface::setMetatable(L, -1, "Party");
 
@@ -452,24 +399,15 @@ bool Events::eventPartyOnJoin(std::shared_ptr<Party> party, std::shared_ptr<Play
 
 bool Events::eventPartyOnLeave(std::shared_ptr<Party> party, std::shared_ptr<Player> player) {
 	// Party:onLeave(player) or Party.onLeave(self, player)
-	if (info.partyOnLeave == -1) {
+	if (!hasHandler(EventHandler_t::PARTY_ON_LEAVE)) {
 		return true;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPartyOnLeave - "
-						 "Player {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName());
+	lua_State* L = prepareCall(EventHandler_t::PARTY_ON_LEAVE);
+	if (!L) {
 		return false;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.partyOnLeave, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.partyOnLeave);
-
 	LuaScriptInterface::pushUserdata<Party>(L, party);
 	LuaScriptInterface::setMetatable(L, -1, "Party");
 
@@ -481,23 +419,15 @@ bool Events::eventPartyOnLeave(std::shared_ptr<Party> party, std::shared_ptr<Pla
 
 bool Events::eventPartyOnDisband(std::shared_ptr<Party> party) {
 	// Party:onDisband() or Party.onDisband(self)
-	if (info.partyOnDisband == -1) {
+	if (!hasHandler(EventHandler_t::PARTY_ON_DISBAND)) {
 		return true;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPartyOnDisband - Party leader {}] Call stack "
-						 "overflow. Too many lua script calls being nested.",
-						 party->getLeader() ? party->getLeader()->getName() : "unknown");
+	lua_State* L = prepareCall(EventHandler_t::PARTY_ON_DISBAND);
+	if (!L) {
 		return false;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.partyOnDisband, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.partyOnDisband);
-
 	LuaScriptInterface::pushUserdata<Party>(L, party);
 	LuaScriptInterface::setMetatable(L, -1, "Party");
 
@@ -506,21 +436,15 @@ bool Events::eventPartyOnDisband(std::shared_ptr<Party> party) {
 
 void Events::eventPartyOnShareExperience(std::shared_ptr<Party> party, uint64_t &exp) {
 	// Party:onShareExperience(exp) or Party.onShareExperience(self, exp)
-	if (info.partyOnShareExperience == -1) {
+	if (!hasHandler(EventHandler_t::PARTY_ON_SHARE_EXPERIENCE)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("Party leader {}. Call stack overflow. Too many lua script calls being nested.", party->getLeader() ? party->getLeader()->getName() : "unknown");
+	lua_State* L = prepareCall(EventHandler_t::PARTY_ON_SHARE_EXPERIENCE);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.partyOnShareExperience, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.partyOnShareExperience);
-
 	LuaScriptInterface::pushUserdata<Party>(L, party);
 	LuaScriptInterface::setMetatable(L, -1, "Party");
 
@@ -539,24 +463,15 @@ void Events::eventPartyOnShareExperience(std::shared_ptr<Party> party, uint64_t
 // Player
 bool Events::eventPlayerOnBrowseField(std::shared_ptr<Player> player, const Position &position) {
 	// Player:onBrowseField(position) or Player.onBrowseField(self, position)
-	if (info.playerOnBrowseField == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_BROWSE_FIELD)) {
 		return true;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnBrowseField - "
-						 "Player {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_BROWSE_FIELD);
+	if (!L) {
 		return false;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnBrowseField, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnBrowseField);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -567,24 +482,15 @@ bool Events::eventPlayerOnBrowseField(std::shared_ptr<Player> player, const Posi
 
 void Events::eventPlayerOnLook(std::shared_ptr<Player> player, const Position &position, std::shared_ptr<Thing> thing, uint8_t stackpos, int32_t lookDistance) {
 	// Player:onLook(thing, position, distance) or Player.onLook(self, thing, position, distance)
-	if (info.playerOnLook == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_LOOK)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnLook - "
-						 "Player {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_LOOK);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnLook, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnLook);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -606,24 +512,15 @@ void Events::eventPlayerOnLook(std::shared_ptr<Player> player, const Position &p
 
 void Events::eventPlayerOnLookInBattleList(std::shared_ptr<Player> player, std::shared_ptr<Creature> creature, int32_t lookDistance) {
 	// Player:onLookInBattleList(creature, position, distance) or Player.onLookInBattleList(self, creature, position, distance)
-	if (info.playerOnLookInBattleList == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_LOOK_IN_BATTLE_LIST)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnLookInBattleList - "
-						 "Player {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_LOOK_IN_BATTLE_LIST);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnLookInBattleList, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnLookInBattleList);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -637,24 +534,15 @@ void Events::eventPlayerOnLookInBattleList(std::shared_ptr<Player> player, std::
 
 void Events::eventPlayerOnLookInTrade(std::shared_ptr<Player> player, std::shared_ptr<Player> partner, std::shared_ptr<Item> item, int32_t lookDistance) {
 	// Player:onLookInTrade(partner, item, distance) or Player.onLookInTrade(self, partner, item, distance)
-	if (info.playerOnLookInTrade == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_LOOK_IN_TRADE)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnLookInTrade - "
-						 "Player {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_LOOK_IN_TRADE);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnLookInTrade, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnLookInTrade);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -671,24 +559,15 @@ void Events::eventPlayerOnLookInTrade(std::shared_ptr<Player> player, std::share
 
 bool Events::eventPlayerOnLookInShop(std::shared_ptr<Player> player, const ItemType* itemType, uint8_t count) {
 	// Player:onLookInShop(itemType, count) or Player.onLookInShop(self, itemType, count)
-	if (info.playerOnLookInShop == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_LOOK_IN_SHOP)) {
 		return true;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnLookInShop - "
-						 "Player {} itemType {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName(), itemType->getPluralName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_LOOK_IN_SHOP);
+	if (!L) {
 		return false;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnLookInShop, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnLookInShop);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -702,24 +581,15 @@ bool Events::eventPlayerOnLookInShop(std::shared_ptr<Player> player, const ItemT
 
 bool Events::eventPlayerOnRemoveCount(std::shared_ptr<Player> player, std::shared_ptr<Item> item) {
 	// Player:onMove()
-	if (info.playerOnRemoveCount == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_REMOVE_COUNT)) {
 		return true;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnMove - "
-						 "Player {} item {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName(), item->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_REMOVE_COUNT);
+	if (!L) {
 		return false;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnRemoveCount, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnRemoveCount);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -731,24 +601,15 @@ bool Events::eventPlayerOnRemoveCount(std::shared_ptr<Player> player, std::share
 
 bool Events::eventPlayerOnMoveItem(std::shared_ptr<Player> player, std::shared_ptr<Item> item, uint16_t count, const Position &fromPosition, const Position &toPosition, std::shared_ptr<Cylinder> fromCylinder, std::shared_ptr<Cylinder> toCylinder) {
 	// Player:onMoveItem(item, count, fromPosition, toPosition) or Player.onMoveItem(self, item, count, fromPosition, toPosition, fromCylinder, toCylinder)
-	if (info.playerOnMoveItem == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_MOVE_ITEM)) {
 		return true;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnMoveItem - "
-						 "Player {} item {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName(), item->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_MOVE_ITEM);
+	if (!L) {
 		return false;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnMoveItem, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnMoveItem);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -767,24 +628,15 @@ bool Events::eventPlayerOnMoveItem(std::shared_ptr<Player> player, std::shared_p
 
 void Events::eventPlayerOnItemMoved(std::shared_ptr<Player> player, std::shared_ptr<Item> item, uint16_t count, const Position &fromPosition, const Position &toPosition, std::shared_ptr<Cylinder> fromCylinder, std::shared_ptr<Cylinder> toCylinder) {
 	// Player:onItemMoved(item, count, fromPosition, toPosition) or Player.onItemMoved(self, item, count, fromPosition, toPosition, fromCylinder, toCylinder)
-	if (info.playerOnItemMoved == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_ITEM_MOVED)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnItemMoved - "
-						 "Player {} item {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName(), item->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_ITEM_MOVED);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnItemMoved, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnItemMoved);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -803,24 +655,15 @@ void Events::eventPlayerOnItemMoved(std::shared_ptr<Player> player, std::shared_
 
 void Events::eventPlayerOnChangeZone(std::shared_ptr<Player> player, ZoneType_t zone) {
 	// Player:onChangeZone(zone)
-	if (info.playerOnChangeZone == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_CHANGE_ZONE)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnChangeZone - "
-						 "Player {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_CHANGE_ZONE);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnChangeZone, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnChangeZone);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -830,24 +673,15 @@ void Events::eventPlayerOnChangeZone(std::shared_ptr<Player> player, ZoneType_t
 
 bool Events::eventPlayerOnMoveCreature(std::shared_ptr<Player> player, std::shared_ptr<Creature> creature, const Position &fromPosition, const Position &toPosition) {
 	// Player:onMoveCreature(creature, fromPosition, toPosition) or Player.onMoveCreature(self, creature, fromPosition, toPosition)
-	if (info.playerOnMoveCreature == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_MOVE_CREATURE)) {
 		return true;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnMoveCreature - "
-						 "Player {} creature {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName(), creature->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_MOVE_CREATURE);
+	if (!L) {
 		return false;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnMoveCreature, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnMoveCreature);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -862,24 +696,15 @@ bool Events::eventPlayerOnMoveCreature(std::shared_ptr<Player> player, std::shar
 
 void Events::eventPlayerOnReportRuleViolation(std::shared_ptr<Player> player, const std::string &targetName, uint8_t reportType, uint8_t reportReason, const std::string &comment, const std::string &translation) {
 	// Player:onReportRuleViolation(targetName, reportType, reportReason, comment, translation)
-	if (info.playerOnReportRuleViolation == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_REPORT_RULE_VIOLATION)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnReportRuleViolation - "
-						 "Player {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_REPORT_RULE_VIOLATION);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnReportRuleViolation, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnReportRuleViolation);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -896,24 +721,15 @@ void Events::eventPlayerOnReportRuleViolation(std::shared_ptr<Player> player, co
 
 bool Events::eventPlayerOnReportBug(std::shared_ptr<Player> player, const std::string &message, const Position &position, uint8_t category) {
 	// Player:onReportBug(message, position, category)
-	if (info.playerOnReportBug == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_REPORT_BUG)) {
 		return true;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnReportBug - "
-						 "Player {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_REPORT_BUG);
+	if (!L) {
 		return false;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnReportBug, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnReportBug);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -926,24 +742,15 @@ bool Events::eventPlayerOnReportBug(std::shared_ptr<Player> player, const std::s
 
 bool Events::eventPlayerOnTurn(std::shared_ptr<Player> player, Direction direction) {
 	// Player:onTurn(direction) or Player.onTurn(self, direction)
-	if (info.playerOnTurn == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_TURN)) {
 		return true;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnTurn - "
-						 "Player {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_TURN);
+	if (!L) {
 		return false;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnTurn, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnTurn);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -954,24 +761,15 @@ bool Events::eventPlayerOnTurn(std::shared_ptr<Player> player, Direction directi
 
 bool Events::eventPlayerOnTradeRequest(std::shared_ptr<Player> player, std::shared_ptr<Player> target, std::shared_ptr<Item> item) {
 	// Player:onTradeRequest(target, item)
-	if (info.playerOnTradeRequest == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_TRADE_REQUEST)) {
 		return true;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnTradeRequest - "
-						 "Player {} target {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName(), target->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_TRADE_REQUEST);
+	if (!L) {
 		return false;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnTradeRequest, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnTradeRequest);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -986,24 +784,15 @@ bool Events::eventPlayerOnTradeRequest(std::shared_ptr<Player> player, std::shar
 
 bool Events::eventPlayerOnTradeAccept(std::shared_ptr<Player> player, std::shared_ptr<Player> target, std::shared_ptr<Item> item, std::shared_ptr<Item> targetItem) {
 	// Player:onTradeAccept(target, item, targetItem)
-	if (info.playerOnTradeAccept == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_TRADE_ACCEPT)) {
 		return true;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnTradeAccept - "
-						 "Player {} target {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName(), target->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_TRADE_ACCEPT);
+	if (!L) {
 		return false;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnTradeAccept, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnTradeAccept);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -1022,24 +811,15 @@ bool Events::eventPlayerOnTradeAccept(std::shared_ptr<Player> player, std::share
 void Events::eventPlayerOnGainExperience(std::shared_ptr<Player> player, std::shared_ptr<Creature> target, uint64_t &exp, uint64_t rawExp) {
 	// Player:onGainExperience(target, exp, rawExp)
 	// rawExp gives the original exp which is not multiplied
-	if (info.playerOnGainExperience == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_GAIN_EXPERIENCE)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnGainExperience - "
-						 "Player {} target {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName(), target->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_GAIN_EXPERIENCE);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnGainExperience, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnGainExperience);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -1065,24 +845,15 @@ void Events::eventPlayerOnGainExperience(std::shared_ptr<Player> player, std::sh
 
 void Events::eventPlayerOnLoseExperience(std::shared_ptr<Player> player, uint64_t &exp) {
 	// Player:onLoseExperience(exp)
-	if (info.playerOnLoseExperience == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_LOSE_EXPERIENCE)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnLoseExperience - "
-						 "Player {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_LOSE_EXPERIENCE);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnLoseExperience, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnLoseExperience);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -1100,24 +871,15 @@ void Events::eventPlayerOnLoseExperience(std::shared_ptr<Player> player, uint64_
 
 void Events::eventPlayerOnGainSkillTries(std::shared_ptr<Player> player, skills_t skill, uint64_t &tries) {
 	// Player:onGainSkillTries(skill, tries)
-	if (info.playerOnGainSkillTries == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_GAIN_SKILL_TRIES)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnGainSkillTries - "
-						 "Player {} skill {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName(), fmt::underlying(skill));
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_GAIN_SKILL_TRIES);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnGainSkillTries, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnGainSkillTries);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -1136,37 +898,28 @@ void Events::eventPlayerOnGainSkillTries(std::shared_ptr<Player> player, skills_
 
 void Events::eventPlayerOnCombat(std::shared_ptr<Player> player, std::shared_ptr<Creature> target, std::shared_ptr<Item> item, CombatDamage &damage) {
 	// Player:onCombat(target, item, primaryDamage, primaryType, secondaryDamage, secondaryType)
-	if (info.playerOnCombat == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_COMBAT)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnCombat - "
-						 "Player {} target {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName(), target->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_COMBAT);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnCombat, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnCombat);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
 	if (target) {
 		LuaScriptInterface::pushUserdata<Creature>(L, target);
-		LuaScriptInterface::setMetatable(L, -1, "Creature");
+		LuaScriptInterface::setCreatureMetatable(L, -1, target);
 	} else {
 		lua_pushnil(L);
 	}
 
 	if (item) {
 		LuaScriptInterface::pushUserdata<Item>(L, item);
-		LuaScriptInterface::setMetatable(L, -1, "Item");
+		LuaScriptInterface::setItemMetatable(L, -1, item);
 	} else {
 		lua_pushnil(L);
 	}
@@ -1193,24 +946,15 @@ void Events::eventPlayerOnCombat(std::shared_ptr<Player> player, std::shared_ptr
 
 void Events::eventPlayerOnRequestQuestLog(std::shared_ptr<Player> player) {
 	// Player:onRequestQuestLog()
-	if (info.playerOnRequestQuestLog == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_REQUEST_QUEST_LOG)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnRequestQuestLog - "
-						 "Player {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName());
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_REQUEST_QUEST_LOG);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnRequestQuestLog, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnRequestQuestLog);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -1219,24 +963,15 @@ void Events::eventPlayerOnRequestQuestLog(std::shared_ptr<Player> player) {
 
 void Events::eventPlayerOnRequestQuestLine(std::shared_ptr<Player> player, uint16_t questId) {
 	// Player::onRequestQuestLine()
-	if (info.playerOnRequestQuestLine == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_REQUEST_QUEST_LINE)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventPlayerOnRequestQuestLine - "
-						 "Player {} questId {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName(), questId);
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_REQUEST_QUEST_LINE);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnRequestQuestLine, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnRequestQuestLine);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -1247,21 +982,15 @@ void Events::eventPlayerOnRequestQuestLine(std::shared_ptr<Player> player, uint1
 
 void Events::eventPlayerOnInventoryUpdate(std::shared_ptr<Player> player, std::shared_ptr<Item> item, Slots_t slot, bool equip) {
 	// Player:onInventoryUpdate(item, slot, equip)
-	if (info.playerOnInventoryUpdate == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_INVENTORY_UPDATE)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[{}] Call stack overflow", __FUNCTION__);
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_INVENTORY_UPDATE);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnInventoryUpdate, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnInventoryUpdate);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -1276,24 +1005,15 @@ void Events::eventPlayerOnInventoryUpdate(std::shared_ptr<Player> player, std::s
 
 void Events::eventOnStorageUpdate(std::shared_ptr<Player> player, const uint32_t key, const int32_t value, int32_t oldValue, uint64_t currentTime) {
 	// Player::onStorageUpdate(key, value, oldValue, currentTime)
-	if (info.playerOnStorageUpdate == -1) {
+	if (!hasHandler(EventHandler_t::PLAYER_ON_STORAGE_UPDATE)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventOnStorageUpdate - "
-						 "Player {} key {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 player->getName(), key);
+	lua_State* L = prepareCall(EventHandler_t::PLAYER_ON_STORAGE_UPDATE);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.playerOnStorageUpdate, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.playerOnStorageUpdate);
-
 	LuaScriptInterface::pushUserdata<Player>(L, player);
 	LuaScriptInterface::setMetatable(L, -1, "Player");
 
@@ -1308,24 +1028,15 @@ void Events::eventOnStorageUpdate(std::shared_ptr<Player> player, const uint32_t
 // Monster
 void Events::eventMonsterOnDropLoot(std::shared_ptr<Monster> monster, std::shared_ptr<Container> corpse) {
 	// Monster:onDropLoot(corpse)
-	if (info.monsterOnDropLoot == -1) {
+	if (!hasHandler(EventHandler_t::MONSTER_ON_DROP_LOOT)) {
 		return;
 	}
 
-	if (!scriptInterface.reserveScriptEnv()) {
-		g_logger().error("[Events::eventMonsterOnDropLoot - "
-						 "Monster corpse {}] "
-						 "Call stack overflow. Too many lua script calls being nested.",
-						 corpse->getName());
+	lua_State* L = prepareCall(EventHandler_t::MONSTER_ON_DROP_LOOT);
+	if (!L) {
 		return;
 	}
 
-	ScriptEnvironment* env = scriptInterface.getScriptEnv();
-	env->setScriptId(info.monsterOnDropLoot, &scriptInterface);
-
-	lua_State* L = scriptInterface.getLuaState();
-	scriptInterface.pushFunction(info.monsterOnDropLoot);
-
 	LuaScriptInterface::pushUserdata<Monster>(L, monster);
 	LuaScriptInterface::setMetatable(L, -1, "Monster");
 
@@ -18,55 +18,57 @@ class ItemType;
 class Tile;
 class Imbuements;
 
-class Events {
-	struct EventsInfo {
-		// Creature
-		int32_t creatureOnChangeOutfit = -1;
-		int32_t creatureOnAreaCombat = -1;
-		int32_t creatureOnTargetCombat = -1;
-		int32_t creatureOnHear = -1;
-		int32_t creatureOnDrainHealth = -1;
-
-		// Party
-		int32_t partyOnJoin = -1;
-		int32_t partyOnLeave = -1;
-		int32_t partyOnDisband = -1;
-		int32_t partyOnShareExperience = -1;
-
-		// Player
-		int32_t playerOnBrowseField = -1;
-		int32_t playerOnLook = -1;
-		int32_t playerOnLookInBattleList = -1;
-		int32_t playerOnLookInTrade = -1;
-		int32_t playerOnLookInShop = -1;
-		int32_t playerOnMoveItem = -1;
-		int32_t playerOnItemMoved = -1;
-		int32_t playerOnChangeZone = -1;
-		int32_t playerOnChangeHazard = -1;
-		int32_t playerOnMoveCreature = -1;
-		int32_t playerOnReportRuleViolation = -1;
-		int32_t playerOnReportBug = -1;
-		int32_t playerOnTurn = -1;
-		int32_t playerOnTradeRequest = -1;
-		int32_t playerOnTradeAccept = -1;
-		int32_t playerOnGainExperience = -1;
-		int32_t playerOnLoseExperience = -1;
-		int32_t playerOnGainSkillTries = -1;
-		int32_t playerOnRequestQuestLog = -1;
-		int32_t playerOnRequestQuestLine = -1;
-		int32_t playerOnStorageUpdate = -1;
-		int32_t playerOnRemoveCount = -1;
-		int32_t playerOnCombat = -1;
-		int32_t playerOnInventoryUpdate = -1;
-
-		// Monster
-		int32_t monsterOnDropLoot = -1;
-		int32_t monsterOnSpawn = -1;
-
-		// Npc
-		int32_t npcOnSpawn = -1;
-	};
+/**
+ * Every handler events.xml can enable, see EVENT_HANDLERS in events.cpp
+ * for the class and method each one is bound to.
+ */
+enum class EventHandler_t : uint8_t {
+	CREATURE_ON_CHANGE_OUTFIT,
+	CREATURE_ON_AREA_COMBAT,
+	CREATURE_ON_TARGET_COMBAT,
+	CREATURE_ON_HEAR,
+	CREATURE_ON_DRAIN_HEALTH,
+
+	PARTY_ON_JOIN,
+	PARTY_ON_LEAVE,
+	PARTY_ON_DISBAND,
+	PARTY_ON_SHARE_EXPERIENCE,
+
+	PLAYER_ON_BROWSE_FIELD,
+	PLAYER_ON_LOOK,
+	PLAYER_ON_LOOK_IN_BATTLE_LIST,
+	PLAYER_ON_LOOK_IN_TRADE,
+	PLAYER_ON_LOOK_IN_SHOP,
+	PLAYER_ON_MOVE_ITEM,
+	PLAYER_ON_ITEM_MOVED,
+	PLAYER_ON_CHANGE_ZONE,
+	PLAYER_ON_CHANGE_HAZARD,
+	PLAYER_ON_MOVE_CREATURE,
+	PLAYER_ON_REPORT_RULE_VIOLATION,
+	PLAYER_ON_REPORT_BUG,
+	PLAYER_ON_TURN,
+	PLAYER_ON_TRADE_REQUEST,
+	PLAYER_ON_TRADE_ACCEPT,
+	PLAYER_ON_GAIN_EXPERIENCE,
+	PLAYER_ON_LOSE_EXPERIENCE,
+	PLAYER_ON_GAIN_SKILL_TRIES,
+	PLAYER_ON_REQUEST_QUEST_LOG,
+	PLAYER_ON_REQUEST_QUEST_LINE,
+	PLAYER_ON_STORAGE_UPDATE,
+	PLAYER_ON_REMOVE_COUNT,
+	PLAYER_ON_COMBAT,
+	PLAYER_ON_INVENTORY_UPDATE,
+
+	MONSTER_ON_DROP_LOOT,
+	MONSTER_ON_SPAWN,
+
+	NPC_ON_SPAWN,
+
+	// Every is last
+	LAST
+};
 
+class Events {
 public:
 	Events();
 
@@ -80,6 +82,11 @@ public:
 		return inject<Events>();
 	}
 
+	// Inline, so hot paths skip building the arguments of a handler events.xml left disabled
+	[[nodiscard]] bool hasHandler(EventHandler_t handler) const {
+		return handlers[static_cast<size_t>(handler)].scriptId != -1;
+	}
+
 	// Creature
 	bool eventCreatureOnChangeOutfit(std::shared_ptr<Creature> creature, const Outfit_t &outfit);
 	ReturnValue eventCreatureOnAreaCombat(std::shared_ptr<Creature> creature, std::shared_ptr<Tile> tile, bool aggressive);
@@ -126,8 +133,17 @@ public:
 	void eventNpcOnSpawn(std::shared_ptr<Npc> npc, const Position &position);
 
 private:
+	struct EventHandler {
+		int32_t scriptId = -1;
+		// Registry reference of the function, LUA_NOREF when it could not be pushed on load
+		int32_t functionRef = LUA_NOREF;
+	};
+
+	// Reserves the script environment and pushes the handler function, nullptr on a call stack overflow
+	lua_State* prepareCall(EventHandler_t handler);
+
 	LuaScriptInterface scriptInterface;
-	EventsInfo info;
+	std::array<EventHandler, static_cast<size_t>(EventHandler_t::LAST)> handlers;
 };
 
 constexpr auto g_events = Events::getInstance;
@@ -20,6 +20,44 @@ void MoveEvents::clear() {
 	actionIdMap.clear();
 	itemIdMap.clear();
 	positionsMap.clear();
+	itemIdEventTypes.clear();
+}
+
+// Rebuilt after events were removed, registering only adds bits
+void MoveEvents::updateItemIdEventTypes() {
+	itemIdEventTypes.clear();
+	for (const auto &[itemId, moveEventList] : itemIdMap) {
+		if (itemId < 0 || itemId > std::numeric_limits<uint16_t>::max()) {
+			continue;
+		}
+
+		if (static_cast<size_t>(itemId) >= itemIdEventTypes.size()) {
+			itemIdEventTypes.resize(itemId + 1);
+		}
+		for (uint8_t eventType = 0; eventType < MOVE_EVENT_LAST; ++eventType) {
+			if (!moveEventList.moveEvent[eventType].empty()) {
+				itemIdEventTypes[itemId] |= 1 << eventType;
+			}
+		}
+	}
+}
+
+void MoveEvents::clearFileEvents(const std::string &file) {
+	const auto clearLists = [&file](auto &map) {
+		phmap::erase_if(map, [&file](auto &entry) {
+			bool empty = true;
+			for (auto &moveEvents : entry.second.moveEvent) {
+				moveEvents.remove_if([&file](const auto &moveEvent) { return moveEvent->getScriptFile() == file; });
+				empty = empty && moveEvents.empty();
+			}
+			return empty;
+		});
+	};
+	clearLists(uniqueIdMap);
+	clearLists(actionIdMap);
+	clearLists(itemIdMap);
+	clearLists(positionsMap);
+	updateItemIdEventTypes();
 }
 
 bool MoveEvents::registerLuaItemEvent(const std::shared_ptr<MoveEvent> moveEvent) {
@@ -41,6 +79,12 @@ bool MoveEvents::registerLuaItemEvent(const std::shared_ptr<MoveEvent> moveEvent
 		}
 		if (registerEvent(moveEvent, itemId, itemIdMap)) {
 			tmpVector.emplace_back(itemId);
+			if (itemId <= std::numeric_limits<uint16_t>::max()) {
+				if (itemId >= itemIdEventTypes.size()) {
+					itemIdEventTypes.resize(itemId + 1);
+				}
+				itemIdEventTypes[itemId] |= 1 << moveEvent->getEventType();
+			}
 		}
 	}
 
@@ -122,7 +166,7 @@ bool MoveEvents::registerLuaEvent(const std::shared_ptr<MoveEvent> moveEvent) {
 	}
 }
 
-bool MoveEvents::registerEvent(const std::shared_ptr<MoveEvent> moveEvent, int32_t id, std::map<int32_t, MoveEventList> &moveListMap) const {
+bool MoveEvents::registerEvent(const std::shared_ptr<MoveEvent> moveEvent, int32_t id, phmap::flat_hash_map<int32_t, MoveEventList> &moveListMap) const {
 	auto it = moveListMap.find(id);
 	if (it == moveListMap.end()) {
 		MoveEventList moveEventList;
@@ -186,9 +230,9 @@ std::shared_ptr<MoveEvent> MoveEvents::getEvent(const std::shared_ptr<Item> &ite
 	}
 
 	if (item->hasAttribute(ItemAttribute_t::ACTIONID)) {
-		std::map<int32_t, MoveEventList>::iterator it = actionIdMap.find(item->getAttribute<uint16_t>(ItemAttribute_t::ACTIONID));
+		auto it = actionIdMap.find(item->getAttribute<uint16_t>(ItemAttribute_t::ACTIONID));
 		if (it != actionIdMap.end()) {
-			std::list<std::shared_ptr<MoveEvent>> moveEventList = it->second.moveEvent[eventType];
+			const std::list<std::shared_ptr<MoveEvent>> &moveEventList = it->second.moveEvent[eventType];
 			for (const auto &moveEvent : moveEventList) {
 				if ((moveEvent->getSlot() & slotp) != 0) {
 					return moveEvent;
@@ -197,6 +241,10 @@ std::shared_ptr<MoveEvent> MoveEvents::getEvent(const std::shared_ptr<Item> &ite
 		}
 	}
 
+	if (!hasItemIdEvent(item->getID(), eventType)) {
+		return nullptr;
+	}
+
 	auto it = itemIdMap.find(item->getID());
 	if (it != itemIdMap.end()) {
 		std::list<std::shared_ptr<MoveEvent>> &moveEventList = it->second.moveEvent[eventType];
@@ -210,7 +258,11 @@ std::shared_ptr<MoveEvent> MoveEvents::getEvent(const std::shared_ptr<Item> &ite
 }
 
 std::shared_ptr<MoveEvent> MoveEvents::getEvent(const std::shared_ptr<Item> &item, MoveEvent_t eventType) {
-	std::map<int32_t, MoveEventList>::iterator it;
+	if (!mayHaveEvent(item, eventType)) {
+		return nullptr;
+	}
+
+	phmap::flat_hash_map<int32_t, MoveEventList>::iterator it;
 	if (item->hasAttribute(ItemAttribute_t::UNIQUEID)) {
 		it = uniqueIdMap.find(item->getAttribute<uint16_t>(ItemAttribute_t::UNIQUEID));
 		if (it != uniqueIdMap.end()) {
@@ -241,7 +293,7 @@ std::shared_ptr<MoveEvent> MoveEvents::getEvent(const std::shared_ptr<Item> &ite
 	return nullptr;
 }
 
-bool MoveEvents::registerEvent(const std::shared_ptr<MoveEvent> moveEvent, const Position &position, std::map<Position, MoveEventList> &moveListMap) const {
+bool MoveEvents::registerEvent(const std::shared_ptr<MoveEvent> moveEvent, const Position &position, phmap::flat_hash_map<Position, MoveEventList> &moveListMap) const {
 	auto it = moveListMap.find(position);
 	if (it == moveListMap.end()) {
 		MoveEventList moveEventList;
@@ -266,6 +318,10 @@ bool MoveEvents::registerEvent(const std::shared_ptr<MoveEvent> moveEvent, const
 }
 
 std::shared_ptr<MoveEvent> MoveEvents::getEvent(const std::shared_ptr<Tile> &tile, MoveEvent_t eventType) {
+	if (positionsMap.empty()) {
+		return nullptr;
+	}
+
 	if (auto it = positionsMap.find(tile->getPosition());
 		it != positionsMap.end()) {
 		std::list<std::shared_ptr<MoveEvent>> &moveEventList = it->second.moveEvent[eventType];
@@ -293,7 +349,7 @@ uint32_t MoveEvents::onCreatureMove(const std::shared_ptr<Creature> &creature, c
 		}
 
 		std::shared_ptr<Item> tileItem = thing->getItem();
-		if (!tileItem) {
+		if (!tileItem || !mayHaveEvent(tileItem, eventType)) {
 			continue;
 		}
 
@@ -360,7 +416,7 @@ uint32_t MoveEvents::onItemMove(const std::shared_ptr<Item> &item, const std::sh
 		}
 
 		std::shared_ptr<Item> tileItem = thing->getItem();
-		if (!tileItem) {
+		if (!tileItem || !mayHaveEvent(tileItem, eventType2)) {
 			continue;
 		}
 
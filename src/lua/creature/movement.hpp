@@ -41,70 +41,6 @@ public:
 	uint32_t onPlayerDeEquip(const std::shared_ptr<Player> &player, const std::shared_ptr<Item> &item, Slots_t slot);
 	uint32_t onItemMove(const std::shared_ptr<Item> &item, const std::shared_ptr<Tile> &tile, bool isAdd);
 
-	std::map<Position, MoveEventList> getPositionsMap() const {
-		return positionsMap;
-	}
-
-	bool hasPosition(Position position) const {
-		if (auto it = positionsMap.find(position);
-			it != positionsMap.end()) {
-			return true;
-		}
-		return false;
-	}
-
-	void setPosition(Position position, MoveEventList moveEventList) {
-		positionsMap.try_emplace(position, moveEventList);
-	}
-
-	std::map<int32_t, MoveEventList> getItemIdMap() const {
-		return itemIdMap;
-	}
-
-	bool hasItemId(int32_t itemId) const {
-		if (auto it = itemIdMap.find(itemId);
-			it != itemIdMap.end()) {
-			return true;
-		}
-		return false;
-	}
-
-	void setItemId(int32_t itemId, MoveEventList moveEventList) {
-		itemIdMap.try_emplace(itemId, moveEventList);
-	}
-
-	std::map<int32_t, MoveEventList> getUniqueIdMap() const {
-		return uniqueIdMap;
-	}
-
-	bool hasUniqueId(int32_t uniqueId) const {
-		if (auto it = uniqueIdMap.find(uniqueId);
-			it != uniqueIdMap.end()) {
-			return true;
-		}
-		return false;
-	}
-
-	void setUniqueId(int32_t uniqueId, MoveEventList moveEventList) {
-		uniqueIdMap.try_emplace(uniqueId, moveEventList);
-	}
-
-	std::map<int32_t, MoveEventList> getActionIdMap() const {
-		return actionIdMap;
-	}
-
-	bool hasActionId(int32_t actionId) const {
-		if (auto it = actionIdMap.find(actionId);
-			it != actionIdMap.end()) {
-			return true;
-		}
-		return false;
-	}
-
-	void setActionId(int32_t actionId, MoveEventList moveEventList) {
-		actionIdMap.try_emplace(actionId, moveEventList);
-	}
-
 	std::shared_ptr<MoveEvent> getEvent(const std::shared_ptr<Item> &item, MoveEvent_t eventType);
 
 	bool registerLuaItemEvent(const std::shared_ptr<MoveEvent> moveEvent);
@@ -113,21 +49,33 @@ public:
 	bool registerLuaPositionEvent(const std::shared_ptr<MoveEvent> moveEvent);
 	bool registerLuaEvent(const std::shared_ptr<MoveEvent> event);
 	void clear();
+	// Unregisters the events the given script file registered, for hot reload
+	void clearFileEvents(const std::string &file);
 
 private:
-	void clearMap(std::map<int32_t, MoveEventList> &map) const;
-	void clearPosMap(std::map<Position, MoveEventList> &map);
-
-	bool registerEvent(const std::shared_ptr<MoveEvent> moveEvent, int32_t id, std::map<int32_t, MoveEventList> &moveListMap) const;
-	bool registerEvent(const std::shared_ptr<MoveEvent> moveEvent, const Position &position, std::map<Position, MoveEventList> &moveListMap) const;
+	bool registerEvent(const std::shared_ptr<MoveEvent> moveEvent, int32_t id, phmap::flat_hash_map<int32_t, MoveEventList> &moveListMap) const;
+	bool registerEvent(const std::shared_ptr<MoveEvent> moveEvent, const Position &position, phmap::flat_hash_map<Position, MoveEventList> &moveListMap) const;
 	std::shared_ptr<MoveEvent> getEvent(const std::shared_ptr<Tile> &tile, MoveEvent_t eventType);
 
 	std::shared_ptr<MoveEvent> getEvent(const std::shared_ptr<Item> &item, MoveEvent_t eventType, Slots_t slot);
 
-	std::map<int32_t, MoveEventList> uniqueIdMap;
-	std::map<int32_t, MoveEventList> actionIdMap;
-	std::map<int32_t, MoveEventList> itemIdMap;
-	std::map<Position, MoveEventList> positionsMap;
+	// Whether the item id has events of the type, tile items without any are skipped without a lookup
+	bool hasItemIdEvent(uint16_t itemId, MoveEvent_t eventType) const {
+		return itemId < itemIdEventTypes.size() && (itemIdEventTypes[itemId] & (1 << eventType)) != 0;
+	}
+	bool mayHaveEvent(const std::shared_ptr<Item> &item, MoveEvent_t eventType) const {
+		return hasItemIdEvent(item->getID(), eventType)
+			|| (!uniqueIdMap.empty() && item->hasAttribute(ItemAttribute_t::UNIQUEID))
+			|| (!actionIdMap.empty() && item->hasAttribute(ItemAttribute_t::ACTIONID));
+	}
+	void updateItemIdEventTypes();
+
+	phmap::flat_hash_map<int32_t, MoveEventList> uniqueIdMap;
+	phmap::flat_hash_map<int32_t, MoveEventList> actionIdMap;
+	phmap::flat_hash_map<int32_t, MoveEventList> itemIdMap;
+	phmap::flat_hash_map<Position, MoveEventList> positionsMap;
+	// Event types registered per item id, a bit per MoveEvent_t
+	std::vector<uint8_t> itemIdEventTypes;
 };
 
 constexpr auto g_moveEvents = MoveEvents::getInstance;
@@ -95,48 +95,112 @@ bool Raids::loadFromXml() {
 
 static constexpr int32_t MAX_RAND_RANGE = 10000000;
 
+namespace {
+	// Chance of the raid to start at a check, as the roll against MAX_RAND_RANGE gives it
+	double getRaidStartChance(const std::shared_ptr<Raid> &raid) {
+		const auto required = static_cast<uint32_t>(MAX_RAND_RANGE * raid->getInterval()) / CHECK_RAIDS_INTERVAL;
+		return std::min<double>(1, (static_cast<double>(required) + 1) / (MAX_RAND_RANGE + 1));
+	}
+
+	// Places the monsters of a raid spawn a few per tick, the spectators of each are told as it appears
+	void placeRaidSpawns(std::shared_ptr<std::vector<std::pair<std::shared_ptr<Monster>, Position>>> spawns, size_t next) {
+		const size_t last = std::min(spawns->size(), next + RAID_SPAWNS_PER_TICK);
+		for (; next < last; ++next) {
+			const auto &[monster, position] = (*spawns)[next];
+			if (g_game().placeCreature(monster, position, false, true)) {
+				monster->setForgeMonster(false);
+			}
+		}
+
+		if (next < spawns->size()) {
+			g_scheduler().addEvent(
+				SCHEDULER_MINTICKS, [spawns = std::move(spawns), next]() mutable { placeRaidSpawns(std::move(spawns), next); }, "AreaSpawnEvent::placeSpawns"
+			);
+		}
+	}
+}
+
 bool Raids::startup() {
 	if (!isLoaded() || isStarted()) {
 		return false;
 	}
 
-	setLastRaidEnd(OTSYS_TIME());
+	const int64_t now = OTSYS_TIME();
+	setLastRaidEnd(now);
 
-	checkRaidsEvent = g_scheduler().addEvent(CHECK_RAIDS_INTERVAL * 1000, std::bind(&Raids::checkRaids, this), "Raids::checkRaids");
+	nextAttempts.clear();
+	size_t order = 0;
+	for (const auto &raid : raidList) {
+		pushAttempt(raid, order++, now);
+	}
+	scheduleCheck();
 
 	started = true;
 	return started;
 }
 
+void Raids::pushAttempt(const std::shared_ptr<Raid> &raid, size_t order, int64_t from) {
+	from = std::max<int64_t>(from, getLastRaidEnd() + raid->getMargin());
+
+	// Checks are memoryless rolls, so the number of them until one succeeds is geometric and drawn at once
+	const double chance = getRaidStartChance(raid);
+	int64_t checks = 1;
+	if (chance < 1) {
+		const double draw = std::floor(std::log1p(-getRandomGenerator().uniformReal()) / std::log1p(-chance));
+		checks += static_cast<int64_t>(std::min<double>(draw, std::numeric_limits<int32_t>::max()));
+	}
+
+	nextAttempts.emplace_back(RaidAttempt { from + checks * CHECK_RAIDS_INTERVAL * 1000, order, raid });
+	std::ranges::push_heap(nextAttempts, std::greater {});
+}
+
+void Raids::scheduleCheck() {
+	g_scheduler().stopEvent(checkRaidsEvent);
+	checkRaidsEvent = 0;
+	if (nextAttempts.empty()) {
+		return;
+	}
+
+	const auto delay = std::clamp<int64_t>(nextAttempts.front().time - OTSYS_TIME(), SCHEDULER_MINTICKS, std::numeric_limits<int32_t>::max());
+	checkRaidsEvent = g_scheduler().addEvent(static_cast<uint32_t>(delay), std::bind(&Raids::checkRaids, this), "Raids::checkRaids");
+}
+
 void Raids::checkRaids() {
-	if (!getRunning()) {
-		uint64_t now = OTSYS_TIME();
-
-		for (auto it = raidList.begin(), end = raidList.end(); it != end; ++it) {
-			const auto &raid = *it;
-			if (now >= (getLastRaidEnd() + raid->getMargin())) {
-				auto roll = static_cast<uint32_t>(uniform_random(0, MAX_RAND_RANGE));
-				auto required = static_cast<uint32_t>(MAX_RAND_RANGE * raid->getInterval()) / CHECK_RAIDS_INTERVAL;
-				auto shouldStart = required >= roll;
-				if (shouldStart) {
-					setRunning(raid);
-					raid->startRaid();
-
-					if (!raid->canBeRepeated()) {
-						raidList.erase(it);
-					}
-					break;
-				}
-			}
+	checkRaidsEvent = 0;
+	const int64_t now = OTSYS_TIME();
+
+	std::vector<RaidAttempt> dueAttempts;
+	while (!nextAttempts.empty() && nextAttempts.front().time <= now) {
+		std::ranges::pop_heap(nextAttempts, std::greater {});
+		dueAttempts.emplace_back(std::move(nextAttempts.back()));
+		nextAttempts.pop_back();
+	}
+
+	// A single raid runs at a time, the others roll again once their margin after it passed
+	for (const auto &attempt : dueAttempts) {
+		const auto &raid = attempt.raid;
+		if (getRunning() || now < static_cast<int64_t>(getLastRaidEnd() + raid->getMargin())) {
+			pushAttempt(raid, attempt.order, now);
+			continue;
+		}
+
+		setRunning(raid);
+		raid->startRaid();
+
+		if (raid->canBeRepeated()) {
+			pushAttempt(raid, attempt.order, now);
+		} else {
+			raidList.remove(raid);
 		}
 	}
 
-	checkRaidsEvent = g_scheduler().addEvent(CHECK_RAIDS_INTERVAL * 1000, std::bind(&Raids::checkRaids, this), "Raids::checkRaids");
+	scheduleCheck();
 }
 
 void Raids::clear() {
 	g_scheduler().stopEvent(checkRaidsEvent);
 	checkRaidsEvent = 0;
+	nextAttempts.clear();
 
 	for (const auto &raid : raidList) {
 		raid->stopEvents();
@@ -526,29 +590,51 @@ bool AreaSpawnEvent::configureRaidEvent(const pugi::xml_node &eventNode) {
 }
 
 bool AreaSpawnEvent::executeEvent() {
+	if (!spawnPositionsResolved) {
+		spawnPositionsResolved = true;
+		for (uint32_t z = fromPos.z; z <= toPos.z; ++z) {
+			for (uint32_t y = fromPos.y; y <= toPos.y; ++y) {
+				for (uint32_t x = fromPos.x; x <= toPos.x; ++x) {
+					const Position position(static_cast<uint16_t>(x), static_cast<uint16_t>(y), static_cast<uint8_t>(z));
+					const auto tile = g_game().map.getTile(position);
+					if (tile && !tile->hasFlag(TILESTATE_PROTECTIONZONE)) {
+						spawnPositions.emplace_back(position);
+					}
+				}
+			}
+		}
+	}
+
+	// Every monster gets its tile now, the placement is then spread over the next ticks
+	auto spawns = std::make_shared<std::vector<std::pair<std::shared_ptr<Monster>, Position>>>();
+	phmap::flat_hash_set<Position> takenPositions;
 	for (const MonsterSpawn &spawn : spawnMonsterList) {
 		uint32_t amount = uniform_random(spawn.minAmount, spawn.maxAmount);
 		for (uint32_t i = 0; i < amount; ++i) {
 			std::shared_ptr<Monster> monster = Monster::createMonster(spawn.name);
 			if (!monster) {
 				g_logger().error("{} - Can't create monster {}", __FUNCTION__, spawn.name);
+				placeRaidSpawns(std::move(spawns), 0);
 				return false;
 			}
 
-			bool success = false;
-			for (int32_t tries = 0; tries < MAXIMUM_TRIES_PER_MONSTER; tries++) {
-				std::shared_ptr<Tile> tile = g_game().map.getTile(static_cast<uint16_t>(uniform_random(fromPos.x, toPos.x)), static_cast<uint16_t>(uniform_random(fromPos.y, toPos.y)), static_cast<uint8_t>(uniform_random(fromPos.z, toPos.z)));
-				if (tile && !tile->isMoveableBlocking() && !tile->hasFlag(TILESTATE_PROTECTIONZONE) && tile->getTopCreature() == nullptr && g_game().placeCreature(monster, tile->getPosition(), false, true)) {
-					success = true;
-					monster->setForgeMonster(false);
-					break;
+			for (int32_t tries = 0; tries < MAXIMUM_TRIES_PER_MONSTER && !spawnPositions.empty(); tries++) {
+				const auto &position = spawnPositions[uniform_random(0, static_cast<int32_t>(spawnPositions.size()) - 1)];
+				if (takenPositions.contains(position)) {
+					continue;
 				}
-			}
 
-			if (!success) {
+				std::shared_ptr<Tile> tile = g_game().map.getTile(position);
+				if (tile && !tile->isMoveableBlocking() && tile->getTopCreature() == nullptr) {
+					takenPositions.emplace(position);
+					spawns->emplace_back(monster, position);
+					break;
+				}
 			}
 		}
 	}
+
+	placeRaidSpawns(std::move(spawns), 0);
 	return true;
 }
 
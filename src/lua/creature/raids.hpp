@@ -27,6 +27,8 @@ struct MonsterSpawn {
 static constexpr int32_t MAXIMUM_TRIES_PER_MONSTER = 10;
 static constexpr int32_t CHECK_RAIDS_INTERVAL = 60;
 static constexpr int32_t RAID_MINTICKS = 1000;
+// Monsters of a raid spawn placed per tick, a big raid is spread over several ticks
+static constexpr size_t RAID_SPAWNS_PER_TICK = 20;
 
 class Raid;
 class RaidEvent;
@@ -76,9 +78,26 @@ public:
 	}
 
 private:
+	// When a raid gets its next roll to start, the earliest first and the one listed first on ties
+	struct RaidAttempt {
+		int64_t time;
+		size_t order;
+		std::shared_ptr<Raid> raid;
+
+		bool operator>(const RaidAttempt &other) const {
+			return time != other.time ? time > other.time : order > other.order;
+		}
+	};
+
+	// Draws the check at which the raid would start, rolling from the given time on
+	void pushAttempt(const std::shared_ptr<Raid> &raid, size_t order, int64_t from);
+	void scheduleCheck();
+
 	LuaScriptInterface scriptInterface { "Raid Interface" };
 
 	std::list<std::shared_ptr<Raid>> raidList;
+	// Min-heap of the next start rolls, one per raid
+	std::vector<RaidAttempt> nextAttempts;
 	std::shared_ptr<Raid> running = nullptr;
 	uint64_t lastRaidEnd = 0;
 	uint32_t checkRaidsEvent = 0;
@@ -186,6 +205,9 @@ public:
 private:
 	std::list<MonsterSpawn> spawnMonsterList;
 	Position fromPos, toPos;
+	// Tiles of the area out of protection zones, resolved on the first execution as the map is loaded by then
+	std::vector<Position> spawnPositions;
+	bool spawnPositionsResolved = false;
 };
 
 class ScriptEvent final : public RaidEvent, public Event {
@@ -20,6 +20,10 @@ void TalkActions::clear() {
 	talkActions.clear();
 }
 
+void TalkActions::clearFileEvents(const std::string &file) {
+	std::erase_if(talkActions, [&file](const auto &entry) { return entry.second->getScriptFile() == file; });
+}
+
 bool TalkActions::registerLuaEvent(const TalkAction_ptr &talkAction) {
 	auto [iterator, inserted] = talkActions.try_emplace(talkAction->getWords(), talkAction);
 	return inserted;
@@ -83,6 +83,8 @@ public:
 
 	bool registerLuaEvent(const TalkAction_ptr &talkAction);
 	void clear();
+	// Unregisters the events the given script file registered, for hot reload
+	void clearFileEvents(const std::string &file);
 
 	const std::map<std::string, std::shared_ptr<TalkAction>> &getTalkActionsMap() const {
 		return talkActions;
@@ -2,6 +2,7 @@
 #include "lua/functions/core/game/bank_functions.hpp"
 #include "game/bank/bank.hpp"
 #include "game/game.hpp"
+#include "io/iologindata.hpp"
 
 int BankFunctions::luaBankCredit(lua_State* L) {
 	// Bank.credit(playerOrGuild, amount)
@@ -63,6 +64,17 @@ int BankFunctions::luaBankTransfer(lua_State* L) {
 		lua_pushnil(L);
 		return 1;
 	}
+	// An offline player by name goes through the bank ledger, it is not loaded
+	if (lua_type(L, 2) == LUA_TSTRING && !g_game().getPlayerByName(getString(L, 2))) {
+		const uint32_t guid = IOLoginData::getGuidByName(getString(L, 2));
+		if (guid == 0) {
+			g_logger().debug("BankFunctions::luaBankTransfer: destination is null");
+			lua_pushnil(L);
+			return 1;
+		}
+		pushBoolean(L, source->transferToOffline(guid, getNumber<uint64_t>(L, 3)));
+		return 1;
+	}
 	std::shared_ptr<Bank> destination = getBank(L, 2);
 	if (destination == nullptr) {
 		g_logger().debug("BankFunctions::luaBankTransfer: destination is null");
@@ -17,9 +17,15 @@
 #include "io/iobestiary.hpp"
 #include "io/io_bosstiary.hpp"
 #include "io/iologindata.hpp"
+#include "creatures/players/management/ban.hpp"
 #include "lua/functions/core/game/game_functions.hpp"
 #include "lua/functions/events/event_callback_functions.hpp"
 #include "game/scheduling/dispatcher.hpp"
+#include "server/network/protocol/network_profiler.hpp"
+#include "lua/scripts/lua_profiler.hpp"
+#include "utils/object_pool.hpp"
+#include "lib/memory/allocator.hpp"
+#include "creatures/interactions/chat.hpp"
 #include "lua/creature/talkaction.hpp"
 #include "lua/functions/creatures/npc/npc_type_functions.hpp"
 #include "lua/scripts/lua_environment.hpp"
@@ -75,7 +81,7 @@ int GameFunctions::luaGameGetSpectators(lua_State* L) {
 	lua_createtable(L, spectators.size(), 0);
 
 	int index = 0;
-	for (std::shared_ptr<Creature> creature : spectators) {
+	for (const auto &creature : spectators) {
 		pushUserdata<Creature>(L, creature);
 		setCreatureMetatable(L, -1, creature);
 		lua_rawseti(L, -2, ++index);
@@ -179,10 +185,10 @@ int GameFunctions::luaGameGetNpcCount(lua_State* L) {
 
 int GameFunctions::luaGameGetMonsterTypes(lua_State* L) {
 	// Game.getMonsterTypes()
-	const auto type = g_monsters().monsters;
+	const auto &type = g_monsters().monsters;
 	lua_createtable(L, type.size(), 0);
 
-	for (const auto [typeName, mType] : type) {
+	for (const auto &[typeName, mType] : type) {
 		pushUserdata<MonsterType>(L, mType);
 		setMetatable(L, -1, "MonsterType");
 		lua_setfield(L, -2, typeName.c_str());
@@ -413,7 +419,7 @@ int GameFunctions::luaGameCreateMonster(lua_State* L) {
 		if (mtype && mtype->info.raceid > 0 && mtype->info.bosstiaryRace == BosstiaryRarity_t::RARITY_ARCHFOE) {
 			SpectatorHashSet spectators;
 			g_game().map.getSpectators(spectators, monster->getPosition(), true);
-			for (std::shared_ptr<Creature> spectator : spectators) {
+			for (const auto &spectator : spectators) {
 				if (auto tmpPlayer = spectator->getPlayer()) {
 					auto bossesOnTracker = g_ioBosstiary().getBosstiaryCooldownRaceId(tmpPlayer);
 					// If not have boss to update, then kill loop for economize resources
@@ -477,7 +483,7 @@ int GameFunctions::luaGameCreateTile(lua_State* L) {
 	// Game.createTile(position[, isDynamic = false])
 	Position position;
 	bool isDynamic;
-	if (isTable(L, 1)) {
+	if (isPosition(L, 1)) {
 		position = getPosition(L, 1);
 		isDynamic = getBoolean(L, 2, false);
 	} else {
@@ -768,3 +774,205 @@ int GameFunctions::luaGameGetEventCallbacks(lua_State* L) {
 	lua_pop(L, 1);
 	return 1;
 }
+
+int GameFunctions::luaGameGetTaskProfile(lua_State* L) {
+	// Game.getTaskProfile()
+	const auto profiles = g_dispatcher().getProfiler().getSortedProfiles();
+	lua_createtable(L, static_cast<int>(profiles.size()), 0);
+
+	int index = 0;
+	for (const auto &[context, profile] : profiles) {
+		const auto &[calls, execution, wait] = *profile;
+		lua_createtable(L, 0, 8);
+		setField(L, "context", std::string(context));
+		setField(L, "calls", calls);
+		setField(L, "total", execution.total);
+		setField(L, "p50", execution.percentile(calls, 50));
+		setField(L, "p99", execution.percentile(calls, 99));
+		setField(L, "max", execution.max);
+		setField(L, "waitP99", wait.percentile(calls, 99));
+		setField(L, "waitMax", wait.max);
+		lua_rawseti(L, -2, ++index);
+	}
+	return 1;
+}
+
+int GameFunctions::luaGameResetTaskProfile(lua_State* L) {
+	// Game.resetTaskProfile()
+	g_dispatcher().getProfiler().reset();
+	pushBoolean(L, true);
+	return 1;
+}
+
+int GameFunctions::luaGameGetNetworkProfile(lua_State* L) {
+	// Game.getNetworkProfile()
+	const auto &profiler = g_networkProfiler();
+	lua_createtable(L, 0, 2);
+
+	const auto &opcodes = profiler.getOpcodeProfiles();
+	lua_createtable(L, 0, 0);
+	int index = 0;
+	for (size_t opcode = 0; opcode < opcodes.size(); ++opcode) {
+		const auto &[calls, bytes, execution] = opcodes[opcode];
+		if (calls == 0) {
+			continue;
+		}
+
+		lua_createtable(L, 0, 7);
+		setField(L, "opcode", opcode);
+		setField(L, "calls", calls);
+		setField(L, "bytes", bytes);
+		setField(L, "total", execution.total);
+		setField(L, "p50", execution.percentile(calls, 50));
+		setField(L, "p99", execution.percentile(calls, 99));
+		setField(L, "max", execution.max);
+		lua_rawseti(L, -2, ++index);
+	}
+	lua_setfield(L, -2, "opcodes");
+
+	const auto sends = profiler.getSortedSends();
+	lua_createtable(L, static_cast<int>(sends.size()), 0);
+	index = 0;
+	for (const auto &[function, profile] : sends) {
+		lua_createtable(L, 0, 3);
+		setField(L, "function", std::string(function));
+		setField(L, "messages", profile.messages);
+		setField(L, "bytes", profile.bytes);
+		lua_rawseti(L, -2, ++index);
+	}
+	lua_setfield(L, -2, "sends");
+	return 1;
+}
+
+int GameFunctions::luaGameResetNetworkProfile(lua_State* L) {
+	// Game.resetNetworkProfile()
+	g_networkProfiler().reset();
+	pushBoolean(L, true);
+	return 1;
+}
+
+int GameFunctions::luaGameGetLuaProfile(lua_State* L) {
+	// Game.getLuaProfile([byMax = false])
+	const auto &profiler = g_luaProfiler();
+	lua_createtable(L, 0, 3);
+
+	const auto calls = profiler.getSortedCalls(getBoolean(L, 1, false));
+	lua_createtable(L, static_cast<int>(calls.size()), 0);
+	int index = 0;
+	for (const auto &[script, profile] : calls) {
+		const auto &[interfaceName, callCount, execution] = *profile;
+		lua_createtable(L, 0, 7);
+		setField(L, "script", std::string(script));
+		setField(L, "interface", interfaceName);
+		setField(L, "calls", callCount);
+		setField(L, "total", execution.total);
+		setField(L, "p50", execution.percentile(callCount, 50));
+		setField(L, "p99", execution.percentile(callCount, 99));
+		setField(L, "max", execution.max);
+		lua_rawseti(L, -2, ++index);
+	}
+	lua_setfield(L, -2, "calls");
+
+	const auto samples = profiler.getSortedSamples();
+	lua_createtable(L, static_cast<int>(samples.size()), 0);
+	index = 0;
+	for (const auto &[location, count] : samples) {
+		lua_createtable(L, 0, 2);
+		setField(L, "location", std::string(location));
+		setField(L, "samples", count);
+		lua_rawseti(L, -2, ++index);
+	}
+	lua_setfield(L, -2, "samples");
+
+	pushBoolean(L, profiler.isSampling());
+	lua_setfield(L, -2, "sampling");
+	return 1;
+}
+
+int GameFunctions::luaGameResetLuaProfile(lua_State* L) {
+	// Game.resetLuaProfile()
+	g_luaProfiler().reset();
+	pushBoolean(L, true);
+	return 1;
+}
+
+int GameFunctions::luaGameStartLuaSampling(lua_State* L) {
+	// Game.startLuaSampling([intervalMs = 1])
+	pushBoolean(L, g_luaProfiler().startSampling(L, getNumber<uint32_t>(L, 1, 1)));
+	return 1;
+}
+
+int GameFunctions::luaGameStopLuaSampling(lua_State* L) {
+	// Game.stopLuaSampling()
+	g_luaProfiler().stopSampling();
+	pushBoolean(L, true);
+	return 1;
+}
+
+int GameFunctions::luaGameGetObjectPoolStats(lua_State* L) {
+	// Game.getObjectPoolStats()
+	const auto stats = ObjectPoolRegistry::getStats();
+	lua_createtable(L, static_cast<int>(stats.size()), 0);
+
+	int index = 0;
+	for (const auto &[name, blockSize, live, capacity] : stats) {
+		lua_createtable(L, 0, 4);
+		setField(L, "name", std::string(name));
+		setField(L, "blockSize", blockSize);
+		setField(L, "live", live);
+		setField(L, "capacity", capacity);
+		lua_rawseti(L, -2, ++index);
+	}
+	return 1;
+}
+
+int GameFunctions::luaGameGetChatChannelStats(lua_State* L) {
+	// Game.getChatChannelStats() returns the channels and the seconds they were counted for
+	const auto stats = g_chat().getChannelStats();
+	lua_createtable(L, static_cast<int>(stats.size()), 0);
+
+	int index = 0;
+	for (const auto &[name, id, users, messages, deliveries] : stats) {
+		lua_createtable(L, 0, 5);
+		setField(L, "name", name);
+		setField(L, "id", id);
+		setField(L, "users", users);
+		setField(L, "messages", messages);
+		setField(L, "deliveries", deliveries);
+		lua_rawseti(L, -2, ++index);
+	}
+	lua_pushnumber(L, static_cast<lua_Number>(time(nullptr) - g_chat().getStatsSince()));
+	return 2;
+}
+
+int GameFunctions::luaGameResetChatChannelStats(lua_State* L) {
+	// Game.resetChatChannelStats()
+	g_chat().resetChannelStats();
+	pushBoolean(L, true);
+	return 1;
+}
+
+int GameFunctions::luaGameGetAllocatorStats(lua_State* L) {
+	// Game.getAllocatorStats()
+	const auto stats = Allocator::getStats();
+	lua_createtable(L, 0, 4);
+	setField(L, "name", std::string(stats.name));
+	setField(L, "allocated", stats.allocated);
+	setField(L, "committed", stats.committed);
+	setField(L, "resident", stats.resident);
+	return 1;
+}
+
+int GameFunctions::luaGamePurgeAllocator(lua_State* L) {
+	// Game.purgeAllocator()
+	Allocator::purge();
+	pushBoolean(L, true);
+	return 1;
+}
+
+int GameFunctions::luaGameReloadBans(lua_State* L) {
+	// Game.reloadBans()
+	IOBan::reload();
+	pushBoolean(L, true);
+	return 1;
+}
@@ -81,6 +81,21 @@ public:
 
 		registerMethod(L, "Game", "getTalkActions", GameFunctions::luaGameGetTalkActions);
 		registerMethod(L, "Game", "getEventCallbacks", GameFunctions::luaGameGetEventCallbacks);
+
+		registerMethod(L, "Game", "getTaskProfile", GameFunctions::luaGameGetTaskProfile);
+		registerMethod(L, "Game", "resetTaskProfile", GameFunctions::luaGameResetTaskProfile);
+		registerMethod(L, "Game", "getNetworkProfile", GameFunctions::luaGameGetNetworkProfile);
+		registerMethod(L, "Game", "resetNetworkProfile", GameFunctions::luaGameResetNetworkProfile);
+		registerMethod(L, "Game", "getLuaProfile", GameFunctions::luaGameGetLuaProfile);
+		registerMethod(L, "Game", "resetLuaProfile", GameFunctions::luaGameResetLuaProfile);
+		registerMethod(L, "Game", "startLuaSampling", GameFunctions::luaGameStartLuaSampling);
+		registerMethod(L, "Game", "stopLuaSampling", GameFunctions::luaGameStopLuaSampling);
+		registerMethod(L, "Game", "getObjectPoolStats", GameFunctions::luaGameGetObjectPoolStats);
+		registerMethod(L, "Game", "getChatChannelStats", GameFunctions::luaGameGetChatChannelStats);
+		registerMethod(L, "Game", "resetChatChannelStats", GameFunctions::luaGameResetChatChannelStats);
+		registerMethod(L, "Game", "getAllocatorStats", GameFunctions::luaGameGetAllocatorStats);
+		registerMethod(L, "Game", "purgeAllocator", GameFunctions::luaGamePurgeAllocator);
+		registerMethod(L, "Game", "reloadBans", GameFunctions::luaGameReloadBans);
 	}
 
 private:
@@ -150,4 +165,19 @@ private:
 
 	static int luaGameGetTalkActions(lua_State* L);
 	static int luaGameGetEventCallbacks(lua_State* L);
+
+	static int luaGameGetTaskProfile(lua_State* L);
+	static int luaGameResetTaskProfile(lua_State* L);
+	static int luaGameGetNetworkProfile(lua_State* L);
+	static int luaGameResetNetworkProfile(lua_State* L);
+	static int luaGameGetLuaProfile(lua_State* L);
+	static int luaGameResetLuaProfile(lua_State* L);
+	static int luaGameStartLuaSampling(lua_State* L);
+	static int luaGameStopLuaSampling(lua_State* L);
+	static int luaGameGetObjectPoolStats(lua_State* L);
+	static int luaGameGetChatChannelStats(lua_State* L);
+	static int luaGameResetChatChannelStats(lua_State* L);
+	static int luaGameGetAllocatorStats(lua_State* L);
+	static int luaGamePurgeAllocator(lua_State* L);
+	static int luaGameReloadBans(lua_State* L);
 };
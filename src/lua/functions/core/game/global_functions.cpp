@@ -678,13 +678,8 @@ int GlobalFunctions::luaAddEvent(lua_State* L) {
 	eventDesc.scriptName = getScriptEnv()->getScriptInterface()->getLoadingScriptName();
 
 	auto &lastTimerEventId = g_luaEnvironment().lastEventTimerId;
-	eventDesc.eventId = g_scheduler().addEvent(
-		delay,
-		std::bind(&LuaEnvironment::executeTimerEvent, &g_luaEnvironment(), lastTimerEventId),
-		"LuaEnvironment::executeTimerEvent"
-	);
-
 	g_luaEnvironment().timerEvents.emplace(lastTimerEventId, std::move(eventDesc));
+	g_luaEnvironment().scheduleTimerEvent(lastTimerEventId, delay);
 	lua_pushnumber(L, lastTimerEventId++);
 	return 1;
 }
@@ -710,7 +705,7 @@ int GlobalFunctions::luaStopEvent(lua_State* L) {
 	LuaTimerEventDesc timerEventDesc = std::move(it->second);
 	timerEvents.erase(it);
 
-	g_scheduler().stopEvent(timerEventDesc.eventId);
+	// The id left in its timer bucket is skipped when the bucket runs
 	luaL_unref(globalState, LUA_REGISTRYINDEX, timerEventDesc.function);
 
 	for (auto parameter : timerEventDesc.parameters) {
@@ -728,6 +723,13 @@ int GlobalFunctions::luaSaveServer(lua_State* L) {
 }
 
 int GlobalFunctions::luaCleanMap(lua_State* L) {
+	// cleanMap([incremental = false])
+	// Incremental returns the tiles queued instead of the items removed
+	if (getBoolean(L, 1, false)) {
+		lua_pushnumber(L, g_game().startIncrementalClean());
+		return 1;
+	}
+
 	lua_pushnumber(L, Map::clean());
 	return 1;
 }
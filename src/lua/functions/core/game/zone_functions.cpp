@@ -157,7 +157,7 @@ int ZoneFunctions::luaZoneGetCreatures(lua_State* L) {
 	for (auto creature : creatures) {
 		index++;
 		pushUserdata<Creature>(L, creature);
-		setMetatable(L, -1, "Creature");
+		setCreatureMetatable(L, -1, creature);
 		lua_rawseti(L, -2, index);
 	}
 	return 1;
@@ -241,7 +241,7 @@ int ZoneFunctions::luaZoneGetItems(lua_State* L) {
 	for (auto item : items) {
 		index++;
 		pushUserdata<Item>(L, item);
-		setMetatable(L, -1, "Item");
+		setItemMetatable(L, -1, item);
 		lua_rawseti(L, -2, index);
 	}
 	return 1;
@@ -15,6 +15,7 @@
 #include "lua/functions/core/libs/result_functions.hpp"
 #include "lua/functions/core/libs/logger_functions.hpp"
 #include "lua/functions/core/libs/kv_functions.hpp"
+#include "lua/functions/core/libs/ffi_functions.hpp"
 
 class CoreLibsFunctions final : LuaScriptInterface {
 public:
@@ -24,6 +25,7 @@ public:
 		ResultFunctions::init(L);
 		LoggerFunctions::init(L);
 		KVFunctions::init(L);
+		FFIFunctions::init(L);
 	}
 
 private:
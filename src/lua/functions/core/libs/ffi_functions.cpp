@@ -0,0 +1,108 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lua/functions/core/libs/ffi_functions.hpp"
+
+#include "config/configmanager.hpp"
+#include "creatures/players/player.hpp"
+#include "items/item.hpp"
+
+#ifdef LUAJIT_VERSION
+namespace {
+	/**
+	 * The FFI passes the userdata payload, which like for getUserdataShared
+	 * is the shared_ptr of the object. Number getters return NaN where the
+	 * Lua C API version would return nil, every value they return is exactly
+	 * representable as a double.
+	 */
+	constexpr std::string_view ffiDeclarations = R"(
+		typedef struct { uint16_t x, y; uint8_t z; } canary_position;
+		double canary_creature_get_health(void* creature);
+		bool canary_creature_get_position(void* creature, canary_position* position);
+		double canary_player_get_level(void* player);
+		double canary_player_get_storage_value(void* player, uint32_t key);
+		double canary_item_get_id(void* item);
+	)";
+
+	struct FFIPosition {
+		uint16_t x, y;
+		uint8_t z;
+	};
+
+	template <typename T>
+	T* getObject(void* userdata) {
+		if (!userdata) {
+			return nullptr;
+		}
+		return static_cast<std::shared_ptr<T>*>(userdata)->get();
+	}
+
+	constexpr double FFI_NIL = std::numeric_limits<double>::quiet_NaN();
+
+	extern "C" {
+	double canary_creature_get_health(void* userdata) {
+		const auto creature = getObject<Creature>(userdata);
+		return creature ? creature->getHealth() : FFI_NIL;
+	}
+
+	bool canary_creature_get_position(void* userdata, FFIPosition* position) {
+		const auto creature = getObject<Creature>(userdata);
+		if (!creature) {
+			return false;
+		}
+		const auto &creaturePosition = creature->getPosition();
+		*position = { creaturePosition.x, creaturePosition.y, creaturePosition.z };
+		return true;
+	}
+
+	double canary_player_get_level(void* userdata) {
+		const auto player = getObject<Player>(userdata);
+		return player ? player->getLevel() : FFI_NIL;
+	}
+
+	double canary_player_get_storage_value(void* userdata, uint32_t key) {
+		const auto player = getObject<Player>(userdata);
+		return player ? player->getStorageValue(key) : FFI_NIL;
+	}
+
+	double canary_item_get_id(void* userdata) {
+		const auto item = getObject<Item>(userdata);
+		return item ? item->getID() : FFI_NIL;
+	}
+	}
+
+	void setFunction(lua_State* L, const char* name, void* function) {
+		lua_pushlightuserdata(L, function);
+		lua_setfield(L, -2, name);
+	}
+}
+#endif
+
+void FFIFunctions::init(lua_State* L) {
+#ifdef LUAJIT_VERSION
+	if (!g_configManager().getBoolean(LUA_FFI_GETTERS)) {
+		return;
+	}
+
+	lua_createtable(L, 0, 6);
+	lua_pushlstring(L, ffiDeclarations.data(), ffiDeclarations.size());
+	lua_setfield(L, -2, "cdef");
+	setFunction(L, "creatureGetHealth", reinterpret_cast<void*>(&canary_creature_get_health));
+	// Positions pushed as userdata can't be built from Lua, so scripts keep the C API getter
+	if (!g_configManager().getBoolean(LUA_POSITION_USERDATA)) {
+		setFunction(L, "creatureGetPosition", reinterpret_cast<void*>(&canary_creature_get_position));
+	}
+	setFunction(L, "playerGetLevel", reinterpret_cast<void*>(&canary_player_get_level));
+	setFunction(L, "playerGetStorageValue", reinterpret_cast<void*>(&canary_player_get_storage_value));
+	setFunction(L, "itemGetId", reinterpret_cast<void*>(&canary_item_get_id));
+	lua_setglobal(L, "CanaryFFI");
+#endif
+}
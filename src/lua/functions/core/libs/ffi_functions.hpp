@@ -0,0 +1,25 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "lua/scripts/luascript.hpp"
+
+/**
+ * C ABI for the hottest read-only getters, called through the LuaJIT FFI
+ * by data/libs/functions/ffi.lua instead of the Lua C API.
+ * The functions are handed to Lua as light userdata in the CanaryFFI
+ * table, together with the declarations to give ffi.cdef, so nothing has
+ * to be exported from the binary. Only registered with LuaJIT and when
+ * luaFfiGetters is enabled.
+ */
+class FFIFunctions final : LuaScriptInterface {
+public:
+	static void init(lua_State* L);
+};
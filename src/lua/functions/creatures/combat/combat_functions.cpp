@@ -119,7 +119,11 @@ int CombatFunctions::luaCombatSetCallback(lua_State* L) {
 	}
 
 	const std::string &function = getString(L, 3);
-	pushBoolean(L, callback->loadCallBack(getScriptEnv()->getScriptInterface(), function));
+	const bool loaded = callback->loadCallBack(getScriptEnv()->getScriptInterface(), function);
+	if (loaded && key == CALLBACK_PARAM_LEVELMAGICVALUE) {
+		static_cast<ValueCallback*>(callback)->compileFormula();
+	}
+	pushBoolean(L, loaded);
 	return 1;
 }
 
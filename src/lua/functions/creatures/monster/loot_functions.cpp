@@ -43,7 +43,7 @@ int LootFunctions::luaLootSetIdFromName(lua_State* L) {
 	const auto loot = getUserdataShared<Loot>(L, 1);
 	if (loot && isString(L, 2)) {
 		auto name = getString(L, 2);
-		auto ids = Item::items.nameToItems.equal_range(asLowerCaseString(name));
+		auto ids = Item::items.nameToItems.equal_range(name);
 
 		if (ids.first == Item::items.nameToItems.cend()) {
 			g_logger().warn("[LootFunctions::luaLootSetIdFromName] - "
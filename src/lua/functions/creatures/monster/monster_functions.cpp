@@ -94,7 +94,7 @@ int MonsterFunctions::luaMonsterSetType(lua_State* L) {
 		// Reload creature on spectators
 		SpectatorHashSet spectators;
 		g_game().map.getSpectators(spectators, monster->getPosition(), true);
-		for (auto spectator : spectators) {
+		for (const auto &spectator : spectators) {
 			if (auto tmpPlayer = spectator->getPlayer()) {
 				tmpPlayer->sendCreatureReload(monster);
 			}
@@ -467,6 +467,7 @@ int MonsterFunctions::luaMonsterSetForgeStack(lua_State* L) {
 	}
 
 	monster->setForgeStack(stack);
+	g_game().updateForgeableMonster(monster);
 	auto icon = stack < 15
 		? CreatureIconModifications_t::Influenced
 		: CreatureIconModifications_t::Fiendish;
@@ -772,7 +772,7 @@ int MonsterTypeFunctions::luaMonsterTypeAddAttack(lua_State* L) {
 		if (spell) {
 			spellBlock_t sb;
 			if (g_monsters().deserializeSpell(spell, sb, monsterType->name)) {
-				monsterType->info.attackSpells.push_back(std::move(sb));
+				monsterType->addAttackSpell(std::move(sb));
 			} else {
 				g_logger().warn("Monster: {}, cant load spell: {}", monsterType->name, spell->name);
 			}
@@ -390,9 +390,7 @@ int NpcFunctions::luaNpcIsMerchant(lua_State* L) {
 		return 1;
 	}
 
-	const std::vector<ShopBlock> shopItems = npc->getShopItemVector();
-
-	if (shopItems.empty()) {
+	if (npc->getShopItemVector().empty()) {
 		pushBoolean(L, false);
 		return 1;
 	}
@@ -411,7 +409,7 @@ int NpcFunctions::luaNpcGetShopItem(lua_State* L) {
 	}
 
 	const std::vector<ShopBlock> &shopVector = npc->getShopItemVector();
-	for (ShopBlock shopBlock : shopVector) {
+	for (const ShopBlock &shopBlock : shopVector) {
 		setField(L, "id", shopBlock.itemId);
 		setField(L, "name", shopBlock.itemName);
 		setField(L, "subType", shopBlock.itemSubType);
@@ -516,7 +514,7 @@ int NpcFunctions::luaNpcSellItem(lua_State* L) {
 
 	uint64_t pricePerUnit = 0;
 	const std::vector<ShopBlock> &shopVector = npc->getShopItemVector();
-	for (ShopBlock shopBlock : shopVector) {
+	for (const ShopBlock &shopBlock : shopVector) {
 		if (itemId == shopBlock.itemId && shopBlock.itemBuyPrice != 0) {
 			pricePerUnit = shopBlock.itemBuyPrice;
 			break;
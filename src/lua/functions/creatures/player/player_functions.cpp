@@ -214,6 +214,27 @@ int PlayerFunctions::luaPlayerGetGuid(lua_State* L) {
 	return 1;
 }
 
+int PlayerFunctions::luaPlayerAddDeathRecord(lua_State* L) {
+	// player:addDeathRecord(time, level, killedBy, byPlayer, mostDamageBy, mostDamageByPlayer, unjustified, mostDamageUnjustified)
+	std::shared_ptr<Player> player = getUserdataShared<Player>(L, 1);
+	if (!player) {
+		reportErrorFunc(getErrorDesc(LUA_ERROR_PLAYER_NOT_FOUND));
+		pushBoolean(L, false);
+		return 1;
+	}
+
+	PlayerDeathRecord record;
+	record.time = getNumber<uint32_t>(L, 2);
+	record.level = getNumber<uint32_t>(L, 3);
+	record.killedBy = getString(L, 4);
+	record.mostDamageBy = getString(L, 6);
+	record.unjustified = getBoolean(L, 8, false);
+	record.mostDamageUnjustified = getBoolean(L, 9, false);
+	g_game().addPlayerDeathRecord(player, std::move(record), getBoolean(L, 5, false), getBoolean(L, 7, false));
+	pushBoolean(L, true);
+	return 1;
+}
+
 int PlayerFunctions::luaPlayerGetIp(lua_State* L) {
 	// player:getIp()
 	std::shared_ptr<Player> player = getUserdataShared<Player>(L, 1);
@@ -320,22 +341,15 @@ int PlayerFunctions::luaPlayerIsMonsterBestiaryUnlocked(lua_State* L) {
 	}
 
 	auto raceId = getNumber<uint16_t>(L, 2, 0);
-	if (!g_monsters().getMonsterTypeByRaceId(raceId)) {
+	const auto mtype = g_monsters().getMonsterTypeByRaceId(raceId);
+	if (!mtype) {
 		reportErrorFunc("Monster race id not exists");
 		pushBoolean(L, false);
 		return 0;
 	}
 
-	for (auto finishedMonsters = g_iobestiary().getBestiaryFinished(player);
-		 uint16_t finishedRaceId : finishedMonsters) {
-		if (raceId == finishedRaceId) {
-			pushBoolean(L, true);
-			return 1;
-		}
-	}
-
-	pushBoolean(L, false);
-	return 0;
+	pushBoolean(L, player->getBestiaryKillCount(raceId) >= mtype->info.bestiaryFirstUnlock);
+	return 1;
 }
 
 int PlayerFunctions::luaPlayergetCharmMonsterType(lua_State* L) {
@@ -659,6 +673,59 @@ int PlayerFunctions::luaPlayerGetReward(lua_State* L) {
 	return 1;
 }
 
+int PlayerFunctions::luaPlayerAddRewardItems(lua_State* L) {
+	// player:addRewardItems(rewardId, { [itemId] = { count = count }, ... })
+	// Each entry gives one item like container:addItem, charges override the count and stacks are capped at the stack size
+	std::shared_ptr<Player> player = getUserdataShared<Player>(L, 1);
+	if (!player) {
+		lua_pushnil(L);
+		return 1;
+	}
+
+	if (!isTable(L, 3)) {
+		reportErrorFunc("Loot table is missing");
+		pushBoolean(L, false);
+		return 1;
+	}
+
+	const uint64_t rewardId = getNumber<uint64_t>(L, 2);
+	std::vector<std::shared_ptr<Item>> items;
+	lua_pushnil(L);
+	while (lua_next(L, 3) != 0) {
+		// -2 is the item id, -1 the loot info
+		const auto itemId = getNumber<uint16_t>(L, -2);
+		uint32_t count = 1;
+		if (isTable(L, -1)) {
+			lua_getfield(L, -1, "count");
+			count = getNumber<uint32_t>(L, -1, 1);
+			lua_pop(L, 1);
+		}
+		lua_pop(L, 1);
+
+		const ItemType &itemType = Item::items[itemId];
+		if (itemType.id == 0) {
+			continue;
+		}
+
+		if (itemType.charges > 0) {
+			count = itemType.charges;
+		}
+		if (itemType.stackable) {
+			count = std::min<uint32_t>(count, itemType.stackSize);
+		}
+		items.emplace_back(Item::CreateItem(itemId, count));
+	}
+	std::erase(items, nullptr);
+
+	if (auto reward = player->addRewardItems(rewardId, items)) {
+		pushUserdata<Item>(L, reward);
+		setItemMetatable(L, -1, reward);
+	} else {
+		pushBoolean(L, false);
+	}
+	return 1;
+}
+
 int PlayerFunctions::luaPlayerRemoveReward(lua_State* L) {
 	// player:removeReward(rewardId)
 	std::shared_ptr<Player> player = getUserdataShared<Player>(L, 1);
@@ -729,7 +796,7 @@ int PlayerFunctions::luaPlayerGetStashCounter(lua_State* L) {
 	// player:getStashCount()
 	std::shared_ptr<Player> player = getUserdataShared<Player>(L, 1);
 	if (player) {
-		uint16_t sizeStash = getStashSize(player->getStashItems());
+		uint16_t sizeStash = static_cast<uint16_t>(player->getStashSize());
 		lua_pushnumber(L, sizeStash);
 	} else {
 		lua_pushnil(L);
@@ -2949,7 +3016,7 @@ int PlayerFunctions::luaPlayerSetGhostMode(lua_State* L) {
 
 	SpectatorHashSet spectators;
 	g_game().map.getSpectators(spectators, position, true, true);
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		auto tmpPlayer = spectator->getPlayer();
 		if (tmpPlayer != player && !tmpPlayer->isAccessPlayer()) {
 			if (enabled) {
@@ -2962,19 +3029,14 @@ int PlayerFunctions::luaPlayerSetGhostMode(lua_State* L) {
 		}
 	}
 
+	const auto notAccessPlayer = [](const std::shared_ptr<Player> &watcher) {
+		return !watcher->isAccessPlayer();
+	};
 	if (player->isInGhostMode()) {
-		for (const auto &it : g_game().getPlayers()) {
-			if (!it.second->isAccessPlayer()) {
-				it.second->notifyStatusChange(player, VIPSTATUS_OFFLINE);
-			}
-		}
+		g_game().notifyVipStatusChange(player, VIPSTATUS_OFFLINE, true, notAccessPlayer);
 		IOLoginData::updateOnlineStatus(player->getGUID(), false);
 	} else {
-		for (const auto &it : g_game().getPlayers()) {
-			if (!it.second->isAccessPlayer()) {
-				it.second->notifyStatusChange(player, player->statusVipList);
-			}
-		}
+		g_game().notifyVipStatusChange(player, player->statusVipList, true, notAccessPlayer);
 		IOLoginData::updateOnlineStatus(player->getGUID(), true);
 	}
 	pushBoolean(L, true);
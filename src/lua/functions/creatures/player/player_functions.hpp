@@ -29,6 +29,7 @@ private:
 
 		registerMethod(L, "Player", "getGuid", PlayerFunctions::luaPlayerGetGuid);
 		registerMethod(L, "Player", "getIp", PlayerFunctions::luaPlayerGetIp);
+		registerMethod(L, "Player", "addDeathRecord", PlayerFunctions::luaPlayerAddDeathRecord);
 		registerMethod(L, "Player", "getAccountId", PlayerFunctions::luaPlayerGetAccountId);
 		registerMethod(L, "Player", "getLastLoginSaved", PlayerFunctions::luaPlayerGetLastLoginSaved);
 		registerMethod(L, "Player", "getLastLogout", PlayerFunctions::luaPlayerGetLastLogout);
@@ -64,6 +65,7 @@ private:
 		registerMethod(L, "Player", "setKills", PlayerFunctions::luaPlayerSetKills);
 
 		registerMethod(L, "Player", "getReward", PlayerFunctions::luaPlayerGetReward);
+		registerMethod(L, "Player", "addRewardItems", PlayerFunctions::luaPlayerAddRewardItems);
 		registerMethod(L, "Player", "removeReward", PlayerFunctions::luaPlayerRemoveReward);
 		registerMethod(L, "Player", "getRewardList", PlayerFunctions::luaPlayerGetRewardList);
 
@@ -368,6 +370,7 @@ private:
 
 	static int luaPlayerGetGuid(lua_State* L);
 	static int luaPlayerGetIp(lua_State* L);
+	static int luaPlayerAddDeathRecord(lua_State* L);
 	static int luaPlayerGetAccountId(lua_State* L);
 	static int luaPlayerGetLastLoginSaved(lua_State* L);
 	static int luaPlayerGetLastLogout(lua_State* L);
@@ -403,6 +406,7 @@ private:
 	static int luaPlayerGetFreeCapacity(lua_State* L);
 
 	static int luaPlayerGetReward(lua_State* L);
+	static int luaPlayerAddRewardItems(lua_State* L);
 	static int luaPlayerRemoveReward(lua_State* L);
 	static int luaPlayerGetRewardList(lua_State* L);
 
@@ -168,6 +168,7 @@ int ActionFunctions::luaActionPosition(lua_State* L) {
 		ItemType &itemType = Item::items.getItemType(itemId);
 		if (itemType.moveable == true) {
 			itemType.moveable = false;
+			Item::items.updateTypeFlags(itemId);
 		}
 
 		g_game().setCreateLuaItems(position, itemId);
@@ -584,7 +584,7 @@ int ItemFunctions::luaItemMoveTo(lua_State* L) {
 	}
 
 	std::shared_ptr<Cylinder> toCylinder;
-	if (isUserdata(L, 2)) {
+	if (isUserdata(L, 2) && !getPositionUserdata(L, 2)) {
 		const LuaData_t type = getUserdataType(L, 2);
 		switch (type) {
 			case LuaData_t::Container:
@@ -9,6 +9,7 @@
 
 #include "pch.hpp"
 
+#include "config/configmanager.hpp"
 #include "creatures/combat/spells.hpp"
 #include "creatures/monsters/monster.hpp"
 #include "creatures/npcs/npc.hpp"
@@ -29,6 +30,13 @@
 
 class LuaScriptInterface;
 
+namespace {
+	// Registry refs, created again with every Lua state in LuaFunctionsLoader::load
+	int internedUserdataRef = LUA_NOREF;
+	int positionMetatableRef = LUA_NOREF;
+	phmap::flat_hash_map<std::string, int> metatableRefs;
+}
+
 void LuaFunctionsLoader::load(lua_State* L) {
 	if (!L) {
 		g_game().dieSafely("Invalid lua state, cannot load lua functions.");
@@ -42,6 +50,18 @@ void LuaFunctionsLoader::load(lua_State* L) {
 	ItemFunctions::init(L);
 	MapFunctions::init(L);
 	ZoneFunctions::init(L);
+
+	// Object address -> userdata, weak so the cache never keeps a userdata alive
+	lua_newtable(L);
+	lua_newtable(L);
+	lua_pushstring(L, "v");
+	lua_setfield(L, -2, "__mode");
+	lua_setmetatable(L, -2);
+	internedUserdataRef = luaL_ref(L, LUA_REGISTRYINDEX);
+	metatableRefs.clear();
+
+	luaL_getmetatable(L, "PositionValue");
+	positionMetatableRef = luaL_ref(L, LUA_REGISTRYINDEX);
 }
 
 std::string LuaFunctionsLoader::getErrorDesc(ErrorCode_t code) {
@@ -206,8 +226,51 @@ int32_t LuaFunctionsLoader::popCallback(lua_State* L) {
 }
 
 // Metatables
-void LuaFunctionsLoader::setMetatable(lua_State* L, int32_t index, const std::string &name) {
+bool LuaFunctionsLoader::pushInternedUserdata(lua_State* L, const void* object) {
+	if (internedUserdataRef == LUA_NOREF) {
+		return false;
+	}
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, internedUserdataRef);
+	lua_pushlightuserdata(L, const_cast<void*>(object));
+	lua_rawget(L, -2);
+	lua_remove(L, -2);
+	if (lua_isuserdata(L, -1)) {
+		return true;
+	}
+
+	lua_pop(L, 1);
+	return false;
+}
+
+void LuaFunctionsLoader::internUserdata(lua_State* L, const void* object) {
+	if (internedUserdataRef == LUA_NOREF) {
+		return;
+	}
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, internedUserdataRef);
+	lua_pushlightuserdata(L, const_cast<void*>(object));
+	lua_pushvalue(L, -3);
+	lua_rawset(L, -3);
+	lua_pop(L, 1);
+}
+
+void LuaFunctionsLoader::pushMetatable(lua_State* L, const std::string &name) {
+	if (const auto it = metatableRefs.find(name); it != metatableRefs.end()) {
+		lua_rawgeti(L, LUA_REGISTRYINDEX, it->second);
+		return;
+	}
+
 	luaL_getmetatable(L, name.c_str());
+	// Only cache registered classes, so a lookup before registration isn't remembered as nil
+	if (lua_istable(L, -1)) {
+		lua_pushvalue(L, -1);
+		metatableRefs.emplace(name, luaL_ref(L, LUA_REGISTRYINDEX));
+	}
+}
+
+void LuaFunctionsLoader::setMetatable(lua_State* L, int32_t index, const std::string &name) {
+	pushMetatable(L, name);
 	lua_setmetatable(L, index - 1);
 }
 
@@ -246,23 +309,29 @@ void LuaFunctionsLoader::setWeakMetatable(lua_State* L, int32_t index, const std
 }
 
 void LuaFunctionsLoader::setItemMetatable(lua_State* L, int32_t index, std::shared_ptr<Item> item) {
+	static const std::string containerName = "Container";
+	static const std::string teleportName = "Teleport";
+	static const std::string itemName = "Item";
 	if (item && item->getContainer()) {
-		luaL_getmetatable(L, "Container");
+		pushMetatable(L, containerName);
 	} else if (item && item->getTeleport()) {
-		luaL_getmetatable(L, "Teleport");
+		pushMetatable(L, teleportName);
 	} else {
-		luaL_getmetatable(L, "Item");
+		pushMetatable(L, itemName);
 	}
 	lua_setmetatable(L, index - 1);
 }
 
 void LuaFunctionsLoader::setCreatureMetatable(lua_State* L, int32_t index, std::shared_ptr<Creature> creature) {
+	static const std::string playerName = "Player";
+	static const std::string monsterName = "Monster";
+	static const std::string npcName = "Npc";
 	if (creature && creature->getPlayer()) {
-		luaL_getmetatable(L, "Player");
+		pushMetatable(L, playerName);
 	} else if (creature && creature->getMonster()) {
-		luaL_getmetatable(L, "Monster");
+		pushMetatable(L, monsterName);
 	} else {
-		luaL_getmetatable(L, "Npc");
+		pushMetatable(L, npcName);
 	}
 	lua_setmetatable(L, index - 1);
 }
@@ -323,7 +392,24 @@ std::string LuaFunctionsLoader::getString(lua_State* L, int32_t arg) {
 	return std::string(c_str, len);
 }
 
+LuaPosition* LuaFunctionsLoader::getPositionUserdata(lua_State* L, int32_t arg) {
+	auto value = static_cast<LuaPosition*>(lua_touserdata(L, arg));
+	if (!value || positionMetatableRef == LUA_NOREF || lua_getmetatable(L, arg) == 0) {
+		return nullptr;
+	}
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, positionMetatableRef);
+	const bool isPosition = lua_rawequal(L, -1, -2) != 0;
+	lua_pop(L, 2);
+	return isPosition ? value : nullptr;
+}
+
 Position LuaFunctionsLoader::getPosition(lua_State* L, int32_t arg, int32_t &stackpos) {
+	if (const auto value = getPositionUserdata(L, arg)) {
+		stackpos = value->stackpos;
+		return value->position;
+	}
+
 	Position position;
 	position.x = getField<uint16_t>(L, arg, "x");
 	position.y = getField<uint16_t>(L, arg, "y");
@@ -341,6 +427,10 @@ Position LuaFunctionsLoader::getPosition(lua_State* L, int32_t arg, int32_t &sta
 }
 
 Position LuaFunctionsLoader::getPosition(lua_State* L, int32_t arg) {
+	if (const auto value = getPositionUserdata(L, arg)) {
+		return value->position;
+	}
+
 	Position position;
 	position.x = getField<uint16_t>(L, arg, "x");
 	position.y = getField<uint16_t>(L, arg, "y");
@@ -519,6 +609,14 @@ void LuaFunctionsLoader::pushInstantSpell(lua_State* L, const InstantSpell &spel
 }
 
 void LuaFunctionsLoader::pushPosition(lua_State* L, const Position &position, int32_t stackpos /* = 0*/) {
+	if (positionMetatableRef != LUA_NOREF && g_configManager().getBoolean(LUA_POSITION_USERDATA)) {
+		auto value = static_cast<LuaPosition*>(lua_newuserdata(L, sizeof(LuaPosition)));
+		new (value) LuaPosition { position, stackpos };
+		lua_rawgeti(L, LUA_REGISTRYINDEX, positionMetatableRef);
+		lua_setmetatable(L, -2);
+		return;
+	}
+
 	lua_createtable(L, 0, 4);
 
 	setField(L, "x", position.x);
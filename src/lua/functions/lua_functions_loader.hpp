@@ -20,14 +20,48 @@ class Cylinder;
 class Game;
 class InstantSpell;
 class Item;
+class Container;
 class Player;
+class Monster;
+class Npc;
 class Thing;
+class Tile;
 class Guild;
 class Zone;
 class KVStore;
 
+/**
+ * Game objects scripts push over and over (every think, every event) keep a
+ * single userdata while Lua holds one, so pushing them again allocates nothing.
+ */
+template <typename T>
+struct LuaInternedUserdata : std::false_type { };
+template <>
+struct LuaInternedUserdata<Creature> : std::true_type { };
+template <>
+struct LuaInternedUserdata<Player> : std::true_type { };
+template <>
+struct LuaInternedUserdata<Monster> : std::true_type { };
+template <>
+struct LuaInternedUserdata<Npc> : std::true_type { };
+template <>
+struct LuaInternedUserdata<Item> : std::true_type { };
+template <>
+struct LuaInternedUserdata<Container> : std::true_type { };
+template <>
+struct LuaInternedUserdata<Tile> : std::true_type { };
+
 #define reportErrorFunc(a) reportError(__FUNCTION__, a, true)
 
+/**
+ * What pushPosition pushes instead of a table when luaPositionUserdata is
+ * enabled. Fields and Position methods read the same on both.
+ */
+struct LuaPosition {
+	Position position;
+	int32_t stackpos = 0;
+};
+
 class LuaFunctionsLoader {
 public:
 	static void load(lua_State* L);
@@ -104,6 +138,12 @@ public:
 	static CombatDamage getCombatDamage(lua_State* L);
 	static Position getPosition(lua_State* L, int32_t arg, int32_t &stackpos);
 	static Position getPosition(lua_State* L, int32_t arg);
+	// Null unless the value is a position userdata
+	static LuaPosition* getPositionUserdata(lua_State* L, int32_t arg);
+	// A position table or userdata
+	static bool isPosition(lua_State* L, int32_t arg) {
+		return isTable(L, arg) || getPositionUserdata(L, arg);
+	}
 	static Outfit_t getOutfit(lua_State* L, int32_t arg);
 	static LuaVariant getVariant(lua_State* L, int32_t arg);
 
@@ -195,10 +235,27 @@ public:
 
 	template <class T>
 	static void pushUserdata(lua_State* L, std::shared_ptr<T> value) {
+		if constexpr (LuaInternedUserdata<T>::value) {
+			if (value && pushInternedUserdata(L, value.get())) {
+				// Methods like item:transform() swap the object a userdata points to
+				const auto stored = static_cast<std::shared_ptr<T>*>(lua_touserdata(L, -1));
+				if (stored->get() == value.get()) {
+					return;
+				}
+				lua_pop(L, 1);
+			}
+		}
+
 		// This is basically malloc from C++ point of view.
 		auto userData = static_cast<std::shared_ptr<T>*>(lua_newuserdata(L, sizeof(std::shared_ptr<T>)));
 		// Copy constructor, bumps ref count.
 		new (userData) std::shared_ptr<T>(value);
+
+		if constexpr (LuaInternedUserdata<T>::value) {
+			if (value) {
+				internUserdata(L, value.get());
+			}
+		}
 	}
 
 protected:
@@ -217,6 +274,12 @@ protected:
 	static int luaUserdataCompare(lua_State* L);
 	static int luaGarbageCollection(lua_State* L);
 
+	// Pushes the userdata Lua still holds for the object and returns true, or pushes nothing
+	static bool pushInternedUserdata(lua_State* L, const void* object);
+	// Remembers the userdata on top of the stack as the one of the object
+	static void internUserdata(lua_State* L, const void* object);
+	static void pushMetatable(lua_State* L, const std::string &name);
+
 	static ScriptEnvironment scriptEnv[16];
 	static int32_t scriptEnvIndex;
 };
@@ -235,6 +235,7 @@ int HouseFunctions::luaHouseGetBeds(lua_State* L) {
 		return 1;
 	}
 
+	house->loadPendingItems();
 	const auto beds = house->getBeds();
 	lua_createtable(L, beds.size(), 0);
 
@@ -312,6 +313,7 @@ int HouseFunctions::luaHouseGetTiles(lua_State* L) {
 		return 1;
 	}
 
+	house->loadPendingItems();
 	const auto tiles = house->getTiles();
 	lua_newtable(L);
 
@@ -332,6 +334,7 @@ int HouseFunctions::luaHouseGetItems(lua_State* L) {
 		return 1;
 	}
 
+	house->loadPendingItems();
 	const auto tiles = house->getTiles();
 	lua_newtable(L);
 
@@ -352,6 +355,7 @@ int HouseFunctions::luaHouseGetItems(lua_State* L) {
 int HouseFunctions::luaHouseGetTileCount(lua_State* L) {
 	// house:getTileCount()
 	if (const auto &house = getUserdataShared<House>(L, 1)) {
+		house->loadPendingItems();
 		lua_pushnumber(L, house->getTiles().size());
 	} else {
 		lua_pushnil(L);
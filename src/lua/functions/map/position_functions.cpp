@@ -13,6 +13,76 @@
 #include "game/movement/position.hpp"
 #include "lua/functions/map/position_functions.hpp"
 
+void PositionFunctions::registerPositionValue(lua_State* L) {
+	luaL_newmetatable(L, "PositionValue");
+	const int metatable = lua_gettop(L);
+
+	lua_getglobal(L, "Position");
+	lua_pushcclosure(L, PositionFunctions::luaPositionValueIndex, 1);
+	lua_setfield(L, metatable, "__index");
+
+	static constexpr std::array<std::pair<const char*, lua_CFunction>, 5> metamethods = { {
+		{ "__newindex", PositionFunctions::luaPositionValueNewIndex },
+		{ "__add", PositionFunctions::luaPositionAdd },
+		{ "__sub", PositionFunctions::luaPositionSub },
+		{ "__eq", PositionFunctions::luaPositionCompare },
+		{ "__tostring", PositionFunctions::luaPositionToString },
+	} };
+	for (const auto &[name, function] : metamethods) {
+		lua_pushcfunction(L, function);
+		lua_setfield(L, metatable, name);
+	}
+
+	lua_pop(L, 1);
+}
+
+int PositionFunctions::luaPositionValueIndex(lua_State* L) {
+	// position.x, position.y, position.z, position.stackpos or position:method()
+	const auto value = getPositionUserdata(L, 1);
+	if (value && lua_type(L, 2) == LUA_TSTRING) {
+		const std::string_view key = lua_tostring(L, 2);
+		if (key == "x") {
+			lua_pushnumber(L, value->position.x);
+			return 1;
+		} else if (key == "y") {
+			lua_pushnumber(L, value->position.y);
+			return 1;
+		} else if (key == "z") {
+			lua_pushnumber(L, value->position.z);
+			return 1;
+		} else if (key == "stackpos") {
+			lua_pushnumber(L, value->stackpos);
+			return 1;
+		}
+	}
+
+	lua_pushvalue(L, 2);
+	lua_gettable(L, lua_upvalueindex(1));
+	return 1;
+}
+
+int PositionFunctions::luaPositionValueNewIndex(lua_State* L) {
+	// position.x = value
+	const auto value = getPositionUserdata(L, 1);
+	const std::string_view key = lua_type(L, 2) == LUA_TSTRING ? lua_tostring(L, 2) : "";
+	if (!value) {
+		return 0;
+	}
+
+	if (key == "x") {
+		value->position.x = getNumber<uint16_t>(L, 3);
+	} else if (key == "y") {
+		value->position.y = getNumber<uint16_t>(L, 3);
+	} else if (key == "z") {
+		value->position.z = getNumber<uint8_t>(L, 3);
+	} else if (key == "stackpos") {
+		value->stackpos = getNumber<int32_t>(L, 3);
+	} else {
+		return luaL_error(L, "positions only have the fields x, y, z and stackpos");
+	}
+	return 0;
+}
+
 int PositionFunctions::luaPositionCreate(lua_State* L) {
 	// Position([x = 0[, y = 0[, z = 0[, stackpos = 0]]]])
 	// Position([position])
@@ -22,7 +92,7 @@ int PositionFunctions::luaPositionCreate(lua_State* L) {
 	}
 
 	int32_t stackpos;
-	if (isTable(L, 2)) {
+	if (isPosition(L, 2)) {
 		const Position &position = getPosition(L, 2, stackpos);
 		pushPosition(L, position, stackpos);
 	} else {
@@ -34,9 +34,16 @@ public:
 		registerMethod(L, "Position", "sendDoubleSoundEffect", PositionFunctions::luaPositionSendDoubleSoundEffect);
 
 		registerMethod(L, "Position", "toString", PositionFunctions::luaPositionToString);
+
+		registerPositionValue(L);
 	}
 
 private:
+	// Metatable of the LuaPosition userdata, its methods are the ones of Position
+	static void registerPositionValue(lua_State* L);
+	static int luaPositionValueIndex(lua_State* L);
+	static int luaPositionValueNewIndex(lua_State* L);
+
 	static int luaPositionCreate(lua_State* L);
 	static int luaPositionAdd(lua_State* L);
 	static int luaPositionSub(lua_State* L);
@@ -16,7 +16,7 @@ int TileFunctions::luaTileCreate(lua_State* L) {
 	// Tile(x, y, z)
 	// Tile(position)
 	std::shared_ptr<Tile> tile;
-	if (isTable(L, 2)) {
+	if (isPosition(L, 2)) {
 		tile = g_game().map.getTile(getPosition(L, 2));
 	} else {
 		uint8_t z = getNumber<uint8_t>(L, 4);
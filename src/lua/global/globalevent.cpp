@@ -25,11 +25,24 @@ void GlobalEvents::clear() {
 	timerEventId = 0;
 
 	// Clear maps
+	thinkQueue.clear();
 	thinkMap.clear();
 	serverMap.clear();
 	timerMap.clear();
 }
 
+void GlobalEvents::clearFileEvents(const std::string &file) {
+	// The think and timer tasks stay scheduled, they simply find less to run
+	const auto fromFile = [&file](const auto &entry) { return entry.second->getScriptFile() == file; };
+	std::erase_if(thinkMap, fromFile);
+	std::erase_if(serverMap, fromFile);
+	std::erase_if(timerMap, fromFile);
+
+	if (std::erase_if(thinkQueue, [&file](const auto &entry) { return entry.globalEvent->getScriptFile() == file; }) != 0) {
+		std::ranges::make_heap(thinkQueue, std::ranges::greater {}, &ThinkEntry::nextExecution);
+	}
+}
+
 bool GlobalEvents::registerLuaEvent(const std::shared_ptr<GlobalEvent> globalEvent) {
 	if (globalEvent->getEventType() == GLOBALEVENT_TIMER) {
 		auto result = timerMap.emplace(globalEvent->getName(), globalEvent);
@@ -47,11 +60,7 @@ bool GlobalEvents::registerLuaEvent(const std::shared_ptr<GlobalEvent> globalEve
 	} else { // think event
 		auto result = thinkMap.emplace(globalEvent->getName(), globalEvent);
 		if (result.second) {
-			if (thinkEventId == 0) {
-				thinkEventId = g_scheduler().addEvent(
-					SCHEDULER_MINTICKS, [this] { think(); }, "GlobalEvents::think"
-				);
-			}
+			pushThinkEvent(globalEvent);
 			return true;
 		}
 	}
@@ -103,21 +112,45 @@ void GlobalEvents::timer() {
 	}
 }
 
-void GlobalEvents::think() {
-	int64_t now = OTSYS_TIME();
+void GlobalEvents::pushThinkEvent(const std::shared_ptr<GlobalEvent> &globalEvent) {
+	thinkQueue.emplace_back(ThinkEntry { globalEvent->getNextExecution(), globalEvent });
+	std::ranges::push_heap(thinkQueue, std::ranges::greater {}, &ThinkEntry::nextExecution);
 
-	int64_t nextScheduledTime = std::numeric_limits<int64_t>::max();
-	for (auto &it : thinkMap) {
-		const auto globalEvent = it.second;
+	if (thinkEventId == 0 || globalEvent->getNextExecution() < thinkEventTime) {
+		scheduleThink();
+	}
+}
 
-		int64_t nextExecutionTime = globalEvent->getNextExecution() - now;
-		if (nextExecutionTime > 0) {
-			if (nextExecutionTime < nextScheduledTime) {
-				nextScheduledTime = nextExecutionTime;
-			}
-			continue;
+void GlobalEvents::scheduleThink() {
+	g_scheduler().stopEvent(thinkEventId);
+	thinkEventId = 0;
+	if (thinkQueue.empty()) {
+		return;
+	}
+
+	thinkEventTime = thinkQueue.front().nextExecution;
+	const auto delay = std::max<int64_t>(SCHEDULER_MINTICKS, thinkEventTime - OTSYS_TIME());
+	thinkEventId = g_scheduler().addEvent(static_cast<uint32_t>(delay), [this] { think(); }, "GlobalEvents::think");
+}
+
+void GlobalEvents::think() {
+	thinkEventId = 0;
+	const int64_t now = OTSYS_TIME();
+
+	// Every due event runs once per wakeup, even when it fell more than an interval behind
+	std::vector<std::shared_ptr<GlobalEvent>> dueEvents;
+	while (!thinkQueue.empty() && thinkQueue.front().nextExecution <= now) {
+		std::ranges::pop_heap(thinkQueue, std::ranges::greater {}, &ThinkEntry::nextExecution);
+		auto globalEvent = std::move(thinkQueue.back().globalEvent);
+		thinkQueue.pop_back();
+
+		const auto it = thinkMap.find(globalEvent->getName());
+		if (it != thinkMap.end() && it->second == globalEvent) {
+			dueEvents.emplace_back(std::move(globalEvent));
 		}
+	}
 
+	for (const auto &globalEvent : dueEvents) {
 		g_logger().trace("[GlobalEvents::think] - Executing event: {}", globalEvent->getName());
 
 		if (!globalEvent->executeEvent()) {
@@ -126,18 +159,16 @@ void GlobalEvents::think() {
 							 globalEvent->getName());
 		}
 
-		nextExecutionTime = globalEvent->getInterval();
-		if (nextExecutionTime < nextScheduledTime) {
-			nextScheduledTime = nextExecutionTime;
+		globalEvent->setNextExecution(globalEvent->getNextExecution() + globalEvent->getInterval());
+		// Unless the event unregistered itself meanwhile
+		const auto it = thinkMap.find(globalEvent->getName());
+		if (it != thinkMap.end() && it->second == globalEvent) {
+			thinkQueue.emplace_back(ThinkEntry { globalEvent->getNextExecution(), globalEvent });
+			std::ranges::push_heap(thinkQueue, std::ranges::greater {}, &ThinkEntry::nextExecution);
 		}
-
-		globalEvent->setNextExecution(globalEvent->getNextExecution() + nextExecutionTime);
 	}
 
-	if (nextScheduledTime != std::numeric_limits<int64_t>::max()) {
-		auto delay = static_cast<uint32_t>(nextScheduledTime);
-		thinkEventId = g_scheduler().addEvent(delay, std::bind(&GlobalEvents::think, this), "GlobalEvents::think");
-	}
+	scheduleThink();
 }
 
 void GlobalEvents::execute(GlobalEvent_t type) const {
@@ -38,9 +38,23 @@ public:
 
 	bool registerLuaEvent(const std::shared_ptr<GlobalEvent> globalEvent);
 	void clear();
+	// Unregisters the events the given script file registered, for hot reload
+	void clearFileEvents(const std::string &file);
 
 private:
+	struct ThinkEntry {
+		int64_t nextExecution;
+		std::shared_ptr<GlobalEvent> globalEvent;
+	};
+
+	// Pushes the next execution of a think event and wakes think earlier when it comes first
+	void pushThinkEvent(const std::shared_ptr<GlobalEvent> &globalEvent);
+	void scheduleThink();
+
 	GlobalEventMap thinkMap, serverMap, timerMap;
+	// Min-heap of the think events by next execution, entries of unregistered events are dropped when popped
+	std::vector<ThinkEntry> thinkQueue;
+	int64_t thinkEventTime = 0;
 	uint64_t thinkEventId = 0, timerEventId = 0;
 };
 
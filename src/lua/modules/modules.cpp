@@ -20,8 +20,10 @@ Modules::Modules() :
 
 void Modules::clear(bool) {
 	// clear recvbyte list
-	for (auto &it : recvbyteList) {
-		it.second.clearEvent();
+	for (const auto &module : recvbyteModules) {
+		if (module) {
+			module->clearEvent();
+		}
 	}
 
 	// clear lua state
@@ -50,29 +52,24 @@ bool Modules::registerEvent(Event_ptr event, const pugi::xml_node &) {
 		return false;
 	}
 
-	Module* oldModule = getEventByRecvbyte(module->getRecvbyte(), false);
+	const uint8_t recvbyte = module->getRecvbyte();
+	auto &oldModule = recvbyteModules[recvbyte];
 	if (oldModule) {
 		if (!oldModule->isLoaded() && oldModule->getEventType() == module->getEventType()) {
 			oldModule->copyEvent(module.get());
 		}
 		return false;
-	} else {
-		auto it = recvbyteList.find(module->getRecvbyte());
-		if (it != recvbyteList.end()) {
-			it->second = *module;
-		} else {
-			recvbyteList.emplace(module->getRecvbyte(), std::move(*module));
-		}
-		return true;
 	}
+
+	oldModule = std::move(module);
+	registeredRecvbytes[recvbyte].store(true, std::memory_order_relaxed);
+	return true;
 }
 
 Module* Modules::getEventByRecvbyte(uint8_t recvbyte, bool force) {
-	ModulesList::iterator it = recvbyteList.find(recvbyte);
-	if (it != recvbyteList.end()) {
-		if (!force || it->second.isLoaded()) {
-			return &it->second;
-		}
+	const auto &module = recvbyteModules[recvbyte];
+	if (module && (!force || module->isLoaded())) {
+		return module.get();
 	}
 	return nullptr;
 }
@@ -83,14 +80,14 @@ void Modules::executeOnRecvbyte(uint32_t playerId, NetworkMessage &msg, uint8_t
 		return;
 	}
 
-	for (auto &it : recvbyteList) {
-		Module module = it.second;
-		if (module.getEventType() == MODULE_TYPE_RECVBYTE && module.getRecvbyte() == byte && player->canRunModule(module.getRecvbyte())) {
-			player->setModuleDelay(module.getRecvbyte(), module.getDelay());
-			module.executeOnRecvbyte(player, msg);
-			return;
-		}
+	const auto &module = recvbyteModules[byte];
+	// A module whose script a reload dropped is not loaded until it is registered again
+	if (!module || !module->isLoaded() || module->getEventType() != MODULE_TYPE_RECVBYTE || !player->canRunModule(byte)) {
+		return;
 	}
+
+	player->setModuleDelay(byte, module->getDelay());
+	module->executeOnRecvbyte(player, msg);
 }
 
 Module::Module(LuaScriptInterface* interface) :
@@ -69,6 +69,10 @@ public:
 
 	void executeOnRecvbyte(uint32_t playerId, NetworkMessage &msg, uint8_t byte) const;
 	Module* getEventByRecvbyte(uint8_t recvbyte, bool force);
+	// Read by the network threads, so packets no module handles are not copied to the dispatcher
+	bool hasRecvbyteModule(uint8_t recvbyte) const {
+		return registeredRecvbytes[recvbyte].load(std::memory_order_relaxed);
+	}
 
 protected:
 	LuaScriptInterface &getScriptInterface() override;
@@ -77,8 +81,9 @@ protected:
 	bool registerEvent(Event_ptr event, const pugi::xml_node &node) override;
 	void clear(bool) override final;
 
-	typedef std::map<uint8_t, Module> ModulesList;
-	ModulesList recvbyteList;
+	// Indexed by the recvbyte, a module stays in its slot once registered, reloads only clear and refill its script
+	std::array<Module_ptr, std::numeric_limits<uint8_t>::max() + 1> recvbyteModules;
+	std::array<std::atomic<bool>, std::numeric_limits<uint8_t>::max() + 1> registeredRecvbytes {};
 
 	LuaScriptInterface scriptInterface;
 };
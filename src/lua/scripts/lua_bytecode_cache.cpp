@@ -0,0 +1,179 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lua/scripts/lua_bytecode_cache.hpp"
+
+#include "config/configmanager.hpp"
+#include "lib/thread/thread_pool.hpp"
+#include "utils/hash.hpp"
+
+#ifdef LUAJIT_VERSION
+namespace {
+	struct CacheHeader {
+		std::array<char, 8> magic;
+		// LuaJIT version and pointer size, the bytecode format depends on both
+		uint64_t build;
+		int64_t mtime;
+		uint64_t sourceHash;
+	};
+
+	constexpr std::array<char, 8> CACHE_MAGIC = { 'C', 'N', 'R', 'Y', 'L', 'B', 'C', '1' };
+
+	const uint64_t buildHash = stdext::hash_bytes(std::to_string(sizeof(void*)), stdext::hash_bytes(LUAJIT_VERSION));
+
+	bool readFile(const std::filesystem::path &path, std::string &content) {
+		std::ifstream stream(path, std::ios::binary);
+		if (!stream) {
+			return false;
+		}
+		content.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+		return !stream.bad();
+	}
+
+	int writeBytecode(lua_State*, const void* data, size_t size, void* output) {
+		static_cast<std::string*>(output)->append(static_cast<const char*>(data), size);
+		return 0;
+	}
+
+	// The chunk name is the one luaL_loadfile gives, so errors and tracebacks do not change
+	std::string compileSource(const std::filesystem::path &file, const std::string &source) {
+		const auto L = luaL_newstate();
+		if (!L) {
+			return {};
+		}
+
+		std::string bytecode;
+		const auto chunkName = "@" + file.string();
+		if (luaL_loadbuffer(L, source.data(), source.size(), chunkName.c_str()) != 0 || lua_dump(L, writeBytecode, &bytecode) != 0) {
+			bytecode.clear();
+		}
+		lua_close(L);
+		return bytecode;
+	}
+
+	void storeCacheFile(const std::filesystem::path &cacheFile, const CacheHeader &header, const std::string &bytecode) {
+		std::error_code error;
+		std::filesystem::create_directories(cacheFile.parent_path(), error);
+
+		// Written aside and renamed, a crash never leaves a truncated entry behind
+		auto temporaryFile = cacheFile;
+		temporaryFile += ".tmp";
+		{
+			std::ofstream stream(temporaryFile, std::ios::binary | std::ios::trunc);
+			if (!stream) {
+				return;
+			}
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			stream.write(bytecode.data(), static_cast<std::streamsize>(bytecode.size()));
+			if (!stream) {
+				return;
+			}
+		}
+		std::filesystem::rename(temporaryFile, cacheFile, error);
+	}
+}
+#endif
+
+std::vector<std::string> LuaBytecodeCache::compile(const std::vector<std::filesystem::path> &files) {
+	std::vector<std::string> bytecodes(files.size());
+#ifdef LUAJIT_VERSION
+	if (files.empty()) {
+		return bytecodes;
+	}
+
+	// The caller compiles too and only waits for files a worker already took,
+	// so this finishes even when every compute thread is busy
+	struct Batch {
+		Batch(const std::vector<std::filesystem::path> &files, std::vector<std::string> &bytecodes, bool useCache) :
+			files(files), bytecodes(bytecodes), count(files.size()), useCache(useCache) { }
+
+		// Only touched while an index is left, workers may run after compile returned
+		const std::vector<std::filesystem::path> &files;
+		std::vector<std::string> &bytecodes;
+		const size_t count;
+		const bool useCache;
+		std::atomic<size_t> next = 0;
+		std::atomic<size_t> done = 0;
+		std::mutex mutex;
+		std::condition_variable finished;
+
+		void run() {
+			for (size_t index = next++; index < count; index = next++) {
+				bytecodes[index] = compileFile(files[index], useCache);
+				if (++done == count) {
+					std::scoped_lock lock(mutex);
+					finished.notify_all();
+				}
+			}
+		}
+	};
+
+	const auto batch = std::make_shared<Batch>(files, bytecodes, g_configManager().getBoolean(LUA_BYTECODE_CACHE));
+	const auto workers = std::min(inject<ThreadPool>().getThreadCount(), files.size() - 1);
+	for (size_t i = 0; i < workers; ++i) {
+		inject<ThreadPool>().addLoad([batch] {
+			batch->run();
+		});
+	}
+
+	batch->run();
+	std::unique_lock lock(batch->mutex);
+	batch->finished.wait(lock, [&batch] { return batch->done == batch->count; });
+#endif
+	return bytecodes;
+}
+
+std::string LuaBytecodeCache::compileFile(const std::filesystem::path &file, bool useCache) {
+#ifdef LUAJIT_VERSION
+	std::error_code error;
+	const auto mtime = static_cast<int64_t>(std::filesystem::last_write_time(file, error).time_since_epoch().count());
+	if (error) {
+		return {};
+	}
+
+	const auto absolutePath = std::filesystem::absolute(file, error).generic_string();
+	const auto cacheFile = std::filesystem::current_path() / CACHE_DIRECTORY / fmt::format("{:016x}.bc", stdext::hash_bytes(absolutePath));
+
+	CacheHeader cached {};
+	std::string cacheContent;
+	bool hasCacheEntry = false;
+	if (useCache && readFile(cacheFile, cacheContent) && cacheContent.size() > sizeof(CacheHeader)) {
+		std::memcpy(&cached, cacheContent.data(), sizeof(CacheHeader));
+		hasCacheEntry = cached.magic == CACHE_MAGIC && cached.build == buildHash;
+	}
+	if (hasCacheEntry && cached.mtime == mtime) {
+		return cacheContent.substr(sizeof(CacheHeader));
+	}
+
+	std::string source;
+	if (!readFile(file, source)) {
+		return {};
+	}
+
+	CacheHeader header { CACHE_MAGIC, buildHash, mtime, stdext::hash_bytes(source) };
+	std::string bytecode;
+	if (hasCacheEntry && cached.sourceHash == header.sourceHash) {
+		bytecode = cacheContent.substr(sizeof(CacheHeader));
+	} else {
+		bytecode = compileSource(file, source);
+		if (bytecode.empty()) {
+			return {};
+		}
+	}
+
+	if (useCache) {
+		storeCacheFile(cacheFile, header, bytecode);
+	}
+	return bytecode;
+#else
+	return {};
+#endif
+}
@@ -0,0 +1,36 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Compiles Lua files to bytecode away from the game's Lua state, so the
+ * datapack is parsed on every compute thread and the scripts only have to
+ * be loaded and run one after the other.
+ *
+ * With luaBytecodeCache the bytecode is also kept under cache/lua, one
+ * file per script. An entry is reused when the script's mtime is the one
+ * it was built from, or when its content hash is (e.g. after a checkout
+ * touched the file), so unchanged scripts are never parsed again.
+ * Only available with LuaJIT, otherwise every file comes back empty.
+ */
+class LuaBytecodeCache {
+public:
+	static constexpr std::string_view CACHE_DIRECTORY = "cache/lua";
+
+	/**
+	 * Bytecode of every file, in the same order. Empty where a file could
+	 * not be compiled, the caller then loads it from source and gets the
+	 * syntax error from there.
+	 */
+	static std::vector<std::string> compile(const std::vector<std::filesystem::path> &files);
+
+private:
+	static std::string compileFile(const std::filesystem::path &file, bool useCache);
+};
@@ -13,6 +13,7 @@
 #include "lua/scripts/lua_environment.hpp"
 #include "lua/functions/lua_functions_loader.hpp"
 #include "lua/scripts/script_environment.hpp"
+#include "game/scheduling/scheduler.hpp"
 
 bool LuaEnvironment::shuttingDown = false;
 
@@ -79,6 +80,7 @@ bool LuaEnvironment::closeState() {
 	combatIdMap.clear();
 	areaIdMap.clear();
 	timerEvents.clear();
+	timerBuckets.clear();
 	cacheFiles.clear();
 
 	lua_close(luaState);
@@ -148,6 +150,35 @@ void LuaEnvironment::clearAreaObjects(LuaScriptInterface* interface) {
 	it->second.clear();
 }
 
+void LuaEnvironment::scheduleTimerEvent(uint32_t eventIndex, uint32_t delay) {
+	const int64_t now = OTSYS_TIME();
+	const int64_t expiresAt = (now + delay + SCHEDULER_MINTICKS - 1) / SCHEDULER_MINTICKS * SCHEDULER_MINTICKS;
+
+	auto &bucket = timerBuckets[expiresAt];
+	if (bucket.empty()) {
+		g_scheduler().addEvent(
+			static_cast<uint32_t>(expiresAt - now),
+			std::bind(&LuaEnvironment::executeTimerEvents, this, expiresAt),
+			"LuaEnvironment::executeTimerEvents"
+		);
+	}
+	bucket.push_back(eventIndex);
+}
+
+void LuaEnvironment::executeTimerEvents(int64_t expiresAt) {
+	auto it = timerBuckets.find(expiresAt);
+	if (it == timerBuckets.end()) {
+		return;
+	}
+
+	const auto bucket = std::move(it->second);
+	timerBuckets.erase(it);
+
+	for (uint32_t eventIndex : bucket) {
+		executeTimerEvent(eventIndex);
+	}
+}
+
 void LuaEnvironment::executeTimerEvent(uint32_t eventIndex) {
 	auto it = timerEvents.find(eventIndex);
 	if (it == timerEvents.end()) {
@@ -85,9 +85,17 @@ public:
 	void collectGarbage() const;
 
 private:
+	/**
+	 * Timers are grouped by expiration, rounded up to SCHEDULER_MINTICKS,
+	 * and each group is a single scheduler event that runs them all in order.
+	 * Stopping a timer only drops it from timerEvents, its id is skipped when the group runs.
+	 */
+	void scheduleTimerEvent(uint32_t eventIndex, uint32_t delay);
+	void executeTimerEvents(int64_t expiresAt);
 	void executeTimerEvent(uint32_t eventIndex);
 
 	phmap::flat_hash_map<uint32_t, LuaTimerEventDesc> timerEvents;
+	phmap::flat_hash_map<int64_t, std::vector<uint32_t>> timerBuckets;
 	uint32_t lastEventTimerId = 1;
 
 	phmap::flat_hash_map<uint32_t, std::unique_ptr<AreaCombat>> areaMap;
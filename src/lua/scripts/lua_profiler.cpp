@@ -0,0 +1,111 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lua/scripts/lua_profiler.hpp"
+#include "lua/scripts/luascript.hpp"
+
+LuaProfiler &LuaProfiler::getInstance() {
+	return inject<LuaProfiler>();
+}
+
+LuaCallProfile &LuaProfiler::getCallProfile(const LuaScriptInterface &interface, const std::string &script) {
+	auto [it, inserted] = calls.try_emplace(script);
+	if (inserted) {
+		it->second.interfaceName = interface.getInterfaceName();
+	}
+	return it->second;
+}
+
+std::vector<std::pair<std::string_view, const LuaCallProfile*>> LuaProfiler::getSortedCalls(bool byMax) const {
+	std::vector<std::pair<std::string_view, const LuaCallProfile*>> sorted;
+	sorted.reserve(calls.size());
+	for (const auto &[script, profile] : calls) {
+		sorted.emplace_back(script, &profile);
+	}
+
+	std::ranges::sort(sorted, [byMax](const auto &lhs, const auto &rhs) {
+		if (byMax) {
+			return lhs.second->execution.max > rhs.second->execution.max;
+		}
+		return lhs.second->execution.total > rhs.second->execution.total;
+	});
+	return sorted;
+}
+
+std::vector<std::pair<std::string_view, uint64_t>> LuaProfiler::getSortedSamples() const {
+	std::vector<std::pair<std::string_view, uint64_t>> sorted(samples.begin(), samples.end());
+	std::ranges::sort(sorted, [](const auto &lhs, const auto &rhs) {
+		return lhs.second > rhs.second;
+	});
+	return sorted;
+}
+
+bool LuaProfiler::startSampling(lua_State* L, uint32_t intervalMs) {
+#ifdef LUAJIT_VERSION
+	stopSampling();
+	const auto mode = fmt::format("i{}", std::max<uint32_t>(1, intervalMs));
+	luaJIT_profile_start(L, mode.c_str(), &LuaProfiler::onSample, this);
+	samplingState = L;
+	return true;
+#else
+	g_logger().warn("[{}] Lua sampling needs LuaJIT", __FUNCTION__);
+	return false;
+#endif
+}
+
+void LuaProfiler::stopSampling() {
+#ifdef LUAJIT_VERSION
+	if (samplingState) {
+		luaJIT_profile_stop(samplingState);
+		samplingState = nullptr;
+	}
+#endif
+}
+
+void LuaProfiler::onSample(void* data, lua_State* L, int count, [[maybe_unused]] int vmstate) {
+#ifdef LUAJIT_VERSION
+	// "path:line" of the innermost Lua frame
+	size_t length = 0;
+	const char* location = luaJIT_profile_dumpstack(L, "pl", 1, &length);
+	auto &profiler = *static_cast<LuaProfiler*>(data);
+	profiler.samples[std::string(location, length)] += static_cast<uint64_t>(count);
+#endif
+}
+
+LuaCallTimer::LuaCallTimer() {
+	if (!g_configManager().getBoolean(TOGGLE_LUA_PROFILER)) {
+		return;
+	}
+
+	int32_t scriptId;
+	int32_t callbackId;
+	bool timerEvent;
+	LuaScriptInterface* scriptInterface;
+	LuaScriptInterface::getScriptEnv()->getEventInfo(scriptId, scriptInterface, callbackId, timerEvent);
+	if (!scriptInterface) {
+		return;
+	}
+
+	auto &profiler = g_luaProfiler();
+	profile = &profiler.getCallProfile(*scriptInterface, scriptInterface->getFileById(callbackId ? callbackId : scriptId));
+	generation = profiler.getGeneration();
+	startedAt = std::chrono::steady_clock::now();
+}
+
+LuaCallTimer::~LuaCallTimer() {
+	// A reset while the call ran dropped the profile
+	if (!profile || generation != g_luaProfiler().getGeneration()) {
+		return;
+	}
+
+	++profile->calls;
+	profile->execution.add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startedAt).count()));
+}
@@ -0,0 +1,97 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/scheduling/task_profiler.hpp"
+
+class LuaScriptInterface;
+
+struct LuaCallProfile {
+	std::string interfaceName;
+	uint64_t calls = 0;
+	TaskHistogram execution;
+};
+
+/**
+ * Lua accounting: time of every event called through
+ * LuaScriptInterface::callFunction, keyed by the script file and event
+ * ("file:callback@event", see LuaScriptInterface::getFileById).
+ *
+ * Sampling relies on the LuaJIT profiler and counts the line running at
+ * every interval, including code that timing per call can't attribute,
+ * like nested calls. Only the game thread runs Lua, so it takes no lock.
+ */
+class LuaProfiler {
+public:
+	// Ensures that we don't accidentally copy it
+	LuaProfiler() = default;
+	LuaProfiler(const LuaProfiler &) = delete;
+	LuaProfiler operator=(const LuaProfiler &) = delete;
+
+	static LuaProfiler &getInstance();
+
+	// Stable until the next reset, so a timer may hold it across the call
+	LuaCallProfile &getCallProfile(const LuaScriptInterface &interface, const std::string &script);
+
+	// Most expensive first, by total time or by the slowest call
+	std::vector<std::pair<std::string_view, const LuaCallProfile*>> getSortedCalls(bool byMax) const;
+	std::vector<std::pair<std::string_view, uint64_t>> getSortedSamples() const;
+
+	bool startSampling(lua_State* L, uint32_t intervalMs);
+	void stopSampling();
+	bool isSampling() const {
+		return samplingState != nullptr;
+	}
+
+	void reset() {
+		calls.clear();
+		samples.clear();
+		++generation;
+		startedAt = std::chrono::steady_clock::now();
+	}
+
+	uint32_t getGeneration() const {
+		return generation;
+	}
+
+	std::chrono::steady_clock::time_point getStartedAt() const {
+		return startedAt;
+	}
+
+private:
+	static void onSample(void* data, lua_State* L, int samples, int vmstate);
+
+	phmap::node_hash_map<std::string, LuaCallProfile> calls;
+	phmap::flat_hash_map<std::string, uint64_t> samples;
+	lua_State* samplingState = nullptr;
+	uint32_t generation = 0;
+	std::chrono::steady_clock::time_point startedAt = std::chrono::steady_clock::now();
+};
+
+constexpr auto g_luaProfiler = LuaProfiler::getInstance;
+
+/**
+ * Times the event the script environment is set up for, when the Lua
+ * profiler is enabled. Must be created before the call resets the environment.
+ */
+class LuaCallTimer {
+public:
+	LuaCallTimer();
+	~LuaCallTimer();
+
+	// Ensures that we don't accidentally copy it
+	LuaCallTimer(const LuaCallTimer &) = delete;
+	LuaCallTimer operator=(const LuaCallTimer &) = delete;
+
+private:
+	LuaCallProfile* profile = nullptr;
+	uint32_t generation = 0;
+	std::chrono::steady_clock::time_point startedAt;
+};
@@ -11,6 +11,97 @@
 
 #include "lua/scripts/luascript.hpp"
 #include "lua/scripts/lua_environment.hpp"
+#include "lua/scripts/lua_profiler.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "lib/profiling/profiler.hpp"
+
+namespace {
+	// Instructions between two calls of the count hook
+	constexpr int BUDGET_HOOK_INTERVAL = 1000;
+
+	/**
+	 * Instruction budget of the outermost event call and the watchdog context,
+	 * nested calls made from it share them. Game thread only, like the Lua state.
+	 */
+	class LuaCallGuard {
+	public:
+		explicit LuaCallGuard(lua_State* L) :
+			L(L) {
+			if (depth++ > 0) {
+				return;
+			}
+
+			if (auto &watchdog = g_dispatcher().getWatchdog(); watchdog.isRunning()) {
+				const auto file = getScriptFile();
+				watchdog.setLuaContext(file ? TaskWatchdog::internScriptName(*file) : std::string_view {});
+				watched = true;
+			}
+
+			const auto budget = g_configManager().getNumber(LUA_INSTRUCTION_BUDGET);
+			if (budget > 0) {
+				remaining = budget;
+				reported = false;
+				lua_sethook(L, onCount, LUA_MASKCOUNT, BUDGET_HOOK_INTERVAL);
+				hooked = true;
+			}
+		}
+
+		~LuaCallGuard() {
+			if (--depth > 0) {
+				return;
+			}
+
+			if (hooked) {
+				lua_sethook(L, nullptr, 0, 0);
+			}
+			if (watched) {
+				g_dispatcher().getWatchdog().setLuaContext({});
+			}
+		}
+
+		// Ensures that we don't accidentally copy it
+		LuaCallGuard(const LuaCallGuard &) = delete;
+		LuaCallGuard operator=(const LuaCallGuard &) = delete;
+
+	private:
+		static const std::string* getScriptFile() {
+			int32_t scriptId;
+			int32_t callbackId;
+			bool timerEvent;
+			LuaScriptInterface* scriptInterface;
+			LuaScriptInterface::getScriptEnv()->getEventInfo(scriptId, scriptInterface, callbackId, timerEvent);
+			return scriptInterface ? &scriptInterface->getFileById(callbackId ? callbackId : scriptId) : nullptr;
+		}
+
+		static void onCount(lua_State* state, lua_Debug*) {
+			remaining -= BUDGET_HOOK_INTERVAL;
+			if (remaining > 0) {
+				return;
+			}
+
+			const auto budget = g_configManager().getNumber(LUA_INSTRUCTION_BUDGET);
+			if (!reported) {
+				reported = true;
+				const auto file = getScriptFile();
+				auto interface = LuaScriptInterface::getScriptEnv()->getScriptInterface();
+				const auto message = fmt::format("Lua instruction budget of {} exceeded by {}", budget, file ? *file : "unknown script");
+				g_logger().warn("{}", interface ? interface->getStackTrace(message) : message);
+			}
+
+			if (g_configManager().getBoolean(LUA_ABORT_OVER_BUDGET)) {
+				luaL_error(state, "instruction budget of %d exceeded", budget);
+			}
+		}
+
+		static inline uint32_t depth = 0;
+		static inline int64_t remaining = 0;
+		static inline bool reported = false;
+
+		lua_State* L;
+		bool hooked = false;
+		bool watched = false;
+	};
+}
 
 ScriptEnvironment::DBResultMap ScriptEnvironment::tempResults;
 uint32_t ScriptEnvironment::lastResultId = 0;
@@ -36,9 +127,18 @@ bool LuaScriptInterface::reInitState() {
 }
 
 /// Same as lua_pcall, but adds stack trace to error strings in called function.
-int32_t LuaScriptInterface::loadFile(const std::string &file, const std::string &scriptName) {
+int32_t LuaScriptInterface::loadFile(const std::string &file, const std::string &scriptName, const std::string &bytecode /* = {}*/) {
 	// loads file as a chunk at stack top
-	int ret = luaL_loadfile(luaState, file.c_str());
+	int ret = 1;
+	if (!bytecode.empty()) {
+		ret = luaL_loadbuffer(luaState, bytecode.data(), bytecode.size(), ("@" + file).c_str());
+		if (ret != 0) {
+			lua_pop(luaState, 1);
+		}
+	}
+	if (ret != 0) {
+		ret = luaL_loadfile(luaState, file.c_str());
+	}
 	if (ret != 0) {
 		lastLuaError = popString(luaState);
 		return -1;
@@ -227,8 +327,11 @@ bool LuaScriptInterface::closeState() {
 }
 
 bool LuaScriptInterface::callFunction(int params) {
+	CANARY_PROFILE_ZONE("LuaScriptInterface::callFunction");
 	bool result = false;
 	int size = lua_gettop(luaState);
+	LuaCallTimer timer;
+	LuaCallGuard guard(luaState);
 	if (protectedCall(luaState, params, 1) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::getString(luaState, -1));
 	} else {
@@ -246,6 +349,8 @@ bool LuaScriptInterface::callFunction(int params) {
 
 void LuaScriptInterface::callVoidFunction(int params) {
 	int size = lua_gettop(luaState);
+	LuaCallTimer timer;
+	LuaCallGuard guard(luaState);
 	if (protectedCall(luaState, params, 0) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(luaState));
 	}
@@ -25,7 +25,8 @@ public:
 	virtual bool initState();
 	bool reInitState();
 
-	int32_t loadFile(const std::string &file, const std::string &scriptName);
+	// Runs the precompiled bytecode of the file when given, see LuaBytecodeCache; falls back to the source if it does not load
+	int32_t loadFile(const std::string &file, const std::string &scriptName, const std::string &bytecode = {});
 
 	const std::string &getFileById(int32_t scriptId);
 	int32_t getEvent(const std::string &eventName);
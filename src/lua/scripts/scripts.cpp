@@ -16,6 +16,7 @@
 #include "lua/scripts/scripts.hpp"
 #include "creatures/combat/spells.hpp"
 #include "lua/callbacks/events_callbacks.hpp"
+#include "lua/scripts/lua_bytecode_cache.hpp"
 
 Scripts::Scripts() :
 	scriptInterface("Scripts Interface") {
@@ -59,6 +60,30 @@ bool Scripts::loadEventSchedulerScripts(const std::string &fileName) {
 	return false;
 }
 
+namespace {
+	// One line per load, the breakdown per directory is only logged at debug level
+	void logLoadReport(const std::string &loadPath, size_t compiledCount, std::chrono::steady_clock::duration compileTime, const std::map<std::string, std::pair<size_t, std::chrono::steady_clock::duration>> &directoryTimes) {
+		const auto toMs = [](std::chrono::steady_clock::duration duration) {
+			return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+		};
+
+		std::vector<std::pair<std::string_view, std::pair<size_t, std::chrono::steady_clock::duration>>> sorted(directoryTimes.begin(), directoryTimes.end());
+		std::ranges::sort(sorted, [](const auto &lhs, const auto &rhs) {
+			return lhs.second.second > rhs.second.second;
+		});
+
+		std::chrono::steady_clock::duration runTime {};
+		for (const auto &[directory, times] : sorted) {
+			runTime += times.second;
+		}
+
+		g_logger().info("Loaded {} scripts from {} in {} ms, {} ms compiling and {} ms running", compiledCount, loadPath, toMs(compileTime + runTime), toMs(compileTime), toMs(runTime));
+		for (const auto &[directory, times] : sorted) {
+			g_logger().debug("[Scripts::loadScripts] - {}/{}: {} scripts run in {} ms", loadPath, directory, times.first, toMs(times.second));
+		}
+	}
+}
+
 bool Scripts::loadScripts(std::string loadPath, bool isLib, bool reload) {
 	const auto dir = std::filesystem::current_path() / loadPath;
 	// Checks if the folder exists and is really a folder
@@ -67,12 +92,35 @@ bool Scripts::loadScripts(std::string loadPath, bool isLib, bool reload) {
 		return false;
 	}
 
+	// Scripts are compiled in parallel up front, then run one by one in directory order
+	std::vector<std::filesystem::path> entries;
+	for (const auto &entry : std::filesystem::recursive_directory_iterator(dir)) {
+		if (std::filesystem::is_regular_file(entry) && entry.path().extension() == ".lua") {
+			entries.emplace_back(entry.path());
+		}
+	}
+
+	std::vector<std::filesystem::path> compiledFiles;
+	std::vector<size_t> compiledIndex(entries.size());
+	for (size_t i = 0; i < entries.size(); ++i) {
+		const auto fileFolder = entries[i].parent_path().filename().string();
+		if (entries[i].filename().string().front() != '#' && (isLib || (fileFolder != "lib" && fileFolder != "events"))) {
+			compiledIndex[i] = compiledFiles.size();
+			compiledFiles.emplace_back(entries[i]);
+		}
+	}
+	const auto compileStart = std::chrono::steady_clock::now();
+	const auto bytecodes = LuaBytecodeCache::compile(compiledFiles);
+	const auto compileTime = std::chrono::steady_clock::now() - compileStart;
+
+	// Scripts run and time spent running them per directory right under loadPath, for the load report
+	std::map<std::string, std::pair<size_t, std::chrono::steady_clock::duration>> directoryTimes;
+
 	// Declare a string variable to store the last directory
 	std::string lastDirectory;
-	// Recursive iterate through all entries in the directory
-	for (const auto &entry : std::filesystem::recursive_directory_iterator(dir)) {
+	for (size_t i = 0; i < entries.size(); ++i) {
 		// Get the filename of the entry as a string
-		const auto realPath = entry.path();
+		const auto &realPath = entries[i];
 		std::string fileFolder = realPath.parent_path().filename().string();
 		// Script folder, example: "actions"
 		std::string scriptFolder = realPath.parent_path().string();
@@ -81,11 +129,6 @@ bool Scripts::loadScripts(std::string loadPath, bool isLib, bool reload) {
 		std::string_view scriptFolderView(scriptFolder);
 		// Filename, example: "demon.lua"
 		std::string file(realPath.filename().string());
-		if (!std::filesystem::is_regular_file(entry) || realPath.extension() != ".lua") {
-			// Skip this entry if it is not a regular file or does not have a .lua extension
-			continue;
-		}
-
 		// Check if file start with "#"
 		if (std::string disable("#");
 			file.front() == disable.front()) {
@@ -109,8 +152,15 @@ bool Scripts::loadScripts(std::string loadPath, bool isLib, bool reload) {
 				lastDirectory = realPath.parent_path().string();
 			}
 
+			const auto runStart = std::chrono::steady_clock::now();
+			const int result = scriptInterface.loadFile(realPath.string(), realPath.filename().string(), bytecodes[compiledIndex[i]]);
+			const auto relativeFolder = realPath.parent_path().lexically_relative(dir);
+			auto &[count, elapsed] = directoryTimes[relativeFolder.empty() || relativeFolder == "." ? "." : relativeFolder.begin()->string()];
+			++count;
+			elapsed += std::chrono::steady_clock::now() - runStart;
+
 			// If the function 'loadFile' returns -1, then there was an error loading the file
-			if (scriptInterface.loadFile(realPath.string(), realPath.filename().string()) == -1) {
+			if (result == -1) {
 				// Log the error and the file path, and skip to the next iteration of the loop.
 				g_logger().error(realPath.string());
 				g_logger().error(scriptInterface.getLastLuaError());
@@ -127,5 +177,33 @@ bool Scripts::loadScripts(std::string loadPath, bool isLib, bool reload) {
 		}
 	}
 
+	logLoadReport(loadPath, compiledFiles.size(), compileTime, directoryTimes);
+	return true;
+}
+
+bool Scripts::reloadScriptFile(const std::filesystem::path &file) {
+	// Same path string loadScripts gave loadFile, the registered events are tagged with it
+	const auto path = file.string();
+	g_actions().clearFileEvents(path);
+	g_creatureEvents().clearFileEvents(path);
+	g_talkActions().clearFileEvents(path);
+	g_globalEvents().clearFileEvents(path);
+	g_spells().clearFileEvents(path);
+	g_moveEvents().clearFileEvents(path);
+	g_weapons().clearFileEvents(path);
+	g_callbacks().clearFileCallbacks(path);
+
+	if (!std::filesystem::is_regular_file(file)) {
+		g_logger().info("[script removed]: {}", file.filename().string());
+		return true;
+	}
+
+	if (scriptInterface.loadFile(path, file.filename().string()) == -1) {
+		g_logger().error(path);
+		g_logger().error(scriptInterface.getLastLuaError());
+		return false;
+	}
+
+	g_logger().info("[script reloaded]: {}", file.filename().string());
 	return true;
 }
@@ -28,6 +28,8 @@ public:
 
 	bool loadEventSchedulerScripts(const std::string &fileName);
 	bool loadScripts(std::string folderName, bool isLib, bool reload);
+	// Unregisters what the file registered last time and runs it again, a removed file is only unregistered
+	bool reloadScriptFile(const std::filesystem::path &file);
 	LuaScriptInterface &getScriptInterface() {
 		return scriptInterface;
 	}
@@ -57,7 +59,7 @@ public:
 	 * @param interface Lua Script Interface
 	 */
 	explicit Script(LuaScriptInterface* interface) :
-		scriptInterface(interface) { }
+		scriptFile(interface ? interface->getLoadingFile() : std::string {}), scriptInterface(interface) { }
 	virtual ~Script() = default;
 
 	/**
@@ -117,10 +119,20 @@ public:
 		scriptId = newScriptId;
 	}
 
+	// File that was loading when the script was created, what a hot reload of that file unregisters
+	const std::string &getScriptFile() const {
+		return scriptFile;
+	}
+	void setScriptFile(const std::string &file) {
+		scriptFile = file;
+	}
+
 private:
 	// If script is loaded callback
 	bool loadedCallback = false;
 
+	std::string scriptFile;
+
 	int32_t scriptId = 0;
 	LuaScriptInterface* scriptInterface = nullptr;
 };
@@ -12,6 +12,7 @@
 #include "utils/pugicast.hpp"
 #include "map/house/house.hpp"
 #include "io/iologindata.hpp"
+#include "io/iomapserialize.hpp"
 #include "game/game.hpp"
 #include "items/bed.hpp"
 
@@ -24,6 +25,24 @@ void House::addTile(std::shared_ptr<HouseTile> tile) {
 	updateDoorDescription();
 }
 
+void House::addPendingItems(const Position &pos, std::string &&data) {
+	pendingItems[pos] = std::move(data);
+}
+
+void House::loadPendingItems() const {
+	if (pendingItems.empty()) {
+		return;
+	}
+
+	const auto items = std::move(pendingItems);
+	pendingItems.clear();
+	for (const auto &[pos, data] : items) {
+		if (const auto tile = g_game().map.getTile(pos)) {
+			IOMapSerialize::loadHouseTileItems(tile, data);
+		}
+	}
+}
+
 void House::setNewOwnerGuid(int32_t newOwnerGuid, bool serverStartup) {
 	auto isTransferOnRestart = g_configManager().getBoolean(TOGGLE_HOUSE_TRANSFER_ON_SERVER_RESTART);
 	if (!isTransferOnRestart) {
@@ -223,6 +242,8 @@ void House::setAccessList(uint32_t listId, const std::string &textlist) {
 		std::shared_ptr<Door> door = getDoorByNumber(listId);
 		if (door) {
 			door->setAccessList(textlist);
+		} else {
+			pendingDoorLists[listId] = textlist;
 		}
 
 		// We dont have kick anyone
@@ -266,6 +287,8 @@ bool House::transferToDepot(std::shared_ptr<Player> player) const {
 		return false;
 	}
 
+	loadPendingItems();
+
 	ItemList moveItemList;
 	for (std::shared_ptr<HouseTile> tile : houseTiles) {
 		if (const TileItemVector* items = tile->getItemList()) {
@@ -290,6 +313,8 @@ bool House::transferToDepot(std::shared_ptr<Player> player) const {
 }
 
 bool House::hasItemOnTile() const {
+	loadPendingItems();
+
 	bool foundItem = false;
 	for (const std::shared_ptr<HouseTile> &tile : houseTiles) {
 		if (const auto &items = tile->getItemList()) {
@@ -372,9 +397,20 @@ bool House::isInvited(std::shared_ptr<Player> player) {
 	return getHouseAccessLevel(player) != HOUSE_NOT_INVITED;
 }
 
+bool House::isListed(std::shared_ptr<Player> player) {
+	if (g_configManager().getBoolean(HOUSE_OWNED_BY_ACCOUNT) && ownerAccountId == player->getAccountId()) {
+		return true;
+	}
+	return player->getGUID() == owner || subOwnerList.isInList(player) || guestList.isInList(player);
+}
+
 void House::addDoor(std::shared_ptr<Door> door) {
 	doorList.push_back(door);
 	door->setHouse(static_self_cast<House>());
+	if (auto it = pendingDoorLists.find(door->getDoorId()); it != pendingDoorLists.end()) {
+		door->setAccessList(it->second);
+		pendingDoorLists.erase(it);
+	}
 	updateDoorDescription();
 }
 
@@ -504,6 +540,7 @@ void AccessList::parseList(const std::string &list) {
 	std::string validList = validateNameHouse(list);
 	playerList.clear();
 	guildRankList.clear();
+	cachedPlayers.clear();
 	allowEveryone = false;
 	this->list = validList;
 	if (list.empty()) {
@@ -553,24 +590,8 @@ void AccessList::addPlayer(const std::string &name) {
 	}
 }
 
-namespace {
-	std::shared_ptr<Guild> getGuildByName(const std::string &name) {
-		uint32_t guildId = IOGuild::getGuildIdByName(name);
-		if (guildId == 0) {
-			return nullptr;
-		}
-
-		const auto guild = g_game().getGuild(guildId);
-		if (guild) {
-			return guild;
-		}
-
-		return IOGuild::loadGuild(guildId);
-	}
-}
-
 void AccessList::addGuild(const std::string &name) {
-	const auto guild = getGuildByName(name);
+	const auto guild = g_game().getGuildByName(name, true);
 	if (guild) {
 		for (const auto rank : guild->getRanks()) {
 			guildRankList.insert(rank->id);
@@ -579,7 +600,7 @@ void AccessList::addGuild(const std::string &name) {
 }
 
 void AccessList::addGuildRank(const std::string &name, const std::string &guildName) {
-	const auto guild = getGuildByName(guildName);
+	const auto guild = g_game().getGuildByName(guildName, true);
 	if (guild) {
 		const GuildRank_ptr rank = guild->getRankByName(name);
 		if (rank) {
@@ -593,13 +614,23 @@ bool AccessList::isInList(std::shared_ptr<Player> player) {
 		return true;
 	}
 
-	auto playerIt = playerList.find(player->getGUID());
-	if (playerIt != playerList.end()) {
-		return true;
+	const uint32_t guid = player->getGUID();
+	const uint32_t guildRankVersion = player->getGuildRankVersion();
+	if (auto it = cachedPlayers.find(guid); it != cachedPlayers.end() && it->second.guildRankVersion == guildRankVersion) {
+		return it->second.listed;
+	}
+
+	bool listed = playerList.contains(guid);
+	if (!listed) {
+		GuildRank_ptr rank = player->getGuildRank();
+		listed = rank && guildRankList.contains(rank->id);
 	}
 
-	GuildRank_ptr rank = player->getGuildRank();
-	return rank && guildRankList.find(rank->id) != guildRankList.end();
+	if (cachedPlayers.size() >= MAX_CACHED_PLAYERS) {
+		cachedPlayers.clear();
+	}
+	cachedPlayers[guid] = CachedPlayer { listed, guildRankVersion };
+	return listed;
 }
 
 void AccessList::getList(std::string &retList) const {
@@ -680,6 +711,14 @@ std::shared_ptr<House> Houses::getHouseByPlayerId(uint32_t playerId) {
 	return nullptr;
 }
 
+void Houses::loadPendingItems(std::shared_ptr<Player> player) const {
+	for (const auto &[id, house] : houseMap) {
+		if (house->hasPendingItems() && house->isListed(player)) {
+			house->loadPendingItems();
+		}
+	}
+}
+
 bool Houses::loadHousesXML(const std::string &filename) {
 	pugi::xml_document doc;
 	pugi::xml_parse_result result = doc.load_file(filename.c_str());
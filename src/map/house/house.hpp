@@ -10,6 +10,7 @@
 #pragma once
 
 #include "items/containers/container.hpp"
+#include "items/item_pools.hpp"
 #include "declarations.hpp"
 #include "map/house/housetile.hpp"
 #include "game/movement/position.hpp"
@@ -30,9 +31,20 @@ public:
 	void getList(std::string &list) const;
 
 private:
+	// Past it the cached answers are dropped, they are rebuilt by the players still around
+	static constexpr size_t MAX_CACHED_PLAYERS = 1024;
+
+	struct CachedPlayer {
+		bool listed;
+		// A new guild rank of the player makes the answer stale
+		uint32_t guildRankVersion;
+	};
+
 	std::string list;
 	phmap::flat_hash_set<uint32_t> playerList;
 	phmap::flat_hash_set<uint32_t> guildRankList;
+	// Answers by guid for the house tiles and doors checked on every step, cleared when the list is parsed again
+	phmap::flat_hash_map<uint32_t, CachedPlayer> cachedPlayers;
 	bool allowEveryone = false;
 };
 
@@ -112,6 +124,8 @@ public:
 	bool getAccessList(uint32_t listId, std::string &list) const;
 
 	bool isInvited(std::shared_ptr<Player> player);
+	// Whether the player owns the house or is in one of its lists, the CanEditHouses flag aside
+	bool isListed(std::shared_ptr<Player> player);
 
 	AccessHouseLevel_t getHouseAccessLevel(std::shared_ptr<Player> player);
 	bool kickPlayer(std::shared_ptr<Player> player, std::shared_ptr<Player> target);
@@ -158,6 +172,20 @@ public:
 		return paidUntil;
 	}
 
+	// Digests of the rows the last save wrote for the house, zero when unknown, see IOMapSerialize
+	uint64_t getSavedItemsDigest() const {
+		return savedItemsDigest;
+	}
+	void setSavedItemsDigest(uint64_t digest) {
+		savedItemsDigest = digest;
+	}
+	uint64_t getSavedInfoDigest() const {
+		return savedInfoDigest;
+	}
+	void setSavedInfoDigest(uint64_t digest) {
+		savedInfoDigest = digest;
+	}
+
 	void setSize(uint32_t newSize) {
 		this->size = newSize;
 	}
@@ -202,6 +230,20 @@ public:
 		return houseTiles;
 	}
 
+	/**
+	 * Saved items of the house are kept as their tile_store rows until a tile
+	 * of the house is built from the map cache, then all of them are loaded.
+	 * Logic walking every tile or item of the house loads them first.
+	 */
+	void addPendingItems(const Position &pos, std::string &&data);
+	bool hasPendingItems() const {
+		return !pendingItems.empty();
+	}
+	const phmap::flat_hash_map<Position, std::string> &getPendingItems() const {
+		return pendingItems;
+	}
+	void loadPendingItems() const;
+
 	const std::list<std::shared_ptr<Door>> &getDoors() const {
 		return doorList;
 	}
@@ -212,8 +254,20 @@ public:
 		return bedsList;
 	}
 	uint32_t getBedCount() const {
+		// Beds are house items, the count saved with the house stands while they are not loaded
+		if (hasPendingItems()) {
+			return savedBedCount;
+		}
 		return static_cast<uint32_t>(std::floor(static_cast<double>(bedsList.size()) / 2.));
 	}
+	void setSavedBedCount(uint32_t count) {
+		savedBedCount = count;
+	}
+
+	// Access lists of doors whose tile is not built yet, applied once the door is added
+	const phmap::flat_hash_map<uint32_t, std::string> &getPendingDoorLists() const {
+		return pendingDoorLists;
+	}
 
 	void setMaxBeds(int32_t count) {
 		maxBeds = count;
@@ -235,9 +289,12 @@ private:
 	AccessList guestList;
 	AccessList subOwnerList;
 
-	std::shared_ptr<Container> transfer_container = std::make_shared<Container>(ITEM_LOCKER);
+	std::shared_ptr<Container> transfer_container = makePooled<Container>(ITEM_LOCKER);
 
 	HouseTileList houseTiles;
+	// Moved out while they load, building the tiles calls back into loadPendingItems
+	mutable phmap::flat_hash_map<Position, std::string> pendingItems;
+	phmap::flat_hash_map<uint32_t, std::string> pendingDoorLists;
 	std::list<std::shared_ptr<Door>> doorList;
 	HouseBedItemList bedsList;
 
@@ -250,6 +307,9 @@ private:
 
 	time_t paidUntil = 0;
 
+	uint64_t savedItemsDigest = 0;
+	uint64_t savedInfoDigest = 0;
+
 	uint32_t id;
 	uint32_t owner = 0;
 	uint32_t ownerAccountId = 0;
@@ -258,6 +318,7 @@ private:
 	uint32_t size = 0;
 	uint32_t townId = 0;
 	uint32_t maxBeds = 4;
+	uint32_t savedBedCount = 0;
 	int32_t bedsCount = -1;
 
 	Position posEntry = {};
@@ -297,6 +358,9 @@ public:
 
 	std::shared_ptr<House> getHouseByPlayerId(uint32_t playerId);
 
+	// Loads the saved items of every house the player is listed in, so a bed they sleep in is known at login
+	void loadPendingItems(std::shared_ptr<Player> player) const;
+
 	bool loadHousesXML(const std::string &filename);
 
 	void payHouses(RentPeriod_t rentPeriod) const;
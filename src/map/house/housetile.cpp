@@ -60,7 +60,7 @@ void HouseTile::updateHouse(std::shared_ptr<Item> item) {
 	}
 }
 
-ReturnValue HouseTile::queryAdd(int32_t index, const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t tileFlags, std::shared_ptr<Creature> actor /* = nullptr*/) {
+ReturnValue HouseTile::queryAdd(int32_t index, const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t tileFlags, const std::shared_ptr<Creature> &actor /* = nullptr*/) {
 	if (std::shared_ptr<Creature> creature = thing->getCreature()) {
 		if (std::shared_ptr<Player> player = creature->getPlayer()) {
 			if (!house->isInvited(player)) {
@@ -114,7 +114,7 @@ std::shared_ptr<Cylinder> HouseTile::queryDestination(int32_t &index, const std:
 	return Tile::queryDestination(index, thing, destItem, tileFlags);
 }
 
-ReturnValue HouseTile::queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, std::shared_ptr<Creature> actor /*= nullptr*/) {
+ReturnValue HouseTile::queryRemove(const std::shared_ptr<Thing> &thing, uint32_t count, uint32_t flags, const std::shared_ptr<Creature> &actor /*= nullptr*/) {
 	std::shared_ptr<Item> item = thing->getItem();
 	if (!item) {
 		return RETURNVALUE_NOTPOSSIBLE;
@@ -17,11 +17,15 @@
 #include "game/zones/zone.hpp"
 #include "io/iomap.hpp"
 #include "io/iomapserialize.hpp"
+#include "database/databasetasks.hpp"
+#include "lib/metrics/metrics.hpp"
+#include "lib/profiling/profiler.hpp"
 
 void Map::load(const std::string &identifier, const Position &pos) {
 	try {
 		path = identifier;
 		IOMap::loadMap(this, pos);
+		logCacheUsage();
 	} catch (const std::exception &e) {
 		throw IOMapException(fmt::format(
 			"\n[Map::load] - The map in folder {} is missing or corrupted"
@@ -32,6 +36,11 @@ void Map::load(const std::string &identifier, const Position &pos) {
 }
 
 void Map::loadMap(const std::string &identifier, bool mainMap /*= false*/, bool loadHouses /*= false*/, bool loadMonsters /*= false*/, bool loadNpcs /*= false*/, const Position &pos /*= Position()*/) {
+	loadMapTiles(identifier, mainMap, pos);
+	loadMapData(mainMap, loadHouses, loadMonsters, loadNpcs);
+}
+
+void Map::loadMapTiles(const std::string &identifier, bool mainMap, const Position &pos) {
 	// Only download map if is loading the main map and it is not already downloaded
 	if (mainMap && g_configManager().getBoolean(TOGGLE_DOWNLOAD_MAP) && !std::filesystem::exists(identifier)) {
 		const auto mapDownloadUrl = g_configManager().getString(MAP_DOWNLOAD_URL);
@@ -52,9 +61,16 @@ void Map::loadMap(const std::string &identifier, bool mainMap /*= false*/, bool
 		}
 	}
 
+	// Picked before any tile is looked up, the index itself is filled either way
+	if (mainMap) {
+		sectorIndexEnabled = g_configManager().getBoolean(MAP_SECTOR_INDEX);
+	}
+
 	// Load the map
 	load(identifier, pos);
+}
 
+void Map::loadMapData(bool mainMap, bool loadHouses, bool loadMonsters, bool loadNpcs) {
 	// Only create items from lua functions if is loading main map
 	// It needs to be after the load map to ensure the map already exists before creating the items
 	if (mainMap) {
@@ -121,6 +137,12 @@ void Map::loadHouseInfo() {
 }
 
 bool Map::save() {
+	// Houses skipped as unchanged must be written again when a previous write of them did not land
+	const bool stale = DBWriteCapture::getActive() ? g_databaseTasks().takeFailedWrites("houses") : g_databaseTasks().cancelWrites("houses");
+	if (stale) {
+		IOMapSerialize::invalidateHouseDigests();
+	}
+
 	bool saved = false;
 	for (uint32_t tries = 0; tries < 6; tries++) {
 		if (IOMapSerialize::saveHouseInfo()) {
@@ -173,11 +195,7 @@ void Map::setTile(uint16_t x, uint16_t y, uint8_t z, std::shared_ptr<Tile> newTi
 		return;
 	}
 
-	if (const auto leaf = getQTNode(x, y)) {
-		leaf->createFloor(z)->setTile(x, y, newTile);
-	} else {
-		root.getBestLeaf(x, y, 15)->createFloor(z)->setTile(x, y, newTile);
-	}
+	getOrCreateFloor(x, y, z)->setTile(x, y, newTile);
 }
 
 bool Map::placeCreature(const Position &centerPos, std::shared_ptr<Creature> creature, bool extendedPos /* = false*/, bool forceLogin /* = false*/) {
@@ -273,7 +291,10 @@ bool Map::placeCreature(const Position &centerPos, std::shared_ptr<Creature> cre
 	toCylinder->internalAddThing(creature);
 
 	const Position &dest = toCylinder->getPosition();
-	getQTNode(dest.x, dest.y)->addCreature(creature);
+	getQTNode(dest.x, dest.y)->addCreature(creature, dest.z);
+	if (creature->getPlayer()) {
+		markActiveSectors(dest);
+	}
 	return true;
 }
 
@@ -296,7 +317,7 @@ void Map::moveCreature(const std::shared_ptr<Creature> &creature, const std::sha
 	getSpectators(spectators, newPos, true);
 
 	std::vector<int32_t> oldStackPosVector;
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (auto tmpPlayer = spectator->getPlayer()) {
 			if (tmpPlayer->canSeeCreature(creature)) {
 				oldStackPosVector.push_back(oldTile->getClientIndexOfCreature(tmpPlayer, creature));
@@ -312,15 +333,20 @@ void Map::moveCreature(const std::shared_ptr<Creature> &creature, const std::sha
 	auto leaf = getQTNode(oldPos.x, oldPos.y);
 	auto new_leaf = getQTNode(newPos.x, newPos.y);
 
-	// Switch the node ownership
-	if (leaf != new_leaf) {
-		leaf->removeCreature(creature);
-		new_leaf->addCreature(creature);
+	// Switch the node ownership, a floor change inside the same leaf moves it between floor counters
+	if (leaf != new_leaf || oldPos.z != newPos.z) {
+		leaf->removeCreature(creature, oldPos.z);
+		new_leaf->addCreature(creature, newPos.z);
 	}
 
 	// add the creature
 	newTile->addThing(creature);
 
+	// Wake up the sectors the player walks into, before anything there thinks again
+	if (leaf != new_leaf && creature->getPlayer()) {
+		markActiveSectors(newPos);
+	}
+
 	if (!teleport) {
 		if (oldPos.y > newPos.y) {
 			creature->setDirection(DIRECTION_NORTH);
@@ -337,7 +363,7 @@ void Map::moveCreature(const std::shared_ptr<Creature> &creature, const std::sha
 
 	// send to client
 	size_t i = 0;
-	for (auto spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		if (auto tmpPlayer = spectator->getPlayer()) {
 			// Use the correct stackpos
 			int32_t stackpos = oldStackPosVector[i++];
@@ -348,7 +374,7 @@ void Map::moveCreature(const std::shared_ptr<Creature> &creature, const std::sha
 	}
 
 	// event method
-	for (std::shared_ptr<Creature> spectator : spectators) {
+	for (const auto &spectator : spectators) {
 		spectator->onCreatureMove(creature, newTile, newPos, oldTile, oldPos, teleport);
 	}
 
@@ -357,7 +383,8 @@ void Map::moveCreature(const std::shared_ptr<Creature> &creature, const std::sha
 	g_game().afterCreatureZoneChange(creature, fromZones, toZones);
 }
 
-void Map::getSpectatorsInternal(SpectatorHashSet &spectators, const Position &centerPos, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY, int32_t minRangeZ, int32_t maxRangeZ, bool onlyPlayers) const {
+template <typename Container>
+void Map::getSpectatorsInternal(Container &spectators, const Position &centerPos, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY, int32_t minRangeZ, int32_t maxRangeZ, bool onlyPlayers) const {
 	int_fast32_t min_y = centerPos.y + minRangeY;
 	int_fast32_t min_x = centerPos.x + minRangeX;
 	int_fast32_t max_y = centerPos.y + maxRangeY;
@@ -376,7 +403,10 @@ void Map::getSpectatorsInternal(SpectatorHashSet &spectators, const Position &ce
 	int32_t endx2 = x2 - (x2 % FLOOR_SIZE);
 	int32_t endy2 = y2 - (y2 % FLOOR_SIZE);
 
-	const auto startLeaf = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, startx1, starty1);
+	// Floors in [minRangeZ, maxRangeZ], leaves with nobody on them are skipped without touching their lists
+	const uint16_t floorMask = static_cast<uint16_t>(((1u << (maxRangeZ + 1)) - 1) & ~((1u << minRangeZ) - 1));
+
+	const auto startLeaf = getLeaf(startx1, starty1);
 	const QTreeLeafNode* leafS = startLeaf;
 	const QTreeLeafNode* leafE;
 
@@ -384,8 +414,13 @@ void Map::getSpectatorsInternal(SpectatorHashSet &spectators, const Position &ce
 		leafE = leafS;
 		for (int_fast32_t nx = startx1; nx <= endx2; nx += FLOOR_SIZE) {
 			if (leafE) {
-				const auto node_list = (onlyPlayers ? leafE->player_list : leafE->creature_list);
-				for (std::shared_ptr<Creature> creature : node_list) {
+				if (((onlyPlayers ? leafE->playerFloors : leafE->creatureFloors) & floorMask) == 0) {
+					leafE = leafE->leafE;
+					continue;
+				}
+
+				const auto &node_list = (onlyPlayers ? leafE->player_list : leafE->creature_list);
+				for (const std::shared_ptr<Creature> &creature : node_list) {
 					const Position &cpos = creature->getPosition();
 					if (minRangeZ > cpos.z || maxRangeZ < cpos.z) {
 						continue;
@@ -396,23 +431,28 @@ void Map::getSpectatorsInternal(SpectatorHashSet &spectators, const Position &ce
 						continue;
 					}
 
-					spectators.insert(creature);
+					if constexpr (std::is_same_v<Container, SpectatorHashSet>) {
+						spectators.insert(creature);
+					} else {
+						spectators.emplace_back(creature);
+					}
 				}
 				leafE = leafE->leafE;
 			} else {
-				leafE = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, nx + FLOOR_SIZE, ny);
+				leafE = getLeaf(nx + FLOOR_SIZE, ny);
 			}
 		}
 
 		if (leafS) {
 			leafS = leafS->leafS;
 		} else {
-			leafS = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, startx1, ny + FLOOR_SIZE);
+			leafS = getLeaf(startx1, ny + FLOOR_SIZE);
 		}
 	}
 }
 
 void Map::getSpectators(SpectatorHashSet &spectators, const Position &centerPos, bool multifloor /*= false*/, bool onlyPlayers /*= false*/, int32_t minRangeX /*= 0*/, int32_t maxRangeX /*= 0*/, int32_t minRangeY /*= 0*/, int32_t maxRangeY /*= 0*/) {
+	CANARY_PROFILE_ZONE("Map::getSpectators");
 	if (centerPos.z >= MAP_MAX_LAYERS) {
 		return;
 	}
@@ -427,13 +467,11 @@ void Map::getSpectators(SpectatorHashSet &spectators, const Position &centerPos,
 
 	if (minRangeX == -MAP_MAX_VIEW_PORT_X && maxRangeX == MAP_MAX_VIEW_PORT_X && minRangeY == -MAP_MAX_VIEW_PORT_Y && maxRangeY == MAP_MAX_VIEW_PORT_Y && multifloor) {
 		if (onlyPlayers) {
-			auto it = playersSpectatorCache.find(centerPos);
-			if (it != playersSpectatorCache.end()) {
+			if (const auto cachedSpectators = findCachedSpectators(playersSpectatorCache, centerPos)) {
 				if (!spectators.empty()) {
-					const SpectatorHashSet &cachedSpectators = it->second;
-					spectators.insert(cachedSpectators.begin(), cachedSpectators.end());
+					spectators.insert(cachedSpectators->begin(), cachedSpectators->end());
 				} else {
-					spectators = it->second;
+					spectators = *cachedSpectators;
 				}
 
 				foundCache = true;
@@ -441,18 +479,15 @@ void Map::getSpectators(SpectatorHashSet &spectators, const Position &centerPos,
 		}
 
 		if (!foundCache) {
-			auto it = spectatorCache.find(centerPos);
-			if (it != spectatorCache.end()) {
+			if (const auto cachedSpectators = findCachedSpectators(spectatorCache, centerPos)) {
 				if (!onlyPlayers) {
 					if (!spectators.empty()) {
-						const SpectatorHashSet &cachedSpectators = it->second;
-						spectators.insert(cachedSpectators.begin(), cachedSpectators.end());
+						spectators.insert(cachedSpectators->begin(), cachedSpectators->end());
 					} else {
-						spectators = it->second;
+						spectators = *cachedSpectators;
 					}
 				} else {
-					const SpectatorHashSet &cachedSpectators = it->second;
-					for (std::shared_ptr<Creature> spectator : cachedSpectators) {
+					for (std::shared_ptr<Creature> spectator : *cachedSpectators) {
 						if (spectator->getPlayer()) {
 							spectators.insert(spectator);
 						}
@@ -471,22 +506,7 @@ void Map::getSpectators(SpectatorHashSet &spectators, const Position &centerPos,
 		int32_t maxRangeZ;
 
 		if (multifloor) {
-			if (centerPos.z > MAP_INIT_SURFACE_LAYER) {
-				// underground
-
-				// 8->15
-				minRangeZ = std::max<int32_t>(centerPos.getZ() - MAP_LAYER_VIEW_LIMIT, 0);
-				maxRangeZ = std::min<int32_t>(centerPos.getZ() + MAP_LAYER_VIEW_LIMIT, MAP_MAX_LAYERS - 1);
-			} else if (centerPos.z == MAP_INIT_SURFACE_LAYER - 1) {
-				minRangeZ = 0;
-				maxRangeZ = (MAP_INIT_SURFACE_LAYER - 1) + MAP_LAYER_VIEW_LIMIT;
-			} else if (centerPos.z == MAP_INIT_SURFACE_LAYER) {
-				minRangeZ = 0;
-				maxRangeZ = MAP_INIT_SURFACE_LAYER + MAP_LAYER_VIEW_LIMIT;
-			} else {
-				minRangeZ = 0;
-				maxRangeZ = MAP_INIT_SURFACE_LAYER;
-			}
+			getMultifloorRange(centerPos, minRangeZ, maxRangeZ);
 		} else {
 			minRangeZ = centerPos.z;
 			maxRangeZ = centerPos.z;
@@ -495,13 +515,169 @@ void Map::getSpectators(SpectatorHashSet &spectators, const Position &centerPos,
 		getSpectatorsInternal(spectators, centerPos, minRangeX, maxRangeX, minRangeY, maxRangeY, minRangeZ, maxRangeZ, onlyPlayers);
 
 		if (cacheResult) {
-			if (onlyPlayers) {
-				playersSpectatorCache[centerPos] = spectators;
-			} else {
-				spectatorCache[centerPos] = spectators;
+			auto &cache = onlyPlayers ? playersSpectatorCache : spectatorCache;
+			// Entries are only dropped once found stale, keep the cache from growing with every position ever queried
+			if (cache.size() >= MAP_MAX_SPECTATOR_CACHE_ENTRIES) {
+				cache.clear();
+			}
+			cache[centerPos] = { spectatorCacheGeneration, spectators };
+		}
+	}
+}
+
+void Map::getSpectators(std::vector<std::shared_ptr<Creature>> &spectators, const Position &centerPos, bool multifloor /*= false*/, bool onlyPlayers /*= false*/, int32_t minRangeX /*= 0*/, int32_t maxRangeX /*= 0*/, int32_t minRangeY /*= 0*/, int32_t maxRangeY /*= 0*/) {
+	CANARY_PROFILE_ZONE("Map::getSpectators");
+	if (centerPos.z >= MAP_MAX_LAYERS) {
+		return;
+	}
+
+	minRangeX = (minRangeX == 0 ? -MAP_MAX_VIEW_PORT_X : -minRangeX);
+	maxRangeX = (maxRangeX == 0 ? MAP_MAX_VIEW_PORT_X : maxRangeX);
+	minRangeY = (minRangeY == 0 ? -MAP_MAX_VIEW_PORT_Y : -minRangeY);
+	maxRangeY = (maxRangeY == 0 ? MAP_MAX_VIEW_PORT_Y : maxRangeY);
+
+	// Reads the cache filled by the hashed overload, but does not fill it, so it never allocates
+	if (minRangeX == -MAP_MAX_VIEW_PORT_X && maxRangeX == MAP_MAX_VIEW_PORT_X && minRangeY == -MAP_MAX_VIEW_PORT_Y && maxRangeY == MAP_MAX_VIEW_PORT_Y && multifloor) {
+		const SpectatorHashSet* cachedSpectators = onlyPlayers ? findCachedSpectators(playersSpectatorCache, centerPos) : nullptr;
+		const bool filterPlayers = onlyPlayers && !cachedSpectators;
+		if (!cachedSpectators) {
+			cachedSpectators = findCachedSpectators(spectatorCache, centerPos);
+		}
+
+		if (cachedSpectators) {
+			for (const auto &spectator : *cachedSpectators) {
+				if (!filterPlayers || spectator->getPlayer()) {
+					spectators.emplace_back(spectator);
+				}
 			}
+			return;
 		}
 	}
+
+	int32_t minRangeZ;
+	int32_t maxRangeZ;
+	if (multifloor) {
+		getMultifloorRange(centerPos, minRangeZ, maxRangeZ);
+	} else {
+		minRangeZ = centerPos.z;
+		maxRangeZ = centerPos.z;
+	}
+
+	getSpectatorsInternal(spectators, centerPos, minRangeX, maxRangeX, minRangeY, maxRangeY, minRangeZ, maxRangeZ, onlyPlayers);
+}
+
+bool Map::isInSpectatorView(const Position &centerPos, const Position &creaturePos, bool multifloor) {
+	int32_t minRangeZ = centerPos.z;
+	int32_t maxRangeZ = centerPos.z;
+	if (multifloor) {
+		getMultifloorRange(centerPos, minRangeZ, maxRangeZ);
+	}
+
+	if (minRangeZ > creaturePos.z || maxRangeZ < creaturePos.z) {
+		return false;
+	}
+
+	// Same bounds as getSpectatorsInternal
+	const int32_t offsetZ = Position::getOffsetZ(centerPos, creaturePos);
+	return creaturePos.x >= centerPos.x - MAP_MAX_VIEW_PORT_X + offsetZ && creaturePos.x <= centerPos.x + MAP_MAX_VIEW_PORT_X + offsetZ
+		&& creaturePos.y >= centerPos.y - MAP_MAX_VIEW_PORT_Y + offsetZ && creaturePos.y <= centerPos.y + MAP_MAX_VIEW_PORT_Y + offsetZ;
+}
+
+void Map::getMultifloorRange(const Position &centerPos, int32_t &minRangeZ, int32_t &maxRangeZ) {
+	if (centerPos.z > MAP_INIT_SURFACE_LAYER) {
+		// underground
+
+		// 8->15
+		minRangeZ = std::max<int32_t>(centerPos.getZ() - MAP_LAYER_VIEW_LIMIT, 0);
+		maxRangeZ = std::min<int32_t>(centerPos.getZ() + MAP_LAYER_VIEW_LIMIT, MAP_MAX_LAYERS - 1);
+	} else if (centerPos.z == MAP_INIT_SURFACE_LAYER - 1) {
+		minRangeZ = 0;
+		maxRangeZ = (MAP_INIT_SURFACE_LAYER - 1) + MAP_LAYER_VIEW_LIMIT;
+	} else if (centerPos.z == MAP_INIT_SURFACE_LAYER) {
+		minRangeZ = 0;
+		maxRangeZ = MAP_INIT_SURFACE_LAYER + MAP_LAYER_VIEW_LIMIT;
+	} else {
+		minRangeZ = 0;
+		maxRangeZ = MAP_INIT_SURFACE_LAYER;
+	}
+}
+
+const SpectatorHashSet* Map::findCachedSpectators(SpectatorCache &cache, const Position &centerPos) {
+	static auto &hits = g_metrics().getCounter("canary_spectator_cache_hits_total", "Spectator lookups answered from the cache");
+	static auto &misses = g_metrics().getCounter("canary_spectator_cache_misses_total", "Spectator lookups that were not cached or were invalidated");
+
+	auto it = cache.find(centerPos);
+	if (it == cache.end()) {
+		misses.add();
+		return nullptr;
+	}
+
+	if (!isSpectatorCacheValid(centerPos, it->second.generation)) {
+		cache.erase(it);
+		misses.add();
+		return nullptr;
+	}
+	hits.add();
+	return &it->second.spectators;
+}
+
+bool Map::isSpectatorCacheValid(const Position &centerPos, uint64_t generation) const {
+	// Nothing changed anywhere since it was cached
+	if (generation == spectatorCacheGeneration) {
+		return true;
+	}
+
+	// Same area getSpectatorsInternal scans for a full view, multifloor query
+	int32_t minRangeZ;
+	int32_t maxRangeZ;
+	getMultifloorRange(centerPos, minRangeZ, maxRangeZ);
+
+	const int32_t minoffset = centerPos.getZ() - maxRangeZ;
+	const int32_t maxoffset = centerPos.getZ() - minRangeZ;
+	const uint16_t x1 = std::min<uint32_t>(0xFFFF, std::max<int32_t>(0, centerPos.x - MAP_MAX_VIEW_PORT_X + minoffset));
+	const uint16_t y1 = std::min<uint32_t>(0xFFFF, std::max<int32_t>(0, centerPos.y - MAP_MAX_VIEW_PORT_Y + minoffset));
+	const uint16_t x2 = std::min<uint32_t>(0xFFFF, std::max<int32_t>(0, centerPos.x + MAP_MAX_VIEW_PORT_X + maxoffset));
+	const uint16_t y2 = std::min<uint32_t>(0xFFFF, std::max<int32_t>(0, centerPos.y + MAP_MAX_VIEW_PORT_Y + maxoffset));
+
+	for (int32_t ny = y1 & ~FLOOR_MASK; ny <= y2; ny += FLOOR_SIZE) {
+		const QTreeLeafNode* leaf = nullptr;
+		for (int32_t nx = x1 & ~FLOOR_MASK; nx <= x2; nx += FLOOR_SIZE) {
+			leaf = leaf ? leaf->leafE : nullptr;
+			if (!leaf) {
+				leaf = getLeaf(nx, ny);
+			}
+
+			if (leaf && leaf->spectatorGeneration > generation) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void Map::markActiveSectors(const Position &pos) {
+	// Leaves are 2D, so cover the widest multi-floor view
+	static constexpr int32_t rangeX = MAP_MAX_VIEW_PORT_X + MAP_MAX_LAYERS;
+	static constexpr int32_t rangeY = MAP_MAX_VIEW_PORT_Y + MAP_MAX_LAYERS;
+
+	const int32_t startX = std::max<int32_t>(0, pos.x - rangeX) & ~FLOOR_MASK;
+	const int32_t startY = std::max<int32_t>(0, pos.y - rangeY) & ~FLOOR_MASK;
+	const int32_t endX = std::min<int32_t>(0xFFFF, pos.x + rangeX);
+	const int32_t endY = std::min<int32_t>(0xFFFF, pos.y + rangeY);
+
+	const int64_t activeUntil = OTSYS_TIME() + MAP_SECTOR_ACTIVITY_TIME;
+	for (int32_t y = startY; y <= endY; y += FLOOR_SIZE) {
+		for (int32_t x = startX; x <= endX; x += FLOOR_SIZE) {
+			if (const auto leaf = getQTNode(x, y)) {
+				leaf->activeUntil = activeUntil;
+			}
+		}
+	}
+}
+
+bool Map::isSectorActive(const Position &pos) {
+	const auto leaf = getQTNode(pos.x, pos.y);
+	return leaf && leaf->activeUntil >= OTSYS_TIME();
 }
 
 void Map::clearSpectatorCache() {
@@ -509,6 +685,15 @@ void Map::clearSpectatorCache() {
 	playersSpectatorCache.clear();
 }
 
+void Map::invalidateSpectatorCache(const Position &pos) {
+	if (const auto leaf = getQTNode(pos.x, pos.y)) {
+		leaf->spectatorGeneration = ++spectatorCacheGeneration;
+	} else {
+		// No sector to record it in, drop everything
+		clearSpectatorCache();
+	}
+}
+
 bool Map::canThrowObjectTo(const Position &fromPos, const Position &toPos, bool checkLineOfSight /*= true*/, int32_t rangex /*= MAP_MAX_CLIENT_VIEW_PORT_X*/, int32_t rangey /*= MAP_MAX_CLIENT_VIEW_PORT_Y*/) {
 	// z checks
 	// underground 8->15
@@ -567,8 +752,7 @@ bool Map::checkSightLine(const Position &fromPos, const Position &toPos) {
 			start.x += mx;
 		}
 
-		const std::shared_ptr<Tile> tile = getTile(start.x, start.y, start.z);
-		if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+		if (hasSectorFlag(start, SECTOR_FLAG_BLOCKPROJECTILE)) {
 			return false;
 		}
 	}
@@ -586,6 +770,82 @@ bool Map::checkSightLine(const Position &fromPos, const Position &toPos) {
 	return true;
 }
 
+const Floor* Map::getSectorFloor(const Position &pos) {
+	if (pos.z >= MAP_MAX_LAYERS) {
+		return nullptr;
+	}
+
+	const auto leaf = getQTNode(pos.x, pos.y);
+	if (!leaf) {
+		return nullptr;
+	}
+
+	const auto &floor = leaf->getFloor(pos.z);
+	if (floor && (floor->getPendingMask() & Floor::getTileBit(pos.x, pos.y))) {
+		getOrCreateTileFromCache(floor, pos.x, pos.y);
+	}
+	return floor.get();
+}
+
+bool Map::hasSectorFlag(const Position &pos, SectorFlag_t flag) {
+	const auto floor = getSectorFloor(pos);
+	return floor && (floor->getFlagMask(flag) & Floor::getTileBit(pos.x, pos.y));
+}
+
+bool Map::isSectorWalkable(const Position &pos) {
+	const auto floor = getSectorFloor(pos);
+	return floor && (floor->getWalkableMask() & Floor::getTileBit(pos.x, pos.y));
+}
+
+void Map::getSectorFlagGrid(const Position &topLeft, uint32_t width, uint32_t height, SectorFlag_t flag, std::vector<uint8_t> &grid) {
+	grid.assign(static_cast<size_t>(width) * height, 0);
+	for (uint32_t y = 0; y < height; ++y) {
+		for (uint32_t x = 0; x < width; ++x) {
+			grid[y * width + x] = hasSectorFlag(Position(topLeft.x + x, topLeft.y + y, topLeft.z), flag);
+		}
+	}
+}
+
+bool Map::checkSightLine(const std::vector<uint8_t> &blocked, uint32_t width, int32_t fromX, int32_t fromY, int32_t toX, int32_t toY) {
+	if (fromX == toX && fromY == toY) {
+		return true;
+	}
+
+	const int32_t mx = fromX < toX ? 1 : fromX == toX ? 0
+													: -1;
+	const int32_t my = fromY < toY ? 1 : fromY == toY ? 0
+													: -1;
+
+	const int32_t A = toY - fromY;
+	const int32_t B = fromX - toX;
+	const int32_t C = -(A * toX + B * toY);
+
+	int32_t x = fromX;
+	int32_t y = fromY;
+	while (x != toX || y != toY) {
+		const int32_t move_hor = std::abs(A * (x + mx) + B * y + C);
+		const int32_t move_ver = std::abs(A * x + B * (y + my) + C);
+		const int32_t move_cross = std::abs(A * (x + mx) + B * (y + my) + C);
+
+		if (y != toY && (x == toX || move_hor > move_ver || move_hor > move_cross)) {
+			y += my;
+		}
+
+		if (x != toX && (y == toY || move_ver > move_hor || move_ver > move_cross)) {
+			x += mx;
+		}
+
+		if (blocked[y * width + x]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Map::isSightClear(const std::vector<uint8_t> &blocked, uint32_t width, int32_t fromX, int32_t fromY, int32_t toX, int32_t toY) {
+	return checkSightLine(blocked, width, fromX, fromY, toX, toY) || checkSightLine(blocked, width, toX, toY, fromX, fromY);
+}
+
 bool Map::isSightClear(const Position &fromPos, const Position &toPos, bool floorCheck) {
 	if (floorCheck && fromPos.z != toPos.z) {
 		return false;
@@ -603,6 +863,11 @@ std::shared_ptr<Tile> Map::canWalkTo(const std::shared_ptr<Creature> &creature,
 		return getTile(pos.x, pos.y, pos.z);
 	}
 
+	// Floor changes never take part in a path, no need to query the tile
+	if (creature->getPosition() != pos && hasSectorFlag(pos, SECTOR_FLAG_FLOORCHANGE)) {
+		return nullptr;
+	}
+
 	// used for non-cached tiles
 	std::shared_ptr<Tile> tile = getTile(pos.x, pos.y, pos.z);
 	if (creature->getTile() != tile) {
@@ -614,10 +879,17 @@ std::shared_ptr<Tile> Map::canWalkTo(const std::shared_ptr<Creature> &creature,
 }
 
 bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, std::forward_list<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
+	CANARY_PROFILE_ZONE("Map::getPathMatching");
+	// Melee chasers of the same target share a flow field instead of each running A*
+	const auto monster = creature->getMonster();
+	if (monster && !monster->isSummon() && fpp.fullPathSearch && fpp.allowDiagonal && !fpp.keepDistance && fpp.minTargetDist <= 1 && fpp.maxTargetDist == 1 && getFlowFieldPath(monster, pathCondition.getTargetPos(), dirList)) {
+		return true;
+	}
+
 	Position pos = creature->getPosition();
 	Position endPos;
 
-	AStarNodes nodes(pos.x, pos.y);
+	auto &nodes = AStarNodes::getThreadInstance(pos.x, pos.y);
 
 	int32_t bestMatch = 0;
 
@@ -640,7 +912,7 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, std::forwar
 	AStarNode* found = nullptr;
 	while (fpp.maxSearchDist != 0 || nodes.getClosedNodes() < 100) {
 		AStarNode* n = nodes.getBestNode();
-		if (!n) {
+		if (!n || (fpp.maxCost != 0 && n->f > fpp.maxCost)) {
 			if (found) {
 				break;
 			}
@@ -787,11 +1059,127 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, std::forwar
 	return true;
 }
 
+namespace {
+	uint64_t getFlowFieldRegion(int32_t x, int32_t y, uint8_t z) {
+		return (static_cast<uint64_t>(z) << 32) | (static_cast<uint64_t>(x >> MAP_REGION_BITS) << 16) | static_cast<uint64_t>(y >> MAP_REGION_BITS);
+	}
+}
+
+bool Map::getFlowFieldPath(const std::shared_ptr<Monster> &monster, const Position &targetPos, std::forward_list<Direction> &dirList) {
+	const Position &startPos = monster->getPosition();
+	if (startPos.z != targetPos.z || Position::getDistanceX(startPos, targetPos) > FlowField::RADIUS || Position::getDistanceY(startPos, targetPos) > FlowField::RADIUS) {
+		return false;
+	}
+
+	const int64_t now = OTSYS_TIME();
+	if (flowFields.size() >= MAP_MAX_FLOW_FIELDS) {
+		phmap::erase_if(flowFields, [now](const auto &it) { return now - it.second.createdAt > MAP_FLOW_FIELD_LIFETIME; });
+		if (flowFields.size() >= MAP_MAX_FLOW_FIELDS) {
+			flowFields.clear();
+			flowFieldRegions.clear();
+		}
+	}
+
+	const uint8_t walkClass = FlowField::getWalkClass(monster);
+	const uint64_t key = (static_cast<uint64_t>(targetPos.x) << 32) | (static_cast<uint64_t>(targetPos.y) << 16) | (static_cast<uint64_t>(targetPos.z) << 8) | walkClass;
+	auto &entry = flowFields[key];
+	if (now - entry.createdAt > MAP_FLOW_FIELD_LIFETIME) {
+		entry.createdAt = now;
+		entry.requests = 0;
+		entry.field.reset();
+	}
+
+	if (!entry.field) {
+		if (++entry.requests < MAP_FLOW_FIELD_MIN_CHASERS) {
+			return false;
+		}
+
+		// Same walkability and extra costs as the A* of getPathMatching
+		entry.field = std::make_unique<FlowField>(targetPos, [this, &monster](const Position &pos) -> std::optional<int32_t> {
+			const auto tile = canWalkTo(monster, pos);
+			if (!tile) {
+				return std::nullopt;
+			}
+			return AStarNodes::getTileWalkCost(monster, tile);
+		});
+
+		const int32_t minX = (targetPos.x - FlowField::RADIUS) >> MAP_REGION_BITS;
+		const int32_t maxX = (targetPos.x + FlowField::RADIUS) >> MAP_REGION_BITS;
+		const int32_t minY = (targetPos.y - FlowField::RADIUS) >> MAP_REGION_BITS;
+		const int32_t maxY = (targetPos.y + FlowField::RADIUS) >> MAP_REGION_BITS;
+		for (int32_t regionX = minX; regionX <= maxX; ++regionX) {
+			for (int32_t regionY = minY; regionY <= maxY; ++regionY) {
+				auto &keys = flowFieldRegions[getFlowFieldRegion(regionX << MAP_REGION_BITS, regionY << MAP_REGION_BITS, targetPos.z)];
+				if (std::ranges::find(keys, key) == keys.end()) {
+					keys.emplace_back(key);
+				}
+			}
+		}
+	}
+
+	std::forward_list<Direction> path;
+	if (!entry.field->getPath(startPos, path)) {
+		return false;
+	}
+
+	// The field was built from another monster's view, this one must be able to take every step
+	Position pos = startPos;
+	for (const Direction direction : path) {
+		pos = getNextPosition(direction, pos);
+		if (!canWalkTo(monster, pos)) {
+			return false;
+		}
+	}
+
+	dirList.splice_after(dirList.before_begin(), path);
+	return true;
+}
+
+void Map::invalidateFlowFields(const Position &pos) {
+	if (flowFields.empty()) {
+		return;
+	}
+
+	if (isBatchingTileUpdates()) {
+		batchedTiles.emplace(pos);
+		return;
+	}
+
+	resetFlowFields(pos);
+}
+
+void Map::resetFlowFields(const Position &pos) {
+	const auto regionIt = flowFieldRegions.find(getFlowFieldRegion(pos.x, pos.y, pos.z));
+	if (regionIt == flowFieldRegions.end()) {
+		return;
+	}
+
+	auto &keys = regionIt->second;
+	std::erase_if(keys, [this, &pos](uint64_t key) {
+		const auto it = flowFields.find(key);
+		if (it == flowFields.end() || !it->second.field) {
+			return true;
+		}
+
+		// Requests are kept, so the next chaser rebuilds the field right away
+		if (it->second.field->contains(pos)) {
+			it->second.field.reset();
+			return true;
+		}
+		return false;
+	});
+
+	if (keys.empty()) {
+		flowFieldRegions.erase(regionIt);
+	}
+}
+
 bool Map::getPathMatching(const Position &start, std::forward_list<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
+	CANARY_PROFILE_ZONE("Map::getPathMatching");
 	Position pos = start;
 	Position endPos;
 
-	AStarNodes nodes(pos.x, pos.y);
+	auto &nodes = AStarNodes::getThreadInstance(pos.x, pos.y);
 
 	int32_t bestMatch = 0;
 
@@ -814,7 +1202,7 @@ bool Map::getPathMatching(const Position &start, std::forward_list<Direction> &d
 	AStarNode* found = nullptr;
 	while (fpp.maxSearchDist != 0 || nodes.getClosedNodes() < 100) {
 		AStarNode* n = nodes.getBestNode();
-		if (!n) {
+		if (!n || (fpp.maxCost != 0 && n->f > fpp.maxCost)) {
 			if (found) {
 				break;
 			}
@@ -880,15 +1268,9 @@ bool Map::getPathMatching(const Position &start, std::forward_list<Direction> &d
 				continue;
 			}
 
-			std::shared_ptr<Tile> tile;
 			AStarNode* neighborNode = nodes.getNodeByPosition(pos.x, pos.y);
-			if (neighborNode) {
-				tile = getTile(pos.x, pos.y, pos.z);
-			} else {
-				tile = getTile(pos.x, pos.y, pos.z);
-				if (!tile || tile->hasFlag(TILESTATE_BLOCKSOLID)) {
-					continue;
-				}
+			if (!neighborNode && !isSectorWalkable(pos)) {
+				continue;
 			}
 
 			// The cost (g) for this neighbor
@@ -961,6 +1343,35 @@ bool Map::getPathMatching(const Position &start, std::forward_list<Direction> &d
 	return true;
 }
 
+void Map::endTileUpdateBatch() {
+	if (tileUpdateBatchDepth == 0 || --tileUpdateBatchDepth > 0) {
+		return;
+	}
+
+	const auto tiles = std::move(batchedTiles);
+	batchedTiles.clear();
+
+	if (!flowFields.empty()) {
+		for (const auto &pos : tiles) {
+			resetFlowFields(pos);
+		}
+	}
+
+	SpectatorHashSet spectators;
+	for (const auto &pos : tiles) {
+		spectators.clear();
+		getSpectators(spectators, pos, true, true);
+		if (spectators.empty()) {
+			continue;
+		}
+
+		const auto tile = getTile(pos);
+		for (const auto &spectator : spectators) {
+			spectator->getPlayer()->sendUpdateTile(tile, pos);
+		}
+	}
+}
+
 uint32_t Map::clean() {
 	uint64_t start = OTSYS_TIME();
 	size_t tiles = 0;
@@ -984,8 +1395,11 @@ uint32_t Map::clean() {
 		}
 	}
 
-	for (auto item : toRemove) {
-		g_game().internalRemoveItem(item, -1);
+	{
+		TileUpdateBatch batch(g_game().map);
+		for (auto item : toRemove) {
+			g_game().internalRemoveItem(item, -1);
+		}
 	}
 
 	size_t count = toRemove.size();
@@ -999,3 +1413,22 @@ uint32_t Map::clean() {
 	g_logger().info("CLEAN: Removed {} item{} from {} tile{} in {} seconds", count, (count != 1 ? "s" : ""), tiles, (tiles != 1 ? "s" : ""), (end - start) / (1000.f));
 	return count;
 }
+
+uint32_t Map::cleanTile(const std::shared_ptr<Tile> &tile) {
+	const auto items = tile->getItemList();
+	if (!items) {
+		return 0;
+	}
+
+	std::vector<std::shared_ptr<Item>> toRemove;
+	for (const auto &item : *items) {
+		if (item->isCleanable()) {
+			toRemove.emplace_back(item);
+		}
+	}
+
+	for (const auto &item : toRemove) {
+		g_game().internalRemoveItem(item, -1);
+	}
+	return static_cast<uint32_t>(toRemove.size());
+}
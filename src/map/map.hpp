@@ -14,6 +14,7 @@
 #include "map/house/house.hpp"
 #include "creatures/monsters/spawns/spawn_monster.hpp"
 #include "creatures/npcs/spawns/spawn_npc.hpp"
+#include "map/utils/flow_field.hpp"
 
 class Creature;
 class Player;
@@ -23,7 +24,13 @@ class Map;
 
 struct FindPathParams;
 
-using SpectatorCache = std::map<Position, SpectatorHashSet>;
+struct SpectatorCacheEntry {
+	// Map::spectatorCacheGeneration when the result was computed
+	uint64_t generation = 0;
+	SpectatorHashSet spectators;
+};
+
+using SpectatorCache = phmap::flat_hash_map<Position, SpectatorCacheEntry>;
 
 class FrozenPathingConditionCall;
 
@@ -34,6 +41,10 @@ class FrozenPathingConditionCall;
 class Map : protected MapCache {
 public:
 	static uint32_t clean();
+	// Removes the cleanable items of a single tile, returns how many were removed
+	static uint32_t cleanTile(const std::shared_ptr<Tile> &tile);
+
+	using MapCache::evictUntouchedTiles;
 
 	std::filesystem::path getPath() const {
 		return path;
@@ -53,6 +64,17 @@ public:
 	 * \returns true if the main map was loaded successfully
 	 */
 	void loadMap(const std::string &identifier, bool mainMap = false, bool loadHouses = false, bool loadMonsters = false, bool loadNpcs = false, const Position &pos = Position());
+	/**
+	 * First half of loadMap: reads the tiles, towns and waypoints.
+	 * Only needs the item types, so it may run on another thread while scripts load,
+	 * as long as nothing else touches the map until it returns.
+	 */
+	void loadMapTiles(const std::string &identifier, bool mainMap, const Position &pos = Position());
+	/**
+	 * Second half of loadMap: lua items, spawns, houses and npcs.
+	 * Game thread only, after the monster and npc scripts are loaded.
+	 */
+	void loadMapData(bool mainMap, bool loadHouses, bool loadMonsters, bool loadNpcs);
 	/**
 	 * Load the custom map
 	 * \param identifier Is the map custom folder
@@ -97,8 +119,25 @@ public:
 	void moveCreature(const std::shared_ptr<Creature> &creature, const std::shared_ptr<Tile> &newTile, bool forceTeleport = false);
 
 	void getSpectators(SpectatorHashSet &spectators, const Position &centerPos, bool multifloor = false, bool onlyPlayers = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0);
+	// Appends in scan order and may add duplicates, prefer the Spectators query object (map/spectators.hpp)
+	void getSpectators(std::vector<std::shared_ptr<Creature>> &spectators, const Position &centerPos, bool multifloor = false, bool onlyPlayers = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0);
 
 	void clearSpectatorCache();
+	// creaturePos is one getSpectators(centerPos, multifloor) with the default ranges would accept
+	static bool isInSpectatorView(const Position &centerPos, const Position &creaturePos, bool multifloor);
+	/**
+	 * A creature entered or left the tile at pos. Only cached results
+	 * overlapping its sector are dropped, the rest of the cache survives.
+	 */
+	void invalidateSpectatorCache(const Position &pos);
+
+	/**
+	 * Sector activity, a sector being a QTreeLeafNode.
+	 * Players mark every sector in view as active for MAP_SECTOR_ACTIVITY_TIME,
+	 * creatures in sectors nobody marked can sleep and no player can be in view of them.
+	 */
+	void markActiveSectors(const Position &pos);
+	bool isSectorActive(const Position &pos);
 
 	/**
 	 * Checks if you can throw an object to that position
@@ -122,16 +161,59 @@ public:
 	bool isSightClear(const Position &fromPos, const Position &toPos, bool floorCheck);
 	bool checkSightLine(const Position &fromPos, const Position &toPos);
 
+	/**
+	 * Tile state checks on the floor bitmaps, without copying the tile or
+	 * scanning its items. Tiles still in the tile cache are parsed first.
+	 */
+	bool hasSectorFlag(const Position &pos, SectorFlag_t flag);
+	// A tile exists and no item on it blocks solid
+	bool isSectorWalkable(const Position &pos);
+	// Row major grid of width x height tiles from topLeft, 1 where the tile has the given state
+	void getSectorFlagGrid(const Position &topLeft, uint32_t width, uint32_t height, SectorFlag_t flag, std::vector<uint8_t> &grid);
+
+	/**
+	 * isSightClear on a grid from getSectorFlagGrid, with both ends inside it.
+	 * Walks the same two rays as checkSightLine, so the results match.
+	 */
+	static bool isSightClear(const std::vector<uint8_t> &blocked, uint32_t width, int32_t fromX, int32_t fromY, int32_t toX, int32_t toY);
+	static bool checkSightLine(const std::vector<uint8_t> &blocked, uint32_t width, int32_t fromX, int32_t fromY, int32_t toX, int32_t toY);
+
 	std::shared_ptr<Tile> canWalkTo(const std::shared_ptr<Creature> &creature, const Position &pos);
 
 	bool getPathMatching(const std::shared_ptr<Creature> &creature, std::forward_list<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp);
 
 	bool getPathMatching(const Position &startPos, std::forward_list<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp);
 
-	std::map<std::string, Position> waypoints;
+	/**
+	 * Chase path read from the flow field shared by every monster of the same
+	 * walk class going for targetPos. The field is built once enough monsters
+	 * asked for it, until then (or when the first step is blocked) this returns false.
+	 */
+	bool getFlowFieldPath(const std::shared_ptr<Monster> &monster, const Position &targetPos, std::forward_list<Direction> &dirList);
+	// Drops the flow fields covering pos, called whenever the flags of its tile change
+	void invalidateFlowFields(const Position &pos);
+
+	/**
+	 * Batch of mass item changes (clean, lua items, scripts), see TileUpdateBatch.
+	 * While one is open tiles skip the per item packets and flow field drops, they
+	 * only record their position. When the outermost batch ends every changed tile
+	 * drops its flow fields once and is sent as a single tile refresh to each player in view.
+	 */
+	void beginTileUpdateBatch() {
+		++tileUpdateBatchDepth;
+	}
+	void endTileUpdateBatch();
+	[[nodiscard]] bool isBatchingTileUpdates() const {
+		return tileUpdateBatchDepth > 0;
+	}
+	void addBatchedTile(const Position &pos) {
+		batchedTiles.emplace(pos);
+	}
+
+	phmap::flat_hash_map<std::string, Position> waypoints;
 
 	QTreeLeafNode* getQTNode(uint16_t x, uint16_t y) {
-		return QTreeNode::getLeafStatic<QTreeLeafNode*, QTreeNode*>(&root, x, y);
+		return getLeaf(x, y);
 	}
 
 	// Storage made by "loadFromXML" of houses, monsters and npcs for main map
@@ -156,6 +238,32 @@ private:
 
 	SpectatorCache spectatorCache;
 	SpectatorCache playersSpectatorCache;
+	uint64_t spectatorCacheGeneration = 0;
+
+	// Checks that no sector in view of centerPos changed since the given generation
+	bool isSpectatorCacheValid(const Position &centerPos, uint64_t generation) const;
+	// Lookup of a cached full view, multifloor result, stale entries are erased
+	const SpectatorHashSet* findCachedSpectators(SpectatorCache &cache, const Position &centerPos);
+	static void getMultifloorRange(const Position &centerPos, int32_t &minRangeZ, int32_t &maxRangeZ);
+
+	// Floor holding pos with its bitmaps up to date for that tile, nullptr if there is none
+	const Floor* getSectorFloor(const Position &pos);
+
+	struct FlowFieldEntry {
+		int64_t createdAt = 0;
+		uint16_t requests = 0;
+		std::unique_ptr<FlowField> field;
+	};
+
+	// Keyed by target position and walk class
+	phmap::flat_hash_map<uint64_t, FlowFieldEntry> flowFields;
+	// Keys of the fields overlapping each region and floor, stale keys are pruned on lookup
+	phmap::flat_hash_map<uint64_t, std::vector<uint64_t>> flowFieldRegions;
+
+	void resetFlowFields(const Position &pos);
+
+	uint32_t tileUpdateBatchDepth = 0;
+	phmap::flat_hash_set<Position> batchedTiles;
 
 	std::filesystem::path path;
 	std::string monsterfile;
@@ -166,9 +274,31 @@ private:
 	uint32_t height = 0;
 
 	// Actually scans the map for spectators
-	void getSpectatorsInternal(SpectatorHashSet &spectators, const Position &centerPos, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY, int32_t minRangeZ, int32_t maxRangeZ, bool onlyPlayers) const;
+	template <typename Container>
+	void getSpectatorsInternal(Container &spectators, const Position &centerPos, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY, int32_t minRangeZ, int32_t maxRangeZ, bool onlyPlayers) const;
 
 	friend class Game;
 	friend class IOMap;
 	friend class MapCache;
+	friend class MapSnapshot;
+	friend class WorldSnapshot;
+};
+
+// Scope of a Map tile update batch, batches may nest
+class TileUpdateBatch {
+public:
+	explicit TileUpdateBatch(Map &map) :
+		map(map) {
+		map.beginTileUpdateBatch();
+	}
+	~TileUpdateBatch() {
+		map.endTileUpdateBatch();
+	}
+
+	// Ensures that we don't accidentally copy it
+	TileUpdateBatch(const TileUpdateBatch &) = delete;
+	TileUpdateBatch operator=(const TileUpdateBatch &) = delete;
+
+private:
+	Map &map;
 };
@@ -21,3 +21,24 @@ static constexpr int8_t MAP_LAYER_VIEW_LIMIT = 2;
 static constexpr int32_t FLOOR_BITS = 3;
 static constexpr int32_t FLOOR_SIZE = (1 << FLOOR_BITS);
 static constexpr int32_t FLOOR_MASK = (FLOOR_SIZE - 1);
+
+// Cached spectator results per cache, dropped all at once when full
+static constexpr size_t MAP_MAX_SPECTATOR_CACHE_ENTRIES = 1 << 16;
+
+// Regions of 4x4 sectors (32x32 tiles), the unit the creature checks are grouped by
+static constexpr int32_t MAP_REGION_BITS = FLOOR_BITS + 2;
+
+// How long a sector stays active after a player was in view of it
+static constexpr int32_t MAP_SECTOR_ACTIVITY_TIME = 3000;
+
+// Monsters that must chase the same target before they share a flow field
+static constexpr uint16_t MAP_FLOW_FIELD_MIN_CHASERS = 4;
+// Flow fields ignore creatures, so they are rebuilt at least this often (ms)
+static constexpr int64_t MAP_FLOW_FIELD_LIFETIME = 1000;
+static constexpr size_t MAP_MAX_FLOW_FIELDS = 256;
+
+// Materialized tiles checked by each eviction pass
+static constexpr size_t MAP_TILE_EVICTION_BATCH = 4096;
+
+// Time between two slices of an incremental map clean (ms)
+static constexpr uint32_t MAP_CLEAN_SLICE_INTERVAL = 100;
@@ -23,19 +23,66 @@
 #include "io/iomap.hpp"
 
 static phmap::flat_hash_map<size_t, std::shared_ptr<BasicItem>> items;
-static phmap::flat_hash_map<size_t, std::shared_ptr<BasicTile>> tiles;
-
+// Unique tiles, floors refer to them by index + 1
+static std::vector<BasicTile> tileArena;
+static phmap::flat_hash_map<size_t, uint32_t> tileIndexes;
+
+// Attributes an item built from the cache may carry, any other one was set after the tile was loaded
+static constexpr auto EVICTABLE_ITEM_ATTRIBUTES = std::to_array<ItemAttribute_t>({
+	ItemAttribute_t::ACTIONID,
+	ItemAttribute_t::TEXT,
+	ItemAttribute_t::CHARGES,
+	ItemAttribute_t::FLUIDTYPE,
+	ItemAttribute_t::DOORID,
+	ItemAttribute_t::DURATION,
+});
+
+// Container contents are shared too, innermost first
 std::shared_ptr<BasicItem> static_tryGetItemFromCache(const std::shared_ptr<BasicItem> &ref) {
-	return ref ? items.try_emplace(ref->hash(), ref).first->second : nullptr;
+	if (!ref) {
+		return nullptr;
+	}
+
+	for (auto &item : ref->items) {
+		item = static_tryGetItemFromCache(item);
+	}
+	return items.try_emplace(ref->hash(), ref).first->second;
 }
 
-std::shared_ptr<BasicTile> static_tryGetTileFromCache(const std::shared_ptr<BasicTile> &ref) {
-	return ref ? tiles.try_emplace(ref->hash(), ref).first->second : nullptr;
+uint32_t static_tryGetTileFromCache(const std::shared_ptr<BasicTile> &ref) {
+	if (!ref) {
+		return 0;
+	}
+
+	const auto [it, inserted] = tileIndexes.try_emplace(ref->hash(), static_cast<uint32_t>(tileArena.size() + 1));
+	if (inserted) {
+		tileArena.emplace_back(*ref);
+	}
+	return it->second;
 }
 
 void MapCache::flush() {
 	items.clear();
-	tiles.clear();
+	// The arena stays, floors still refer to it
+	tileIndexes.clear();
+}
+
+void MapCache::logCacheUsage() const {
+	size_t itemListBytes = 0;
+	for (const auto &tile : tileArena) {
+		itemListBytes += tile.items.capacity() * sizeof(std::shared_ptr<BasicItem>);
+	}
+
+	constexpr size_t cells = FLOOR_SIZE * FLOOR_SIZE;
+	const size_t currentBytes = floorCount * sizeof(Floor) + tileArena.capacity() * sizeof(BasicTile) + itemListBytes;
+	// A pair of shared pointers per cell instead of an index, and every unique tile in its own allocation with a control block
+	const size_t pairLayoutFloorBytes = sizeof(Floor) - sizeof(void*) + cells * (2 * sizeof(std::shared_ptr<BasicTile>) - sizeof(uint32_t));
+	const size_t pairLayoutBytes = floorCount * pairLayoutFloorBytes + tileArena.size() * (sizeof(BasicTile) + 2 * sizeof(void*)) + itemListBytes;
+
+	g_logger().info(
+		"Map cache: {} cached positions share {} unique tiles over {} floors, {} KB (pointer pair layout: {} KB)",
+		cachedTileCount, tileArena.size(), floorCount, currentBytes / 1024, pairLayoutBytes / 1024
+	);
 }
 
 void MapCache::parseItemAttr(const std::shared_ptr<BasicItem> &BasicItem, std::shared_ptr<Item> item) {
@@ -101,18 +148,20 @@ std::shared_ptr<Item> MapCache::createItem(const std::shared_ptr<BasicItem> &Bas
 }
 
 std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::unique_ptr<Floor> &floor, uint16_t x, uint16_t y) {
-	const auto cachedTile = floor->getTileCache(x, y);
-	if (!cachedTile) {
+	if (!floor->isTileCachePending(x, y)) {
 		return floor->getTile(x, y);
 	}
 
+	const BasicTile* cachedTile = &tileArena[floor->getTileCacheIndex(x, y) - 1];
+
 	const uint8_t z = floor->getZ();
 
 	auto map = static_cast<Map*>(this);
 
 	std::shared_ptr<Tile> tile = nullptr;
+	std::shared_ptr<House> house = nullptr;
 	if (cachedTile->isHouse()) {
-		const auto house = map->houses.getHouse(cachedTile->houseId);
+		house = map->houses.getHouse(cachedTile->houseId);
 		tile = std::make_shared<HouseTile>(x, y, z, house);
 		house->addTile(std::static_pointer_cast<HouseTile>(tile));
 	} else if (cachedTile->isStatic) {
@@ -135,24 +184,173 @@ std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::unique_ptr<F
 
 	floor->setTile(x, y, tile);
 
-	// Remove Tile from cache
-	floor->setTileCache(x, y, nullptr);
+	// The cache entry stays, the tile may be evicted back to it
+	floor->setTileCachePending(x, y, false);
+
+	if (house) {
+		// The first tile built loads the saved items of the whole house, this one included
+		house->loadPendingItems();
+	} else if (const size_t stateHash = hashTileState(tile)) {
+		materializedTiles.push_back({ x, y, z, stateHash });
+	}
 
 	return tile;
 }
 
-void MapCache::setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &newTile) {
+/**
+ * Live state of an item as a BasicItem, or nullptr when the item holds state
+ * the cache cannot rebuild: another reference to it (decay, scripts, ...),
+ * unique id, custom attributes or attributes a map item cannot have.
+ * The owning container or tile holds the only expected reference.
+ */
+static std::shared_ptr<BasicItem> snapshotItem(const std::shared_ptr<Item> &item, long references = 1) {
+	if (item.use_count() > references || item->hasCustomAttribute() || !item->hasOnlyAttributes(EVICTABLE_ITEM_ATTRIBUTES)) {
+		return nullptr;
+	}
+
+	const auto basicItem = std::make_shared<BasicItem>();
+	basicItem->id = item->getID();
+	basicItem->charges = item->getSubType();
+	basicItem->actionId = item->getAttribute<uint16_t>(ItemAttribute_t::ACTIONID);
+	basicItem->text = item->getAttribute<std::string>(ItemAttribute_t::TEXT);
+
+	if (const auto teleport = item->getTeleport()) {
+		const auto &dest = teleport->getDestPos();
+		basicItem->destX = dest.x;
+		basicItem->destY = dest.y;
+		basicItem->destZ = dest.z;
+	}
+
+	if (const auto door = item->getDoor()) {
+		basicItem->doorOrDepotId = door->getDoorId();
+	}
+
+	if (const auto container = item->getContainer()) {
+		if (const auto depotLocker = container->getDepotLocker()) {
+			basicItem->doorOrDepotId = depotLocker->getDepotId();
+		}
+
+		for (const auto &itemInside : container->getItemList()) {
+			auto basicItemInside = snapshotItem(itemInside);
+			if (!basicItemInside) {
+				return nullptr;
+			}
+			basicItem->items.emplace_back(std::move(basicItemInside));
+		}
+	}
+
+	return basicItem;
+}
+
+size_t MapCache::hashTileState(const std::shared_ptr<Tile> &tile) {
+	if (tile->getHouse() || tile->getCreatureCount() != 0) {
+		return 0;
+	}
+
+	BasicTile basicTile;
+	basicTile.flags = tile->getFlags();
+
+	if (const auto ground = tile->getGround()) {
+		// The tile and the local copy
+		basicTile.ground = snapshotItem(ground, 2);
+		if (!basicTile.ground) {
+			return 0;
+		}
+	}
+
+	if (const auto items = tile->getItemList()) {
+		for (const auto &item : *items) {
+			auto basicItem = snapshotItem(item);
+			if (!basicItem) {
+				return 0;
+			}
+			basicTile.items.emplace_back(std::move(basicItem));
+		}
+	}
+
+	return basicTile.hash();
+}
+
+size_t MapCache::evictUntouchedTiles(size_t budget) {
+	size_t evicted = 0;
+	for (size_t checked = 0; checked < budget && !materializedTiles.empty(); ++checked) {
+		if (evictionCursor >= materializedTiles.size()) {
+			evictionCursor = 0;
+		}
+
+		const auto [x, y, z, stateHash] = materializedTiles[evictionCursor];
+		const auto &floor = getLeaf(x, y)->getFloor(z);
+		auto tile = floor->getTile(x, y);
+		if (tile) {
+			// The floor and the local copy, anything else (zones, cleaning, scripts) still uses the tile
+			if (tile.use_count() > 2 || hashTileState(tile) != stateHash) {
+				++evictionCursor;
+				continue;
+			}
+
+			tile.reset();
+			floor->setTile(x, y, nullptr);
+			floor->setTileCachePending(x, y, true);
+			++evicted;
+		}
+
+		materializedTiles[evictionCursor] = materializedTiles.back();
+		materializedTiles.pop_back();
+	}
+	return evicted;
+}
+
+void Floor::setTile(uint16_t x, uint16_t y, std::shared_ptr<Tile> tile) {
+	const uint64_t bit = getTileBit(x, y);
+	tileMask = tile ? tileMask | bit : tileMask & ~bit;
+	setSectorFlags(x, y, tile ? tile->getFlags() : 0);
+
+	if (!tiles) {
+		if (!tile) {
+			return;
+		}
+		tiles = std::make_unique<std::array<std::shared_ptr<Tile>, FLOOR_SIZE * FLOOR_SIZE>>();
+	}
+	(*tiles)[getCellIndex(x, y)] = std::move(tile);
+
+	if (tileMask == 0) {
+		tiles.reset();
+	}
+}
+
+uint32_t MapCache::setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &newTile) {
 	if (z >= MAP_MAX_LAYERS) {
 		g_logger().error("Attempt to set tile on invalid coordinate: {}", Position(x, y, z).toString());
-		return;
+		return 0;
 	}
 
-	const auto tile = static_tryGetTileFromCache(newTile);
-	if (const auto leaf = QTreeNode::getLeafStatic<QTreeLeafNode*, QTreeNode*>(&root, x, y)) {
-		leaf->createFloor(z)->setTileCache(x, y, tile);
-	} else {
-		root.getBestLeaf(x, y, 15)->createFloor(z)->setTileCache(x, y, tile);
+	const uint32_t index = static_tryGetTileFromCache(newTile);
+	if (index) {
+		++cachedTileCount;
+		getOrCreateFloor(x, y, z)->setTileCacheIndex(x, y, index);
+	}
+	return index;
+}
+
+const BasicTile &MapCache::getCachedTile(uint32_t index) {
+	return tileArena[index - 1];
+}
+
+uint32_t MapCache::getPendingHouseId(uint16_t x, uint16_t y, uint8_t z) const {
+	if (z >= MAP_MAX_LAYERS) {
+		return 0;
+	}
+
+	const auto leaf = getLeaf(x, y);
+	if (!leaf) {
+		return 0;
+	}
+
+	const auto &floor = leaf->getFloor(z);
+	if (!floor || !floor->isTileCachePending(x, y)) {
+		return 0;
 	}
+	return getCachedTile(floor->getTileCacheIndex(x, y)).houseId;
 }
 
 std::shared_ptr<BasicItem> MapCache::tryReplaceItemFromCache(const std::shared_ptr<BasicItem> &ref) {
@@ -221,7 +419,8 @@ bool BasicItem::unserializeItemNode(FileStream &stream, uint16_t x, uint16_t y,
 			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Failed to load item.", x, y, z));
 		}
 
-		items.emplace_back(static_tryGetItemFromCache(item));
+		// Replaced from the cache along with the top item, see static_tryGetItemFromCache
+		items.emplace_back(item);
 
 		if (!stream.endNode()) {
 			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
@@ -11,6 +11,7 @@
 
 #include "items/items_definitions.hpp"
 #include "utils/qtreenode.hpp"
+#include "utils/sector_index.hpp"
 
 class Map;
 class Tile;
@@ -81,32 +82,87 @@ private:
 
 #pragma pack()
 
+/**
+ * 8x8 tiles of one floor. Cached tiles are 32-bit indexes into the MapCache
+ * tile arena, and the array of materialized tiles is only allocated once the
+ * first Tile of the floor is created.
+ */
 struct Floor {
 	explicit Floor(uint8_t z) :
 		z(z) {};
 
 	std::shared_ptr<Tile> getTile(uint16_t x, uint16_t y) const {
-		return tiles[x & FLOOR_MASK][y & FLOOR_MASK].first;
+		return tiles ? (*tiles)[getCellIndex(x, y)] : nullptr;
+	}
+
+	void setTile(uint16_t x, uint16_t y, std::shared_ptr<Tile> tile);
+
+	// Index + 1 of the tile in the MapCache arena, 0 when it is not cached. It is kept once the tile is materialized, so the tile can be evicted back to it
+	uint32_t getTileCacheIndex(uint16_t x, uint16_t y) const {
+		return cacheIndexes[getCellIndex(x, y)];
 	}
 
-	void setTile(uint16_t x, uint16_t y, std::shared_ptr<Tile> tile) {
-		tiles[x & FLOOR_MASK][y & FLOOR_MASK].first = tile;
+	void setTileCacheIndex(uint16_t x, uint16_t y, uint32_t index) {
+		cacheIndexes[getCellIndex(x, y)] = index;
+		setTileCachePending(x, y, index != 0);
 	}
 
-	std::shared_ptr<BasicTile> getTileCache(uint16_t x, uint16_t y) const {
-		return tiles[x & FLOOR_MASK][y & FLOOR_MASK].second;
+	// Whether the tile still has to be built from its cache entry
+	bool isTileCachePending(uint16_t x, uint16_t y) const {
+		return pendingMask & getTileBit(x, y);
 	}
 
-	void setTileCache(uint16_t x, uint16_t y, const std::shared_ptr<BasicTile> &newTile) {
-		tiles[x & FLOOR_MASK][y & FLOOR_MASK].second = newTile;
+	void setTileCachePending(uint16_t x, uint16_t y, bool pending) {
+		pendingMask = pending ? pendingMask | getTileBit(x, y) : pendingMask & ~getTileBit(x, y);
 	}
 
 	uint8_t getZ() const {
 		return z;
 	}
 
+	static size_t getCellIndex(uint16_t x, uint16_t y) {
+		return ((y & FLOOR_MASK) << FLOOR_BITS) | (x & FLOOR_MASK);
+	}
+
+	// Bit of a tile in every mask of its floor
+	static uint64_t getTileBit(uint16_t x, uint16_t y) {
+		return uint64_t { 1 } << getCellIndex(x, y);
+	}
+
+	void setSectorFlags(uint16_t x, uint16_t y, uint32_t tileFlags) {
+		const uint64_t bit = getTileBit(x, y);
+		for (size_t flag = 0; flag < SECTOR_FLAG_COUNT; ++flag) {
+			flagMasks[flag] = (tileFlags & SECTOR_FLAG_TILESTATES[flag]) ? flagMasks[flag] | bit : flagMasks[flag] & ~bit;
+		}
+	}
+
+	/**
+	 * Tiles of this floor in the given state. Tiles still only in the tile
+	 * cache have no items parsed yet, they are set in getPendingMask() instead.
+	 */
+	uint64_t getFlagMask(SectorFlag_t flag) const {
+		return flagMasks[flag];
+	}
+
+	uint64_t getTileMask() const {
+		return tileMask;
+	}
+
+	uint64_t getPendingMask() const {
+		return pendingMask;
+	}
+
+	// Parsed tiles without any item blocking solid
+	uint64_t getWalkableMask() const {
+		return tileMask & ~flagMasks[SECTOR_FLAG_BLOCKSOLID];
+	}
+
 private:
-	std::pair<std::shared_ptr<Tile>, std::shared_ptr<BasicTile>> tiles[FLOOR_SIZE][FLOOR_SIZE] = {};
+	std::unique_ptr<std::array<std::shared_ptr<Tile>, FLOOR_SIZE * FLOOR_SIZE>> tiles;
+	std::array<uint32_t, FLOOR_SIZE * FLOOR_SIZE> cacheIndexes {};
+	std::array<uint64_t, SECTOR_FLAG_COUNT> flagMasks {};
+	uint64_t tileMask = 0;
+	uint64_t pendingMask = 0;
 	uint8_t z { 0 };
 };
 
@@ -114,18 +170,78 @@ class MapCache {
 public:
 	virtual ~MapCache() = default;
 
-	void setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &BasicTile);
+	// Returns the index + 1 of the tile in the cache arena, 0 when it was not cached
+	uint32_t setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &BasicTile);
+	// Arena entry of an index given by setBasicTile
+	static const BasicTile &getCachedTile(uint32_t index);
+	// House of a tile not built from the cache yet, 0 when it is built or not a house tile
+	uint32_t getPendingHouseId(uint16_t x, uint16_t y, uint8_t z) const;
 
 	std::shared_ptr<BasicItem> tryReplaceItemFromCache(const std::shared_ptr<BasicItem> &ref);
 
 	void flush();
 
+	// Logs how much the loaded tile cache takes, next to what one pointer pair per cell used to
+	void logCacheUsage() const;
+
+	/**
+	 * Checks up to budget materialized tiles, round robin, and turns the ones
+	 * nothing changed or holds a reference to back into their cache entry.
+	 * Returns how many tiles were released.
+	 */
+	size_t evictUntouchedTiles(size_t budget);
+
 protected:
 	std::shared_ptr<Tile> getOrCreateTileFromCache(const std::unique_ptr<Floor> &floor, uint16_t x, uint16_t y);
 
+	QTreeLeafNode* getLeaf(uint16_t x, uint16_t y) {
+		return sectorIndexEnabled ? sectorIndex.get(x, y) : QTreeNode::getLeafStatic<QTreeLeafNode*, QTreeNode*>(&root, x, y);
+	}
+
+	const QTreeLeafNode* getLeaf(uint16_t x, uint16_t y) const {
+		return sectorIndexEnabled ? sectorIndex.get(x, y) : QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, x, y);
+	}
+
+	// Every leaf must be created here, so the sector index stays in sync with the tree
+	QTreeLeafNode* getOrCreateLeaf(uint16_t x, uint16_t y) {
+		if (const auto leaf = getLeaf(x, y)) {
+			return leaf;
+		}
+
+		const auto leaf = root.getBestLeaf(x, y, 15);
+		sectorIndex.set(x, y, leaf);
+		return leaf;
+	}
+
+	const std::unique_ptr<Floor> &getOrCreateFloor(uint16_t x, uint16_t y, uint8_t z) {
+		const auto leaf = getOrCreateLeaf(x, y);
+		if (!leaf->getFloor(z)) {
+			++floorCount;
+		}
+		return leaf->createFloor(z);
+	}
+
+	struct MaterializedTile {
+		uint16_t x, y;
+		uint8_t z;
+		// Hash of the tile state right after it was built from the cache
+		size_t stateHash;
+	};
+
 	QTreeNode root;
+	// Tiles built from the cache that could be evicted back to it
+	std::vector<MaterializedTile> materializedTiles;
+	size_t evictionCursor = 0;
+	size_t floorCount = 0;
+	size_t cachedTileCount = 0;
+	// Always kept up to date, sectorIndexEnabled only picks which one lookups use
+	SectorIndex sectorIndex;
+	bool sectorIndexEnabled = false;
 
 private:
+	// Hash of the live tile state as a BasicTile, 0 when the tile cannot be evicted
+	static size_t hashTileState(const std::shared_ptr<Tile> &tile);
+
 	void parseItemAttr(const std::shared_ptr<BasicItem> &BasicItem, std::shared_ptr<Item> item);
 	std::shared_ptr<Item> createItem(const std::shared_ptr<BasicItem> &BasicItem, Position position);
 };
@@ -0,0 +1,72 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "map/spectators.hpp"
+#include "creatures/creature.hpp"
+#include "game/game.hpp"
+
+namespace {
+	using SpectatorBuffer = std::vector<std::shared_ptr<Creature>>;
+
+	// Buffers are kept with their capacity, but a single huge query should not pin its memory forever
+	constexpr size_t MAX_POOLED_CAPACITY = 1024;
+
+	std::vector<std::unique_ptr<SpectatorBuffer>> &getBufferPool() {
+		thread_local std::vector<std::unique_ptr<SpectatorBuffer>> pool;
+		return pool;
+	}
+}
+
+Spectators::Spectators() {
+	auto &pool = getBufferPool();
+	if (pool.empty()) {
+		creatures = new SpectatorBuffer();
+	} else {
+		creatures = pool.back().release();
+		pool.pop_back();
+	}
+}
+
+Spectators::~Spectators() {
+	creatures->clear();
+	if (creatures->capacity() > MAX_POOLED_CAPACITY) {
+		creatures->shrink_to_fit();
+	}
+	getBufferPool().emplace_back(creatures);
+}
+
+Spectators &Spectators::find(const Position &centerPos, bool multifloor /*= false*/, bool onlyPlayers /*= false*/, int32_t minRangeX /*= 0*/, int32_t maxRangeX /*= 0*/, int32_t minRangeY /*= 0*/, int32_t maxRangeY /*= 0*/) {
+	g_game().map.getSpectators(*creatures, centerPos, multifloor, onlyPlayers, minRangeX, maxRangeX, minRangeY, maxRangeY);
+
+	std::ranges::sort(*creatures, std::less {}, [](const std::shared_ptr<Creature> &creature) { return creature->getID(); });
+	const auto [first, last] = std::ranges::unique(*creatures);
+	creatures->erase(first, last);
+	return *this;
+}
+
+Spectators &Spectators::onlyPlayers() {
+	return filter([](const std::shared_ptr<Creature> &creature) { return creature->getPlayer() != nullptr; });
+}
+
+Spectators &Spectators::onlyMonsters() {
+	return filter([](const std::shared_ptr<Creature> &creature) { return creature->getMonster() != nullptr; });
+}
+
+Spectators &Spectators::onFloor(uint8_t z) {
+	return filter([z](const std::shared_ptr<Creature> &creature) { return creature->getPosition().z == z; });
+}
+
+Spectators &Spectators::withinRange(const Position &centerPos, int32_t rangeX, int32_t rangeY) {
+	return filter([&centerPos, rangeX, rangeY](const std::shared_ptr<Creature> &creature) {
+		const Position &pos = creature->getPosition();
+		return Position::getDistanceX(centerPos, pos) <= rangeX && Position::getDistanceY(centerPos, pos) <= rangeY;
+	});
+}
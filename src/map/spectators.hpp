@@ -0,0 +1,67 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class Creature;
+
+/**
+ * Spectator query without a hash set per call.
+ * Results live in a vector borrowed from a per thread pool and handed back
+ * on destruction, so once warmed up a query does not allocate. Queries can
+ * be nested, each one borrows its own vector.
+ *
+ * Results are unique and ordered by creature id, so iterating them is
+ * deterministic. Filters narrow the current result in place:
+ *
+ *	Spectators spectators;
+ *	for (const auto &spectator : spectators.find(pos, true).onlyPlayers()) { ... }
+ */
+class Spectators {
+public:
+	Spectators();
+	~Spectators();
+
+	// Ensures that we don't accidentally copy it
+	Spectators(const Spectators &) = delete;
+	Spectators &operator=(const Spectators &) = delete;
+
+	// Same parameters as Map::getSpectators, the results are merged with the current ones
+	Spectators &find(const Position &centerPos, bool multifloor = false, bool onlyPlayers = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0);
+
+	template <typename F>
+	Spectators &filter(F &&predicate) {
+		std::erase_if(*creatures, [&predicate](const std::shared_ptr<Creature> &creature) { return !predicate(creature); });
+		return *this;
+	}
+
+	Spectators &onlyPlayers();
+	Spectators &onlyMonsters();
+	Spectators &onFloor(uint8_t z);
+	Spectators &withinRange(const Position &centerPos, int32_t rangeX, int32_t rangeY);
+
+	[[nodiscard]] auto begin() const {
+		return creatures->cbegin();
+	}
+	[[nodiscard]] auto end() const {
+		return creatures->cend();
+	}
+	[[nodiscard]] size_t size() const {
+		return creatures->size();
+	}
+	[[nodiscard]] bool empty() const {
+		return creatures->empty();
+	}
+	[[nodiscard]] std::span<const std::shared_ptr<Creature>> data() const {
+		return *creatures;
+	}
+
+private:
+	std::vector<std::shared_ptr<Creature>>* creatures;
+};
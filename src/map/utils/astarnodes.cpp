@@ -13,18 +13,35 @@
 #include "creatures/monsters/monster.hpp"
 #include "creatures/combat/combat.hpp"
 
-AStarNodes::AStarNodes(uint32_t x, uint32_t y) :
-	nodes(), openNodes() {
-	curNode = 1;
+namespace {
+	// Lowest f on top, ties go to the oldest node like the former linear scan did
+	constexpr auto openEntryGreater = [](const auto &lhs, const auto &rhs) {
+		return lhs.f > rhs.f || (lhs.f == rhs.f && lhs.index > rhs.index);
+	};
+}
+
+AStarNodes &AStarNodes::getThreadInstance(uint32_t x, uint32_t y) {
+	thread_local AStarNodes nodes;
+	nodes.reset(x, y);
+	return nodes;
+}
+
+void AStarNodes::reset(uint32_t x, uint32_t y) {
+	if (++stamp == 0) {
+		// Stamps wrapped around, slots of old searches would look valid again
+		nodeTable.fill({});
+		stamp = 1;
+	}
+
+	openList.clear();
+	curNode = 0;
 	closedNodes = 0;
-	openNodes[0] = true;
-
-	AStarNode &startNode = nodes[0];
-	startNode.parent = nullptr;
-	startNode.x = x;
-	startNode.y = y;
-	startNode.f = 0;
-	nodeTable[(x << 16) | y] = nodes;
+	createOpenNode(nullptr, x, y, 0);
+}
+
+void AStarNodes::pushOpen(size_t index) {
+	openList.push_back({ nodes[index].f, static_cast<uint16_t>(index) });
+	std::ranges::push_heap(openList, openEntryGreater);
 }
 
 AStarNode* AStarNodes::createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_fast32_t f) {
@@ -36,30 +53,32 @@ AStarNode* AStarNodes::createOpenNode(AStarNode* parent, uint32_t x, uint32_t y,
 	openNodes[retNode] = true;
 
 	AStarNode* node = nodes + retNode;
-	nodeTable[(x << 16) | y] = node;
 	node->parent = parent;
 	node->x = x;
 	node->y = y;
 	node->f = f;
+
+	const uint32_t key = (x << 16) | y;
+	uint32_t slot = getSlot(key);
+	while (nodeTable[slot].stamp == stamp) {
+		slot = (slot + 1) & (NODE_TABLE_SIZE - 1);
+	}
+	nodeTable[slot] = { stamp, key, static_cast<uint16_t>(retNode) };
+
+	pushOpen(retNode);
 	return node;
 }
 
 AStarNode* AStarNodes::getBestNode() {
-	if (curNode == 0) {
-		return nullptr;
-	}
-
-	int32_t best_node_f = std::numeric_limits<int32_t>::max();
-	int32_t best_node = -1;
-	for (size_t i = 0; i < curNode; i++) {
-		if (openNodes[i] && nodes[i].f < best_node_f) {
-			best_node_f = nodes[i].f;
-			best_node = i;
+	while (!openList.empty()) {
+		const auto &[f, index] = openList.front();
+		if (openNodes[index] && nodes[index].f == f) {
+			return nodes + index;
 		}
-	}
 
-	if (best_node >= 0) {
-		return nodes + best_node;
+		// Closed since, or improved and pushed again with a lower f
+		std::ranges::pop_heap(openList, openEntryGreater);
+		openList.pop_back();
 	}
 	return nullptr;
 }
@@ -78,6 +97,7 @@ void AStarNodes::openNode(const AStarNode* node) {
 		openNodes[index] = true;
 		--closedNodes;
 	}
+	pushOpen(index);
 }
 
 int_fast32_t AStarNodes::getClosedNodes() const {
@@ -85,11 +105,13 @@ int_fast32_t AStarNodes::getClosedNodes() const {
 }
 
 AStarNode* AStarNodes::getNodeByPosition(uint32_t x, uint32_t y) {
-	auto it = nodeTable.find((x << 16) | y);
-	if (it == nodeTable.end()) {
-		return nullptr;
+	const uint32_t key = (x << 16) | y;
+	for (uint32_t slot = getSlot(key); nodeTable[slot].stamp == stamp; slot = (slot + 1) & (NODE_TABLE_SIZE - 1)) {
+		if (nodeTable[slot].key == key) {
+			return nodes + nodeTable[slot].index;
+		}
 	}
-	return it->second;
+	return nullptr;
 }
 
 int_fast32_t AStarNodes::getMapWalkCost(AStarNode* node, const Position &neighborPos, bool preferDiagonal) {
@@ -19,9 +19,25 @@ struct AStarNode {
 	uint16_t x, y;
 };
 
+/**
+ * Node arena of a single A* search.
+ * The open list is a binary heap with lazy deletion: improving a node pushes
+ * a new entry and stale entries are dropped when they reach the top. Nodes are
+ * found by position through a flat open addressing table stamped per search,
+ * so reset() is O(1) and nothing is allocated once the thread has warmed up.
+ */
 class AStarNodes {
 public:
-	AStarNodes(uint32_t x, uint32_t y);
+	AStarNodes() = default;
+
+	// Ensures that we don't accidentally copy it
+	AStarNodes(const AStarNodes &) = delete;
+	AStarNodes operator=(const AStarNodes &) = delete;
+
+	// The calling thread's arena, reset to start a new search at the given position
+	static AStarNodes &getThreadInstance(uint32_t x, uint32_t y);
+
+	void reset(uint32_t x, uint32_t y);
 
 	AStarNode* createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_fast32_t f);
 	AStarNode* getBestNode();
@@ -33,15 +49,38 @@ public:
 	static int_fast32_t getMapWalkCost(AStarNode* node, const Position &neighborPos, bool preferDiagonal = false);
 	static int_fast32_t getTileWalkCost(const std::shared_ptr<Creature> &creature, std::shared_ptr<Tile> tile);
 
-private:
-	static constexpr int32_t MAX_NODES = 512;
 	static constexpr int32_t MAP_NORMALWALKCOST = 10;
 	static constexpr int32_t MAP_PREFERDIAGONALWALKCOST = 14;
 	static constexpr int32_t MAP_DIAGONALWALKCOST = 25;
 
-	AStarNode nodes[MAX_NODES];
-	bool openNodes[MAX_NODES];
-	phmap::flat_hash_map<uint32_t, AStarNode*> nodeTable;
-	size_t curNode;
-	int_fast32_t closedNodes;
+private:
+	static constexpr int32_t MAX_NODES = 512;
+	// Power of two, twice MAX_NODES so probing always finds a free slot quickly
+	static constexpr uint32_t NODE_TABLE_BITS = 10;
+	static constexpr uint32_t NODE_TABLE_SIZE = 1 << NODE_TABLE_BITS;
+
+	struct OpenEntry {
+		int_fast32_t f;
+		uint16_t index;
+	};
+
+	struct NodeSlot {
+		uint32_t stamp = 0;
+		uint32_t key = 0;
+		uint16_t index = 0;
+	};
+
+	static uint32_t getSlot(uint32_t key) {
+		return (key * 0x9E3779B1u) >> (32 - NODE_TABLE_BITS);
+	}
+
+	void pushOpen(size_t index);
+
+	AStarNode nodes[MAX_NODES] {};
+	bool openNodes[MAX_NODES] {};
+	std::vector<OpenEntry> openList;
+	std::array<NodeSlot, NODE_TABLE_SIZE> nodeTable {};
+	uint32_t stamp = 0;
+	size_t curNode = 0;
+	int_fast32_t closedNodes = 0;
 };
@@ -0,0 +1,140 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "map/utils/flow_field.hpp"
+#include "map/utils/astarnodes.hpp"
+#include "creatures/monsters/monster.hpp"
+
+namespace {
+	struct Step {
+		int32_t x, y;
+		Direction direction;
+	};
+
+	// Straight steps first, so ties are broken the same way for every monster
+	constexpr std::array<Step, 8> steps { {
+		{ -1, 0, DIRECTION_WEST },
+		{ 0, 1, DIRECTION_SOUTH },
+		{ 1, 0, DIRECTION_EAST },
+		{ 0, -1, DIRECTION_NORTH },
+		{ -1, -1, DIRECTION_NORTHWEST },
+		{ 1, -1, DIRECTION_NORTHEAST },
+		{ 1, 1, DIRECTION_SOUTHEAST },
+		{ -1, 1, DIRECTION_SOUTHWEST },
+	} };
+
+	// Same costs as monster A*, so both pick similar paths
+	constexpr int32_t getStepCost(const Step &step) {
+		return step.x != 0 && step.y != 0 ? AStarNodes::MAP_DIAGONALWALKCOST : AStarNodes::MAP_NORMALWALKCOST;
+	}
+
+	bool passesField(const std::shared_ptr<Monster> &monster, CombatType_t combatType) {
+		return monster->isImmune(combatType) || monster->canWalkOnFieldType(combatType) || monster->getIgnoreFieldDamage();
+	}
+}
+
+uint8_t FlowField::getWalkClass(const std::shared_ptr<Monster> &monster) {
+	uint8_t walkClass = 0;
+	if (monster->canPushItems()) {
+		walkClass |= WALKCLASS_PUSH_ITEMS;
+	}
+	if (passesField(monster, COMBAT_FIREDAMAGE)) {
+		walkClass |= WALKCLASS_PASS_FIRE;
+	}
+	if (passesField(monster, COMBAT_ENERGYDAMAGE)) {
+		walkClass |= WALKCLASS_PASS_ENERGY;
+	}
+	if (passesField(monster, COMBAT_EARTHDAMAGE)) {
+		walkClass |= WALKCLASS_PASS_EARTH;
+	}
+	return walkClass;
+}
+
+FlowField::FlowField(const Position &target, const TileCost &tileCost) :
+	target(target) {
+	costs.fill(UNREACHABLE);
+
+	using Entry = std::pair<uint16_t, Position>;
+	constexpr auto greater = [](const Entry &lhs, const Entry &rhs) { return lhs.first > rhs.first; };
+	std::vector<Entry> open;
+	open.reserve(SIZE * 4);
+
+	costs[getIndex(target.x, target.y)] = 0;
+	open.emplace_back(0, target);
+	while (!open.empty()) {
+		std::ranges::pop_heap(open, greater);
+		const auto [cost, pos] = open.back();
+		open.pop_back();
+		if (cost != costs[getIndex(pos.x, pos.y)]) {
+			continue;
+		}
+
+		for (const auto &step : steps) {
+			const Position next(pos.x + step.x, pos.y + step.y, pos.z);
+			if (!contains(next)) {
+				continue;
+			}
+
+			auto &nextCost = costs[getIndex(next.x, next.y)];
+			if (cost + getStepCost(step) >= nextCost) {
+				continue;
+			}
+
+			const auto extraCost = tileCost(next);
+			if (!extraCost) {
+				continue;
+			}
+
+			const auto newCost = static_cast<uint16_t>(std::min<int32_t>(cost + getStepCost(step) + *extraCost, UNREACHABLE - 1));
+			if (newCost >= nextCost) {
+				continue;
+			}
+
+			nextCost = newCost;
+			open.emplace_back(newCost, next);
+			std::ranges::push_heap(open, greater);
+		}
+	}
+}
+
+bool FlowField::getPath(const Position &startPos, std::forward_list<Direction> &dirList) const {
+	if (!contains(startPos)) {
+		return false;
+	}
+
+	std::vector<Direction> path;
+	Position pos = startPos;
+	// The monster's own tile may not be walkable for the field, only its neighbours matter
+	uint16_t cost = UNREACHABLE;
+	while (Position::getDistanceX(pos, target) > 1 || Position::getDistanceY(pos, target) > 1) {
+		const Step* best = nullptr;
+		for (const auto &step : steps) {
+			const uint16_t stepCost = getCost(Position(pos.x + step.x, pos.y + step.y, pos.z));
+			if (stepCost < cost) {
+				cost = stepCost;
+				best = &step;
+			}
+		}
+
+		if (!best) {
+			return false;
+		}
+
+		pos.x += best->x;
+		pos.y += best->y;
+		path.push_back(best->direction);
+	}
+
+	for (auto it = path.rbegin(); it != path.rend(); ++it) {
+		dirList.push_front(*it);
+	}
+	return !path.empty();
+}
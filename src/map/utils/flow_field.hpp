@@ -0,0 +1,66 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/movement/position.hpp"
+
+class Monster;
+
+/**
+ * Walk cost from every tile around a target back to it (a Dijkstra map).
+ * Monsters chasing the same target read their next steps from it instead of
+ * each running A*. The tiles are judged by the monster that built it, with
+ * the same check and costs as its A*, so the caller only has to validate
+ * the steps against the monster following it.
+ */
+class FlowField {
+public:
+	static constexpr int32_t RADIUS = 12;
+	static constexpr int32_t SIZE = RADIUS * 2 + 1;
+	static constexpr uint16_t UNREACHABLE = std::numeric_limits<uint16_t>::max();
+
+	// Monsters of the same walk class agree on every tile the flow field looks at
+	enum WalkClass_t : uint8_t {
+		WALKCLASS_PUSH_ITEMS = 1 << 0,
+		WALKCLASS_PASS_FIRE = 1 << 1,
+		WALKCLASS_PASS_ENERGY = 1 << 2,
+		WALKCLASS_PASS_EARTH = 1 << 3,
+	};
+
+	static uint8_t getWalkClass(const std::shared_ptr<Monster> &monster);
+
+	// Extra cost of walking onto the tile, std::nullopt when it cannot be walked
+	using TileCost = std::function<std::optional<int32_t>(const Position &)>;
+
+	FlowField(const Position &target, const TileCost &tileCost);
+
+	const Position &getTarget() const {
+		return target;
+	}
+
+	bool contains(const Position &pos) const {
+		return pos.z == target.z && Position::getDistanceX(pos, target) <= RADIUS && Position::getDistanceY(pos, target) <= RADIUS;
+	}
+
+	uint16_t getCost(const Position &pos) const {
+		return contains(pos) ? costs[getIndex(pos.x, pos.y)] : UNREACHABLE;
+	}
+
+	// Steps downhill from startPos until next to the target, false if it is unreachable
+	bool getPath(const Position &startPos, std::forward_list<Direction> &dirList) const;
+
+private:
+	size_t getIndex(int32_t x, int32_t y) const {
+		return static_cast<size_t>((y - target.y + RADIUS) * SIZE + (x - target.x + RADIUS));
+	}
+
+	Position target;
+	std::array<uint16_t, SIZE * SIZE> costs;
+};
@@ -71,24 +71,40 @@ QTreeLeafNode* QTreeNode::getBestLeaf(uint32_t x, uint32_t y, uint32_t level) {
 	return tempLeaf;
 }
 
-void QTreeLeafNode::addCreature(std::shared_ptr<Creature> c) {
+void QTreeLeafNode::addCreature(const std::shared_ptr<Creature> &c, uint8_t z) {
 	creature_list.push_back(c);
+	if (creatureFloorCount[z]++ == 0) {
+		creatureFloors |= 1 << z;
+	}
 
 	if (c->getPlayer()) {
 		player_list.push_back(c);
+		if (playerFloorCount[z]++ == 0) {
+			playerFloors |= 1 << z;
+		}
 	}
 }
 
-void QTreeLeafNode::removeCreature(std::shared_ptr<Creature> c) {
+void QTreeLeafNode::removeCreature(const std::shared_ptr<Creature> &c, uint8_t z) {
 	auto iter = std::find(creature_list.begin(), creature_list.end(), c);
 	assert(iter != creature_list.end());
 	*iter = creature_list.back();
 	creature_list.pop_back();
 
+	assert(creatureFloorCount[z] > 0);
+	if (--creatureFloorCount[z] == 0) {
+		creatureFloors &= ~(1 << z);
+	}
+
 	if (c->getPlayer()) {
 		iter = std::find(player_list.begin(), player_list.end(), c);
 		assert(iter != player_list.end());
 		*iter = player_list.back();
 		player_list.pop_back();
+
+		assert(playerFloorCount[z] > 0);
+		if (--playerFloorCount[z] == 0) {
+			playerFloors &= ~(1 << z);
+		}
 	}
 }
@@ -76,8 +76,17 @@ public:
 		return array[z];
 	}
 
-	void addCreature(std::shared_ptr<Creature> c);
-	void removeCreature(std::shared_ptr<Creature> c);
+	// The floor is given by the caller, the creature position may not be updated yet
+	void addCreature(const std::shared_ptr<Creature> &c, uint8_t z);
+	void removeCreature(const std::shared_ptr<Creature> &c, uint8_t z);
+
+	// Bit z is set when at least one creature (player) stands on floor z of this leaf
+	uint16_t getCreatureFloors() const {
+		return creatureFloors;
+	}
+	uint16_t getPlayerFloors() const {
+		return playerFloors;
+	}
 
 private:
 	static bool newLeaf;
@@ -89,6 +98,16 @@ private:
 	std::vector<std::shared_ptr<Creature>> creature_list;
 	std::vector<std::shared_ptr<Creature>> player_list;
 
+	std::array<uint16_t, MAP_MAX_LAYERS> creatureFloorCount = {};
+	std::array<uint16_t, MAP_MAX_LAYERS> playerFloorCount = {};
+	uint16_t creatureFloors = 0;
+	uint16_t playerFloors = 0;
+
+	// OTSYS_TIME until which a player is (or recently was) in view of this sector
+	int64_t activeUntil = 0;
+	// Map spectator cache generation of the last creature change in this sector
+	uint64_t spectatorGeneration = 0;
+
 	friend class Map;
 	friend class MapCache;
 	friend class QTreeNode;
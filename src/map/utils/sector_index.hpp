@@ -0,0 +1,50 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "map/map_const.hpp"
+
+class QTreeLeafNode;
+
+/**
+ * Direct lookup of the QTreeLeafNode holding a position.
+ * Two flat tables: a fixed grid of chunks, each chunk a grid of 64x64 leaves
+ * (512x512 tiles), allocated the first time a leaf is created in it.
+ * A lookup is two dependent loads instead of one per quadtree level.
+ * The leaves are still owned by the quadtree.
+ */
+class SectorIndex {
+public:
+	static constexpr uint32_t CHUNK_BITS = 6;
+	static constexpr uint32_t CHUNK_SIZE = 1 << CHUNK_BITS;
+	static constexpr uint32_t CHUNK_MASK = CHUNK_SIZE - 1;
+	static constexpr uint32_t CHUNKS_PER_AXIS = 1 << (16 - FLOOR_BITS - CHUNK_BITS);
+
+	QTreeLeafNode* get(uint16_t x, uint16_t y) const {
+		const uint32_t leafX = x >> FLOOR_BITS;
+		const uint32_t leafY = y >> FLOOR_BITS;
+		const auto &chunk = chunks[(leafY >> CHUNK_BITS) * CHUNKS_PER_AXIS + (leafX >> CHUNK_BITS)];
+		return chunk ? (*chunk)[(leafY & CHUNK_MASK) * CHUNK_SIZE + (leafX & CHUNK_MASK)] : nullptr;
+	}
+
+	void set(uint16_t x, uint16_t y, QTreeLeafNode* leaf) {
+		const uint32_t leafX = x >> FLOOR_BITS;
+		const uint32_t leafY = y >> FLOOR_BITS;
+		auto &chunk = chunks[(leafY >> CHUNK_BITS) * CHUNKS_PER_AXIS + (leafX >> CHUNK_BITS)];
+		if (!chunk) {
+			chunk = std::make_unique<Chunk>();
+		}
+		(*chunk)[(leafY & CHUNK_MASK) * CHUNK_SIZE + (leafX & CHUNK_MASK)] = leaf;
+	}
+
+private:
+	using Chunk = std::array<QTreeLeafNode*, CHUNK_SIZE * CHUNK_SIZE>;
+	std::array<std::unique_ptr<Chunk>, CHUNKS_PER_AXIS * CHUNKS_PER_AXIS> chunks {};
+};
@@ -21,11 +21,13 @@
 // STL Includes
 // --------------------
 
+#include <bit>
 #include <bitset>
 #include <charconv>
 #include <filesystem>
 #include <fstream>
 #include <forward_list>
+#include <future>
 #include <list>
 #include <map>
 #include <queue>
@@ -33,6 +35,8 @@
 #include <ranges>
 #include <regex>
 #include <set>
+#include <source_location>
+#include <span>
 #include <thread>
 #include <vector>
 #include <variant>
@@ -58,6 +62,7 @@
 // --------------------
 
 // ABSL
+#include <absl/container/inlined_vector.h>
 #include <absl/numeric/int128.h>
 
 // ARGON2
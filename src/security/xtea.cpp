@@ -0,0 +1,250 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "security/xtea.hpp"
+#include "utils/cpu_features.hpp"
+
+namespace XTEA {
+	static constexpr uint32_t DELTA = 0x61C88647;
+	static constexpr size_t ROUNDS = 32;
+	static constexpr size_t BLOCK_SIZE = 8;
+
+	// Key and sum of both half rounds of each round, computed once per message
+	using RoundKeys = std::array<std::array<uint32_t, 2>, ROUNDS>;
+
+	static RoundKeys expandEncryptKey(const Key &key) {
+		RoundKeys roundKeys;
+		uint32_t sum = 0;
+		for (auto &roundKey : roundKeys) {
+			roundKey[0] = sum + key[sum & 3];
+			sum -= DELTA;
+			roundKey[1] = sum + key[(sum >> 11) & 3];
+		}
+		return roundKeys;
+	}
+
+	static RoundKeys expandDecryptKey(const Key &key) {
+		RoundKeys roundKeys;
+		uint32_t sum = 0xC6EF3720;
+		for (auto &roundKey : roundKeys) {
+			roundKey[0] = sum + key[(sum >> 11) & 3];
+			sum += DELTA;
+			roundKey[1] = sum + key[sum & 3];
+		}
+		return roundKeys;
+	}
+
+	static void encryptBlocks(uint8_t* data, size_t length, const RoundKeys &roundKeys) {
+		for (size_t offset = 0; offset < length; offset += BLOCK_SIZE) {
+			std::array<uint32_t, 2> vData;
+			memcpy(vData.data(), data + offset, BLOCK_SIZE);
+			for (const auto &roundKey : roundKeys) {
+				vData[0] += ((vData[1] << 4 ^ vData[1] >> 5) + vData[1]) ^ roundKey[0];
+				vData[1] += ((vData[0] << 4 ^ vData[0] >> 5) + vData[0]) ^ roundKey[1];
+			}
+			memcpy(data + offset, vData.data(), BLOCK_SIZE);
+		}
+	}
+
+	static void decryptBlocks(uint8_t* data, size_t length, const RoundKeys &roundKeys) {
+		for (size_t offset = 0; offset < length; offset += BLOCK_SIZE) {
+			std::array<uint32_t, 2> vData;
+			memcpy(vData.data(), data + offset, BLOCK_SIZE);
+			for (const auto &roundKey : roundKeys) {
+				vData[1] -= ((vData[0] << 4 ^ vData[0] >> 5) + vData[0]) ^ roundKey[0];
+				vData[0] -= ((vData[1] << 4 ^ vData[1] >> 5) + vData[1]) ^ roundKey[1];
+			}
+			memcpy(data + offset, vData.data(), BLOCK_SIZE);
+		}
+	}
+
+	// Processes the whole groups of blocks, returns the bytes it did
+	using VectorKernel = size_t (*)(uint8_t* data, size_t length, const RoundKeys &roundKeys);
+
+#if defined(CANARY_SIMD_X86_64)
+	static constexpr size_t AVX2_BLOCKS = 8;
+
+	// Two registers of four interleaved blocks each, into the first and the second words of all eight blocks
+	CANARY_TARGET("avx2") static void loadBlocks(const uint8_t* data, __m256i &v0, __m256i &v1) {
+		const __m256i low = _mm256_shuffle_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), _MM_SHUFFLE(3, 1, 2, 0));
+		const __m256i high = _mm256_shuffle_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32)), _MM_SHUFFLE(3, 1, 2, 0));
+		v0 = _mm256_unpacklo_epi64(low, high);
+		v1 = _mm256_unpackhi_epi64(low, high);
+	}
+
+	CANARY_TARGET("avx2") static void storeBlocks(uint8_t* data, __m256i v0, __m256i v1) {
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data), _mm256_shuffle_epi32(_mm256_unpacklo_epi64(v0, v1), _MM_SHUFFLE(3, 1, 2, 0)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + 32), _mm256_shuffle_epi32(_mm256_unpackhi_epi64(v0, v1), _MM_SHUFFLE(3, 1, 2, 0)));
+	}
+
+	CANARY_TARGET("avx2") static __m256i mix(__m256i v) {
+		return _mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v, 4), _mm256_srli_epi32(v, 5)), v);
+	}
+
+	CANARY_TARGET("avx2") static size_t encryptAvx2(uint8_t* data, size_t length, const RoundKeys &roundKeys) {
+		size_t offset = 0;
+		for (; offset + AVX2_BLOCKS * BLOCK_SIZE <= length; offset += AVX2_BLOCKS * BLOCK_SIZE) {
+			__m256i v0, v1;
+			loadBlocks(data + offset, v0, v1);
+			for (const auto &roundKey : roundKeys) {
+				v0 = _mm256_add_epi32(v0, _mm256_xor_si256(mix(v1), _mm256_set1_epi32(static_cast<int32_t>(roundKey[0]))));
+				v1 = _mm256_add_epi32(v1, _mm256_xor_si256(mix(v0), _mm256_set1_epi32(static_cast<int32_t>(roundKey[1]))));
+			}
+			storeBlocks(data + offset, v0, v1);
+		}
+		return offset;
+	}
+
+	CANARY_TARGET("avx2") static size_t decryptAvx2(uint8_t* data, size_t length, const RoundKeys &roundKeys) {
+		size_t offset = 0;
+		for (; offset + AVX2_BLOCKS * BLOCK_SIZE <= length; offset += AVX2_BLOCKS * BLOCK_SIZE) {
+			__m256i v0, v1;
+			loadBlocks(data + offset, v0, v1);
+			for (const auto &roundKey : roundKeys) {
+				v1 = _mm256_sub_epi32(v1, _mm256_xor_si256(mix(v0), _mm256_set1_epi32(static_cast<int32_t>(roundKey[0]))));
+				v0 = _mm256_sub_epi32(v0, _mm256_xor_si256(mix(v1), _mm256_set1_epi32(static_cast<int32_t>(roundKey[1]))));
+			}
+			storeBlocks(data + offset, v0, v1);
+		}
+		return offset;
+	}
+
+	static constexpr size_t SSE2_BLOCKS = 4;
+
+	// Two registers of two interleaved blocks each, into the first and the second words of all four blocks
+	static void loadBlocks(const uint8_t* data, __m128i &v0, __m128i &v1) {
+		const __m128i low = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), _MM_SHUFFLE(3, 1, 2, 0));
+		const __m128i high = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)), _MM_SHUFFLE(3, 1, 2, 0));
+		v0 = _mm_unpacklo_epi64(low, high);
+		v1 = _mm_unpackhi_epi64(low, high);
+	}
+
+	static void storeBlocks(uint8_t* data, __m128i v0, __m128i v1) {
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data), _mm_shuffle_epi32(_mm_unpacklo_epi64(v0, v1), _MM_SHUFFLE(3, 1, 2, 0)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data + 16), _mm_shuffle_epi32(_mm_unpackhi_epi64(v0, v1), _MM_SHUFFLE(3, 1, 2, 0)));
+	}
+
+	static __m128i mix(__m128i v) {
+		return _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v, 4), _mm_srli_epi32(v, 5)), v);
+	}
+
+	static size_t encryptSse2(uint8_t* data, size_t length, const RoundKeys &roundKeys) {
+		size_t offset = 0;
+		for (; offset + SSE2_BLOCKS * BLOCK_SIZE <= length; offset += SSE2_BLOCKS * BLOCK_SIZE) {
+			__m128i v0, v1;
+			loadBlocks(data + offset, v0, v1);
+			for (const auto &roundKey : roundKeys) {
+				v0 = _mm_add_epi32(v0, _mm_xor_si128(mix(v1), _mm_set1_epi32(static_cast<int32_t>(roundKey[0]))));
+				v1 = _mm_add_epi32(v1, _mm_xor_si128(mix(v0), _mm_set1_epi32(static_cast<int32_t>(roundKey[1]))));
+			}
+			storeBlocks(data + offset, v0, v1);
+		}
+		return offset;
+	}
+
+	static size_t decryptSse2(uint8_t* data, size_t length, const RoundKeys &roundKeys) {
+		size_t offset = 0;
+		for (; offset + SSE2_BLOCKS * BLOCK_SIZE <= length; offset += SSE2_BLOCKS * BLOCK_SIZE) {
+			__m128i v0, v1;
+			loadBlocks(data + offset, v0, v1);
+			for (const auto &roundKey : roundKeys) {
+				v1 = _mm_sub_epi32(v1, _mm_xor_si128(mix(v0), _mm_set1_epi32(static_cast<int32_t>(roundKey[0]))));
+				v0 = _mm_sub_epi32(v0, _mm_xor_si128(mix(v1), _mm_set1_epi32(static_cast<int32_t>(roundKey[1]))));
+			}
+			storeBlocks(data + offset, v0, v1);
+		}
+		return offset;
+	}
+
+	static VectorKernel selectEncryptKernel() {
+		return getCpuFeatures().avx2 ? encryptAvx2 : encryptSse2;
+	}
+
+	static VectorKernel selectDecryptKernel() {
+		return getCpuFeatures().avx2 ? decryptAvx2 : decryptSse2;
+	}
+#elif defined(__NEON__)
+	static constexpr size_t NEON_BLOCKS = 4;
+
+	static uint32x4_t mix(uint32x4_t v) {
+		return vaddq_u32(veorq_u32(vshlq_n_u32(v, 4), vshrq_n_u32(v, 5)), v);
+	}
+
+	static size_t encryptNeon(uint8_t* data, size_t length, const RoundKeys &roundKeys) {
+		size_t offset = 0;
+		for (; offset + NEON_BLOCKS * BLOCK_SIZE <= length; offset += NEON_BLOCKS * BLOCK_SIZE) {
+			// Deinterleaving load, val[0] holds the first and val[1] the second word of each block
+			uint32x4x2_t v = vld2q_u32(reinterpret_cast<const uint32_t*>(data + offset));
+			for (const auto &roundKey : roundKeys) {
+				v.val[0] = vaddq_u32(v.val[0], veorq_u32(mix(v.val[1]), vdupq_n_u32(roundKey[0])));
+				v.val[1] = vaddq_u32(v.val[1], veorq_u32(mix(v.val[0]), vdupq_n_u32(roundKey[1])));
+			}
+			vst2q_u32(reinterpret_cast<uint32_t*>(data + offset), v);
+		}
+		return offset;
+	}
+
+	static size_t decryptNeon(uint8_t* data, size_t length, const RoundKeys &roundKeys) {
+		size_t offset = 0;
+		for (; offset + NEON_BLOCKS * BLOCK_SIZE <= length; offset += NEON_BLOCKS * BLOCK_SIZE) {
+			uint32x4x2_t v = vld2q_u32(reinterpret_cast<const uint32_t*>(data + offset));
+			for (const auto &roundKey : roundKeys) {
+				v.val[1] = vsubq_u32(v.val[1], veorq_u32(mix(v.val[0]), vdupq_n_u32(roundKey[0])));
+				v.val[0] = vsubq_u32(v.val[0], veorq_u32(mix(v.val[1]), vdupq_n_u32(roundKey[1])));
+			}
+			vst2q_u32(reinterpret_cast<uint32_t*>(data + offset), v);
+		}
+		return offset;
+	}
+
+	static VectorKernel selectEncryptKernel() {
+		return encryptNeon;
+	}
+
+	static VectorKernel selectDecryptKernel() {
+		return decryptNeon;
+	}
+#else
+	static size_t noVector(uint8_t*, size_t, const RoundKeys &) {
+		return 0;
+	}
+
+	static VectorKernel selectEncryptKernel() {
+		return noVector;
+	}
+
+	static VectorKernel selectDecryptKernel() {
+		return noVector;
+	}
+#endif
+
+	void encrypt(uint8_t* data, size_t length, const Key &key) {
+		const auto roundKeys = expandEncryptKey(key);
+		static const VectorKernel kernel = selectEncryptKernel();
+		const size_t offset = kernel(data, length, roundKeys);
+		encryptBlocks(data + offset, length - offset, roundKeys);
+	}
+
+	void decrypt(uint8_t* data, size_t length, const Key &key) {
+		const auto roundKeys = expandDecryptKey(key);
+		static const VectorKernel kernel = selectDecryptKernel();
+		const size_t offset = kernel(data, length, roundKeys);
+		decryptBlocks(data + offset, length - offset, roundKeys);
+	}
+
+	void encryptScalar(uint8_t* data, size_t length, const Key &key) {
+		encryptBlocks(data, length, expandEncryptKey(key));
+	}
+
+	void decryptScalar(uint8_t* data, size_t length, const Key &key) {
+		decryptBlocks(data, length, expandDecryptKey(key));
+	}
+}
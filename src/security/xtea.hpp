@@ -0,0 +1,29 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * XTEA in ECB mode, as the client protocol uses it. Blocks do not depend on
+ * each other, so whole groups of blocks go through the rounds at once with
+ * the widest vector unit of the host: AVX2 when the CPU has it, else SSE2
+ * on x86-64, or NEON (see utils/cpu_features.hpp). The remaining blocks use
+ * the scalar implementation.
+ */
+namespace XTEA {
+	using Key = std::array<uint32_t, 4>;
+
+	// In place over length bytes, length must be a multiple of 8
+	void encrypt(uint8_t* data, size_t length, const Key &key);
+	void decrypt(uint8_t* data, size_t length, const Key &key);
+
+	// One block at a time, the reference for the vectorized path
+	void encryptScalar(uint8_t* data, size_t length, const Key &key);
+	void decryptScalar(uint8_t* data, size_t length, const Key &key);
+}
@@ -0,0 +1,93 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "server/cluster/cluster_bus.hpp"
+#include "config/configmanager.hpp"
+#include "database/database.hpp"
+#include "database/databasetasks.hpp"
+#include "game/scheduling/scheduler.hpp"
+#include "lib/di/container.hpp"
+#include "utils/tools.hpp"
+
+ClusterBus &ClusterBus::getInstance() {
+	return inject<ClusterBus>();
+}
+
+bool ClusterBus::isEnabled() const {
+	return g_configManager().getNumber(CLUSTER_WORLD_ID) > 0;
+}
+
+void ClusterBus::start() {
+	if (!isEnabled()) {
+		return;
+	}
+
+	worldId = static_cast<uint32_t>(g_configManager().getNumber(CLUSTER_WORLD_ID));
+	if (DBResult_ptr result = Database::getInstance().storeQuery("SELECT MAX(`id`) AS `id` FROM `cluster_messages`")) {
+		lastMessageId = result->getNumber<uint64_t>("id");
+	}
+
+	g_logger().info("[ClusterBus] World {} joined the cluster", worldId);
+	schedulePoll();
+}
+
+void ClusterBus::publish(ClusterMessage message) {
+	if (worldId == 0) {
+		return;
+	}
+
+	const auto query = fmt::format(
+		"INSERT INTO `cluster_messages` (`world_id`, `type`, `guid`, `value`, `text`, `created_at`) VALUES ({}, {}, {}, {}, {}, {})",
+		worldId, static_cast<uint16_t>(message.type), message.guid, message.value, Database::getInstance().escapeString(message.text), getTimeNow()
+	);
+	g_databaseTasks().execute(query);
+}
+
+void ClusterBus::schedulePoll() {
+	const auto interval = std::max<int32_t>(50, g_configManager().getNumber(CLUSTER_POLL_INTERVAL_MS));
+	g_scheduler().addEvent(static_cast<uint32_t>(interval), [this] { poll(); }, "ClusterBus::poll");
+}
+
+void ClusterBus::poll() {
+	const auto now = getTimeNow();
+	if (now >= nextPruneTime) {
+		// Any world may prune, the rows are the same for all of them
+		nextPruneTime = now + 60;
+		g_databaseTasks().execute(fmt::format("DELETE FROM `cluster_messages` WHERE `created_at` < {}", now - MESSAGE_TTL_SECONDS));
+	}
+
+	// The ids grow with every insert, so the rows after the last one seen are the new ones. A row whose
+	// insert commits after a greater id was read is skipped, the messages are notifications that may be lost
+	const auto query = fmt::format(
+		"SELECT `id`, `world_id`, `type`, `guid`, `value`, `text` FROM `cluster_messages` WHERE `id` > {} ORDER BY `id` LIMIT {}",
+		lastMessageId, MAX_MESSAGES_PER_POLL
+	);
+	g_databaseTasks().store(query, [this](DBResult_ptr result, bool) {
+		if (result) {
+			do {
+				lastMessageId = std::max(lastMessageId, result->getNumber<uint64_t>("id"));
+
+				ClusterMessage message;
+				message.type = static_cast<ClusterMessageType>(result->getNumber<uint16_t>("type"));
+				message.worldId = result->getNumber<uint32_t>("world_id");
+				if (message.worldId == worldId) {
+					continue;
+				}
+
+				message.guid = result->getNumber<uint32_t>("guid");
+				message.value = result->getNumber<int32_t>("value");
+				message.text = result->getString("text");
+				dispatcher.dispatch(message);
+			} while (result->next());
+		}
+		schedulePoll();
+	});
+}
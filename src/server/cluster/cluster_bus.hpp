@@ -0,0 +1,73 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "lib/messaging/message.hpp"
+
+enum class ClusterMessageType : uint16_t {
+	// guid logged in or out, value is the VipStatus_t and text the name
+	vipStatus = 1,
+};
+
+struct ClusterMessage : Message<ClusterMessageType> {
+	// World that published it
+	uint32_t worldId = 0;
+	uint32_t guid = 0;
+	int32_t value = 0;
+	std::string text;
+};
+
+using ClusterDispatcher = eventpp::EventDispatcher<ClusterMessageType, void(const ClusterMessage &), MessagePolicy<ClusterMessageType>>;
+
+/**
+ * Messages between the worlds sharing the account database, enabled by a
+ * non-zero clusterWorldId. Published messages are rows of cluster_messages,
+ * every world polls the rows the others appended since its last poll and
+ * dispatches them to its listeners on the game thread. Rows older than
+ * MESSAGE_TTL_SECONDS are removed, a world that was away longer misses them.
+ */
+class ClusterBus {
+public:
+	static constexpr int32_t DEFAULT_POLL_INTERVAL_MS = 500;
+	static constexpr uint32_t MAX_MESSAGES_PER_POLL = 500;
+	static constexpr int64_t MESSAGE_TTL_SECONDS = 5 * 60;
+
+	ClusterBus() = default;
+
+	// Ensures that we don't accidentally copy it
+	ClusterBus(const ClusterBus &) = delete;
+	ClusterBus &operator=(const ClusterBus &) = delete;
+
+	static ClusterBus &getInstance();
+
+	bool isEnabled() const;
+
+	// Skips the messages already in the table and starts polling, the listeners added later still get the next ones
+	void start();
+
+	// Sent to the other worlds only, the local listeners are not called
+	void publish(ClusterMessage message);
+
+	template <typename Callback>
+	void appendListener(ClusterMessageType type, Callback &&callback) {
+		dispatcher.appendListener(type, std::forward<Callback>(callback));
+	}
+
+private:
+	void poll();
+	void schedulePoll();
+
+	ClusterDispatcher dispatcher;
+	uint32_t worldId = 0;
+	uint64_t lastMessageId = 0;
+	int64_t nextPruneTime = 0;
+};
+
+constexpr auto g_clusterBus = ClusterBus::getInstance;
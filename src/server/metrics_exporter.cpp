@@ -0,0 +1,120 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "server/metrics_exporter.hpp"
+#include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
+
+namespace {
+	class MetricsSession : public std::enable_shared_from_this<MetricsSession> {
+	public:
+		MetricsSession(asio::ip::tcp::socket &&socket, asio::io_service &ioService) :
+			socket(std::move(socket)), timer(ioService), request(MetricsExporter::MAX_REQUEST_SIZE) { }
+
+		void start() {
+			timer.expires_from_now(MetricsExporter::REQUEST_TIMEOUT);
+			timer.async_wait([self = shared_from_this()](const std::error_code &error) {
+				if (!error) {
+					std::error_code ignored;
+					self->socket.close(ignored);
+				}
+			});
+
+			asio::async_read_until(socket, request, "\r\n\r\n", [self = shared_from_this()](const std::error_code &error, size_t) {
+				self->onRequest(error);
+			});
+		}
+
+	private:
+		void onRequest(const std::error_code &error) {
+			if (error) {
+				timer.cancel();
+				return;
+			}
+
+			std::string_view line(static_cast<const char*>(request.data().data()), request.size());
+			line = line.substr(0, line.find("\r\n"));
+			if (line.starts_with("GET /metrics ") || line.starts_with("GET /metrics?")) {
+				respond("200 OK", g_metrics().serialize());
+			} else {
+				respond("404 Not Found", "Not found\n");
+			}
+		}
+
+		void respond(std::string_view status, const std::string &body) {
+			response = fmt::format(
+				"HTTP/1.1 {}\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: {}\r\nConnection: close\r\n\r\n{}",
+				status, body.size(), body
+			);
+			asio::async_write(socket, asio::buffer(response), [self = shared_from_this()](const std::error_code &, size_t) {
+				self->timer.cancel();
+				std::error_code ignored;
+				self->socket.shutdown(asio::ip::tcp::socket::shutdown_both, ignored);
+				self->socket.close(ignored);
+			});
+		}
+
+		asio::ip::tcp::socket socket;
+		asio::high_resolution_timer timer;
+		asio::streambuf request;
+		std::string response;
+	};
+}
+
+MetricsExporter &MetricsExporter::getInstance() {
+	return inject<MetricsExporter>();
+}
+
+MetricsExporter::~MetricsExporter() {
+	shutdown();
+}
+
+bool MetricsExporter::start(const std::string &ip, uint16_t port) {
+	try {
+		acceptor = std::make_unique<asio::ip::tcp::acceptor>(ioService, asio::ip::tcp::endpoint(asio::ip::address::from_string(ip), port));
+	} catch (const std::system_error &e) {
+		g_logger().warn("[MetricsExporter::start] - Can not listen on {}:{}: {}", ip, port, e.what());
+		return false;
+	}
+
+	accept();
+	thread = std::jthread([this] {
+		ioService.run();
+	});
+	g_logger().info("Metrics exported on http://{}:{}/metrics", ip, port);
+	return true;
+}
+
+void MetricsExporter::shutdown() {
+	if (!thread.joinable()) {
+		return;
+	}
+
+	ioService.post([this] {
+		std::error_code ignored;
+		acceptor->close(ignored);
+	});
+	ioService.stop();
+	thread.join();
+}
+
+void MetricsExporter::accept() {
+	acceptor->async_accept([this](const std::error_code &error, asio::ip::tcp::socket socket) {
+		if (error == asio::error::operation_aborted) {
+			return;
+		}
+
+		if (!error) {
+			std::make_shared<MetricsSession>(std::move(socket), ioService)->start();
+		}
+		accept();
+	});
+}
@@ -0,0 +1,44 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Answers GET /metrics with the metrics registry in the Prometheus text
+ * format. Runs on its own thread and io_service, so a scrape never waits
+ * for the game thread nor delays the game connections: the registry is
+ * read with relaxed atomics and game state only through the gauges the
+ * collectors sampled.
+ */
+class MetricsExporter {
+public:
+	static constexpr size_t MAX_REQUEST_SIZE = 8 * 1024;
+	static constexpr std::chrono::seconds REQUEST_TIMEOUT { 5 };
+
+	MetricsExporter() = default;
+	~MetricsExporter();
+
+	// Ensures that we don't accidentally copy it
+	MetricsExporter(const MetricsExporter &) = delete;
+	MetricsExporter operator=(const MetricsExporter &) = delete;
+
+	static MetricsExporter &getInstance();
+
+	bool start(const std::string &ip, uint16_t port);
+	void shutdown();
+
+private:
+	void accept();
+
+	asio::io_service ioService;
+	std::unique_ptr<asio::ip::tcp::acceptor> acceptor;
+	std::jthread thread;
+};
+
+constexpr auto g_metricsExporter = MetricsExporter::getInstance;
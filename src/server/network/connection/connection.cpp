@@ -10,6 +10,8 @@
 #include "pch.hpp"
 
 #include "server/network/connection/connection.hpp"
+#include "lib/metrics/metrics.hpp"
+#include "lib/thread/thread_pool.hpp"
 #include "server/network/message/outputmessage.hpp"
 #include "server/network/protocol/protocol.hpp"
 #include "server/network/protocol/protocolgame.hpp"
@@ -70,7 +72,7 @@ void Connection::close(bool force) {
 		g_dispatcher().addTask(std::bind_front(&Protocol::release, protocol), "Protocol::release", 1000);
 	}
 
-	if (messageQueue.empty() || force) {
+	if ((!writing && messageQueue.empty()) || force) {
 		closeSocket();
 	} else {
 		// will be closed by the destructor or onWriteOperation
@@ -93,13 +95,20 @@ void Connection::closeSocket() {
 
 void Connection::accept(Protocol_ptr protocolPtr) {
 	this->connectionState = CONNECTION_STATE_IDENTIFYING;
-	this->protocol = protocolPtr;
+	setProtocol(protocolPtr);
 	g_dispatcher().addTask(std::bind_front(&Protocol::onConnect, protocolPtr), "Protocol::onConnect", 1000);
 
 	// Call second accept for not duplicate code
 	accept(false);
 }
 
+void Connection::setProtocol(Protocol_ptr protocolPtr) {
+	protocol = std::move(protocolPtr);
+	const auto labels = fmt::format("protocol=\"{}\"", protocol->getProtocolName());
+	bytesReceived = &g_metrics().getCounter("canary_network_received_bytes_total", "Bytes read from the client connections", labels);
+	bytesSent = &g_metrics().getCounter("canary_network_sent_bytes_total", "Bytes written to the client connections", labels);
+}
+
 void Connection::accept(bool toggleParseHeader /* = true */) {
 	try {
 		readTimer.expires_from_now(std::chrono::seconds(CONNECTION_READ_TIMEOUT));
@@ -247,11 +256,12 @@ void Connection::parsePacket(const std::error_code &error) {
 			}
 
 			// Game protocol has already been created at this point
-			protocol = service_port->make_protocol(recvChecksum == checksum, msg, shared_from_this());
-			if (!protocol) {
+			auto protocolPtr = service_port->make_protocol(recvChecksum == checksum, msg, shared_from_this());
+			if (!protocolPtr) {
 				close(FORCE_CLOSE);
 				return;
 			}
+			setProtocol(std::move(protocolPtr));
 		} else {
 			// It is rather hard to detect if we have checksum or sequence method here so let's skip checksum check
 			// it doesn't generate any problem because olders protocol don't use 'server sends first' feature
@@ -260,11 +270,12 @@ void Connection::parsePacket(const std::error_code &error) {
 			msg.skipBytes(1);
 		}
 
-		protocol->onRecvFirstMessage(msg);
+		skipReadingNextPacket = protocol->onRecvFirstMessage(msg);
 	} else {
 		// Send the packet to the current protocol
 		skipReadingNextPacket = protocol->onRecvMessage(msg);
 	}
+	bytesReceived->add(msg.getLength());
 
 	try {
 		readTimer.expires_from_now(std::chrono::seconds(CONNECTION_READ_TIMEOUT));
@@ -298,10 +309,10 @@ void Connection::send(const OutputMessage_ptr &outputMessage) {
 		return;
 	}
 
-	bool noPendingWrite = messageQueue.empty();
+	bool noPendingWrite = !writing && messageQueue.empty();
 	messageQueue.emplace_back(outputMessage);
 	if (noPendingWrite) {
-		// Make asio thread handle xtea encryption instead of dispatcher
+		// Compression and encryption run on the network thread or the thread pool, never on the dispatcher
 		try {
 			asio::post(socket.get_executor(), std::bind(&Connection::internalWorker, shared_from_this()));
 		} catch (const std::system_error &e) {
@@ -314,12 +325,13 @@ void Connection::send(const OutputMessage_ptr &outputMessage) {
 
 void Connection::internalWorker() {
 	std::unique_lock<std::recursive_mutex> lockClass(connectionLock);
+	if (writing) {
+		// onWriteOperation sends what was queued meanwhile
+		return;
+	}
+
 	if (!messageQueue.empty()) {
-		const OutputMessage_ptr &outputMessage = messageQueue.front();
-		lockClass.unlock();
-		protocol->onSendMessage(outputMessage);
-		lockClass.lock();
-		internalSend(outputMessage);
+		internalSend(lockClass);
 	} else if (connectionState == CONNECTION_STATE_CLOSED) {
 		closeSocket();
 	}
@@ -338,21 +350,80 @@ uint32_t Connection::getIP() {
 	return htonl(endpoint.address().to_v4().to_ulong());
 }
 
-void Connection::internalSend(const OutputMessage_ptr &outputMessage) {
+void Connection::internalSend(std::unique_lock<std::recursive_mutex> &lockClass) {
+	// Everything queued so far leaves in one write. The batch is spliced off the queue, so what send() appends meanwhile waits for the next one
+	writing = true;
+	const auto batchSize = std::min(messageQueue.size(), CONNECTION_MAX_WRITE_BATCH);
+	std::list<OutputMessage_ptr> batch;
+	batch.splice(batch.end(), messageQueue, messageQueue.begin(), std::next(messageQueue.begin(), static_cast<std::ptrdiff_t>(batchSize)));
+
+	size_t batchBytes = 0;
+	for (const auto &message : batch) {
+		batchBytes += message->getLength();
+	}
+
+	if (batchBytes < CONNECTION_OFFLOAD_MIN_BYTES) {
+		lockClass.unlock();
+		auto buffers = prepareWriteBatch(batch);
+		lockClass.lock();
+		startWrite(std::move(batch), std::move(buffers));
+		return;
+	}
+
+	// Deflate of big batches would hold back every other connection on the network thread
+	inject<ThreadPool>().addLoad([connection = shared_from_this(), batch = std::move(batch)]() mutable {
+		auto buffers = connection->prepareWriteBatch(batch);
+		try {
+			asio::post(connection->socket.get_executor(), [connection, batch = std::move(batch), buffers = std::move(buffers)]() mutable {
+				std::lock_guard<std::recursive_mutex> lockClass(connection->connectionLock);
+				connection->startWrite(std::move(batch), std::move(buffers));
+			});
+		} catch (const std::system_error &e) {
+			g_logger().error("[Connection::internalSend] - error: {}", e.what());
+			// The batch never reaches startWrite, writing would stay set and block the queue for good
+			connection->close(FORCE_CLOSE);
+		}
+	});
+}
+
+std::vector<asio::const_buffer> Connection::prepareWriteBatch(const std::list<OutputMessage_ptr> &batch) {
+	std::vector<asio::const_buffer> buffers;
+	buffers.reserve(batch.size());
+	for (const auto &message : batch) {
+		// Encrypted in queue order, the sequence checksum depends on it
+		protocol->onSendMessage(message);
+		buffers.emplace_back(asio::buffer(message->getOutputBuffer(), message->getLength()));
+	}
+	return buffers;
+}
+
+void Connection::startWrite(std::list<OutputMessage_ptr> &&batch, std::vector<asio::const_buffer> &&buffers) {
+	writeBatch = std::move(batch);
+	writeBuffers = std::move(buffers);
 	try {
 		writeTimer.expires_from_now(std::chrono::seconds(CONNECTION_WRITE_TIMEOUT));
 		writeTimer.async_wait(std::bind(&Connection::handleTimeout, std::weak_ptr<Connection>(shared_from_this()), std::placeholders::_1));
 
-		asio::async_write(socket, asio::buffer(outputMessage->getOutputBuffer(), outputMessage->getLength()), std::bind(&Connection::onWriteOperation, shared_from_this(), std::placeholders::_1));
+		asio::async_write(socket, writeBuffers, std::bind(&Connection::onWriteOperation, shared_from_this(), std::placeholders::_1));
 	} catch (const std::system_error &e) {
-		g_logger().error("[Connection::internalSend] - error: {}", e.what());
+		g_logger().error("[Connection::startWrite] - error: {}", e.what());
+		writeBatch.clear();
+		writeBuffers.clear();
+		writing = false;
+		messageQueue.clear();
+		close(FORCE_CLOSE);
 	}
 }
 
 void Connection::onWriteOperation(const std::error_code &error) {
 	std::unique_lock<std::recursive_mutex> lockClass(connectionLock);
 	writeTimer.cancel();
-	messageQueue.pop_front();
+	if (!error) {
+		bytesSent->add(asio::buffer_size(writeBuffers));
+	}
+	writeBatch.clear();
+	writeBuffers.clear();
+	writing = false;
 
 	if (error) {
 		messageQueue.clear();
@@ -361,11 +432,7 @@ void Connection::onWriteOperation(const std::error_code &error) {
 	}
 
 	if (!messageQueue.empty()) {
-		const OutputMessage_ptr &outputMessage = messageQueue.front();
-		lockClass.unlock();
-		protocol->onSendMessage(outputMessage);
-		lockClass.lock();
-		internalSend(outputMessage);
+		internalSend(lockClass);
 	} else if (connectionState == CONNECTION_STATE_CLOSED) {
 		closeSocket();
 	}
@@ -14,6 +14,10 @@
 #include "server/network/message/networkmessage.hpp"
 
 static constexpr int32_t CONNECTION_WRITE_TIMEOUT = 30;
+// Queued messages sent at most in a single vectored write
+static constexpr size_t CONNECTION_MAX_WRITE_BATCH = 64;
+// Write batches from this size on are compressed and encrypted on the thread pool instead of the network thread
+static constexpr size_t CONNECTION_OFFLOAD_MIN_BYTES = 4096;
 static constexpr int32_t CONNECTION_READ_TIMEOUT = 30;
 
 class Protocol;
@@ -24,6 +28,7 @@ class Connection;
 using Connection_ptr = std::shared_ptr<Connection>;
 using ConnectionWeak_ptr = std::weak_ptr<Connection>;
 class ServiceBase;
+class MetricCounter;
 using Service_ptr = std::shared_ptr<ServiceBase>;
 class ServicePort;
 using ServicePort_ptr = std::shared_ptr<ServicePort>;
@@ -79,8 +84,14 @@ private:
 	static void handleTimeout(ConnectionWeak_ptr connectionWeak, const std::error_code &error);
 
 	void closeSocket();
+	void setProtocol(Protocol_ptr protocolPtr);
 	void internalWorker();
-	void internalSend(const OutputMessage_ptr &outputMessage);
+	// Takes the messages at the front of the queue off it and writes them at once, the lock is released while encrypting
+	void internalSend(std::unique_lock<std::recursive_mutex> &lockClass);
+	// Compression, checksum and encryption of the batch, in queue order. Needs no lock, the batch is off the queue
+	std::vector<asio::const_buffer> prepareWriteBatch(const std::list<OutputMessage_ptr> &batch);
+	// Network thread, with the lock held
+	void startWrite(std::list<OutputMessage_ptr> &&batch, std::vector<asio::const_buffer> &&buffers);
 
 	asio::ip::tcp::socket &getSocket() {
 		return socket;
@@ -94,9 +105,17 @@ private:
 	std::recursive_mutex connectionLock;
 
 	std::list<OutputMessage_ptr> messageQueue;
+	// Messages taken off the queue for the write in flight, and their buffers
+	std::list<OutputMessage_ptr> writeBatch;
+	std::vector<asio::const_buffer> writeBuffers;
+	// From the batch leaving the queue until its write completes, also while the thread pool encrypts it
+	bool writing = false;
 
 	ConstServicePort_ptr service_port;
 	Protocol_ptr protocol;
+	// Traffic counters of the protocol, set along with it
+	MetricCounter* bytesReceived = nullptr;
+	MetricCounter* bytesSent = nullptr;
 
 	asio::ip::tcp::socket socket;
 
@@ -13,13 +13,13 @@
 #include "items/containers/container.hpp"
 #include "creatures/creature.hpp"
 
-int32_t NetworkMessage::decodeHeader() {
+int32_t NetworkMessageBase::decodeHeader() {
 	int32_t newSize = buffer[0] | buffer[1] << 8;
 	info.length = newSize;
 	return info.length;
 }
 
-std::string NetworkMessage::getString(uint16_t stringLen /* = 0*/) {
+std::string NetworkMessageBase::getString(uint16_t stringLen /* = 0*/) {
 	if (stringLen == 0) {
 		stringLen = get<uint16_t>();
 	}
@@ -33,7 +33,7 @@ std::string NetworkMessage::getString(uint16_t stringLen /* = 0*/) {
 	return std::string(v, stringLen);
 }
 
-Position NetworkMessage::getPosition() {
+Position NetworkMessageBase::getPosition() {
 	Position pos;
 	pos.x = get<uint16_t>();
 	pos.y = get<uint16_t>();
@@ -41,7 +41,7 @@ Position NetworkMessage::getPosition() {
 	return pos;
 }
 
-void NetworkMessage::addString(const std::string &value) {
+void NetworkMessageBase::addString(std::string_view value) {
 	size_t stringLen = value.length();
 	if (value.empty()) {
 		g_logger().debug("[NetworkMessage::addString] - Value string is empty");
@@ -56,17 +56,48 @@ void NetworkMessage::addString(const std::string &value) {
 	}
 
 	add<uint16_t>(stringLen);
-	memcpy(buffer + info.position, value.c_str(), stringLen);
+	memcpy(buffer + info.position, value.data(), stringLen);
 	info.position += stringLen;
 	info.length += stringLen;
 }
 
-void NetworkMessage::addDouble(double value, uint8_t precision /* = 2*/) {
+NetworkMessageBase::StringWriter::StringWriter(NetworkMessageBase &msg) :
+	msg(msg), lengthPosition(msg.info.position), started(msg.canAdd(sizeof(uint16_t))) {
+	if (started) {
+		msg.add<uint16_t>(0);
+	}
+}
+
+NetworkMessageBase::StringWriter::~StringWriter() {
+	if (!started) {
+		return;
+	}
+
+	const auto length = static_cast<uint16_t>(msg.info.position - lengthPosition - sizeof(uint16_t));
+	memcpy(msg.buffer + lengthPosition, &length, sizeof(length));
+}
+
+void NetworkMessageBase::StringWriter::append(std::string_view text) {
+	if (!started || text.empty()) {
+		return;
+	}
+
+	if (!msg.canAdd(text.size())) {
+		g_logger().error("[NetworkMessage::StringWriter::append] - NetworkMessage size is wrong: {}", text.size());
+		return;
+	}
+
+	memcpy(msg.buffer + msg.info.position, text.data(), text.size());
+	msg.info.position += text.size();
+	msg.info.length += text.size();
+}
+
+void NetworkMessageBase::addDouble(double value, uint8_t precision /* = 2*/) {
 	addByte(precision);
 	add<uint32_t>((value * std::pow(static_cast<float>(10), precision)) + std::numeric_limits<int32_t>::max());
 }
 
-void NetworkMessage::addBytes(const char* bytes, size_t size) {
+void NetworkMessageBase::addBytes(const char* bytes, size_t size) {
 	if (bytes == nullptr) {
 		g_logger().error("[NetworkMessage::addBytes] - Bytes is nullptr");
 		return;
@@ -85,18 +116,17 @@ void NetworkMessage::addBytes(const char* bytes, size_t size) {
 	info.length += size;
 }
 
-void NetworkMessage::addPaddingBytes(size_t n) {
-#define canAdd(size) ((size + info.position) < NETWORKMESSAGE_MAXSIZE)
-	if (!canAdd(n)) {
+void NetworkMessageBase::addPaddingBytes(size_t n) {
+	// The padding goes into the room kept after the body
+	if ((n + info.position) >= capacity) {
 		return;
 	}
-#undef canAdd
 
 	memset(buffer + info.position, 0x33, n);
 	info.length += n;
 }
 
-void NetworkMessage::addPosition(const Position &pos) {
+void NetworkMessageBase::addPosition(const Position &pos) {
 	add<uint16_t>(pos.x);
 	add<uint16_t>(pos.y);
 	addByte(pos.z);
@@ -18,7 +18,12 @@ class Player;
 struct Position;
 class RSA;
 
-class NetworkMessage {
+/**
+ * Read and write functions of a network message over a buffer owned by the
+ * derived class. A write that does not fit is dropped, unless grow() gives
+ * the message a bigger buffer first.
+ */
+class NetworkMessageBase {
 public:
 	using MsgSize_t = uint16_t;
 	// Headers:
@@ -26,8 +31,14 @@ public:
 	// 4 bytes for checksum
 	// 2 bytes for encrypted message size
 	static constexpr MsgSize_t INITIAL_BUFFER_POSITION = 8;
+	// Room every buffer keeps after the body, for the headers and the XTEA padding
+	static constexpr size_t BODY_RESERVE = NETWORKMESSAGE_MAXSIZE - MAX_BODY_LENGTH;
+
+	virtual ~NetworkMessageBase() = default;
 
-	NetworkMessage() = default;
+	// Ensures that we don't accidentally copy it
+	NetworkMessageBase(const NetworkMessageBase &) = delete;
+	NetworkMessageBase &operator=(const NetworkMessageBase &) = delete;
 
 	void reset() {
 		info = {};
@@ -88,9 +99,53 @@ public:
 	}
 
 	void addBytes(const char* bytes, size_t size);
+	// The values as they are in memory, little endian as the rest of the protocol
+	template <typename T>
+		requires std::is_trivially_copyable_v<T>
+	void addBytes(std::span<const T> values) {
+		addBytes(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+	}
 	void addPaddingBytes(size_t n);
 
-	void addString(const std::string &value);
+	void addString(std::string_view value);
+
+	// Formatted on the stack and copied in, without a std::string in between
+	template <typename... Args>
+	void addFormattedString(fmt::format_string<Args...> format, Args &&... args) {
+		fmt::basic_memory_buffer<char, 256> text;
+		fmt::format_to(std::back_inserter(text), format, std::forward<Args>(args)...);
+		addString(std::string_view(text.data(), text.size()));
+	}
+
+	/**
+	 * Writes one string straight into the message, in parts, as the callers
+	 * that joined an ostringstream did. The length in front of it is written
+	 * when the writer goes out of scope, nothing else may be added to the
+	 * message while it is open.
+	 */
+	class StringWriter {
+	public:
+		explicit StringWriter(NetworkMessageBase &msg);
+		~StringWriter();
+
+		// Ensures that we don't accidentally copy it
+		StringWriter(const StringWriter &) = delete;
+		StringWriter &operator=(const StringWriter &) = delete;
+
+		void append(std::string_view text);
+
+		template <typename... Args>
+		void format(fmt::format_string<Args...> format, Args &&... args) {
+			fmt::basic_memory_buffer<char, 256> text;
+			fmt::format_to(std::back_inserter(text), format, std::forward<Args>(args)...);
+			append(std::string_view(text.data(), text.size()));
+		}
+
+	private:
+		NetworkMessageBase &msg;
+		MsgSize_t lengthPosition;
+		bool started;
+	};
 
 	void addDouble(double value, uint8_t precision = 2);
 
@@ -136,13 +191,25 @@ public:
 		return buffer + HEADER_LENGTH;
 	}
 
+	size_t getCapacity() const {
+		return capacity;
+	}
+
 protected:
-	bool canAdd(size_t size) const {
-		return (size + info.position) < MAX_BODY_LENGTH;
+	NetworkMessageBase(uint8_t* buffer, size_t capacity) :
+		buffer(buffer), capacity(capacity) { }
+
+	bool canAdd(size_t size) {
+		return (size + info.position + BODY_RESERVE) < capacity || grow(size + info.position + BODY_RESERVE);
+	}
+
+	// Called when a write does not fit, returns whether the buffer now holds more than bufferSize bytes
+	virtual bool grow(size_t) {
+		return false;
 	}
 
 	bool canRead(int32_t size) {
-		if ((info.position + size) > (info.length + 8) || size >= (NETWORKMESSAGE_MAXSIZE - info.position)) {
+		if ((info.position + size) > (info.length + 8) || size >= (static_cast<int32_t>(capacity) - info.position)) {
 			info.overrun = true;
 			return false;
 		}
@@ -156,5 +223,29 @@ protected:
 	};
 
 	NetworkMessageInfo info;
-	uint8_t buffer[NETWORKMESSAGE_MAXSIZE];
+	uint8_t* buffer;
+	size_t capacity;
+};
+
+// Message with an inline buffer of the max size, as used to read packets and to build them before they are appended to an OutputMessage
+class NetworkMessage : public NetworkMessageBase {
+public:
+	NetworkMessage() :
+		NetworkMessageBase(storage, NETWORKMESSAGE_MAXSIZE) { }
+
+	NetworkMessage(const NetworkMessage &other) :
+		NetworkMessageBase(storage, NETWORKMESSAGE_MAXSIZE) {
+		*this = other;
+	}
+
+	NetworkMessage &operator=(const NetworkMessage &other) {
+		if (this != &other) {
+			info = other.info;
+			memcpy(storage, other.storage, sizeof(storage));
+		}
+		return *this;
+	}
+
+private:
+	uint8_t storage[NETWORKMESSAGE_MAXSIZE];
 };
@@ -11,46 +11,204 @@
 
 #include "outputmessage.hpp"
 #include "server/network/protocol/protocol.hpp"
-#include "game/scheduling/scheduler.hpp"
+#include "game/scheduling/dispatcher.hpp"
 
-const std::chrono::milliseconds OUTPUTMESSAGE_AUTOSEND_DELAY { 10 };
+// Free buffers each thread keeps per size class, and how many the shared pool keeps for all of them
+static constexpr auto OUTPUTMESSAGE_THREAD_FREELIST_SIZES = std::to_array<size_t>({ 256, 64, 8 });
+static constexpr auto OUTPUTMESSAGE_SHARED_POOL_SIZES = std::to_array<size_t>({ 8192, 2048, 256 });
 
-void OutputMessagePool::scheduleSendAll() {
-	auto function = std::bind_front(&OutputMessagePool::sendAll, this);
-	g_scheduler().addEvent(OUTPUTMESSAGE_AUTOSEND_DELAY.count(), function, "OutputMessagePool::sendAll");
+static constexpr size_t OUTPUTMESSAGE_SIZE_CLASSES = OUTPUTMESSAGE_BUFFER_SIZES.size();
+
+// Smallest size class with more than bufferSize bytes, the biggest one when none is
+static uint8_t getOutputBufferSizeClass(size_t bufferSize) {
+	uint8_t sizeClass = 0;
+	while (sizeClass + 1u < OUTPUTMESSAGE_SIZE_CLASSES && OUTPUTMESSAGE_BUFFER_SIZES[sizeClass] <= bufferSize) {
+		++sizeClass;
+	}
+	return sizeClass;
+}
+
+// Overflow of the thread freelists, messages are mostly built on the game thread and released on the network threads
+struct SharedOutputBufferPool {
+	~SharedOutputBufferPool() {
+		for (const auto &buffers : freeBuffers) {
+			for (const auto buffer : buffers) {
+				delete[] buffer;
+			}
+		}
+	}
+
+	std::mutex mutex;
+	std::array<std::vector<uint8_t*>, OUTPUTMESSAGE_SIZE_CLASSES> freeBuffers;
+};
+
+static SharedOutputBufferPool &getSharedOutputBufferPool() {
+	static SharedOutputBufferPool pool;
+	return pool;
+}
+
+// Set once the freelist of the thread is gone, messages released after that free their buffer directly
+static thread_local bool outputBufferFreelistDestroyed = false;
+
+/**
+ * Free buffers of one thread. Taking and returning a buffer never locks,
+ * only an empty or full freelist moves half of its size from or to the
+ * shared pool.
+ */
+class OutputBufferFreelist {
+public:
+	OutputBufferFreelist() {
+		for (size_t sizeClass = 0; sizeClass < OUTPUTMESSAGE_SIZE_CLASSES; ++sizeClass) {
+			freeBuffers[sizeClass].reserve(OUTPUTMESSAGE_THREAD_FREELIST_SIZES[sizeClass]);
+		}
+	}
+
+	~OutputBufferFreelist() {
+		for (size_t sizeClass = 0; sizeClass < OUTPUTMESSAGE_SIZE_CLASSES; ++sizeClass) {
+			moveToSharedPool(sizeClass, freeBuffers[sizeClass].size());
+		}
+		outputBufferFreelistDestroyed = true;
+	}
+
+	// Ensures that we don't accidentally copy it
+	OutputBufferFreelist(const OutputBufferFreelist &) = delete;
+	OutputBufferFreelist operator=(const OutputBufferFreelist &) = delete;
+
+	uint8_t* acquire(uint8_t sizeClass) {
+		auto &buffers = freeBuffers[sizeClass];
+		if (buffers.empty()) {
+			moveFromSharedPool(sizeClass, OUTPUTMESSAGE_THREAD_FREELIST_SIZES[sizeClass] / 2);
+			if (buffers.empty()) {
+				return new uint8_t[OUTPUTMESSAGE_BUFFER_SIZES[sizeClass]];
+			}
+		}
+
+		const auto buffer = buffers.back();
+		buffers.pop_back();
+		return buffer;
+	}
+
+	void release(uint8_t sizeClass, uint8_t* buffer) {
+		auto &buffers = freeBuffers[sizeClass];
+		if (buffers.size() >= OUTPUTMESSAGE_THREAD_FREELIST_SIZES[sizeClass]) {
+			moveToSharedPool(sizeClass, buffers.size() / 2);
+		}
+		buffers.push_back(buffer);
+	}
+
+private:
+	void moveFromSharedPool(size_t sizeClass, size_t count) {
+		auto &pool = getSharedOutputBufferPool();
+		std::scoped_lock lock(pool.mutex);
+		auto &shared = pool.freeBuffers[sizeClass];
+		const size_t moved = std::min(count, shared.size());
+		freeBuffers[sizeClass].insert(freeBuffers[sizeClass].end(), shared.end() - static_cast<std::ptrdiff_t>(moved), shared.end());
+		shared.resize(shared.size() - moved);
+	}
+
+	void moveToSharedPool(size_t sizeClass, size_t count) {
+		auto &buffers = freeBuffers[sizeClass];
+		auto &pool = getSharedOutputBufferPool();
+		std::scoped_lock lock(pool.mutex);
+		auto &shared = pool.freeBuffers[sizeClass];
+		for (; count > 0; --count) {
+			if (shared.size() < OUTPUTMESSAGE_SHARED_POOL_SIZES[sizeClass]) {
+				shared.push_back(buffers.back());
+			} else {
+				delete[] buffers.back();
+			}
+			buffers.pop_back();
+		}
+	}
+
+	std::array<std::vector<uint8_t*>, OUTPUTMESSAGE_SIZE_CLASSES> freeBuffers;
+};
+
+static OutputBufferFreelist &getOutputBufferFreelist() {
+	static thread_local OutputBufferFreelist freelist;
+	return freelist;
+}
+
+static void releaseOutputBuffer(uint8_t sizeClass, uint8_t* buffer) {
+	if (outputBufferFreelistDestroyed) {
+		delete[] buffer;
+		return;
+	}
+	getOutputBufferFreelist().release(sizeClass, buffer);
+}
+
+OutputMessage::OutputMessage(size_t bodySize /* = 0*/) :
+	NetworkMessageBase(nullptr, 0), sizeClass(getOutputBufferSizeClass(INITIAL_BUFFER_POSITION + bodySize + BODY_RESERVE)) {
+	buffer = getOutputBufferFreelist().acquire(sizeClass);
+	capacity = OUTPUTMESSAGE_BUFFER_SIZES[sizeClass];
+}
+
+OutputMessage::~OutputMessage() {
+	releaseOutputBuffer(sizeClass, buffer);
+}
+
+bool OutputMessage::grow(size_t bufferSize) {
+	if (bufferSize >= OUTPUTMESSAGE_BUFFER_SIZES.back()) {
+		return false;
+	}
+
+	const uint8_t newSizeClass = getOutputBufferSizeClass(bufferSize);
+	const auto newBuffer = getOutputBufferFreelist().acquire(newSizeClass);
+	// Headers are only added once the body is complete, so everything written is before the position
+	memcpy(newBuffer, buffer, info.position);
+	releaseOutputBuffer(sizeClass, buffer);
+
+	buffer = newBuffer;
+	capacity = OUTPUTMESSAGE_BUFFER_SIZES[newSizeClass];
+	sizeClass = newSizeClass;
+	return true;
+}
+
+OutputMessagePool::OutputMessagePool() {
+	g_dispatcher().addCycleEndHandler(std::bind_front(&OutputMessagePool::sendAll, this));
 }
 
 void OutputMessagePool::sendAll() {
 	// dispatcher thread
-	for (auto &protocol : bufferedProtocols) {
+	if (pendingProtocols.empty()) {
+		return;
+	}
+
+	// Swapped out first, sending may start new buffers that belong to the next cycle
+	std::swap(pendingProtocols, sendingProtocols);
+	for (const auto &protocol : sendingProtocols) {
 		auto &msg = protocol->getCurrentBuffer();
-		if (msg) {
+		if (protocol->autosend && msg) {
 			protocol->send(std::move(msg));
 		}
 	}
-
-	if (!bufferedProtocols.empty()) {
-		scheduleSendAll();
-	}
+	sendingProtocols.clear();
 }
 
-void OutputMessagePool::addProtocolToAutosend(Protocol_ptr protocol) {
+void OutputMessagePool::addProtocolToAutosend(const Protocol_ptr &protocol) {
 	// dispatcher thread
-	if (bufferedProtocols.empty()) {
-		scheduleSendAll();
+	if (protocol->autosend) {
+		return;
+	}
+
+	protocol->autosend = true;
+	if (protocol->getCurrentBuffer()) {
+		pendingProtocols.emplace_back(protocol);
 	}
-	bufferedProtocols.emplace_back(protocol);
 }
 
 void OutputMessagePool::removeProtocolFromAutosend(const Protocol_ptr &protocol) {
+	// dispatcher thread, a pending entry left behind is skipped by the next sendAll
+	protocol->autosend = false;
+}
+
+void OutputMessagePool::addPendingProtocol(const Protocol_ptr &protocol) {
 	// dispatcher thread
-	auto it = std::ranges::find(bufferedProtocols.begin(), bufferedProtocols.end(), protocol);
-	if (it != bufferedProtocols.end()) {
-		*it = bufferedProtocols.back();
-		bufferedProtocols.pop_back();
+	if (protocol->autosend) {
+		pendingProtocols.emplace_back(protocol);
 	}
 }
 
-OutputMessage_ptr OutputMessagePool::getOutputMessage() {
-	return std::make_shared<OutputMessage>();
+OutputMessage_ptr OutputMessagePool::getOutputMessage(size_t bodySize /* = 0*/) {
+	return std::make_shared<OutputMessage>(bodySize);
 }
@@ -12,12 +12,23 @@
 #include "server/network/message/networkmessage.hpp"
 #include "server/network/connection/connection.hpp"
 #include "utils/tools.hpp"
+#include "lib/profiling/allocation_profiler.hpp"
 
 class Protocol;
 
-class OutputMessage : public NetworkMessage {
+// Buffer sizes output messages are drawn from, a message moves to the next one when a write does not fit
+static constexpr auto OUTPUTMESSAGE_BUFFER_SIZES = std::to_array<size_t>({ 1024, 8192, NETWORKMESSAGE_MAXSIZE });
+
+/**
+ * Outgoing message over a pooled buffer of one of OUTPUTMESSAGE_BUFFER_SIZES.
+ * Buffers come from freelists of the thread creating or destroying the
+ * message, see outputmessage.cpp.
+ */
+class OutputMessage : public NetworkMessageBase, public AllocationTracked<OutputMessage> {
 public:
-	OutputMessage() = default;
+	// Starts with the smallest buffer that fits bodySize bytes
+	explicit OutputMessage(size_t bodySize = 0);
+	~OutputMessage() override;
 
 	// non-copyable
 	OutputMessage(const OutputMessage &) = delete;
@@ -41,6 +52,10 @@ public:
 
 	void append(const NetworkMessage &msg) {
 		auto msgLen = msg.getLength();
+		if (!canAdd(msgLen)) {
+			return;
+		}
+
 		memcpy(buffer + info.position, msg.getBuffer() + INITIAL_BUFFER_POSITION, msgLen);
 		info.length += msgLen;
 		info.position += msgLen;
@@ -48,11 +63,19 @@ public:
 
 	void append(const OutputMessage_ptr &msg) {
 		auto msgLen = msg->getLength();
+		if (!canAdd(msgLen)) {
+			return;
+		}
+
 		memcpy(buffer + info.position, msg->getBuffer() + INITIAL_BUFFER_POSITION, msgLen);
 		info.length += msgLen;
 		info.position += msgLen;
 	}
 
+protected:
+	// Moves the message to the smallest buffer holding more than bufferSize bytes
+	bool grow(size_t bufferSize) override;
+
 private:
 	template <typename T>
 	void add_header(T addHeader) {
@@ -64,11 +87,16 @@ private:
 	}
 
 	MsgSize_t outputBufferStart = INITIAL_BUFFER_POSITION;
+	uint8_t sizeClass;
 };
 
+/**
+ * Sends the buffered output of game clients once per dispatcher cycle, so
+ * everything a cycle wrote to a client leaves in one message.
+ */
 class OutputMessagePool {
 public:
-	OutputMessagePool() = default;
+	OutputMessagePool();
 
 	// non-copyable
 	OutputMessagePool(const OutputMessagePool &) = delete;
@@ -79,15 +107,46 @@ public:
 	}
 
 	void sendAll();
-	void scheduleSendAll();
 
-	static OutputMessage_ptr getOutputMessage();
+	static OutputMessage_ptr getOutputMessage(size_t bodySize = 0);
 
-	void addProtocolToAutosend(Protocol_ptr protocol);
+	void addProtocolToAutosend(const Protocol_ptr &protocol);
 	void removeProtocolFromAutosend(const Protocol_ptr &protocol);
 
+	// Called by the protocol when it starts a new buffer
+	void addPendingProtocol(const Protocol_ptr &protocol);
+
+private:
+	// Autosent protocols with a buffer to send, each at most once. Autosend membership is a flag on the protocol, so removal is O(1)
+	std::vector<Protocol_ptr> pendingProtocols;
+	std::vector<Protocol_ptr> sendingProtocols;
+};
+
+/**
+ * Packet broadcast to many clients, e.g. a magic effect to every spectator.
+ * It is serialized once per protocol variant, on first use, and the same
+ * bytes are appended to the output of every recipient before it gets
+ * encrypted for that connection. A packet must only be reused with the
+ * arguments it was first written with.
+ */
+class BroadcastPacket {
+public:
+	BroadcastPacket() = default;
+
+	// non-copyable
+	BroadcastPacket(const BroadcastPacket &) = delete;
+	BroadcastPacket &operator=(const BroadcastPacket &) = delete;
+
+	template <typename Writer>
+	const OutputMessage_ptr &get(bool oldProtocol, Writer &&writer) {
+		auto &packet = packets[oldProtocol ? 1 : 0];
+		if (!packet) {
+			packet = OutputMessagePool::getOutputMessage();
+			writer(*packet);
+		}
+		return packet;
+	}
+
 private:
-	// NOTE: A vector is used here because this container is mostly read
-	// and relatively rarely modified (only when a client connects/disconnects)
-	std::vector<Protocol_ptr> bufferedProtocols;
+	std::array<OutputMessage_ptr, 2> packets;
 };
@@ -0,0 +1,43 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "server/network/protocol/network_profiler.hpp"
+
+namespace {
+	// "void ProtocolGame::sendMagicEffect(const Position&, ...)" -> "ProtocolGame::sendMagicEffect"
+	std::string_view getFunctionName(std::string_view signature) {
+		signature = signature.substr(0, signature.find('('));
+		if (const auto space = signature.rfind(' '); space != std::string_view::npos) {
+			signature.remove_prefix(space + 1);
+		}
+		return signature;
+	}
+}
+
+NetworkProfiler &NetworkProfiler::getInstance() {
+	return inject<NetworkProfiler>();
+}
+
+std::vector<std::pair<std::string_view, SendProfile>> NetworkProfiler::getSortedSends() const {
+	// Overloads of a send function are reported together
+	phmap::flat_hash_map<std::string_view, SendProfile> merged;
+	for (const auto &[function, profile] : sends) {
+		auto &total = merged[getFunctionName(function)];
+		total.messages += profile.messages;
+		total.bytes += profile.bytes;
+	}
+
+	std::vector<std::pair<std::string_view, SendProfile>> sorted(merged.begin(), merged.end());
+	std::ranges::sort(sorted, [](const auto &lhs, const auto &rhs) {
+		return lhs.second.bytes > rhs.second.bytes;
+	});
+	return sorted;
+}
@@ -0,0 +1,76 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/scheduling/task_profiler.hpp"
+
+struct OpcodeProfile {
+	uint64_t calls = 0;
+	uint64_t bytes = 0;
+	TaskHistogram execution;
+};
+
+struct SendProfile {
+	uint64_t messages = 0;
+	uint64_t bytes = 0;
+};
+
+/**
+ * Game protocol accounting: parse time of every client opcode and bytes
+ * written by every send function. Only the game thread records and reads
+ * it, so it takes no lock.
+ */
+class NetworkProfiler {
+public:
+	// Ensures that we don't accidentally copy it
+	NetworkProfiler() = default;
+	NetworkProfiler(const NetworkProfiler &) = delete;
+	NetworkProfiler operator=(const NetworkProfiler &) = delete;
+
+	static NetworkProfiler &getInstance();
+
+	void recordPacket(uint8_t opcode, uint32_t bytes, uint64_t executionUs) {
+		auto &profile = opcodes[opcode];
+		++profile.calls;
+		profile.bytes += bytes;
+		profile.execution.add(executionUs);
+	}
+
+	// Keyed by std::source_location::function_name(), which is unique per function
+	void recordSend(const char* function, uint32_t bytes) {
+		auto &profile = sends[function];
+		++profile.messages;
+		profile.bytes += bytes;
+	}
+
+	const std::array<OpcodeProfile, 256> &getOpcodeProfiles() const {
+		return opcodes;
+	}
+
+	// Send functions sorted by bytes written, most expensive first
+	std::vector<std::pair<std::string_view, SendProfile>> getSortedSends() const;
+
+	void reset() {
+		opcodes = {};
+		sends.clear();
+		startedAt = std::chrono::steady_clock::now();
+	}
+
+	std::chrono::steady_clock::time_point getStartedAt() const {
+		return startedAt;
+	}
+
+private:
+	std::array<OpcodeProfile, 256> opcodes {};
+	phmap::flat_hash_map<const char*, SendProfile> sends;
+	std::chrono::steady_clock::time_point startedAt = std::chrono::steady_clock::now();
+};
+
+constexpr auto g_networkProfiler = NetworkProfiler::getInstance;
@@ -12,7 +12,9 @@
 #include "server/network/protocol/protocol.hpp"
 #include "server/network/message/outputmessage.hpp"
 #include "security/rsa.hpp"
+#include "security/xtea.hpp"
 #include "game/scheduling/dispatcher.hpp"
+#include "lib/thread/thread_pool.hpp"
 
 Protocol::~Protocol() {
 	if (compreesionEnabled) {
@@ -33,11 +35,16 @@ void Protocol::onSendMessage(const OutputMessage_ptr &msg) {
 			return;
 		}
 
+		if (checksumMethod == CHECKSUM_METHOD_ADLER32) {
+			AdlerChecksum checksum;
+			XTEA_encrypt(*msg, &checksum);
+			msg->addCryptoHeader(true, checksum.value());
+			return;
+		}
+
 		XTEA_encrypt(*msg);
 		if (checksumMethod == CHECKSUM_METHOD_NONE) {
 			msg->addCryptoHeader(false, 0);
-		} else if (checksumMethod == CHECKSUM_METHOD_ADLER32) {
-			msg->addCryptoHeader(true, adlerChecksum(msg->getOutputBuffer(), msg->getLength()));
 		} else if (checksumMethod == CHECKSUM_METHOD_SEQUENCE) {
 			msg->addCryptoHeader(true, sendMessageChecksum | (++serverSequenceNumber));
 			if (serverSequenceNumber >= 0x7FFFFFFF) {
@@ -108,44 +115,34 @@ bool Protocol::onRecvMessage(NetworkMessage &msg) {
 OutputMessage_ptr Protocol::getOutputBuffer(int32_t size) {
 	// dispatcher thread
 	if (!outputBuffer) {
-		outputBuffer = OutputMessagePool::getOutputMessage();
+		outputBuffer = OutputMessagePool::getOutputMessage(size);
+		OutputMessagePool::getInstance().addPendingProtocol(shared_from_this());
 	} else if ((outputBuffer->getLength() + size) > MAX_PROTOCOL_BODY_LENGTH) {
 		send(outputBuffer);
-		outputBuffer = OutputMessagePool::getOutputMessage();
+		outputBuffer = OutputMessagePool::getOutputMessage(size);
 	}
 	return outputBuffer;
 }
 
-void Protocol::XTEA_encrypt(OutputMessage &msg) const {
-	const uint32_t delta = 0x61C88647;
-
+void Protocol::XTEA_encrypt(OutputMessage &msg, AdlerChecksum* checksum /* = nullptr*/) const {
 	// The message must be a multiple of 8
 	size_t paddingBytes = msg.getLength() & 7;
 	if (paddingBytes != 0) {
 		msg.addPaddingBytes(8 - paddingBytes);
 	}
 
-	uint8_t* buffer = msg.getOutputBuffer();
-	auto messageLength = static_cast<int32_t>(msg.getLength());
-	int32_t readPos = 0;
-	const std::array<uint32_t, 4> newKey = { key[0], key[1], key[2], key[3] };
-	// TODO: refactor this for not use c-style
-	uint32_t precachedControlSum[32][2];
-	uint32_t sum = 0;
-	for (int32_t i = 0; i < 32; ++i) {
-		precachedControlSum[i][0] = (sum + newKey[sum & 3]);
-		sum -= delta;
-		precachedControlSum[i][1] = (sum + newKey[(sum >> 11) & 3]);
+	if (!checksum) {
+		XTEA::encrypt(msg.getOutputBuffer(), msg.getLength(), key);
+		return;
 	}
-	while (readPos < messageLength) {
-		std::array<uint32_t, 2> vData = {};
-		memcpy(vData.data(), buffer + readPos, 8);
-		for (int32_t i = 0; i < 32; ++i) {
-			vData[0] += ((vData[1] << 4 ^ vData[1] >> 5) + vData[1]) ^ precachedControlSum[i][0];
-			vData[1] += ((vData[0] << 4 ^ vData[0] >> 5) + vData[0]) ^ precachedControlSum[i][1];
-		}
-		memcpy(buffer + readPos, vData.data(), 8);
-		readPos += 8;
+
+	// A multiple of the XTEA block, small enough to still be in L1 when summed
+	constexpr size_t PART_SIZE = 4096;
+	uint8_t* data = msg.getOutputBuffer();
+	for (size_t offset = 0, length = msg.getLength(); offset < length; offset += PART_SIZE) {
+		const size_t partLength = std::min(PART_SIZE, length - offset);
+		XTEA::encrypt(data + offset, partLength, key);
+		checksum->update(data + offset, partLength);
 	}
 }
 
@@ -155,30 +152,7 @@ bool Protocol::XTEA_decrypt(NetworkMessage &msg) const {
 		return false;
 	}
 
-	const uint32_t delta = 0x61C88647;
-
-	uint8_t* buffer = msg.getBuffer() + msg.getBufferPosition();
-	auto messageLength = static_cast<int32_t>(msgLength);
-	int32_t readPos = 0;
-	const std::array<uint32_t, 4> newKey = { key[0], key[1], key[2], key[3] };
-	// TODO: refactor this for not use c-style
-	uint32_t precachedControlSum[32][2];
-	uint32_t sum = 0xC6EF3720;
-	for (int32_t i = 0; i < 32; ++i) {
-		precachedControlSum[i][0] = (sum + newKey[(sum >> 11) & 3]);
-		sum += delta;
-		precachedControlSum[i][1] = (sum + newKey[sum & 3]);
-	}
-	while (readPos < messageLength) {
-		std::array<uint32_t, 2> vData = {};
-		memcpy(vData.data(), buffer + readPos, 8);
-		for (int32_t i = 0; i < 32; ++i) {
-			vData[1] -= ((vData[0] << 4 ^ vData[0] >> 5) + vData[0]) ^ precachedControlSum[i][0];
-			vData[0] -= ((vData[1] << 4 ^ vData[1] >> 5) + vData[1]) ^ precachedControlSum[i][1];
-		}
-		memcpy(buffer + readPos, vData.data(), 8);
-		readPos += 8;
-	}
+	XTEA::decrypt(msg.getBuffer() + msg.getBufferPosition(), msgLength, key);
 
 	uint16_t innerLength = msg.get<uint16_t>();
 	if (std::cmp_greater(innerLength, msgLength - 2)) {
@@ -189,6 +163,30 @@ bool Protocol::XTEA_decrypt(NetworkMessage &msg) const {
 	return true;
 }
 
+namespace {
+	// Logins queued or running on the thread pool
+	std::atomic<int32_t> pendingLogins = 0;
+}
+
+bool Protocol::addLoginLoad(std::function<void(void)> &&load) {
+	const auto maxPendingLogins = g_configManager().getNumber(MAX_PENDING_LOGINS);
+	if (maxPendingLogins <= 0) {
+		load();
+		return true;
+	}
+
+	if (pendingLogins.fetch_add(1, std::memory_order_relaxed) >= maxPendingLogins) {
+		pendingLogins.fetch_sub(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	inject<ThreadPool>().addBlockingLoad([load = std::move(load)]() {
+		load();
+		pendingLogins.fetch_sub(1, std::memory_order_relaxed);
+	});
+	return true;
+}
+
 bool Protocol::RSA_decrypt(NetworkMessage &msg) {
 	if ((msg.getLength() - msg.getBufferPosition()) < 128) {
 		return false;
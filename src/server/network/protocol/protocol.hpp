@@ -11,6 +11,9 @@
 
 #include "server/network/connection/connection.hpp"
 #include "config/configmanager.hpp"
+#include "lib/profiling/profiler.hpp"
+
+class AdlerChecksum;
 
 class Protocol : public std::enable_shared_from_this<Protocol> {
 public:
@@ -28,8 +31,11 @@ public:
 	virtual void onSendMessage(const OutputMessage_ptr &msg);
 	bool onRecvMessage(NetworkMessage &msg);
 	bool sendRecvMessageCallback(NetworkMessage &msg);
-	virtual void onRecvFirstMessage(NetworkMessage &msg) = 0;
+	// Returns true when the message is still being handled, reading then waits for Connection::resumeWork() as with onRecvMessage
+	virtual bool onRecvFirstMessage(NetworkMessage &msg) = 0;
 	virtual void onConnect() { }
+	// The protocol_name() of the concrete type, the connection reports its traffic under it
+	virtual const char* getProtocolName() const = 0;
 
 	bool isConnectionExpired() const {
 		return connectionPtr.expired();
@@ -49,6 +55,7 @@ public:
 	}
 
 	void send(OutputMessage_ptr msg) const {
+		CANARY_PROFILE_ZONE("Protocol::send");
 		if (auto connection = getConnection();
 			connection != nullptr) {
 			connection->send(msg);
@@ -75,6 +82,13 @@ protected:
 
 	static bool RSA_decrypt(NetworkMessage &msg);
 
+	/**
+	 * Runs the expensive part of a login (RSA, password hashing, account
+	 * queries) on the blocking thread pool instead of the network thread.
+	 * Returns false, without running it, when too many logins are pending.
+	 */
+	static bool addLoginLoad(std::function<void(void)> &&load);
+
 	void setRawMessages(bool value) {
 		rawMessages = value;
 	}
@@ -82,7 +96,8 @@ protected:
 	virtual void release() { }
 
 private:
-	void XTEA_encrypt(OutputMessage &msg) const;
+	// With a checksum, it is fed each part of the message right after that part is encrypted
+	void XTEA_encrypt(OutputMessage &msg, AdlerChecksum* checksum = nullptr) const;
 	bool XTEA_decrypt(NetworkMessage &msg) const;
 	bool compression(OutputMessage &msg) const;
 
@@ -97,6 +112,9 @@ private:
 	bool encryptionEnabled = false;
 	bool rawMessages = false;
 	bool compreesionEnabled = false;
+	// Flushed by OutputMessagePool at the end of every dispatcher cycle
+	bool autosend = false;
 
 	friend class Connection;
+	friend class OutputMessagePool;
 };
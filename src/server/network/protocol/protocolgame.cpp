@@ -19,6 +19,7 @@
 #include "io/io_bosstiary.hpp"
 #include "io/iologindata.hpp"
 #include "io/iomarket.hpp"
+#include "kv/kv.hpp"
 #include "lua/modules/modules.hpp"
 #include "creatures/monsters/monster.hpp"
 #include "creatures/monsters/monsters.hpp"
@@ -27,6 +28,8 @@
 #include "creatures/players/wheel/player_wheel.hpp"
 #include "creatures/players/grouping/familiars.hpp"
 #include "server/network/protocol/protocolgame.hpp"
+#include "server/network/protocol/network_profiler.hpp"
+#include "server/network/protocol/session_recording.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/scheduler.hpp"
 #include "creatures/combat/spells.hpp"
@@ -41,6 +44,10 @@
 // This "getIteration" function will allow us to get the total number of iterations that run within a specific map
 // Very useful to send the total amount in certain bytes in the ProtocolGame class
 namespace {
+	bool networkProfilerEnabled() {
+		return g_configManager().getBoolean(TOGGLE_NETWORK_PROFILER);
+	}
+
 	template <typename T>
 	uint16_t getIterationIncreaseCount(T &map) {
 		uint16_t totalIterationCount = 0;
@@ -245,7 +252,7 @@ void ProtocolGame::addGameTask(Callable function, Args &&... args) {
 }
 
 template <typename Callable, typename... Args>
-void ProtocolGame::addGameTaskTimed(uint32_t delay, std::string context, Callable function, Args &&... args) {
+void ProtocolGame::addGameTaskTimed(uint32_t delay, std::string_view context, Callable function, Args &&... args) {
 	g_dispatcher().addTask(std::bind(function, &g_game(), std::forward<Args>(args)...), context, delay);
 }
 
@@ -446,6 +453,11 @@ void ProtocolGame::AddItem(NetworkMessage &msg, std::shared_ptr<Item> item) {
 
 void ProtocolGame::release() {
 	// dispatcher thread
+	if (recordedSession != 0) {
+		g_sessionRecorder().addDisconnect(recordedSession);
+		recordedSession = 0;
+	}
+
 	if (player && player->client == shared_from_this()) {
 		player->client.reset();
 		player = nullptr;
@@ -456,6 +468,11 @@ void ProtocolGame::release() {
 }
 
 void ProtocolGame::login(const std::string &name, uint32_t accountId, OperatingSystem_t operatingSystem) {
+	// Whatever the outcome, a replay of the login gets the same one
+	if (g_sessionRecorder().isRecording()) {
+		recordedSession = g_sessionRecorder().addLogin(name, accountId, operatingSystem);
+	}
+
 	// OTCV8 features
 	if (otclientV8 > 0) {
 		sendFeatures();
@@ -473,6 +490,7 @@ void ProtocolGame::login(const std::string &name, uint32_t accountId, OperatingS
 	// dispatcher thread
 	std::shared_ptr<Player> foundPlayer = g_game().getPlayerUniqueLogin(name);
 	if (!foundPlayer) {
+		DBPrefetch prefetch(std::move(loginPrefetch));
 		player = std::make_shared<Player>(getThis());
 		player->setName(name);
 		g_game().addPlayerUniqueLogin(player);
@@ -659,12 +677,25 @@ void ProtocolGame::logout(bool displayEffect, bool forced) {
 	g_game().removeCreature(player, true);
 }
 
-void ProtocolGame::onRecvFirstMessage(NetworkMessage &msg) {
+bool ProtocolGame::onRecvFirstMessage(NetworkMessage &msg) {
 	if (g_game().getGameState() == GAME_STATE_SHUTDOWN) {
 		disconnect();
-		return;
+		return false;
 	}
 
+	// The connection buffer is reused by the next read, so the worker gets its own copy
+	auto firstMessage = std::make_shared<NetworkMessage>(msg);
+	if (!addLoginLoad([self = getThis(), firstMessage]() { self->parseFirstMessage(*firstMessage); })) {
+		g_logger().warn("[ProtocolGame::onRecvFirstMessage] - Too many pending logins, dropping connection from {}", convertIPToString(getIP()));
+		disconnect();
+		return false;
+	}
+
+	// Reading resumes once the XTEA key is known
+	return true;
+}
+
+void ProtocolGame::parseFirstMessage(NetworkMessage &msg) {
 	OperatingSystem_t operatingSystem = static_cast<OperatingSystem_t>(msg.get<uint16_t>());
 	version = msg.get<uint16_t>(); // Protocol version
 
@@ -687,7 +718,7 @@ void ProtocolGame::onRecvFirstMessage(NetworkMessage &msg) {
 	msg.skipBytes(3); // U16 dat revision, U8 game preview state
 
 	if (!Protocol::RSA_decrypt(msg)) {
-		g_logger().warn("[ProtocolGame::onRecvFirstMessage] - RSA Decrypt Failed");
+		g_logger().warn("[ProtocolGame::parseFirstMessage] - RSA Decrypt Failed");
 		disconnect();
 		return;
 	}
@@ -798,15 +829,21 @@ void ProtocolGame::onRecvFirstMessage(NetworkMessage &msg) {
 		return;
 	}
 
+	// Still on the login thread, so loading the player on the game thread doesn't wait on the database
+	if (const auto guid = IOLoginData::getGuidByName(characterName); guid != 0) {
+		loginPrefetch = DBPrefetch::fetch(IOLoginDataLoad::getPrefetchQueries(characterName, guid, accountId));
+		g_kv().scoped("player")->scoped(Player::getFirstID() + guid)->prefetch();
+	}
+
 	g_dispatcher().addTask(std::bind(&ProtocolGame::login, getThis(), characterName, accountId, operatingSystem), "ProtocolGame::login");
+
+	if (auto connection = getConnection()) {
+		connection->resumeWork();
+	}
 }
 
 void ProtocolGame::onConnect() {
 	auto output = OutputMessagePool::getOutputMessage();
-	static std::random_device rd;
-	static std::ranlux24 generator(rd());
-	static std::uniform_int_distribution<uint16_t> randNumber(0x00, 0xFF);
-
 	// Skip checksum
 	output->skipBytes(sizeof(uint32_t));
 
@@ -818,7 +855,7 @@ void ProtocolGame::onConnect() {
 	challengeTimestamp = static_cast<uint32_t>(time(nullptr));
 	output->add<uint32_t>(challengeTimestamp);
 
-	challengeRandom = randNumber(generator);
+	challengeRandom = static_cast<uint8_t>(uniform_random(0x00, 0xFF));
 	output->addByte(challengeRandom);
 
 	// Go back and write checksum
@@ -837,12 +874,49 @@ void ProtocolGame::disconnectClient(const std::string &message) const {
 	disconnect();
 }
 
-void ProtocolGame::writeToOutputBuffer(const NetworkMessage &msg) {
+void ProtocolGame::writeToOutputBuffer(const NetworkMessage &msg, const std::source_location &location /* = std::source_location::current()*/) {
+	if (networkProfilerEnabled() && g_dispatcher().isGameThread()) {
+		g_networkProfiler().recordSend(location.function_name(), msg.getLength());
+	}
+
+	if (stagingWrites) {
+		const auto* bytes = msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION;
+		stagedWrites.insert(stagedWrites.end(), bytes, bytes + msg.getLength());
+		stagedWriteLengths.emplace_back(static_cast<uint16_t>(msg.getLength()));
+		return;
+	}
+
 	auto out = getOutputBuffer(msg.getLength());
 	out->append(msg);
 }
 
+void ProtocolGame::endStagedWrites() {
+	stagingWrites = false;
+	size_t offset = 0;
+	for (const auto length : stagedWriteLengths) {
+		NetworkMessage msg;
+		msg.addBytes(reinterpret_cast<const char*>(stagedWrites.data() + offset), length);
+		offset += length;
+		writeToOutputBuffer(msg);
+	}
+	stagedWrites.clear();
+	stagedWriteLengths.clear();
+}
+
+void ProtocolGame::writeToOutputBuffer(const OutputMessage_ptr &packet, const std::source_location &location /* = std::source_location::current()*/) {
+	if (networkProfilerEnabled() && g_dispatcher().isGameThread()) {
+		g_networkProfiler().recordSend(location.function_name(), packet->getLength());
+	}
+
+	auto out = getOutputBuffer(packet->getLength());
+	out->append(packet);
+}
+
 void ProtocolGame::parsePacket(NetworkMessage &msg) {
+	if (recordedSession != 0) {
+		g_sessionRecorder().addPacket(recordedSession, msg);
+	}
+
 	if (!acceptPackets || g_game().getGameState() == GAME_STATE_SHUTDOWN || msg.getLength() <= 0) {
 		return;
 	}
@@ -868,7 +942,7 @@ void ProtocolGame::parsePacket(NetworkMessage &msg) {
 	}
 
 	// Modules system
-	if (player && recvbyte != 0xD3) {
+	if (player && recvbyte != 0xD3 && g_modules().hasRecvbyteModule(recvbyte)) {
 		g_dispatcher().addTask(std::bind(&Modules::executeOnRecvbyte, &g_modules(), player->getID(), msg, recvbyte), "Modules::executeOnRecvbyte");
 	}
 
@@ -940,6 +1014,14 @@ void ProtocolGame::parsePacketFromDispatcher(NetworkMessage msg, uint8_t recvbyt
 		return;
 	}
 
+	if (g_dispatcher().getRecorder().isRunning()) {
+		g_dispatcher().getRecorder().setTaskInfo(player->getID(), recvbyte);
+	}
+
+	const bool profiled = networkProfilerEnabled();
+	const auto packetLength = msg.getLength();
+	const auto startedAt = profiled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point {};
+
 	switch (recvbyte) {
 		case 0x14:
 			g_dispatcher().addTask(std::bind(&ProtocolGame::logout, getThis(), true, false), "ProtocolGame::logout");
@@ -1314,6 +1396,16 @@ void ProtocolGame::parsePacketFromDispatcher(NetworkMessage msg, uint8_t recvbyt
 			g_logger().debug("Player '{}' sent unknown packet header: hex[{}], decimal[{}]", player->getName(), asUpperCaseString(hexString), recvbyte);
 			break;
 	}
+
+	if (profiled) {
+		const auto executionUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startedAt).count());
+		g_networkProfiler().recordPacket(recvbyte, packetLength, executionUs);
+
+		const auto slowPacketMs = g_configManager().getNumber(NETWORK_PROFILER_SLOW_PACKET_MS);
+		if (slowPacketMs > 0 && executionUs >= static_cast<uint64_t>(slowPacketMs) * 1000) {
+			g_logger().warn("[{}] packet 0x{:02X} ({} bytes) from player '{}' took {} ms", __FUNCTION__, recvbyte, packetLength, player ? player->getName() : "unknown", executionUs / 1000);
+		}
+	}
 }
 
 void ProtocolGame::parseHotkeyEquip(NetworkMessage &msg) {
@@ -1326,30 +1418,166 @@ void ProtocolGame::parseHotkeyEquip(NetworkMessage &msg) {
 	addGameTask(&Game::playerEquipItem, player->getID(), itemId, Item::items[itemId].upgradeClassification > 0, tier);
 }
 
+namespace {
+	// A tile description sends no more than this many things
+	constexpr int32_t MAX_TILE_THINGS = 10;
+	constexpr size_t MAX_ENCODED_TILES = 1 << 16;
+
+	struct EncodedTileItem {
+		const Item* item;
+		uint32_t attributeVersion;
+		uint16_t id;
+		uint8_t count;
+		// Where the item ends in the bytes
+		uint16_t end;
+	};
+
+	/**
+	 * The items of a tile as map descriptions send them, which is the same for
+	 * every viewer on the same protocol, only the creatures between the top
+	 * and the down items differ.
+	 */
+	struct EncodedTile {
+		// The ground and the top items, then the down items, as many of each as can be sent
+		std::vector<EncodedTileItem> items;
+		std::vector<uint8_t> bytes;
+		uint8_t topCount = 0;
+
+		void addItems(NetworkMessage &msg, size_t first, size_t count) const {
+			if (count == 0) {
+				return;
+			}
+
+			const size_t begin = first == 0 ? 0 : items[first - 1].end;
+			msg.addBytes(std::span<const uint8_t>(bytes).subspan(begin, items[first + count - 1].end - begin));
+		}
+	};
+
+	// Game thread only, one table per protocol flavour, started over when full or when the item types were reloaded
+	std::array<phmap::flat_hash_map<const Tile*, EncodedTile>, 2> encodedTiles;
+	uint32_t encodedItemsGeneration = 0;
+
+	/**
+	 * The cached encoding of the items of the tile, encoded again when they
+	 * changed in any way: an entry is checked against the items before use, by
+	 * address, id, count and attribute version, so no tile change has to
+	 * report to the cache. Nullptr for the tiles not worth caching and when
+	 * an item shows a timer, those are encoded on every send. The encoding
+	 * stays valid until the next call.
+	 */
+	template <typename EncodeItem>
+	const EncodedTile* getEncodedTile(const std::shared_ptr<Tile> &tile, bool oldProtocol, EncodeItem encodeItem) {
+		std::array<const std::shared_ptr<Item>*, 2 * MAX_TILE_THINGS> described;
+		size_t describedCount = 0;
+		const auto &ground = tile->getGround();
+		if (ground) {
+			described[describedCount++] = &ground;
+		}
+
+		const TileItemVector* items = tile->getItemList();
+		if (items) {
+			for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end && describedCount < MAX_TILE_THINGS; ++it) {
+				described[describedCount++] = &*it;
+			}
+		}
+		const size_t topCount = describedCount;
+		if (items) {
+			for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end && describedCount < topCount + MAX_TILE_THINGS; ++it) {
+				described[describedCount++] = &*it;
+			}
+		}
+
+		// A lone ground encodes as quick as it is looked up
+		if (describedCount < 2) {
+			return nullptr;
+		}
+
+		if (encodedItemsGeneration != Item::items.getGeneration()) {
+			encodedItemsGeneration = Item::items.getGeneration();
+			for (auto &flavourTiles : encodedTiles) {
+				flavourTiles.clear();
+			}
+		}
+
+		auto &tiles = encodedTiles[oldProtocol ? 1 : 0];
+		auto cached = tiles.find(tile.get());
+		if (cached != tiles.end() && cached->second.topCount == topCount && cached->second.items.size() == describedCount) {
+			const bool matches = std::ranges::equal(std::span(described.data(), describedCount), cached->second.items, [](const std::shared_ptr<Item>* item, const EncodedTileItem &encodedItem) {
+				return (*item).get() == encodedItem.item && (*item)->getAttributeVersion() == encodedItem.attributeVersion && (*item)->getID() == encodedItem.id && (*item)->getItemCount() == encodedItem.count;
+			});
+			if (matches) {
+				return &cached->second;
+			}
+		}
+
+		for (size_t i = 0; i < describedCount; ++i) {
+			const ItemType &it = Item::items[(*described[i])->getID()];
+			if (it.expire || it.expireStop || it.clockExpire) {
+				if (cached != tiles.end()) {
+					tiles.erase(cached);
+				}
+				return nullptr;
+			}
+		}
+
+		if (cached == tiles.end()) {
+			if (tiles.size() >= MAX_ENCODED_TILES) {
+				tiles.clear();
+			}
+			cached = tiles.try_emplace(tile.get()).first;
+		}
+
+		static NetworkMessage scratch;
+		scratch.reset();
+		auto &encoded = cached->second;
+		encoded.items.clear();
+		encoded.topCount = static_cast<uint8_t>(topCount);
+		const auto begin = scratch.getBufferPosition();
+		for (size_t i = 0; i < describedCount; ++i) {
+			const auto &item = *described[i];
+			encodeItem(scratch, item);
+			encoded.items.emplace_back(EncodedTileItem { item.get(), item->getAttributeVersion(), item->getID(), item->getItemCount(), static_cast<uint16_t>(scratch.getBufferPosition() - begin) });
+		}
+		encoded.bytes.assign(scratch.getBuffer() + begin, scratch.getBuffer() + scratch.getBufferPosition());
+		return &encoded;
+	}
+}
+
 void ProtocolGame::GetTileDescription(std::shared_ptr<Tile> tile, NetworkMessage &msg) {
 	if (oldProtocol) {
 		msg.add<uint16_t>(0x00); // Env effects
 	}
 
 	int32_t count;
-	std::shared_ptr<Item> ground = tile->getGround();
-	if (ground) {
-		AddItem(msg, ground);
-		count = 1;
+	const TileItemVector* items = tile->getItemList();
+	const EncodedTile* encoded = getEncodedTile(tile, oldProtocol, [this](NetworkMessage &itemMsg, const std::shared_ptr<Item> &item) {
+		AddItem(itemMsg, item);
+	});
+	if (encoded) {
+		count = std::min<int32_t>(encoded->topCount, tile->getPosition() == player->getPosition() ? MAX_TILE_THINGS - 1 : MAX_TILE_THINGS);
+		encoded->addItems(msg, 0, count);
+		if (count == MAX_TILE_THINGS) {
+			return;
+		}
 	} else {
-		count = 0;
-	}
+		std::shared_ptr<Item> ground = tile->getGround();
+		if (ground) {
+			AddItem(msg, ground);
+			count = 1;
+		} else {
+			count = 0;
+		}
 
-	const TileItemVector* items = tile->getItemList();
-	if (items) {
-		for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
-			AddItem(msg, *it);
+		if (items) {
+			for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
+				AddItem(msg, *it);
 
-			count++;
-			if (count == 9 && tile->getPosition() == player->getPosition()) {
-				break;
-			} else if (count == 10) {
-				return;
+				count++;
+				if (count == 9 && tile->getPosition() == player->getPosition()) {
+					break;
+				} else if (count == 10) {
+					return;
+				}
 			}
 		}
 	}
@@ -1382,7 +1610,9 @@ void ProtocolGame::GetTileDescription(std::shared_ptr<Tile> tile, NetworkMessage
 		}
 	}
 
-	if (items) {
+	if (encoded) {
+		encoded->addItems(msg, encoded->topCount, std::min<int32_t>(encoded->items.size() - encoded->topCount, MAX_TILE_THINGS - count));
+	} else if (items) {
 		for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
 			AddItem(msg, *it);
 
@@ -1441,45 +1671,46 @@ void ProtocolGame::GetFloorDescription(NetworkMessage &msg, int32_t x, int32_t y
 }
 
 void ProtocolGame::checkCreatureAsKnown(uint32_t id, bool &known, uint32_t &removedKnown) {
-	if (auto [creatureKnown, creatureInserted] = knownCreatureSet.insert(id);
-		!creatureInserted) {
+	removedKnown = 0;
+	if (auto it = knownCreatureSet.find(id); it != knownCreatureSet.end()) {
+		knownCreatureOrder.splice(knownCreatureOrder.begin(), knownCreatureOrder, it->second);
 		known = true;
 		return;
 	}
+
 	known = false;
-	if (knownCreatureSet.size() > 1300) {
-		// Look for a creature to remove
-		for (auto it = knownCreatureSet.begin(), end = knownCreatureSet.end(); it != end; ++it) {
-			if (*it == id) {
-				continue;
-			}
-			// We need to protect party players from removing
-			std::shared_ptr<Creature> creature = g_game().getCreatureByID(*it);
-			if (std::shared_ptr<Player> checkPlayer;
-				creature && (checkPlayer = creature->getPlayer()) != nullptr) {
-				if (player->getParty() != checkPlayer->getParty() && !canSee(creature)) {
-					removedKnown = *it;
-					knownCreatureSet.erase(it);
-					return;
-				}
-			} else if (!canSee(creature)) {
-				removedKnown = *it;
-				knownCreatureSet.erase(it);
-				return;
-			}
-		}
+	knownCreatureOrder.push_front(id);
+	knownCreatureSet.emplace(id, knownCreatureOrder.begin());
+	if (knownCreatureSet.size() <= MAX_KNOWN_CREATURES) {
+		return;
+	}
 
-		// Bad situation. Let's just remove anyone.
-		auto it = knownCreatureSet.begin();
-		if (*it == id) {
-			++it;
+	// The least recently described goes, unless it is still in view: those move to the front, so the next search skips them
+	const auto removeKnown = [this, &removedKnown](std::list<uint32_t>::iterator it) {
+		removedKnown = *it;
+		knownCreatureStates.erase(removedKnown);
+		knownCreatureSet.erase(removedKnown);
+		knownCreatureOrder.erase(it);
+	};
+
+	for (size_t checked = 1; checked < knownCreatureOrder.size(); ++checked) {
+		const auto it = std::prev(knownCreatureOrder.end());
+		// We need to protect party players from removing
+		std::shared_ptr<Creature> creature = g_game().getCreatureByID(*it);
+		std::shared_ptr<Player> checkPlayer = creature ? creature->getPlayer() : nullptr;
+		if (!canSee(creature) && (!checkPlayer || player->getParty() != checkPlayer->getParty())) {
+			removeKnown(it);
+			return;
 		}
+		knownCreatureOrder.splice(knownCreatureOrder.begin(), knownCreatureOrder, it);
+	}
 
-		removedKnown = *it;
-		knownCreatureSet.erase(it);
-	} else {
-		removedKnown = 0;
+	// Bad situation. Let's just remove anyone.
+	auto it = std::prev(knownCreatureOrder.end());
+	if (*it == id) {
+		--it;
 	}
+	removeKnown(it);
 }
 
 bool ProtocolGame::canSee(std::shared_ptr<Creature> c) const {
@@ -2812,7 +3043,7 @@ void ProtocolGame::BestiarysendCharms() {
 	msg.addByte(4); // Unknown
 
 	auto finishedMonstersSet = g_iobestiary().getBestiaryFinished(player);
-	std::list<charmRune_t> usedRunes = g_iobestiary().getCharmUsedRuneBitAll(player);
+	const auto usedRunes = g_iobestiary().getCharmUsedRuneBitAll(player);
 
 	for (charmRune_t charmRune : usedRunes) {
 		const auto tmpCharm = g_iobestiary().getBestiaryCharm(charmRune);
@@ -3174,11 +3405,37 @@ void ProtocolGame::sendWorldLight(const LightInfo &lightInfo) {
 	writeToOutputBuffer(msg);
 }
 
+void ProtocolGame::sendWorldLight(const LightInfo &lightInfo, BroadcastPacket &packet) {
+	if (!player) {
+		return;
+	}
+
+	// Access players always see full light, the shared packet is not theirs
+	if (player->isAccessPlayer()) {
+		if (knownWorldLight != std::pair<uint8_t, uint8_t>(0xFF, lightInfo.color)) {
+			sendWorldLight(lightInfo);
+		}
+		return;
+	}
+
+	if (knownWorldLight == std::make_pair(lightInfo.level, lightInfo.color)) {
+		return;
+	}
+
+	knownWorldLight.emplace(lightInfo.level, lightInfo.color);
+	writeToOutputBuffer(packet.get(oldProtocol, [&](NetworkMessageBase &msg) {
+		msg.addByte(0x82);
+		msg.addByte(lightInfo.level);
+		msg.addByte(lightInfo.color);
+	}));
+}
+
 void ProtocolGame::sendTibiaTime(int32_t time) {
 	if (!player || oldProtocol) {
 		return;
 	}
 
+	knownTibiaTime = time;
 	NetworkMessage msg;
 	msg.addByte(0xEF);
 	msg.addByte(time / 60);
@@ -3186,8 +3443,21 @@ void ProtocolGame::sendTibiaTime(int32_t time) {
 	writeToOutputBuffer(msg);
 }
 
+void ProtocolGame::sendTibiaTime(int32_t time, BroadcastPacket &packet) {
+	if (!player || oldProtocol || knownTibiaTime == time) {
+		return;
+	}
+
+	knownTibiaTime = time;
+	writeToOutputBuffer(packet.get(oldProtocol, [&](NetworkMessageBase &msg) {
+		msg.addByte(0xEF);
+		msg.addByte(time / 60);
+		msg.addByte(time % 60);
+	}));
+}
+
 void ProtocolGame::sendCreatureWalkthrough(std::shared_ptr<Creature> creature, bool walkthrough) {
-	if (!canSee(creature)) {
+	if (!canSee(creature) || !updateKnownCreatureState(creature->getID(), &KnownCreatureState::walkthrough, walkthrough)) {
 		return;
 	}
 
@@ -3203,10 +3473,15 @@ void ProtocolGame::sendCreatureShield(std::shared_ptr<Creature> creature) {
 		return;
 	}
 
+	const uint8_t shield = player->getPartyShield(creature->getPlayer());
+	if (!updateKnownCreatureState(creature->getID(), &KnownCreatureState::shield, shield)) {
+		return;
+	}
+
 	NetworkMessage msg;
 	msg.addByte(0x91);
 	msg.add<uint32_t>(creature->getID());
-	msg.addByte(player->getPartyShield(creature->getPlayer()));
+	msg.addByte(shield);
 	writeToOutputBuffer(msg);
 }
 
@@ -3241,10 +3516,15 @@ void ProtocolGame::sendCreatureSkull(std::shared_ptr<Creature> creature) {
 		return;
 	}
 
+	const uint8_t skull = player->getSkullClient(creature);
+	if (!updateKnownCreatureState(creature->getID(), &KnownCreatureState::skull, skull)) {
+		return;
+	}
+
 	NetworkMessage msg;
 	msg.addByte(0x90);
 	msg.add<uint32_t>(creature->getID());
-	msg.addByte(player->getSkullClient(creature));
+	msg.addByte(skull);
 	writeToOutputBuffer(msg);
 }
 
@@ -4157,15 +4437,20 @@ void ProtocolGame::sendChannel(uint16_t channelId, const std::string &channelNam
 }
 
 void ProtocolGame::sendChannelMessage(const std::string &author, const std::string &text, SpeakClasses type, uint16_t channel) {
-	NetworkMessage msg;
-	msg.addByte(0xAA);
-	msg.add<uint32_t>(0x00);
-	msg.addString(author);
-	msg.add<uint16_t>(0x00);
-	msg.addByte(type);
-	msg.add<uint16_t>(channel);
-	msg.addString(text);
-	writeToOutputBuffer(msg);
+	BroadcastPacket packet;
+	sendChannelMessage(author, text, type, channel, packet);
+}
+
+void ProtocolGame::sendChannelMessage(const std::string &author, const std::string &text, SpeakClasses type, uint16_t channel, BroadcastPacket &packet) {
+	writeToOutputBuffer(packet.get(oldProtocol, [&](NetworkMessageBase &msg) {
+		msg.addByte(0xAA);
+		msg.add<uint32_t>(0x00);
+		msg.addString(author);
+		msg.add<uint16_t>(0x00);
+		msg.addByte(type);
+		msg.add<uint16_t>(channel);
+		msg.addString(text);
+	}));
 }
 
 void ProtocolGame::sendIcons(uint32_t icons) {
@@ -4352,12 +4637,12 @@ void ProtocolGame::sendShop(std::shared_ptr<Npc> npc) {
 		msg.addString(std::string()); // Currency name
 	}
 
-	std::vector<ShopBlock> shoplist = npc->getShopItemVector();
+	const auto &shoplist = npc->getShopItemVector();
 	uint16_t itemsToSend = std::min<size_t>(shoplist.size(), std::numeric_limits<uint16_t>::max());
 	msg.add<uint16_t>(itemsToSend);
 
 	uint16_t i = 0;
-	for (ShopBlock shopBlock : shoplist) {
+	for (const ShopBlock &shopBlock : shoplist) {
 		if (++i > itemsToSend) {
 			break;
 		}
@@ -4465,7 +4750,7 @@ void ProtocolGame::sendSaleItemList(const std::vector<ShopBlock> &shopVector, co
 	auto msgPosition = msg.getBufferPosition();
 	msg.skipBytes(1);
 
-	for (ShopBlock shopBlock : shopVector) {
+	for (const ShopBlock &shopBlock : shopVector) {
 		if (shopBlock.itemSellPrice == 0) {
 			continue;
 		}
@@ -5120,60 +5405,55 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 	}
 
 	if (it.armor != 0) {
-		msg.addString(std::to_string(it.armor));
+		msg.addFormattedString("{}", it.armor);
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
 
 	if (it.isRanged()) {
-		std::ostringstream ss;
+		NetworkMessage::StringWriter ss(msg);
 		bool separator = false;
 
 		if (it.attack != 0) {
-			ss << "attack +" << it.attack;
+			ss.format("attack +{}", it.attack);
 			separator = true;
 		}
 
 		if (it.hitChance != 0) {
 			if (separator) {
-				ss << ", ";
+				ss.append(", ");
 			}
-			ss << "chance to hit +" << static_cast<int16_t>(it.hitChance) << "%";
+			ss.format("chance to hit +{}%", static_cast<int16_t>(it.hitChance));
 			separator = true;
 		}
 
 		if (it.shootRange != 0) {
 			if (separator) {
-				ss << ", ";
+				ss.append(", ");
 			}
-			ss << static_cast<uint16_t>(it.shootRange) << " fields";
+			ss.format("{} fields", static_cast<uint16_t>(it.shootRange));
 		}
-		msg.addString(ss.str());
 	} else if (!it.isRanged() && it.attack != 0) {
 		if (it.abilities && it.abilities->elementType != COMBAT_NONE && it.abilities->elementDamage != 0) {
-			std::ostringstream ss;
-			ss << it.attack << " physical +" << it.abilities->elementDamage << ' ' << getCombatName(it.abilities->elementType);
-			msg.addString(ss.str());
+			msg.addFormattedString("{} physical +{} {}", it.attack, it.abilities->elementDamage, getCombatName(it.abilities->elementType));
 		} else {
-			msg.addString(std::to_string(it.attack));
+			msg.addFormattedString("{}", it.attack);
 		}
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
 
 	if (it.isContainer()) {
-		msg.addString(std::to_string(it.maxItems));
+		msg.addFormattedString("{}", it.maxItems);
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
 
 	if (it.defense != 0 || it.isMissile()) {
 		if (it.extraDefense != 0) {
-			std::ostringstream ss;
-			ss << it.defense << ' ' << std::showpos << it.extraDefense << std::noshowpos;
-			msg.addString(ss.str());
+			msg.addFormattedString("{} {:+}", it.defense, it.extraDefense);
 		} else {
-			msg.addString(std::to_string(it.defense));
+			msg.addFormattedString("{}", it.defense);
 		}
 	} else {
 		msg.add<uint16_t>(0x00);
@@ -5182,7 +5462,7 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 	if (!it.description.empty()) {
 		const std::string &descr = it.description;
 		if (descr.back() == '.') {
-			msg.addString(std::string(descr, 0, descr.length() - 1));
+			msg.addString(std::string_view(descr).substr(0, descr.length() - 1));
 		} else {
 			msg.addString(descr);
 		}
@@ -5191,15 +5471,13 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 	}
 
 	if (it.decayTime != 0) {
-		std::ostringstream ss;
-		ss << it.decayTime << " seconds";
-		msg.addString(ss.str());
+		msg.addFormattedString("{} seconds", it.decayTime);
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
 
 	if (it.abilities) {
-		std::ostringstream ss;
+		NetworkMessage::StringWriter ss(msg);
 		bool separator = false;
 
 		for (size_t i = 0; i < COMBAT_COUNT; ++i) {
@@ -5208,27 +5486,25 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 			}
 
 			if (separator) {
-				ss << ", ";
+				ss.append(", ");
 			} else {
 				separator = true;
 			}
 
-			ss << fmt::format("{} {:+}%", getCombatName(indexToCombatType(i)), it.abilities->absorbPercent[i]);
+			ss.format("{} {:+}%", getCombatName(indexToCombatType(i)), it.abilities->absorbPercent[i]);
 		}
-
-		msg.addString(ss.str());
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
 
 	if (it.minReqLevel != 0) {
-		msg.addString(std::to_string(it.minReqLevel));
+		msg.addFormattedString("{}", it.minReqLevel);
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
 
 	if (it.minReqMagicLevel != 0) {
-		msg.addString(std::to_string(it.minReqMagicLevel));
+		msg.addFormattedString("{}", it.minReqMagicLevel);
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
@@ -5237,7 +5513,7 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 	msg.addString(it.runeSpellName);
 
 	if (it.abilities) {
-		std::ostringstream ss;
+		NetworkMessage::StringWriter ss(msg);
 		bool separator = false;
 
 		for (uint8_t i = SKILL_FIRST; i <= SKILL_FISHING; i++) {
@@ -5246,12 +5522,12 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 			}
 
 			if (separator) {
-				ss << ", ";
+				ss.append(", ");
 			} else {
 				separator = true;
 			}
 
-			ss << fmt::format("{} {:+}", getSkillName(i), it.abilities->skills[i]);
+			ss.format("{} {:+}", getSkillName(i), it.abilities->skills[i]);
 		}
 
 		for (uint8_t i = SKILL_CRITICAL_HIT_CHANCE; i <= SKILL_LAST; i++) {
@@ -5260,64 +5536,56 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 			}
 
 			if (separator) {
-				ss << ", ";
+				ss.append(", ");
 			} else {
 				separator = true;
 			}
 
-			ss << getSkillName(i) << ' ';
-			if (i != SKILL_CRITICAL_HIT_CHANCE) {
-				ss << std::showpos;
-			}
-			if (i == SKILL_LIFE_LEECH_AMOUNT || i == SKILL_MANA_LEECH_AMOUNT) {
-				ss << (it.abilities->skills[i] / 100.) << '%';
+			const bool leech = i == SKILL_LIFE_LEECH_AMOUNT || i == SKILL_MANA_LEECH_AMOUNT;
+			if (i == SKILL_CRITICAL_HIT_CHANCE) {
+				ss.format("{} {}%", getSkillName(i), it.abilities->skills[i]);
+			} else if (leech) {
+				ss.format("{} {:+}%", getSkillName(i), it.abilities->skills[i] / 100.);
 			} else {
-				ss << it.abilities->skills[i] << '%';
-			}
-
-			if (i != SKILL_CRITICAL_HIT_CHANCE) {
-				ss << std::noshowpos;
+				ss.format("{} {:+}%", getSkillName(i), it.abilities->skills[i]);
 			}
 		}
 
 		if (it.abilities->stats[STAT_MAGICPOINTS] != 0) {
 			if (separator) {
-				ss << ", ";
+				ss.append(", ");
 			} else {
 				separator = true;
 			}
 
-			ss << fmt::format(" magic level {:+}", it.abilities->stats[STAT_MAGICPOINTS]);
+			ss.format(" magic level {:+}", it.abilities->stats[STAT_MAGICPOINTS]);
 		}
 
 		// Version 12.72 (Specialized magic level modifier)
 		for (uint8_t i = 1; i <= 11; i++) {
 			if (it.abilities->specializedMagicLevel[i]) {
 				if (separator) {
-					ss << ", ";
+					ss.append(", ");
 				} else {
 					separator = true;
 				}
-				std::string combatName = getCombatName(indexToCombatType(i));
-				ss << std::showpos << combatName << std::noshowpos << "magic level +" << it.abilities->specializedMagicLevel[i];
+				ss.format("{}magic level +{}", getCombatName(indexToCombatType(i)), it.abilities->specializedMagicLevel[i]);
 			}
 		}
 
 		if (it.abilities->speed != 0) {
 			if (separator) {
-				ss << ", ";
+				ss.append(", ");
 			}
 
-			ss << fmt::format("speed {:+}", (it.abilities->speed >> 1));
+			ss.format("speed {:+}", (it.abilities->speed >> 1));
 		}
-
-		msg.addString(ss.str());
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
 
 	if (it.charges != 0) {
-		msg.addString(std::to_string(it.charges));
+		msg.addFormattedString("{}", it.charges);
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
@@ -5335,18 +5603,8 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 	msg.addString(weaponName);
 
 	if (it.weight != 0) {
-		std::ostringstream ss;
-		if (it.weight < 10) {
-			ss << "0.0" << it.weight;
-		} else if (it.weight < 100) {
-			ss << "0." << it.weight;
-		} else {
-			std::string weightString = std::to_string(it.weight);
-			weightString.insert(weightString.end() - 2, '.');
-			ss << weightString;
-		}
-		ss << " oz";
-		msg.addString(ss.str());
+		// In hundredths of an ounce
+		msg.addFormattedString("{}.{:02} oz", it.weight / 100, it.weight % 100);
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
@@ -5356,7 +5614,7 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 	}
 
 	if (it.imbuementSlot > 0) {
-		msg.addString(std::to_string(it.imbuementSlot));
+		msg.addFormattedString("{}", it.imbuementSlot);
 	} else {
 		msg.add<uint16_t>(0x00);
 	}
@@ -5364,35 +5622,26 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 	if (!oldProtocol) {
 		// Version 12.70 new skills
 		if (it.abilities) {
-			std::ostringstream string;
 			if (it.abilities->magicShieldCapacityFlat > 0) {
-				string.clear();
-				string << std::showpos << it.abilities->magicShieldCapacityFlat << std::noshowpos << " and " << it.abilities->magicShieldCapacityPercent << "%";
-				msg.addString(string.str());
+				msg.addFormattedString("{:+} and {}%", it.abilities->magicShieldCapacityFlat, it.abilities->magicShieldCapacityPercent);
 			} else {
 				msg.add<uint16_t>(0x00);
 			}
 
 			if (it.abilities->cleavePercent > 0) {
-				string.clear();
-				string << it.abilities->cleavePercent << "%";
-				msg.addString(string.str());
+				msg.addFormattedString("{}%", it.abilities->cleavePercent);
 			} else {
 				msg.add<uint16_t>(0x00);
 			}
 
 			if (it.abilities->reflectFlat[COMBAT_PHYSICALDAMAGE] > 0) {
-				string.clear();
-				string << it.abilities->reflectFlat[COMBAT_PHYSICALDAMAGE];
-				msg.addString(string.str());
+				msg.addFormattedString("{}", it.abilities->reflectFlat[COMBAT_PHYSICALDAMAGE]);
 			} else {
 				msg.add<uint16_t>(0x00);
 			}
 
 			if (it.abilities->perfectShotDamage > 0) {
-				string.clear();
-				string << std::showpos << it.abilities->perfectShotDamage << std::noshowpos << " at " << it.abilities->perfectShotRange << "%";
-				msg.addString(string.str());
+				msg.addFormattedString("{:+} at {}%", it.abilities->perfectShotDamage, it.abilities->perfectShotRange);
 			} else {
 				msg.add<uint16_t>(0x00);
 			}
@@ -5410,31 +5659,30 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 
 		// Upgrade and tier detail modifier
 		if (it.upgradeClassification > 0 && tier > 0) {
-			msg.addString(std::to_string(it.upgradeClassification));
-			std::ostringstream ss;
+			msg.addFormattedString("{}", it.upgradeClassification);
+			NetworkMessage::StringWriter ss(msg);
 
 			double chance;
 			if (it.isWeapon()) {
 				chance = 0.5 * tier + 0.05 * ((tier - 1) * (tier - 1));
-				ss << fmt::format("{} ({:.2f}% Onslaught)", static_cast<uint16_t>(tier), chance);
+				ss.format("{} ({:.2f}% Onslaught)", static_cast<uint16_t>(tier), chance);
 			} else if (it.isHelmet()) {
 				chance = 2 * tier + 0.05 * ((tier - 1) * (tier - 1));
-				ss << fmt::format("{} ({:.2f}% Momentum)", static_cast<uint16_t>(tier), chance);
+				ss.format("{} ({:.2f}% Momentum)", static_cast<uint16_t>(tier), chance);
 			} else if (it.isArmor()) {
 				chance = (0.0307576 * tier * tier) + (0.440697 * tier) + 0.026;
-				ss << fmt::format("{} ({:.2f}% Ruse)", static_cast<uint16_t>(tier), chance);
+				ss.format("{} ({:.2f}% Ruse)", static_cast<uint16_t>(tier), chance);
 			}
-			msg.addString(ss.str());
 		} else if (it.upgradeClassification > 0 && tier == 0) {
-			msg.addString(std::to_string(it.upgradeClassification));
-			msg.addString(std::to_string(tier));
+			msg.addFormattedString("{}", it.upgradeClassification);
+			msg.addFormattedString("{}", tier);
 		} else {
 			msg.add<uint16_t>(0x00);
 			msg.add<uint16_t>(0x00);
 		}
 	}
 
-	auto purchase = IOMarket::getInstance().getPurchaseStatistics()[itemId][tier];
+	auto purchase = IOMarket::getInstance().getStatistics(MARKETACTION_BUY, itemId, tier);
 	if (const MarketStatistics* purchaseStatistics = &purchase; purchaseStatistics) {
 		msg.addByte(0x01);
 		msg.add<uint32_t>(purchaseStatistics->numTransactions);
@@ -5451,7 +5699,7 @@ void ProtocolGame::sendMarketDetail(uint16_t itemId, uint8_t tier) {
 		msg.addByte(0x00); // send to old protocol ?
 	}
 
-	auto sale = IOMarket::getInstance().getSaleStatistics()[itemId][tier];
+	auto sale = IOMarket::getInstance().getStatistics(MARKETACTION_SELL, itemId, tier);
 	if (const MarketStatistics* saleStatistics = &sale; saleStatistics) {
 		msg.addByte(0x01);
 		msg.add<uint32_t>(saleStatistics->numTransactions);
@@ -5539,81 +5787,92 @@ void ProtocolGame::sendCreatureTurn(std::shared_ptr<Creature> creature, uint32_t
 }
 
 void ProtocolGame::sendCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, const Position* pos /* = nullptr*/) {
-	NetworkMessage msg;
-	msg.addByte(0xAA);
+	BroadcastPacket packet;
+	sendCreatureSay(creature, type, text, pos, packet);
+}
 
-	static uint32_t statementId = 0;
-	msg.add<uint32_t>(++statementId);
+void ProtocolGame::sendCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, const Position* pos, BroadcastPacket &packet) {
+	writeToOutputBuffer(packet.get(oldProtocol, [&](NetworkMessageBase &msg) {
+		msg.addByte(0xAA);
 
-	msg.addString(creature->getName());
+		static uint32_t statementId = 0;
+		msg.add<uint32_t>(++statementId);
 
-	if (!oldProtocol) {
-		msg.addByte(0x00); // Show (Traded)
-	}
+		msg.addString(creature->getName());
 
-	// Add level only for players
-	if (std::shared_ptr<Player> speaker = creature->getPlayer()) {
-		msg.add<uint16_t>(speaker->getLevel());
-	} else {
-		msg.add<uint16_t>(0x00);
-	}
+		if (!oldProtocol) {
+			msg.addByte(0x00); // Show (Traded)
+		}
 
-	if (oldProtocol && type >= TALKTYPE_MONSTER_LAST_OLDPROTOCOL && type != TALKTYPE_CHANNEL_R2) {
-		msg.addByte(TALKTYPE_MONSTER_SAY);
-	} else {
-		msg.addByte(type);
-	}
+		// Add level only for players
+		if (std::shared_ptr<Player> speaker = creature->getPlayer()) {
+			msg.add<uint16_t>(speaker->getLevel());
+		} else {
+			msg.add<uint16_t>(0x00);
+		}
 
-	if (pos) {
-		msg.addPosition(*pos);
-	} else {
-		msg.addPosition(creature->getPosition());
-	}
+		if (oldProtocol && type >= TALKTYPE_MONSTER_LAST_OLDPROTOCOL && type != TALKTYPE_CHANNEL_R2) {
+			msg.addByte(TALKTYPE_MONSTER_SAY);
+		} else {
+			msg.addByte(type);
+		}
 
-	msg.addString(text);
-	writeToOutputBuffer(msg);
+		if (pos) {
+			msg.addPosition(*pos);
+		} else {
+			msg.addPosition(creature->getPosition());
+		}
+
+		msg.addString(text);
+	}));
 }
 
 void ProtocolGame::sendToChannel(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, uint16_t channelId) {
-	NetworkMessage msg;
-	msg.addByte(0xAA);
+	BroadcastPacket packet;
+	sendToChannel(creature, type, text, channelId, packet);
+}
 
-	static uint32_t statementId = 0;
-	msg.add<uint32_t>(++statementId);
-	if (!creature) {
-		msg.add<uint32_t>(0x00);
-		if (!oldProtocol && statementId != 0) {
-			msg.addByte(0x00); // Show (Traded)
-		}
-	} else if (type == TALKTYPE_CHANNEL_R2) {
-		msg.add<uint32_t>(0x00);
-		if (!oldProtocol && statementId != 0) {
-			msg.addByte(0x00); // Show (Traded)
-		}
-		type = TALKTYPE_CHANNEL_R1;
-	} else {
-		msg.addString(creature->getName());
-		if (!oldProtocol && statementId != 0) {
-			msg.addByte(0x00); // Show (Traded)
-		}
+void ProtocolGame::sendToChannel(const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, uint16_t channelId, BroadcastPacket &packet) {
+	writeToOutputBuffer(packet.get(oldProtocol, [&](NetworkMessageBase &msg) {
+		SpeakClasses speakType = type;
+		msg.addByte(0xAA);
 
-		// Add level only for players
-		if (std::shared_ptr<Player> speaker = creature->getPlayer()) {
-			msg.add<uint16_t>(speaker->getLevel());
+		static uint32_t statementId = 0;
+		msg.add<uint32_t>(++statementId);
+		if (!creature) {
+			msg.add<uint32_t>(0x00);
+			if (!oldProtocol && statementId != 0) {
+				msg.addByte(0x00); // Show (Traded)
+			}
+		} else if (speakType == TALKTYPE_CHANNEL_R2) {
+			msg.add<uint32_t>(0x00);
+			if (!oldProtocol && statementId != 0) {
+				msg.addByte(0x00); // Show (Traded)
+			}
+			speakType = TALKTYPE_CHANNEL_R1;
 		} else {
-			msg.add<uint16_t>(0x00);
+			msg.addString(creature->getName());
+			if (!oldProtocol && statementId != 0) {
+				msg.addByte(0x00); // Show (Traded)
+			}
+
+			// Add level only for players
+			if (std::shared_ptr<Player> speaker = creature->getPlayer()) {
+				msg.add<uint16_t>(speaker->getLevel());
+			} else {
+				msg.add<uint16_t>(0x00);
+			}
 		}
-	}
 
-	if (oldProtocol && type >= TALKTYPE_MONSTER_LAST_OLDPROTOCOL && type != TALKTYPE_CHANNEL_R2) {
-		msg.addByte(TALKTYPE_CHANNEL_O);
-	} else {
-		msg.addByte(type);
-	}
+		if (oldProtocol && speakType >= TALKTYPE_MONSTER_LAST_OLDPROTOCOL && speakType != TALKTYPE_CHANNEL_R2) {
+			msg.addByte(TALKTYPE_CHANNEL_O);
+		} else {
+			msg.addByte(speakType);
+		}
 
-	msg.add<uint16_t>(channelId);
-	msg.addString(text);
-	writeToOutputBuffer(msg);
+		msg.add<uint16_t>(channelId);
+		msg.addString(text);
+	}));
 }
 
 void ProtocolGame::sendPrivateMessage(std::shared_ptr<Player> speaker, SpeakClasses type, const std::string &text) {
@@ -5652,10 +5911,15 @@ void ProtocolGame::sendCancelTarget() {
 }
 
 void ProtocolGame::sendChangeSpeed(std::shared_ptr<Creature> creature, uint16_t speed) {
+	const uint16_t baseSpeed = creature->getBaseSpeed();
+	if (!updateKnownCreatureState(creature->getID(), &KnownCreatureState::speed, std::make_pair(baseSpeed, speed))) {
+		return;
+	}
+
 	NetworkMessage msg;
 	msg.addByte(0x8F);
 	msg.add<uint32_t>(creature->getID());
-	msg.add<uint16_t>(creature->getBaseSpeed());
+	msg.add<uint16_t>(baseSpeed);
 	msg.add<uint16_t>(speed);
 	writeToOutputBuffer(msg);
 }
@@ -5690,25 +5954,30 @@ void ProtocolGame::sendPingBack() {
 }
 
 void ProtocolGame::sendDistanceShoot(const Position &from, const Position &to, uint16_t type) {
+	BroadcastPacket packet;
+	sendDistanceShoot(from, to, type, packet);
+}
+
+void ProtocolGame::sendDistanceShoot(const Position &from, const Position &to, uint16_t type, BroadcastPacket &packet) {
 	if (oldProtocol && type > 0xFF) {
 		return;
 	}
-	NetworkMessage msg;
-	if (oldProtocol) {
-		msg.addByte(0x85);
-		msg.addPosition(from);
-		msg.addPosition(to);
-		msg.addByte(static_cast<uint8_t>(type));
-	} else {
-		msg.addByte(0x83);
-		msg.addPosition(from);
-		msg.addByte(MAGIC_EFFECTS_CREATE_DISTANCEEFFECT);
-		msg.add<uint16_t>(type);
-		msg.addByte(static_cast<uint8_t>(static_cast<int8_t>(static_cast<int32_t>(to.x) - static_cast<int32_t>(from.x))));
-		msg.addByte(static_cast<uint8_t>(static_cast<int8_t>(static_cast<int32_t>(to.y) - static_cast<int32_t>(from.y))));
-		msg.addByte(MAGIC_EFFECTS_END_LOOP);
-	}
-	writeToOutputBuffer(msg);
+	writeToOutputBuffer(packet.get(oldProtocol, [&](NetworkMessageBase &msg) {
+		if (oldProtocol) {
+			msg.addByte(0x85);
+			msg.addPosition(from);
+			msg.addPosition(to);
+			msg.addByte(static_cast<uint8_t>(type));
+		} else {
+			msg.addByte(0x83);
+			msg.addPosition(from);
+			msg.addByte(MAGIC_EFFECTS_CREATE_DISTANCEEFFECT);
+			msg.add<uint16_t>(type);
+			msg.addByte(static_cast<uint8_t>(static_cast<int8_t>(static_cast<int32_t>(to.x) - static_cast<int32_t>(from.x))));
+			msg.addByte(static_cast<uint8_t>(static_cast<int8_t>(static_cast<int32_t>(to.y) - static_cast<int32_t>(from.y))));
+			msg.addByte(MAGIC_EFFECTS_END_LOOP);
+		}
+	}));
 }
 
 void ProtocolGame::sendRestingStatus(uint8_t protection) {
@@ -5724,65 +5993,74 @@ void ProtocolGame::sendRestingStatus(uint8_t protection) {
 	if (PlayerdailyStreak < 2) {
 		msg.addString("Resting Area (no active bonus)");
 	} else {
-		std::ostringstream ss;
-		ss << "Active Resting Area Bonuses: ";
+		NetworkMessage::StringWriter ss(msg);
+		ss.append("Active Resting Area Bonuses: ");
 		if (PlayerdailyStreak < DAILY_REWARD_DOUBLE_HP_REGENERATION) {
-			ss << "\nHit Points Regeneration";
+			ss.append("\nHit Points Regeneration");
 		} else {
-			ss << "\nDouble Hit Points Regeneration";
+			ss.append("\nDouble Hit Points Regeneration");
 		}
 		if (PlayerdailyStreak >= DAILY_REWARD_MP_REGENERATION) {
 			if (PlayerdailyStreak < DAILY_REWARD_DOUBLE_MP_REGENERATION) {
-				ss << ",\nMana Points Regeneration";
+				ss.append(",\nMana Points Regeneration");
 			} else {
-				ss << ",\nDouble Mana Points Regeneration";
+				ss.append(",\nDouble Mana Points Regeneration");
 			}
 		}
 		if (PlayerdailyStreak >= DAILY_REWARD_STAMINA_REGENERATION) {
-			ss << ",\nStamina Points Regeneration";
+			ss.append(",\nStamina Points Regeneration");
 		}
 		if (PlayerdailyStreak >= DAILY_REWARD_SOUL_REGENERATION) {
-			ss << ",\nSoul Points Regeneration";
+			ss.append(",\nSoul Points Regeneration");
 		}
-		ss << ".";
-		msg.addString(ss.str());
+		ss.append(".");
 	}
 	writeToOutputBuffer(msg);
 }
 
 void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type) {
+	BroadcastPacket packet;
+	sendMagicEffect(pos, type, packet);
+}
+
+void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type, BroadcastPacket &packet) {
 	if (!canSee(pos) || (oldProtocol && type > 0xFF)) {
 		return;
 	}
 
-	NetworkMessage msg;
-	if (oldProtocol) {
-		msg.addByte(0x83);
-		msg.addPosition(pos);
-		msg.addByte(static_cast<uint8_t>(type));
-	} else {
-		msg.addByte(0x83);
-		msg.addPosition(pos);
-		msg.addByte(MAGIC_EFFECTS_CREATE_EFFECT);
-		msg.add<uint16_t>(type);
-		msg.addByte(MAGIC_EFFECTS_END_LOOP);
-	}
-	writeToOutputBuffer(msg);
+	writeToOutputBuffer(packet.get(oldProtocol, [&](NetworkMessageBase &msg) {
+		if (oldProtocol) {
+			msg.addByte(0x83);
+			msg.addPosition(pos);
+			msg.addByte(static_cast<uint8_t>(type));
+		} else {
+			msg.addByte(0x83);
+			msg.addPosition(pos);
+			msg.addByte(MAGIC_EFFECTS_CREATE_EFFECT);
+			msg.add<uint16_t>(type);
+			msg.addByte(MAGIC_EFFECTS_END_LOOP);
+		}
+	}));
 }
 
 void ProtocolGame::removeMagicEffect(const Position &pos, uint16_t type) {
+	BroadcastPacket packet;
+	removeMagicEffect(pos, type, packet);
+}
+
+void ProtocolGame::removeMagicEffect(const Position &pos, uint16_t type, BroadcastPacket &packet) {
 	if (oldProtocol && type > 0xFF) {
 		return;
 	}
-	NetworkMessage msg;
-	msg.addByte(0x84);
-	msg.addPosition(pos);
-	if (oldProtocol) {
-		msg.addByte(static_cast<uint8_t>(type));
-	} else {
-		msg.add<uint16_t>(type);
-	}
-	writeToOutputBuffer(msg);
+	writeToOutputBuffer(packet.get(oldProtocol, [&](NetworkMessageBase &msg) {
+		msg.addByte(0x84);
+		msg.addPosition(pos);
+		if (oldProtocol) {
+			msg.addByte(static_cast<uint8_t>(type));
+		} else {
+			msg.add<uint16_t>(type);
+		}
+	}));
 }
 
 void ProtocolGame::sendCreatureHealth(std::shared_ptr<Creature> creature) {
@@ -5790,15 +6068,15 @@ void ProtocolGame::sendCreatureHealth(std::shared_ptr<Creature> creature) {
 		return;
 	}
 
+	const auto healthPercent = static_cast<uint8_t>(std::min<double>(100, std::ceil((static_cast<double>(creature->getHealth()) / std::max<int32_t>(creature->getMaxHealth(), 1)) * 100)));
+	if (!updateKnownCreatureState(creature->getID(), &KnownCreatureState::healthPercent, healthPercent)) {
+		return;
+	}
+
 	NetworkMessage msg;
 	msg.addByte(0x8C);
 	msg.add<uint32_t>(creature->getID());
-	if (creature->isHealthHidden()) {
-		msg.addByte(0x00);
-	} else {
-		msg.addByte(static_cast<uint8_t>(std::min<double>(100, std::ceil((static_cast<double>(creature->getHealth()) / std::max<int32_t>(creature->getMaxHealth(), 1)) * 100))));
-	}
-
+	msg.addByte(healthPercent);
 	writeToOutputBuffer(msg);
 }
 
@@ -6126,6 +6404,8 @@ void ProtocolGame::sendAddCreature(std::shared_ptr<Creature> creature, const Pos
 		sendMagicEffect(pos, CONST_ME_TELEPORT);
 	}
 
+	// The client starts with an empty inventory when it enters the world
+	sentInventoryItems = {};
 	for (int i = CONST_SLOT_FIRST; i <= CONST_SLOT_LAST; ++i) {
 		sendInventoryItem(static_cast<Slots_t>(i), player->getInventoryItem(static_cast<Slots_t>(i)));
 	}
@@ -6276,6 +6556,17 @@ void ProtocolGame::sendInventoryItem(Slots_t slot, std::shared_ptr<Item> item) {
 		msg.addByte(0x79);
 		msg.addByte(slot);
 	}
+
+	// Inventory refreshes often resend a slot that did not change
+	if (slot <= CONST_SLOT_LAST) {
+		const std::span<const uint8_t> update(msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION, msg.getLength());
+		auto &sent = sentInventoryItems[slot];
+		if (std::ranges::equal(update, sent)) {
+			return;
+		}
+		sent.assign(update.begin(), update.end());
+	}
+
 	writeToOutputBuffer(msg);
 }
 
@@ -6989,11 +7280,9 @@ void ProtocolGame::AddCreature(NetworkMessage &msg, std::shared_ptr<Creature> cr
 		}
 	}
 
-	if (creature->isHealthHidden()) {
-		msg.addByte(0x00);
-	} else {
-		msg.addByte(std::ceil((static_cast<double>(creature->getHealth()) / std::max<int32_t>(creature->getMaxHealth(), 1)) * 100));
-	}
+	auto &knownState = knownCreatureStates[creature->getID()];
+	knownState.healthPercent = creature->isHealthHidden() ? 0 : static_cast<uint8_t>(std::ceil((static_cast<double>(creature->getHealth()) / std::max<int32_t>(creature->getMaxHealth(), 1)) * 100));
+	msg.addByte(knownState.healthPercent);
 
 	msg.addByte(creature->getDirection());
 
@@ -7016,11 +7305,14 @@ void ProtocolGame::AddCreature(NetworkMessage &msg, std::shared_ptr<Creature> cr
 	msg.addByte(lightInfo.color);
 
 	msg.add<uint16_t>(creature->getStepSpeed());
+	knownState.speed.reset();
 
 	addCreatureIcon(msg, creature);
 
-	msg.addByte(player->getSkullClient(creature));
-	msg.addByte(player->getPartyShield(otherPlayer));
+	knownState.skull = player->getSkullClient(creature);
+	knownState.shield = player->getPartyShield(otherPlayer);
+	msg.addByte(knownState.skull);
+	msg.addByte(knownState.shield);
 
 	if (!known) {
 		msg.addByte(player->getGuildEmblem(otherPlayer));
@@ -7069,7 +7361,8 @@ void ProtocolGame::AddCreature(NetworkMessage &msg, std::shared_ptr<Creature> cr
 		}
 	}
 
-	msg.addByte(player->canWalkthroughEx(creature) ? 0x00 : 0x01);
+	knownState.walkthrough = player->canWalkthroughEx(creature);
+	msg.addByte(knownState.walkthrough ? 0x00 : 0x01);
 }
 
 void ProtocolGame::AddPlayerStats(NetworkMessage &msg) {
@@ -7310,8 +7603,10 @@ void ProtocolGame::closeImbuementWindow() {
 }
 
 void ProtocolGame::AddWorldLight(NetworkMessage &msg, LightInfo lightInfo) {
+	const uint8_t level = player->isAccessPlayer() ? 0xFF : lightInfo.level;
+	knownWorldLight.emplace(level, lightInfo.color);
 	msg.addByte(0x82);
-	msg.addByte((player->isAccessPlayer() ? 0xFF : lightInfo.level));
+	msg.addByte(level);
 	msg.addByte(lightInfo.color);
 }
 
@@ -7808,8 +8103,7 @@ void ProtocolGame::reloadCreature(std::shared_ptr<Creature> creature) {
 
 	NetworkMessage msg;
 
-	phmap::flat_hash_set<uint32_t>::iterator it = std::find(knownCreatureSet.begin(), knownCreatureSet.end(), creature->getID());
-	if (it != knownCreatureSet.end()) {
+	if (knownCreatureSet.contains(creature->getID())) {
 		msg.addByte(0x6B);
 		msg.addPosition(creature->getPosition());
 		msg.addByte(stackpos);
@@ -7828,13 +8122,13 @@ void ProtocolGame::sendOpenStash() {
 
 	NetworkMessage msg;
 	msg.addByte(0x29);
-	StashItemList list = player->getStashItems();
+	const StashItemList &list = player->getStashItems();
 	msg.add<uint16_t>(list.size());
-	for (auto item : list) {
-		msg.add<uint16_t>(item.first);
-		msg.add<uint32_t>(item.second);
+	for (const auto &[itemId, itemCount] : list) {
+		msg.add<uint16_t>(itemId);
+		msg.add<uint32_t>(itemCount);
 	}
-	msg.add<uint16_t>(static_cast<uint16_t>(g_configManager().getNumber(STASH_ITEMS) - getStashSize(list)));
+	msg.add<uint16_t>(static_cast<uint16_t>(g_configManager().getNumber(STASH_ITEMS) - player->getStashSize()));
 	writeToOutputBuffer(msg);
 }
 
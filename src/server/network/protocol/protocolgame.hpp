@@ -12,8 +12,10 @@
 #include "server/network/protocol/protocol.hpp"
 #include "creatures/interactions/chat.hpp"
 #include "creatures/creature.hpp"
+#include "database/database.hpp"
 
 class NetworkMessage;
+class BroadcastPacket;
 class Player;
 class Game;
 class House;
@@ -55,6 +57,10 @@ public:
 		return "gameworld protocol";
 	}
 
+	const char* getProtocolName() const override {
+		return protocol_name();
+	}
+
 	explicit ProtocolGame(Connection_ptr initConnection);
 
 	void login(const std::string &name, uint32_t accnumber, OperatingSystem_t operatingSystem);
@@ -72,14 +78,26 @@ private:
 	template <typename Callable, typename... Args>
 	void addGameTask(Callable function, Args &&... args);
 	template <typename Callable, typename... Args>
-	void addGameTaskTimed(uint32_t delay, std::string context, Callable function, Args &&... args);
+	void addGameTaskTimed(uint32_t delay, std::string_view context, Callable function, Args &&... args);
 
 	ProtocolGame_ptr getThis() {
 		return std::static_pointer_cast<ProtocolGame>(shared_from_this());
 	}
 	void connect(const std::string &playerName, OperatingSystem_t operatingSystem);
 	void disconnectClient(const std::string &message) const;
-	void writeToOutputBuffer(const NetworkMessage &msg);
+	// The caller location attributes the bytes to the send function in the network profiler
+	void writeToOutputBuffer(const NetworkMessage &msg, const std::source_location &location = std::source_location::current());
+	void writeToOutputBuffer(const OutputMessage_ptr &packet, const std::source_location &location = std::source_location::current());
+
+	/**
+	 * Between the two, the messages written are kept by this protocol instead
+	 * of going to its output buffer, so they can be built off the game thread
+	 * while it waits; the end writes them out, on the game thread.
+	 */
+	void beginStagedWrites() {
+		stagingWrites = true;
+	}
+	void endStagedWrites();
 
 	void release() override;
 
@@ -92,7 +110,9 @@ private:
 	// we have all the parse methods
 	void parsePacket(NetworkMessage &msg) override;
 	void parsePacketFromDispatcher(NetworkMessage msg, uint8_t recvbyte);
-	void onRecvFirstMessage(NetworkMessage &msg) override;
+	bool onRecvFirstMessage(NetworkMessage &msg) override;
+	// Runs on the thread pool, see Protocol::addLoginLoad
+	void parseFirstMessage(NetworkMessage &msg);
 	void onConnect() override;
 
 	// Parse methods
@@ -225,6 +245,7 @@ private:
 
 	// Send functions
 	void sendChannelMessage(const std::string &author, const std::string &text, SpeakClasses type, uint16_t channel);
+	void sendChannelMessage(const std::string &author, const std::string &text, SpeakClasses type, uint16_t channel, BroadcastPacket &packet);
 	void sendChannelEvent(uint16_t channelId, const std::string &playerName, ChannelEvent_t channelEvent);
 	void sendClosePrivate(uint16_t channelId);
 	void sendCreatePrivateChannel(uint16_t channelId, const std::string &channelName);
@@ -233,6 +254,7 @@ private:
 	void sendOpenPrivateChannel(const std::string &receiver);
 	void sendExperienceTracker(int64_t rawExp, int64_t finalExp);
 	void sendToChannel(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, uint16_t channelId);
+	void sendToChannel(const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, uint16_t channelId, BroadcastPacket &packet);
 	void sendPrivateMessage(std::shared_ptr<Player> speaker, SpeakClasses type, const std::string &text);
 	void sendIcons(uint32_t icons);
 	void sendFYIBox(const std::string &message);
@@ -275,6 +297,10 @@ private:
 	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type);
 	void sendMagicEffect(const Position &pos, uint16_t type);
 	void removeMagicEffect(const Position &pos, uint16_t type);
+	// Broadcast variants, every recipient appends the same serialized packet
+	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type, BroadcastPacket &packet);
+	void sendMagicEffect(const Position &pos, uint16_t type, BroadcastPacket &packet);
+	void removeMagicEffect(const Position &pos, uint16_t type, BroadcastPacket &packet);
 	void sendRestingStatus(uint8_t protection);
 	void sendCreatureHealth(std::shared_ptr<Creature> creature);
 	void sendPartyCreatureUpdate(std::shared_ptr<Creature> target);
@@ -290,6 +316,7 @@ private:
 	void sendPingBack();
 	void sendCreatureTurn(std::shared_ptr<Creature> creature, uint32_t stackpos);
 	void sendCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, const Position* pos = nullptr);
+	void sendCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, const Position* pos, BroadcastPacket &packet);
 
 	// Unjust Panel
 	void sendUnjustifiedPoints(const uint8_t &dayProgress, const uint8_t &dayLeft, const uint8_t &weekProgress, const uint8_t &weekLeft, const uint8_t &monthProgress, const uint8_t &monthLeft, const uint8_t &skullDuration);
@@ -365,6 +392,9 @@ private:
 	void sendUpdateCreature(std::shared_ptr<Creature> creature);
 	void sendWorldLight(const LightInfo &lightInfo);
 	void sendTibiaTime(int32_t time);
+	// Broadcast variants, skipped when the client already has the light or the minute
+	void sendWorldLight(const LightInfo &lightInfo, BroadcastPacket &packet);
+	void sendTibiaTime(int32_t time, BroadcastPacket &packet);
 
 	void sendCreatureSquare(std::shared_ptr<Creature> creature, SquareColor_t color);
 
@@ -470,8 +500,49 @@ private:
 
 	friend class Player;
 	friend class PlayerWheel;
+	friend class SessionReplay;
+
+	// What the client was last sent about a known creature, so updates that change nothing are dropped
+	struct KnownCreatureState {
+		uint8_t healthPercent = 0;
+		uint8_t skull = 0;
+		uint8_t shield = 0;
+		bool walkthrough = false;
+		// Base and current speed, not part of the creature description
+		std::optional<std::pair<uint16_t, uint16_t>> speed;
+	};
+
+	// Returns false when the client already has the value
+	template <typename T, typename V>
+	bool updateKnownCreatureState(uint32_t creatureId, T KnownCreatureState::*field, const V &value) {
+		auto it = knownCreatureStates.find(creatureId);
+		if (it == knownCreatureStates.end()) {
+			return true;
+		}
+
+		auto &known = it->second.*field;
+		if (known == value) {
+			return false;
+		}
+
+		known = value;
+		return true;
+	}
 
-	phmap::flat_hash_set<uint32_t> knownCreatureSet;
+	// Creatures the client keeps, at most MAX_KNOWN_CREATURES, the most recently described first in knownCreatureOrder
+	static constexpr size_t MAX_KNOWN_CREATURES = 1300;
+	std::list<uint32_t> knownCreatureOrder;
+	phmap::flat_hash_map<uint32_t, std::list<uint32_t>::iterator> knownCreatureSet;
+	phmap::flat_hash_map<uint32_t, KnownCreatureState> knownCreatureStates;
+	bool stagingWrites = false;
+	std::vector<uint8_t> stagedWrites;
+	std::vector<uint16_t> stagedWriteLengths;
+
+	// World light level and color and Tibia time in minutes the client was last sent
+	std::optional<std::pair<uint8_t, uint8_t>> knownWorldLight;
+	int32_t knownTibiaTime = -1;
+	// Last inventory update sent for each slot
+	std::array<std::vector<uint8_t>, CONST_SLOT_LAST + 1> sentInventoryItems;
 	std::shared_ptr<Player> player = nullptr;
 
 	uint32_t eventConnect = 0;
@@ -489,8 +560,14 @@ private:
 
 	bool oldProtocol = false;
 
+	// Session the game thread records the packets under, 0 when not recording
+	uint32_t recordedSession = 0;
+
 	uint16_t otclientV8 = 0;
 
+	// Character tables read on the login thread, used up by login
+	DBPrefetch::Results loginPrefetch;
+
 	void sendInventory();
 	void sendOpenStash();
 	void parseStashWithdraw(NetworkMessage &msg);
@@ -99,12 +99,26 @@ void ProtocolLogin::getCharacterList(const std::string &accountDescriptor, const
 	disconnect();
 }
 
-void ProtocolLogin::onRecvFirstMessage(NetworkMessage &msg) {
+bool ProtocolLogin::onRecvFirstMessage(NetworkMessage &msg) {
 	if (g_game().getGameState() == GAME_STATE_SHUTDOWN) {
 		disconnect();
-		return;
+		return false;
+	}
+
+	// The connection buffer is reused by the next read, so the worker gets its own copy
+	auto firstMessage = std::make_shared<NetworkMessage>(msg);
+	auto thisPtr = std::static_pointer_cast<ProtocolLogin>(shared_from_this());
+	if (!addLoginLoad([thisPtr, firstMessage]() { thisPtr->parseFirstMessage(*firstMessage); })) {
+		g_logger().warn("[ProtocolLogin::onRecvFirstMessage] - Too many pending logins, dropping connection from {}", convertIPToString(getIP()));
+		disconnect();
+		return false;
 	}
 
+	// The connection is closed once the character list is sent
+	return true;
+}
+
+void ProtocolLogin::parseFirstMessage(NetworkMessage &msg) {
 	msg.skipBytes(2); // client OS
 
 	uint16_t version = msg.get<uint16_t>();
@@ -121,7 +135,7 @@ void ProtocolLogin::onRecvFirstMessage(NetworkMessage &msg) {
 	 */
 
 	if (!Protocol::RSA_decrypt(msg)) {
-		g_logger().warn("[ProtocolLogin::onRecvFirstMessage] - RSA Decrypt Failed");
+		g_logger().warn("[ProtocolLogin::parseFirstMessage] - RSA Decrypt Failed");
 		disconnect();
 		return;
 	}
@@ -174,6 +188,6 @@ void ProtocolLogin::onRecvFirstMessage(NetworkMessage &msg) {
 		return;
 	}
 
-	auto thisPtr = std::static_pointer_cast<ProtocolLogin>(shared_from_this());
-	g_dispatcher().addTask(std::bind(&ProtocolLogin::getCharacterList, thisPtr, accountDescriptor, password), "ProtocolLogin::getCharacterList");
+	// Account queries and password hashing stay off the dispatcher as well
+	getCharacterList(accountDescriptor, password);
 }
@@ -24,14 +24,21 @@ public:
 		return "login protocol";
 	}
 
+	const char* getProtocolName() const override {
+		return protocol_name();
+	}
+
 	explicit ProtocolLogin(Connection_ptr loginConnection) :
 		Protocol(loginConnection) { }
 
-	void onRecvFirstMessage(NetworkMessage &msg);
+	bool onRecvFirstMessage(NetworkMessage &msg) override;
 
 private:
 	void disconnectClient(const std::string &message);
 
+	// Runs on the thread pool, see Protocol::addLoginLoad
+	void parseFirstMessage(NetworkMessage &msg);
+
 	void getCharacterList(const std::string &accountDescriptor, const std::string &password);
 
 	bool oldProtocol = false;
@@ -19,7 +19,7 @@
 std::map<uint32_t, int64_t> ProtocolStatus::ipConnectMap;
 const uint64_t ProtocolStatus::start = OTSYS_TIME();
 
-void ProtocolStatus::onRecvFirstMessage(NetworkMessage &msg) {
+bool ProtocolStatus::onRecvFirstMessage(NetworkMessage &msg) {
 	uint32_t ip = getIP();
 	if (ip != 0x0100007F) {
 		std::string ipStr = convertIPToString(ip);
@@ -27,7 +27,7 @@ void ProtocolStatus::onRecvFirstMessage(NetworkMessage &msg) {
 			std::map<uint32_t, int64_t>::const_iterator it = ipConnectMap.find(ip);
 			if (it != ipConnectMap.end() && (OTSYS_TIME() < (it->second + g_configManager().getNumber(STATUSQUERY_TIMEOUT)))) {
 				disconnect();
-				return;
+				return false;
 			}
 		}
 	}
@@ -39,7 +39,7 @@ void ProtocolStatus::onRecvFirstMessage(NetworkMessage &msg) {
 		case 0xFF: {
 			if (msg.getString(4) == "info") {
 				g_dispatcher().addTask(std::bind(&ProtocolStatus::sendStatusString, std::static_pointer_cast<ProtocolStatus>(shared_from_this())), "ProtocolStatus::sendStatusString");
-				return;
+				return false;
 			}
 			break;
 		}
@@ -52,20 +52,27 @@ void ProtocolStatus::onRecvFirstMessage(NetworkMessage &msg) {
 				characterName = msg.getString();
 			}
 			g_dispatcher().addTask(std::bind(&ProtocolStatus::sendInfo, std::static_pointer_cast<ProtocolStatus>(shared_from_this()), requestedInfo, characterName), "ProtocolStatus::sendInfo");
-			return;
+			return false;
 		}
 
 		default:
 			break;
 	}
 	disconnect();
+	return false;
 }
 
-void ProtocolStatus::sendStatusString() {
-	auto output = OutputMessagePool::getOutputMessage();
-
-	setRawMessages(true);
+ProtocolStatus::StatusCache &ProtocolStatus::getStatusCache() {
+	// Status requests are answered on the dispatcher, so the cache takes no lock
+	static StatusCache cache;
+	if (const int64_t now = OTSYS_TIME(); now >= cache.expiresAt) {
+		cache = {};
+		cache.expiresAt = now + g_configManager().getNumber(STATUS_CACHE_TIME);
+	}
+	return cache;
+}
 
+std::string ProtocolStatus::buildStatusString() {
 	pugi::xml_document doc;
 
 	pugi::xml_node decl = doc.prepend_child(pugi::node_declaration);
@@ -138,80 +145,129 @@ void ProtocolStatus::sendStatusString() {
 
 	std::ostringstream ss;
 	doc.save(ss, "", pugi::format_raw);
+	return ss.str();
+}
+
+void ProtocolStatus::sendStatusString() {
+	auto output = OutputMessagePool::getOutputMessage();
+
+	setRawMessages(true);
+
+	auto &cache = getStatusCache();
+	if (cache.statusString.empty()) {
+		cache.statusString = buildStatusString();
+	}
 
-	std::string data = ss.str();
-	output->addBytes(data.c_str(), data.size());
+	output->addBytes(cache.statusString.data(), cache.statusString.size());
 	send(output);
 	disconnect();
 }
 
-void ProtocolStatus::sendInfo(uint16_t requestedInfo, const std::string &characterName) {
-	auto output = OutputMessagePool::getOutputMessage();
+void ProtocolStatus::writeInfoSection(NetworkMessageBase &msg, RequestedInfo_t section) {
+	switch (section) {
+		case REQUEST_BASIC_SERVER_INFO:
+			msg.addByte(0x10);
+			msg.addString(g_configManager().getString(SERVER_NAME));
+			msg.addString(g_configManager().getString(IP));
+			msg.addString(std::to_string(g_configManager().getNumber(LOGIN_PORT)));
+			break;
 
-	if (requestedInfo & REQUEST_BASIC_SERVER_INFO) {
-		output->addByte(0x10);
-		output->addString(g_configManager().getString(SERVER_NAME));
-		output->addString(g_configManager().getString(IP));
-		output->addString(std::to_string(g_configManager().getNumber(LOGIN_PORT)));
-	}
+		case REQUEST_OWNER_SERVER_INFO:
+			msg.addByte(0x11);
+			msg.addString(g_configManager().getString(OWNER_NAME));
+			msg.addString(g_configManager().getString(OWNER_EMAIL));
+			break;
 
-	if (requestedInfo & REQUEST_OWNER_SERVER_INFO) {
-		output->addByte(0x11);
-		output->addString(g_configManager().getString(OWNER_NAME));
-		output->addString(g_configManager().getString(OWNER_EMAIL));
-	}
+		case REQUEST_MISC_SERVER_INFO:
+			msg.addByte(0x12);
+			msg.addString(g_configManager().getString(SERVER_MOTD));
+			msg.addString(g_configManager().getString(LOCATION));
+			msg.addString(g_configManager().getString(URL));
+			msg.add<uint64_t>((OTSYS_TIME() - ProtocolStatus::start) / 1000);
+			break;
 
-	if (requestedInfo & REQUEST_MISC_SERVER_INFO) {
-		output->addByte(0x12);
-		output->addString(g_configManager().getString(SERVER_MOTD));
-		output->addString(g_configManager().getString(LOCATION));
-		output->addString(g_configManager().getString(URL));
-		output->add<uint64_t>((OTSYS_TIME() - ProtocolStatus::start) / 1000);
-	}
+		case REQUEST_PLAYERS_INFO:
+			msg.addByte(0x20);
+			msg.add<uint32_t>(static_cast<uint32_t>(g_game().getPlayersOnline()));
+			msg.add<uint32_t>(g_configManager().getNumber(MAX_PLAYERS));
+			msg.add<uint32_t>(g_game().getPlayersRecord());
+			break;
 
-	if (requestedInfo & REQUEST_PLAYERS_INFO) {
-		output->addByte(0x20);
-		output->add<uint32_t>(static_cast<uint32_t>(g_game().getPlayersOnline()));
-		output->add<uint32_t>(g_configManager().getNumber(MAX_PLAYERS));
-		output->add<uint32_t>(g_game().getPlayersRecord());
-	}
+		case REQUEST_MAP_INFO: {
+			msg.addByte(0x30);
+			msg.addString(g_configManager().getString(MAP_NAME));
+			msg.addString(g_configManager().getString(MAP_AUTHOR));
+			uint32_t mapWidth, mapHeight;
+			g_game().getMapDimensions(mapWidth, mapHeight);
+			msg.add<uint16_t>(mapWidth);
+			msg.add<uint16_t>(mapHeight);
+			break;
+		}
+
+		case REQUEST_EXT_PLAYERS_INFO: {
+			msg.addByte(0x21); // players info - online players list
+
+			const auto players = g_game().getPlayers();
+			msg.add<uint32_t>(players.size());
+			for (const auto &it : players) {
+				msg.addString(it.second->getName());
+				msg.add<uint32_t>(it.second->getLevel());
+			}
+			break;
+		}
+
+		case REQUEST_SERVER_SOFTWARE_INFO:
+			msg.addByte(0x23); // server software info
+			msg.addString(STATUS_SERVER_NAME);
+			msg.addString(STATUS_SERVER_VERSION);
+			msg.addString(fmt::format("{}.{}", CLIENT_VERSION_UPPER, CLIENT_VERSION_LOWER));
+			break;
 
-	if (requestedInfo & REQUEST_MAP_INFO) {
-		output->addByte(0x30);
-		output->addString(g_configManager().getString(MAP_NAME));
-		output->addString(g_configManager().getString(MAP_AUTHOR));
-		uint32_t mapWidth, mapHeight;
-		g_game().getMapDimensions(mapWidth, mapHeight);
-		output->add<uint16_t>(mapWidth);
-		output->add<uint16_t>(mapHeight);
+		default:
+			break;
 	}
+}
 
-	if (requestedInfo & REQUEST_EXT_PLAYERS_INFO) {
-		output->addByte(0x21); // players info - online players list
+void ProtocolStatus::sendInfo(uint16_t requestedInfo, const std::string &characterName) {
+	auto output = OutputMessagePool::getOutputMessage();
+	auto &cache = getStatusCache();
+
+	// Sections in the order the client expects them
+	static constexpr auto sections = std::to_array<RequestedInfo_t>({
+		REQUEST_BASIC_SERVER_INFO,
+		REQUEST_OWNER_SERVER_INFO,
+		REQUEST_MISC_SERVER_INFO,
+		REQUEST_PLAYERS_INFO,
+		REQUEST_MAP_INFO,
+		REQUEST_EXT_PLAYERS_INFO,
+		REQUEST_PLAYER_STATUS_INFO,
+		REQUEST_SERVER_SOFTWARE_INFO,
+	});
+	for (size_t index = 0; index < sections.size(); ++index) {
+		const auto section = sections[index];
+		if ((requestedInfo & section) == 0) {
+			continue;
+		}
 
-		const auto players = g_game().getPlayers();
-		output->add<uint32_t>(players.size());
-		for (const auto &it : players) {
-			output->addString(it.second->getName());
-			output->add<uint32_t>(it.second->getLevel());
+		if (section == REQUEST_PLAYER_STATUS_INFO) {
+			output->addByte(0x22); // players info - online status info of a player
+			if (g_game().getPlayerByName(characterName) != nullptr) {
+				output->addByte(0x01);
+			} else {
+				output->addByte(0x00);
+			}
+			continue;
 		}
-	}
 
-	if (requestedInfo & REQUEST_PLAYER_STATUS_INFO) {
-		output->addByte(0x22); // players info - online status info of a player
-		if (g_game().getPlayerByName(characterName) != nullptr) {
-			output->addByte(0x01);
-		} else {
-			output->addByte(0x00);
+		auto &bytes = cache.infoSections[index];
+		if (!bytes) {
+			NetworkMessage msg;
+			writeInfoSection(msg, section);
+			bytes.emplace(reinterpret_cast<const char*>(msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION), msg.getLength());
 		}
+		output->addBytes(bytes->data(), bytes->size());
 	}
 
-	if (requestedInfo & REQUEST_SERVER_SOFTWARE_INFO) {
-		output->addByte(0x23); // server software info
-		output->addString(STATUS_SERVER_NAME);
-		output->addString(STATUS_SERVER_VERSION);
-		output->addString(fmt::format("{}.{}", CLIENT_VERSION_UPPER, CLIENT_VERSION_LOWER));
-	}
 	send(output);
 	disconnect();
 }
@@ -22,10 +22,14 @@ public:
 		return "status protocol";
 	}
 
+	const char* getProtocolName() const override {
+		return protocol_name();
+	}
+
 	explicit ProtocolStatus(Connection_ptr conn) :
 		Protocol(conn) { }
 
-	void onRecvFirstMessage(NetworkMessage &msg) override;
+	bool onRecvFirstMessage(NetworkMessage &msg) override;
 
 	void sendStatusString();
 	void sendInfo(uint16_t requestedInfo, const std::string &characterName);
@@ -33,5 +37,17 @@ public:
 	static const uint64_t start;
 
 private:
+	// Serialized responses, rebuilt at most once per statusCacheTime
+	struct StatusCache {
+		int64_t expiresAt = 0;
+		std::string statusString;
+		// Indexed like the sections of sendInfo, the player status section is never cached
+		std::array<std::optional<std::string>, 8> infoSections;
+	};
+
+	static StatusCache &getStatusCache();
+	static std::string buildStatusString();
+	static void writeInfoSection(NetworkMessageBase &msg, RequestedInfo_t section);
+
 	static std::map<uint32_t, int64_t> ipConnectMap;
 };
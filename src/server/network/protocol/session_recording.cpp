@@ -0,0 +1,246 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "server/network/protocol/session_recording.hpp"
+#include "server/network/protocol/protocolgame.hpp"
+#include "server/network/message/networkmessage.hpp"
+#include "game/game.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "lib/di/container.hpp"
+#include "utils/tools.hpp"
+
+namespace {
+	constexpr std::array<char, 4> SESSION_MAGIC = { 'C', 'N', 'R', 'S' };
+	constexpr uint32_t SESSION_FORMAT_VERSION = 1;
+	// Time the last tasks of the replay get before the results are taken
+	constexpr std::chrono::seconds REPLAY_DRAIN_TIME { 5 };
+
+	template <typename T>
+	void writeValue(std::ofstream &file, T value) {
+		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	template <typename T>
+	bool readValue(std::ifstream &file, T &value) {
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+	}
+}
+
+SessionRecorder &SessionRecorder::getInstance() {
+	return inject<SessionRecorder>();
+}
+
+void SessionRecorder::start() {
+	std::error_code error;
+	std::filesystem::create_directories(SESSION_DIRECTORY, error);
+	const auto fileName = fmt::format("{}/{:%Y%m%d-%H%M%S}.bin", SESSION_DIRECTORY, fmt::localtime(std::time(nullptr)));
+	file.open(fileName, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		g_logger().error("[SessionRecorder::start] - Could not create {}", fileName);
+		return;
+	}
+
+	const auto seed = std::random_device {}();
+	seedRandomGenerators(seed);
+
+	file.write(SESSION_MAGIC.data(), SESSION_MAGIC.size());
+	writeValue(file, SESSION_FORMAT_VERSION);
+	writeValue(file, seed);
+	startedAt = std::chrono::steady_clock::now();
+	g_logger().info("Recording game sessions to {}", fileName);
+}
+
+void SessionRecorder::stop() {
+	if (file.is_open()) {
+		file.close();
+	}
+}
+
+uint32_t SessionRecorder::addLogin(const std::string &name, uint32_t accountId, uint16_t operatingSystem) {
+	const uint32_t session = ++lastSession;
+	writeHeader(SessionRecord_t::Login, session);
+	writeValue(file, accountId);
+	writeValue(file, operatingSystem);
+	writeValue(file, static_cast<uint16_t>(name.size()));
+	file.write(name.data(), static_cast<std::streamsize>(name.size()));
+	return session;
+}
+
+void SessionRecorder::addPacket(uint32_t session, const NetworkMessage &msg) {
+	const auto length = static_cast<uint16_t>(msg.getLength() + NetworkMessage::INITIAL_BUFFER_POSITION - msg.getBufferPosition());
+	writeHeader(SessionRecord_t::Packet, session);
+	writeValue(file, length);
+	file.write(reinterpret_cast<const char*>(msg.getBuffer() + msg.getBufferPosition()), length);
+}
+
+void SessionRecorder::addDisconnect(uint32_t session) {
+	writeHeader(SessionRecord_t::Disconnect, session);
+}
+
+void SessionRecorder::writeHeader(SessionRecord_t type, uint32_t session) {
+	const auto offset = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startedAt).count();
+	writeValue(file, static_cast<uint8_t>(type));
+	writeValue(file, session);
+	writeValue(file, static_cast<uint64_t>(offset));
+}
+
+SessionReplay &SessionReplay::getInstance() {
+	return inject<SessionReplay>();
+}
+
+bool SessionReplay::load(const std::string &fileName) {
+	std::ifstream file(fileName, std::ios::binary);
+	std::array<char, 4> magic {};
+	uint32_t version = 0;
+	if (!file.read(magic.data(), magic.size()) || magic != SESSION_MAGIC || !readValue(file, version) || version != SESSION_FORMAT_VERSION || !readValue(file, seed)) {
+		g_logger().error("[SessionReplay::load] - {} is not a session recording of this version", fileName);
+		return false;
+	}
+
+	uint8_t type;
+	while (readValue(file, type)) {
+		Record record;
+		record.type = static_cast<SessionRecord_t>(type);
+		uint64_t offset = 0;
+		if (!readValue(file, record.session) || !readValue(file, offset)) {
+			break;
+		}
+		record.offset = std::chrono::microseconds(offset);
+
+		uint16_t length = 0;
+		if (record.type == SessionRecord_t::Login) {
+			if (!readValue(file, record.accountId) || !readValue(file, record.operatingSystem) || !readValue(file, length)) {
+				break;
+			}
+		} else if (record.type == SessionRecord_t::Packet) {
+			if (!readValue(file, length)) {
+				break;
+			}
+		} else if (record.type != SessionRecord_t::Disconnect) {
+			g_logger().error("[SessionReplay::load] - Unknown record type {} in {}", type, fileName);
+			return false;
+		}
+
+		record.data.resize(length);
+		if (!file.read(record.data.data(), length)) {
+			break;
+		}
+		records.emplace_back(std::move(record));
+	}
+
+	// A server that did not shut down cleanly leaves the last record cut
+	g_logger().info("Loaded {} session records, {} seconds, from {}", records.size(), records.empty() ? 0 : std::chrono::duration_cast<std::chrono::seconds>(records.back().offset).count(), fileName);
+	return !records.empty();
+}
+
+void SessionReplay::start() {
+	seedRandomGenerators(seed);
+	thread = std::jthread([this](const std::stop_token &stopToken) { run(stopToken); });
+}
+
+void SessionReplay::wait() {
+	if (thread.joinable()) {
+		thread.join();
+	}
+}
+
+void SessionReplay::run(const std::stop_token &stopToken) {
+	const auto startedAt = std::chrono::steady_clock::now();
+	const auto busyAtStart = g_dispatcher().getBusyTime();
+	const auto cpuAtStart = getProcessCpuTimeMs();
+
+	// Sleeps a second at most, so a shutdown is not held up
+	const auto sleepUntil = [&stopToken](std::chrono::steady_clock::time_point until) {
+		while (std::chrono::steady_clock::now() < until) {
+			if (stopToken.stop_requested() || g_game().getGameState() == GAME_STATE_SHUTDOWN) {
+				return false;
+			}
+			std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(until - std::chrono::steady_clock::now(), std::chrono::seconds(1)));
+		}
+		return true;
+	};
+
+	for (const auto &record : records) {
+		if (!sleepUntil(startedAt + record.offset)) {
+			return;
+		}
+		dispatch(record);
+	}
+
+	if (!sleepUntil(std::chrono::steady_clock::now() + REPLAY_DRAIN_TIME)) {
+		return;
+	}
+
+	std::promise<void> done;
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startedAt).count();
+	g_dispatcher().addTask(
+		[&] {
+			g_logger().info(
+				"[SessionReplay] {} records in {} ms, game thread busy {} ms, process cpu {} ms",
+				records.size(), elapsed,
+				std::chrono::duration_cast<std::chrono::milliseconds>(g_dispatcher().getBusyTime() - busyAtStart).count(),
+				getProcessCpuTimeMs() - cpuAtStart
+			);
+			g_game().setGameState(GAME_STATE_SHUTDOWN);
+			done.set_value();
+		},
+		"SessionReplay::run"
+	);
+	done.get_future().wait();
+}
+
+void SessionReplay::dispatch(const Record &record) {
+	switch (record.type) {
+		case SessionRecord_t::Login: {
+			auto protocol = std::make_shared<ProtocolGame>(nullptr);
+			sessions[record.session] = protocol;
+			g_dispatcher().addTask(
+				[protocol, name = record.data, accountId = record.accountId, operatingSystem = record.operatingSystem] {
+					protocol->login(name, accountId, static_cast<OperatingSystem_t>(operatingSystem));
+				},
+				"SessionReplay::login"
+			);
+			break;
+		}
+		case SessionRecord_t::Packet: {
+			const auto it = sessions.find(record.session);
+			if (it == sessions.end()) {
+				break;
+			}
+
+			auto msg = std::make_shared<NetworkMessage>();
+			msg->addBytes(record.data.data(), record.data.size());
+			msg->setBufferPosition(NetworkMessage::INITIAL_BUFFER_POSITION);
+			g_dispatcher().addTask(
+				[protocol = it->second, msg] {
+					protocol->parsePacket(*msg);
+				},
+				"SessionReplay::parsePacket"
+			);
+			break;
+		}
+		case SessionRecord_t::Disconnect: {
+			const auto it = sessions.find(record.session);
+			if (it == sessions.end()) {
+				break;
+			}
+
+			g_dispatcher().addTask(
+				[protocol = it->second] {
+					protocol->release();
+				},
+				"SessionReplay::release"
+			);
+			sessions.erase(it);
+			break;
+		}
+	}
+}
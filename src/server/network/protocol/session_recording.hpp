@@ -0,0 +1,119 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class NetworkMessage;
+class ProtocolGame;
+
+enum class SessionRecord_t : uint8_t {
+	Login = 1,
+	Packet = 2,
+	Disconnect = 3,
+};
+
+/**
+ * Game sessions as the game thread saw them: every login, decrypted
+ * packet and disconnect, with the time since the recording started, and
+ * the seed the random generator was given. With sessionRecording one file
+ * per run is written to SESSION_DIRECTORY.
+ *
+ * Records are written from the game thread, where the packets are parsed,
+ * so their order is the one they were handled in. Packets hold what the
+ * client typed, chat included, so recordings stay on the server.
+ */
+class SessionRecorder {
+public:
+	static constexpr std::string_view SESSION_DIRECTORY = "logs/sessions";
+
+	SessionRecorder() = default;
+
+	// Ensures that we don't accidentally copy it
+	SessionRecorder(const SessionRecorder &) = delete;
+	SessionRecorder operator=(const SessionRecorder &) = delete;
+
+	static SessionRecorder &getInstance();
+
+	// Seeds the random generator with the seed it records
+	void start();
+	void stop();
+
+	[[nodiscard]] bool isRecording() const {
+		return file.is_open();
+	}
+
+	// Game thread only, returns the session the packets of the login are recorded under
+	uint32_t addLogin(const std::string &name, uint32_t accountId, uint16_t operatingSystem);
+	// Game thread only, the unread part of the message
+	void addPacket(uint32_t session, const NetworkMessage &msg);
+	void addDisconnect(uint32_t session);
+
+private:
+	void writeHeader(SessionRecord_t type, uint32_t session);
+
+	std::ofstream file;
+	std::chrono::steady_clock::time_point startedAt;
+	uint32_t lastSession = 0;
+};
+
+constexpr auto g_sessionRecorder = SessionRecorder::getInstance;
+
+/**
+ * Plays a recording back with no network: sessionReplay names the file and
+ * the server then opens no ports. Logins, packets and disconnects are
+ * dispatched to the game thread at their recorded times, for protocols
+ * without a connection, so everything they send is built and dropped.
+ *
+ * The world has to be the one of the recording (map, datapack and a copy
+ * of the database from when it started) for the replay to match it. The
+ * game thread busy time and the process CPU time are logged at the end,
+ * to compare builds against the same workload.
+ */
+class SessionReplay {
+public:
+	SessionReplay() = default;
+
+	// Ensures that we don't accidentally copy it
+	SessionReplay(const SessionReplay &) = delete;
+	SessionReplay operator=(const SessionReplay &) = delete;
+
+	static SessionReplay &getInstance();
+
+	// Reads the whole recording, false when it can not be read
+	bool load(const std::string &fileName);
+	// Seeds the random generator as the recording did and replays from another thread, the server shuts down once it is done
+	void start();
+	void wait();
+
+	[[nodiscard]] bool isLoaded() const {
+		return !records.empty();
+	}
+
+private:
+	struct Record {
+		SessionRecord_t type;
+		uint32_t session;
+		std::chrono::microseconds offset;
+		// Name of the login or the packet
+		std::string data;
+		uint32_t accountId = 0;
+		uint16_t operatingSystem = 0;
+	};
+
+	void run(const std::stop_token &stopToken);
+	void dispatch(const Record &record);
+
+	uint32_t seed = 0;
+	std::vector<Record> records;
+	// Replay thread only
+	std::map<uint32_t, std::shared_ptr<ProtocolGame>> sessions;
+	std::jthread thread;
+};
+
+constexpr auto g_sessionReplay = SessionReplay::getInstance;
@@ -11,11 +11,9 @@
 
 #include "server/network/webhook/webhook.hpp"
 #include "config/configmanager.hpp"
-#include "game/scheduling/scheduler.hpp"
 #include "utils/tools.hpp"
 
-Webhook::Webhook(ThreadPool &threadPool) :
-	threadPool(threadPool) {
+Webhook::Webhook() {
 	if (curl_global_init(CURL_GLOBAL_ALL) != 0) {
 		g_logger().error("Failed to init curl, no webhook messages may be sent");
 		return;
@@ -29,23 +27,49 @@ Webhook::Webhook(ThreadPool &threadPool) :
 		return;
 	}
 
-	run();
+	multi = curl_multi_init();
+	if (!multi) {
+		g_logger().error("Failed to init curl, curl_multi_init failed");
+		return;
+	}
+
+	thread = std::jthread([this] { loop(); });
+}
+
+Webhook::~Webhook() {
+	shutdown();
 }
 
 Webhook &Webhook::getInstance() {
 	return inject<Webhook>();
 }
 
-void Webhook::run() {
-	threadPool.addLoad([this] { sendWebhook(); });
-	g_scheduler().addEvent(
-		g_configManager().getNumber(DISCORD_WEBHOOK_DELAY_MS), [this] { run(); }, "Webhook::run"
-	);
+void Webhook::shutdown() {
+	if (!thread.joinable()) {
+		return;
+	}
+
+	{
+		std::scoped_lock lock { taskLock };
+		stopping = true;
+		curl_multi_wakeup(multi);
+	}
+	thread.join();
 }
 
-void Webhook::sendMessage(const std::string payload, std::string url) {
+void Webhook::queueTask(WebhookTask task) {
+	// The thread frees the multi handle under the lock when it stops
 	std::scoped_lock lock { taskLock };
-	webhooks.push_back(std::make_shared<WebhookTask>(payload, url));
+	if (!multi || stopping) {
+		return;
+	}
+
+	incoming.emplace_back(std::move(task));
+	curl_multi_wakeup(multi);
+}
+
+void Webhook::sendMessage(const std::string payload, std::string url) {
+	queueTask(WebhookTask { payload, url });
 }
 
 void Webhook::sendMessage(const std::string title, const std::string message, int color, std::string url) {
@@ -57,40 +81,162 @@ void Webhook::sendMessage(const std::string title, const std::string message, in
 		return;
 	}
 
-	sendMessage(getPayload(title, message, color), url);
+	queueTask(WebhookTask { getEmbed(title, message, color), url, true });
 }
 
-int Webhook::sendRequest(const char* url, const char* payload, std::string* response_body) const {
-	CURL* curl = curl_easy_init();
-	if (!curl) {
-		g_logger().error("Failed to send webhook message; curl_easy_init failed");
-		return -1;
+void Webhook::loop() {
+	int64_t deadline = 0;
+	while (true) {
+		const int64_t now = OTSYS_TIME();
+		{
+			std::scoped_lock lock { taskLock };
+			for (auto &task : incoming) {
+				auto &target = targets[task.url];
+				target.tasks.emplace_back(std::move(task));
+			}
+			incoming.clear();
+
+			if (stopping && deadline == 0) {
+				deadline = now + SHUTDOWN_TIMEOUT_MS;
+			}
+		}
+
+		if (deadline != 0) {
+			const bool pending = std::ranges::any_of(targets, [](const auto &entry) { return !entry.second.tasks.empty(); });
+			if (!pending || now >= deadline) {
+				break;
+			}
+		}
+
+		const int64_t wait = startRequests(now);
+
+		int running = 0;
+		curl_multi_perform(multi, &running);
+
+		int queued = 0;
+		while (CURLMsg* message = curl_multi_info_read(multi, &queued)) {
+			if (message->msg == CURLMSG_DONE) {
+				finishRequest(message->easy_handle, message->data.result, OTSYS_TIME());
+			}
+		}
+
+		curl_multi_poll(multi, nullptr, 0, static_cast<int>(std::clamp<int64_t>(wait, 0, 1000)), nullptr);
 	}
 
-	curl_easy_setopt(curl, CURLOPT_URL, url);
-	curl_easy_setopt(curl, CURLOPT_SSLVERSION, CURL_SSLVERSION_TLSv1_2);
-	curl_easy_setopt(curl, CURLOPT_POST, 1L);
-	curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload);
-	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &Webhook::writeCallback);
-	curl_easy_setopt(curl, CURLOPT_WRITEDATA, reinterpret_cast<void*>(response_body));
-	curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-	curl_easy_setopt(curl, CURLOPT_USERAGENT, "canary (https://github.com/Hydractify/canary)");
+	for (auto &[url, target] : targets) {
+		if (target.handle) {
+			curl_multi_remove_handle(multi, target.handle);
+			curl_easy_cleanup(target.handle);
+		}
+	}
+	targets.clear();
 
-	CURLcode res = curl_easy_perform(curl);
+	std::scoped_lock lock { taskLock };
+	curl_multi_cleanup(multi);
+	multi = nullptr;
+	curl_slist_free_all(headers);
+	headers = nullptr;
+}
 
-	if (res != CURLE_OK) {
-		g_logger().error("Failed to send webhook message with the error: {}", curl_easy_strerror(res));
-		curl_easy_cleanup(curl);
+int64_t Webhook::startRequests(int64_t now) {
+	int64_t wait = std::numeric_limits<int64_t>::max();
+	for (auto &[url, target] : targets) {
+		if (target.sending != 0 || target.tasks.empty()) {
+			continue;
+		}
+
+		if (target.nextRequest > now) {
+			wait = std::min(wait, target.nextRequest - now);
+			continue;
+		}
+
+		if (!target.handle) {
+			target.handle = curl_easy_init();
+			if (!target.handle) {
+				g_logger().error("Failed to send webhook message; curl_easy_init failed");
+				backOff(target, now, g_configManager().getNumber(DISCORD_WEBHOOK_DELAY_MS));
+				continue;
+			}
+
+			curl_easy_setopt(target.handle, CURLOPT_URL, url.c_str());
+			curl_easy_setopt(target.handle, CURLOPT_SSLVERSION, CURL_SSLVERSION_TLSv1_2);
+			curl_easy_setopt(target.handle, CURLOPT_POST, 1L);
+			curl_easy_setopt(target.handle, CURLOPT_WRITEFUNCTION, &Webhook::writeCallback);
+			curl_easy_setopt(target.handle, CURLOPT_WRITEDATA, reinterpret_cast<void*>(&target.responseBody));
+			curl_easy_setopt(target.handle, CURLOPT_HTTPHEADER, headers);
+			curl_easy_setopt(target.handle, CURLOPT_USERAGENT, "canary (https://github.com/Hydractify/canary)");
+			curl_easy_setopt(target.handle, CURLOPT_PRIVATE, reinterpret_cast<void*>(&target));
+		}
+
+		// Consecutive embeds share a message, other payloads go alone
+		if (target.tasks.front().embed) {
+			target.requestBody = "{ \"embeds\": [";
+			for (const auto &task : target.tasks) {
+				if (!task.embed || target.sending == MAX_EMBEDS_PER_MESSAGE) {
+					break;
+				}
+				if (target.sending++ != 0) {
+					target.requestBody += ", ";
+				}
+				target.requestBody += task.payload;
+			}
+			target.requestBody += "] }";
+		} else {
+			target.requestBody = target.tasks.front().payload;
+			target.sending = 1;
+		}
+
+		target.responseBody.clear();
+		curl_easy_setopt(target.handle, CURLOPT_POSTFIELDS, target.requestBody.c_str());
+		curl_easy_setopt(target.handle, CURLOPT_POSTFIELDSIZE, static_cast<long>(target.requestBody.size()));
+		curl_multi_add_handle(multi, target.handle);
+	}
+	return wait;
+}
 
-		return -1;
+void Webhook::finishRequest(CURL* handle, CURLcode result, int64_t now) {
+	Target* target = nullptr;
+	curl_easy_getinfo(handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&target));
+	curl_multi_remove_handle(multi, handle);
+
+	const size_t sent = std::exchange(target->sending, 0);
+	const int64_t delay = g_configManager().getNumber(DISCORD_WEBHOOK_DELAY_MS);
+	if (result != CURLE_OK) {
+		g_logger().error("Failed to send webhook message with the error: {}", curl_easy_strerror(result));
+		backOff(*target, now, delay);
+		return;
 	}
 
-	int response_code;
+	long responseCode = 0;
+	curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &responseCode);
+	if (responseCode == 429 || responseCode == 504) {
+		curl_off_t retryAfter = 0;
+		curl_easy_getinfo(handle, CURLINFO_RETRY_AFTER, &retryAfter);
+		g_logger().warn("Webhook encountered error code {}, re-queueing task.", responseCode);
+		backOff(*target, now, std::max<int64_t>(delay, retryAfter * 1000));
+		return;
+	}
 
-	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
-	curl_easy_cleanup(curl);
+	target->failures = 0;
+	target->nextRequest = now + delay;
+	if (responseCode >= 300) {
+		g_logger().error(
+			"Failed to send webhook message, error code: {} response body: {} request body: {}",
+			responseCode,
+			target->responseBody,
+			target->requestBody
+		);
+	} else {
+		g_logger().debug("Webhook successfully sent {} messages", sent);
+	}
+	target->tasks.erase(target->tasks.begin(), target->tasks.begin() + static_cast<std::ptrdiff_t>(sent));
+}
 
-	return response_code;
+void Webhook::backOff(Target &target, int64_t now, int64_t delay) {
+	// Doubles with each failure in a row, the rate limit of the answer is waited for at least
+	const auto backoff = std::min<int64_t>(MAX_BACKOFF_MS, delay << std::min<uint32_t>(target.failures, 16));
+	target.nextRequest = now + std::max(delay, backoff);
+	++target.failures;
 }
 
 size_t Webhook::writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
@@ -100,7 +246,7 @@ size_t Webhook::writeCallback(void* contents, size_t size, size_t nmemb, void* u
 	return real_size;
 }
 
-std::string Webhook::getPayload(const std::string title, const std::string message, int color) const {
+std::string Webhook::getEmbed(const std::string title, const std::string message, int color) const {
 	std::time_t now = getTimeNow();
 	std::string time_buf = formatDate(now);
 
@@ -110,51 +256,14 @@ std::string Webhook::getPayload(const std::string title, const std::string messa
 		<< time_buf;
 
 	std::stringstream payload;
-	payload << "{ \"embeds\": [{ ";
+	payload << "{ ";
 	payload << "\"title\": \"" << title << "\", ";
 	payload << "\"description\": \"" << message << "\", ";
 	payload << "\"footer\": { \"text\": \"" << footer_text.str() << "\" }, ";
 	if (color >= 0) {
 		payload << "\"color\": " << color;
 	}
-	payload << " }] }";
+	payload << " }";
 
 	return payload.str();
 }
-
-void Webhook::sendWebhook() {
-	std::scoped_lock lock { taskLock };
-	if (webhooks.empty()) {
-		return;
-	}
-
-	auto task = webhooks.front();
-
-	std::string response_body;
-	auto response_code = sendRequest(task->url.c_str(), task->payload.c_str(), &response_body);
-
-	if (response_code == -1) {
-		return;
-	}
-
-	if (response_code == 429 || response_code == 504) {
-		g_logger().warn("Webhook encountered error code {}, re-queueing task.", response_code);
-
-		return;
-	}
-
-	webhooks.pop_front();
-
-	if (response_code >= 300) {
-		g_logger().error(
-			"Failed to send webhook message, error code: {} response body: {} request body: {}",
-			response_code,
-			response_body,
-			task->payload
-		);
-
-		return;
-	}
-
-	g_logger().debug("Webhook successfully sent to {}", task->url);
-}
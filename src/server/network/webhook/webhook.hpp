@@ -9,18 +9,31 @@
 
 #pragma once
 
-#include "lib/thread/thread_pool.hpp"
-
 struct WebhookTask {
 	std::string payload;
 	std::string url;
+	// The payload is a single Discord embed, sent in one message with the other embeds queued for the url
+	bool embed = false;
 };
 
+/**
+ * Sends the webhook messages from its own thread with a curl multi handle.
+ * Each url keeps one easy handle, so its connection and TLS session are
+ * reused, and has a single request in flight: the embeds queued meanwhile
+ * go out together in the next one. Urls that answer 429 wait as long as
+ * they ask, failed requests are retried with an exponential back-off.
+ */
 class Webhook {
 public:
 	static constexpr size_t DEFAULT_DELAY_MS = 1000;
+	// Discord takes at most 10 embeds per message
+	static constexpr size_t MAX_EMBEDS_PER_MESSAGE = 10;
+	static constexpr int64_t MAX_BACKOFF_MS = 60 * 1000;
+	// Time left to the queued messages on shutdown
+	static constexpr int64_t SHUTDOWN_TIMEOUT_MS = 5 * 1000;
 
-	explicit Webhook(ThreadPool &threadPool);
+	Webhook();
+	~Webhook();
 
 	// Singleton - ensures we don't accidentally copy it
 	Webhook(const Webhook &) = delete;
@@ -28,22 +41,44 @@ public:
 
 	static Webhook &getInstance();
 
-	void run();
+	// Sends what is queued, for a few seconds at most, and stops the thread
+	void shutdown();
 
 	void sendMessage(const std::string payload, std::string url);
 	void sendMessage(const std::string title, const std::string message, int color, std::string url = "");
 
 private:
-	std::mutex taskLock;
-	ThreadPool &threadPool;
-	std::deque<std::shared_ptr<WebhookTask>> webhooks;
-	curl_slist* headers = nullptr;
+	// Everything in it belongs to the webhook thread
+	struct Target {
+		std::deque<WebhookTask> tasks;
+		CURL* handle = nullptr;
+		// Tasks the request in flight carries, 0 when there is none
+		size_t sending = 0;
+		std::string requestBody;
+		std::string responseBody;
+		int64_t nextRequest = 0;
+		uint32_t failures = 0;
+	};
 
-	void sendWebhook();
+	void queueTask(WebhookTask task);
+	void loop();
+	// Returns the time until a url waiting for its delay may send again
+	int64_t startRequests(int64_t now);
+	void finishRequest(CURL* handle, CURLcode result, int64_t now);
+	void backOff(Target &target, int64_t now, int64_t delay);
 
-	int sendRequest(const char* url, const char* payload, std::string* response_body) const;
 	static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp);
-	std::string getPayload(const std::string title, const std::string message, int color) const;
+	std::string getEmbed(const std::string title, const std::string message, int color) const;
+
+	std::mutex taskLock;
+	std::vector<WebhookTask> incoming;
+	bool stopping = false;
+
+	// Pointers to the targets are kept by their handles, std::map never moves them
+	std::map<std::string, Target> targets;
+	CURLM* multi = nullptr;
+	curl_slist* headers = nullptr;
+	std::jthread thread;
 };
 
 constexpr auto g_webhook = Webhook::getInstance;
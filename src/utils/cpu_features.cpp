@@ -0,0 +1,60 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "utils/cpu_features.hpp"
+
+#if defined(CANARY_SIMD_X86_64) && defined(_MSC_VER) && !defined(__clang__)
+	#include <intrin.h>
+#endif
+
+namespace {
+	CpuFeatures detectCpuFeatures() {
+		CpuFeatures features;
+#if defined(CANARY_SIMD_X86_64) && defined(_MSC_VER) && !defined(__clang__)
+		std::array<int, 4> info {};
+		__cpuid(info.data(), 0);
+		const int maxLeaf = info[0];
+
+		__cpuid(info.data(), 1);
+		features.ssse3 = (info[2] & (1 << 9)) != 0;
+		// AVX registers also need the OS to save them, OSXSAVE and XCR0
+		const bool osSavesAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+		if (maxLeaf >= 7 && osSavesAvx) {
+			__cpuidex(info.data(), 7, 0);
+			features.avx2 = (info[1] & (1 << 5)) != 0;
+		}
+#elif defined(CANARY_SIMD_X86_64)
+		// Also checks that the OS saves the AVX registers
+		__builtin_cpu_init();
+		features.ssse3 = __builtin_cpu_supports("ssse3");
+		features.avx2 = __builtin_cpu_supports("avx2");
+#elif defined(__NEON__) || defined(__aarch64__) || defined(_M_ARM64)
+		// Part of every AArch64 core, and of the ARM builds that target it
+		features.neon = true;
+#endif
+		return features;
+	}
+}
+
+std::string CpuFeatures::toString() const {
+	std::string result;
+	for (const auto &[name, supported] : { std::pair { "ssse3", ssse3 }, std::pair { "avx2", avx2 }, std::pair { "neon", neon } }) {
+		if (supported) {
+			result += result.empty() ? name : fmt::format(" {}", name);
+		}
+	}
+	return result.empty() ? "none" : result;
+}
+
+const CpuFeatures &getCpuFeatures() {
+	static const CpuFeatures features = detectCpuFeatures();
+	return features;
+}
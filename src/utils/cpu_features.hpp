@@ -0,0 +1,26 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Vector extensions of the host, read once. Kernels built with
+ * CANARY_TARGET (utils/simd.hpp) for more than the build targets are only
+ * called when these say the host runs them, so one binary uses AVX2 where
+ * it exists and still starts everywhere else.
+ */
+struct CpuFeatures {
+	bool ssse3 = false;
+	bool avx2 = false;
+	bool neon = false;
+
+	std::string toString() const;
+};
+
+const CpuFeatures &getCpuFeatures();
@@ -4,6 +4,14 @@ namespace stdext {
 	template <class _Kty>
 	using hash = phmap::Hash<_Kty>;
 
+	// FNV-1a, for hashes that end up on disk and so must not depend on the standard library
+	inline uint64_t hash_bytes(std::string_view bytes, uint64_t hash = 0xcbf29ce484222325) {
+		for (const auto byte : bytes) {
+			hash = (hash ^ static_cast<uint8_t>(byte)) * 0x100000001b3;
+		}
+		return hash;
+	}
+
 	// Robin Hood lib
 	inline size_t hash_int(uint64_t x) noexcept {
 		x ^= x >> 33U;
@@ -17,24 +25,24 @@ namespace stdext {
 		seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 	}
 
-	void hash_combine(size_t &seed, uint64_t v) {
+	inline void hash_combine(size_t &seed, uint64_t v) {
 		hash_union(seed, hash_int(v));
 	}
 
-	void hash_combine(size_t &seed, uint32_t v) {
+	inline void hash_combine(size_t &seed, uint32_t v) {
 		hash_union(seed, hash_int(v));
 	}
 
-	void hash_combine(size_t &seed, uint16_t v) {
+	inline void hash_combine(size_t &seed, uint16_t v) {
 		hash_union(seed, hash_int(v));
 	}
 
-	void hash_combine(size_t &seed, uint8_t v) {
+	inline void hash_combine(size_t &seed, uint8_t v) {
 		hash_union(seed, hash_int(v));
 	}
 
 	template <class T>
-	void hash_combine(size_t &seed, const T &v) {
+	inline void hash_combine(size_t &seed, const T &v) {
 		stdext::hash<T> hasher;
 		hash_union(seed, hasher(v));
 	}
@@ -0,0 +1,179 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Reference counted base for objects held by IntrusivePtr.
+ * The count lives in the object itself: there is no separate control block
+ * and no weak count, and a handle can be made from this at any time, which
+ * is what shared_from_this needs a weak pointer per object for.
+ *
+ * With Atomic false the count is a plain integer, for objects only ever
+ * referenced from the dispatcher thread. Objects that are handed to the
+ * thread pool (saves, map loading) must use the atomic count.
+ *
+ * Derived is the base of the hierarchy, its destructor must be virtual
+ * when subclasses are released through it.
+ */
+template <typename Derived, bool Atomic = false>
+class RefCounted {
+public:
+	RefCounted(const RefCounted &) noexcept { }
+	RefCounted &operator=(const RefCounted &) noexcept {
+		return *this;
+	}
+
+	void addReference() const noexcept {
+		if constexpr (Atomic) {
+			references.fetch_add(1, std::memory_order_relaxed);
+		} else {
+			++references;
+		}
+	}
+
+	void releaseReference() const noexcept {
+		if constexpr (Atomic) {
+			if (references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+				return;
+			}
+		} else if (--references != 0) {
+			return;
+		}
+		delete static_cast<const Derived*>(this);
+	}
+
+	uint32_t getReferenceCount() const noexcept {
+		if constexpr (Atomic) {
+			return references.load(std::memory_order_relaxed);
+		} else {
+			return references;
+		}
+	}
+
+protected:
+	RefCounted() noexcept = default;
+	~RefCounted() = default;
+
+private:
+	mutable std::conditional_t<Atomic, std::atomic<uint32_t>, uint32_t> references = 0;
+};
+
+/**
+ * Handle to a RefCounted object, with the interface of std::shared_ptr the
+ * game code uses: copies, moves, upcasts, casts, comparisons and hashing.
+ * It is a single pointer wide, copying it touches the object only.
+ */
+template <typename T>
+class IntrusivePtr {
+public:
+	using element_type = T;
+
+	IntrusivePtr() noexcept = default;
+	IntrusivePtr(std::nullptr_t) noexcept { }
+
+	explicit IntrusivePtr(T* pointer) noexcept :
+		pointer(pointer) {
+		if (pointer) {
+			pointer->addReference();
+		}
+	}
+
+	IntrusivePtr(const IntrusivePtr &other) noexcept :
+		IntrusivePtr(other.pointer) { }
+
+	IntrusivePtr(IntrusivePtr &&other) noexcept :
+		pointer(std::exchange(other.pointer, nullptr)) { }
+
+	template <typename U>
+		requires std::convertible_to<U*, T*>
+	IntrusivePtr(const IntrusivePtr<U> &other) noexcept :
+		IntrusivePtr(other.get()) { }
+
+	template <typename U>
+		requires std::convertible_to<U*, T*>
+	IntrusivePtr(IntrusivePtr<U> &&other) noexcept :
+		pointer(other.detach()) { }
+
+	~IntrusivePtr() {
+		if (pointer) {
+			pointer->releaseReference();
+		}
+	}
+
+	IntrusivePtr &operator=(IntrusivePtr other) noexcept {
+		swap(other);
+		return *this;
+	}
+
+	void reset() noexcept {
+		IntrusivePtr().swap(*this);
+	}
+
+	void swap(IntrusivePtr &other) noexcept {
+		std::swap(pointer, other.pointer);
+	}
+
+	// Gives up the reference without releasing it
+	T* detach() noexcept {
+		return std::exchange(pointer, nullptr);
+	}
+
+	T* get() const noexcept {
+		return pointer;
+	}
+
+	T &operator*() const noexcept {
+		return *pointer;
+	}
+
+	T* operator->() const noexcept {
+		return pointer;
+	}
+
+	explicit operator bool() const noexcept {
+		return pointer != nullptr;
+	}
+
+	template <typename U>
+	bool operator==(const IntrusivePtr<U> &other) const noexcept {
+		return pointer == other.get();
+	}
+
+	bool operator==(std::nullptr_t) const noexcept {
+		return pointer == nullptr;
+	}
+
+private:
+	T* pointer = nullptr;
+};
+
+// std::make_shared for RefCounted types
+template <typename T, typename... Args>
+IntrusivePtr<T> makeIntrusive(Args &&... args) {
+	return IntrusivePtr<T>(new T(std::forward<Args>(args)...));
+}
+
+// Found by argument dependent lookup, so unqualified calls work with both handle types
+template <typename T, typename U>
+IntrusivePtr<T> static_pointer_cast(const IntrusivePtr<U> &source) noexcept {
+	return IntrusivePtr<T>(static_cast<T*>(source.get()));
+}
+
+template <typename T, typename U>
+IntrusivePtr<T> dynamic_pointer_cast(const IntrusivePtr<U> &source) noexcept {
+	return IntrusivePtr<T>(dynamic_cast<T*>(source.get()));
+}
+
+template <typename T>
+struct std::hash<IntrusivePtr<T>> {
+	size_t operator()(const IntrusivePtr<T> &pointer) const noexcept {
+		return std::hash<T*>()(pointer.get());
+	}
+};
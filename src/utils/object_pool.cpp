@@ -0,0 +1,49 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "utils/object_pool.hpp"
+
+namespace {
+	struct PoolList {
+		std::mutex mutex;
+		std::vector<const ObjectPoolBase*> pools;
+	};
+
+	// Never destroyed, like the pools it points to
+	PoolList &getPoolList() {
+		static auto* list = new PoolList();
+		return *list;
+	}
+}
+
+void ObjectPoolRegistry::add(const ObjectPoolBase* pool) {
+	auto &list = getPoolList();
+	std::scoped_lock lock(list.mutex);
+	list.pools.emplace_back(pool);
+}
+
+std::vector<ObjectPoolStats> ObjectPoolRegistry::getStats() {
+	std::vector<const ObjectPoolBase*> pools;
+	{
+		auto &list = getPoolList();
+		std::scoped_lock lock(list.mutex);
+		pools = list.pools;
+	}
+
+	std::vector<ObjectPoolStats> stats;
+	stats.reserve(pools.size());
+	for (const auto pool : pools) {
+		stats.emplace_back(pool->getStats());
+	}
+
+	std::ranges::sort(stats, {}, &ObjectPoolStats::name);
+	return stats;
+}
@@ -0,0 +1,252 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Name a pooled type reports its stats under. Every type created with
+ * makePooled needs a specialization, e.g.:
+ * template <> struct ObjectPoolName<Item> { static constexpr std::string_view value = "Item"; };
+ */
+template <typename T>
+struct ObjectPoolName;
+
+struct ObjectPoolStats {
+	std::string_view name;
+	// Size of one slot, including the shared_ptr control block
+	size_t blockSize = 0;
+	uint64_t live = 0;
+	uint64_t capacity = 0;
+};
+
+class ObjectPoolBase {
+public:
+	virtual ~ObjectPoolBase() = default;
+	virtual ObjectPoolStats getStats() const = 0;
+};
+
+class ObjectPoolRegistry {
+public:
+	static void add(const ObjectPoolBase* pool);
+
+	// Stats of every pool that allocated at least once, sorted by name
+	static std::vector<ObjectPoolStats> getStats();
+};
+
+/**
+ * Fixed size slab allocator, one per pooled type.
+ * Slots are carved from slabs of SLAB_BLOCKS and never given back to the
+ * system, so objects churning all day (loot, corpses, split stacks) reuse
+ * the same memory instead of fragmenting the general heap.
+ *
+ * Like the output message buffers, every thread keeps its own freelist
+ * and only moves a batch from or to the shared one under the mutex, as
+ * objects created on one thread are often released on another.
+ */
+template <typename Owner, size_t BlockSize, size_t BlockAlign>
+class SlabPool final : public ObjectPoolBase {
+public:
+	static constexpr size_t SLAB_BLOCKS = 256;
+	static constexpr size_t THREAD_FREELIST_SIZE = 128;
+
+	// Never destroyed, objects may still be released while statics are torn down
+	static SlabPool &getInstance() {
+		static auto* pool = new SlabPool();
+		return *pool;
+	}
+
+	// Ensures that we don't accidentally copy it
+	SlabPool(const SlabPool &) = delete;
+	SlabPool operator=(const SlabPool &) = delete;
+
+	void* allocate() {
+		live.fetch_add(1, std::memory_order_relaxed);
+		if (threadFreelistDestroyed) {
+			std::scoped_lock lock(mutex);
+			if (!sharedFreelist.head) {
+				addSlab();
+			}
+			return pop(sharedFreelist, 1);
+		}
+
+		auto &freelist = getThreadFreelist();
+		if (!freelist.head) {
+			std::scoped_lock lock(mutex);
+			if (!sharedFreelist.head) {
+				addSlab();
+			}
+			const size_t sharedSize = sharedFreelist.size;
+			freelist.head = pop(sharedFreelist, THREAD_FREELIST_SIZE / 2);
+			freelist.size = sharedSize - sharedFreelist.size;
+		}
+
+		auto block = freelist.head;
+		freelist.head = block->next;
+		--freelist.size;
+		return block;
+	}
+
+	void deallocate(void* pointer) {
+		live.fetch_sub(1, std::memory_order_relaxed);
+		auto block = static_cast<FreeBlock*>(pointer);
+		if (threadFreelistDestroyed) {
+			std::scoped_lock lock(mutex);
+			push(sharedFreelist, block, block, 1);
+			return;
+		}
+
+		auto &freelist = getThreadFreelist();
+		block->next = freelist.head;
+		freelist.head = block;
+		if (++freelist.size >= THREAD_FREELIST_SIZE) {
+			moveToShared(freelist, THREAD_FREELIST_SIZE / 2);
+		}
+	}
+
+	ObjectPoolStats getStats() const override {
+		std::scoped_lock lock(mutex);
+		return { ObjectPoolName<Owner>::value, BLOCK_SIZE, live.load(std::memory_order_relaxed), slabs.size() * SLAB_BLOCKS };
+	}
+
+private:
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	static constexpr size_t BLOCK_ALIGN = std::max(BlockAlign, alignof(FreeBlock));
+	static constexpr size_t BLOCK_SIZE = (std::max(BlockSize, sizeof(FreeBlock)) + BLOCK_ALIGN - 1) / BLOCK_ALIGN * BLOCK_ALIGN;
+
+	struct Freelist {
+		FreeBlock* head = nullptr;
+		size_t size = 0;
+	};
+
+	struct ThreadFreelist : Freelist {
+		ThreadFreelist() = default;
+		~ThreadFreelist() {
+			if (this->head) {
+				getInstance().moveToShared(*this, this->size);
+			}
+			threadFreelistDestroyed = true;
+		}
+
+		// Ensures that we don't accidentally copy it
+		ThreadFreelist(const ThreadFreelist &) = delete;
+		ThreadFreelist operator=(const ThreadFreelist &) = delete;
+	};
+
+	SlabPool() {
+		ObjectPoolRegistry::add(this);
+	}
+	~SlabPool() override = default;
+
+	static ThreadFreelist &getThreadFreelist() {
+		static thread_local ThreadFreelist freelist;
+		return freelist;
+	}
+
+	// Detaches up to count blocks from the front of the list, the returned chain is null terminated
+	static FreeBlock* pop(Freelist &list, size_t count) {
+		auto first = list.head;
+		auto last = first;
+		size_t taken = 1;
+		while (taken < count && last->next) {
+			last = last->next;
+			++taken;
+		}
+		list.head = last->next;
+		list.size -= taken;
+		last->next = nullptr;
+		return first;
+	}
+
+	static void push(Freelist &list, FreeBlock* first, FreeBlock* last, size_t count) {
+		last->next = list.head;
+		list.head = first;
+		list.size += count;
+	}
+
+	void moveToShared(Freelist &freelist, size_t count) {
+		auto last = freelist.head;
+		for (size_t i = 1; i < count; ++i) {
+			last = last->next;
+		}
+
+		auto first = freelist.head;
+		freelist.head = last->next;
+		freelist.size -= count;
+
+		std::scoped_lock lock(mutex);
+		push(sharedFreelist, first, last, count);
+	}
+
+	// Mutex held
+	void addSlab() {
+		auto &slab = slabs.emplace_back(static_cast<std::byte*>(::operator new(BLOCK_SIZE * SLAB_BLOCKS, std::align_val_t { BLOCK_ALIGN })));
+		for (size_t i = SLAB_BLOCKS; i > 0; --i) {
+			auto block = reinterpret_cast<FreeBlock*>(slab + (i - 1) * BLOCK_SIZE);
+			push(sharedFreelist, block, block, 1);
+		}
+	}
+
+	static inline thread_local bool threadFreelistDestroyed = false;
+
+	mutable std::mutex mutex;
+	Freelist sharedFreelist;
+	std::vector<std::byte*> slabs;
+	std::atomic<uint64_t> live = 0;
+};
+
+/**
+ * Allocator handing out SlabPool slots, for std::allocate_shared.
+ * The shared_ptr rebinds it to its control block type, so the object and
+ * its reference counts share a single slot. Owner is the type the stats
+ * are reported under.
+ */
+template <typename T, typename Owner = T>
+class PoolAllocator {
+public:
+	using value_type = T;
+
+	template <typename U>
+	struct rebind {
+		using other = PoolAllocator<U, Owner>;
+	};
+
+	PoolAllocator() noexcept = default;
+
+	template <typename U>
+	PoolAllocator(const PoolAllocator<U, Owner> &) noexcept { }
+
+	T* allocate(size_t count) {
+		if (count != 1) {
+			return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t { alignof(T) }));
+		}
+		return static_cast<T*>(SlabPool<Owner, sizeof(T), alignof(T)>::getInstance().allocate());
+	}
+
+	void deallocate(T* pointer, size_t count) noexcept {
+		if (count != 1) {
+			::operator delete(pointer, std::align_val_t { alignof(T) });
+			return;
+		}
+		SlabPool<Owner, sizeof(T), alignof(T)>::getInstance().deallocate(pointer);
+	}
+
+	template <typename U>
+	bool operator==(const PoolAllocator<U, Owner> &) const noexcept {
+		return true;
+	}
+};
+
+// std::make_shared drawing the object and its control block from the pool of T
+template <typename T, typename... Args>
+std::shared_ptr<T> makePooled(Args &&... args) {
+	return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
@@ -0,0 +1,95 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * xoshiro256** (Blackman and Vigna): 32 bytes of state and a few shifts
+ * and multiplies per 64 bits, good enough for every roll of the game.
+ * Each thread has its own, see getRandomGenerator, so the dispatcher and
+ * the threads of the pool never share one.
+ *
+ * It is a UniformRandomBitGenerator, so it also works with std::shuffle and
+ * the standard distributions.
+ */
+class RandomGenerator {
+public:
+	using result_type = uint64_t;
+
+	explicit RandomGenerator(uint64_t seed) {
+		this->seed(seed);
+	}
+
+	static constexpr result_type min() {
+		return std::numeric_limits<result_type>::min();
+	}
+	static constexpr result_type max() {
+		return std::numeric_limits<result_type>::max();
+	}
+
+	void seed(uint64_t seed) {
+		// Expanded with splitmix64, so that any seed, 0 included, gives a well mixed state
+		for (auto &word : state) {
+			seed += 0x9E3779B97F4A7C15ULL;
+			uint64_t mixed = seed;
+			mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+			word = mixed ^ (mixed >> 31);
+		}
+	}
+
+	result_type operator()() {
+		const uint64_t result = std::rotl(state[1] * 5, 7) * 9;
+		const uint64_t shifted = state[1] << 17;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= shifted;
+		state[3] = std::rotl(state[3], 45);
+		return result;
+	}
+
+	// Uniform in [minNumber, maxNumber], minNumber not above maxNumber
+	int32_t uniform(int32_t minNumber, int32_t maxNumber) {
+		const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(maxNumber) - minNumber) + 1;
+		return static_cast<int32_t>(minNumber + static_cast<int64_t>(bounded(range, rejectionThreshold(range))));
+	}
+
+	// The same rolls as calling uniform for each value, the range set up once
+	void fillUniform(std::span<int32_t> values, int32_t minNumber, int32_t maxNumber) {
+		const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(maxNumber) - minNumber) + 1;
+		const uint32_t threshold = rejectionThreshold(range);
+		for (auto &value : values) {
+			value = static_cast<int32_t>(minNumber + static_cast<int64_t>(bounded(range, threshold)));
+		}
+	}
+
+	// Uniform in [0, 1)
+	double uniformReal() {
+		return static_cast<double>(operator()() >> 11) * 0x1.0p-53;
+	}
+
+private:
+	// Lemire's multiply and reject: the values below the threshold would make some results more likely
+	static uint32_t rejectionThreshold(uint64_t range) {
+		return static_cast<uint32_t>(((1ULL << 32) - range) % range);
+	}
+
+	// In [0, range), range up to 2^32
+	uint64_t bounded(uint64_t range, uint32_t threshold) {
+		uint64_t product = (operator()() >> 32) * range;
+		while (static_cast<uint32_t>(product) < threshold) {
+			product = (operator()() >> 32) * range;
+		}
+		return product >> 32;
+	}
+
+	std::array<uint64_t, 4> state;
+};
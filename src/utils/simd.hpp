@@ -52,6 +52,19 @@
 	#if defined(__AVX__) || defined(__AVX2__) || defined(__AVX512F__)
 		#include <immintrin.h>
 	#endif
+
+	// x86-64 always has SSE2, wider kernels are compiled with CANARY_TARGET and picked at runtime (utils/cpu_features.hpp)
+	#if defined(__x86_64__) || defined(_M_X64)
+		#define CANARY_SIMD_X86_64 1
+		#include <immintrin.h>
+	#endif
+#endif
+
+// Lets one function use instructions the build does not target, MSVC takes the intrinsics anywhere
+#if defined(_MSC_VER) && !defined(__clang__)
+	#define CANARY_TARGET(features)
+#else
+	#define CANARY_TARGET(features) __attribute__((target(features)))
 #endif
 
 #ifdef _MSC_VER
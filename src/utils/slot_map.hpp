@@ -0,0 +1,148 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Values by generational ids within [firstId, lastId]: the low SlotBits of
+ * id - firstId pick a slot, the bits above are the generation of the slot.
+ * Lookups are an index and a compare, and the ids of erased values are
+ * stale for good, their slot is only reused with the next generation.
+ *
+ * Values live in one dense vector of (id, value) pairs, iterated in no
+ * particular order: erasing moves the last pair into the hole. Freed slots
+ * are reused oldest first, so an id comes back only after every other free
+ * slot went through as many generations.
+ */
+template <typename T, uint8_t SlotBits>
+class SlotMap {
+public:
+	using value_type = std::pair<uint32_t, T>;
+
+	// Only whole generations are used, the ids past the last one are never given out
+	SlotMap(uint32_t firstId, uint32_t lastId) :
+		firstId(firstId), generations(static_cast<uint32_t>((static_cast<uint64_t>(lastId) - firstId + 1) >> SlotBits)) {
+		assert(firstId != 0 && lastId > firstId && "Id 0 means no creature");
+		assert(generations >= 2 && generations <= (1ULL << (32 - SlotBits)) - 1 && "The id range must hold two generations at least");
+	}
+
+	// Returns the id of the value, 0 when every slot holds one
+	uint32_t insert(T value) {
+		uint32_t slot;
+		if (!freeSlots.empty()) {
+			slot = freeSlots.front();
+			freeSlots.pop_front();
+		} else if (slots.size() < MAX_SLOTS) {
+			slot = static_cast<uint32_t>(slots.size());
+			slots.emplace_back();
+		} else {
+			return 0;
+		}
+
+		const uint32_t id = makeId(slot, slots[slot].generation);
+		slots[slot].entry = static_cast<uint32_t>(entries.size());
+		entries.emplace_back(id, std::move(value));
+		return id;
+	}
+
+	// False when the id was stale or out of range
+	bool erase(uint32_t id) {
+		const auto slot = findSlot(id);
+		if (!slot) {
+			return false;
+		}
+
+		const uint32_t entry = slots[*slot].entry;
+		if (entry != entries.size() - 1) {
+			entries[entry] = std::move(entries.back());
+			slots[(entries[entry].first - firstId) & SLOT_MASK].entry = entry;
+		}
+		entries.pop_back();
+
+		slots[*slot].entry = NO_ENTRY;
+		slots[*slot].generation = (slots[*slot].generation + 1) % generations;
+		freeSlots.push_back(*slot);
+		return true;
+	}
+
+	// Nullptr when the id is stale or out of range
+	const T* find(uint32_t id) const {
+		const auto slot = findSlot(id);
+		return slot ? &entries[slots[*slot].entry].second : nullptr;
+	}
+
+	bool contains(uint32_t id) const {
+		return findSlot(id).has_value();
+	}
+
+	bool isInRange(uint32_t id) const {
+		return id >= firstId && id - firstId < (generations << SlotBits);
+	}
+
+	size_t size() const {
+		return entries.size();
+	}
+
+	bool empty() const {
+		return entries.empty();
+	}
+
+	void clear() {
+		// Every slot moves on a generation, no id given out before stays valid
+		for (size_t slot = 0; slot < slots.size(); ++slot) {
+			if (slots[slot].entry != NO_ENTRY) {
+				slots[slot].entry = NO_ENTRY;
+				slots[slot].generation = (slots[slot].generation + 1) % generations;
+				freeSlots.push_back(static_cast<uint32_t>(slot));
+			}
+		}
+		entries.clear();
+	}
+
+	auto begin() const {
+		return entries.begin();
+	}
+
+	auto end() const {
+		return entries.end();
+	}
+
+private:
+	static constexpr uint32_t MAX_SLOTS = 1U << SlotBits;
+	static constexpr uint32_t SLOT_MASK = MAX_SLOTS - 1;
+	static constexpr uint32_t NO_ENTRY = std::numeric_limits<uint32_t>::max();
+
+	struct Slot {
+		uint32_t generation = 0;
+		uint32_t entry = NO_ENTRY;
+	};
+
+	uint32_t makeId(uint32_t slot, uint32_t generation) const {
+		return firstId + ((generation << SlotBits) | slot);
+	}
+
+	std::optional<uint32_t> findSlot(uint32_t id) const {
+		if (!isInRange(id)) {
+			return std::nullopt;
+		}
+
+		const uint32_t offset = id - firstId;
+		const uint32_t slot = offset & SLOT_MASK;
+		if (slot >= slots.size() || slots[slot].entry == NO_ENTRY || slots[slot].generation != offset >> SlotBits) {
+			return std::nullopt;
+		}
+		return slot;
+	}
+
+	uint32_t firstId;
+	uint32_t generations;
+	std::vector<Slot> slots;
+	std::vector<value_type> entries;
+	std::deque<uint32_t> freeSlots;
+};
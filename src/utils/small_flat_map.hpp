@@ -0,0 +1,112 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Map for the few entries per owner case, such as the attackers of a
+ * creature. The (key, value) pairs live in one vector in the order they
+ * were added and are found with a linear scan. Past LinearLimit entries a
+ * hash index by key is kept next to them, so a boss with a hundred
+ * attackers is not scanned on every hit.
+ *
+ * There is no erase of single entries, only clear, so the index of a pair
+ * never changes.
+ */
+template <typename Key, typename Value, size_t LinearLimit = 16>
+class SmallFlatMap {
+public:
+	using value_type = std::pair<Key, Value>;
+	using iterator = typename std::vector<value_type>::iterator;
+	using const_iterator = typename std::vector<value_type>::const_iterator;
+
+	iterator find(const Key &key) {
+		return entries.begin() + indexOf(key);
+	}
+
+	const_iterator find(const Key &key) const {
+		return entries.begin() + indexOf(key);
+	}
+
+	bool contains(const Key &key) const {
+		return indexOf(key) != entries.size();
+	}
+
+	template <typename... Args>
+	std::pair<iterator, bool> try_emplace(const Key &key, Args &&... args) {
+		const auto position = indexOf(key);
+		if (position != entries.size()) {
+			return { entries.begin() + position, false };
+		}
+
+		entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+		if (!index.empty()) {
+			index.emplace(key, static_cast<uint32_t>(position));
+		} else if (entries.size() > LinearLimit) {
+			index.reserve(entries.size() * 2);
+			for (size_t i = 0; i < entries.size(); ++i) {
+				index.emplace(entries[i].first, static_cast<uint32_t>(i));
+			}
+		}
+		return { entries.end() - 1, true };
+	}
+
+	Value &operator[](const Key &key) {
+		return try_emplace(key).first->second;
+	}
+
+	size_t size() const {
+		return entries.size();
+	}
+
+	bool empty() const {
+		return entries.empty();
+	}
+
+	void clear() {
+		entries.clear();
+		index.clear();
+	}
+
+	iterator begin() {
+		return entries.begin();
+	}
+
+	iterator end() {
+		return entries.end();
+	}
+
+	const_iterator begin() const {
+		return entries.begin();
+	}
+
+	const_iterator end() const {
+		return entries.end();
+	}
+
+private:
+	// size() when the key is not there
+	size_t indexOf(const Key &key) const {
+		if (!index.empty()) {
+			const auto it = index.find(key);
+			return it != index.end() ? it->second : entries.size();
+		}
+
+		for (size_t i = 0; i < entries.size(); ++i) {
+			if (entries[i].first == key) {
+				return i;
+			}
+		}
+		return entries.size();
+	}
+
+	std::vector<value_type> entries;
+	// Empty while there are LinearLimit entries or fewer
+	phmap::flat_hash_map<Key, uint32_t> index;
+};
@@ -0,0 +1,123 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+template <typename Signature, size_t Capacity = 64>
+class SmallFunction;
+
+/**
+ * Move-only type erased callable with inline storage.
+ * Callables up to Capacity bytes (lambdas, std::bind results) are stored
+ * in place without touching the heap; bigger ones fall back to a single
+ * heap allocation.
+ */
+template <typename R, typename... Args, size_t Capacity>
+class SmallFunction<R(Args...), Capacity> {
+public:
+	SmallFunction() = default;
+	SmallFunction(std::nullptr_t) { }
+
+	template <typename F>
+		requires(!std::is_same_v<std::remove_cvref_t<F>, SmallFunction> && std::is_invocable_r_v<R, std::decay_t<F> &, Args...>)
+	SmallFunction(F &&f) {
+		using Functor = std::decay_t<F>;
+		if constexpr (fitsInline<Functor>()) {
+			::new (static_cast<void*>(storage)) Functor(std::forward<F>(f));
+			vtable = &inlineVTable<Functor>;
+		} else {
+			::new (static_cast<void*>(storage)) Functor*(new Functor(std::forward<F>(f)));
+			vtable = &heapVTable<Functor>;
+		}
+	}
+
+	SmallFunction(SmallFunction &&other) noexcept {
+		moveFrom(other);
+	}
+
+	SmallFunction &operator=(SmallFunction &&other) noexcept {
+		if (this != &other) {
+			reset();
+			moveFrom(other);
+		}
+		return *this;
+	}
+
+	SmallFunction(const SmallFunction &) = delete;
+	SmallFunction &operator=(const SmallFunction &) = delete;
+
+	~SmallFunction() {
+		reset();
+	}
+
+	R operator()(Args... args) {
+		assert(vtable && "Calling an empty SmallFunction");
+		return vtable->invoke(storage, std::forward<Args>(args)...);
+	}
+
+	explicit operator bool() const {
+		return vtable != nullptr;
+	}
+
+	void reset() {
+		if (vtable) {
+			vtable->destroy(storage);
+			vtable = nullptr;
+		}
+	}
+
+private:
+	struct VTable {
+		R (*invoke)(void* storage, Args &&... args);
+		void (*move)(void* destination, void* source);
+		void (*destroy)(void* storage);
+	};
+
+	template <typename Functor>
+	static constexpr bool fitsInline() {
+		return sizeof(Functor) <= Capacity && alignof(Functor) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Functor>;
+	}
+
+	template <typename Functor>
+	static constexpr VTable inlineVTable {
+		[](void* storage, Args &&... args) -> R {
+			return std::invoke(*static_cast<Functor*>(storage), std::forward<Args>(args)...);
+		},
+		[](void* destination, void* source) {
+			::new (destination) Functor(std::move(*static_cast<Functor*>(source)));
+			static_cast<Functor*>(source)->~Functor();
+		},
+		[](void* storage) {
+			static_cast<Functor*>(storage)->~Functor();
+		},
+	};
+
+	template <typename Functor>
+	static constexpr VTable heapVTable {
+		[](void* storage, Args &&... args) -> R {
+			return std::invoke(**static_cast<Functor**>(storage), std::forward<Args>(args)...);
+		},
+		[](void* destination, void* source) {
+			::new (destination) Functor*(*static_cast<Functor**>(source));
+		},
+		[](void* storage) {
+			delete *static_cast<Functor**>(storage);
+		},
+	};
+
+	void moveFrom(SmallFunction &other) noexcept {
+		if (other.vtable) {
+			other.vtable->move(storage, other.storage);
+			vtable = std::exchange(other.vtable, nullptr);
+		}
+	}
+
+	alignas(std::max_align_t) std::byte storage[Capacity];
+	const VTable* vtable = nullptr;
+};
@@ -12,6 +12,13 @@
 #include "core.hpp"
 #include "items/item.hpp"
 #include "utils/tools.hpp"
+#include "utils/cpu_features.hpp"
+
+#ifdef _WIN32
+	#include <psapi.h>
+#else
+	#include <sys/resource.h>
+#endif
 
 void printXMLError(const std::string &where, const std::string &fileName, const pugi::xml_parse_result &result) {
 	g_logger().error("[{}] Failed to load {}: {}", where, fileName, result.description());
@@ -187,14 +194,6 @@ std::string transformToSHA1(const std::string &input) {
 	return std::string(hexstring, 40);
 }
 
-uint16_t getStashSize(StashItemList itemList) {
-	uint16_t size = 0;
-	for (auto item : itemList) {
-		size += ceil(item.second / (float_t)Item::items[item.first].stackSize);
-	}
-	return size;
-}
-
 std::string generateToken(const std::string &key, uint32_t ticks) {
 	// generate message from ticks
 	std::string message(8, 0);
@@ -258,7 +257,20 @@ void trim_left(std::string &source, char t) {
 }
 
 void toLowerCaseString(std::string &source) {
-	std::transform(source.begin(), source.end(), source.begin(), tolower);
+	size_t offset = 0;
+#if defined(CANARY_SIMD_X86_64)
+	// ASCII letters only, as tolower does in the C locale the server runs in; bytes above 127 compare negative and stay
+	const __m128i beforeA = _mm_set1_epi8('A' - 1);
+	const __m128i afterZ = _mm_set1_epi8('Z' + 1);
+	const __m128i caseBit = _mm_set1_epi8(0x20);
+	for (; offset + 16 <= source.size(); offset += 16) {
+		auto* chunk = reinterpret_cast<__m128i*>(source.data() + offset);
+		const __m128i characters = _mm_loadu_si128(chunk);
+		const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(characters, beforeA), _mm_cmplt_epi8(characters, afterZ));
+		_mm_storeu_si128(chunk, _mm_or_si128(characters, _mm_and_si128(upper, caseBit)));
+	}
+#endif
+	std::transform(source.begin() + static_cast<std::ptrdiff_t>(offset), source.end(), source.begin() + static_cast<std::ptrdiff_t>(offset), tolower);
 }
 
 std::string asLowerCaseString(std::string source) {
@@ -380,24 +392,38 @@ IntegerVector vectorAtoi(const StringVector &stringVector) {
 	return returnVector;
 }
 
-std::mt19937 &getRandomGenerator() {
-	static std::random_device rd;
-	static std::mt19937 generator(rd());
+namespace {
+	std::atomic<uint64_t> sharedSeed = 0;
+	// Bumped by every seedRandomGenerators, each thread reseeds once it sees a new one
+	std::atomic<uint32_t> seedGeneration = 0;
+}
+
+RandomGenerator &getRandomGenerator() {
+	thread_local RandomGenerator generator((static_cast<uint64_t>(std::random_device {}()) << 32) | std::random_device {}());
+	thread_local uint32_t generation = 0;
+	if (const auto current = seedGeneration.load(std::memory_order_acquire); current != generation) [[unlikely]] {
+		generation = current;
+		generator.seed(sharedSeed.load(std::memory_order_relaxed));
+	}
 	return generator;
 }
 
+void seedRandomGenerators(uint64_t seed) {
+	sharedSeed.store(seed, std::memory_order_relaxed);
+	seedGeneration.fetch_add(1, std::memory_order_release);
+}
+
 int32_t uniform_random(int32_t minNumber, int32_t maxNumber) {
-	static std::uniform_int_distribution<int32_t> uniformRand;
 	if (minNumber == maxNumber) {
 		return minNumber;
 	} else if (minNumber > maxNumber) {
 		std::swap(minNumber, maxNumber);
 	}
-	return uniformRand(getRandomGenerator(), std::uniform_int_distribution<int32_t>::param_type(minNumber, maxNumber));
+	return getRandomGenerator().uniform(minNumber, maxNumber);
 }
 
 int32_t normal_random(int32_t minNumber, int32_t maxNumber) {
-	static std::normal_distribution<float> normalRand(0.5f, 0.25f);
+	thread_local std::normal_distribution<float> normalRand(0.5f, 0.25f);
 	if (minNumber == maxNumber) {
 		return minNumber;
 	} else if (minNumber > maxNumber) {
@@ -418,8 +444,7 @@ int32_t normal_random(int32_t minNumber, int32_t maxNumber) {
 }
 
 bool boolean_random(double probability /* = 0.5*/) {
-	static std::bernoulli_distribution booleanRand;
-	return booleanRand(getRandomGenerator(), std::bernoulli_distribution::param_type(probability));
+	return getRandomGenerator().uniformReal() < probability;
 }
 
 void trimString(std::string &str) {
@@ -993,29 +1018,145 @@ std::string getSkillName(uint8_t skillid) {
 	}
 }
 
-uint32_t adlerChecksum(const uint8_t* data, size_t length) {
-	if (length > NETWORKMESSAGE_MAXSIZE) {
-		return 0;
-	}
+namespace {
+	constexpr uint32_t ADLER_MODULO = 65521;
+	// Most bytes summed before b can overflow 32 bits
+	constexpr size_t ADLER_MAX_RUN = 5552;
+	constexpr size_t ADLER_VECTOR_BLOCK = 32;
 
-	const uint16_t adler = 65521;
+	using AdlerKernel = uint32_t (*)(uint32_t adler, const uint8_t* data, size_t length);
 
-	uint32_t a = 1, b = 0;
+	uint32_t adlerScalar(uint32_t adler, const uint8_t* data, size_t length) {
+		uint32_t a = adler & 0xFFFF, b = adler >> 16;
+		while (length > 0) {
+			size_t run = std::min(length, ADLER_MAX_RUN);
+			length -= run;
 
-	while (length > 0) {
-		size_t tmp = length > 5552 ? 5552 : length;
-		length -= tmp;
+			do {
+				a += *data++;
+				b += a;
+			} while (--run);
 
-		do {
-			a += *data++;
-			b += a;
-		} while (--tmp);
+			a %= ADLER_MODULO;
+			b %= ADLER_MODULO;
+		}
+		return (b << 16) | a;
+	}
+
+#if defined(CANARY_SIMD_X86_64)
+	__m128i sumLanes(__m128i v) {
+		v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+	}
+
+	/**
+	 * 32 bytes per step: a takes their sum, b their sum weighted by the
+	 * distance to the end of the step (maddubs against 32..1), plus 32 times
+	 * the a of before the step, accumulated in previousA and shifted at the
+	 * end of each run.
+	 */
+	CANARY_TARGET("ssse3") uint32_t adlerSsse3(uint32_t adler, const uint8_t* data, size_t length) {
+		uint32_t a = adler & 0xFFFF, b = adler >> 16;
+		size_t steps = length / ADLER_VECTOR_BLOCK;
+		length -= steps * ADLER_VECTOR_BLOCK;
+
+		const __m128i firstWeights = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+		const __m128i secondWeights = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i ones = _mm_set1_epi16(1);
+		while (steps > 0) {
+			size_t run = std::min(steps, ADLER_MAX_RUN / ADLER_VECTOR_BLOCK);
+			steps -= run;
+
+			__m128i previousA = _mm_set_epi32(0, 0, 0, static_cast<int32_t>(a * run));
+			__m128i vectorB = _mm_set_epi32(0, 0, 0, static_cast<int32_t>(b));
+			__m128i vectorA = zero;
+			do {
+				const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+				const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16));
+				previousA = _mm_add_epi32(previousA, vectorA);
+				vectorA = _mm_add_epi32(vectorA, _mm_add_epi32(_mm_sad_epu8(first, zero), _mm_sad_epu8(second, zero)));
+				vectorB = _mm_add_epi32(vectorB, _mm_madd_epi16(_mm_maddubs_epi16(first, firstWeights), ones));
+				vectorB = _mm_add_epi32(vectorB, _mm_madd_epi16(_mm_maddubs_epi16(second, secondWeights), ones));
+				data += ADLER_VECTOR_BLOCK;
+			} while (--run);
+
+			vectorB = _mm_add_epi32(vectorB, _mm_slli_epi32(previousA, 5));
+			a = (a + static_cast<uint32_t>(_mm_cvtsi128_si32(sumLanes(vectorA)))) % ADLER_MODULO;
+			b = static_cast<uint32_t>(_mm_cvtsi128_si32(sumLanes(vectorB))) % ADLER_MODULO;
+		}
+		return adlerScalar((b << 16) | a, data, length);
+	}
+
+	CANARY_TARGET("avx2") uint32_t sumLanes(__m256i v) {
+		return static_cast<uint32_t>(_mm_cvtsi128_si32(sumLanes(_mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)))));
+	}
+
+	// adlerSsse3 with the 32 bytes of a step in one register
+	CANARY_TARGET("avx2") uint32_t adlerAvx2(uint32_t adler, const uint8_t* data, size_t length) {
+		uint32_t a = adler & 0xFFFF, b = adler >> 16;
+		size_t steps = length / ADLER_VECTOR_BLOCK;
+		length -= steps * ADLER_VECTOR_BLOCK;
+
+		const __m256i weights = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i ones = _mm256_set1_epi16(1);
+		while (steps > 0) {
+			size_t run = std::min(steps, ADLER_MAX_RUN / ADLER_VECTOR_BLOCK);
+			steps -= run;
+
+			__m256i previousA = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, static_cast<int32_t>(a * run));
+			__m256i vectorB = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, static_cast<int32_t>(b));
+			__m256i vectorA = zero;
+			do {
+				const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+				previousA = _mm256_add_epi32(previousA, vectorA);
+				vectorA = _mm256_add_epi32(vectorA, _mm256_sad_epu8(bytes, zero));
+				vectorB = _mm256_add_epi32(vectorB, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, weights), ones));
+				data += ADLER_VECTOR_BLOCK;
+			} while (--run);
+
+			vectorB = _mm256_add_epi32(vectorB, _mm256_slli_epi32(previousA, 5));
+			a = (a + sumLanes(vectorA)) % ADLER_MODULO;
+			b = sumLanes(vectorB) % ADLER_MODULO;
+		}
+		return adlerScalar((b << 16) | a, data, length);
+	}
+#endif
 
-		a %= adler;
-		b %= adler;
+	AdlerKernel selectAdlerKernel() {
+#if defined(CANARY_SIMD_X86_64)
+		if (getCpuFeatures().avx2) {
+			return adlerAvx2;
+		}
+		if (getCpuFeatures().ssse3) {
+			return adlerSsse3;
+		}
+#endif
+		return adlerScalar;
 	}
+}
 
-	return (b << 16) | a;
+void AdlerChecksum::update(const uint8_t* data, size_t length) {
+	static const AdlerKernel kernel = selectAdlerKernel();
+	adler = kernel(adler, data, length);
+}
+
+uint32_t adlerChecksum(const uint8_t* data, size_t length) {
+	if (length > NETWORKMESSAGE_MAXSIZE) {
+		return 0;
+	}
+
+	AdlerChecksum checksum;
+	checksum.update(data, length);
+	return checksum.value();
+}
+
+uint32_t adlerChecksumScalar(const uint8_t* data, size_t length) {
+	if (length > NETWORKMESSAGE_MAXSIZE) {
+		return 0;
+	}
+	return adlerScalar(1, data, length);
 }
 
 std::string ucfirst(std::string str) {
@@ -1451,8 +1592,63 @@ const char* getReturnMessage(ReturnValue value) {
 	}
 }
 
+namespace {
+	// 0 outside the game thread
+	constinit thread_local int64_t gameTime = 0;
+}
+
+int64_t getPreciseTimeMs() {
+	// Function statics, OTSYS_TIME is called from static initializers of other files
+	static const auto systemStart = std::chrono::system_clock::now().time_since_epoch();
+	static const auto steadyStart = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::milliseconds>(systemStart + (std::chrono::steady_clock::now() - steadyStart)).count();
+}
+
 int64_t OTSYS_TIME() {
-	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	return gameTime != 0 ? gameTime : getPreciseTimeMs();
+}
+
+void refreshGameTime() {
+	gameTime = getPreciseTimeMs();
+}
+
+int64_t getProcessCpuTimeMs() {
+#ifdef _WIN32
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+	if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+		return 0;
+	}
+	// In 100 ns units
+	const auto toTicks = [](const FILETIME &time) {
+		return (static_cast<int64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+	};
+	return (toTicks(kernelTime) + toTicks(userTime)) / 10000;
+#else
+	rusage usage {};
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+	return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000 + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+#endif
+}
+
+int64_t getProcessResidentBytes() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters {};
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return 0;
+	}
+	return static_cast<int64_t>(counters.WorkingSetSize);
+#else
+	// The second field of statm is the resident size in pages
+	std::ifstream statm("/proc/self/statm");
+	int64_t size = 0;
+	int64_t resident = 0;
+	if (!(statm >> size >> resident)) {
+		return 0;
+	}
+	return resident * sysconf(_SC_PAGESIZE);
+#endif
 }
 
 SpellGroup_t stringToSpellGroup(const std::string &value) {
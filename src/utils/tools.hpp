@@ -13,12 +13,12 @@
 #include "declarations.hpp"
 #include "enums/item_attribute.hpp"
 #include "game/movement/position.hpp"
+#include "utils/random_generator.hpp"
 
 void printXMLError(const std::string &where, const std::string &fileName, const pugi::xml_parse_result &result);
 
 std::string transformToSHA1(const std::string &input);
 
-uint16_t getStashSize(StashItemList itemList);
 
 std::string generateToken(const std::string &secret, uint32_t ticks);
 
@@ -29,6 +29,51 @@ void toLowerCaseString(std::string &source);
 std::string asLowerCaseString(std::string source);
 std::string asUpperCaseString(std::string source);
 
+// ASCII only, as tolower in the C locale the server runs in
+constexpr char asLowerCaseChar(char ch) {
+	return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch | 0x20) : ch;
+}
+
+constexpr bool caseInsensitiveEquals(std::string_view lhs, std::string_view rhs) {
+	return lhs.size() == rhs.size() && std::ranges::equal(lhs, rhs, {}, asLowerCaseChar, asLowerCaseChar);
+}
+
+/**
+ * Hash, equality and ordering of names regardless of case. They are
+ * transparent, so the containers keyed with them are looked up with the
+ * name as it was typed, without a lowercase copy of it.
+ */
+struct CaseInsensitiveHash {
+	using is_transparent = void;
+
+	size_t operator()(std::string_view str) const noexcept {
+		// FNV-1a over the lowercase bytes
+		uint64_t hash = 14695981039346656037ULL;
+		for (char ch : str) {
+			hash = (hash ^ static_cast<uint8_t>(asLowerCaseChar(ch))) * 1099511628211ULL;
+		}
+		return static_cast<size_t>(hash);
+	}
+};
+
+struct CaseInsensitiveEqual {
+	using is_transparent = void;
+
+	bool operator()(std::string_view lhs, std::string_view rhs) const noexcept {
+		return caseInsensitiveEquals(lhs, rhs);
+	}
+};
+
+struct CaseInsensitiveLess {
+	using is_transparent = void;
+
+	bool operator()(std::string_view lhs, std::string_view rhs) const noexcept {
+		// Unsigned, as std::string orders its bytes
+		constexpr auto lowerByte = [](char ch) { return static_cast<uint8_t>(asLowerCaseChar(ch)); };
+		return std::ranges::lexicographical_compare(lhs, rhs, {}, lowerByte, lowerByte);
+	}
+};
+
 std::string toCamelCase(const std::string &str);
 std::string toPascalCase(const std::string &str);
 std::string toSnakeCase(const std::string &str);
@@ -44,7 +89,10 @@ constexpr bool hasBitSet(uint32_t flag, uint32_t flags) {
 	return (flags & flag) != 0;
 }
 
-std::mt19937 &getRandomGenerator();
+// The generator of this thread
+RandomGenerator &getRandomGenerator();
+// Reseeds the generator of every thread with the seed, before its next roll, to replay or benchmark a run deterministically
+void seedRandomGenerators(uint64_t seed);
 int32_t uniform_random(int32_t minNumber, int32_t maxNumber);
 int32_t normal_random(int32_t minNumber, int32_t maxNumber);
 bool boolean_random(double probability = 0.5);
@@ -89,7 +137,30 @@ SpawnType_t getSpawnType(const std::string &strValue);
 
 std::string getSkillName(uint8_t skillid);
 
+/**
+ * Adler-32 fed in pieces, so a packet can be summed while each part of it
+ * is still in cache. Vectorized with the widest extension of the host
+ * (utils/cpu_features.hpp).
+ */
+class AdlerChecksum {
+public:
+	void update(const uint8_t* data, size_t length);
+	void update(std::span<const uint8_t> data) {
+		update(data.data(), data.size());
+	}
+
+	uint32_t value() const {
+		return adler;
+	}
+
+private:
+	uint32_t adler = 1;
+};
+
+// The checksum of the whole buffer at once, 0 above NETWORKMESSAGE_MAXSIZE
 uint32_t adlerChecksum(const uint8_t* data, size_t len);
+// One byte at a time, the reference for the vectorized path
+uint32_t adlerChecksumScalar(const uint8_t* data, size_t len);
 
 std::string ucfirst(std::string str);
 std::string ucwords(std::string str);
@@ -131,7 +202,21 @@ bool isCaskItem(uint16_t itemId);
 
 std::string getObjectCategoryName(ObjectCategory_t category);
 
+/**
+ * Milliseconds since the epoch, counted by the monotonic clock from the
+ * time the server started, so adjusting the system clock does not make
+ * timers jump. On the game thread it is the time the running task started
+ * and does not move while the task runs, the other threads read the clock.
+ */
 int64_t OTSYS_TIME();
+// Same clock as OTSYS_TIME, read now, to measure how long something running on the game thread takes
+int64_t getPreciseTimeMs();
+// Called by the dispatcher before each task it runs
+void refreshGameTime();
+// User and system time the process used so far
+int64_t getProcessCpuTimeMs();
+// Resident set size of the process in bytes, 0 when it can not be read
+int64_t getProcessResidentBytes();
 
 SpellGroup_t stringToSpellGroup(const std::string &value);
 
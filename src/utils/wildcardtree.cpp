@@ -10,101 +10,107 @@
 #include "pch.hpp"
 
 #include "utils/wildcardtree.hpp"
+#include "utils/tools.hpp"
 
-WildcardTreeNode* WildcardTreeNode::getChild(char ch) {
-	auto it = children.find(ch);
-	if (it == children.end()) {
-		return nullptr;
+uint32_t WildcardTree::getChild(uint32_t node, char ch) const {
+	const auto &children = nodes[node].children;
+	auto it = std::ranges::lower_bound(children, ch, {}, &std::pair<char, uint32_t>::first);
+	if (it == children.end() || it->first != ch) {
+		return NO_NODE;
 	}
-	return &it->second;
+	return it->second;
 }
 
-const WildcardTreeNode* WildcardTreeNode::getChild(char ch) const {
-	auto it = children.find(ch);
-	if (it == children.end()) {
-		return nullptr;
+uint32_t WildcardTree::addChild(uint32_t node, char ch) {
+	auto &children = nodes[node].children;
+	auto it = std::ranges::lower_bound(children, ch, {}, &std::pair<char, uint32_t>::first);
+	if (it != children.end() && it->first == ch) {
+		return it->second;
 	}
-	return &it->second;
-}
 
-WildcardTreeNode* WildcardTreeNode::addChild(char ch, bool breakp) {
-	WildcardTreeNode* child = getChild(ch);
-	if (child) {
-		if (breakp && !child->breakpoint) {
-			child->breakpoint = true;
-		}
+	const auto index = it - children.begin();
+	uint32_t child;
+	if (!freeNodes.empty()) {
+		child = freeNodes.back();
+		freeNodes.pop_back();
 	} else {
-		auto pair = children.emplace(std::piecewise_construct, std::forward_as_tuple(ch), std::forward_as_tuple(breakp));
-		child = &pair.first->second;
+		child = static_cast<uint32_t>(nodes.size());
+		nodes.emplace_back();
 	}
+
+	// Growing the nodes may have moved the children of this one
+	auto &nodeChildren = nodes[node].children;
+	nodeChildren.emplace(nodeChildren.begin() + index, ch, child);
 	return child;
 }
 
-void WildcardTreeNode::insert(const std::string &str) {
-	WildcardTreeNode* cur = this;
-
-	size_t length = str.length() - 1;
-	for (size_t pos = 0; pos < length; ++pos) {
-		cur = cur->addChild(str[pos], false);
+void WildcardTree::insert(std::string_view str) {
+	if (str.empty()) {
+		return;
 	}
 
-	cur->addChild(str[length], true);
+	uint32_t node = 0;
+	for (char ch : str) {
+		node = addChild(node, asLowerCaseChar(ch));
+	}
+	nodes[node].breakpoint = true;
 }
 
-void WildcardTreeNode::remove(const std::string &str) {
-	WildcardTreeNode* cur = this;
+void WildcardTree::remove(std::string_view str) {
+	std::vector<uint32_t> path;
+	path.reserve(str.length() + 1);
 
-	std::stack<WildcardTreeNode*> path;
-	path.push(cur);
-	size_t len = str.length();
-	for (size_t pos = 0; pos < len; ++pos) {
-		cur = cur->getChild(str[pos]);
-		if (!cur) {
+	uint32_t node = 0;
+	path.push_back(node);
+	for (char ch : str) {
+		node = getChild(node, asLowerCaseChar(ch));
+		if (node == NO_NODE) {
 			return;
 		}
-		path.push(cur);
+		path.push_back(node);
 	}
 
-	cur->breakpoint = false;
-
-	do {
-		cur = path.top();
-		path.pop();
+	nodes[node].breakpoint = false;
 
-		if (!cur->children.empty() || cur->breakpoint || path.empty()) {
+	// Drops the nodes no other name goes through, from the end of the name up
+	for (size_t depth = path.size() - 1; depth > 0; --depth) {
+		auto &current = nodes[path[depth]];
+		if (!current.children.empty() || current.breakpoint) {
 			break;
 		}
 
-		cur = path.top();
-
-		auto it = cur->children.find(str[--len]);
-		if (it != cur->children.end()) {
-			cur->children.erase(it);
-		}
-	} while (true);
+		auto &parentChildren = nodes[path[depth - 1]].children;
+		std::erase_if(parentChildren, [child = path[depth]](const auto &entry) {
+			return entry.second == child;
+		});
+		freeNodes.push_back(path[depth]);
+	}
 }
 
-ReturnValue WildcardTreeNode::findOne(const std::string &query, std::string &result) const {
-	const WildcardTreeNode* cur = this;
-	for (char pos : query) {
-		cur = cur->getChild(pos);
-		if (!cur) {
+ReturnValue WildcardTree::findOne(std::string_view query, std::string &result) const {
+	result.clear();
+	result.reserve(query.length());
+
+	uint32_t node = 0;
+	for (char ch : query) {
+		const char lower = asLowerCaseChar(ch);
+		node = getChild(node, lower);
+		if (node == NO_NODE) {
 			return RETURNVALUE_PLAYERWITHTHISNAMEISNOTONLINE;
 		}
+		result += lower;
 	}
 
-	result = query;
-
 	do {
-		size_t size = cur->children.size();
+		const auto &current = nodes[node];
+		size_t size = current.children.size();
 		if (size == 0) {
 			return RETURNVALUE_NOERROR;
-		} else if (size > 1 || cur->breakpoint) {
+		} else if (size > 1 || current.breakpoint) {
 			return RETURNVALUE_NAMEISTOOAMBIGUOUS;
 		}
 
-		auto it = cur->children.begin();
-		result += it->first;
-		cur = &it->second;
+		result += current.children.front().first;
+		node = current.children.front().second;
 	} while (true);
 }
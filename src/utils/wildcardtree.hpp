@@ -11,26 +11,35 @@
 
 #include "declarations.hpp"
 
-class WildcardTreeNode {
+// Case insensitive trie of the names online, for the "name~" completion
+class WildcardTree {
 public:
-	explicit WildcardTreeNode(bool initBreakpoint) :
-		breakpoint(initBreakpoint) { }
-	WildcardTreeNode(WildcardTreeNode &&other) = default;
+	WildcardTree() :
+		nodes(1) { }
 
 	// non-copyable
-	WildcardTreeNode(const WildcardTreeNode &) = delete;
-	WildcardTreeNode &operator=(const WildcardTreeNode &) = delete;
+	WildcardTree(const WildcardTree &) = delete;
+	WildcardTree &operator=(const WildcardTree &) = delete;
 
-	WildcardTreeNode* getChild(char ch);
-	const WildcardTreeNode* getChild(char ch) const;
-	WildcardTreeNode* addChild(char ch, bool breakpoint);
+	void insert(std::string_view str);
+	void remove(std::string_view str);
 
-	void insert(const std::string &str);
-	void remove(const std::string &str);
-
-	ReturnValue findOne(const std::string &query, std::string &result) const;
+	// The only name starting with query, in lower case
+	ReturnValue findOne(std::string_view query, std::string &result) const;
 
 private:
-	std::map<char, WildcardTreeNode> children;
-	bool breakpoint;
+	// Node 0 is the root, it is never anyone's child
+	static constexpr uint32_t NO_NODE = 0;
+
+	struct Node {
+		// Sorted by character
+		std::vector<std::pair<char, uint32_t>> children;
+		bool breakpoint = false;
+	};
+
+	uint32_t getChild(uint32_t node, char ch) const;
+	uint32_t addChild(uint32_t node, char ch);
+
+	std::vector<Node> nodes;
+	std::vector<uint32_t> freeNodes;
 };
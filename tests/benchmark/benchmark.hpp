@@ -0,0 +1,31 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include <nanobench.h>
+
+/**
+ * Benchmarks register themselves like the boost::ut suites, one group per
+ * file or area. main runs the groups matching its filter, each in its own
+ * ankerl::nanobench::Bench, so their results are compared within a group.
+ */
+class BenchmarkGroup {
+public:
+	using Function = void (*)(ankerl::nanobench::Bench &bench);
+
+	BenchmarkGroup(std::string_view name, Function function) {
+		getGroups().emplace_back(name, function);
+	}
+
+	static std::vector<std::pair<std::string_view, Function>> &getGroups() {
+		static std::vector<std::pair<std::string_view, Function>> groups;
+		return groups;
+	}
+};
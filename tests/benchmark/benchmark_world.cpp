@@ -0,0 +1,57 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "benchmark.hpp"
+#include "benchmark_world.hpp"
+#include "game/game.hpp"
+#include "items/tile.hpp"
+
+void BenchmarkWorld::setup() {
+	static bool ready = false;
+	if (ready) {
+		return;
+	}
+	ready = true;
+
+	if (g_game().loadAppearanceProtobuf(std::string(CANARY_DATA_DIRECTORY) + "/items/appearances.dat") != ERROR_NONE) {
+		throw std::runtime_error("appearances.dat could not be loaded");
+	}
+
+	pugi::xml_document itemsDocument;
+	if (!itemsDocument.load_file((std::string(CANARY_DATA_DIRECTORY) + "/items/items.xml").c_str()) || !Item::items.loadFromXml(itemsDocument)) {
+		throw std::runtime_error("items.xml could not be loaded");
+	}
+
+	for (uint16_t x = WORLD_ORIGIN; x < WORLD_ORIGIN + WORLD_SIZE; ++x) {
+		for (uint16_t y = WORLD_ORIGIN; y < WORLD_ORIGIN + WORLD_SIZE; ++y) {
+			g_game().map.setTile(x, y, WORLD_FLOOR, std::make_shared<DynamicTile>(x, y, WORLD_FLOOR));
+		}
+	}
+}
+
+uint16_t BenchmarkWorld::getDecayingItemId() {
+	for (size_t id = 100; id < Item::items.size(); ++id) {
+		const auto &itemType = Item::items[id];
+		if (itemType.decayTo >= 0 && itemType.decayTime > 0 && !itemType.stackable) {
+			return static_cast<uint16_t>(id);
+		}
+	}
+	return 0;
+}
+
+Position BenchmarkWorld::getRandomPosition(ankerl::nanobench::Rng &rng, uint16_t margin /* = 0 */) {
+	const auto span = static_cast<uint32_t>(WORLD_SIZE - 2 * margin);
+	return Position(
+		static_cast<uint16_t>(WORLD_ORIGIN + margin + rng.bounded(span)),
+		static_cast<uint16_t>(WORLD_ORIGIN + margin + rng.bounded(span)),
+		WORLD_FLOOR
+	);
+}
@@ -0,0 +1,32 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class Tile;
+
+/**
+ * Synthetic world the map benchmarks run on: a WORLD_SIZE square of empty
+ * walkable tiles on floor 7 of g_game().map, starting at WORLD_ORIGIN, and
+ * the item types of the repository datapack. Built once, on first use.
+ */
+class BenchmarkWorld {
+public:
+	static constexpr uint16_t WORLD_ORIGIN = 1000;
+	static constexpr uint16_t WORLD_SIZE = 256;
+	static constexpr uint8_t WORLD_FLOOR = 7;
+
+	static void setup();
+
+	// Any item type that decays, 0 when the datapack has none
+	static uint16_t getDecayingItemId();
+
+	// Same sequence on every run, so runs stay comparable
+	static Position getRandomPosition(ankerl::nanobench::Rng &rng, uint16_t margin = 0);
+};
@@ -0,0 +1,65 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "benchmark.hpp"
+#include "benchmark_world.hpp"
+#include "game/game.hpp"
+#include "items/decay/decay.hpp"
+#include "items/functions/item/attribute.hpp"
+#include "items/tile.hpp"
+
+namespace {
+	void benchItems(ankerl::nanobench::Bench &bench) {
+		ItemAttribute attributes;
+		int64_t value = 0;
+		bench.run("ItemAttribute set and get integers", [&] {
+			attributes.setAttribute(ItemAttribute_t::DURATION, ++value);
+			attributes.setAttribute(ItemAttribute_t::CHARGES, value);
+			attributes.setAttribute(ItemAttribute_t::DATE, value);
+			ankerl::nanobench::doNotOptimizeAway(attributes.getAttributeValue(ItemAttribute_t::DURATION) + attributes.getAttributeValue(ItemAttribute_t::CHARGES));
+		});
+
+		bench.run("ItemAttribute set and get strings", [&] {
+			attributes.setAttribute(ItemAttribute_t::DESCRIPTION, std::string_view("A benchmark item description."));
+			attributes.setAttribute(ItemAttribute_t::WRITER, std::string_view("Benchmark"));
+			ankerl::nanobench::doNotOptimizeAway(attributes.getAttributeString(ItemAttribute_t::DESCRIPTION));
+		});
+
+		BenchmarkWorld::setup();
+		const auto itemId = BenchmarkWorld::getDecayingItemId();
+		if (itemId == 0) {
+			return;
+		}
+
+		// Decay only runs for items on the map
+		const auto tile = g_game().map.getTile(BenchmarkWorld::WORLD_ORIGIN, BenchmarkWorld::WORLD_ORIGIN, BenchmarkWorld::WORLD_FLOOR);
+		std::vector<std::shared_ptr<Item>> items;
+		for (size_t i = 0; i < 1024; ++i) {
+			auto item = Item::CreateItem(itemId);
+			tile->internalAddThing(item);
+			items.emplace_back(std::move(item));
+		}
+
+		bench.batch(items.size()).unit("item");
+		bench.run("Decay startDecay and stopDecay", [&] {
+			for (const auto &item : items) {
+				item->setDuration(60 * 1000);
+				g_decay().startDecay(item);
+			}
+			for (const auto &item : items) {
+				g_decay().stopDecay(item);
+			}
+		});
+		bench.batch(1).unit("op");
+	}
+}
+
+BenchmarkGroup itemsBenchmarks("items", benchItems);
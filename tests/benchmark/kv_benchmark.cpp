@@ -0,0 +1,36 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "benchmark.hpp"
+#include "kv/in_memory_kv.hpp"
+#include "lib/logging/in_memory_logger.hpp"
+
+namespace {
+	void benchKV(ankerl::nanobench::Bench &bench) {
+		InMemoryLogger logger;
+		KVMemory kv(logger);
+		std::vector<std::string> keys;
+		for (size_t i = 0; i < 4096; ++i) {
+			keys.emplace_back(fmt::format("player.{}.storage.{}", i % 64, i));
+			kv.set(keys.back(), static_cast<int>(i));
+		}
+
+		ankerl::nanobench::Rng rng(7);
+		bench.run("KVStore::set integer", [&] {
+			kv.set(keys[rng.bounded(static_cast<uint32_t>(keys.size()))], static_cast<int>(rng.bounded(1000)));
+		});
+		bench.run("KVStore::get integer", [&] {
+			ankerl::nanobench::doNotOptimizeAway(kv.get<int>(keys[rng.bounded(static_cast<uint32_t>(keys.size()))]));
+		});
+	}
+}
+
+BenchmarkGroup kvBenchmarks("kv", benchKV);
@@ -0,0 +1,57 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "benchmark.hpp"
+#include "utils/tools.hpp"
+
+/**
+ * canary_bench [filter] [--json file] [--seed number]
+ * Runs every group whose name contains the filter, the results can also be
+ * written as JSON to compare runs in CI. The random generators are seeded
+ * with the seed, 0 by default, so two runs roll the same.
+ */
+int main(int argc, char* argv[]) {
+	std::string_view filter;
+	std::string jsonFile;
+	uint64_t seed = 0;
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view argument(argv[i]);
+		if (argument == "--json" && i + 1 < argc) {
+			jsonFile = argv[++i];
+		} else if (argument == "--seed" && i + 1 < argc) {
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		} else {
+			filter = argument;
+		}
+	}
+
+	seedRandomGenerators(seed);
+
+	std::ofstream json;
+	if (!jsonFile.empty()) {
+		json.open(jsonFile, std::ios::trunc);
+	}
+
+	for (const auto &[name, function] : BenchmarkGroup::getGroups()) {
+		if (name.find(filter) == std::string_view::npos) {
+			continue;
+		}
+
+		ankerl::nanobench::Bench bench;
+		bench.title(std::string(name)).warmup(100).minEpochIterations(1000).relative(false);
+		function(bench);
+
+		if (json.is_open()) {
+			bench.render(ankerl::nanobench::templates::json(), json);
+		}
+	}
+	return 0;
+}
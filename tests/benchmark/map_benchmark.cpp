@@ -0,0 +1,86 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "benchmark.hpp"
+#include "benchmark_world.hpp"
+#include "creatures/combat/combat.hpp"
+#include "game/game.hpp"
+#include "map/utils/astarnodes.hpp"
+
+namespace {
+	void benchMap(ankerl::nanobench::Bench &bench) {
+		BenchmarkWorld::setup();
+		auto &map = g_game().map;
+		ankerl::nanobench::Rng rng(7);
+
+		bench.run("Map::getTile", [&] {
+			ankerl::nanobench::doNotOptimizeAway(map.getTile(BenchmarkWorld::getRandomPosition(rng)));
+		});
+
+		const Position center(BenchmarkWorld::WORLD_ORIGIN + 128, BenchmarkWorld::WORLD_ORIGIN + 128, BenchmarkWorld::WORLD_FLOOR);
+		bench.run("Map::getSpectators multifloor, cached", [&] {
+			SpectatorHashSet spectators;
+			map.getSpectators(spectators, center, true);
+			ankerl::nanobench::doNotOptimizeAway(spectators);
+		});
+
+		bench.run("Map::getSpectators multifloor, uncached", [&] {
+			map.clearSpectatorCache();
+			SpectatorHashSet spectators;
+			map.getSpectators(spectators, BenchmarkWorld::getRandomPosition(rng, 16), true);
+			ankerl::nanobench::doNotOptimizeAway(spectators);
+		});
+
+		// Same shape as the move event and action lookups by position, done on every step
+		phmap::flat_hash_map<Position, uint32_t> positionMap;
+		for (uint32_t i = 0; i < 4096; ++i) {
+			positionMap.emplace(BenchmarkWorld::getRandomPosition(rng), i);
+		}
+		bench.run("flat_hash_map<Position> find, 4096 positions", [&] {
+			ankerl::nanobench::doNotOptimizeAway(positionMap.find(BenchmarkWorld::getRandomPosition(rng)));
+		});
+
+		bench.run("Map::getPathMatching 20 sqm", [&] {
+			const auto start = BenchmarkWorld::getRandomPosition(rng, 32);
+			const Position target(start.x + 20, start.y + 5, start.z);
+			FindPathParams fpp;
+			fpp.maxSearchDist = 30;
+			fpp.minTargetDist = 0;
+			fpp.maxTargetDist = 1;
+			std::forward_list<Direction> dirList;
+			ankerl::nanobench::doNotOptimizeAway(map.getPathMatching(start, dirList, FrozenPathingConditionCall(target), fpp));
+		});
+
+		bench.run("AStarNodes open and close 256 nodes", [&] {
+			auto &nodes = AStarNodes::getThreadInstance(100, 100);
+			auto parent = nodes.getBestNode();
+			nodes.closeNode(parent);
+			for (uint32_t i = 0; i < 256; ++i) {
+				nodes.createOpenNode(parent, 100 + i % 16, 101 + i / 16, static_cast<int_fast32_t>(rng.bounded(1000)));
+			}
+			while (auto node = nodes.getBestNode()) {
+				nodes.closeNode(node);
+			}
+		});
+
+		AreaCombat area;
+		area.setupArea(3);
+		std::vector<std::shared_ptr<Tile>> tiles;
+		bench.run("AreaCombat::getList radius 3", [&] {
+			tiles.clear();
+			const auto pos = BenchmarkWorld::getRandomPosition(rng, 16);
+			area.getList(pos, pos, tiles);
+			ankerl::nanobench::doNotOptimizeAway(tiles);
+		});
+	}
+}
+
+BenchmarkGroup mapBenchmarks("map", benchMap);
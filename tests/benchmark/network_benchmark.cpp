@@ -0,0 +1,52 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "benchmark.hpp"
+#include "security/xtea.hpp"
+#include "server/network/message/networkmessage.hpp"
+
+namespace {
+	void benchNetwork(ankerl::nanobench::Bench &bench) {
+		static constexpr XTEA::Key key = { 0x01234567, 0x89ABCDEF, 0xFEDCBA98, 0x76543210 };
+		std::vector<uint8_t> data(4096);
+		for (size_t i = 0; i < data.size(); ++i) {
+			data[i] = static_cast<uint8_t>(i * 131 + 7);
+		}
+
+		bench.batch(data.size()).unit("byte");
+		bench.run("XTEA::encrypt 4 KB", [&] {
+			XTEA::encrypt(data.data(), data.size(), key);
+			ankerl::nanobench::doNotOptimizeAway(data);
+		});
+		bench.run("XTEA::decrypt 4 KB", [&] {
+			XTEA::decrypt(data.data(), data.size(), key);
+			ankerl::nanobench::doNotOptimizeAway(data);
+		});
+
+		// Sizes of the usual names and texts of the game protocol
+		const std::array<std::string, 4> strings = { "Rat", "Dragon Lord", std::string(64, 'a'), std::string(255, 'b') };
+		NetworkMessage msg;
+		bench.batch(32).unit("string");
+		bench.run("NetworkMessage addString and getString", [&] {
+			msg.reset();
+			for (size_t i = 0; i < 32; ++i) {
+				msg.addString(strings[i % strings.size()]);
+			}
+			msg.setBufferPosition(NetworkMessage::INITIAL_BUFFER_POSITION);
+			for (size_t i = 0; i < 32; ++i) {
+				ankerl::nanobench::doNotOptimizeAway(msg.getString());
+			}
+		});
+		bench.batch(1).unit("op");
+	}
+}
+
+BenchmarkGroup networkBenchmarks("network", benchNetwork);
@@ -0,0 +1,34 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "benchmark.hpp"
+#include "game/scheduling/scheduler.hpp"
+
+namespace {
+	void benchScheduling(ankerl::nanobench::Bench &bench) {
+		ankerl::nanobench::Rng rng(7);
+		std::vector<uint64_t> eventIds(256);
+
+		// The thread pool is not started, so no event ever fires while measured
+		bench.batch(eventIds.size()).unit("event");
+		bench.run("Scheduler addEvent and stopEvent", [&] {
+			for (auto &eventId : eventIds) {
+				eventId = g_scheduler().addEvent(1000 + rng.bounded(60 * 1000), [] { }, "Game::checkCreatures");
+			}
+			for (const auto eventId : eventIds) {
+				g_scheduler().stopEvent(eventId);
+			}
+		});
+		bench.batch(1).unit("op");
+	}
+}
+
+BenchmarkGroup schedulingBenchmarks("scheduling", benchScheduling);
@@ -0,0 +1,501 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "load_bot.hpp"
+#include "core.hpp"
+#include "creatures/creatures_definitions.hpp"
+#include "security/rsa.hpp"
+#include "utils/tools.hpp"
+#include "utils/utils_definitions.hpp"
+
+namespace {
+	constexpr uint8_t LOGIN_PROTOCOL_IDENTIFIER = 0x01;
+	constexpr uint8_t GAME_PROTOCOL_IDENTIFIER = 0x0A;
+	constexpr uint16_t OLD_PROTOCOL_VERSION = 1100;
+	constexpr uint32_t SEQUENCE_COMPRESSED_FLAG = 1U << 31;
+
+	// Server messages are deflated on their own, so one stream per io thread inflates them all
+	struct Inflater {
+		Inflater() {
+			inflateInit2(&stream, -15);
+		}
+		~Inflater() {
+			inflateEnd(&stream);
+		}
+
+		// Ensures that we don't accidentally copy it
+		Inflater(const Inflater &) = delete;
+		Inflater operator=(const Inflater &) = delete;
+
+		z_stream stream {};
+		NetworkMessage output;
+	};
+}
+
+void LoadTestStats::addError(std::string_view error) {
+	std::scoped_lock lock(errorsMutex);
+	auto it = errors.find(error);
+	if (it == errors.end()) {
+		it = errors.emplace(error, 0).first;
+	}
+	++it->second;
+}
+
+std::vector<std::pair<std::string, uint32_t>> LoadTestStats::getErrors() const {
+	std::scoped_lock lock(errorsMutex);
+	std::vector<std::pair<std::string, uint32_t>> sorted(errors.begin(), errors.end());
+	std::ranges::sort(sorted, [](const auto &lhs, const auto &rhs) {
+		return lhs.second > rhs.second;
+	});
+	return sorted;
+}
+
+LoadBot::LoadBot(asio::io_context &ioContext, const LoadTestOptions &options, LoadTestStats &stats, uint32_t number) :
+	ioContext(ioContext), socket(ioContext), actionTimer(ioContext), options(options), stats(stats), number(number),
+	account(fmt::format(fmt::runtime(options.account), number)), character(fmt::format(fmt::runtime(options.character), number)),
+	rng(std::random_device {}() ^ number) { }
+
+void LoadBot::start() {
+	asio::post(ioContext, [self = shared_from_this()] {
+		++self->stats.connecting;
+		self->loginStartedAt = std::chrono::steady_clock::now();
+		if (self->options.loginPort != 0) {
+			self->state = State::Login;
+			self->connect(self->options.loginPort);
+		} else {
+			self->state = State::Challenge;
+			self->connect(self->options.gamePort);
+		}
+	});
+}
+
+void LoadBot::stop() {
+	asio::post(ioContext, [self = shared_from_this()] {
+		self->close();
+	});
+}
+
+void LoadBot::connect(uint16_t port) {
+	std::error_code addressError;
+	const auto address = asio::ip::make_address(options.host, addressError);
+	if (addressError) {
+		fail(fmt::format("invalid address {}", options.host));
+		return;
+	}
+
+	socket.async_connect(asio::ip::tcp::endpoint(address, port), [self = shared_from_this()](const std::error_code &error) {
+		if (self->state == State::Closed) {
+			return;
+		}
+		if (error) {
+			self->fail(fmt::format("connect: {}", error.message()));
+			return;
+		}
+
+		if (self->state == State::Login) {
+			self->sendLogin();
+		}
+		// The game server sends the challenge first
+		self->readHeader();
+	});
+}
+
+void LoadBot::sendLogin() {
+	std::ranges::generate(key, std::ref(rng));
+
+	NetworkMessage msg;
+	msg.addByte(LOGIN_PROTOCOL_IDENTIFIER);
+	msg.add<uint16_t>(CLIENTOS_WINDOWS);
+	msg.add<uint16_t>(OLD_PROTOCOL_VERSION);
+	msg.add<uint32_t>(OLD_PROTOCOL_VERSION);
+	// Dat, spr and pic signatures, preview world
+	msg.addPaddingBytes(13);
+
+	NetworkMessage block;
+	block.addByte(0);
+	for (const auto part : key) {
+		block.add<uint32_t>(part);
+	}
+	block.addString(account);
+	block.addString(options.password);
+	addRSABlock(msg, block);
+
+	sendUnencrypted(msg);
+}
+
+void LoadBot::sendGameLogin(uint32_t timestamp, uint8_t random) {
+	std::ranges::generate(key, std::ref(rng));
+	// What the server enables for a client of these operating systems
+	sequenceChecksum = !options.oldProtocol;
+	sequenceNumber = 0;
+
+	const uint16_t version = options.oldProtocol ? OLD_PROTOCOL_VERSION : CLIENT_VERSION;
+	NetworkMessage msg;
+	msg.addByte(GAME_PROTOCOL_IDENTIFIER);
+	msg.add<uint16_t>(options.oldProtocol ? CLIENTOS_WINDOWS : CLIENTOS_NEW_WINDOWS);
+	msg.add<uint16_t>(version);
+	msg.add<uint32_t>(version);
+	if (!options.oldProtocol) {
+		msg.addString(fmt::format("{}.{}", CLIENT_VERSION_UPPER, CLIENT_VERSION_LOWER));
+	}
+	// Dat revision, preview state
+	msg.add<uint16_t>(0);
+	msg.addByte(0);
+
+	NetworkMessage block;
+	block.addByte(0);
+	for (const auto part : key) {
+		block.add<uint32_t>(part);
+	}
+	// Gamemaster flag
+	block.addByte(0);
+	block.addString(account + "\n" + options.password);
+	block.addString(character);
+	block.add<uint32_t>(timestamp);
+	block.addByte(random);
+	// No OTCv8 signature
+	block.add<uint16_t>(0);
+	addRSABlock(msg, block);
+
+	sendUnencrypted(msg);
+	state = State::EnteringGame;
+}
+
+void LoadBot::readHeader() {
+	asio::async_read(socket, asio::buffer(inbound.getBuffer(), HEADER_LENGTH), [self = shared_from_this()](const std::error_code &error, size_t) {
+		if (self->state == State::Closed) {
+			return;
+		}
+		if (error) {
+			self->fail(error == asio::error::eof ? "closed by the server" : fmt::format("read: {}", error.message()));
+			return;
+		}
+		self->readBody();
+	});
+}
+
+void LoadBot::readBody() {
+	const uint16_t length = inbound.getLengthHeader();
+	if (length == 0 || length > NETWORKMESSAGE_MAXSIZE - HEADER_LENGTH) {
+		fail("invalid message length");
+		return;
+	}
+
+	asio::async_read(socket, asio::buffer(inbound.getBuffer() + HEADER_LENGTH, length), [self = shared_from_this()](const std::error_code &error, size_t size) {
+		if (self->state == State::Closed) {
+			return;
+		}
+		if (error) {
+			self->fail(fmt::format("read: {}", error.message()));
+			return;
+		}
+
+		self->stats.bytesReceived += HEADER_LENGTH + size;
+		if (self->onMessage() && self->state != State::Closed) {
+			self->readHeader();
+		}
+	});
+}
+
+bool LoadBot::onMessage() {
+	if (state == State::Challenge) {
+		inbound.setBufferPosition(HEADER_LENGTH);
+		inbound.setLength(inbound.getLengthHeader());
+		// Checksum and inner length
+		inbound.skipBytes(CHECKSUM_LENGTH + 2);
+		if (inbound.getByte() != 0x1F) {
+			fail("unexpected challenge");
+			return false;
+		}
+
+		const auto timestamp = inbound.get<uint32_t>();
+		const auto random = inbound.getByte();
+		sendGameLogin(timestamp, random);
+		return true;
+	}
+
+	NetworkMessage* msg = decode();
+	if (!msg) {
+		fail("undecodable message");
+		return false;
+	}
+
+	if (state == State::Login) {
+		return onLoginMessage(*msg);
+	}
+	onGameMessage(*msg);
+	return true;
+}
+
+bool LoadBot::onLoginMessage(NetworkMessage &msg) {
+	while (msg.getBufferPosition() < msg.getLength() + NetworkMessage::INITIAL_BUFFER_POSITION && !msg.isOverrun()) {
+		switch (msg.getByte()) {
+			case 0x0A:
+			case 0x0B:
+				fail(fmt::format("login: {}", msg.getString()));
+				return false;
+			// Motd, session key
+			case 0x14:
+			case 0x28:
+				msg.getString();
+				break;
+			case 0x64: {
+				uint16_t port = options.gamePort;
+				const uint8_t worlds = msg.getByte();
+				for (uint8_t world = 0; world < worlds; ++world) {
+					msg.getByte();
+					msg.getString();
+					msg.getString();
+					const auto worldPort = msg.get<uint16_t>();
+					msg.getByte();
+					if (world == 0) {
+						port = worldPort;
+					}
+				}
+
+				const uint8_t characters = msg.getByte();
+				if (characters == 0) {
+					fail("login: account has no characters");
+					return false;
+				}
+				msg.getByte();
+				character = msg.getString();
+
+				// The address of the world is the one of the server, which may not be reachable from here
+				std::error_code ignored;
+				socket.close(ignored);
+				state = State::Challenge;
+				connect(port);
+				// The next read is the one of the game connection
+				return false;
+			}
+			default:
+				fail("login: unexpected message");
+				return false;
+		}
+	}
+	return true;
+}
+
+void LoadBot::onGameMessage(NetworkMessage &msg) {
+	const uint8_t opcode = msg.getByte();
+	if (opcode == 0x14) {
+		fail(fmt::format("{}: {}", state == State::Online ? "kicked" : "login", msg.getString()));
+		return;
+	}
+
+	if (state != State::EnteringGame) {
+		return;
+	}
+
+	if (opcode == 0x16) {
+		fail("login: waiting list");
+		return;
+	}
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - loginStartedAt).count();
+	stats.loginTimeMs += elapsed;
+	++stats.logins;
+	--stats.connecting;
+	++stats.online;
+	state = State::Online;
+
+	lastPongAt = std::chrono::steady_clock::now();
+	scheduleAction();
+}
+
+void LoadBot::scheduleAction() {
+	// Spread over the interval so the bots do not act in the same tick
+	std::uniform_int_distribution<uint32_t> delay(options.actionIntervalMs / 2, options.actionIntervalMs * 3 / 2);
+	actionTimer.expires_after(std::chrono::milliseconds(delay(rng)));
+	actionTimer.async_wait([self = shared_from_this()](const std::error_code &error) {
+		if (error || self->state != State::Online) {
+			return;
+		}
+		self->doAction();
+		self->scheduleAction();
+	});
+}
+
+void LoadBot::doAction() {
+	NetworkMessage msg;
+	const auto now = std::chrono::steady_clock::now();
+	if (now - lastPongAt >= std::chrono::milliseconds(PONG_INTERVAL_MS)) {
+		lastPongAt = now;
+		msg.addByte(0x1E);
+		send(msg);
+		msg.reset();
+	}
+
+	const uint32_t action = rng() % 100;
+	if (action < 50) {
+		// North, east, south or west
+		msg.addByte(static_cast<uint8_t>(0x65 + rng() % 4));
+	} else if (action < 70) {
+		msg.addByte(0x96);
+		msg.addByte(TALKTYPE_SAY);
+		msg.addString(fmt::format("load test {} says {}", number, rng() % 1000));
+	} else if (action < 85 && !options.spells.empty()) {
+		msg.addByte(0x96);
+		msg.addByte(TALKTYPE_SAY);
+		msg.addString(options.spells[rng() % options.spells.size()]);
+	} else {
+		// Between two inventory slots, whichever one holds the item
+		const bool back = rng() % 2 == 0;
+		msg.addByte(0x78);
+		msg.addPosition(Position(0xFFFF, back ? options.moveToSlot : options.moveFromSlot, 0));
+		msg.add<uint16_t>(0);
+		msg.addByte(0);
+		msg.addPosition(Position(0xFFFF, back ? options.moveFromSlot : options.moveToSlot, 0));
+		msg.addByte(1);
+	}
+
+	send(msg);
+	++stats.actions;
+}
+
+void LoadBot::sendUnencrypted(NetworkMessage &msg) {
+	// The checksum and the length go right before the body
+	uint8_t* buffer = msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION - HEADER_LENGTH - CHECKSUM_LENGTH;
+	const uint16_t length = msg.getLength();
+	const uint32_t checksum = adlerChecksum(buffer + HEADER_LENGTH + CHECKSUM_LENGTH, length);
+	const uint16_t outerLength = length + CHECKSUM_LENGTH;
+	memcpy(buffer, &outerLength, sizeof(outerLength));
+	memcpy(buffer + HEADER_LENGTH, &checksum, sizeof(checksum));
+
+	write(std::vector<uint8_t>(buffer, buffer + HEADER_LENGTH + outerLength));
+}
+
+void LoadBot::send(NetworkMessage &msg) {
+	// Inner length, body and padding are encrypted, they start after the length and the checksum
+	uint8_t* buffer = msg.getBuffer();
+	const uint16_t length = msg.getLength();
+	memcpy(buffer + HEADER_LENGTH + CHECKSUM_LENGTH, &length, sizeof(length));
+
+	const size_t encryptedLength = (length + 2 + 7) & ~size_t { 7 };
+	memset(buffer + NetworkMessage::INITIAL_BUFFER_POSITION + length, 0, encryptedLength - length - 2);
+	XTEA::encrypt(buffer + HEADER_LENGTH + CHECKSUM_LENGTH, encryptedLength, key);
+
+	const uint32_t checksum = sequenceChecksum ? ++sequenceNumber : adlerChecksum(buffer + HEADER_LENGTH + CHECKSUM_LENGTH, encryptedLength);
+	const auto outerLength = static_cast<uint16_t>(encryptedLength + CHECKSUM_LENGTH);
+	memcpy(buffer, &outerLength, sizeof(outerLength));
+	memcpy(buffer + HEADER_LENGTH, &checksum, sizeof(checksum));
+
+	write(std::vector<uint8_t>(buffer, buffer + HEADER_LENGTH + outerLength));
+}
+
+void LoadBot::write(std::vector<uint8_t> &&packet) {
+	stats.bytesSent += packet.size();
+	writeQueue.emplace_back(std::move(packet));
+	if (writeQueue.size() == 1) {
+		flush();
+	}
+}
+
+void LoadBot::flush() {
+	asio::async_write(socket, asio::buffer(writeQueue.front()), [self = shared_from_this()](const std::error_code &error, size_t) {
+		if (self->state == State::Closed) {
+			return;
+		}
+		if (error) {
+			self->fail(fmt::format("write: {}", error.message()));
+			return;
+		}
+
+		self->writeQueue.pop_front();
+		if (!self->writeQueue.empty()) {
+			self->flush();
+		}
+	});
+}
+
+void LoadBot::addRSABlock(NetworkMessage &msg, NetworkMessage &block) {
+	std::array<char, 128> data {};
+	memcpy(data.data(), block.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION, std::min<size_t>(block.getLength(), data.size()));
+	g_RSA().encrypt(data.data());
+	msg.addBytes(data.data(), data.size());
+}
+
+NetworkMessage* LoadBot::decode() {
+	const uint16_t length = inbound.getLengthHeader();
+	if (length < CHECKSUM_LENGTH + 8 || (length - CHECKSUM_LENGTH) % 8 != 0) {
+		return nullptr;
+	}
+
+	uint8_t* buffer = inbound.getBuffer();
+	uint32_t checksum;
+	memcpy(&checksum, buffer + HEADER_LENGTH, sizeof(checksum));
+
+	const size_t encryptedLength = length - CHECKSUM_LENGTH;
+	XTEA::decrypt(buffer + HEADER_LENGTH + CHECKSUM_LENGTH, encryptedLength, key);
+
+	uint16_t innerLength;
+	memcpy(&innerLength, buffer + HEADER_LENGTH + CHECKSUM_LENGTH, sizeof(innerLength));
+	if (innerLength > encryptedLength - 2) {
+		return nullptr;
+	}
+
+	inbound.setBufferPosition(NetworkMessage::INITIAL_BUFFER_POSITION);
+	inbound.setLength(innerLength);
+	if (!sequenceChecksum || (checksum & SEQUENCE_COMPRESSED_FLAG) == 0) {
+		return &inbound;
+	}
+
+	static thread_local Inflater inflater;
+	auto &stream = inflater.stream;
+	auto &output = inflater.output;
+	stream.next_in = buffer + NetworkMessage::INITIAL_BUFFER_POSITION;
+	stream.avail_in = innerLength;
+	stream.next_out = output.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION;
+	stream.avail_out = static_cast<uInt>(output.getCapacity() - NetworkMessage::INITIAL_BUFFER_POSITION - NetworkMessage::BODY_RESERVE);
+
+	const int result = inflate(&stream, Z_FINISH);
+	const auto inflatedLength = static_cast<uint16_t>(stream.total_out);
+	inflateReset(&stream);
+	if (result != Z_STREAM_END) {
+		return nullptr;
+	}
+
+	output.setBufferPosition(NetworkMessage::INITIAL_BUFFER_POSITION);
+	output.setLength(inflatedLength);
+	return &output;
+}
+
+void LoadBot::fail(std::string_view error) {
+	if (state == State::Closed) {
+		return;
+	}
+
+	stats.addError(error);
+	if (state == State::Online) {
+		++stats.disconnected;
+	} else {
+		++stats.failed;
+	}
+	close();
+}
+
+void LoadBot::close() {
+	if (state == State::Closed) {
+		return;
+	}
+
+	if (state == State::Online) {
+		--stats.online;
+	} else {
+		--stats.connecting;
+	}
+	state = State::Closed;
+
+	actionTimer.cancel();
+	std::error_code ignored;
+	socket.close(ignored);
+}
@@ -0,0 +1,145 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "security/xtea.hpp"
+#include "server/network/message/networkmessage.hpp"
+
+struct LoadTestOptions {
+	std::string host = "127.0.0.1";
+	// 0 logs straight into the game port, otherwise the character list comes from ProtocolLogin (11.00 only)
+	uint16_t loginPort = 0;
+	uint16_t gamePort = 7172;
+	bool oldProtocol = false;
+
+	uint32_t bots = 100;
+	uint32_t firstBot = 1;
+	// {} is replaced by the bot number
+	std::string account = "loadtest{}@canary.local";
+	std::string password = "loadtest";
+	std::string character = "Loadtest {}";
+
+	// Bots connected per second while ramping up
+	uint32_t rampRate = 50;
+	uint32_t actionIntervalMs = 1000;
+	std::vector<std::string> spells = { "utevo lux", "exura" };
+	// Inventory slots the item move action swaps
+	uint8_t moveFromSlot = 6;
+	uint8_t moveToSlot = 5;
+
+	// PEM of the server key, otherwise key.pem of the working directory or the default key of the server
+	std::string keyFile;
+};
+
+// Shared by every bot, written from the io threads
+struct LoadTestStats {
+	std::atomic<uint32_t> connecting = 0;
+	std::atomic<uint32_t> online = 0;
+	std::atomic<uint32_t> failed = 0;
+	std::atomic<uint32_t> disconnected = 0;
+
+	std::atomic<uint64_t> logins = 0;
+	std::atomic<uint64_t> loginTimeMs = 0;
+	std::atomic<uint64_t> actions = 0;
+	std::atomic<uint64_t> bytesSent = 0;
+	std::atomic<uint64_t> bytesReceived = 0;
+
+	void addError(std::string_view error);
+	// Most frequent first
+	std::vector<std::pair<std::string, uint32_t>> getErrors() const;
+
+private:
+	mutable std::mutex errorsMutex;
+	std::map<std::string, uint32_t, std::less<>> errors;
+};
+
+/**
+ * One simulated client. It logs in like the client does (character list
+ * from ProtocolLogin when asked for, then the game challenge, the RSA block
+ * with the XTEA key and the account), then walks, talks, casts spells and
+ * moves items at random every action interval until it is disconnected.
+ *
+ * Server messages are decrypted and inflated to tell failed logins and
+ * kicks apart, but otherwise not parsed. Every callback of a bot runs on the
+ * io_context it was created with, so a bot needs no locking of its own.
+ */
+class LoadBot : public std::enable_shared_from_this<LoadBot> {
+public:
+	// Client pongs are sent on their own, the server pings are not parsed
+	static constexpr uint32_t PONG_INTERVAL_MS = 5000;
+
+	LoadBot(asio::io_context &ioContext, const LoadTestOptions &options, LoadTestStats &stats, uint32_t number);
+
+	// Ensures that we don't accidentally copy it
+	LoadBot(const LoadBot &) = delete;
+	LoadBot operator=(const LoadBot &) = delete;
+
+	void start();
+	void stop();
+
+private:
+	enum class State : uint8_t {
+		Login,
+		Challenge,
+		EnteringGame,
+		Online,
+		Closed,
+	};
+
+	void connect(uint16_t port);
+	void sendLogin();
+	void sendGameLogin(uint32_t timestamp, uint8_t random);
+
+	void readHeader();
+	void readBody();
+	// Whether to go on reading from the same connection
+	bool onMessage();
+	bool onLoginMessage(NetworkMessage &msg);
+	void onGameMessage(NetworkMessage &msg);
+
+	void scheduleAction();
+	void doAction();
+
+	// Writes the message framed as the client first message: checksummed, not encrypted
+	void sendUnencrypted(NetworkMessage &msg);
+	void send(NetworkMessage &msg);
+	void write(std::vector<uint8_t> &&packet);
+	void flush();
+	// Adds the 128 bytes of block, encrypted with the server key
+	static void addRSABlock(NetworkMessage &msg, NetworkMessage &block);
+	// The decrypted and inflated body of the message just read, nullptr when it is not valid
+	NetworkMessage* decode();
+
+	void fail(std::string_view error);
+	void close();
+
+	asio::io_context &ioContext;
+	asio::ip::tcp::socket socket;
+	asio::steady_timer actionTimer;
+	const LoadTestOptions &options;
+	LoadTestStats &stats;
+	const uint32_t number;
+	std::string account;
+	std::string character;
+
+	State state = State::Closed;
+	std::chrono::steady_clock::time_point loginStartedAt;
+	std::chrono::steady_clock::time_point lastPongAt;
+
+	XTEA::Key key {};
+	bool sequenceChecksum = false;
+	uint32_t sequenceNumber = 0;
+
+	// Messages are read into it, the inflated ones go to a buffer of the io thread
+	NetworkMessage inbound;
+	std::deque<std::vector<uint8_t>> writeQueue;
+
+	std::mt19937 rng;
+};
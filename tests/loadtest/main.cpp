@@ -0,0 +1,221 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "load_bot.hpp"
+#include "server_metrics.hpp"
+#include "security/rsa.hpp"
+
+namespace {
+	struct RunOptions {
+		uint32_t threads = std::max(1U, std::thread::hardware_concurrency());
+		uint32_t durationSeconds = 300;
+		uint32_t reportSeconds = 10;
+		uint16_t metricsPort = 0;
+	};
+
+	void printUsage() {
+		fmt::print(
+			"canary_loadtest [options]\n"
+			"  --host <ip>             server address (127.0.0.1)\n"
+			"  --game-port <port>      game port (7172)\n"
+			"  --login-port <port>     take the character list from ProtocolLogin, implies --old-protocol\n"
+			"  --old-protocol          log in as an 11.00 client, needs allowOldProtocol\n"
+			"  --bots <n>              simulated clients (100)\n"
+			"  --first <n>             number of the first bot (1)\n"
+			"  --account <pattern>     account of bot {{}} (loadtest{{}}@canary.local)\n"
+			"  --password <password>   password of every account (loadtest)\n"
+			"  --character <pattern>   character of bot {{}} (Loadtest {{}})\n"
+			"  --ramp <n>              bots connected per second (50)\n"
+			"  --interval <ms>         mean time between the actions of a bot (1000)\n"
+			"  --spell <words>         spell to cast, repeatable (utevo lux, exura)\n"
+			"  --move <from>,<to>      inventory slots the item moves swap (6,5)\n"
+			"  --key <file>            PEM of the server key (key.pem, else the default key)\n"
+			"  --threads <n>           io threads (hardware concurrency)\n"
+			"  --duration <s>          length of the run (300)\n"
+			"  --report <s>            time between reports (10)\n"
+			"  --metrics-port <port>   metricsPort of the server, for tick times and CPU\n"
+		);
+	}
+
+	bool parseArguments(int argc, char* argv[], LoadTestOptions &options, RunOptions &run) {
+		bool defaultSpells = true;
+		for (int i = 1; i < argc; ++i) {
+			const std::string_view argument(argv[i]);
+			if (argument == "--old-protocol") {
+				options.oldProtocol = true;
+				continue;
+			}
+			if (i + 1 >= argc) {
+				return false;
+			}
+
+			const std::string value(argv[++i]);
+			const auto number = [&value] {
+				return static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+			};
+			if (argument == "--host") {
+				options.host = value;
+			} else if (argument == "--game-port") {
+				options.gamePort = static_cast<uint16_t>(number());
+			} else if (argument == "--login-port") {
+				options.loginPort = static_cast<uint16_t>(number());
+				options.oldProtocol = true;
+			} else if (argument == "--bots") {
+				options.bots = number();
+			} else if (argument == "--first") {
+				options.firstBot = number();
+			} else if (argument == "--account") {
+				options.account = value;
+			} else if (argument == "--password") {
+				options.password = value;
+			} else if (argument == "--character") {
+				options.character = value;
+			} else if (argument == "--ramp") {
+				options.rampRate = std::max(1U, number());
+			} else if (argument == "--interval") {
+				options.actionIntervalMs = std::max(1U, number());
+			} else if (argument == "--spell") {
+				if (defaultSpells) {
+					options.spells.clear();
+					defaultSpells = false;
+				}
+				options.spells.emplace_back(value);
+			} else if (argument == "--move") {
+				const auto separator = value.find(',');
+				if (separator == std::string::npos) {
+					return false;
+				}
+				options.moveFromSlot = static_cast<uint8_t>(std::strtoul(value.c_str(), nullptr, 10));
+				options.moveToSlot = static_cast<uint8_t>(std::strtoul(value.c_str() + separator + 1, nullptr, 10));
+			} else if (argument == "--key") {
+				options.keyFile = value;
+			} else if (argument == "--threads") {
+				run.threads = std::max(1U, number());
+			} else if (argument == "--duration") {
+				run.durationSeconds = number();
+			} else if (argument == "--report") {
+				run.reportSeconds = std::max(1U, number());
+			} else if (argument == "--metrics-port") {
+				run.metricsPort = static_cast<uint16_t>(number());
+			} else {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::string formatServerMetrics(const std::optional<ServerMetrics> &current, const std::optional<ServerMetrics> &previous) {
+		if (!current || !previous) {
+			return "server metrics unavailable";
+		}
+		return fmt::format(
+			"server {} players, cycle mean {:.2f} ms, p99 <= {} ms, cpu {:.0f}%, rss {:.0f} MB",
+			current->get("canary_players_online"), current->getMeanCycleMs(*previous),
+			current->getCyclePercentileMs(*previous, 99), current->getCpuUsage(*previous) * 100,
+			current->get("canary_process_resident_bytes") / 1048576
+		);
+	}
+}
+
+/**
+ * canary_loadtest [options]
+ * Connects the bots at the ramp rate, then lets them play for the rest of
+ * the run. Every report shows what the bots see and, with the metrics port
+ * of the server, the dispatcher cycle times and the CPU of the server over
+ * the report interval, and its resident memory.
+ */
+int main(int argc, char* argv[]) {
+	LoadTestOptions options;
+	RunOptions run;
+	if (!parseArguments(argc, argv, options, run)) {
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	g_RSA().start();
+	if (!options.keyFile.empty() && !g_RSA().loadPEM(options.keyFile)) {
+		fmt::print("Could not load the key {}\n", options.keyFile);
+		return EXIT_FAILURE;
+	}
+
+	// One io_context per thread, so the callbacks of a bot never run concurrently
+	std::vector<std::unique_ptr<asio::io_context>> ioContexts;
+	std::vector<asio::executor_work_guard<asio::io_context::executor_type>> workGuards;
+	std::vector<std::jthread> threads;
+	for (uint32_t i = 0; i < run.threads; ++i) {
+		auto &ioContext = ioContexts.emplace_back(std::make_unique<asio::io_context>());
+		workGuards.emplace_back(asio::make_work_guard(*ioContext));
+		threads.emplace_back([&context = *ioContext] { context.run(); });
+	}
+
+	LoadTestStats stats;
+	std::vector<std::shared_ptr<LoadBot>> bots;
+	bots.reserve(options.bots);
+
+	const auto scrape = [&]() -> std::optional<ServerMetrics> {
+		return run.metricsPort != 0 ? ServerMetrics::scrape(options.host, run.metricsPort) : std::nullopt;
+	};
+	const auto firstMetrics = scrape();
+	auto previousMetrics = firstMetrics;
+	uint64_t previousActions = 0;
+	uint64_t previousSent = 0;
+	uint64_t previousReceived = 0;
+
+	const auto startedAt = std::chrono::steady_clock::now();
+	for (uint32_t second = 1; second <= run.durationSeconds; ++second) {
+		for (uint32_t i = 0; i < options.rampRate && bots.size() < options.bots; ++i) {
+			const auto number = options.firstBot + static_cast<uint32_t>(bots.size());
+			auto &bot = bots.emplace_back(std::make_shared<LoadBot>(*ioContexts[bots.size() % ioContexts.size()], options, stats, number));
+			bot->start();
+		}
+
+		std::this_thread::sleep_until(startedAt + std::chrono::seconds(second));
+		if (second % run.reportSeconds != 0 && second != run.durationSeconds) {
+			continue;
+		}
+
+		const auto actions = stats.actions.load();
+		const auto sent = stats.bytesSent.load();
+		const auto received = stats.bytesReceived.load();
+		const auto interval = static_cast<double>(second % run.reportSeconds == 0 ? run.reportSeconds : second % run.reportSeconds);
+		const auto metrics = scrape();
+		fmt::print(
+			"[{:>5}s] bots {} online, {} connecting, {} failed, {} disconnected | {:.0f} actions/s, sent {:.1f} KB/s, received {:.1f} KB/s | {}\n",
+			second, stats.online.load(), stats.connecting.load(), stats.failed.load(), stats.disconnected.load(),
+			(actions - previousActions) / interval, (sent - previousSent) / interval / 1024, (received - previousReceived) / interval / 1024,
+			formatServerMetrics(metrics, previousMetrics)
+		);
+		std::fflush(stdout);
+
+		previousActions = actions;
+		previousSent = sent;
+		previousReceived = received;
+		if (metrics) {
+			previousMetrics = metrics;
+		}
+	}
+
+	for (const auto &bot : bots) {
+		bot->stop();
+	}
+	workGuards.clear();
+	threads.clear();
+
+	const auto logins = stats.logins.load();
+	fmt::print("{} of {} bots logged in, mean login time {} ms\n", logins, bots.size(), logins != 0 ? stats.loginTimeMs.load() / logins : 0);
+	if (firstMetrics && previousMetrics) {
+		fmt::print("Whole run: {}\n", formatServerMetrics(previousMetrics, firstMetrics));
+	}
+	for (const auto &[error, count] : stats.getErrors() | std::views::take(10)) {
+		fmt::print("{:>6} x {}\n", count, error);
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,119 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "server_metrics.hpp"
+
+namespace {
+	constexpr std::string_view CYCLE_HISTOGRAM = "canary_dispatcher_cycle_seconds";
+	constexpr std::string_view PROCESS_CPU = "canary_process_cpu_milliseconds";
+}
+
+std::optional<ServerMetrics> ServerMetrics::scrape(const std::string &host, uint16_t port) {
+	std::error_code error;
+	const auto address = asio::ip::make_address(host, error);
+	if (error) {
+		return std::nullopt;
+	}
+
+	asio::io_context ioContext;
+	asio::ip::tcp::socket socket(ioContext);
+	socket.connect(asio::ip::tcp::endpoint(address, port), error);
+	if (error) {
+		return std::nullopt;
+	}
+
+	const std::string request = fmt::format("GET /metrics HTTP/1.1\r\nHost: {}\r\nConnection: close\r\n\r\n", host);
+	asio::write(socket, asio::buffer(request), error);
+	if (error) {
+		return std::nullopt;
+	}
+
+	// The exporter closes the connection after the response
+	std::string response;
+	asio::read(socket, asio::dynamic_buffer(response), error);
+	if (error && error != asio::error::eof) {
+		return std::nullopt;
+	}
+
+	const auto bodyStart = response.find("\r\n\r\n");
+	if (response.find(" 200 ") == std::string::npos || bodyStart == std::string::npos) {
+		return std::nullopt;
+	}
+
+	ServerMetrics metrics;
+	metrics.scrapedAt = std::chrono::steady_clock::now();
+	metrics.parse(std::string_view(response).substr(bodyStart + 4));
+	return metrics;
+}
+
+void ServerMetrics::parse(std::string_view text) {
+	while (!text.empty()) {
+		const auto lineEnd = text.find('\n');
+		const auto line = text.substr(0, lineEnd);
+		text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+		if (line.empty() || line.front() == '#') {
+			continue;
+		}
+
+		const auto separator = line.rfind(' ');
+		if (separator == std::string_view::npos) {
+			continue;
+		}
+
+		const auto series = line.substr(0, separator);
+		const double value = std::strtod(std::string(line.substr(separator + 1)).c_str(), nullptr);
+		values.emplace(series, value);
+
+		if (series.starts_with(CYCLE_HISTOGRAM) && series.substr(CYCLE_HISTOGRAM.size()).starts_with("_bucket{le=\"")) {
+			const auto bound = series.substr(CYCLE_HISTOGRAM.size() + 12);
+			cycleBuckets.emplace_back(bound.starts_with("+Inf") ? std::numeric_limits<double>::infinity() : std::strtod(std::string(bound).c_str(), nullptr), value);
+		}
+	}
+}
+
+double ServerMetrics::get(std::string_view series) const {
+	const auto it = values.find(series);
+	return it != values.end() ? it->second : 0;
+}
+
+double ServerMetrics::getMeanCycleMs(const ServerMetrics &previous) const {
+	const auto count = get(fmt::format("{}_count", CYCLE_HISTOGRAM)) - previous.get(fmt::format("{}_count", CYCLE_HISTOGRAM));
+	if (count <= 0) {
+		return 0;
+	}
+	return (get(fmt::format("{}_sum", CYCLE_HISTOGRAM)) - previous.get(fmt::format("{}_sum", CYCLE_HISTOGRAM))) * 1000 / count;
+}
+
+double ServerMetrics::getCyclePercentileMs(const ServerMetrics &previous, double percentile) const {
+	if (cycleBuckets.empty() || cycleBuckets.size() != previous.cycleBuckets.size()) {
+		return 0;
+	}
+
+	const auto total = cycleBuckets.back().second - previous.cycleBuckets.back().second;
+	if (total <= 0) {
+		return 0;
+	}
+
+	for (size_t bucket = 0; bucket < cycleBuckets.size(); ++bucket) {
+		if (cycleBuckets[bucket].second - previous.cycleBuckets[bucket].second >= total * percentile / 100) {
+			return cycleBuckets[bucket].first * 1000;
+		}
+	}
+	return std::numeric_limits<double>::infinity();
+}
+
+double ServerMetrics::getCpuUsage(const ServerMetrics &previous) const {
+	const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(scrapedAt - previous.scrapedAt).count();
+	if (elapsedMs <= 0) {
+		return 0;
+	}
+	return (get(PROCESS_CPU) - previous.get(PROCESS_CPU)) / static_cast<double>(elapsedMs);
+}
@@ -0,0 +1,39 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * One scrape of the metrics endpoint of the server (metricsPort), kept as
+ * series name with labels to value. Two scrapes give the dispatcher cycle
+ * times and the CPU the server used in between.
+ */
+class ServerMetrics {
+public:
+	// Empty when the endpoint could not be read
+	static std::optional<ServerMetrics> scrape(const std::string &host, uint16_t port);
+
+	// 0 when the series is missing
+	double get(std::string_view series) const;
+
+	// Mean cycle time in ms since the previous scrape
+	double getMeanCycleMs(const ServerMetrics &previous) const;
+	// Upper bound in ms of the bucket holding the given percentile of the cycles since the previous scrape
+	double getCyclePercentileMs(const ServerMetrics &previous, double percentile) const;
+	// Cores the server kept busy since the previous scrape, 1.0 is one core
+	double getCpuUsage(const ServerMetrics &previous) const;
+
+private:
+	void parse(std::string_view text);
+
+	std::chrono::steady_clock::time_point scrapedAt;
+	std::map<std::string, double, std::less<>> values;
+	// Bound in seconds and cumulative count of the cycle histogram, +Inf last
+	std::vector<std::pair<double, double>> cycleBuckets;
+};
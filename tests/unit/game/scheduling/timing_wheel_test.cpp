@@ -0,0 +1,86 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/task.hpp"
+#include "game/scheduling/timing_wheel.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	std::shared_ptr<Task> makeTask(uint64_t eventId) {
+		auto task = std::make_shared<Task>([] {}, "TimingWheelTest");
+		task->setEventId(eventId);
+		return task;
+	}
+}
+
+suite<"game"> timingWheelTest = [] {
+	test("TimingWheel expires tasks at their tick") = [] {
+		TimingWheel wheel;
+		wheel.add(makeTask(1), 3);
+		wheel.add(makeTask(2), 1);
+
+		std::vector<std::shared_ptr<Task>> expired;
+		wheel.advance(2, expired);
+		expect(eq(size_t { 1 }, expired.size()) >> fatal);
+		expect(eq(uint64_t { 2 }, expired[0]->getEventId()));
+
+		wheel.advance(3, expired);
+		expect(eq(size_t { 2 }, expired.size()) >> fatal);
+		expect(eq(uint64_t { 1 }, expired[1]->getEventId()));
+		expect(eq(size_t { 0 }, wheel.size()));
+	};
+
+	test("TimingWheel cascades far away tasks") = [] {
+		TimingWheel wheel;
+		const uint64_t farAway = TimingWheel::SLOTS * TimingWheel::SLOTS + 7;
+		wheel.add(makeTask(1), farAway);
+
+		std::vector<std::shared_ptr<Task>> expired;
+		wheel.advance(farAway - 1, expired);
+		expect(expired.empty());
+
+		wheel.advance(farAway, expired);
+		expect(eq(size_t { 1 }, expired.size()));
+	};
+
+	test("TimingWheel skips removed and rescheduled tasks") = [] {
+		TimingWheel wheel;
+		auto rescheduled = makeTask(2);
+		wheel.add(makeTask(1), 5);
+		wheel.add(rescheduled, 5);
+		wheel.add(rescheduled, 10);
+		expect(wheel.remove(1));
+		expect(!wheel.remove(1));
+
+		std::vector<std::shared_ptr<Task>> expired;
+		wheel.advance(9, expired);
+		expect(expired.empty());
+
+		wheel.advance(10, expired);
+		expect(eq(size_t { 1 }, expired.size()) >> fatal);
+		expect(eq(uint64_t { 2 }, expired[0]->getEventId()));
+	};
+
+	test("TimingWheel never expires a task on an already expired tick") = [] {
+		TimingWheel wheel;
+		std::vector<std::shared_ptr<Task>> expired;
+		wheel.advance(4, expired);
+
+		wheel.add(makeTask(1), 2);
+		wheel.advance(4, expired);
+		expect(expired.empty());
+
+		wheel.advance(5, expired);
+		expect(eq(size_t { 1 }, expired.size()));
+	};
+};
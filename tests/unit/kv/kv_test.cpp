@@ -97,4 +97,13 @@ suite<"kv"> kvTest = [] {
 		expect(eq(scoped->get<int>("key1"), 1));
 		expect(eq(kv.get<int>("scope-name.key1"), 1));
 	};
+
+	test("Evicted entries keep their unsaved value") = [&injectionFixture] {
+		auto [kv] = injectionFixture.get<KVStore>();
+		kv.set("keyEvicted", 7);
+		for (size_t i = 0; i < KVStore::MAX_SIZE; ++i) {
+			kv.set(fmt::format("keyFiller{}", i), static_cast<int>(i));
+		}
+		expect(eq(kv.get<int>("keyEvicted"), 7));
+	};
 };
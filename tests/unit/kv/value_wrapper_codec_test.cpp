@@ -0,0 +1,73 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "kv/value_wrapper_codec.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	std::optional<ValueWrapper> roundTrip(const ValueWrapper &value, std::string* encoded = nullptr) {
+		std::string data;
+		ValueWrapperCodec::encode(value, data);
+		if (encoded) {
+			*encoded = data;
+		}
+		return ValueWrapperCodec::decode(data.data(), data.size(), 0);
+	}
+}
+
+suite<"kv"> valueWrapperCodecTest = [] {
+	test("ValueWrapperCodec keeps small integers in two bytes") = [] {
+		std::string data;
+		for (const int value : { 0, 15, -15 }) {
+			const auto decoded = roundTrip(value, &data);
+			expect(eq(size_t { 2 }, data.size()));
+			expect(eq(true, decoded.has_value()) >> fatal);
+			expect(eq(value, decoded->get<IntType>()));
+		}
+
+		for (const int value : { 16, std::numeric_limits<int>::min(), std::numeric_limits<int>::max() }) {
+			const auto decoded = roundTrip(value);
+			expect(eq(true, decoded.has_value()) >> fatal);
+			expect(eq(value, decoded->get<IntType>()));
+		}
+	};
+
+	test("ValueWrapperCodec round trips nested values") = [] {
+		phmap::flat_hash_map<std::string, ValueWrapper> inner;
+		inner.emplace("level", 8);
+		phmap::flat_hash_map<std::string, ValueWrapper> map;
+		map.emplace("name", std::string(40, 'x'));
+		map.emplace("rate", 1.5);
+		map.emplace("list", ArrayType { ValueWrapper(1), ValueWrapper(-100000), ValueWrapper(std::string("a")) });
+		map.emplace("inner", ValueWrapper(inner));
+
+		const auto decoded = roundTrip(ValueWrapper(map));
+		expect(eq(true, decoded.has_value()) >> fatal);
+		expect(eq(std::string(40, 'x'), decoded->get<StringType>("name")));
+		expect(eq(1.5, decoded->get<DoubleType>("rate")));
+		expect(eq(-100000, decoded->get("list")->get<IntType>(1)));
+		expect(eq(8, decoded->get("inner")->get<IntType>("level")));
+	};
+
+	test("ValueWrapperCodec rejects cut and foreign data") = [] {
+		std::string data;
+		ValueWrapperCodec::encode(ValueWrapper(ArrayType(40, ValueWrapper(std::string("abc")))), data);
+		for (size_t size = 0; size < data.size(); ++size) {
+			expect(!ValueWrapperCodec::decode(data.data(), size, 0).has_value());
+		}
+
+		// A protobuf string value, as the rows saved before
+		const std::string proto = "\x0A\x02hi";
+		expect(!ValueWrapperCodec::isEncoded(proto.data(), proto.size()));
+	};
+};
@@ -0,0 +1,36 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/di/container.hpp"
+#include "lib/logging/in_memory_logger.hpp"
+
+using namespace boost::ut;
+
+suite<"lib"> containerTest = [] {
+	test("inject resolves the instance of the current test container") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+
+		auto &logger = injector.create<Logger &>();
+		expect(eq(&logger, &inject<Logger>()));
+		expect(eq(&logger, &inject<Logger>()));
+	};
+
+	test("inject resolves again when the test container changes") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+		expect(dynamic_cast<InMemoryLogger*>(&inject<Logger>()) != nullptr);
+
+		DI::setTestContainer(nullptr);
+		expect(dynamic_cast<InMemoryLogger*>(&inject<Logger>()) == nullptr);
+	};
+};
@@ -61,8 +61,8 @@ public:
 		return "DEBUG";
 	}
 
-	virtual void log(std::string lvl, fmt::basic_string_view<char> msg) const override {
-		logs.push_back({ lvl, { msg.data(), msg.size() } });
+	virtual void log(LogLevel lvl, fmt::basic_string_view<char> msg) const override {
+		logs.push_back({ std::string(getLogLevelName(lvl)), { msg.data(), msg.size() } });
 	}
 
 	// Helper methods for testing
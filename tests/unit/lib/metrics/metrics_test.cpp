@@ -0,0 +1,58 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/metrics/metrics.hpp"
+
+using namespace boost::ut;
+
+suite<"lib"> metricsTest = [] {
+	test("Metrics returns the same counter for the same name and labels") = [] {
+		Metrics metrics;
+		auto &counter = metrics.getCounter("test_total", "Test", "kind=\"a\"");
+		counter.add(2);
+		metrics.getCounter("test_total", "Test", "kind=\"a\"").add(3);
+		metrics.getCounter("test_total", "Test", "kind=\"b\"").add();
+
+		expect(eq(uint64_t { 5 }, counter.get()));
+		expect(metrics.serialize().find("# TYPE test_total counter\ntest_total{kind=\"a\"} 5\ntest_total{kind=\"b\"} 1\n") != std::string::npos);
+	};
+
+	test("MetricCounter sums the shards of every thread") = [] {
+		MetricCounter counter;
+		std::vector<std::jthread> threads;
+		for (int i = 0; i < 8; ++i) {
+			threads.emplace_back([&counter] {
+				for (int j = 0; j < 1000; ++j) {
+					counter.add();
+				}
+			});
+		}
+		threads.clear();
+
+		expect(eq(uint64_t { 8000 }, counter.get()));
+	};
+
+	test("Metrics writes histogram buckets cumulatively") = [] {
+		Metrics metrics;
+		auto &histogram = metrics.getHistogram("test_seconds", "Test", { 100, 1000 }, 1e6);
+		histogram.observe(50);
+		histogram.observe(100);
+		histogram.observe(500);
+		histogram.observe(5000);
+
+		const auto text = metrics.serialize();
+		expect(text.find("test_seconds_bucket{le=\"0.0001\"} 2\n") != std::string::npos);
+		expect(text.find("test_seconds_bucket{le=\"0.001\"} 3\n") != std::string::npos);
+		expect(text.find("test_seconds_bucket{le=\"+Inf\"} 4\n") != std::string::npos);
+		expect(text.find("test_seconds_count 4\n") != std::string::npos);
+	};
+};
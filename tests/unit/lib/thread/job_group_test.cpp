@@ -0,0 +1,58 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/logging/in_memory_logger.hpp"
+#include "lib/thread/job_group.hpp"
+
+using namespace boost::ut;
+
+suite<"lib"> jobGroupTest = [] {
+	test("JobGroup runs every job on the waiting thread when the pool is not started") = [] {
+		InMemoryLogger logger;
+		ThreadPool pool(logger);
+
+		int sum = 0;
+		JobGroup group(pool);
+		for (int i = 1; i <= 10; ++i) {
+			group.run([&sum, i]() { sum += i; });
+		}
+		group.wait();
+
+		expect(eq(55, sum));
+		pool.shutdown();
+	};
+
+	test("parallelFor visits every index exactly once") = [] {
+		InMemoryLogger logger;
+		ThreadPool pool(logger);
+		pool.start(4, 1);
+
+		std::vector<std::atomic<int>> visits(10000);
+		parallelFor(pool, 0, visits.size(), [&visits](size_t i) {
+			visits[i].fetch_add(1, std::memory_order_relaxed);
+		});
+
+		expect(std::ranges::all_of(visits, [](const auto &count) { return count.load() == 1; }));
+		pool.shutdown();
+	};
+
+	test("JobGroup::wait rethrows the first job exception") = [] {
+		InMemoryLogger logger;
+		ThreadPool pool(logger);
+		pool.start(2, 1);
+
+		JobGroup group(pool);
+		group.run([]() { throw std::runtime_error("job failed"); });
+		expect(throws<std::runtime_error>([&group] { group.wait(); }));
+		pool.shutdown();
+	};
+};
@@ -0,0 +1,57 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/thread/mpsc_queue.hpp"
+
+using namespace boost::ut;
+
+suite<"lib"> mpscQueueTest = [] {
+	test("MPSCQueue pops in push order") = [] {
+		MPSCQueue<int> queue;
+		expect(queue.empty());
+
+		queue.push(1);
+		queue.push(2);
+		queue.push(3);
+
+		std::vector<int> values;
+		expect(eq(size_t { 3 }, queue.popAll(values)));
+		expect(eq(std::vector<int> { 1, 2, 3 }, values));
+		expect(queue.empty());
+	};
+
+	test("MPSCQueue receives every element from concurrent producers") = [] {
+		constexpr int producers = 4;
+		constexpr int perProducer = 10000;
+
+		MPSCQueue<int> queue;
+		std::vector<std::jthread> threads;
+		for (int i = 0; i < producers; ++i) {
+			threads.emplace_back([&queue] {
+				for (int j = 0; j < perProducer; ++j) {
+					queue.push(j);
+				}
+			});
+		}
+
+		int received = 0;
+		int value = 0;
+		while (received < producers * perProducer) {
+			if (queue.pop(value)) {
+				++received;
+			}
+		}
+
+		expect(eq(producers * perProducer, received));
+		expect(queue.empty());
+	};
+};
@@ -0,0 +1,62 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "map/utils/astarnodes.hpp"
+
+using namespace boost::ut;
+
+suite<"map"> aStarNodesTest = [] {
+	test("AStarNodes::getBestNode returns the lowest f, oldest first on ties") = [] {
+		auto &nodes = AStarNodes::getThreadInstance(100, 100);
+		auto start = nodes.getBestNode();
+		expect(start != nullptr && start->x == 100 && start->y == 100);
+		nodes.closeNode(start);
+
+		auto far = nodes.createOpenNode(start, 101, 100, 30);
+		auto first = nodes.createOpenNode(start, 100, 101, 10);
+		auto second = nodes.createOpenNode(start, 99, 100, 10);
+		expect(eq(nodes.getBestNode(), first));
+		nodes.closeNode(first);
+		expect(eq(nodes.getBestNode(), second));
+		nodes.closeNode(second);
+		expect(eq(nodes.getBestNode(), far));
+	};
+
+	test("AStarNodes::openNode reorders an improved node") = [] {
+		auto &nodes = AStarNodes::getThreadInstance(100, 100);
+		auto start = nodes.getBestNode();
+		nodes.closeNode(start);
+
+		auto cheap = nodes.createOpenNode(start, 101, 100, 20);
+		auto improved = nodes.createOpenNode(start, 100, 101, 40);
+		improved->f = 10;
+		nodes.openNode(improved);
+		expect(eq(nodes.getBestNode(), improved));
+		nodes.closeNode(improved);
+		expect(eq(nodes.getBestNode(), cheap));
+		nodes.closeNode(cheap);
+		expect(eq(nodes.getBestNode(), static_cast<AStarNode*>(nullptr)));
+		expect(eq(nodes.getClosedNodes(), 3));
+	};
+
+	test("AStarNodes::reset forgets the nodes of the previous search") = [] {
+		auto &nodes = AStarNodes::getThreadInstance(100, 100);
+		nodes.createOpenNode(nodes.getBestNode(), 101, 100, 10);
+		expect(nodes.getNodeByPosition(101, 100) != nullptr);
+
+		auto &again = AStarNodes::getThreadInstance(200, 200);
+		expect(eq(&again, &nodes));
+		expect(eq(again.getNodeByPosition(101, 100), static_cast<AStarNode*>(nullptr)));
+		expect(again.getNodeByPosition(200, 200) != nullptr);
+	};
+};
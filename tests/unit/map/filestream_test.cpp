@@ -0,0 +1,54 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "io/filestream.hpp"
+#include "io/fileloader.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr auto START = static_cast<char>(OTB::Node::START);
+	constexpr auto END = static_cast<char>(OTB::Node::END);
+	constexpr auto ESCAPE = static_cast<char>(OTB::Node::ESCAPE);
+}
+
+suite<"map"> fileStreamTest = [] {
+	test("FileStream::skipNode moves past nested and escaped bytes") = [] {
+		// Two sibling nodes of type 4, the first has a child and an escaped END in its data
+		const std::vector<char> data = {
+			START, 4, ESCAPE, END,
+			START, 5, 1, END,
+			END,
+			START, 4, 2, END
+		};
+		FileStream stream { data.data(), data.data() + data.size() };
+
+		expect(stream.skipNode(4));
+		expect(eq(stream.tell(), 9u));
+		expect(stream.skipNode(4));
+		expect(eq(stream.tell(), 13u));
+	};
+
+	test("FileStream::slice reads a node on its own") = [] {
+		const std::vector<char> data = {
+			START, 4, 7, END,
+			START, 4, 9, END
+		};
+		const FileStream stream { data.data(), data.data() + data.size() };
+
+		auto second = stream.slice(4, 8);
+		expect(second.startNode(4));
+		expect(eq(second.getU8(), uint8_t { 9 }));
+		expect(second.endNode());
+	};
+};
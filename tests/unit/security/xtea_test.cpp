@@ -0,0 +1,69 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "security/xtea.hpp"
+
+using namespace boost::ut;
+
+static std::vector<uint8_t> makeData(size_t length) {
+	std::vector<uint8_t> data(length);
+	for (size_t i = 0; i < length; ++i) {
+		data[i] = static_cast<uint8_t>(i * 131 + 7);
+	}
+	return data;
+}
+
+suite<"security"> xteaTest = [] {
+	static constexpr XTEA::Key key = { 0x01234567, 0x89ABCDEF, 0xFEDCBA98, 0x76543210 };
+
+	test("XTEA::encrypt matches the scalar implementation for every block count") = [] {
+		for (size_t length = 0; length <= 8 * 40; length += 8) {
+			auto vectorized = makeData(length);
+			auto scalar = vectorized;
+			XTEA::encrypt(vectorized.data(), length, key);
+			XTEA::encryptScalar(scalar.data(), length, key);
+			expect(vectorized == scalar) << "length" << length;
+		}
+	};
+
+	test("XTEA::decrypt restores what XTEA::encrypt wrote") = [] {
+		for (size_t length = 0; length <= 8 * 40; length += 8) {
+			const auto original = makeData(length);
+			auto data = original;
+			XTEA::encrypt(data.data(), length, key);
+			XTEA::decrypt(data.data(), length, key);
+			expect(data == original) << "length" << length;
+
+			XTEA::encryptScalar(data.data(), length, key);
+			XTEA::decrypt(data.data(), length, key);
+			expect(data == original) << "length" << length;
+		}
+	};
+
+	test("XTEA::encrypt benchmark against the scalar implementation") = [] {
+		static constexpr size_t ITERATIONS = 100;
+		auto data = makeData(NETWORKMESSAGE_MAXSIZE & ~size_t { 7 });
+
+		const auto measure = [&data](auto encrypt) {
+			const auto startedAt = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < ITERATIONS; ++i) {
+				encrypt(data.data(), data.size(), key);
+			}
+			const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+			return static_cast<uint64_t>(ITERATIONS * data.size() / std::max(elapsed, 1e-9) / (1024 * 1024));
+		};
+
+		const auto scalar = measure(XTEA::encryptScalar);
+		const auto vectorized = measure(XTEA::encrypt);
+		log << "XTEA scalar:" << scalar << "MB/s, vectorized:" << vectorized << "MB/s";
+	};
+};
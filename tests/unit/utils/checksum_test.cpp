@@ -0,0 +1,48 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/tools.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> adlerChecksumTest = [] {
+	test("adlerChecksum matches the scalar implementation for every length") = [] {
+		std::vector<uint8_t> data(NETWORKMESSAGE_MAXSIZE);
+		for (size_t i = 0; i < data.size(); ++i) {
+			data[i] = static_cast<uint8_t>(i * 131 + 7);
+		}
+
+		for (size_t length = 0; length <= data.size(); length += length < 512 ? 1 : 997) {
+			expect(eq(adlerChecksumScalar(data.data(), length), adlerChecksum(data.data(), length))) << "length" << length;
+		}
+	};
+
+	test("adlerChecksum of bytes at their maximum does not overflow a run") = [] {
+		const std::vector<uint8_t> data(NETWORKMESSAGE_MAXSIZE, 0xFF);
+		expect(eq(adlerChecksumScalar(data.data(), data.size()), adlerChecksum(data.data(), data.size())));
+	};
+
+	test("AdlerChecksum fed in parts matches the checksum of the whole buffer") = [] {
+		std::vector<uint8_t> data(NETWORKMESSAGE_MAXSIZE);
+		for (size_t i = 0; i < data.size(); ++i) {
+			data[i] = static_cast<uint8_t>(i * 37 + 11);
+		}
+
+		for (size_t part : { 1, 7, 32, 1000, 4096 }) {
+			AdlerChecksum checksum;
+			for (size_t offset = 0; offset < data.size(); offset += part) {
+				checksum.update(std::span(data).subspan(offset, std::min(part, data.size() - offset)));
+			}
+			expect(eq(adlerChecksumScalar(data.data(), data.size()), checksum.value())) << "part" << part;
+		}
+	};
+};
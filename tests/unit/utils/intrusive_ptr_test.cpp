@@ -0,0 +1,92 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/intrusive_ptr.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	class Counted : public RefCounted<Counted> {
+	public:
+		explicit Counted(int &destroyed) :
+			destroyed(destroyed) { }
+		virtual ~Counted() {
+			++destroyed;
+		}
+
+		IntrusivePtr<Counted> getSelf() {
+			return IntrusivePtr<Counted>(this);
+		}
+
+	private:
+		int &destroyed;
+	};
+
+	class DerivedCounted final : public Counted {
+	public:
+		using Counted::Counted;
+	};
+
+	class SharedCounted final : public RefCounted<SharedCounted, true> { };
+}
+
+suite<"utils"> intrusivePtrTest = [] {
+	test("IntrusivePtr releases the object with its last handle") = [] {
+		int destroyed = 0;
+		auto first = makeIntrusive<Counted>(destroyed);
+		auto second = first;
+		expect(eq(2u, first->getReferenceCount()));
+
+		first.reset();
+		expect(eq(0, destroyed));
+		expect(eq(1u, second->getReferenceCount()));
+
+		second = nullptr;
+		expect(eq(1, destroyed));
+	};
+
+	test("IntrusivePtr moves without touching the count") = [] {
+		int destroyed = 0;
+		auto first = makeIntrusive<Counted>(destroyed);
+		auto second = std::move(first);
+		expect(first == nullptr);
+		expect(eq(1u, second->getReferenceCount()));
+	};
+
+	test("IntrusivePtr can be made from this") = [] {
+		int destroyed = 0;
+		auto first = makeIntrusive<Counted>(destroyed);
+		auto self = first->getSelf();
+		expect(self == first);
+		expect(eq(2u, first->getReferenceCount()));
+	};
+
+	test("IntrusivePtr casts within the hierarchy") = [] {
+		int destroyed = 0;
+		IntrusivePtr<Counted> base = makeIntrusive<DerivedCounted>(destroyed);
+		expect(dynamic_pointer_cast<DerivedCounted>(base) != nullptr);
+		expect(static_pointer_cast<DerivedCounted>(base) == base);
+		expect(eq(1u, base->getReferenceCount()));
+
+		base.reset();
+		expect(eq(1, destroyed));
+	};
+
+	test("IntrusivePtr hashes by address") = [] {
+		std::unordered_set<IntrusivePtr<SharedCounted>> set;
+		const auto object = makeIntrusive<SharedCounted>();
+		set.insert(object);
+		set.insert(object);
+		expect(eq(1u, set.size()));
+		expect(eq(2u, object->getReferenceCount()));
+	};
+};
@@ -51,3 +51,20 @@ suite<"utils"> getDirectionToTest = [] {
 		};
 	}
 };
+
+suite<"utils"> positionPackTest = [] {
+	test("Position::pack keeps every field") = [] {
+		constexpr Position position { 65535, 12345, 15 };
+		expect(eq(uint64_t { 65535 }, position.pack() & 0xFFFF));
+		expect(eq(uint64_t { 12345 }, (position.pack() >> 16) & 0xFFFF));
+		expect(eq(uint64_t { 15 }, position.pack() >> 32));
+	};
+
+	test("Position::pack differs for neighbours") = [] {
+		const Position position { 32000, 32000, 7 };
+		expect(neq(position.pack(), Position(32001, 32000, 7).pack()));
+		expect(neq(position.pack(), Position(32000, 32001, 7).pack()));
+		expect(neq(position.pack(), Position(32000, 32000, 8).pack()));
+		expect(neq(Position(0, 1, 0).pack(), Position(65535, 0, 0).pack()));
+	};
+};
@@ -0,0 +1,38 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/tools.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> randomGeneratorTest = [] {
+	test("uniform_random stays within its bounds, in either order") = [] {
+		for (int i = 0; i < 10000; ++i) {
+			const auto value = uniform_random(7, -3);
+			expect(value >= -3 && value <= 7) << "value" << value;
+		}
+		expect(eq(5, uniform_random(5, 5)));
+	};
+
+	test("seedRandomGenerators makes the rolls repeat") = [] {
+		seedRandomGenerators(42);
+		std::array<int32_t, 16> first {};
+		for (auto &value : first) {
+			value = uniform_random(1, 100);
+		}
+
+		seedRandomGenerators(42);
+		std::array<int32_t, 16> second {};
+		getRandomGenerator().fillUniform(second, 1, 100);
+		expect(first == second);
+	};
+};
@@ -0,0 +1,80 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/slot_map.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> slotMapTest = [] {
+	test("SlotMap finds a value by the id it was given") = [] {
+		SlotMap<int, 4> map(0x100, 0x1FF);
+		const auto first = map.insert(1);
+		const auto second = map.insert(2);
+
+		expect(eq(0x100u, first));
+		expect(eq(0x101u, second));
+		expect(eq(1, *map.find(first)));
+		expect(eq(2, *map.find(second)));
+		expect(eq(2u, map.size()));
+	};
+
+	test("SlotMap ids of erased values stay stale") = [] {
+		SlotMap<int, 4> map(0x100, 0x1FF);
+		const auto id = map.insert(1);
+		expect(map.erase(id));
+		expect(!map.erase(id));
+		expect(map.find(id) == nullptr);
+
+		const auto reused = map.insert(2);
+		expect(neq(id, reused));
+		expect(map.find(id) == nullptr);
+		expect(eq(2, *map.find(reused)));
+	};
+
+	test("SlotMap keeps the values dense when erasing") = [] {
+		SlotMap<int, 4> map(0x100, 0x1FF);
+		std::vector<uint32_t> ids;
+		for (int i = 0; i < 8; ++i) {
+			ids.push_back(map.insert(i));
+		}
+		map.erase(ids[2]);
+		map.erase(ids[0]);
+
+		int sum = 0;
+		for (const auto &[id, value] : map) {
+			expect(eq(value, *map.find(id)));
+			sum += value;
+		}
+		expect(eq(6u, map.size()));
+		expect(eq(1 + 3 + 4 + 5 + 6 + 7, sum));
+	};
+
+	test("SlotMap gives no id when every slot holds a value") = [] {
+		SlotMap<int, 4> map(0x100, 0x1FF);
+		for (int i = 0; i < 16; ++i) {
+			expect(neq(0u, map.insert(i)));
+		}
+		expect(eq(0u, map.insert(16)));
+	};
+
+	test("SlotMap ids stay within their range") = [] {
+		SlotMap<int, 4> map(0x100, 0x12F);
+		map.insert(0);
+		for (int i = 0; i < 8; ++i) {
+			map.erase(map.begin()->first);
+			const auto next = map.insert(i);
+			expect(map.isInRange(next) && next >= 0x100 && next <= 0x12F) << "id" << next;
+		}
+		expect(!map.isInRange(0x130));
+		expect(!map.isInRange(0xFF));
+	};
+};
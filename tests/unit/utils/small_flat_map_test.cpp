@@ -0,0 +1,62 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/small_flat_map.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> smallFlatMapTest = [] {
+	test("SmallFlatMap keeps the entries in the order they were added") = [] {
+		SmallFlatMap<uint32_t, int, 4> map;
+		map[30] = 1;
+		map[10] = 2;
+		map[20] = 3;
+		map[10] += 5;
+
+		std::vector<uint32_t> keys;
+		for (const auto &[key, value] : map) {
+			keys.push_back(key);
+		}
+		expect(eq(3u, map.size()));
+		expect(keys == std::vector<uint32_t> { 30, 10, 20 });
+		expect(eq(7, map.find(10)->second));
+	};
+
+	test("SmallFlatMap finds every key past the linear limit") = [] {
+		SmallFlatMap<uint32_t, uint32_t, 4> map;
+		for (uint32_t key = 1; key <= 64; ++key) {
+			expect(map.try_emplace(key * 7, key).second);
+		}
+		expect(!map.try_emplace(7, 0u).second);
+
+		for (uint32_t key = 1; key <= 64; ++key) {
+			const auto it = map.find(key * 7);
+			expect(it != map.end() && it->second == key) << "key" << key * 7;
+		}
+		expect(map.find(8) == map.end());
+		expect(!map.contains(0));
+	};
+
+	test("SmallFlatMap clear drops the entries and the index") = [] {
+		SmallFlatMap<uint32_t, int, 2> map;
+		for (uint32_t key = 0; key < 8; ++key) {
+			map[key] = 1;
+		}
+		map.clear();
+		expect(map.empty());
+		expect(!map.contains(3));
+
+		map[3] = 4;
+		expect(eq(4, map.find(3)->second));
+		expect(eq(1u, map.size()));
+	};
+};
@@ -32,3 +32,18 @@ suite<"utils"> replaceStringTest = [] {
 		};
 	}
 };
+
+suite<"utils"> toLowerCaseStringTest = [] {
+	test("asLowerCaseString matches tolower byte by byte past the vectorized chunks") = [] {
+		std::string subject;
+		for (int i = 0; i < 256 * 3; ++i) {
+			subject.push_back(static_cast<char>(i * 37 + 11));
+		}
+
+		for (size_t length = 0; length <= subject.size(); length += 13) {
+			auto expected = subject.substr(0, length);
+			std::transform(expected.begin(), expected.end(), expected.begin(), [](char c) { return static_cast<char>(tolower(static_cast<unsigned char>(c))); });
+			expect(eq(expected, asLowerCaseString(subject.substr(0, length)))) << "length" << length;
+		}
+	};
+};
@@ -0,0 +1,44 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/wildcardtree.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> wildcardTreeTest = [] {
+	test("WildcardTree completes the only name starting with the query in any case") = [] {
+		WildcardTree tree;
+		tree.insert("Knight Alpha");
+		tree.insert("Bubble");
+
+		std::string result;
+		expect(eq(RETURNVALUE_NOERROR, tree.findOne("KNI", result)));
+		expect(eq(std::string("knight alpha"), result));
+		expect(eq(RETURNVALUE_PLAYERWITHTHISNAMEISNOTONLINE, tree.findOne("sorcerer", result)));
+	};
+
+	test("WildcardTree is ambiguous while more than one name starts with the query") = [] {
+		WildcardTree tree;
+		tree.insert("Bubble");
+		tree.insert("Bubbles");
+
+		std::string result;
+		expect(eq(RETURNVALUE_NAMEISTOOAMBIGUOUS, tree.findOne("bub", result)));
+
+		tree.remove("bubble");
+		expect(eq(RETURNVALUE_NOERROR, tree.findOne("bub", result)));
+		expect(eq(std::string("bubbles"), result));
+
+		tree.remove("Bubbles");
+		expect(eq(RETURNVALUE_PLAYERWITHTHISNAMEISNOTONLINE, tree.findOne("bub", result)));
+	};
+};